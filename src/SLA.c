@@ -0,0 +1,36 @@
+#include "SLA.h"
+#include "SLAPredictor.h"
+#include "SLAUtility.h"
+
+/* 使用するSIMD命令セットの設定 */
+SLAApiResult SLA_SetSIMDInstructionSet(SLASIMDInstructionSet simd)
+{
+  /* 引数チェック */
+  if ((simd != SLA_SIMDINSTRUCTIONSET_AUTO)
+      && (simd != SLA_SIMDINSTRUCTIONSET_NONE) && (simd != SLA_SIMDINSTRUCTIONSET_SSE41)) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  /* 実行環境で使用できない命令セット */
+  if (SLAPredictor_SetSIMDInstructionSet(simd) != SLAPREDICTOR_APIRESULT_OK) {
+    return SLA_APIRESULT_UNSUPPORTED_INSTRUCTION_SET;
+  }
+
+  return SLA_APIRESULT_OK;
+}
+
+/* 使用中のSIMD命令セットの取得 */
+SLASIMDInstructionSet SLA_GetSIMDInstructionSet(void)
+{
+  return SLAPredictor_GetSIMDInstructionSet();
+}
+
+/* 実行環境で使用可能な全命令セットの演算がリファレンス実装と一致するか自己診断 */
+SLAApiResult SLA_CheckSIMDInstructionSet(void)
+{
+  if (SLAPredictor_CheckKernels() != SLAPREDICTOR_APIRESULT_OK) {
+    return SLA_APIRESULT_NG;
+  }
+
+  return SLA_APIRESULT_OK;
+}
@@ -0,0 +1,515 @@
+#include "SLABlockCache.h"
+#include "SLAUtility.h"
+#include "SLAInternal.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* 無効なスロット番号 */
+#define SLABLOCKCACHE_INVALID_SLOT  0xFFFFFFFFUL
+
+/* キーからの分割番号の計算 */
+#define SLABLOCKCACHE_GET_SHARD_NO(cache, stream_id, block_no) \
+  ((((stream_id) * 2654435761UL) ^ (block_no)) % (cache)->num_shards)
+
+/* キーからの分割内ハッシュ表の探索開始位置の計算（分割番号とは別の混ぜ方をする） */
+#define SLABLOCKCACHE_GET_HASH_POS(shard, stream_id, block_no) \
+  (SLABlockCache_HashKey(stream_id, block_no) & ((shard)->hash_mask))
+
+/* 分割単位のロック/アンロック */
+#define SLABLOCKCACHE_LOCK(cache, shard_no) {                       \
+  if ((cache)->lock != NULL) {                                      \
+    (cache)->lock((cache)->lock_context, (shard_no));               \
+  }                                                                 \
+}
+#define SLABLOCKCACHE_UNLOCK(cache, shard_no) {                     \
+  if ((cache)->unlock != NULL) {                                    \
+    (cache)->unlock((cache)->lock_context, (shard_no));             \
+  }                                                                 \
+}
+
+/* ブロックを格納するスロット */
+struct SLABlockCacheSlot {
+  uint32_t  stream_id;      /* ストリーム番号                     */
+  uint32_t  block_no;       /* ブロック番号                       */
+  uint32_t  num_channels;   /* チャンネル数（0ならば空きスロット）*/
+  uint32_t  num_samples;    /* チャンネルあたりサンプル数         */
+  uint32_t  prev;           /* LRUリストの前（より最近の）スロット */
+  uint32_t  next;           /* LRUリストの次（より古い）スロット。空きスロットでは空きリストの次 */
+  int32_t*  samples;        /* サンプル（チャンネル毎に最大ブロックサンプル数ずつ並べる） */
+};
+
+/* 分割（ロックの単位） */
+struct SLABlockCacheShard {
+  uint32_t  slot_offset;    /* 先頭スロット番号           */
+  uint32_t  num_slots;      /* スロット数                 */
+  uint32_t  head;           /* 最も最近参照したスロット   */
+  uint32_t  tail;           /* 最も古く参照したスロット   */
+  uint32_t  free_head;      /* 空きスロットリストの先頭   */
+  uint32_t* hash_table;     /* キーからスロット番号を引くハッシュ表（オープンアドレス法） */
+  uint32_t  hash_mask;      /* ハッシュ表のサイズ-1（サイズは2の冪） */
+  uint32_t  num_used_slots; /* 使用中のスロット数         */
+  uint32_t  num_hits;       /* ヒット回数                 */
+  uint32_t  num_misses;     /* ミス回数                   */
+  uint32_t  num_evictions;  /* 追い出し回数               */
+};
+
+/* ブロックキャッシュハンドル */
+struct SLABlockCache {
+  uint32_t                    max_num_channels;
+  uint32_t                    max_num_block_samples;
+  uint32_t                    num_shards;
+  SLABlockCacheLockFunction   lock;
+  SLABlockCacheLockFunction   unlock;
+  void*                       lock_context;
+  struct SLABlockCacheShard*  shards;
+  struct SLABlockCacheSlot*   slots;
+  uint8_t                     alloced_by_own;   /* 自前で領域を確保したか */
+  void*                       work;             /* ワーク領域先頭ポインタ */
+};
+
+/* 全スロット数の計算 */
+static uint32_t SLABlockCache_CalculateNumSlots(const struct SLABlockCacheConfig* config)
+{
+  size_t slot_size;
+
+  SLA_Assert(config != NULL);
+  SLA_Assert((config->max_num_channels > 0) && (config->max_num_block_samples > 0) && (config->num_shards > 0));
+
+  /* 1スロットがキャッシュサイズ上限に収まらない（積の桁あふれもここで弾く） */
+  if (config->max_num_channels > (config->max_cache_size / sizeof(int32_t) / config->max_num_block_samples)) {
+    return 0;
+  }
+  slot_size = sizeof(int32_t) * (size_t)config->max_num_channels * config->max_num_block_samples;
+
+  /* 分割毎に同数のスロットを割り当てる */
+  return (uint32_t)(config->max_cache_size / slot_size / config->num_shards) * config->num_shards;
+}
+
+/* 分割毎のハッシュ表サイズの計算: 負荷率を1/2以下に保つ2の冪 */
+static uint32_t SLABlockCache_CalculateHashTableSize(uint32_t num_slots_per_shard)
+{
+  uint32_t size = 1;
+
+  SLA_Assert(num_slots_per_shard <= (UINT32_MAX / 4));
+
+  while (size < (2 * num_slots_per_shard)) {
+    size <<= 1;
+  }
+
+  return size;
+}
+
+/* キーのハッシュ値計算 */
+static uint32_t SLABlockCache_HashKey(uint32_t stream_id, uint32_t block_no)
+{
+  uint32_t hash = (uint32_t)((stream_id * 0x85EBCA6BUL) ^ (block_no * 0xC2B2AE35UL)) & 0xFFFFFFFFUL;
+  hash ^= hash >> 16;
+  hash = (uint32_t)(hash * 0x7FEB352DUL) & 0xFFFFFFFFUL;
+  hash ^= hash >> 15;
+  return hash;
+}
+
+/* ブロックキャッシュの作成に必要なワークサイズ計算 */
+int32_t SLABlockCache_CalculateWorkSize(const struct SLABlockCacheConfig* config)
+{
+  uint64_t work_size;
+  uint32_t num_slots;
+
+  /* 引数チェック */
+  if ((config == NULL) || (config->num_shards == 0)
+      || (config->max_num_channels == 0) || (config->max_num_block_samples == 0)
+      || ((config->lock == NULL) != (config->unlock == NULL))) {
+    return -1;
+  }
+
+  /* 各分割に1つもスロットを割り当てられない */
+  if ((num_slots = SLABlockCache_CalculateNumSlots(config)) == 0) {
+    return -1;
+  }
+
+  /* ハンドル本体 */
+  work_size = SLA_MEMORY_ALIGNMENT + (uint64_t)SLAUTILITY_WORK_SIZE(sizeof(struct SLABlockCache));
+
+  /* 分割とスロット */
+  work_size += SLAUTILITY_WORK_SIZE64((uint64_t)sizeof(struct SLABlockCacheShard) * config->num_shards);
+  work_size += SLAUTILITY_WORK_SIZE64((uint64_t)sizeof(struct SLABlockCacheSlot) * num_slots);
+
+  /* 分割毎のハッシュ表 */
+  work_size += (uint64_t)config->num_shards * SLAUTILITY_WORK_SIZE64(
+      (uint64_t)sizeof(uint32_t) * SLABlockCache_CalculateHashTableSize(num_slots / config->num_shards));
+
+  /* スロット毎のサンプル領域 */
+  /* 補足）スロットのサイズはキャッシュサイズ上限以下であることを確認済み */
+  work_size += (uint64_t)num_slots
+    * SLAUTILITY_WORK_SIZE64((uint64_t)sizeof(int32_t) * config->max_num_channels * config->max_num_block_samples);
+
+  /* ワークサイズが表現できない */
+  if (work_size > INT32_MAX) {
+    return -1;
+  }
+
+  return (int32_t)work_size;
+}
+
+/* ブロックキャッシュの作成（ワーク領域指定） */
+struct SLABlockCache* SLABlockCache_CreateWithWork(const struct SLABlockCacheConfig* config, void* work, int32_t work_size)
+{
+  struct SLABlockCache* cache;
+  uint32_t i, j, num_slots, num_slots_per_shard, hash_table_size;
+  int32_t required_work_size;
+  uint8_t* work_ptr;
+
+  /* 引数チェック */
+  required_work_size = SLABlockCache_CalculateWorkSize(config);
+  if ((work == NULL) || (required_work_size < 0) || (work_size < required_work_size)) {
+    return NULL;
+  }
+
+  num_slots = SLABlockCache_CalculateNumSlots(config);
+  num_slots_per_shard = num_slots / config->num_shards;
+  hash_table_size = SLABlockCache_CalculateHashTableSize(num_slots_per_shard);
+
+  work_ptr = SLAUTILITY_ALIGN_WORK(work);
+
+  cache = (struct SLABlockCache *)SLAUtility_AllocateWork(&work_ptr, sizeof(struct SLABlockCache));
+  cache->max_num_channels       = config->max_num_channels;
+  cache->max_num_block_samples  = config->max_num_block_samples;
+  cache->num_shards             = config->num_shards;
+  cache->lock                   = config->lock;
+  cache->unlock                 = config->unlock;
+  cache->lock_context           = config->lock_context;
+  cache->alloced_by_own         = 0;
+  cache->work                   = work;
+
+  /* 各種領域割り当て */
+  cache->shards = (struct SLABlockCacheShard *)SLAUtility_AllocateWork(&work_ptr, sizeof(struct SLABlockCacheShard) * config->num_shards);
+  cache->slots  = (struct SLABlockCacheSlot *)SLAUtility_AllocateWork(&work_ptr, sizeof(struct SLABlockCacheSlot) * num_slots);
+  for (i = 0; i < num_slots; i++) {
+    cache->slots[i].num_channels  = 0;
+    cache->slots[i].prev          = SLABLOCKCACHE_INVALID_SLOT;
+    cache->slots[i].next          = SLABLOCKCACHE_INVALID_SLOT;
+    cache->slots[i].samples       = (int32_t *)SLAUtility_AllocateWork(&work_ptr,
+        sizeof(int32_t) * config->max_num_channels * config->max_num_block_samples);
+  }
+
+  /* 分割毎にスロットを割り当て */
+  for (i = 0; i < config->num_shards; i++) {
+    struct SLABlockCacheShard* shard = &cache->shards[i];
+    shard->slot_offset    = i * num_slots_per_shard;
+    shard->num_slots      = num_slots_per_shard;
+    shard->head           = SLABLOCKCACHE_INVALID_SLOT;
+    shard->tail           = SLABLOCKCACHE_INVALID_SLOT;
+    /* 空きスロットを番号順に繋ぐ */
+    shard->free_head      = shard->slot_offset;
+    for (j = 0; j < num_slots_per_shard; j++) {
+      cache->slots[shard->slot_offset + j].next
+        = (j + 1 < num_slots_per_shard) ? (shard->slot_offset + j + 1) : SLABLOCKCACHE_INVALID_SLOT;
+    }
+    shard->hash_table     = (uint32_t *)SLAUtility_AllocateWork(&work_ptr, sizeof(uint32_t) * hash_table_size);
+    shard->hash_mask      = hash_table_size - 1;
+    for (j = 0; j < hash_table_size; j++) {
+      shard->hash_table[j] = SLABLOCKCACHE_INVALID_SLOT;
+    }
+    shard->num_used_slots = 0;
+    shard->num_hits       = 0;
+    shard->num_misses     = 0;
+    shard->num_evictions  = 0;
+  }
+
+  /* ワーク領域を超えていないか */
+  SLA_Assert((int32_t)(work_ptr - (uint8_t *)work) <= required_work_size);
+
+  return cache;
+}
+
+/* ブロックキャッシュの作成 */
+struct SLABlockCache* SLABlockCache_Create(const struct SLABlockCacheConfig* config)
+{
+  int32_t work_size;
+  void* work;
+  struct SLABlockCache* cache;
+
+  if ((work_size = SLABlockCache_CalculateWorkSize(config)) < 0) {
+    return NULL;
+  }
+
+  work = malloc((size_t)work_size);
+  if ((cache = SLABlockCache_CreateWithWork(config, work, work_size)) == NULL) {
+    NULLCHECK_AND_FREE(work);
+    return NULL;
+  }
+  cache->alloced_by_own = 1;
+
+  return cache;
+}
+
+/* ブロックキャッシュの破棄 */
+void SLABlockCache_Destroy(struct SLABlockCache* cache)
+{
+  if ((cache != NULL) && cache->alloced_by_own) {
+    free(cache->work);
+  }
+}
+
+/* スロットをLRUリストから外す */
+static void SLABlockCache_Unlink(struct SLABlockCache* cache, struct SLABlockCacheShard* shard, uint32_t slot_no)
+{
+  struct SLABlockCacheSlot* slot = &cache->slots[slot_no];
+
+  if (slot->prev != SLABLOCKCACHE_INVALID_SLOT) {
+    cache->slots[slot->prev].next = slot->next;
+  } else {
+    shard->head = slot->next;
+  }
+  if (slot->next != SLABLOCKCACHE_INVALID_SLOT) {
+    cache->slots[slot->next].prev = slot->prev;
+  } else {
+    shard->tail = slot->prev;
+  }
+  slot->prev = slot->next = SLABLOCKCACHE_INVALID_SLOT;
+}
+
+/* スロットをLRUリストの先頭（最近参照）に繋ぐ */
+static void SLABlockCache_LinkToHead(struct SLABlockCache* cache, struct SLABlockCacheShard* shard, uint32_t slot_no)
+{
+  struct SLABlockCacheSlot* slot = &cache->slots[slot_no];
+
+  slot->prev = SLABLOCKCACHE_INVALID_SLOT;
+  slot->next = shard->head;
+  if (shard->head != SLABLOCKCACHE_INVALID_SLOT) {
+    cache->slots[shard->head].prev = slot_no;
+  } else {
+    shard->tail = slot_no;
+  }
+  shard->head = slot_no;
+}
+
+/* 分割内でキーに一致するスロットのハッシュ表上の位置を探す（見つからなければ無効値） */
+static uint32_t SLABlockCache_FindHashPos(const struct SLABlockCache* cache, const struct SLABlockCacheShard* shard,
+    uint32_t stream_id, uint32_t block_no)
+{
+  uint32_t pos, slot_no;
+
+  /* 空きに当たるまで線形探索（負荷率1/2以下なので必ず空きがある） */
+  for (pos = SLABLOCKCACHE_GET_HASH_POS(shard, stream_id, block_no);
+      (slot_no = shard->hash_table[pos]) != SLABLOCKCACHE_INVALID_SLOT;
+      pos = (pos + 1) & shard->hash_mask) {
+    const struct SLABlockCacheSlot* slot = &cache->slots[slot_no];
+    if ((slot->stream_id == stream_id) && (slot->block_no == block_no)) {
+      return pos;
+    }
+  }
+
+  return SLABLOCKCACHE_INVALID_SLOT;
+}
+
+/* 分割内でキーに一致するスロットを探す（見つからなければ無効値） */
+static uint32_t SLABlockCache_FindSlot(const struct SLABlockCache* cache, const struct SLABlockCacheShard* shard,
+    uint32_t stream_id, uint32_t block_no)
+{
+  uint32_t pos = SLABlockCache_FindHashPos(cache, shard, stream_id, block_no);
+  return (pos != SLABLOCKCACHE_INVALID_SLOT) ? shard->hash_table[pos] : SLABLOCKCACHE_INVALID_SLOT;
+}
+
+/* スロットをハッシュ表に登録（キーは未登録であること） */
+static void SLABlockCache_InsertHash(struct SLABlockCache* cache, struct SLABlockCacheShard* shard, uint32_t slot_no)
+{
+  uint32_t pos;
+  const struct SLABlockCacheSlot* slot = &cache->slots[slot_no];
+
+  for (pos = SLABLOCKCACHE_GET_HASH_POS(shard, slot->stream_id, slot->block_no);
+      shard->hash_table[pos] != SLABLOCKCACHE_INVALID_SLOT;
+      pos = (pos + 1) & shard->hash_mask) ;
+  shard->hash_table[pos] = slot_no;
+}
+
+/* スロットをハッシュ表から削除 */
+/* 補足）墓標は使わず、後続の要素を詰め直して探索列を保つ */
+static void SLABlockCache_RemoveHash(struct SLABlockCache* cache, struct SLABlockCacheShard* shard, uint32_t slot_no)
+{
+  uint32_t pos, next_pos, home_pos;
+  const struct SLABlockCacheSlot* slot = &cache->slots[slot_no];
+
+  pos = SLABlockCache_FindHashPos(cache, shard, slot->stream_id, slot->block_no);
+  SLA_Assert((pos != SLABLOCKCACHE_INVALID_SLOT) && (shard->hash_table[pos] == slot_no));
+
+  next_pos = pos;
+  while (1) {
+    next_pos = (next_pos + 1) & shard->hash_mask;
+    if (shard->hash_table[next_pos] == SLABLOCKCACHE_INVALID_SLOT) {
+      break;
+    }
+    /* 本来の位置から見て空けた位置を越えている要素は、空けた位置に移す */
+    slot = &cache->slots[shard->hash_table[next_pos]];
+    home_pos = SLABLOCKCACHE_GET_HASH_POS(shard, slot->stream_id, slot->block_no);
+    if (((next_pos - home_pos) & shard->hash_mask) >= ((next_pos - pos) & shard->hash_mask)) {
+      shard->hash_table[pos] = shard->hash_table[next_pos];
+      pos = next_pos;
+    }
+  }
+  shard->hash_table[pos] = SLABLOCKCACHE_INVALID_SLOT;
+}
+
+/* デコード済みブロックの取得 */
+SLAApiResult SLABlockCache_Get(struct SLABlockCache* cache,
+    uint32_t stream_id, uint32_t block_no,
+    int32_t** buffer, uint32_t num_channels, uint32_t buffer_num_samples, uint32_t* output_num_samples)
+{
+  uint32_t ch, shard_no, slot_no;
+  struct SLABlockCacheShard* shard;
+  struct SLABlockCacheSlot* slot;
+  SLAApiResult ret;
+
+  /* 引数チェック */
+  if ((cache == NULL) || (buffer == NULL) || (output_num_samples == NULL)) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  shard_no = (uint32_t)SLABLOCKCACHE_GET_SHARD_NO(cache, stream_id, block_no);
+  shard = &cache->shards[shard_no];
+
+  SLABLOCKCACHE_LOCK(cache, shard_no);
+
+  slot_no = SLABlockCache_FindSlot(cache, shard, stream_id, block_no);
+  slot = (slot_no != SLABLOCKCACHE_INVALID_SLOT) ? &cache->slots[slot_no] : NULL;
+  if (slot == NULL) {
+    shard->num_misses++;
+    ret = SLA_APIRESULT_CACHE_MISS;
+  } else if (slot->num_channels != num_channels) {
+    ret = SLA_APIRESULT_INVALID_ARGUMENT;
+  } else if (slot->num_samples > buffer_num_samples) {
+    ret = SLA_APIRESULT_INSUFFICIENT_BUFFER_SIZE;
+  } else {
+    /* 取り出し中に追い出されないよう、ロック中にコピーする */
+    for (ch = 0; ch < num_channels; ch++) {
+      memcpy(buffer[ch], &slot->samples[ch * cache->max_num_block_samples], sizeof(int32_t) * slot->num_samples);
+    }
+    *output_num_samples = slot->num_samples;
+    /* 最近参照したスロットとしてリストの先頭に移す */
+    SLABlockCache_Unlink(cache, shard, slot_no);
+    SLABlockCache_LinkToHead(cache, shard, slot_no);
+    shard->num_hits++;
+    ret = SLA_APIRESULT_OK;
+  }
+
+  SLABLOCKCACHE_UNLOCK(cache, shard_no);
+
+  return ret;
+}
+
+/* デコード済みブロックの格納 */
+SLAApiResult SLABlockCache_Put(struct SLABlockCache* cache,
+    uint32_t stream_id, uint32_t block_no,
+    const int32_t* const* samples, uint32_t num_channels, uint32_t num_samples)
+{
+  uint32_t ch, shard_no, slot_no;
+  struct SLABlockCacheShard* shard;
+  struct SLABlockCacheSlot* slot;
+
+  /* 引数チェック */
+  if ((cache == NULL) || (samples == NULL) || (num_channels == 0)) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  /* スロットに収まらない */
+  if ((num_channels > cache->max_num_channels) || (num_samples > cache->max_num_block_samples)) {
+    return SLA_APIRESULT_EXCEED_HANDLE_CAPACITY;
+  }
+
+  shard_no = (uint32_t)SLABLOCKCACHE_GET_SHARD_NO(cache, stream_id, block_no);
+  shard = &cache->shards[shard_no];
+
+  SLABLOCKCACHE_LOCK(cache, shard_no);
+
+  if ((slot_no = SLABlockCache_FindSlot(cache, shard, stream_id, block_no)) != SLABLOCKCACHE_INVALID_SLOT) {
+    /* 格納済み: 内容を上書き（ハッシュ表はそのまま） */
+    SLABlockCache_Unlink(cache, shard, slot_no);
+  } else {
+    if (shard->free_head != SLABLOCKCACHE_INVALID_SLOT) {
+      /* 空きスロットを使う */
+      slot_no = shard->free_head;
+      shard->free_head = cache->slots[slot_no].next;
+      shard->num_used_slots++;
+    } else {
+      /* 最も古く参照したスロットを追い出す */
+      slot_no = shard->tail;
+      SLABlockCache_Unlink(cache, shard, slot_no);
+      SLABlockCache_RemoveHash(cache, shard, slot_no);
+      shard->num_evictions++;
+    }
+    cache->slots[slot_no].stream_id = stream_id;
+    cache->slots[slot_no].block_no  = block_no;
+    SLABlockCache_InsertHash(cache, shard, slot_no);
+  }
+
+  slot = &cache->slots[slot_no];
+  slot->num_channels  = num_channels;
+  slot->num_samples   = num_samples;
+  for (ch = 0; ch < num_channels; ch++) {
+    memcpy(&slot->samples[ch * cache->max_num_block_samples], samples[ch], sizeof(int32_t) * num_samples);
+  }
+  SLABlockCache_LinkToHead(cache, shard, slot_no);
+
+  SLABLOCKCACHE_UNLOCK(cache, shard_no);
+
+  return SLA_APIRESULT_OK;
+}
+
+/* ストリームのブロックを全て破棄 */
+SLAApiResult SLABlockCache_Invalidate(struct SLABlockCache* cache, uint32_t stream_id)
+{
+  uint32_t shard_no, slot_no, next_slot_no;
+  struct SLABlockCacheShard* shard;
+
+  /* 引数チェック */
+  if (cache == NULL) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  for (shard_no = 0; shard_no < cache->num_shards; shard_no++) {
+    shard = &cache->shards[shard_no];
+    SLABLOCKCACHE_LOCK(cache, shard_no);
+    for (slot_no = shard->head; slot_no != SLABLOCKCACHE_INVALID_SLOT; slot_no = next_slot_no) {
+      next_slot_no = cache->slots[slot_no].next;
+      if (cache->slots[slot_no].stream_id == stream_id) {
+        SLABlockCache_Unlink(cache, shard, slot_no);
+        SLABlockCache_RemoveHash(cache, shard, slot_no);
+        /* 空きリストに戻す */
+        cache->slots[slot_no].num_channels = 0;
+        cache->slots[slot_no].next = shard->free_head;
+        shard->free_head = slot_no;
+        shard->num_used_slots--;
+      }
+    }
+    SLABLOCKCACHE_UNLOCK(cache, shard_no);
+  }
+
+  return SLA_APIRESULT_OK;
+}
+
+/* 利用状況の取得 */
+SLAApiResult SLABlockCache_GetStatistics(struct SLABlockCache* cache, struct SLABlockCacheStatistics* statistics)
+{
+  uint32_t shard_no;
+  const struct SLABlockCacheShard* shard;
+
+  /* 引数チェック */
+  if ((cache == NULL) || (statistics == NULL)) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  memset(statistics, 0, sizeof(struct SLABlockCacheStatistics));
+  for (shard_no = 0; shard_no < cache->num_shards; shard_no++) {
+    shard = &cache->shards[shard_no];
+    SLABLOCKCACHE_LOCK(cache, shard_no);
+    statistics->num_slots       += shard->num_slots;
+    statistics->num_used_slots  += shard->num_used_slots;
+    statistics->num_hits        += shard->num_hits;
+    statistics->num_misses      += shard->num_misses;
+    statistics->num_evictions   += shard->num_evictions;
+    SLABLOCKCACHE_UNLOCK(cache, shard_no);
+  }
+
+  return SLA_APIRESULT_OK;
+}
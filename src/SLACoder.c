@@ -30,6 +30,17 @@
 #define SLARICE_CALCULATE_RICE_PARAMETER(param_array, order) \
   SLAUTILITY_ROUNDUP2POWERED(SLAUTILITY_MAX(SLACODER_FIXED_FLOAT_TO_UINT32((param_array)[(order)] >> 1), 1UL))
 
+/* ライス符号パラメータの使用回数記録 */
+#ifdef SLA_ENABLE_STATISTICS
+#define SLACODER_COUNT_RICE_PARAMETER(coder, param) {                                   \
+  if ((coder)->rice_parameter_histogram != NULL) {                                      \
+    (coder)->rice_parameter_histogram[SLAUTILITY_LOG2FLOOR((uint32_t)(param))]++;       \
+  }                                                                                     \
+}
+#else
+#define SLACODER_COUNT_RICE_PARAMETER(coder, param)
+#endif
+
 /* 再帰的ライス符号パラメータ型 */
 typedef uint64_t SLARecursiveRiceParameter;
 
@@ -39,6 +50,11 @@ struct SLACoder {
   SLARecursiveRiceParameter** init_rice_parameter;
   uint32_t                    max_num_channels;
   uint32_t                    max_num_parameters;
+#ifdef SLA_ENABLE_STATISTICS
+  uint64_t*                   rice_parameter_histogram; /* パラメータヒストグラム（NULLなら記録しない） */
+#endif
+  uint8_t                     alloced_by_own;   /* 自前で領域を確保したか */
+  void*                       work;             /* ワーク領域先頭ポインタ */
 };
 
 /* ゴロム符号化の出力 */
@@ -317,25 +333,71 @@ static uint32_t SLARecursiveRice_GetCode(
   return val;
 }
 
-/* 符号化ハンドルの作成 */
-struct SLACoder* SLACoder_Create(uint32_t max_num_channels, uint32_t max_num_parameters)
+/* 符号化ハンドルのワークサイズ計算 */
+int32_t SLACoder_CalculateWorkSize(uint32_t max_num_channels, uint32_t max_num_parameters)
+{
+  int32_t work_size;
+
+  work_size = SLA_MEMORY_ALIGNMENT + SLAUTILITY_WORK_SIZE(sizeof(struct SLACoder));
+  work_size += 2 * SLAUTILITY_WORK_SIZE(sizeof(SLARecursiveRiceParameter *) * max_num_channels);
+  work_size += 2 * (int32_t)max_num_channels * SLAUTILITY_WORK_SIZE(sizeof(SLARecursiveRiceParameter) * max_num_parameters);
+
+  return work_size;
+}
+
+/* 符号化ハンドルの作成（ワーク領域指定） */
+struct SLACoder* SLACoder_CreateWithWork(
+    uint32_t max_num_channels, uint32_t max_num_parameters, void* work, int32_t work_size)
 {
   uint32_t ch;
+  uint8_t* work_ptr;
   struct SLACoder* coder;
-  
-  coder = (struct SLACoder *)malloc(sizeof(struct SLACoder));
+
+  /* 引数チェック */
+  if ((work == NULL) || (work_size < SLACoder_CalculateWorkSize(max_num_channels, max_num_parameters))) {
+    return NULL;
+  }
+
+  work_ptr = SLAUTILITY_ALIGN_WORK(work);
+
+  coder = (struct SLACoder *)SLAUtility_AllocateWork(&work_ptr, sizeof(struct SLACoder));
   coder->max_num_channels   = max_num_channels;
   coder->max_num_parameters = max_num_parameters;
+  coder->alloced_by_own     = 0;
+  coder->work               = work;
+#ifdef SLA_ENABLE_STATISTICS
+  coder->rice_parameter_histogram = NULL;
+#endif
 
-  coder->rice_parameter       = (SLARecursiveRiceParameter **)malloc(sizeof(SLARecursiveRiceParameter *) * max_num_channels);
-  coder->init_rice_parameter  = (SLARecursiveRiceParameter **)malloc(sizeof(SLARecursiveRiceParameter *) * max_num_channels);
+  coder->rice_parameter       = (SLARecursiveRiceParameter **)SLAUtility_AllocateWork(&work_ptr, sizeof(SLARecursiveRiceParameter *) * max_num_channels);
+  coder->init_rice_parameter  = (SLARecursiveRiceParameter **)SLAUtility_AllocateWork(&work_ptr, sizeof(SLARecursiveRiceParameter *) * max_num_channels);
 
   for (ch = 0; ch < max_num_channels; ch++) {
     coder->rice_parameter[ch] 
-      = (SLARecursiveRiceParameter *)malloc(sizeof(SLARecursiveRiceParameter) * max_num_parameters);
+      = (SLARecursiveRiceParameter *)SLAUtility_AllocateWork(&work_ptr, sizeof(SLARecursiveRiceParameter) * max_num_parameters);
     coder->init_rice_parameter[ch] 
-      = (SLARecursiveRiceParameter *)malloc(sizeof(SLARecursiveRiceParameter) * max_num_parameters);
+      = (SLARecursiveRiceParameter *)SLAUtility_AllocateWork(&work_ptr, sizeof(SLARecursiveRiceParameter) * max_num_parameters);
+  }
+
+  SLA_Assert((work_ptr - (uint8_t *)work) <= work_size);
+
+  return coder;
+}
+
+/* 符号化ハンドルの作成 */
+struct SLACoder* SLACoder_Create(uint32_t max_num_channels, uint32_t max_num_parameters)
+{
+  int32_t work_size;
+  void* work;
+  struct SLACoder* coder;
+
+  work_size = SLACoder_CalculateWorkSize(max_num_channels, max_num_parameters);
+  work = malloc((size_t)work_size);
+  if ((coder = SLACoder_CreateWithWork(max_num_channels, max_num_parameters, work, work_size)) == NULL) {
+    NULLCHECK_AND_FREE(work);
+    return NULL;
   }
+  coder->alloced_by_own = 1;
 
   return coder;
 }
@@ -343,19 +405,19 @@ struct SLACoder* SLACoder_Create(uint32_t max_num_channels, uint32_t max_num_par
 /* 符号化ハンドルの破棄 */
 void SLACoder_Destroy(struct SLACoder* coder)
 {
-  uint32_t ch;
-
-  if (coder != NULL) {
-    for (ch = 0; ch < coder->max_num_channels; ch++) {
-      NULLCHECK_AND_FREE(coder->rice_parameter[ch]);
-      NULLCHECK_AND_FREE(coder->init_rice_parameter[ch]);
-    }
-    NULLCHECK_AND_FREE(coder->rice_parameter);
-    NULLCHECK_AND_FREE(coder->init_rice_parameter);
-    free(coder);
+  if ((coder != NULL) && coder->alloced_by_own) {
+    free(coder->work);
   }
+}
 
+#ifdef SLA_ENABLE_STATISTICS
+/* ライス符号パラメータのヒストグラム記録先の設定 */
+void SLACoder_SetRiceParameterHistogram(struct SLACoder* coder, uint64_t* histogram)
+{
+  SLA_Assert(coder != NULL);
+  coder->rice_parameter_histogram = histogram;
 }
+#endif
 
 /* 初期パラメータの計算 */
 void SLACoder_CalculateInitialRecursiveRiceParameter(
@@ -451,6 +513,7 @@ void SLACoder_PutDataArray(
     /* パラメータを適応的に変更しつつ符号化 */
     for (smpl = 0; smpl < num_samples; smpl++) {
       for (ch = 0; ch < num_channels; ch++) {
+        SLACODER_COUNT_RICE_PARAMETER(coder, SLARICE_CALCULATE_RICE_PARAMETER(coder->rice_parameter[ch], 0));
         SLARecursiveRice_PutCode(strm,
             coder->rice_parameter[ch], num_parameters, SLAUTILITY_SINT32_TO_UINT32(data[ch][smpl]));
       }
@@ -459,6 +522,7 @@ void SLACoder_PutDataArray(
     /* パラメータが小さい場合はパラメータ固定で符号化 */
     for (smpl = 0; smpl < num_samples; smpl++) {
       for (ch = 0; ch < num_channels; ch++) {
+        SLACODER_COUNT_RICE_PARAMETER(coder, SLACODER_PARAMETER_GET(coder->init_rice_parameter[ch], 0));
         SLAGolomb_PutCode(strm,
             SLACODER_PARAMETER_GET(coder->init_rice_parameter[ch], 0), SLAUTILITY_SINT32_TO_UINT32(data[ch][smpl]));
       }
@@ -490,6 +554,7 @@ void SLACoder_GetDataArray(
     /* パラメータを適応的に変更しつつ符号化 */
     for (smpl = 0; smpl < num_samples; smpl++) {
       for (ch = 0; ch < num_channels; ch++) {
+        SLACODER_COUNT_RICE_PARAMETER(coder, SLARICE_CALCULATE_RICE_PARAMETER(coder->rice_parameter[ch], 0));
         abs = SLARecursiveRice_GetCode(strm, coder->rice_parameter[ch], num_parameters);
         data[ch][smpl] = SLAUTILITY_UINT32_TO_SINT32(abs);
       }
@@ -498,6 +563,7 @@ void SLACoder_GetDataArray(
     /* パラメータが小さい場合はパラメータ固定で符号化 */
     for (smpl = 0; smpl < num_samples; smpl++) {
       for (ch = 0; ch < num_channels; ch++) {
+        SLACODER_COUNT_RICE_PARAMETER(coder, SLACODER_PARAMETER_GET(coder->init_rice_parameter[ch], 0));
         abs = SLAGolomb_GetCode(strm, SLACODER_PARAMETER_GET(coder->init_rice_parameter[ch], 0));
         data[ch][smpl] = SLAUTILITY_UINT32_TO_SINT32(abs);
       }
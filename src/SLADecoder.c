@@ -1,4 +1,5 @@
 #include "SLADecoder.h"
+#include "SLABlockCache.h"
 #include "SLAUtility.h"
 #include "SLAPredictor.h"
 #include "SLACoder.h"
@@ -14,12 +15,21 @@
 #define SLADECODER_STATUS_FLAG_SET_WAVE_FORMAT      (1 << 0)    /* 波形フォーマットセット済み     */
 #define SLADECODER_STATUS_FLAG_SET_ENCODE_PARAMETER (1 << 1)    /* エンコードパラメータセット済み */
 
+/* データ全体のうちoffset以降の残りサイズ（ブロック単位の処理に渡すため32bitに飽和させる） */
+/* 補足）ブロックサイズは32bitで表されるので、飽和させても1ブロックの処理には影響しない */
+#define SLADECODER_REMAIN_SIZE(data_size, offset) \
+  ((uint32_t)SLAUTILITY_MIN((uint64_t)(data_size) - (offset), (uint64_t)UINT32_MAX))
+
 /* ブロックヘッダ */
 struct SLABlockHeaderInfo {
   uint32_t  block_size;               /* ブロックサイズ                         */
   uint32_t  block_num_samples;        /* ブロックに含まれるchあたりのサンプル数 */
 };
 
+/* チャンネル単位の音声合成関数型 */
+typedef SLAApiResult (*SLADecoderSynthesizeFunction)(
+    struct SLADecoder* decoder, uint32_t ch, uint32_t num_samples);
+
 /* デコーダハンドル */
 struct SLADecoder {
   struct SLAWaveFormat          wave_format;
@@ -41,38 +51,146 @@ struct SLADecoder {
   int32_t**                     parcor_coef;
   int32_t**                     longterm_coef;
   uint32_t*                     pitch_period;
+  uint8_t*                      is_int16_synthesizable;
 
   SLABlockDataType              block_data_type;
+  SLADecoderSynthesizeFunction  synthesize_function;
   int32_t**                     residual;
   int32_t**                     output;
+  int32_t**                     range_buffer;     /* 範囲デコードで端のブロックを受ける一時領域 */
+  void**                        channel_data;       /* 32bit左詰め出力をPCM出力として参照するためのポインタ配列 */
+  void**                        block_channel_data; /* ブロック毎に書き込み先を進めたPCM出力のポインタ配列 */
+  int32_t**                     range_output;     /* 範囲デコードで出力先を指すポインタ配列 */
+  uint32_t*                     raw_data_bits;    /* 生データ読み込み時のチャンネル毎のビット幅 */
+  struct SLABlockCache*         block_cache;      /* 範囲デコードで参照するブロックキャッシュ */
+  uint32_t                      block_cache_stream_id;  /* ブロックキャッシュ上のストリーム番号 */
   uint32_t                      status_flag;
   uint8_t                       verpose_flag;
+#ifdef SLA_ENABLE_STATISTICS
+  struct SLAStatistics          statistics;       /* 統計情報               */
+  uint64_t                      stage_start_tick; /* 計測中の処理段階の開始時刻 */
+#endif
+  uint8_t                       alloced_by_own;   /* 自前で領域を確保したか */
+  void*                         work;             /* ワーク領域先頭ポインタ */
 };
 
 /* ストリーミングデコードハンドル */
 struct SLAStreamingDecoder {
   struct SLADecoder*            decoder_core;
-  uint8_t*                      data_buffer;
   uint32_t                      data_buffer_size;
-  uint32_t                      data_buffer_provided_size;
+  uint32_t                      data_buffer_provided_size;    /* 連結領域に連結済みのサイズ */
+  uint8_t*                      data_buffer;                  /* データ片をまたぐブロックの連結領域 */
+  const uint8_t*                current_block_data;           /* デコード中ブロックの先頭 */
+  uint8_t                       is_direct_decoding;           /* データ片から直接デコード中か */
   uint32_t                      num_output_samples_per_decode;
   struct SLABlockHeaderInfo     current_block_header;
   uint32_t                      current_block_sample_offset;
+  uint16_t                      block_crc16;                  /* 次のブロック（ブロック先頭ではデコード中ブロック）のCRC16途中結果 */
+  uint32_t                      block_crc16_progress;         /* block_crc16に計算済みのバイト数 */
   float                         estimated_bytes_per_sample;
   float                         decode_interval_hz;
   uint32_t                      max_bit_per_sample;
   struct SLADataPacketQueue*    queue;
 };
 
-/* デコーダハンドルの作成 */
-struct SLADecoder* SLADecoder_Create(const struct SLADecoderConfig* config)
+/* 一括デコードのワーカ */
+struct SLADecoderBatchWorker {
+  struct SLADecoder*            decoder;        /* 使用するハンドル   */
+  struct SLADecodeBatchItem*    items;          /* データ配列         */
+  uint32_t                      num_items;      /* データ数           */
+  uint32_t                      start;          /* 担当する先頭のデータ番号 */
+  uint32_t                      stride;         /* 担当するデータ番号の間隔 */
+  void*                         thread;         /* 起動したスレッド（呼び出しスレッドで処理する場合はNULL） */
+};
+
+/* デコーダハンドルプール */
+struct SLADecoderPool {
+  struct SLADecoder**           decoders;       /* プール中のハンドル */
+  uint8_t*                      in_use;         /* ハンドルが貸出中か */
+  struct SLADecoderBatchWorker* workers;        /* 一括デコードのワーカ（ハンドル毎） */
+  uint32_t                      num_decoders;   /* ハンドル数         */
+  void*                         work;           /* ワーク領域         */
+};
+
+/* デコーダハンドルの作成に必要なワークサイズ計算 */
+/* 補足）合計はuint64_tで計算し、int32_tで表せなければ-1を返す */
+int32_t SLADecoder_CalculateWorkSize(const struct SLADecoderConfig* config)
+{
+  uint64_t work_size;
+  int32_t coder_work_size, lpcs_work_size, ltms_work_size, lms_work_size, emp_work_size;
+  uint32_t max_num_channels, max_num_block_samples;
+
+  /* 引数チェック */
+  if (config == NULL) {
+    return -1;
+  }
+
+  /* 下位モジュールのサイズ計算（32bit）が桁あふれしない範囲に制限 */
+  if (config->max_num_block_samples > SLA_MAX_NUM_BLOCK_SAMPLES) {
+    return -1;
+  }
+
+  /* 頻繁に参照する変数をオート変数に受ける */
+  max_num_channels      = config->max_num_channels;
+  max_num_block_samples = config->max_num_block_samples;
+
+  /* ハンドル本体 */
+  work_size = (uint64_t)SLA_MEMORY_ALIGNMENT + SLAUTILITY_WORK_SIZE64(sizeof(struct SLADecoder));
+
+  /* チャンネル毎の領域を指すポインタ配列 */
+  work_size += 6 * SLAUTILITY_WORK_SIZE64(sizeof(int32_t *) * max_num_channels);  /* parcor_coef, longterm_coef, residual, output, range_buffer, range_output */
+  work_size += 2 * SLAUTILITY_WORK_SIZE64(sizeof(void *) * max_num_channels);     /* channel_data, block_channel_data */
+  work_size += SLAUTILITY_WORK_SIZE64(sizeof(uint32_t) * max_num_channels);       /* raw_data_bits */
+  work_size += SLAUTILITY_WORK_SIZE64(sizeof(uint32_t) * max_num_channels);       /* pitch_period */
+  work_size += SLAUTILITY_WORK_SIZE64(sizeof(uint8_t) * max_num_channels);        /* is_int16_synthesizable */
+
+  /* チャンネル毎の領域 */
+  work_size += (uint64_t)max_num_channels * (
+      SLAUTILITY_WORK_SIZE64(sizeof(int32_t) * (config->max_parcor_order + 1))
+      + SLAUTILITY_WORK_SIZE64(sizeof(int32_t) * config->max_longterm_order)
+      + 3 * SLAUTILITY_WORK_SIZE64(sizeof(int32_t) * max_num_block_samples));
+
+  /* 符号化ハンドル */
+  if ((coder_work_size = SLACoder_CalculateWorkSize(max_num_channels, SLACODER_NUM_RECURSIVERICE_PARAMETER)) < 0) {
+    return -1;
+  }
+  work_size += (uint64_t)coder_work_size;
+
+  /* チャンネル毎の合成ハンドル */
+  work_size += SLAUTILITY_WORK_SIZE64(sizeof(struct SLALPCSynthesizer *) * max_num_channels);
+  work_size += SLAUTILITY_WORK_SIZE64(sizeof(struct SLALongTermSynthesizer *) * max_num_channels);
+  work_size += SLAUTILITY_WORK_SIZE64(sizeof(struct SLALMSFilter *) * max_num_channels);
+  work_size += SLAUTILITY_WORK_SIZE64(sizeof(struct SLAEmphasisFilter *) * max_num_channels);
+  lpcs_work_size  = SLALPCSynthesizer_CalculateWorkSize(config->max_parcor_order);
+  ltms_work_size  = SLALongTermSynthesizer_CalculateWorkSize(config->max_longterm_order, SLALONGTERM_MAX_PERIOD);
+  lms_work_size   = SLALMSFilter_CalculateWorkSize(config->max_lms_order_per_filter);
+  emp_work_size   = SLAEmphasisFilter_CalculateWorkSize();
+  if ((lpcs_work_size < 0) || (ltms_work_size < 0) || (lms_work_size < 0) || (emp_work_size < 0)) {
+    return -1;
+  }
+  work_size += (uint64_t)max_num_channels * ((uint64_t)lpcs_work_size
+      + (uint64_t)ltms_work_size + (uint64_t)lms_work_size + (uint64_t)emp_work_size);
+
+  /* int32_tで表せないサイズ */
+  if (work_size > INT32_MAX) {
+    return -1;
+  }
+
+  return (int32_t)work_size;
+}
+
+/* デコーダハンドルの作成（ワーク領域指定） */
+struct SLADecoder* SLADecoder_CreateWithWork(const struct SLADecoderConfig* config, void* work, int32_t work_size)
 {
   struct SLADecoder* decoder;
   uint32_t ch;
   uint32_t max_num_channels, max_num_block_samples;
+  int32_t required_work_size, tmp_work_size;
+  uint8_t* work_ptr;
 
   /* 引数チェック */
-  if (config == NULL) {
+  required_work_size = SLADecoder_CalculateWorkSize(config);
+  if ((work == NULL) || (required_work_size < 0) || (work_size < required_work_size)) {
     return NULL;
   }
 
@@ -80,7 +198,9 @@ struct SLADecoder* SLADecoder_Create(const struct SLADecoderConfig* config)
   max_num_channels      = config->max_num_channels;
   max_num_block_samples = config->max_num_block_samples;
 
-  decoder = malloc(sizeof(struct SLADecoder));
+  work_ptr = SLAUTILITY_ALIGN_WORK(work);
+
+  decoder = (struct SLADecoder *)SLAUtility_AllocateWork(&work_ptr, sizeof(struct SLADecoder));
   decoder->max_num_channels         = config->max_num_channels;
   decoder->max_num_block_samples    = config->max_num_block_samples;
   decoder->max_parcor_order         = config->max_parcor_order;
@@ -88,69 +208,115 @@ struct SLADecoder* SLADecoder_Create(const struct SLADecoderConfig* config)
   decoder->max_lms_order_per_filter = config->max_lms_order_per_filter;
   decoder->enable_crc_check         = config->enable_crc_check;
   decoder->verpose_flag             = config->verpose_flag;
+  decoder->block_cache              = NULL;
+  decoder->block_cache_stream_id    = 0;
+  decoder->alloced_by_own           = 0;
+  decoder->work                     = work;
 
   /* 各種領域割り当て */
-  decoder->parcor_coef   = (int32_t **)malloc(sizeof(int32_t*) * max_num_channels);
-  decoder->longterm_coef = (int32_t **)malloc(sizeof(int32_t*) * max_num_channels);
-  decoder->pitch_period  = (uint32_t *)malloc(sizeof(uint32_t) * max_num_channels);
-  decoder->residual      = (int32_t **)malloc(sizeof(int32_t*) * max_num_channels);
-  decoder->output        = (int32_t **)malloc(sizeof(int32_t*) * max_num_channels);
+  decoder->parcor_coef   = (int32_t **)SLAUtility_AllocateWork(&work_ptr, sizeof(int32_t*) * max_num_channels);
+  decoder->longterm_coef = (int32_t **)SLAUtility_AllocateWork(&work_ptr, sizeof(int32_t*) * max_num_channels);
+  decoder->pitch_period  = (uint32_t *)SLAUtility_AllocateWork(&work_ptr, sizeof(uint32_t) * max_num_channels);
+  decoder->is_int16_synthesizable = (uint8_t *)SLAUtility_AllocateWork(&work_ptr, sizeof(uint8_t) * max_num_channels);
+  decoder->residual      = (int32_t **)SLAUtility_AllocateWork(&work_ptr, sizeof(int32_t*) * max_num_channels);
+  decoder->output        = (int32_t **)SLAUtility_AllocateWork(&work_ptr, sizeof(int32_t*) * max_num_channels);
+  decoder->range_buffer  = (int32_t **)SLAUtility_AllocateWork(&work_ptr, sizeof(int32_t*) * max_num_channels);
+  decoder->range_output  = (int32_t **)SLAUtility_AllocateWork(&work_ptr, sizeof(int32_t*) * max_num_channels);
+  decoder->channel_data  = (void **)SLAUtility_AllocateWork(&work_ptr, sizeof(void*) * max_num_channels);
+  decoder->block_channel_data = (void **)SLAUtility_AllocateWork(&work_ptr, sizeof(void*) * max_num_channels);
+  decoder->raw_data_bits = (uint32_t *)SLAUtility_AllocateWork(&work_ptr, sizeof(uint32_t) * max_num_channels);
   for (ch = 0; ch < max_num_channels; ch++) {
-    decoder->parcor_coef[ch]    = (int32_t *)malloc(sizeof(int32_t) * (config->max_parcor_order + 1));
-    decoder->longterm_coef[ch]  = (int32_t *)malloc(sizeof(int32_t) * config->max_longterm_order);
-    decoder->residual[ch]       = (int32_t *)malloc(sizeof(int32_t) * max_num_block_samples);
-    decoder->output[ch]         = (int32_t *)malloc(sizeof(int32_t) * max_num_block_samples);
+    decoder->parcor_coef[ch]    = (int32_t *)SLAUtility_AllocateWork(&work_ptr, sizeof(int32_t) * (config->max_parcor_order + 1));
+    decoder->longterm_coef[ch]  = (int32_t *)SLAUtility_AllocateWork(&work_ptr, sizeof(int32_t) * config->max_longterm_order);
+    decoder->residual[ch]       = (int32_t *)SLAUtility_AllocateWork(&work_ptr, sizeof(int32_t) * max_num_block_samples);
+    decoder->output[ch]         = (int32_t *)SLAUtility_AllocateWork(&work_ptr, sizeof(int32_t) * max_num_block_samples);
+    decoder->range_buffer[ch]   = (int32_t *)SLAUtility_AllocateWork(&work_ptr, sizeof(int32_t) * max_num_block_samples);
   }
 
-  decoder->coder  = SLACoder_Create(config->max_num_channels, SLACODER_NUM_RECURSIVERICE_PARAMETER);
+  tmp_work_size   = SLACoder_CalculateWorkSize(config->max_num_channels, SLACODER_NUM_RECURSIVERICE_PARAMETER);
+  decoder->coder  = SLACoder_CreateWithWork(config->max_num_channels, SLACODER_NUM_RECURSIVERICE_PARAMETER,
+      SLAUtility_AllocateWork(&work_ptr, (size_t)tmp_work_size), tmp_work_size);
 
   /* 合成ハンドル作成 */
-  decoder->lpcs   = (struct SLALPCSynthesizer **)malloc(sizeof(struct SLALPCSynthesizer *) * max_num_channels);
-  decoder->ltms   = (struct SLALongTermSynthesizer **)malloc(sizeof(struct SLALongTermSynthesizer *) * max_num_channels);
-  decoder->nlmsc  = (struct SLALMSFilter **)malloc(sizeof(struct SLALMSFilter *) * max_num_channels);
-  decoder->emp    = (struct SLAEmphasisFilter **)malloc(sizeof(struct SLAEmphasisFilter *) * max_num_channels);
+  decoder->lpcs   = (struct SLALPCSynthesizer **)SLAUtility_AllocateWork(&work_ptr, sizeof(struct SLALPCSynthesizer *) * max_num_channels);
+  decoder->ltms   = (struct SLALongTermSynthesizer **)SLAUtility_AllocateWork(&work_ptr, sizeof(struct SLALongTermSynthesizer *) * max_num_channels);
+  decoder->nlmsc  = (struct SLALMSFilter **)SLAUtility_AllocateWork(&work_ptr, sizeof(struct SLALMSFilter *) * max_num_channels);
+  decoder->emp    = (struct SLAEmphasisFilter **)SLAUtility_AllocateWork(&work_ptr, sizeof(struct SLAEmphasisFilter *) * max_num_channels);
   for (ch = 0; ch < max_num_channels; ch++) {
-    decoder->lpcs[ch]   = SLALPCSynthesizer_Create(config->max_parcor_order);
-    decoder->ltms[ch]   = SLALongTermSynthesizer_Create(config->max_longterm_order, SLALONGTERM_MAX_PERIOD);
-    decoder->nlmsc[ch]  = SLALMSFilter_Create(config->max_lms_order_per_filter);
-    decoder->emp[ch]    = SLAEmphasisFilter_Create();
+    tmp_work_size       = SLALPCSynthesizer_CalculateWorkSize(config->max_parcor_order);
+    decoder->lpcs[ch]   = SLALPCSynthesizer_CreateWithWork(config->max_parcor_order,
+        SLAUtility_AllocateWork(&work_ptr, (size_t)tmp_work_size), tmp_work_size);
+    tmp_work_size       = SLALongTermSynthesizer_CalculateWorkSize(config->max_longterm_order, SLALONGTERM_MAX_PERIOD);
+    decoder->ltms[ch]   = SLALongTermSynthesizer_CreateWithWork(config->max_longterm_order, SLALONGTERM_MAX_PERIOD,
+        SLAUtility_AllocateWork(&work_ptr, (size_t)tmp_work_size), tmp_work_size);
+    tmp_work_size       = SLALMSFilter_CalculateWorkSize(config->max_lms_order_per_filter);
+    decoder->nlmsc[ch]  = SLALMSFilter_CreateWithWork(config->max_lms_order_per_filter,
+        SLAUtility_AllocateWork(&work_ptr, (size_t)tmp_work_size), tmp_work_size);
+    tmp_work_size       = SLAEmphasisFilter_CalculateWorkSize();
+    decoder->emp[ch]    = SLAEmphasisFilter_CreateWithWork(
+        SLAUtility_AllocateWork(&work_ptr, (size_t)tmp_work_size), tmp_work_size);
   }
 
+  SLA_Assert((work_ptr - (uint8_t *)work) <= work_size);
+
   /* 状態管理フラグをすべて落とす */
   decoder->status_flag = 0;
-   
+  decoder->synthesize_function = NULL;
+
+#ifdef SLA_ENABLE_STATISTICS
+  /* 統計情報のクリアとヒストグラム記録先の設定 */
+  memset(&decoder->statistics, 0, sizeof(struct SLAStatistics));
+  SLACoder_SetRiceParameterHistogram(decoder->coder, decoder->statistics.rice_parameter_histogram);
+#endif
+
+  return decoder;
+}
+
+/* デコーダハンドルの作成 */
+struct SLADecoder* SLADecoder_Create(const struct SLADecoderConfig* config)
+{
+  int32_t work_size;
+  void* work;
+  struct SLADecoder* decoder;
+
+  if ((work_size = SLADecoder_CalculateWorkSize(config)) < 0) {
+    return NULL;
+  }
+
+  work = malloc((size_t)work_size);
+  if ((decoder = SLADecoder_CreateWithWork(config, work, work_size)) == NULL) {
+    NULLCHECK_AND_FREE(work);
+    return NULL;
+  }
+  decoder->alloced_by_own = 1;
+
   return decoder;
 }
 
 /* デコーダハンドルの破棄 */
+/* 補足）内部ハンドルも含めて全てワーク領域上にあるため、ワーク領域の解放のみ行う */
 void SLADecoder_Destroy(struct SLADecoder* decoder)
 {
-  uint32_t ch;
+  if ((decoder != NULL) && decoder->alloced_by_own) {
+    free(decoder->work);
+  }
+}
 
-  if (decoder != NULL) {
-    for (ch = 0; ch < decoder->max_num_channels; ch++) {
-      NULLCHECK_AND_FREE(decoder->output[ch]);
-      NULLCHECK_AND_FREE(decoder->residual[ch]);
-      NULLCHECK_AND_FREE(decoder->parcor_coef[ch]);
-      NULLCHECK_AND_FREE(decoder->longterm_coef[ch]);
-    }
-    NULLCHECK_AND_FREE(decoder->residual);
-    NULLCHECK_AND_FREE(decoder->output);
-    NULLCHECK_AND_FREE(decoder->parcor_coef);
-    NULLCHECK_AND_FREE(decoder->longterm_coef);
-    for (ch = 0; ch < decoder->max_num_channels; ch++) {
-      SLALPCSynthesizer_Destroy(decoder->lpcs[ch]);
-      SLALongTermSynthesizer_Destroy(decoder->ltms[ch]);
-      SLALMSFilter_Destroy(decoder->nlmsc[ch]);
-      SLAEmphasisFilter_Destroy(decoder->emp[ch]);
-    }
-    NULLCHECK_AND_FREE(decoder->lpcs);
-    NULLCHECK_AND_FREE(decoder->ltms);
-    NULLCHECK_AND_FREE(decoder->nlmsc);
-    NULLCHECK_AND_FREE(decoder->emp);
-    SLACoder_Destroy(decoder->coder);
-    free(decoder);
+/* デコーダハンドルを新しいストリーム向けにリセット */
+SLAApiResult SLADecoder_Reset(struct SLADecoder* decoder)
+{
+  /* 引数チェック */
+  if (decoder == NULL) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
   }
+
+  /* パラメータ・ブロック途中の状態を破棄 */
+  /* 補足）合成ハンドルの状態はブロック先頭で毎回リセットされる */
+  decoder->status_flag          = 0;
+  decoder->synthesize_function  = NULL;
+  decoder->block_cache          = NULL;
+
+  return SLA_APIRESULT_OK;
 }
 
 /* ヘッダデコード */
@@ -158,8 +324,8 @@ SLAApiResult SLADecoder_DecodeHeader(
     const uint8_t* data, uint32_t data_size, struct SLAHeaderInfo* header_info)
 {
   const uint8_t* data_pos;
-  uint32_t u32buf;
-  uint16_t u16buf;
+  uint32_t u32buf, format_version, header_size;
+  uint16_t u16buf, crc16;
   uint8_t  u8buf;
   struct SLAHeaderInfo tmp_header;
   SLAApiResult ret;
@@ -170,7 +336,7 @@ SLAApiResult SLADecoder_DecodeHeader(
   }
 
   /* データサイズが足らない */
-  if (data_size < SLA_HEADER_SIZE) {
+  if (data_size < SLA_HEADER_SIZE_V1) {
     return SLA_APIRESULT_INSUFFICIENT_DATA_SIZE;
   }
 
@@ -197,24 +363,45 @@ SLAApiResult SLADecoder_DecodeHeader(
   /* 一番最初のデータブロックまでのオフセット */
   SLAByteArray_GetUint32(data_pos, &u32buf);
   /* これ以降のフィールドで、ヘッダ末尾までのCRC16 */
-  SLAByteArray_GetUint16(data_pos, &u16buf);
+  SLAByteArray_GetUint16(data_pos, &crc16);
+  /* フォーマットバージョン */
+  SLAByteArray_GetUint32(data_pos, &format_version);
+  /* 知らないバージョンの場合は無条件でエラー */
+  switch (format_version) {
+    case 1:
+      header_size = SLA_HEADER_SIZE_V1;
+      break;
+    case 2:
+      header_size = SLA_HEADER_SIZE_V2;
+      break;
+    case SLA_FORMAT_VERSION:
+      header_size = SLA_HEADER_SIZE;
+      break;
+    default:
+      return SLA_APIRESULT_INVALID_HEADER_FORMAT;
+  }
+  /* バージョン毎のサイズが揃っているか */
+  if (data_size < header_size) {
+    return SLA_APIRESULT_INSUFFICIENT_DATA_SIZE;
+  }
   /* CRC16計算 */
-  if (u16buf != SLAUtility_CalculateCRC16(
-        &data[SLA_HEADER_CRC16_CALC_START_OFFSET], SLA_HEADER_SIZE - SLA_HEADER_CRC16_CALC_START_OFFSET)) {
+  if (crc16 != SLAUtility_CalculateCRC16(
+        &data[SLA_HEADER_CRC16_CALC_START_OFFSET], header_size - SLA_HEADER_CRC16_CALC_START_OFFSET)) {
     /* 不一致を検出: 返り値をデータ破損検出とする */
     ret = SLA_APIRESULT_DETECT_DATA_CORRUPTION;
   }
-  /* フォーマットバージョン */
-  SLAByteArray_GetUint32(data_pos, &u32buf);
-  /* 今のところはバージョン不一致の場合は無条件でエラー */
-  if (u32buf != SLA_FORMAT_VERSION) {
-    return SLA_APIRESULT_INVALID_HEADER_FORMAT;
-  }
+  tmp_header.header_size = header_size;
   /* チャンネル数 */
   SLAByteArray_GetUint8(data_pos, &u8buf);
   tmp_header.wave_format.num_channels       = (uint32_t)u8buf;
   /* サンプル数 */
-  SLAByteArray_GetUint32(data_pos, &tmp_header.num_samples);
+  if (format_version == 1) {
+    /* バージョン1は32bit */
+    SLAByteArray_GetUint32(data_pos, &u32buf);
+    tmp_header.num_samples = (u32buf == 0xFFFFFFFFUL) ? SLA_NUM_SAMPLES_INVALID : u32buf;
+  } else {
+    SLAByteArray_GetUint64(data_pos, &tmp_header.num_samples);
+  }
   /* サンプリングレート */
   SLAByteArray_GetUint32(data_pos, &tmp_header.wave_format.sampling_rate);
   /* サンプルあたりビット数 */
@@ -238,15 +425,36 @@ SLAApiResult SLADecoder_DecodeHeader(
   SLAByteArray_GetUint32(data_pos, &u32buf);
   tmp_header.num_blocks = u32buf;
   /* SLAブロックあたり最大サンプル数 */
-  SLAByteArray_GetUint16(data_pos, &u16buf);
-  tmp_header.encode_param.max_num_block_samples = (uint32_t)u16buf;
+  if (format_version <= 2) {
+    /* バージョン2までは16bit */
+    SLAByteArray_GetUint16(data_pos, &u16buf);
+    tmp_header.encode_param.max_num_block_samples = (uint32_t)u16buf;
+  } else {
+    SLAByteArray_GetUint32(data_pos, &tmp_header.encode_param.max_num_block_samples);
+  }
   /* 最大ブロックサイズ */
   SLAByteArray_GetUint32(data_pos, &tmp_header.max_block_size);
   /* 最大bps */
   SLAByteArray_GetUint32(data_pos, &tmp_header.max_bit_per_second);
 
   /* ヘッダサイズチェック */
-  SLA_Assert((data_pos - data) == SLA_HEADER_SIZE);
+  SLA_Assert((data_pos - data) == (int32_t)header_size);
+
+  /* ハンドルの領域サイズを決める値の範囲チェック */
+  if ((tmp_header.wave_format.num_channels == 0)
+      || (tmp_header.wave_format.num_channels > SLA_MAX_NUM_CHANNELS)
+      || (tmp_header.encode_param.max_num_block_samples == 0)
+      || (tmp_header.encode_param.max_num_block_samples > SLA_MAX_NUM_BLOCK_SAMPLES)) {
+    return SLA_APIRESULT_INVALID_HEADER_FORMAT;
+  }
+
+  /* 最大ブロックサイズの範囲チェック */
+  /* 補足）ブロックを1つも含まないデータのみ0を許す */
+  if ((tmp_header.max_block_size != SLA_MAX_BLOCK_SIZE_INVAILD)
+      && (tmp_header.max_block_size < SLA_MINIMUM_BLOCK_HEADER_SIZE)
+      && ((tmp_header.max_block_size != 0) || (tmp_header.num_blocks != 0))) {
+    return SLA_APIRESULT_INVALID_HEADER_FORMAT;
+  }
 
   /* 出力に書き込むが、ステータスは破壊検知の場合もある */
   *header_info = tmp_header;
@@ -277,6 +485,163 @@ SLAApiResult SLADecoder_SetWaveFormat(struct SLADecoder* decoder,
   return SLA_APIRESULT_OK;
 }
 
+/* チャンネル単位の音声合成（汎用版） */
+static SLAApiResult SLADecoder_SynthesizeGeneric(
+    struct SLADecoder* decoder, uint32_t ch, uint32_t num_samples)
+{
+  /* LMSの残差分を合成 */
+  SLA_STATISTICS_START_STAGE(decoder);
+  if (SLALMSFilter_SynthesizeInt32(decoder->nlmsc[ch],
+        decoder->encode_param.lms_order_per_filter,
+        decoder->residual[ch], num_samples,
+        decoder->output[ch]) != SLAPREDICTOR_APIRESULT_OK) {
+    return SLA_APIRESULT_FAILED_TO_SYNTHESIZE;
+  }
+  /* 合成した信号で残差を差し替え */
+  memcpy(decoder->residual[ch], decoder->output[ch], sizeof(int32_t) * num_samples);
+  SLA_STATISTICS_END_STAGE(decoder, SLA_STATISTICS_STAGE_LMS);
+
+  /* ロングタームの残差分を合成 */
+  SLA_STATISTICS_START_STAGE(decoder);
+  if (decoder->pitch_period[ch] != 0) {
+    if (SLALongTermSynthesizer_SynthesizeInt32(
+          decoder->ltms[ch],
+          decoder->residual[ch], num_samples,
+          decoder->pitch_period[ch], decoder->longterm_coef[ch],
+          decoder->encode_param.longterm_order, decoder->output[ch]) != SLAPREDICTOR_APIRESULT_OK) {
+      return SLA_APIRESULT_FAILED_TO_SYNTHESIZE;
+    }
+    /* 合成した信号で残差を差し替え */
+    memcpy(decoder->residual[ch], decoder->output[ch], sizeof(int32_t) * num_samples);
+  }
+  SLA_STATISTICS_END_STAGE(decoder, SLA_STATISTICS_STAGE_LONGTERM);
+
+  /* PARCORの残差分を合成 */
+  SLA_STATISTICS_START_STAGE(decoder);
+  if (decoder->is_int16_synthesizable[ch] == 1) {
+    /* 16bit幅で合成（途中で16bit幅を超えたら32bit幅で合成） */
+    if (SLALPCSynthesizer_SynthesizeByParcorCoefInt16(decoder->lpcs[ch],
+          decoder->residual[ch], num_samples,
+          decoder->parcor_coef[ch], decoder->encode_param.parcor_order,
+          decoder->output[ch]) != SLAPREDICTOR_APIRESULT_OK) {
+      return SLA_APIRESULT_FAILED_TO_SYNTHESIZE;
+    }
+  } else {
+    if (SLALPCSynthesizer_SynthesizeByParcorCoefInt32(decoder->lpcs[ch],
+          decoder->residual[ch], num_samples,
+          decoder->parcor_coef[ch], decoder->encode_param.parcor_order,
+          decoder->output[ch]) != SLAPREDICTOR_APIRESULT_OK) {
+      return SLA_APIRESULT_FAILED_TO_SYNTHESIZE;
+    }
+  }
+
+  /* デエンファシス */
+  if (SLAEmphasisFilter_DeEmphasisInt32(decoder->emp[ch], 
+        decoder->output[ch], num_samples, 
+        SLA_PRE_EMPHASIS_COEFFICIENT_SHIFT) != SLAPREDICTOR_APIRESULT_OK) {
+    return SLA_APIRESULT_FAILED_TO_SYNTHESIZE;
+  }
+  SLA_STATISTICS_END_STAGE(decoder, SLA_STATISTICS_STAGE_LPC);
+
+  return SLA_APIRESULT_OK;
+}
+
+/* 次数固定のチャンネル単位の音声合成関数の定義 */
+/* 補足）各予測器の次数固定版を直接呼び出す。処理内容は汎用版と同一 */
+#define SLADECODER_DEFINE_SYNTHESIZE_FUNCTION(parcor_order, longterm_order, lms_order) \
+static SLAApiResult SLADecoder_SynthesizeP##parcor_order##L##longterm_order##M##lms_order(\
+    struct SLADecoder* decoder, uint32_t ch, uint32_t num_samples)\
+{\
+  /* LMSの残差分を合成 */\
+  SLA_STATISTICS_START_STAGE(decoder);\
+  if (SLALMSFilter_SynthesizeInt32Order##lms_order(decoder->nlmsc[ch],\
+        decoder->residual[ch], num_samples,\
+        decoder->output[ch]) != SLAPREDICTOR_APIRESULT_OK) {\
+    return SLA_APIRESULT_FAILED_TO_SYNTHESIZE;\
+  }\
+  memcpy(decoder->residual[ch], decoder->output[ch], sizeof(int32_t) * num_samples);\
+  SLA_STATISTICS_END_STAGE(decoder, SLA_STATISTICS_STAGE_LMS);\
+\
+  /* ロングタームの残差分を合成 */\
+  SLA_STATISTICS_START_STAGE(decoder);\
+  if (decoder->pitch_period[ch] != 0) {\
+    if (SLALongTermSynthesizer_SynthesizeInt32Taps##longterm_order(decoder->ltms[ch],\
+          decoder->residual[ch], num_samples,\
+          decoder->pitch_period[ch], decoder->longterm_coef[ch],\
+          decoder->output[ch]) != SLAPREDICTOR_APIRESULT_OK) {\
+      return SLA_APIRESULT_FAILED_TO_SYNTHESIZE;\
+    }\
+    memcpy(decoder->residual[ch], decoder->output[ch], sizeof(int32_t) * num_samples);\
+  }\
+  SLA_STATISTICS_END_STAGE(decoder, SLA_STATISTICS_STAGE_LONGTERM);\
+\
+  /* PARCORの残差分を合成 */\
+  SLA_STATISTICS_START_STAGE(decoder);\
+  if (decoder->is_int16_synthesizable[ch] == 1) {\
+    if (SLALPCSynthesizer_SynthesizeByParcorCoefInt16(decoder->lpcs[ch],\
+          decoder->residual[ch], num_samples,\
+          decoder->parcor_coef[ch], (parcor_order),\
+          decoder->output[ch]) != SLAPREDICTOR_APIRESULT_OK) {\
+      return SLA_APIRESULT_FAILED_TO_SYNTHESIZE;\
+    }\
+  } else {\
+    if (SLALPCSynthesizer_SynthesizeByParcorCoefInt32Order##parcor_order(decoder->lpcs[ch],\
+          decoder->residual[ch], num_samples,\
+          decoder->parcor_coef[ch], decoder->output[ch]) != SLAPREDICTOR_APIRESULT_OK) {\
+      return SLA_APIRESULT_FAILED_TO_SYNTHESIZE;\
+    }\
+  }\
+\
+  /* デエンファシス */\
+  if (SLAEmphasisFilter_DeEmphasisInt32(decoder->emp[ch],\
+        decoder->output[ch], num_samples,\
+        SLA_PRE_EMPHASIS_COEFFICIENT_SHIFT) != SLAPREDICTOR_APIRESULT_OK) {\
+    return SLA_APIRESULT_FAILED_TO_SYNTHESIZE;\
+  }\
+  SLA_STATISTICS_END_STAGE(decoder, SLA_STATISTICS_STAGE_LPC);\
+\
+  return SLA_APIRESULT_OK;\
+}
+
+/* 次数固定のチャンネル単位の音声合成関数の実体（エンコードプリセットで使用する組み合わせ） */
+SLADECODER_DEFINE_SYNTHESIZE_FUNCTION( 8, 1, 4)
+SLADECODER_DEFINE_SYNTHESIZE_FUNCTION( 8, 1, 8)
+SLADECODER_DEFINE_SYNTHESIZE_FUNCTION(16, 1, 8)
+SLADECODER_DEFINE_SYNTHESIZE_FUNCTION(32, 3, 8)
+
+/* 次数固定の音声合成関数テーブル */
+static const struct SLADecoderSynthesizeFunctionEntry {
+  uint32_t                      parcor_order;
+  uint32_t                      longterm_order;
+  uint32_t                      lms_order_per_filter;
+  SLADecoderSynthesizeFunction  function;
+} st_synthesize_function_table[] = {
+  {  8, 1, 4, SLADecoder_SynthesizeP8L1M4  },
+  {  8, 1, 8, SLADecoder_SynthesizeP8L1M8  },
+  { 16, 1, 8, SLADecoder_SynthesizeP16L1M8 },
+  { 32, 3, 8, SLADecoder_SynthesizeP32L3M8 },
+};
+
+/* 次数に合った音声合成関数の選択 見つからない場合は汎用版 */
+static SLADecoderSynthesizeFunction SLADecoder_SelectSynthesizeFunction(
+    const struct SLAEncodeParameter* encode_param)
+{
+  uint32_t i;
+  const uint32_t num_entries
+    = sizeof(st_synthesize_function_table) / sizeof(st_synthesize_function_table[0]);
+
+  for (i = 0; i < num_entries; i++) {
+    const struct SLADecoderSynthesizeFunctionEntry* entry = &st_synthesize_function_table[i];
+    if ((entry->parcor_order == encode_param->parcor_order)
+        && (entry->longterm_order == encode_param->longterm_order)
+        && (entry->lms_order_per_filter == encode_param->lms_order_per_filter)) {
+      return entry->function;
+    }
+  }
+
+  return SLADecoder_SynthesizeGeneric;
+}
+
 /* エンコードパラメータをデコーダにセット */
 SLAApiResult SLADecoder_SetEncodeParameter(struct SLADecoder* decoder,
     const struct SLAEncodeParameter* encode_param)
@@ -298,6 +663,9 @@ SLAApiResult SLADecoder_SetEncodeParameter(struct SLADecoder* decoder,
   /* パラメータをセット */
   decoder->encode_param = *encode_param;
 
+  /* 次数に合った音声合成関数を選択 */
+  decoder->synthesize_function = SLADecoder_SelectSynthesizeFunction(encode_param);
+
   /* パラメータセット済みに設定 */
   decoder->status_flag |= SLADECODER_STATUS_FLAG_SET_ENCODE_PARAMETER;
 
@@ -307,7 +675,7 @@ SLAApiResult SLADecoder_SetEncodeParameter(struct SLADecoder* decoder,
 /* ブロックヘッダ（ヘッダ+係数パラメータ）のデコード */
 /* FIXME: この関数内だけでストリームオープンとクローズを完結させたかったができていない */
 static SLAApiResult SLADecoder_DecodeBlockHeader(struct SLADecoder* decoder, 
-    const uint8_t* data, uint32_t data_size, 
+    const uint8_t* data, uint32_t data_size, uint8_t check_crc16,
     struct SLABlockHeaderInfo* block_header_info, uint32_t* block_header_size)
 {
   uint64_t bitsbuf;
@@ -342,12 +710,17 @@ static SLAApiResult SLADecoder_DecodeBlockHeader(struct SLADecoder* decoder,
   /* これ以降のフィールドのCRC16値 */
   SLABitReader_GetBits(&decoder->strm, &bitsbuf, 16);
   crc16 = (uint16_t)bitsbuf;
-  /* CRC16チェック: データ長がブロックサイズ分ないときはチェックできない */
-  if ((decoder->enable_crc_check == 1) && (data_size >= block_header_info->block_size)) {
+  /* CRC16チェック: ブロック全体が揃っていなければ照合できないのでデータ不足とする */
+  if (check_crc16 == 1) {
     uint16_t calc_crc16;
+    if (data_size < block_header_info->block_size) {
+      return SLA_APIRESULT_INSUFFICIENT_DATA_SIZE;
+    }
     SLA_Assert(block_header_info->block_size >= SLA_BLOCK_CRC16_CALC_START_OFFSET);
+    SLA_STATISTICS_START_STAGE(decoder);
     calc_crc16 = SLAUtility_CalculateCRC16(
         &data[SLA_BLOCK_CRC16_CALC_START_OFFSET], block_header_info->block_size - SLA_BLOCK_CRC16_CALC_START_OFFSET);
+    SLA_STATISTICS_END_STAGE(decoder, SLA_STATISTICS_STAGE_CRC);
     if (calc_crc16 != crc16) {
       /* 不一致を検出 */
       return SLA_APIRESULT_DETECT_DATA_CORRUPTION;
@@ -355,6 +728,13 @@ static SLAApiResult SLADecoder_DecodeBlockHeader(struct SLADecoder* decoder,
   }
   /* ブロックサンプル数 */
   SLABitReader_GetBits(&decoder->strm, &bitsbuf, 16);
+  if (bitsbuf == SLA_BLOCK_NUM_SAMPLES_ESCAPE) {
+    /* 16bitに収まらないサンプル数 */
+    if (data_size < SLA_EXTENDED_BLOCK_HEADER_SIZE) {
+      return SLA_APIRESULT_INSUFFICIENT_DATA_SIZE;
+    }
+    SLABitReader_GetBits(&decoder->strm, &bitsbuf, 32);
+  }
   block_header_info->block_num_samples = (uint32_t)bitsbuf;
   /* printf("next:%d crc16:%04X nsmpl:%d \n", next_block_offset, crc16, block_samples); */
   /* ブロックタイプ */
@@ -389,6 +769,13 @@ static SLAApiResult SLADecoder_DecodeBlockHeader(struct SLADecoder* decoder,
         = SLAUTILITY_SHIFT_RIGHT_ARITHMETIC(decoder->parcor_coef[ch][ord], rshift);
     }
 
+    /* 16bit幅の格子型フィルタで合成するか判定 */
+    /* 補足）右シフト量0はエンコーダがブロックのデータビット幅を16bit以下と判定した場合に限る */
+    /*       係数は16bitベースなので、データ幅も16bit以下ならば16bit幅での合成を試みる */
+    decoder->is_int16_synthesizable[ch]
+      = ((rshift == 0)
+          && ((decoder->wave_format.bit_per_sample - decoder->wave_format.offset_lshift) <= 16)) ? 1 : 0;
+
     /* ロングターム係数読み取り */
     SLABitReader_GetBits(&decoder->strm, &bitsbuf, 1);
     if (bitsbuf == 0) {
@@ -416,22 +803,181 @@ static SLAApiResult SLADecoder_DecodeBlockHeader(struct SLADecoder* decoder,
   /* ブロックヘッダサイズの取得 */
   SLABitStream_Tell(&decoder->strm, (int32_t *)block_header_size);
 
+  /* 統計情報の記録 */
+  SLA_STATISTICS_COUNT_BLOCK(decoder, decoder->block_data_type,
+      block_header_info->block_num_samples, *block_header_size, block_header_info->block_size);
+
+  return SLA_APIRESULT_OK;
+}
+
+/* PCMサンプル1個あたりのバイト数 */
+static uint32_t SLADecoder_GetPcmSampleBytes(SLAPcmSampleType sample_type)
+{
+  switch (sample_type) {
+    case SLA_PCM_SAMPLE_TYPE_INT16:         return 2;
+    case SLA_PCM_SAMPLE_TYPE_PACKED_INT24:  return 3;
+    default:                                break;
+  }
+  return 4;
+}
+
+/* PCM出力の内容チェック */
+static SLAApiResult SLADecoder_CheckPcmOutput(
+    const struct SLAPcmOutput* output, uint32_t num_channels, uint32_t bit_per_sample)
+{
+  uint32_t ch;
+
+  if ((output == NULL) || (output->channel_data == NULL) || (output->stride == 0)) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  for (ch = 0; ch < num_channels; ch++) {
+    if (output->channel_data[ch] == NULL) {
+      return SLA_APIRESULT_INVALID_ARGUMENT;
+    }
+  }
+
+  /* 型に収まらないビット幅 */
+  switch (output->sample_type) {
+    case SLA_PCM_SAMPLE_TYPE_INT16:
+      if (bit_per_sample > 16) {
+        return SLA_APIRESULT_INVALID_ARGUMENT;
+      }
+      break;
+    case SLA_PCM_SAMPLE_TYPE_PACKED_INT24:
+      if (bit_per_sample > 24) {
+        return SLA_APIRESULT_INVALID_ARGUMENT;
+      }
+      break;
+    case SLA_PCM_SAMPLE_TYPE_INT32:
+    case SLA_PCM_SAMPLE_TYPE_INT32_LEFT_JUSTIFIED:
+    case SLA_PCM_SAMPLE_TYPE_FLOAT32:
+      break;
+    default:
+      return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+
   return SLA_APIRESULT_OK;
 }
 
+/* PCM出力の書き込み先をoffsetサンプル進めたものを作成 */
+static void SLADecoder_OffsetPcmOutput(const struct SLAPcmOutput* output,
+    uint32_t num_channels, uint32_t offset, void** channel_data, struct SLAPcmOutput* offset_output)
+{
+  uint32_t ch;
+  const size_t offset_bytes
+    = (size_t)offset * output->stride * SLADecoder_GetPcmSampleBytes(output->sample_type);
+
+  SLA_Assert(num_channels <= SLA_MAX_NUM_CHANNELS);
+
+  for (ch = 0; ch < num_channels; ch++) {
+    channel_data[ch] = (uint8_t *)output->channel_data[ch] + offset_bytes;
+  }
+  offset_output->sample_type  = output->sample_type;
+  offset_output->channel_data = channel_data;
+  offset_output->stride       = output->stride;
+}
+
+/* チャンネル毎の32bit左詰め出力先のoffsetサンプル目をPCM出力として参照 */
+static void SLADecoder_SetLeftJustifiedPcmOutput(uint32_t num_channels,
+    int32_t* const* buffer, uint32_t offset, void** channel_data, struct SLAPcmOutput* pcm_output)
+{
+  uint32_t ch;
+
+  SLA_Assert(num_channels <= SLA_MAX_NUM_CHANNELS);
+
+  for (ch = 0; ch < num_channels; ch++) {
+    channel_data[ch] = &buffer[ch][offset];
+  }
+  pcm_output->sample_type   = SLA_PCM_SAMPLE_TYPE_INT32_LEFT_JUSTIFIED;
+  pcm_output->channel_data  = channel_data;
+  pcm_output->stride        = 1;
+}
+
+/* 最終結果をPCM出力の形式で書き出し */
+/* 補足）オフセット分の左シフト・型変換・インターリーブを1パスで行う */
+static void SLADecoder_OutputPcm(const struct SLADecoder* decoder,
+    const struct SLAPcmOutput* output, uint32_t num_samples)
+{
+  uint32_t  ch, smpl, stride, lshift, bit_per_sample;
+
+  SLA_Assert(decoder != NULL);
+  SLA_Assert(output != NULL);
+
+  stride          = output->stride;
+  lshift          = decoder->wave_format.offset_lshift;
+  bit_per_sample  = decoder->wave_format.bit_per_sample;
+
+  for (ch = 0; ch < decoder->wave_format.num_channels; ch++) {
+    const int32_t* src = decoder->output[ch];
+    switch (output->sample_type) {
+      case SLA_PCM_SAMPLE_TYPE_INT16:
+        {
+          int16_t* dst = (int16_t *)output->channel_data[ch];
+          for (smpl = 0; smpl < num_samples; smpl++) {
+            dst[(size_t)smpl * stride] = (int16_t)(src[smpl] << lshift);
+          }
+        }
+        break;
+      case SLA_PCM_SAMPLE_TYPE_PACKED_INT24:
+        {
+          uint8_t* dst = (uint8_t *)output->channel_data[ch];
+          for (smpl = 0; smpl < num_samples; smpl++) {
+            const uint32_t val = (uint32_t)(src[smpl] << lshift);
+            uint8_t* pdst = &dst[(size_t)smpl * stride * 3];
+            pdst[0] = (uint8_t)((val >>  0) & 0xFF);
+            pdst[1] = (uint8_t)((val >>  8) & 0xFF);
+            pdst[2] = (uint8_t)((val >> 16) & 0xFF);
+          }
+        }
+        break;
+      case SLA_PCM_SAMPLE_TYPE_INT32:
+        {
+          int32_t* dst = (int32_t *)output->channel_data[ch];
+          for (smpl = 0; smpl < num_samples; smpl++) {
+            dst[(size_t)smpl * stride] = src[smpl] << lshift;
+          }
+        }
+        break;
+      case SLA_PCM_SAMPLE_TYPE_INT32_LEFT_JUSTIFIED:
+        {
+          int32_t* dst = (int32_t *)output->channel_data[ch];
+          const uint32_t lj_lshift = 32 - bit_per_sample + lshift;
+          for (smpl = 0; smpl < num_samples; smpl++) {
+            dst[(size_t)smpl * stride] = src[smpl] << lj_lshift;
+          }
+        }
+        break;
+      case SLA_PCM_SAMPLE_TYPE_FLOAT32:
+        {
+          float* dst = (float *)output->channel_data[ch];
+          const double scale = pow(2, 1.0 - bit_per_sample);
+          for (smpl = 0; smpl < num_samples; smpl++) {
+            dst[(size_t)smpl * stride] = (float)((double)(src[smpl] << lshift) * scale);
+          }
+        }
+        break;
+      default:
+        SLA_Assert(0);
+    }
+  }
+}
+
 /* ブロックデータ（波形データ）のデコード */
 /* FIXME: この関数内だけでストリームオープンとクローズを完結させたかったができていない */
-/* 注意）data_sizeは消費したサイズを返すがバイト境界上にあるとは限らない */
+/* 注意）data_sizeは消費したサイズを返すがバイト境界上にあるとは限らない
+ *       outputがNULLの場合は内部領域（decoder->output）に右詰めの値を残す */
 static SLAApiResult SLADecoder_DecodeWaveData(struct SLADecoder* decoder, 
-    int32_t** buffer, uint32_t num_decode_saples, uint32_t* output_data_size)
+    const struct SLAPcmOutput* output, uint32_t num_decode_saples, uint32_t* output_data_size)
 {
   uint32_t ch, smpl;
   uint32_t num_channels;
   uint64_t bitsbuf;
   int32_t  start_data_offset, end_data_offset; 
+  SLAApiResult ret;
 
   /* 引数チェック */
-  if ((decoder == NULL) || (buffer == NULL)) {
+  if (decoder == NULL) {
     return SLA_APIRESULT_INVALID_ARGUMENT;
   }
 
@@ -448,6 +994,7 @@ static SLAApiResult SLADecoder_DecodeWaveData(struct SLADecoder* decoder,
   num_channels = decoder->wave_format.num_channels;
 
   /* 残差復号 */
+  SLA_STATISTICS_START_STAGE(decoder);
   switch (decoder->block_data_type) {
     case SLA_BLOCK_DATA_TYPE_SILENT:
       /* 無音で埋める */
@@ -458,7 +1005,7 @@ static SLAApiResult SLADecoder_DecodeWaveData(struct SLADecoder* decoder,
     case SLA_BLOCK_DATA_TYPE_RAWDATA:
       /* 生データ取得 */
       {
-        uint32_t input_bits[SLA_MAX_CHANNELS];
+        uint32_t* input_bits = decoder->raw_data_bits;
         for (ch = 0; ch < num_channels; ch++) {
           /* 左シフト量だけ減らして取得 */
           SLA_Assert(decoder->wave_format.bit_per_sample > decoder->wave_format.offset_lshift);
@@ -489,50 +1036,14 @@ static SLAApiResult SLADecoder_DecodeWaveData(struct SLADecoder* decoder,
       SLA_Assert(0);
       break;
   }
+  SLA_STATISTICS_END_STAGE(decoder, SLA_STATISTICS_STAGE_ENTROPY_CODING);
 
   /* チャンネル毎に音声合成 */
-  for (ch = 0; ch < num_channels; ch++) {
-    /* 圧縮されたブロック以外ではスキップ */
-    if (decoder->block_data_type != SLA_BLOCK_DATA_TYPE_COMPRESSDATA) {
-      break;
-    }
-
-    /* LMSの残差分を合成 */
-    if (SLALMSFilter_SynthesizeInt32(decoder->nlmsc[ch],
-          decoder->encode_param.lms_order_per_filter,
-          decoder->residual[ch], num_decode_saples,
-          decoder->output[ch]) != SLAPREDICTOR_APIRESULT_OK) {
-      return SLA_APIRESULT_FAILED_TO_SYNTHESIZE;
-    }
-    /* 合成した信号で残差を差し替え */
-    memcpy(decoder->residual[ch], decoder->output[ch], sizeof(int32_t) * num_decode_saples);
-
-    /* ロングタームの残差分を合成 */
-    if (decoder->pitch_period[ch] != 0) {
-      if (SLALongTermSynthesizer_SynthesizeInt32(
-            decoder->ltms[ch],
-            decoder->residual[ch], num_decode_saples,
-            decoder->pitch_period[ch], decoder->longterm_coef[ch],
-            decoder->encode_param.longterm_order, decoder->output[ch]) != SLAPREDICTOR_APIRESULT_OK) {
-        return SLA_APIRESULT_FAILED_TO_SYNTHESIZE;
+  if (decoder->block_data_type == SLA_BLOCK_DATA_TYPE_COMPRESSDATA) {
+    for (ch = 0; ch < num_channels; ch++) {
+      if ((ret = decoder->synthesize_function(decoder, ch, num_decode_saples)) != SLA_APIRESULT_OK) {
+        return ret;
       }
-      /* 合成した信号で残差を差し替え */
-      memcpy(decoder->residual[ch], decoder->output[ch], sizeof(int32_t) * num_decode_saples);
-    }
-
-    /* PARCORの残差分を合成 */
-    if (SLALPCSynthesizer_SynthesizeByParcorCoefInt32(decoder->lpcs[ch],
-          decoder->residual[ch], num_decode_saples,
-          decoder->parcor_coef[ch], decoder->encode_param.parcor_order,
-          decoder->output[ch]) != SLAPREDICTOR_APIRESULT_OK) {
-      return SLA_APIRESULT_FAILED_TO_SYNTHESIZE;
-    }
-
-    /* デエンファシス */
-    if (SLAEmphasisFilter_DeEmphasisInt32(decoder->emp[ch], 
-          decoder->output[ch], num_decode_saples, 
-          SLA_PRE_EMPHASIS_COEFFICIENT_SHIFT) != SLAPREDICTOR_APIRESULT_OK) {
-      return SLA_APIRESULT_FAILED_TO_SYNTHESIZE;
     }
   }
 
@@ -545,13 +1056,17 @@ static SLAApiResult SLADecoder_DecodeWaveData(struct SLADecoder* decoder,
       break;
   }
 
-  /* 最終結果をバッファにコピー */
+  /* 最終結果を出力 */
   SLA_Assert(decoder->wave_format.bit_per_sample > decoder->wave_format.offset_lshift);
   SLA_Assert((decoder->wave_format.bit_per_sample - decoder->wave_format.offset_lshift) < 32);
-  for (ch = 0; ch < num_channels; ch++) {
-    for (smpl = 0; smpl < num_decode_saples; smpl++) {
-      buffer[ch][smpl]
-        = decoder->output[ch][smpl] << (32 - decoder->wave_format.bit_per_sample + decoder->wave_format.offset_lshift);
+  if (output != NULL) {
+    SLADecoder_OutputPcm(decoder, output, num_decode_saples);
+  } else if (decoder->wave_format.offset_lshift > 0) {
+    /* 内部領域に残す場合はその場でオフセット分だけ戻す */
+    for (ch = 0; ch < num_channels; ch++) {
+      for (smpl = 0; smpl < num_decode_saples; smpl++) {
+        decoder->output[ch][smpl] <<= decoder->wave_format.offset_lshift;
+      }
     }
   }
 
@@ -580,10 +1095,41 @@ static void SLADecoder_ResetAllSynthesizer(struct SLADecoder* decoder)
   }
 }
 
-/* 1ブロックデコード */
-static SLAApiResult SLADecoder_DecodeBlock(struct SLADecoder* decoder,
+/* ブロック先頭のデータからブロックサイズを取得 */
+SLAApiResult SLADecoder_GetBlockSize(const uint8_t* data, uint32_t data_size, uint32_t* block_size)
+{
+  uint32_t tmp_block_size;
+
+  /* 引数チェック */
+  if ((data == NULL) || (block_size == NULL)) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  /* ブロックサイズのフィールドまで揃っていない */
+  if (data_size < SLA_BLOCK_SIZE_FIELD_END_OFFSET) {
+    return SLA_APIRESULT_INSUFFICIENT_DATA_SIZE;
+  }
+
+  /* 同期コード */
+  if (SLAByteArray_ReadUint16(data) != SLA_BLOCK_SYNC_CODE) {
+    return SLA_APIRESULT_FAILED_TO_FIND_SYNC_CODE;
+  }
+
+  /* 次のブロックまでのオフセットからブロックサイズに変換 */
+  tmp_block_size = SLAByteArray_ReadUint32(&data[2]) + SLA_BLOCK_SIZE_FIELD_END_OFFSET;
+  if (tmp_block_size < SLA_MINIMUM_BLOCK_HEADER_SIZE) {
+    return SLA_APIRESULT_INVALID_HEADER_FORMAT;
+  }
+
+  *block_size = tmp_block_size;
+  return SLA_APIRESULT_OK;
+}
+
+/* 1ブロックデコード（出力先の形式を問わない共通処理） */
+/* 補足）outputがNULLの場合は内部領域に結果を残す */
+static SLAApiResult SLADecoder_DecodeBlockCore(struct SLADecoder* decoder,
     const uint8_t* data, uint32_t data_size,
-    int32_t** buffer, uint32_t buffer_num_samples,
+    const struct SLAPcmOutput* output, uint32_t buffer_num_samples,
     uint32_t* output_block_size, uint32_t* output_num_samples)
 {
   uint32_t block_header_size;
@@ -591,17 +1137,10 @@ static SLAApiResult SLADecoder_DecodeBlock(struct SLADecoder* decoder,
   SLAApiResult ret;
   struct SLABlockHeaderInfo block_header;
 
-  /* 引数チェック */
-  if (decoder == NULL || data == NULL || buffer == NULL
-      || output_block_size == NULL || output_num_samples == NULL) {
-    return SLA_APIRESULT_INVALID_ARGUMENT;
-  }
-
-  /* デコードに必要なパラメータがセットされていない */
-  if ((!(decoder->status_flag & SLADECODER_STATUS_FLAG_SET_WAVE_FORMAT))
-      || (!(decoder->status_flag & SLADECODER_STATUS_FLAG_SET_ENCODE_PARAMETER))) {
-    return SLA_APIRESULT_PARAMETER_NOT_SET;
-  }
+  SLA_Assert(decoder != NULL);
+  SLA_Assert(data != NULL);
+  SLA_Assert(output_block_size != NULL);
+  SLA_Assert(output_num_samples != NULL);
 
   /* チャンネル毎の処理に矛盾がないかチェック */
   switch (decoder->encode_param.ch_process_method) {
@@ -620,7 +1159,7 @@ static SLAApiResult SLADecoder_DecodeBlock(struct SLADecoder* decoder,
 
   /* ブロックヘッダを復号 */
   if ((ret = SLADecoder_DecodeBlockHeader(decoder,
-          data, data_size, &block_header, &block_header_size)) != SLA_APIRESULT_OK) {
+          data, data_size, decoder->enable_crc_check, &block_header, &block_header_size)) != SLA_APIRESULT_OK) {
     return ret;
   }
 
@@ -640,7 +1179,7 @@ static SLAApiResult SLADecoder_DecodeBlock(struct SLADecoder* decoder,
 
   /* データ復号 */
   if ((ret = SLADecoder_DecodeWaveData(decoder,
-          buffer, block_header.block_num_samples, &tmp_data_size)) != SLA_APIRESULT_OK) {
+          output, block_header.block_num_samples, &tmp_data_size)) != SLA_APIRESULT_OK) {
     return ret;
   }
 
@@ -656,25 +1195,141 @@ static SLAApiResult SLADecoder_DecodeBlock(struct SLADecoder* decoder,
   return SLA_APIRESULT_OK;
 }
 
-/* ヘッダを含めて全ブロックデコード */
-SLAApiResult SLADecoder_DecodeWhole(struct SLADecoder* decoder,
+/* 1ブロックデコード */
+SLAApiResult SLADecoder_DecodeBlock(struct SLADecoder* decoder,
     const uint8_t* data, uint32_t data_size,
-    int32_t** buffer, uint32_t buffer_num_samples, uint32_t* output_num_samples)
+    int32_t** buffer, uint32_t buffer_num_samples,
+    uint32_t* output_block_size, uint32_t* output_num_samples)
 {
-  uint32_t ch;
-  uint32_t decode_offset_byte, decode_offset_sample;
-  uint32_t block_num_samples, block_size;
-  int32_t* output_ptr[SLA_MAX_CHANNELS];
-  struct SLAHeaderInfo header;
-  SLAApiResult api_ret;
+  struct SLAPcmOutput pcm_output;
 
   /* 引数チェック */
-  if (decoder == NULL || buffer == NULL
-      || data == NULL || output_num_samples == NULL) {
+  if (decoder == NULL || data == NULL || buffer == NULL
+      || output_block_size == NULL || output_num_samples == NULL) {
     return SLA_APIRESULT_INVALID_ARGUMENT;
   }
 
-  /* ヘッダ読み出し */
+  /* デコードに必要なパラメータがセットされていない */
+  if ((!(decoder->status_flag & SLADECODER_STATUS_FLAG_SET_WAVE_FORMAT))
+      || (!(decoder->status_flag & SLADECODER_STATUS_FLAG_SET_ENCODE_PARAMETER))) {
+    return SLA_APIRESULT_PARAMETER_NOT_SET;
+  }
+
+  SLADecoder_SetLeftJustifiedPcmOutput(decoder->wave_format.num_channels,
+      buffer, 0, decoder->channel_data, &pcm_output);
+  return SLADecoder_DecodeBlockCore(decoder, data, data_size,
+      &pcm_output, buffer_num_samples, output_block_size, output_num_samples);
+}
+
+/* 1ブロックデコード（PCM出力） */
+SLAApiResult SLADecoder_DecodeBlockPcm(struct SLADecoder* decoder,
+    const uint8_t* data, uint32_t data_size,
+    const struct SLAPcmOutput* output, uint32_t buffer_num_samples,
+    uint32_t* output_block_size, uint32_t* output_num_samples)
+{
+  SLAApiResult ret;
+
+  /* 引数チェック */
+  if (decoder == NULL || data == NULL || output == NULL
+      || output_block_size == NULL || output_num_samples == NULL) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  /* デコードに必要なパラメータがセットされていない */
+  if ((!(decoder->status_flag & SLADECODER_STATUS_FLAG_SET_WAVE_FORMAT))
+      || (!(decoder->status_flag & SLADECODER_STATUS_FLAG_SET_ENCODE_PARAMETER))) {
+    return SLA_APIRESULT_PARAMETER_NOT_SET;
+  }
+
+  /* 出力先の内容チェック */
+  if ((ret = SLADecoder_CheckPcmOutput(output,
+          decoder->wave_format.num_channels, decoder->wave_format.bit_per_sample)) != SLA_APIRESULT_OK) {
+    return ret;
+  }
+
+  return SLADecoder_DecodeBlockCore(decoder, data, data_size,
+      output, buffer_num_samples, output_block_size, output_num_samples);
+}
+
+/* 1ブロックデコード（内部バッファの参照を返す） */
+SLAApiResult SLADecoder_DecodeBlockBorrowed(struct SLADecoder* decoder,
+    const uint8_t* data, uint32_t data_size, const int32_t** buffer,
+    uint32_t* output_block_size, uint32_t* output_num_samples)
+{
+  uint32_t ch;
+  SLAApiResult ret;
+
+  /* 引数チェック */
+  if (decoder == NULL || data == NULL || buffer == NULL
+      || output_block_size == NULL || output_num_samples == NULL) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  /* デコードに必要なパラメータがセットされていない */
+  if ((!(decoder->status_flag & SLADECODER_STATUS_FLAG_SET_WAVE_FORMAT))
+      || (!(decoder->status_flag & SLADECODER_STATUS_FLAG_SET_ENCODE_PARAMETER))) {
+    return SLA_APIRESULT_PARAMETER_NOT_SET;
+  }
+
+  /* 内部領域に収まるブロックだけをデコード */
+  if ((ret = SLADecoder_DecodeBlockCore(decoder, data, data_size,
+          NULL, decoder->max_num_block_samples, output_block_size, output_num_samples)) != SLA_APIRESULT_OK) {
+    return ret;
+  }
+
+  for (ch = 0; ch < decoder->wave_format.num_channels; ch++) {
+    buffer[ch] = decoder->output[ch];
+  }
+
+  return SLA_APIRESULT_OK;
+}
+
+/* ヘッダを含めて全ブロックデコード */
+SLAApiResult SLADecoder_DecodeWhole(struct SLADecoder* decoder,
+    const uint8_t* data, uint32_t data_size,
+    int32_t** buffer, uint32_t buffer_num_samples, uint32_t* output_num_samples)
+{
+  struct SLAPcmOutput   pcm_output;
+  struct SLAHeaderInfo  header;
+  SLAApiResult          api_ret;
+
+  /* 引数チェック */
+  if (decoder == NULL || buffer == NULL
+      || data == NULL || output_num_samples == NULL) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  /* 出力先のチャンネル数を知るためにヘッダ読み出し */
+  if ((api_ret = SLADecoder_DecodeHeader(data, data_size, &header))
+      != SLA_APIRESULT_OK) {
+    return api_ret;
+  }
+
+  SLADecoder_SetLeftJustifiedPcmOutput(
+      SLAUTILITY_MIN(header.wave_format.num_channels, decoder->max_num_channels),
+      buffer, 0, decoder->channel_data, &pcm_output);
+  return SLADecoder_DecodeWholePcm(decoder, data, data_size,
+      &pcm_output, buffer_num_samples, output_num_samples);
+}
+
+/* ヘッダを含めて全ブロックデコード（PCM出力） */
+SLAApiResult SLADecoder_DecodeWholePcm(struct SLADecoder* decoder,
+    const uint8_t* data, uint32_t data_size,
+    const struct SLAPcmOutput* output, uint32_t buffer_num_samples, uint32_t* output_num_samples)
+{
+  uint32_t decode_offset_byte, decode_offset_sample;
+  uint32_t block_num_samples, block_size;
+  struct SLAPcmOutput block_output;
+  struct SLAHeaderInfo header;
+  SLAApiResult api_ret;
+
+  /* 引数チェック */
+  if (decoder == NULL || output == NULL
+      || data == NULL || output_num_samples == NULL) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  /* ヘッダ読み出し */
   if ((api_ret = SLADecoder_DecodeHeader(data, data_size, &header))
       != SLA_APIRESULT_OK) {
     return api_ret;
@@ -691,7 +1346,7 @@ SLAApiResult SLADecoder_DecodeWhole(struct SLADecoder* decoder,
   }
 
   /* 全ブロックを逐次デコード */
-  decode_offset_byte   = SLA_HEADER_SIZE;
+  decode_offset_byte   = header.header_size;
   decode_offset_sample = 0;
   /* FIXME: サンプル数が無効値だと偉いことになる */
   while (decode_offset_sample < header.num_samples) {
@@ -701,14 +1356,13 @@ SLAApiResult SLADecoder_DecodeWhole(struct SLADecoder* decoder,
     }
 
     /* 出力信号のポインタをセット */
-    for (ch = 0; ch < decoder->wave_format.num_channels; ch++) {
-      output_ptr[ch] = &buffer[ch][decode_offset_sample];
-    }
+    SLADecoder_OffsetPcmOutput(output, decoder->wave_format.num_channels,
+        decode_offset_sample, decoder->block_channel_data, &block_output);
 
     /* ブロックデコード */
-    if ((api_ret = SLADecoder_DecodeBlock(decoder,
+    if ((api_ret = SLADecoder_DecodeBlockPcm(decoder,
             &data[decode_offset_byte], data_size - decode_offset_byte,
-            output_ptr, buffer_num_samples - decode_offset_sample,
+            &block_output, buffer_num_samples - decode_offset_sample,
             &block_size, &block_num_samples)) != SLA_APIRESULT_OK) {
       return api_ret;
     }
@@ -731,6 +1385,709 @@ SLAApiResult SLADecoder_DecodeWhole(struct SLADecoder* decoder,
   return SLA_APIRESULT_OK;
 }
 
+/* ブロックキャッシュの設定 */
+SLAApiResult SLADecoder_SetBlockCache(struct SLADecoder* decoder,
+    struct SLABlockCache* cache, uint32_t stream_id)
+{
+  /* 引数チェック */
+  if (decoder == NULL) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  decoder->block_cache            = cache;
+  decoder->block_cache_stream_id  = stream_id;
+
+  return SLA_APIRESULT_OK;
+}
+
+/* ブロックキャッシュを参照しながら1ブロックデコード */
+static SLAApiResult SLADecoder_DecodeBlockWithCache(struct SLADecoder* decoder,
+    const uint8_t* data, uint32_t data_size, uint32_t block_no,
+    int32_t** buffer, uint32_t buffer_num_samples,
+    uint32_t* output_block_size, uint32_t* output_num_samples)
+{
+  SLAApiResult ret;
+
+  SLA_Assert(decoder != NULL);
+  SLA_Assert(data_size >= SLA_MINIMUM_BLOCK_HEADER_SIZE);
+
+  /* キャッシュにあればブロックサイズだけ読んで返す */
+  if ((decoder->block_cache != NULL)
+      && (SLABlockCache_Get(decoder->block_cache, decoder->block_cache_stream_id, block_no,
+          buffer, decoder->wave_format.num_channels, buffer_num_samples, output_num_samples) == SLA_APIRESULT_OK)) {
+    (*output_block_size) = SLAByteArray_ReadUint32(&data[2]) + SLA_BLOCK_SIZE_FIELD_END_OFFSET;
+    return ((*output_block_size) <= data_size) ? SLA_APIRESULT_OK : SLA_APIRESULT_INSUFFICIENT_DATA_SIZE;
+  }
+
+  if ((ret = SLADecoder_DecodeBlock(decoder, data, data_size,
+          buffer, buffer_num_samples, output_block_size, output_num_samples)) != SLA_APIRESULT_OK) {
+    return ret;
+  }
+
+  /* デコード結果をキャッシュに格納（格納できなくてもデコードは成功） */
+  if (decoder->block_cache != NULL) {
+    (void)SLABlockCache_Put(decoder->block_cache, decoder->block_cache_stream_id, block_no,
+        (const int32_t* const*)buffer, decoder->wave_format.num_channels, *output_num_samples);
+  }
+
+  return SLA_APIRESULT_OK;
+}
+
+/* サンプル範囲のデコード */
+SLAApiResult SLADecoder_DecodeRange(struct SLADecoder* decoder,
+    const uint8_t* data, uint64_t data_size,
+    const struct SLABlockIndexEntry* entries, uint32_t num_entries,
+    uint64_t start_sample, uint32_t num_samples,
+    int32_t** buffer, uint32_t buffer_num_samples, uint32_t* output_num_samples)
+{
+  uint32_t ch, block_no, progress;
+  uint64_t decode_offset_byte, block_sample_offset;
+  uint32_t block_num_samples, block_size, skip_num_samples, copy_num_samples;
+  struct SLAHeaderInfo header;
+  SLAApiResult api_ret;
+
+  /* 引数チェック */
+  if ((decoder == NULL) || (data == NULL) || (buffer == NULL) || (output_num_samples == NULL)
+      || ((entries == NULL) && (num_entries > 0))) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  /* ヘッダ読み出し */
+  if ((api_ret = SLADecoder_DecodeHeader(data, SLADECODER_REMAIN_SIZE(data_size, 0), &header))
+      != SLA_APIRESULT_OK) {
+    return api_ret;
+  }
+
+  /* ヘッダから読み取った情報をハンドルにセット */
+  if ((api_ret = SLADecoder_SetWaveFormat(decoder,
+          &header.wave_format)) != SLA_APIRESULT_OK) {
+    return api_ret;
+  }
+  if ((api_ret = SLADecoder_SetEncodeParameter(decoder,
+          &header.encode_param)) != SLA_APIRESULT_OK) {
+    return api_ret;
+  }
+
+  /* 範囲チェック: 末尾を超える分は切り詰める */
+  if (start_sample >= header.num_samples) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+  num_samples = (uint32_t)SLAUTILITY_MIN((uint64_t)num_samples, header.num_samples - start_sample);
+  if (num_samples > buffer_num_samples) {
+    return SLA_APIRESULT_INSUFFICIENT_BUFFER_SIZE;
+  }
+
+  /* 開始サンプルを含むブロックを探す */
+  if (entries != NULL) {
+    /* 索引があれば二分探索 */
+    if ((api_ret = SLADecoder_SearchBlockIndex(entries, num_entries, start_sample, &block_no))
+        != SLA_APIRESULT_OK) {
+      return api_ret;
+    }
+    decode_offset_byte  = entries[block_no].data_offset;
+    block_sample_offset = entries[block_no].sample_offset;
+  } else {
+    /* 索引がなければブロックヘッダのサイズを辿る（ブロックデータは読まない） */
+    decode_offset_byte  = header.header_size;
+    block_sample_offset = 0;
+    block_no            = 0;
+    while (1) {
+      if ((decode_offset_byte >= data_size)
+          || ((data_size - decode_offset_byte) < SLA_MINIMUM_BLOCK_HEADER_SIZE)) {
+        return SLA_APIRESULT_INSUFFICIENT_DATA_SIZE;
+      }
+      if (SLAByteArray_ReadUint16(&data[decode_offset_byte]) != SLA_BLOCK_SYNC_CODE) {
+        return SLA_APIRESULT_FAILED_TO_FIND_SYNC_CODE;
+      }
+      if ((block_num_samples = SLAUtility_GetBlockNumSamples(&data[decode_offset_byte],
+              SLADECODER_REMAIN_SIZE(data_size, decode_offset_byte))) == 0) {
+        return SLA_APIRESULT_INSUFFICIENT_DATA_SIZE;
+      }
+      /* 補足）block_sample_offset <= start_sample を保って進むので差で比べる（加算の桁あふれ回避） */
+      if (block_num_samples > (start_sample - block_sample_offset)) {
+        break;
+      }
+      /* ブロックサイズ: 壊れた値が32bitで桁あふれしたり残りデータを超えたりしないか確認 */
+      block_size = SLAByteArray_ReadUint32(&data[decode_offset_byte + 2]);
+      if (block_size > (UINT32_MAX - SLA_BLOCK_SIZE_FIELD_END_OFFSET)) {
+        return SLA_APIRESULT_DETECT_DATA_CORRUPTION;
+      }
+      block_size += SLA_BLOCK_SIZE_FIELD_END_OFFSET;
+      if (block_size < SLA_MINIMUM_BLOCK_HEADER_SIZE) {
+        return SLA_APIRESULT_DETECT_DATA_CORRUPTION;
+      }
+      if (block_size > (data_size - decode_offset_byte)) {
+        return SLA_APIRESULT_INSUFFICIENT_DATA_SIZE;
+      }
+      decode_offset_byte  += block_size;
+      block_sample_offset += block_num_samples;
+      block_no++;
+    }
+  }
+
+  /* 範囲にかかるブロックだけデコード */
+  progress = 0;
+  while (progress < num_samples) {
+    if ((decode_offset_byte >= data_size)
+        || ((data_size - decode_offset_byte) < SLA_MINIMUM_BLOCK_HEADER_SIZE)) {
+      return SLA_APIRESULT_INSUFFICIENT_DATA_SIZE;
+    }
+
+    /* ブロック内の開始位置と出力サンプル数 */
+    /* 補足）block_sample_offset <= start_sample + progress < block_sample_offset + ブロックサンプル数 なので32bitに収まる */
+    skip_num_samples  = (uint32_t)(start_sample + progress - block_sample_offset);
+    if ((block_num_samples = SLAUtility_GetBlockNumSamples(&data[decode_offset_byte],
+            SLADECODER_REMAIN_SIZE(data_size, decode_offset_byte))) == 0) {
+      return SLA_APIRESULT_INSUFFICIENT_DATA_SIZE;
+    }
+    if ((skip_num_samples == 0) && (block_num_samples <= (num_samples - progress))) {
+      /* ブロック全体が範囲内: 出力バッファに直接デコード */
+      for (ch = 0; ch < decoder->wave_format.num_channels; ch++) {
+        decoder->range_output[ch] = &buffer[ch][progress];
+      }
+      if ((api_ret = SLADecoder_DecodeBlockWithCache(decoder,
+              &data[decode_offset_byte], SLADECODER_REMAIN_SIZE(data_size, decode_offset_byte), block_no,
+              decoder->range_output, num_samples - progress,
+              &block_size, &block_num_samples)) != SLA_APIRESULT_OK) {
+        return api_ret;
+      }
+      copy_num_samples = block_num_samples;
+    } else {
+      /* 範囲の端のブロック: 一時領域にデコードして必要な部分だけコピー */
+      if ((api_ret = SLADecoder_DecodeBlockWithCache(decoder,
+              &data[decode_offset_byte], SLADECODER_REMAIN_SIZE(data_size, decode_offset_byte), block_no,
+              decoder->range_buffer, decoder->max_num_block_samples,
+              &block_size, &block_num_samples)) != SLA_APIRESULT_OK) {
+        return api_ret;
+      }
+      if (skip_num_samples >= block_num_samples) {
+        return SLA_APIRESULT_DETECT_DATA_CORRUPTION;
+      }
+      copy_num_samples = SLAUTILITY_MIN(block_num_samples - skip_num_samples, num_samples - progress);
+      for (ch = 0; ch < decoder->wave_format.num_channels; ch++) {
+        memcpy(&buffer[ch][progress], &decoder->range_buffer[ch][skip_num_samples],
+            sizeof(int32_t) * copy_num_samples);
+      }
+    }
+
+    progress            += copy_num_samples;
+    decode_offset_byte  += block_size;
+    block_sample_offset += block_num_samples;
+    block_no++;
+  }
+
+  /* 出力サンプル数を記録 */
+  *output_num_samples = num_samples;
+
+  return SLA_APIRESULT_OK;
+}
+
+/* 統計情報の取得 */
+SLAApiResult SLADecoder_GetStatistics(const struct SLADecoder* decoder, struct SLAStatistics* statistics)
+{
+  /* 引数チェック */
+  if ((decoder == NULL) || (statistics == NULL)) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+
+#ifdef SLA_ENABLE_STATISTICS
+  *statistics = decoder->statistics;
+  statistics->ticks_per_second = SLA_STATISTICS_TICKS_PER_SECOND;
+  statistics->tick_clock = SLA_STATISTICS_TICK_CLOCK;
+  return SLA_APIRESULT_OK;
+#else
+  return SLA_APIRESULT_STATISTICS_DISABLED;
+#endif
+}
+
+/* 統計情報のリセット */
+SLAApiResult SLADecoder_ResetStatistics(struct SLADecoder* decoder)
+{
+  /* 引数チェック */
+  if (decoder == NULL) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+
+#ifdef SLA_ENABLE_STATISTICS
+  memset(&decoder->statistics, 0, sizeof(struct SLAStatistics));
+  return SLA_APIRESULT_OK;
+#else
+  return SLA_APIRESULT_STATISTICS_DISABLED;
+#endif
+}
+
+/* 同期コード候補の検索 */
+/* 補足）先頭バイト0xFFをmemchrで探し、続くバイトも0xFFの位置を返す。見つからなければdata_sizeを返す */
+static uint64_t SLADecoder_FindSyncCodeCandidate(const uint8_t* data, uint64_t data_size, uint64_t offset)
+{
+  const uint8_t* pos;
+
+  SLA_Assert(data != NULL);
+
+  while ((offset + 1) < data_size) {
+    /* 0xFFの検索（ライブラリのmemchrは多くの環境でSIMD化されている） */
+    if ((pos = (const uint8_t *)memchr(&data[offset], 0xFF, (size_t)(data_size - offset - 1))) == NULL) {
+      break;
+    }
+    offset = (uint64_t)(pos - data);
+    if (data[offset + 1] == 0xFF) {
+      return offset;
+    }
+    offset++;
+  }
+
+  return data_size;
+}
+
+/* 同期コード候補位置のブロックを検証 */
+/* 補足）ヘッダ情報がある場合はその範囲でも検証する */
+static uint8_t SLADecoder_ValidateBlockCandidate(const uint8_t* data, uint32_t data_size,
+    const struct SLAHeaderInfo* header, struct SLABlockIndexEntry* entry)
+{
+  uint32_t block_size, num_samples, data_type_offset;
+
+  SLA_Assert((data != NULL) && (entry != NULL));
+
+  /* 最小のブロックヘッダすら入らない */
+  if (data_size < SLA_MINIMUM_BLOCK_HEADER_SIZE) {
+    return 0;
+  }
+
+  /* 同期コード */
+  if (SLAByteArray_ReadUint16(&data[0]) != SLA_BLOCK_SYNC_CODE) {
+    return 0;
+  }
+
+  /* ブロックサイズ: データ内に収まっていなければならない */
+  block_size = SLAByteArray_ReadUint32(&data[2]);
+  if (block_size > (data_size - SLA_BLOCK_SIZE_FIELD_END_OFFSET)) {
+    return 0;
+  }
+  block_size += SLA_BLOCK_SIZE_FIELD_END_OFFSET;
+  if (block_size < SLA_MINIMUM_BLOCK_HEADER_SIZE) {
+    return 0;
+  }
+
+  /* サンプル数とブロックデータタイプ */
+  num_samples = SLAUtility_GetBlockNumSamples(data, block_size);
+  data_type_offset = SLA_BLOCK_CRC16_CALC_START_OFFSET
+    + ((SLAByteArray_ReadUint16(&data[SLA_BLOCK_CRC16_CALC_START_OFFSET]) == SLA_BLOCK_NUM_SAMPLES_ESCAPE) ? (2 + 4) : 2);
+  if ((num_samples == 0)
+      || ((SLABlockDataType)(data[data_type_offset] >> 6) == SLA_BLOCK_DATA_TYPE_INVAILD)) {
+    return 0;
+  }
+
+  /* ヘッダに記録された上限 */
+  if (header != NULL) {
+    if ((num_samples > header->encode_param.max_num_block_samples)
+        || ((header->max_block_size != SLA_MAX_BLOCK_SIZE_INVAILD) && (block_size > header->max_block_size))) {
+      return 0;
+    }
+  }
+
+  /* CRC16 */
+  entry->crc16 = SLAByteArray_ReadUint16(&data[SLA_BLOCK_SIZE_FIELD_END_OFFSET]);
+  if (SLAUtility_CalculateCRC16(&data[SLA_BLOCK_CRC16_CALC_START_OFFSET],
+        block_size - SLA_BLOCK_CRC16_CALC_START_OFFSET) != entry->crc16) {
+    return 0;
+  }
+
+  entry->block_size   = block_size;
+  entry->num_samples  = num_samples;
+
+  return 1;
+}
+
+/* 同期コードの走査によるブロック索引の作成 */
+SLAApiResult SLADecoder_BuildBlockIndex(const uint8_t* data, uint64_t data_size,
+    struct SLABlockIndexEntry* entries, uint32_t max_num_entries, uint32_t* num_entries)
+{
+  uint32_t count;
+  uint64_t offset, sample_offset;
+  uint8_t is_damaged;
+  struct SLAHeaderInfo header;
+  const struct SLAHeaderInfo* pheader;
+  struct SLABlockIndexEntry entry;
+
+  /* 引数チェック */
+  if (num_entries == NULL) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+  *num_entries = 0;
+  if (data == NULL) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  /* ヘッダが読めればヘッダ直後から、読めなければ先頭から走査 */
+  if (SLADecoder_DecodeHeader(data, SLADECODER_REMAIN_SIZE(data_size, 0), &header) == SLA_APIRESULT_OK) {
+    offset  = header.header_size;
+    pheader = &header;
+  } else {
+    offset  = 0;
+    pheader = NULL;
+  }
+
+  count = 0;
+  sample_offset = 0;
+  is_damaged = (pheader == NULL) ? 1 : 0;
+  while (offset < data_size) {
+    /* 検証に成功したら次のブロックへ直接進む（正常なデータではこの経路のみ通る） */
+    if (SLADecoder_ValidateBlockCandidate(&data[offset], SLADECODER_REMAIN_SIZE(data_size, offset), pheader, &entry)) {
+      /* 領域を超えた分は記録せず数えるだけ */
+      if ((entries != NULL) && (count < max_num_entries)) {
+        entry.data_offset   = offset;
+        entry.sample_offset = sample_offset;
+        entries[count]      = entry;
+      }
+      count++;
+      sample_offset += entry.num_samples;
+      offset        += entry.block_size;
+      continue;
+    }
+    /* 検証に失敗: 破損として次の同期コード候補を探す */
+    is_damaged = 1;
+    offset = SLADecoder_FindSyncCodeCandidate(data, data_size, offset + 1);
+  }
+
+  *num_entries = count;
+
+  /* 領域不足: 必要なエントリ数を返す */
+  if ((entries != NULL) && (count > max_num_entries)) {
+    return SLA_APIRESULT_EXCEED_HANDLE_CAPACITY;
+  }
+
+  /* ヘッダに記録されたサンプル数に届いていなければ欠落がある */
+  if ((pheader != NULL) && (pheader->num_samples != SLA_NUM_SAMPLES_INVALID)
+      && (sample_offset != pheader->num_samples)) {
+    is_damaged = 1;
+  }
+
+  return (is_damaged) ? SLA_APIRESULT_DETECT_DATA_CORRUPTION : SLA_APIRESULT_OK;
+}
+
+/* 1ブロックの完全性検証 */
+SLAApiResult SLADecoder_VerifyBlock(const uint8_t* data, uint32_t data_size,
+    const struct SLAHeaderInfo* header, uint32_t* block_size, uint32_t* num_samples)
+{
+  uint32_t tmp_block_size;
+  struct SLABlockIndexEntry entry;
+  SLAApiResult ret;
+
+  /* 引数チェック */
+  if ((data == NULL) || (block_size == NULL) || (num_samples == NULL)) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  /* 同期コードとブロックサイズ */
+  if ((ret = SLADecoder_GetBlockSize(data, data_size, &tmp_block_size)) != SLA_APIRESULT_OK) {
+    return (ret == SLA_APIRESULT_INVALID_HEADER_FORMAT) ? SLA_APIRESULT_DETECT_DATA_CORRUPTION : ret;
+  }
+  if (tmp_block_size > data_size) {
+    return SLA_APIRESULT_INSUFFICIENT_DATA_SIZE;
+  }
+
+  /* サンプル数・データタイプ・ヘッダの上限・CRC16の検証 */
+  if (!SLADecoder_ValidateBlockCandidate(data, tmp_block_size, header, &entry)) {
+    return SLA_APIRESULT_DETECT_DATA_CORRUPTION;
+  }
+
+  *block_size   = entry.block_size;
+  *num_samples  = entry.num_samples;
+  return SLA_APIRESULT_OK;
+}
+
+/* ヘッダを含むデータ全体の完全性検証 */
+SLAApiResult SLADecoder_VerifyStream(const uint8_t* data, uint64_t data_size,
+    struct SLAVerifyResult* result)
+{
+  uint64_t offset;
+  uint32_t block_size, block_num_samples;
+  struct SLAHeaderInfo header;
+  SLAApiResult ret;
+
+  /* 引数チェック */
+  if ((data == NULL) || (result == NULL)) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  result->num_blocks    = 0;
+  result->num_samples   = 0;
+  result->error_offset  = 0;
+
+  /* ヘッダ（CRC16含む） */
+  if ((ret = SLADecoder_DecodeHeader(data, SLADECODER_REMAIN_SIZE(data_size, 0), &header)) != SLA_APIRESULT_OK) {
+    return ret;
+  }
+
+  /* ブロックヘッダのサイズを辿りながら各ブロックを検証 */
+  /* 補足）エントロピー復号・合成は行わない */
+  offset = header.header_size;
+  while (offset < data_size) {
+    if ((ret = SLADecoder_VerifyBlock(&data[offset], SLADECODER_REMAIN_SIZE(data_size, offset),
+            &header, &block_size, &block_num_samples)) != SLA_APIRESULT_OK) {
+      result->error_offset = offset;
+      return ret;
+    }
+    result->num_blocks++;
+    result->num_samples += block_num_samples;
+    offset += block_size;
+  }
+  result->error_offset = offset;
+
+  /* ヘッダに記録されたブロック数・サンプル数との一致 */
+  if (((header.num_blocks != SLA_NUM_BLOCKS_INVALID) && (result->num_blocks != header.num_blocks))
+      || ((header.num_samples != SLA_NUM_SAMPLES_INVALID) && (result->num_samples != header.num_samples))) {
+    return SLA_APIRESULT_DETECT_DATA_CORRUPTION;
+  }
+
+  return SLA_APIRESULT_OK;
+}
+
+/* ブロック索引ファイルのサイズ計算 */
+uint32_t SLADecoder_CalculateBlockIndexFileSize(uint32_t num_entries)
+{
+  /* サイズが32bitで表現できない */
+  if (num_entries > ((UINT32_MAX - SLA_BLOCK_INDEX_HEADER_SIZE) / SLA_BLOCK_INDEX_ENTRY_SIZE)) {
+    return 0;
+  }
+
+  return SLA_BLOCK_INDEX_HEADER_SIZE + SLA_BLOCK_INDEX_ENTRY_SIZE * num_entries;
+}
+
+/* ブロック索引ファイルの書き出し */
+SLAApiResult SLADecoder_EncodeBlockIndexFile(
+    const uint8_t* sla_data, uint64_t sla_data_size,
+    const struct SLABlockIndexEntry* entries, uint32_t num_entries,
+    uint8_t* buffer, uint32_t buffer_size, uint32_t* output_size)
+{
+  uint32_t i, index_size;
+  uint64_t num_samples;
+  uint16_t crc16;
+  uint8_t* data_pos;
+  struct SLAHeaderInfo header;
+
+  /* 引数チェック */
+  if ((sla_data == NULL) || (buffer == NULL) || (output_size == NULL)
+      || ((entries == NULL) && (num_entries > 0))) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  /* 索引は正しいヘッダを持つデータに対してのみ作成する */
+  if (SLADecoder_DecodeHeader(sla_data, SLADECODER_REMAIN_SIZE(sla_data_size, 0), &header) != SLA_APIRESULT_OK) {
+    return SLA_APIRESULT_INVALID_HEADER_FORMAT;
+  }
+
+  /* バッファサイズチェック */
+  if ((index_size = SLADecoder_CalculateBlockIndexFileSize(num_entries)) == 0) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+  if (buffer_size < index_size) {
+    return SLA_APIRESULT_INSUFFICIENT_BUFFER_SIZE;
+  }
+
+  num_samples = 0;
+  if (num_entries > 0) {
+    num_samples = entries[num_entries - 1].sample_offset + entries[num_entries - 1].num_samples;
+  }
+
+  data_pos = buffer;
+  /* シグネチャ */
+  SLAByteArray_PutUint8(data_pos, (uint8_t)'S');
+  SLAByteArray_PutUint8(data_pos, (uint8_t)'L');
+  SLAByteArray_PutUint8(data_pos, (uint8_t)'I');
+  SLAByteArray_PutUint8(data_pos, (uint8_t)'\1');
+  /* これ以降のフィールドのCRC16（仮値で埋めておく） */
+  SLAByteArray_PutUint16(data_pos, 0);
+  /* 索引フォーマットバージョン */
+  SLAByteArray_PutUint32(data_pos, SLA_BLOCK_INDEX_FORMAT_VERSION);
+  /* 対象データのサイズとヘッダのCRC16 */
+  SLAByteArray_PutUint64(data_pos, sla_data_size);
+  SLAByteArray_PutUint16(data_pos, SLAByteArray_ReadUint16(&sla_data[SLA_HEADER_CRC16_CALC_START_OFFSET - 2]));
+  /* 全サンプル数 */
+  SLAByteArray_PutUint64(data_pos, num_samples);
+  /* エントリ数 */
+  SLAByteArray_PutUint32(data_pos, num_entries);
+  SLA_Assert((uint32_t)(data_pos - buffer) == SLA_BLOCK_INDEX_HEADER_SIZE);
+
+  /* エントリ */
+  for (i = 0; i < num_entries; i++) {
+    SLAByteArray_PutUint64(data_pos, entries[i].data_offset);
+    SLAByteArray_PutUint64(data_pos, entries[i].sample_offset);
+    SLAByteArray_PutUint32(data_pos, entries[i].block_size);
+    SLAByteArray_PutUint32(data_pos, entries[i].num_samples);
+    SLAByteArray_PutUint16(data_pos, entries[i].crc16);
+  }
+  SLA_Assert((uint32_t)(data_pos - buffer) == index_size);
+
+  /* CRC16を書き込み */
+  crc16 = SLAUtility_CalculateCRC16(&buffer[6], index_size - 6);
+  SLAByteArray_WriteUint16(&buffer[4], crc16);
+
+  *output_size = index_size;
+  return SLA_APIRESULT_OK;
+}
+
+/* ブロック索引ファイルの読み込み */
+SLAApiResult SLADecoder_DecodeBlockIndexFile(
+    const uint8_t* index_data, uint32_t index_data_size, struct SLABlockIndexInfo* info,
+    struct SLABlockIndexEntry* entries, uint32_t max_num_entries)
+{
+  uint32_t i, index_size, format_version, header_size, entry_size;
+  uint16_t crc16;
+  const uint8_t* data_pos;
+  struct SLABlockIndexInfo tmp_info;
+
+  /* 引数チェック */
+  if ((index_data == NULL) || (info == NULL)) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  /* バージョンまでのフィールドに満たない */
+  if (index_data_size < 10) {
+    return SLA_APIRESULT_INSUFFICIENT_DATA_SIZE;
+  }
+
+  /* シグネチャとバージョンの確認 */
+  /* 補足）バージョン1はオフセット・サンプル数が32bit */
+  if ((index_data[0] != 'S') || (index_data[1] != 'L')
+      || (index_data[2] != 'I') || (index_data[3] != '\1')) {
+    return SLA_APIRESULT_INVALID_HEADER_FORMAT;
+  }
+  format_version = SLAByteArray_ReadUint32(&index_data[6]);
+  switch (format_version) {
+    case 1:
+      header_size = SLA_BLOCK_INDEX_HEADER_SIZE_V1;
+      entry_size  = SLA_BLOCK_INDEX_ENTRY_SIZE_V1;
+      break;
+    case SLA_BLOCK_INDEX_FORMAT_VERSION:
+      header_size = SLA_BLOCK_INDEX_HEADER_SIZE;
+      entry_size  = SLA_BLOCK_INDEX_ENTRY_SIZE;
+      break;
+    default:
+      return SLA_APIRESULT_INVALID_HEADER_FORMAT;
+  }
+
+  /* ヘッダサイズに満たない */
+  if (index_data_size < header_size) {
+    return SLA_APIRESULT_INSUFFICIENT_DATA_SIZE;
+  }
+
+  data_pos = &index_data[10];
+  if (format_version == 1) {
+    uint32_t u32buf;
+    SLAByteArray_GetUint32(data_pos, &u32buf);
+    tmp_info.source_data_size = u32buf;
+    SLAByteArray_GetUint16(data_pos, &tmp_info.source_header_crc16);
+    SLAByteArray_GetUint32(data_pos, &u32buf);
+    tmp_info.num_samples = u32buf;
+  } else {
+    SLAByteArray_GetUint64(data_pos, &tmp_info.source_data_size);
+    SLAByteArray_GetUint16(data_pos, &tmp_info.source_header_crc16);
+    SLAByteArray_GetUint64(data_pos, &tmp_info.num_samples);
+  }
+  SLAByteArray_GetUint32(data_pos, &tmp_info.num_entries);
+  SLA_Assert((uint32_t)(data_pos - index_data) == header_size);
+
+  /* 全エントリが揃っているか */
+  if (tmp_info.num_entries > (index_data_size - header_size) / entry_size) {
+    return SLA_APIRESULT_INSUFFICIENT_DATA_SIZE;
+  }
+  index_size = header_size + entry_size * tmp_info.num_entries;
+
+  /* CRC16の確認 */
+  crc16 = SLAUtility_CalculateCRC16(&index_data[6], index_size - 6);
+  if (crc16 != SLAByteArray_ReadUint16(&index_data[4])) {
+    return SLA_APIRESULT_DETECT_DATA_CORRUPTION;
+  }
+
+  (*info) = tmp_info;
+
+  /* 情報の読み取りのみ */
+  if (entries == NULL) {
+    return SLA_APIRESULT_OK;
+  }
+
+  if (tmp_info.num_entries > max_num_entries) {
+    return SLA_APIRESULT_EXCEED_HANDLE_CAPACITY;
+  }
+
+  for (i = 0; i < tmp_info.num_entries; i++) {
+    if (format_version == 1) {
+      uint32_t u32buf;
+      SLAByteArray_GetUint32(data_pos, &u32buf);
+      entries[i].data_offset = u32buf;
+      SLAByteArray_GetUint32(data_pos, &u32buf);
+      entries[i].sample_offset = u32buf;
+    } else {
+      SLAByteArray_GetUint64(data_pos, &entries[i].data_offset);
+      SLAByteArray_GetUint64(data_pos, &entries[i].sample_offset);
+    }
+    SLAByteArray_GetUint32(data_pos, &entries[i].block_size);
+    SLAByteArray_GetUint32(data_pos, &entries[i].num_samples);
+    SLAByteArray_GetUint16(data_pos, &entries[i].crc16);
+  }
+
+  return SLA_APIRESULT_OK;
+}
+
+/* ブロック索引が対象データのものか確認 */
+SLAApiResult SLADecoder_CheckBlockIndexSource(const struct SLABlockIndexInfo* info,
+    const uint8_t* header_data, uint64_t source_data_size)
+{
+  struct SLAHeaderInfo header;
+
+  /* 引数チェック */
+  if ((info == NULL) || (header_data == NULL)) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  if (SLADecoder_DecodeHeader(header_data,
+        (uint32_t)SLAUTILITY_MIN(source_data_size, SLA_HEADER_SIZE), &header) != SLA_APIRESULT_OK) {
+    return SLA_APIRESULT_INVALID_HEADER_FORMAT;
+  }
+
+  /* サイズとヘッダのCRC16が一致しなければ別のデータ（または更新された後のデータ） */
+  if ((info->source_data_size != source_data_size)
+      || (info->source_header_crc16 != SLAByteArray_ReadUint16(&header_data[SLA_HEADER_CRC16_CALC_START_OFFSET - 2]))) {
+    return SLA_APIRESULT_INDEX_SOURCE_MISMATCH;
+  }
+
+  return SLA_APIRESULT_OK;
+}
+
+/* ブロック索引からサンプル位置を含むブロックを二分探索 */
+SLAApiResult SLADecoder_SearchBlockIndex(
+    const struct SLABlockIndexEntry* entries, uint32_t num_entries,
+    uint64_t sample_position, uint32_t* entry_index)
+{
+  uint32_t low, high, mid;
+
+  /* 引数チェック */
+  if ((entries == NULL) || (entry_index == NULL) || (num_entries == 0)) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  /* 範囲外 */
+  if ((sample_position < entries[0].sample_offset)
+      || (sample_position >= (entries[num_entries - 1].sample_offset + entries[num_entries - 1].num_samples))) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  /* sample_offset <= sample_position を満たす最後のエントリを探す */
+  low = 0; high = num_entries - 1;
+  while (low < high) {
+    mid = low + (high - low + 1) / 2;
+    if (entries[mid].sample_offset <= sample_position) {
+      low = mid;
+    } else {
+      high = mid - 1;
+    }
+  }
+
+  *entry_index = low;
+  return SLA_APIRESULT_OK;
+}
+
 /* ストリーミングデコーダの内部状態リセット */
 static SLAApiResult SLAStreamingDecoder_Reset(struct SLAStreamingDecoder* decoder)
 {
@@ -741,9 +2098,15 @@ static SLAApiResult SLAStreamingDecoder_Reset(struct SLAStreamingDecoder* decode
   /* ブロックオフセットをリセット */
   decoder->current_block_sample_offset = 0;
 
+  /* CRC16の途中結果をリセット */
+  decoder->block_crc16          = 0;
+  decoder->block_crc16_progress = 0;
+
   /* データバッファをリセット */
   memset(decoder->data_buffer, 0, sizeof(uint8_t) * decoder->data_buffer_size);
   decoder->data_buffer_provided_size = 0;
+  decoder->current_block_data = NULL;
+  decoder->is_direct_decoding = 0;
 
   return SLA_APIRESULT_OK;
 }
@@ -764,20 +2127,27 @@ struct SLAStreamingDecoder* SLAStreamingDecoder_Create(const struct SLAStreaming
   }
 
   /* ハンドルの領域割当て */
-  decoder = (struct SLAStreamingDecoder *)malloc(sizeof(struct SLAStreamingDecoder));
+  if ((decoder = (struct SLAStreamingDecoder *)malloc(sizeof(struct SLAStreamingDecoder))) == NULL) {
+    return NULL;
+  }
+  /* 補足）途中で失敗した時に破棄関数で後始末できるよう、先に全てNULLにしておく */
+  decoder->decoder_core = NULL;
+  decoder->queue        = NULL;
+  decoder->data_buffer  = NULL;
 
   /* デコーダコアハンドルの作成 */
-  decoder->decoder_core = SLADecoder_Create(&config->core_config);
-  if (decoder->decoder_core == NULL) {
-    free(decoder);
+  if ((decoder->decoder_core = SLADecoder_Create(&config->core_config)) == NULL) {
+    SLAStreamingDecoder_Destroy(decoder);
     return NULL;
   }
 
   /* データパケットキューの作成 */
-  decoder->queue = SLADataPacketQueue_Create(SLA_STREAMING_DECODE_MAX_NUM_PACKETS);
+  /* 補足）データ片はブロックのデコードが終わるまで保持するため、ブロックサンプル数に比例して確保 */
+  decoder->queue = SLADataPacketQueue_Create(SLA_STREAMING_DECODE_MAX_NUM_PACKETS
+      * SLAUTILITY_MAX(1, SLAUTILITY_ROUNDUP(config->core_config.max_num_block_samples, SLA_STREAMING_DECODE_PACKETS_UNIT_NUM_SAMPLES)
+        / SLA_STREAMING_DECODE_PACKETS_UNIT_NUM_SAMPLES));
   if (decoder->queue == NULL) {
-    free(decoder->decoder_core);
-    free(decoder);
+    SLAStreamingDecoder_Destroy(decoder);
     return NULL;
   }
 
@@ -785,23 +2155,23 @@ struct SLAStreamingDecoder* SLAStreamingDecoder_Create(const struct SLAStreaming
   decoder->decode_interval_hz = config->decode_interval_hz;
   decoder->max_bit_per_sample = config->max_bit_per_sample;
 
-  /* バッファサイズ計算: ブロックをまたぐことがあるので、2ブロック分確保 */
+  /* バッファサイズ計算: 連結領域にはデコード中の1ブロックしか置かない */
   decoder->data_buffer_size
-    = 2 * SLA_CalculateSufficientBlockSize(config->core_config.max_num_channels,
+    = SLA_CalculateSufficientBlockSize(config->core_config.max_num_channels,
         config->core_config.max_num_block_samples, config->max_bit_per_sample);
 
   /* バッファ確保 */
-  decoder->data_buffer = (uint8_t *)malloc(sizeof(uint8_t) * decoder->data_buffer_size);
+  if ((decoder->data_buffer = (uint8_t *)malloc(sizeof(uint8_t) * decoder->data_buffer_size)) == NULL) {
+    SLAStreamingDecoder_Destroy(decoder);
+    return NULL;
+  }
 
   /* 推定サンプルあたりバイト数を最悪値で見積もる */
   decoder->estimated_bytes_per_sample = (float)((double)config->core_config.max_num_channels * (config->max_bit_per_sample / 8));
 
   /* 内部状態リセット */
   if (SLAStreamingDecoder_Reset(decoder) != SLA_APIRESULT_OK) {
-    free(decoder->decoder_core);
-    free(decoder->data_buffer);
-    free(decoder->queue);
-    free(decoder);
+    SLAStreamingDecoder_Destroy(decoder);
     return NULL;
   }
 
@@ -937,50 +2307,304 @@ SLAApiResult SLAStreamingDecoder_GetRemainDataSize(struct SLAStreamingDecoder* d
   }
 
   /* キューの残りデータサイズを取得 */
+  /* 補足）データ片から直接デコード中のブロックはキューに残っている */
   queue_remain = SLADataPacketQueue_GetRemainDataSize(decoder->queue);
 
-  /* 連続バッファの残りサイズ */
+  /* 連結領域の残りサイズ */
   data_buffer_remain = decoder->data_buffer_provided_size;
+
+  /* デコード中のブロックはデコード済みサイズで減じる */
   if (decoder->current_block_sample_offset > 0) {
     int32_t decoded_size;
-    /* デコード済みサイズで減じる */
     SLABitStream_Tell(&decoder->decoder_core->strm, &decoded_size);
-    SLA_Assert(decoder->data_buffer_provided_size >= (uint32_t)decoded_size);
-    data_buffer_remain -= (uint32_t)decoded_size;
+    if (decoder->is_direct_decoding == 1) {
+      SLA_Assert(queue_remain >= (uint32_t)decoded_size);
+      queue_remain -= (uint32_t)decoded_size;
+    } else {
+      SLA_Assert(data_buffer_remain >= (uint32_t)decoded_size);
+      data_buffer_remain -= (uint32_t)decoded_size;
+    }
   }
 
-  /* キューと連続バッファの合計が余りサイズ */
+  /* キューと連結領域の合計が余りサイズ */
   (*remain_data_size) = queue_remain + data_buffer_remain;
 
   return SLA_APIRESULT_OK;
 }
 
+/* デコード中ブロック先頭からoffsetバイト目以降の未デコードデータをコピー */
+/* 補足）未デコードデータは連結領域の内容にキューの未読み出しデータが続いたもの */
+static SLAApiResult SLAStreamingDecoder_PeekStreamData(const struct SLAStreamingDecoder* decoder,
+    uint32_t offset, uint8_t* data, uint32_t data_size)
+{
+  uint32_t copy_size;
+
+  SLA_Assert((decoder != NULL) && (data != NULL));
+
+  /* 連結領域からコピー */
+  if (offset < decoder->data_buffer_provided_size) {
+    copy_size = SLAUTILITY_MIN(decoder->data_buffer_provided_size - offset, data_size);
+    memcpy(data, &decoder->data_buffer[offset], copy_size);
+    data      += copy_size;
+    data_size -= copy_size;
+    offset    = 0;
+  } else {
+    offset -= decoder->data_buffer_provided_size;
+  }
+
+  /* 残りはキューからコピー */
+  if (SLADataPacketQueue_PeekData(decoder->queue, offset, data, data_size) != SLA_DATAPACKETQUEUE_APIRESULT_OK) {
+    return SLA_APIRESULT_INSUFFICIENT_DATA_SIZE;
+  }
+
+  return SLA_APIRESULT_OK;
+}
+
+/* デコード中ブロック先頭からoffsetバイト目以降の未デコードデータを参照 */
+/* 補足）コピーせずに参照できるのは連結領域またはデータ片1つの範囲なので、data_sizeにはその残りサイズを返す */
+static SLAApiResult SLAStreamingDecoder_PeekStreamDataFragmentAt(const struct SLAStreamingDecoder* decoder,
+    uint32_t offset, const uint8_t** data_ptr, uint32_t* data_size)
+{
+  SLA_Assert((decoder != NULL) && (data_ptr != NULL) && (data_size != NULL));
+
+  /* 連結領域を参照 */
+  if (offset < decoder->data_buffer_provided_size) {
+    (*data_ptr)   = &decoder->data_buffer[offset];
+    (*data_size)  = decoder->data_buffer_provided_size - offset;
+    return SLA_APIRESULT_OK;
+  }
+
+  /* キューのデータ片を参照 */
+  if (SLADataPacketQueue_PeekDataFragmentAt(decoder->queue,
+        offset - decoder->data_buffer_provided_size, data_ptr, data_size) != SLA_DATAPACKETQUEUE_APIRESULT_OK) {
+    return SLA_APIRESULT_INSUFFICIENT_DATA_SIZE;
+  }
+
+  return SLA_APIRESULT_OK;
+}
+
+/* デコード中ブロックの完了に必要な追加データサイズを取得 */
+SLAApiResult SLAStreamingDecoder_GetNecessaryDataSize(struct SLAStreamingDecoder* decoder,
+    uint32_t* necessary_data_size)
+{
+  uint32_t  total_data_size, block_size;
+  uint8_t   size_field[SLA_BLOCK_SIZE_FIELD_END_OFFSET];
+
+  /* 引数チェック */
+  if ((decoder == NULL) || (necessary_data_size == NULL)) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  /* デコード中ブロック先頭から数えた供給済みデータサイズ */
+  total_data_size = decoder->data_buffer_provided_size
+    + SLADataPacketQueue_GetRemainDataSize(decoder->queue);
+
+  /* ブロックサイズが読めるまでに必要なサイズ */
+  if (SLAStreamingDecoder_PeekStreamData(decoder,
+        0, size_field, SLA_BLOCK_SIZE_FIELD_END_OFFSET) != SLA_APIRESULT_OK) {
+    SLA_Assert(total_data_size < SLA_BLOCK_SIZE_FIELD_END_OFFSET);
+    (*necessary_data_size) = SLA_BLOCK_SIZE_FIELD_END_OFFSET - total_data_size;
+    return SLA_APIRESULT_OK;
+  }
+
+  /* ブロック全体が揃うまでに必要なサイズ */
+  block_size = SLAByteArray_ReadUint32(&size_field[2]) + SLA_BLOCK_SIZE_FIELD_END_OFFSET;
+  (*necessary_data_size) = (block_size > total_data_size) ? (block_size - total_data_size) : 0;
+
+  return SLA_APIRESULT_OK;
+}
+
+/* 供給済みのデータだけで確実にデコード可能なサンプル数を数える */
+/* 補足）max_num_samples以上数えたら打ち切る */
+static uint32_t SLAStreamingDecoder_CountDecodableNumSamples(
+    const struct SLAStreamingDecoder* decoder, uint32_t max_num_samples)
+{
+  uint32_t  total_data_size, block_offset, num_samples;
+  uint8_t   header[SLA_EXTENDED_BLOCK_HEADER_SIZE];
+
+  SLA_Assert(decoder != NULL);
+
+  /* デコード中ブロック先頭から数えた供給済みデータサイズ */
+  total_data_size = decoder->data_buffer_provided_size
+    + SLADataPacketQueue_GetRemainDataSize(decoder->queue);
+
+  /* 全体が揃っているブロックのサンプル数を合計 */
+  /* 補足）デコード中ブロックのデコード済みサンプル数は減じる */
+  num_samples = 0;
+  block_offset = 0;
+  while ((total_data_size - block_offset) >= SLA_MINIMUM_BLOCK_HEADER_SIZE) {
+    uint32_t block_size, header_size;
+    /* ブロックヘッダ先頭の読み出し */
+    header_size = SLAUTILITY_MIN(SLA_EXTENDED_BLOCK_HEADER_SIZE, total_data_size - block_offset);
+    if (SLAStreamingDecoder_PeekStreamData(decoder,
+          block_offset, header, header_size) != SLA_APIRESULT_OK) {
+      break;
+    }
+    /* 同期コードが見つからなければ以降は数えない */
+    if (SLAByteArray_ReadUint16(&header[0]) != SLA_BLOCK_SYNC_CODE) {
+      break;
+    }
+    block_size = SLAByteArray_ReadUint32(&header[2]) + SLA_BLOCK_SIZE_FIELD_END_OFFSET;
+    /* ブロック全体が揃っていない */
+    if ((block_size < SLA_MINIMUM_BLOCK_HEADER_SIZE) || (block_size > (total_data_size - block_offset))) {
+      break;
+    }
+    num_samples += SLAUtility_GetBlockNumSamples(header, header_size);
+    if (block_offset == 0) {
+      SLA_Assert(num_samples >= decoder->current_block_sample_offset);
+      num_samples -= decoder->current_block_sample_offset;
+    }
+    block_offset += block_size;
+    /* 十分数えた */
+    if (num_samples >= max_num_samples) {
+      break;
+    }
+  }
+
+  return num_samples;
+}
+
+/* 供給済みのデータだけで確実にデコード可能なサンプル数を取得 */
+SLAApiResult SLAStreamingDecoder_GetDecodableNumSamples(struct SLAStreamingDecoder* decoder,
+    uint32_t* decodable_num_samples)
+{
+  /* 引数チェック */
+  if ((decoder == NULL) || (decodable_num_samples == NULL)) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  /* 全て数える */
+  (*decodable_num_samples)
+    = SLAStreamingDecoder_CountDecodableNumSamples(decoder, UINT32_MAX);
+
+  return SLA_APIRESULT_OK;
+}
+
+/* キューから連結領域にデータを連結 */
+/* 補足）連結するのはデコード中ブロックの末尾まで（ブロックサイズが不明な間はサイズが確定する位置まで） */
+static void SLAStreamingDecoder_FillDataBuffer(struct SLAStreamingDecoder* decoder)
+{
+  const uint8_t* append_data;
+  uint32_t append_data_size, goal_size;
+
+  SLA_Assert(decoder != NULL);
+
+  while (1) {
+    /* 連結目標サイズの確定 */
+    if (decoder->data_buffer_provided_size < SLA_BLOCK_SIZE_FIELD_END_OFFSET) {
+      goal_size = SLA_BLOCK_SIZE_FIELD_END_OFFSET;
+    } else {
+      /* ブロック末尾まで。ただし壊れたデータで連結領域を超えないよう制限 */
+      goal_size = SLAByteArray_ReadUint32(&decoder->data_buffer[2]);
+      goal_size = SLAUTILITY_MIN(goal_size, decoder->data_buffer_size - SLA_BLOCK_SIZE_FIELD_END_OFFSET);
+      goal_size += SLA_BLOCK_SIZE_FIELD_END_OFFSET;
+    }
+
+    /* 目標に達した */
+    if (decoder->data_buffer_provided_size >= goal_size) {
+      break;
+    }
+
+    /* キューからデータ片を取り出して連結 */
+    if (SLADataPacketQueue_GetDataFragment(decoder->queue,
+          &append_data, &append_data_size,
+          goal_size - decoder->data_buffer_provided_size) != SLA_DATAPACKETQUEUE_APIRESULT_OK) {
+      break;
+    }
+    memcpy(&decoder->data_buffer[decoder->data_buffer_provided_size], append_data, append_data_size);
+    decoder->data_buffer_provided_size += append_data_size;
+    SLA_Assert(decoder->data_buffer_size >= decoder->data_buffer_provided_size);
+  }
+}
+
+/* ブロック先頭のデータを準備 */
+/* 補足）ブロック全体が1つのデータ片に収まっていればデータ片から直接デコードし、
+ *       そうでなければ連結領域にブロックを連結してデコードする */
+static SLAApiResult SLAStreamingDecoder_PrepareBlockData(struct SLAStreamingDecoder* decoder,
+    uint32_t* available_data_size)
+{
+  const uint8_t* fragment;
+  uint32_t fragment_size, block_size;
+
+  SLA_Assert((decoder != NULL) && (available_data_size != NULL));
+
+  /* 連結途中のデータがなければデータ片の先頭を参照 */
+  if ((decoder->data_buffer_provided_size == 0)
+      && (SLADataPacketQueue_PeekDataFragment(decoder->queue,
+          &fragment, &fragment_size) == SLA_DATAPACKETQUEUE_APIRESULT_OK)
+      && (fragment_size >= SLA_BLOCK_SIZE_FIELD_END_OFFSET)) {
+    block_size = SLAByteArray_ReadUint32(&fragment[2]);
+    /* ブロック全体がデータ片に収まっている */
+    if (block_size <= (fragment_size - SLA_BLOCK_SIZE_FIELD_END_OFFSET)) {
+      decoder->current_block_data = fragment;
+      decoder->is_direct_decoding = 1;
+      (*available_data_size) = block_size + SLA_BLOCK_SIZE_FIELD_END_OFFSET;
+      return SLA_APIRESULT_OK;
+    }
+  }
+
+  /* 連結領域にブロックを連結 */
+  SLAStreamingDecoder_FillDataBuffer(decoder);
+  if (decoder->data_buffer_provided_size < SLA_BLOCK_SIZE_FIELD_END_OFFSET) {
+    return SLA_APIRESULT_INSUFFICIENT_DATA_SIZE;
+  }
+
+  /* 連結領域に収まらないブロック */
+  block_size = SLAByteArray_ReadUint32(&decoder->data_buffer[2]);
+  if (block_size > (decoder->data_buffer_size - SLA_BLOCK_SIZE_FIELD_END_OFFSET)) {
+    return SLA_APIRESULT_EXCEED_HANDLE_CAPACITY;
+  }
+
+  decoder->current_block_data = decoder->data_buffer;
+  decoder->is_direct_decoding = 0;
+  (*available_data_size) = decoder->data_buffer_provided_size;
+  return SLA_APIRESULT_OK;
+}
+
+/* デコードが終わったブロックのデータを解放 */
+static void SLAStreamingDecoder_ReleaseBlockData(struct SLAStreamingDecoder* decoder)
+{
+  SLA_Assert(decoder != NULL);
+
+  if (decoder->is_direct_decoding == 1) {
+    const uint8_t* consumed_data;
+    uint32_t consumed_size;
+    /* データ片をブロックサイズ分消費済みにする（ここで初めて回収可能になる） */
+    (void)SLADataPacketQueue_GetDataFragment(decoder->queue,
+        &consumed_data, &consumed_size, decoder->current_block_header.block_size);
+    SLA_Assert(consumed_data == decoder->current_block_data);
+    SLA_Assert(consumed_size == decoder->current_block_header.block_size);
+  } else {
+    /* 連結領域はブロック末尾までしか連結していないので空にするだけ */
+    /* 補足）ブロック末尾まで届いていない分があれば、ここで連結して読み捨てる */
+    SLAStreamingDecoder_FillDataBuffer(decoder);
+    SLA_Assert(decoder->data_buffer_provided_size == decoder->current_block_header.block_size);
+    decoder->data_buffer_provided_size = 0;
+  }
+
+  decoder->current_block_data = NULL;
+  decoder->is_direct_decoding = 0;
+}
+
 /* デコーダにデータを供給 */
 SLAApiResult SLAStreamingDecoder_AppendDataFragment(struct SLAStreamingDecoder* decoder,
     const uint8_t* data, uint32_t data_size)
 {
-  const uint8_t* append_data;
-  uint32_t append_data_size;
-
   /* 引数チェック */
   if ((decoder == NULL) || (data == NULL)) {
     return SLA_APIRESULT_INVALID_ARGUMENT;
   }
 
   /* キューにデータ挿入 */
+  /* 補足）データ片はコピーせず、デコードが終わるまで参照する */
   if (SLADataPacketQueue_EnqueueDataFragment(
         decoder->queue, data, data_size) != SLA_DATAPACKETQUEUE_APIRESULT_OK) {
     return SLA_APIRESULT_EXCEED_HANDLE_CAPACITY;
   }
 
-  /* データ片を突っ込めるだけデコード領域にコピー */
-  SLA_Assert(decoder->data_buffer_size >= decoder->data_buffer_provided_size);
-  while (SLADataPacketQueue_GetDataFragment(
-          decoder->queue, &append_data, &append_data_size,
-          decoder->data_buffer_size - decoder->data_buffer_provided_size) != SLA_DATAPACKETQUEUE_APIRESULT_NO_DATA_FRAGMENTS) {
-    memcpy(&decoder->data_buffer[decoder->data_buffer_provided_size], append_data, append_data_size);
-    decoder->data_buffer_provided_size += append_data_size;
-    SLA_Assert(decoder->data_buffer_size >= decoder->data_buffer_provided_size);
+  /* 連結途中のブロックがあれば連結を進める（データ片を早く回収可能にする） */
+  if (decoder->data_buffer_provided_size > 0) {
+    SLAStreamingDecoder_FillDataBuffer(decoder);
   }
 
   return SLA_APIRESULT_OK;
@@ -1004,43 +2628,129 @@ SLAApiResult SLAStreamingDecoder_CollectDataFragment(struct SLAStreamingDecoder*
   return SLA_APIRESULT_OK;
 }
 
+/* 次のブロックのCRC16をデコード中ブロックの進捗に合わせて少しずつ計算 */
+/* 補足）ブロック境界でブロック全体のCRC16を計算すると、その呼び出しだけ処理時間が突出する。
+ *       デコード中ブロックのサンプル進捗と同じ割合まで次のブロックを計算しておき、境界では残りだけを計算する。
+ *       次のブロックのデータが届いていなければ、届いている分まで計算する */
+static void SLAStreamingDecoder_UpdateNextBlockCRC16(struct SLAStreamingDecoder* decoder)
+{
+  uint8_t   size_field[SLA_BLOCK_SIZE_FIELD_END_OFFSET];
+  uint32_t  next_block_offset, next_block_size, goal_size;
+
+  SLA_Assert(decoder != NULL);
+  SLA_Assert(decoder->current_block_header.block_num_samples > 0);
+
+  /* 次のブロックのサイズが読めるか */
+  next_block_offset = decoder->current_block_header.block_size;
+  if (SLAStreamingDecoder_PeekStreamData(decoder,
+        next_block_offset, size_field, SLA_BLOCK_SIZE_FIELD_END_OFFSET) != SLA_APIRESULT_OK) {
+    return;
+  }
+  /* 壊れたブロックサイズの判定は次のブロック先頭での照合に任せる */
+  next_block_size = SLAByteArray_ReadUint32(&size_field[2]) + SLA_BLOCK_SIZE_FIELD_END_OFFSET;
+  if ((next_block_size < SLA_MINIMUM_BLOCK_HEADER_SIZE)
+      || (next_block_size > (UINT32_MAX - next_block_offset))) {
+    return;
+  }
+
+  /* デコード中ブロックの進捗に比例したサイズまで計算 */
+  goal_size = (uint32_t)(((uint64_t)(next_block_size - SLA_BLOCK_CRC16_CALC_START_OFFSET)
+        * decoder->current_block_sample_offset) / decoder->current_block_header.block_num_samples);
+  SLA_STATISTICS_START_STAGE(decoder->decoder_core);
+  while (decoder->block_crc16_progress < goal_size) {
+    const uint8_t* data;
+    uint32_t data_size;
+    if (SLAStreamingDecoder_PeekStreamDataFragmentAt(decoder,
+          next_block_offset + SLA_BLOCK_CRC16_CALC_START_OFFSET + decoder->block_crc16_progress,
+          &data, &data_size) != SLA_APIRESULT_OK) {
+      break;
+    }
+    data_size = SLAUTILITY_MIN(data_size, goal_size - decoder->block_crc16_progress);
+    decoder->block_crc16 = SLAUtility_UpdateCRC16(decoder->block_crc16, data, data_size);
+    decoder->block_crc16_progress += data_size;
+  }
+  SLA_STATISTICS_END_STAGE(decoder->decoder_core, SLA_STATISTICS_STAGE_CRC);
+}
+
+/* デコード中ブロックのCRC16照合 */
+/* 補足）前のブロックのデコード中に計算済みの分に続けて、残りだけを計算する */
+static SLAApiResult SLAStreamingDecoder_CheckBlockCRC16(struct SLAStreamingDecoder* decoder,
+    uint32_t available_data_size)
+{
+  uint16_t crc16;
+  uint32_t block_size;
+
+  SLA_Assert(decoder != NULL);
+  SLA_Assert(decoder->current_block_data != NULL);
+
+  /* ブロック全体が揃っていなければ照合できない */
+  block_size = decoder->current_block_header.block_size;
+  if (available_data_size < block_size) {
+    return SLA_APIRESULT_INSUFFICIENT_DATA_SIZE;
+  }
+  if (block_size < SLA_MINIMUM_BLOCK_HEADER_SIZE) {
+    return SLA_APIRESULT_DETECT_DATA_CORRUPTION;
+  }
+  SLA_Assert(decoder->block_crc16_progress <= (block_size - SLA_BLOCK_CRC16_CALC_START_OFFSET));
+
+  /* 残りを計算 */
+  SLA_STATISTICS_START_STAGE(decoder->decoder_core);
+  crc16 = SLAUtility_UpdateCRC16(decoder->block_crc16,
+      &decoder->current_block_data[SLA_BLOCK_CRC16_CALC_START_OFFSET + decoder->block_crc16_progress],
+      block_size - SLA_BLOCK_CRC16_CALC_START_OFFSET - decoder->block_crc16_progress);
+  SLA_STATISTICS_END_STAGE(decoder->decoder_core, SLA_STATISTICS_STAGE_CRC);
+
+  /* 途中結果は次のブロックの計算に使う */
+  decoder->block_crc16          = 0;
+  decoder->block_crc16_progress = 0;
+
+  /* 記録されたCRC16と照合 */
+  if (crc16 != SLAByteArray_ReadUint16(&decoder->current_block_data[SLA_BLOCK_SIZE_FIELD_END_OFFSET])) {
+    return SLA_APIRESULT_DETECT_DATA_CORRUPTION;
+  }
+
+  return SLA_APIRESULT_OK;
+}
+
 /* ストリーミングデコードコア処理 */
+/* 補足）CRCチェック有効時は、ブロック先頭でブロック全体のCRC16を照合してからデコードする。
+ *       途中まで出力したブロックが後から破損と分かることはない */
 static SLAApiResult SLAStreamingDecoder_DecodeCore(struct SLAStreamingDecoder* decoder,
-    int32_t** buffer, uint32_t buffer_num_samples, uint32_t* num_output_samples)
+    int32_t** buffer, uint32_t goal_num_samples)
 {
-  uint32_t      ch;
-  uint32_t      num_decode_samples, goal_num_samples;
-  uint32_t      sample_progress, decoded_data_progress;
+  uint32_t      num_decode_samples;
+  uint32_t      sample_progress;
   SLAApiResult  ret;
-  int32_t*      buffer_ptr[SLA_MAX_CHANNELS];
+  struct SLAPcmOutput pcm_output;
   uint32_t      output_wavedata_size;
-  static uint32_t      block_offset;
 
   /* 内部関数なので引数は非NULLを要求 */
-  SLA_Assert((decoder != NULL) && (buffer != NULL) && (num_output_samples != NULL));
-  SLA_Assert(buffer_num_samples > 0);
-
-  /* デコードするべきサンプル数 */
-  goal_num_samples = SLAUTILITY_MIN(buffer_num_samples, decoder->num_output_samples_per_decode);
+  SLA_Assert((decoder != NULL) && (buffer != NULL));
 
   /* デコードサンプル数に達するまでデコードし続ける */
   sample_progress = 0;
-  decoded_data_progress = 0;
   while (sample_progress < goal_num_samples) {
     /* ブロック先頭 */
     if (decoder->current_block_sample_offset == 0) {
-      uint32_t block_header_size;
+      uint32_t block_header_size, available_data_size;
+      /* ブロックデータの準備 */
+      if ((ret = SLAStreamingDecoder_PrepareBlockData(decoder, &available_data_size)) != SLA_APIRESULT_OK) {
+        return ret;
+      }
       /* ストリームを開く */
       SLABitReader_Open(&decoder->decoder_core->strm,
-          decoder->data_buffer, decoder->data_buffer_size);
+          (uint8_t *)decoder->current_block_data, available_data_size);
       /* ブロックヘッダ読み取り */
-      if ((ret = SLADecoder_DecodeBlockHeader(decoder->decoder_core, 
-              decoder->data_buffer, decoder->data_buffer_provided_size,
+      if ((ret = SLADecoder_DecodeBlockHeader(decoder->decoder_core,
+              decoder->current_block_data, available_data_size, 0,
               &decoder->current_block_header, &block_header_size)) != SLA_APIRESULT_OK) {
         return ret;
       }
-      decoded_data_progress += block_header_size;
-      block_offset += block_header_size;
+      /* CRCチェック有効時は出力前にブロック全体を照合 */
+      if ((decoder->decoder_core->enable_crc_check == 1)
+          && ((ret = SLAStreamingDecoder_CheckBlockCRC16(decoder, available_data_size)) != SLA_APIRESULT_OK)) {
+        return ret;
+      }
       /* サンプルあたりバイト数の更新 */
       decoder->estimated_bytes_per_sample
         = (float)((double)decoder->current_block_header.block_size / decoder->current_block_header.block_num_samples);
@@ -1053,37 +2763,36 @@ static SLAApiResult SLAStreamingDecoder_DecodeCore(struct SLAStreamingDecoder* d
       = SLAUTILITY_MIN(goal_num_samples - sample_progress,
           decoder->current_block_header.block_num_samples - decoder->current_block_sample_offset);
 
-    /* バッファオーバーラン検知 */
-    if (buffer_num_samples < (sample_progress + num_decode_samples)) {
-      return SLA_APIRESULT_INSUFFICIENT_BUFFER_SIZE;
+    /* 連結中のブロックであれば届いている分を連結 */
+    if (decoder->is_direct_decoding == 0) {
+      SLAStreamingDecoder_FillDataBuffer(decoder);
     }
 
     /* デコード実行 */
-    for (ch = 0; ch < decoder->decoder_core->wave_format.num_channels; ch++) {
-      buffer_ptr[ch] = &buffer[ch][sample_progress];
-    }
+    SLADecoder_SetLeftJustifiedPcmOutput(decoder->decoder_core->wave_format.num_channels,
+        buffer, sample_progress, decoder->decoder_core->channel_data, &pcm_output);
     if ((ret = SLADecoder_DecodeWaveData(
-            decoder->decoder_core, buffer_ptr, num_decode_samples, &output_wavedata_size)) != SLA_APIRESULT_OK) {
+            decoder->decoder_core, &pcm_output, num_decode_samples, &output_wavedata_size)) != SLA_APIRESULT_OK) {
       return ret;
     }
 
     /* デコード進捗を進める */
     sample_progress                       += num_decode_samples;
     decoder->current_block_sample_offset  += num_decode_samples;
-    decoded_data_progress                 += output_wavedata_size;
+
+    /* 次のブロックのCRC16を進捗に合わせて計算 */
+    if (decoder->decoder_core->enable_crc_check == 1) {
+      SLAStreamingDecoder_UpdateNextBlockCRC16(decoder);
+    }
 
     /* ブロック末尾に達した */
     if (decoder->current_block_sample_offset >= decoder->current_block_header.block_num_samples) {
       /* ぴったりブロック末尾でなければならない */
       SLA_Assert(decoder->current_block_sample_offset == decoder->current_block_header.block_num_samples);
-      SLA_Assert(decoder->data_buffer_provided_size >= decoder->current_block_header.block_size);
-      /* ブロック末尾でのデータ折返し */
-      memmove(decoder->data_buffer,
-          &decoder->data_buffer[decoder->current_block_header.block_size],
-          decoder->data_buffer_provided_size - decoder->current_block_header.block_size);
-      decoder->data_buffer_provided_size -= decoder->current_block_header.block_size;
       /* ストリームを閉じる */
       SLABitStream_Close(&decoder->decoder_core->strm);
+      /* ブロックデータの解放 */
+      SLAStreamingDecoder_ReleaseBlockData(decoder);
       /* ブロック内のオフセットを0に戻す */
       decoder->current_block_sample_offset = 0;
     }
@@ -1092,9 +2801,6 @@ static SLAApiResult SLAStreamingDecoder_DecodeCore(struct SLAStreamingDecoder* d
   /* 目標サンプル数きっちりデコードしなければならない */
   SLA_Assert(sample_progress == goal_num_samples);
 
-  /* 出力データサイズの記録 */
-  (*num_output_samples) = goal_num_samples;
-
   return SLA_APIRESULT_OK;
 }
 
@@ -1102,7 +2808,7 @@ static SLAApiResult SLAStreamingDecoder_DecodeCore(struct SLAStreamingDecoder* d
 SLAApiResult SLAStreamingDecoder_Decode(struct SLAStreamingDecoder* decoder,
     int32_t** buffer, uint32_t buffer_num_samples, uint32_t* num_output_samples)
 {
-  uint32_t      tmp_num_output_samples;
+  uint32_t      goal_num_samples;
   SLAApiResult  ret;
 
   /* 引数チェック */
@@ -1110,14 +2816,260 @@ SLAApiResult SLAStreamingDecoder_Decode(struct SLAStreamingDecoder* decoder,
     return SLA_APIRESULT_INVALID_ARGUMENT;
   }
 
+  /* デコードするべきサンプル数 */
+  goal_num_samples = SLAUTILITY_MIN(buffer_num_samples, decoder->num_output_samples_per_decode);
+  SLA_Assert(goal_num_samples > 0);
+
+  /* CRCチェック有効時は全体が揃ったブロックの分だけデコードする */
+  /* 補足）揃ったブロックが無ければコア処理がブロック先頭でデータ不足（または破損）を返す */
+  if (decoder->decoder_core->enable_crc_check == 1) {
+    uint32_t decodable_num_samples = SLAStreamingDecoder_CountDecodableNumSamples(decoder, goal_num_samples);
+    if (decodable_num_samples > 0) {
+      goal_num_samples = SLAUTILITY_MIN(goal_num_samples, decodable_num_samples);
+    }
+  }
+
   /* コア処理実行 */
-  if ((ret = SLAStreamingDecoder_DecodeCore(decoder,
-          buffer, buffer_num_samples, &tmp_num_output_samples))) {
+  if ((ret = SLAStreamingDecoder_DecodeCore(decoder, buffer, goal_num_samples)) != SLA_APIRESULT_OK) {
     return ret;
   }
 
   /* 出力サンプル数の書き出し */
-  (*num_output_samples) = tmp_num_output_samples;
+  (*num_output_samples) = goal_num_samples;
+
+  return SLA_APIRESULT_OK;
+}
+
+/* 指定サンプル数ちょうどのストリーミングデコード */
+SLAApiResult SLAStreamingDecoder_DecodeFrames(struct SLAStreamingDecoder* decoder,
+    int32_t** buffer, uint32_t num_frames)
+{
+  /* 引数チェック */
+  if ((decoder == NULL) || (buffer == NULL)) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  /* 全体が揃ったブロックだけで足りなければ何もしない */
+  /* 補足）ブロックの途中でデータが尽きて状態が壊れることを防ぐ */
+  if (SLAStreamingDecoder_CountDecodableNumSamples(decoder, num_frames) < num_frames) {
+    return SLA_APIRESULT_INSUFFICIENT_DATA_SIZE;
+  }
+
+  /* コア処理実行 */
+  return SLAStreamingDecoder_DecodeCore(decoder, buffer, num_frames);
+}
+
+/* 統計情報の取得 */
+SLAApiResult SLAStreamingDecoder_GetStatistics(const struct SLAStreamingDecoder* decoder,
+    struct SLAStatistics* statistics)
+{
+  /* 引数チェック */
+  if (decoder == NULL) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  return SLADecoder_GetStatistics(decoder->decoder_core, statistics);
+}
+
+/* デコーダハンドルプールの作成 */
+struct SLADecoderPool* SLADecoderPool_Create(const struct SLADecoderConfig* config, uint32_t num_decoders)
+{
+  uint32_t i;
+  int32_t decoder_work_size;
+  uint64_t work_size;
+  uint8_t* work;
+  uint8_t* work_ptr;
+  struct SLADecoderPool* pool;
+
+  /* 引数チェック */
+  if ((config == NULL) || (num_decoders == 0)) {
+    return NULL;
+  }
+  if ((decoder_work_size = SLADecoder_CalculateWorkSize(config)) < 0) {
+    return NULL;
+  }
+
+  /* プール本体と全ハンドルを1つのワーク領域にまとめる */
+  /* 補足）ハンドル数の積はuint64_tで計算し、size_tで表せなければ作成しない */
+  work_size = (uint64_t)SLA_MEMORY_ALIGNMENT + SLAUTILITY_WORK_SIZE64(sizeof(struct SLADecoderPool));
+  work_size += SLAUTILITY_WORK_SIZE64((uint64_t)sizeof(struct SLADecoder *) * num_decoders);
+  work_size += SLAUTILITY_WORK_SIZE64((uint64_t)sizeof(uint8_t) * num_decoders);
+  work_size += SLAUTILITY_WORK_SIZE64((uint64_t)sizeof(struct SLADecoderBatchWorker) * num_decoders);
+  work_size += (uint64_t)num_decoders * SLAUTILITY_WORK_SIZE64(decoder_work_size);
+  if ((uint64_t)(size_t)work_size != work_size) {
+    return NULL;
+  }
+  if ((work = (uint8_t *)malloc((size_t)work_size)) == NULL) {
+    return NULL;
+  }
+  work_ptr = SLAUTILITY_ALIGN_WORK(work);
+
+  pool = (struct SLADecoderPool *)SLAUtility_AllocateWork(&work_ptr, sizeof(struct SLADecoderPool));
+  pool->work          = work;
+  pool->num_decoders  = num_decoders;
+  pool->decoders      = (struct SLADecoder **)SLAUtility_AllocateWork(&work_ptr, sizeof(struct SLADecoder *) * num_decoders);
+  pool->in_use        = (uint8_t *)SLAUtility_AllocateWork(&work_ptr, sizeof(uint8_t) * num_decoders);
+  pool->workers       = (struct SLADecoderBatchWorker *)SLAUtility_AllocateWork(&work_ptr, sizeof(struct SLADecoderBatchWorker) * num_decoders);
+  for (i = 0; i < num_decoders; i++) {
+    pool->decoders[i] = SLADecoder_CreateWithWork(config,
+        SLAUtility_AllocateWork(&work_ptr, (size_t)decoder_work_size), decoder_work_size);
+    if (pool->decoders[i] == NULL) {
+      free(work);
+      return NULL;
+    }
+    pool->in_use[i]   = 0;
+  }
+
+  SLA_Assert((uint64_t)(work_ptr - work) <= work_size);
+
+  return pool;
+}
+
+/* デコーダハンドルプールの破棄 */
+void SLADecoderPool_Destroy(struct SLADecoderPool* pool)
+{
+  if (pool != NULL) {
+    free(pool->work);
+  }
+}
+
+/* プールからデコーダハンドルを取得 */
+struct SLADecoder* SLADecoderPool_Acquire(struct SLADecoderPool* pool)
+{
+  uint32_t i;
+
+  /* 引数チェック */
+  if (pool == NULL) {
+    return NULL;
+  }
+
+  /* 空いているハンドルをリセットして貸し出す */
+  for (i = 0; i < pool->num_decoders; i++) {
+    if (!pool->in_use[i]) {
+      SLADecoder_Reset(pool->decoders[i]);
+      pool->in_use[i] = 1;
+      return pool->decoders[i];
+    }
+  }
+
+  /* 全て貸出中 */
+  return NULL;
+}
+
+/* デコーダハンドルをプールに返却 */
+SLAApiResult SLADecoderPool_Release(struct SLADecoderPool* pool, struct SLADecoder* decoder)
+{
+  uint32_t i;
+
+  /* 引数チェック */
+  if ((pool == NULL) || (decoder == NULL)) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  for (i = 0; i < pool->num_decoders; i++) {
+    if ((pool->decoders[i] == decoder) && pool->in_use[i]) {
+      pool->in_use[i] = 0;
+      return SLA_APIRESULT_OK;
+    }
+  }
+
+  /* このプールから貸し出したハンドルではない */
+  return SLA_APIRESULT_INVALID_ARGUMENT;
+}
+
+/* 一括デコードのワーカ処理: start番目からstride毎のデータをデコード */
+static void SLADecoder_DecodeBatchWorker(void* arg)
+{
+  uint32_t i;
+  struct SLADecoderBatchWorker* worker = (struct SLADecoderBatchWorker *)arg;
+
+  for (i = worker->start; i < worker->num_items; i += worker->stride) {
+    struct SLADecodeBatchItem* item = &worker->items[i];
+    item->output_num_samples = 0;
+    if ((item->data == NULL) || (item->buffer == NULL)) {
+      item->result = SLA_APIRESULT_INVALID_ARGUMENT;
+    } else {
+      SLADecoder_Reset(worker->decoder);
+      item->result = SLADecoder_DecodeWhole(worker->decoder,
+          item->data, item->data_size,
+          item->buffer, item->buffer_num_samples, &item->output_num_samples);
+    }
+    /* 次のデータ番号が桁あふれする場合は終了 */
+    if (worker->stride > (worker->num_items - i)) {
+      break;
+    }
+  }
+}
+
+/* 複数データの一括デコード */
+SLAApiResult SLADecoder_DecodeBatch(struct SLADecoderPool* pool,
+    struct SLADecodeBatchItem* items, uint32_t num_items)
+{
+  return SLADecoder_DecodeBatchParallel(pool, items, num_items, NULL);
+}
+
+/* 複数データの並列一括デコード */
+SLAApiResult SLADecoder_DecodeBatchParallel(struct SLADecoderPool* pool,
+    struct SLADecodeBatchItem* items, uint32_t num_items,
+    const struct SLADecodeBatchThreadFunctions* thread_functions)
+{
+  uint32_t i, num_workers, max_num_workers;
+  struct SLADecoder* decoder;
+
+  /* 引数チェック */
+  if ((pool == NULL) || (items == NULL)) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+  if ((thread_functions != NULL)
+      && ((thread_functions->spawn == NULL) || (thread_functions->join == NULL))) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  /* 空いているハンドルをワーカ毎に1つずつ借りる（スレッド起動前に呼び出しスレッドで行う） */
+  max_num_workers = (thread_functions != NULL) ? SLAUTILITY_MIN(num_items, pool->num_decoders) : 1;
+  max_num_workers = SLAUTILITY_MAX(max_num_workers, 1);
+  num_workers = 0;
+  while ((num_workers < max_num_workers)
+      && ((decoder = SLADecoderPool_Acquire(pool)) != NULL)) {
+    pool->workers[num_workers].decoder = decoder;
+    num_workers++;
+  }
+  if (num_workers == 0) {
+    return SLA_APIRESULT_EXCEED_HANDLE_CAPACITY;
+  }
+
+  /* データはワーカ毎に飛び飛びに割り当てる（先頭のワーカは呼び出しスレッドで処理） */
+  for (i = 0; i < num_workers; i++) {
+    struct SLADecoderBatchWorker* worker = &pool->workers[i];
+    worker->items     = items;
+    worker->num_items = num_items;
+    worker->start     = i;
+    worker->stride    = num_workers;
+    worker->thread    = NULL;
+    if (i > 0) {
+      /* 起動できなければ呼び出しスレッドで処理する */
+      worker->thread = thread_functions->spawn(
+          SLADecoder_DecodeBatchWorker, worker, thread_functions->user_data);
+    }
+  }
+  for (i = 0; i < num_workers; i++) {
+    if (pool->workers[i].thread == NULL) {
+      SLADecoder_DecodeBatchWorker(&pool->workers[i]);
+    }
+  }
+  for (i = 0; i < num_workers; i++) {
+    if (pool->workers[i].thread != NULL) {
+      thread_functions->join(pool->workers[i].thread, thread_functions->user_data);
+    }
+    SLADecoderPool_Release(pool, pool->workers[i].decoder);
+  }
+
+  /* 失敗したデータがあっても残りはデコードし、先頭から見て最初の失敗を返す */
+  for (i = 0; i < num_items; i++) {
+    if (items[i].result != SLA_APIRESULT_OK) {
+      return items[i].result;
+    }
+  }
 
   return SLA_APIRESULT_OK;
 }
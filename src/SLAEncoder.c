@@ -14,6 +14,11 @@
 #define SLAENCODER_STATUS_FLAG_SET_WAVE_FORMAT      (1 << 0)    /* 波形フォーマットセット済み     */
 #define SLAENCODER_STATUS_FLAG_SET_ENCODE_PARAMETER (1 << 1)    /* エンコードパラメータセット済み */
 
+/* 3byte詰め24bit符号付き整数（リトルエンディアン）の読み出し */
+#define SLAENCODER_GET_PACKED_INT24(p)\
+  (int32_t)SLAUTILITY_SHIFT_RIGHT_ARITHMETIC(\
+      (int32_t)(((uint32_t)(p)[0] << 8) | ((uint32_t)(p)[1] << 16) | ((uint32_t)(p)[2] << 24)), 8)
+
 /* エンコーダハンドル */
 struct SLAEncoder {
   struct SLAWaveFormat          wave_format;
@@ -48,19 +53,115 @@ struct SLAEncoder {
   int32_t**                     residual;
   int32_t**                     tmp_residual;
   uint32_t*                     num_block_partition_samples;
+  const void**                  channel_data;     /* 32bit左詰め入力をPCM入力として参照するためのポインタ配列 */
+  uint32_t*                     raw_data_bits;    /* 生データ書き出し時のチャンネル毎のビット幅 */
   uint32_t                      status_flag;
   uint8_t                       verpose_flag;
+#ifdef SLA_ENABLE_STATISTICS
+  struct SLAStatistics          statistics;       /* 統計情報               */
+  uint64_t                      stage_start_tick; /* 計測中の処理段階の開始時刻 */
+#endif
+  uint8_t                       alloced_by_own;   /* 自前で領域を確保したか */
+  void*                         work;             /* ワーク領域先頭ポインタ */
 };
 
-/* エンコーダハンドルの作成 */
-struct SLAEncoder* SLAEncoder_Create(const struct SLAEncoderConfig* config)
+/* エンコーダハンドルの作成に必要なワークサイズ計算 */
+/* 補足）合計はuint64_tで計算し、int32_tで表せなければ-1を返す */
+int32_t SLAEncoder_CalculateWorkSize(const struct SLAEncoderConfig* config)
+{
+  uint64_t work_size;
+  int32_t oee_work_size, ltc_work_size, coder_work_size, lpcc_work_size;
+  int32_t lpcs_work_size, ltms_work_size, lms_work_size, emp_work_size;
+  uint32_t max_num_channels, max_num_block_samples, max_parcor_order, max_longterm_order;
+
+  /* 引数チェック */
+  if (config == NULL) {
+    return -1;
+  }
+
+  /* 下位モジュールのサイズ計算（32bit）が桁あふれしない範囲に制限 */
+  if (config->max_num_block_samples > SLA_MAX_NUM_BLOCK_SAMPLES) {
+    return -1;
+  }
+
+  /* 頻繁に参照する変数をオート変数に受ける */
+  max_num_channels      = config->max_num_channels;
+  max_num_block_samples = config->max_num_block_samples;
+  max_parcor_order      = config->max_parcor_order;
+  max_longterm_order    = config->max_longterm_order;
+
+  /* ハンドル本体 */
+  work_size = (uint64_t)SLA_MEMORY_ALIGNMENT + SLAUTILITY_WORK_SIZE64(sizeof(struct SLAEncoder));
+
+  /* チャンネル毎の領域を指すポインタ配列 */
+  work_size += 3 * SLAUTILITY_WORK_SIZE64(sizeof(double *) * max_num_channels);   /* input_double, parcor_coef, longterm_coef */
+  work_size += 6 * SLAUTILITY_WORK_SIZE64(sizeof(int32_t *) * max_num_channels);  /* input_int32, residual, tmp_residual, parcor_coef_int32, parcor_coef_code, longterm_coef_int32 */
+  work_size += 2 * SLAUTILITY_WORK_SIZE64(sizeof(uint32_t) * max_num_channels);   /* parcor_rshift, pitch_period */
+  work_size += SLAUTILITY_WORK_SIZE64(sizeof(void *) * max_num_channels);         /* channel_data */
+  work_size += SLAUTILITY_WORK_SIZE64(sizeof(uint32_t) * max_num_channels);       /* raw_data_bits */
+
+  /* チャンネル毎の領域 */
+  work_size += (uint64_t)max_num_channels * (
+      SLAUTILITY_WORK_SIZE64(sizeof(double) * max_num_block_samples)          /* input_double */
+      + 3 * SLAUTILITY_WORK_SIZE64(sizeof(int32_t) * max_num_block_samples)   /* input_int32, residual, tmp_residual */
+      + SLAUTILITY_WORK_SIZE64(sizeof(double) * (max_parcor_order + 1))       /* parcor_coef */
+      + 2 * SLAUTILITY_WORK_SIZE64(sizeof(int32_t) * (max_parcor_order + 1))  /* parcor_coef_int32, parcor_coef_code */
+      + SLAUTILITY_WORK_SIZE64(sizeof(double) * max_longterm_order)           /* longterm_coef */
+      + SLAUTILITY_WORK_SIZE64(sizeof(int32_t) * max_longterm_order));        /* longterm_coef_int32 */
+
+  /* 窓関数・ブロック分割結果 */
+  work_size += SLAUTILITY_WORK_SIZE64(sizeof(double) * max_num_block_samples);
+  work_size += SLAUTILITY_WORK_SIZE64(sizeof(uint32_t)
+      * SLAOptimalEncodeEstimator_CalculateMaxNumPartitions(SLA_GET_SEARCH_BLOCK_WORK_NUM_SAMPLES(max_num_block_samples), SLA_SEARCH_BLOCK_NUM_SAMPLES_DELTA));
+
+  /* 各種ハンドル */
+  coder_work_size = SLACoder_CalculateWorkSize(max_num_channels, SLACODER_NUM_RECURSIVERICE_PARAMETER);
+  lpcc_work_size  = SLALPCCalculator_CalculateWorkSize(max_parcor_order);
+  ltc_work_size   = SLALongTermCalculator_CalculateWorkSize(
+      SLAUTILITY_ROUNDUP2POWERED(max_num_block_samples * 2), SLALONGTERM_MAX_PERIOD, SLALONGTERM_NUM_PITCH_CANDIDATES, max_longterm_order);
+  if ((coder_work_size < 0) || (lpcc_work_size < 0) || (ltc_work_size < 0)) {
+    return -1;
+  }
+  work_size += (uint64_t)coder_work_size + (uint64_t)lpcc_work_size + (uint64_t)ltc_work_size;
+  /* 探索ハンドルはブロックサイズが小さいと作成できない（その場合は探索を使わない） */
+  oee_work_size = SLAOptimalEncodeEstimator_CalculateWorkSize(SLA_GET_SEARCH_BLOCK_WORK_NUM_SAMPLES(max_num_block_samples), SLA_SEARCH_BLOCK_NUM_SAMPLES_DELTA);
+  work_size += (uint64_t)SLAUTILITY_MAX(oee_work_size, 0);
+
+  /* チャンネル毎のハンドル */
+  work_size += SLAUTILITY_WORK_SIZE64(sizeof(struct SLALPCSynthesizer *) * max_num_channels);
+  work_size += SLAUTILITY_WORK_SIZE64(sizeof(struct SLALongTermSynthesizer *) * max_num_channels);
+  work_size += SLAUTILITY_WORK_SIZE64(sizeof(struct SLALMSFilter *) * max_num_channels);
+  work_size += SLAUTILITY_WORK_SIZE64(sizeof(struct SLAEmphasisFilter *) * max_num_channels);
+  lpcs_work_size  = SLALPCSynthesizer_CalculateWorkSize(max_parcor_order);
+  ltms_work_size  = SLALongTermSynthesizer_CalculateWorkSize(max_longterm_order, SLALONGTERM_MAX_PERIOD);
+  lms_work_size   = SLALMSFilter_CalculateWorkSize(config->max_lms_order_per_filter);
+  emp_work_size   = SLAEmphasisFilter_CalculateWorkSize();
+  if ((lpcs_work_size < 0) || (ltms_work_size < 0) || (lms_work_size < 0) || (emp_work_size < 0)) {
+    return -1;
+  }
+  work_size += (uint64_t)max_num_channels * ((uint64_t)lpcs_work_size
+      + (uint64_t)ltms_work_size + (uint64_t)lms_work_size + (uint64_t)emp_work_size);
+
+  /* int32_tで表せないサイズ */
+  if (work_size > INT32_MAX) {
+    return -1;
+  }
+
+  return (int32_t)work_size;
+}
+
+/* エンコーダハンドルの作成（ワーク領域指定） */
+struct SLAEncoder* SLAEncoder_CreateWithWork(const struct SLAEncoderConfig* config, void* work, int32_t work_size)
 {
   struct SLAEncoder* encoder;
   uint32_t ch; 
   uint32_t max_num_channels, max_num_block_samples;
+  int32_t required_work_size, tmp_work_size;
+  uint8_t* work_ptr;
 
   /* 引数チェック */
-  if (config == NULL) {
+  required_work_size = SLAEncoder_CalculateWorkSize(config);
+  if ((work == NULL) || (required_work_size < 0) || (work_size < required_work_size)) {
     return NULL;
   }
 
@@ -68,107 +169,124 @@ struct SLAEncoder* SLAEncoder_Create(const struct SLAEncoderConfig* config)
   max_num_channels      = config->max_num_channels;
   max_num_block_samples = config->max_num_block_samples;
 
-  encoder = malloc(sizeof(struct SLAEncoder));
+  work_ptr = SLAUTILITY_ALIGN_WORK(work);
+
+  encoder = (struct SLAEncoder *)SLAUtility_AllocateWork(&work_ptr, sizeof(struct SLAEncoder));
   encoder->max_num_channels         = max_num_channels;
   encoder->max_num_block_samples    = max_num_block_samples;
   encoder->max_parcor_order         = config->max_parcor_order;
   encoder->max_longterm_order       = config->max_longterm_order;
   encoder->max_lms_order_per_filter = config->max_lms_order_per_filter;
   encoder->verpose_flag             = config->verpose_flag;
+  encoder->alloced_by_own           = 0;
+  encoder->work                     = work;
 
   /* 各種領域割当て */
-  encoder->input_double           = (double **)malloc(sizeof(double *) * max_num_channels);
-  encoder->input_int32            = (int32_t **)malloc(sizeof(int32_t *) * max_num_channels);
-  encoder->residual               = (int32_t **)malloc(sizeof(int32_t *) * max_num_channels);
-  encoder->tmp_residual           = (int32_t **)malloc(sizeof(int32_t *) * max_num_channels);
-  encoder->parcor_coef            = (double **)malloc(sizeof(double *) * max_num_channels);
-  encoder->parcor_coef_int32      = (int32_t **)malloc(sizeof(int32_t *) * max_num_channels);
-  encoder->parcor_coef_code       = (int32_t **)malloc(sizeof(int32_t *) * max_num_channels);
-  encoder->parcor_rshift          = (uint32_t *)malloc(sizeof(uint32_t) * max_num_channels);
-  encoder->longterm_coef          = (double **)malloc(sizeof(double *) * max_num_channels);
-  encoder->longterm_coef_int32    = (int32_t **)malloc(sizeof(int32_t *) * max_num_channels);
+  encoder->input_double           = (double **)SLAUtility_AllocateWork(&work_ptr, sizeof(double *) * max_num_channels);
+  encoder->input_int32            = (int32_t **)SLAUtility_AllocateWork(&work_ptr, sizeof(int32_t *) * max_num_channels);
+  encoder->residual               = (int32_t **)SLAUtility_AllocateWork(&work_ptr, sizeof(int32_t *) * max_num_channels);
+  encoder->tmp_residual           = (int32_t **)SLAUtility_AllocateWork(&work_ptr, sizeof(int32_t *) * max_num_channels);
+  encoder->parcor_coef            = (double **)SLAUtility_AllocateWork(&work_ptr, sizeof(double *) * max_num_channels);
+  encoder->parcor_coef_int32      = (int32_t **)SLAUtility_AllocateWork(&work_ptr, sizeof(int32_t *) * max_num_channels);
+  encoder->parcor_coef_code       = (int32_t **)SLAUtility_AllocateWork(&work_ptr, sizeof(int32_t *) * max_num_channels);
+  encoder->parcor_rshift          = (uint32_t *)SLAUtility_AllocateWork(&work_ptr, sizeof(uint32_t) * max_num_channels);
+  encoder->longterm_coef          = (double **)SLAUtility_AllocateWork(&work_ptr, sizeof(double *) * max_num_channels);
+  encoder->longterm_coef_int32    = (int32_t **)SLAUtility_AllocateWork(&work_ptr, sizeof(int32_t *) * max_num_channels);
 
   for (ch = 0; ch < max_num_channels; ch++) {
-    encoder->input_double[ch]         = (double *)malloc(sizeof(double) * max_num_block_samples);
-    encoder->input_int32[ch]          = (int32_t *)malloc(sizeof(int32_t) * max_num_block_samples);
-    encoder->parcor_coef_code[ch]     = (int32_t *)malloc(sizeof(int32_t) * max_num_block_samples);
-    encoder->residual[ch]             = (int32_t *)malloc(sizeof(int32_t) * max_num_block_samples);
-    encoder->tmp_residual[ch]         = (int32_t *)malloc(sizeof(int32_t) * max_num_block_samples);
-    encoder->parcor_coef[ch]          = (double *)malloc(sizeof(double) * (config->max_parcor_order + 1));
-    encoder->parcor_coef_int32[ch]    = (int32_t *)malloc(sizeof(int32_t) * (config->max_parcor_order + 1));
-    encoder->longterm_coef[ch]        = (double *)malloc(sizeof(double) * config->max_longterm_order);
-    encoder->longterm_coef_int32[ch]  = (int32_t *)malloc(sizeof(int32_t) * config->max_longterm_order);
+    encoder->input_double[ch]         = (double *)SLAUtility_AllocateWork(&work_ptr, sizeof(double) * max_num_block_samples);
+    encoder->input_int32[ch]          = (int32_t *)SLAUtility_AllocateWork(&work_ptr, sizeof(int32_t) * max_num_block_samples);
+    encoder->parcor_coef_code[ch]     = (int32_t *)SLAUtility_AllocateWork(&work_ptr, sizeof(int32_t) * (config->max_parcor_order + 1));
+    encoder->residual[ch]             = (int32_t *)SLAUtility_AllocateWork(&work_ptr, sizeof(int32_t) * max_num_block_samples);
+    encoder->tmp_residual[ch]         = (int32_t *)SLAUtility_AllocateWork(&work_ptr, sizeof(int32_t) * max_num_block_samples);
+    encoder->parcor_coef[ch]          = (double *)SLAUtility_AllocateWork(&work_ptr, sizeof(double) * (config->max_parcor_order + 1));
+    encoder->parcor_coef_int32[ch]    = (int32_t *)SLAUtility_AllocateWork(&work_ptr, sizeof(int32_t) * (config->max_parcor_order + 1));
+    encoder->longterm_coef[ch]        = (double *)SLAUtility_AllocateWork(&work_ptr, sizeof(double) * config->max_longterm_order);
+    encoder->longterm_coef_int32[ch]  = (int32_t *)SLAUtility_AllocateWork(&work_ptr, sizeof(int32_t) * config->max_longterm_order);
   }
 
-  encoder->pitch_period                 = (uint32_t *)malloc(sizeof(uint32_t) * max_num_channels);
-  encoder->window                       = (double *)malloc(sizeof(double) * max_num_block_samples);
-  encoder->num_block_partition_samples  = (uint32_t *)malloc(sizeof(uint32_t) * SLAOptimalEncodeEstimator_CalculateMaxNumPartitions(config->max_num_block_samples, SLA_SEARCH_BLOCK_NUM_SAMPLES_DELTA));
+  encoder->pitch_period                 = (uint32_t *)SLAUtility_AllocateWork(&work_ptr, sizeof(uint32_t) * max_num_channels);
+  encoder->channel_data                 = (const void **)SLAUtility_AllocateWork(&work_ptr, sizeof(void *) * max_num_channels);
+  encoder->raw_data_bits                = (uint32_t *)SLAUtility_AllocateWork(&work_ptr, sizeof(uint32_t) * max_num_channels);
+  encoder->window                       = (double *)SLAUtility_AllocateWork(&work_ptr, sizeof(double) * max_num_block_samples);
+  encoder->num_block_partition_samples  = (uint32_t *)SLAUtility_AllocateWork(&work_ptr, sizeof(uint32_t) * SLAOptimalEncodeEstimator_CalculateMaxNumPartitions(SLA_GET_SEARCH_BLOCK_WORK_NUM_SAMPLES(config->max_num_block_samples), SLA_SEARCH_BLOCK_NUM_SAMPLES_DELTA));
 
   /* ハンドル領域作成 */
-  encoder->coder  = SLACoder_Create(config->max_num_channels, SLACODER_NUM_RECURSIVERICE_PARAMETER);
-  encoder->lpcc   = SLALPCCalculator_Create(config->max_parcor_order);
-  encoder->ltc    = SLALongTermCalculator_Create(SLAUTILITY_ROUNDUP2POWERED(config->max_num_block_samples * 2), SLALONGTERM_MAX_PERIOD, SLALONGTERM_NUM_PITCH_CANDIDATES, config->max_longterm_order);
-  encoder->oee    = SLAOptimalEncodeEstimator_Create(config->max_num_block_samples, SLA_SEARCH_BLOCK_NUM_SAMPLES_DELTA);
-
-  encoder->lpcs     = (struct SLALPCSynthesizer **)malloc(sizeof(struct SLALPCSynthesizer *) * max_num_channels);
-  encoder->ltms     = (struct SLALongTermSynthesizer **)malloc(sizeof(struct SLALongTermSynthesizer *) * max_num_channels);
-  encoder->nlmsc    = (struct SLALMSFilter **)malloc(sizeof(struct SLALMSFilter *) * max_num_channels);
-  encoder->emp      = (struct SLAEmphasisFilter **)malloc(sizeof(struct SLAEmphasisFilter *) * max_num_channels);
+  tmp_work_size   = SLACoder_CalculateWorkSize(config->max_num_channels, SLACODER_NUM_RECURSIVERICE_PARAMETER);
+  encoder->coder  = SLACoder_CreateWithWork(config->max_num_channels, SLACODER_NUM_RECURSIVERICE_PARAMETER,
+      SLAUtility_AllocateWork(&work_ptr, (size_t)tmp_work_size), tmp_work_size);
+  tmp_work_size   = SLALPCCalculator_CalculateWorkSize(config->max_parcor_order);
+  encoder->lpcc   = SLALPCCalculator_CreateWithWork(config->max_parcor_order,
+      SLAUtility_AllocateWork(&work_ptr, (size_t)tmp_work_size), tmp_work_size);
+  tmp_work_size   = SLALongTermCalculator_CalculateWorkSize(SLAUTILITY_ROUNDUP2POWERED(config->max_num_block_samples * 2), SLALONGTERM_MAX_PERIOD, SLALONGTERM_NUM_PITCH_CANDIDATES, config->max_longterm_order);
+  encoder->ltc    = SLALongTermCalculator_CreateWithWork(SLAUTILITY_ROUNDUP2POWERED(config->max_num_block_samples * 2), SLALONGTERM_MAX_PERIOD, SLALONGTERM_NUM_PITCH_CANDIDATES, config->max_longterm_order,
+      SLAUtility_AllocateWork(&work_ptr, (size_t)tmp_work_size), tmp_work_size);
+  encoder->oee    = NULL;
+  if ((tmp_work_size = SLAOptimalEncodeEstimator_CalculateWorkSize(SLA_GET_SEARCH_BLOCK_WORK_NUM_SAMPLES(config->max_num_block_samples), SLA_SEARCH_BLOCK_NUM_SAMPLES_DELTA)) >= 0) {
+    encoder->oee  = SLAOptimalEncodeEstimator_CreateWithWork(SLA_GET_SEARCH_BLOCK_WORK_NUM_SAMPLES(config->max_num_block_samples), SLA_SEARCH_BLOCK_NUM_SAMPLES_DELTA,
+        SLAUtility_AllocateWork(&work_ptr, (size_t)tmp_work_size), tmp_work_size);
+  }
+
+  encoder->lpcs     = (struct SLALPCSynthesizer **)SLAUtility_AllocateWork(&work_ptr, sizeof(struct SLALPCSynthesizer *) * max_num_channels);
+  encoder->ltms     = (struct SLALongTermSynthesizer **)SLAUtility_AllocateWork(&work_ptr, sizeof(struct SLALongTermSynthesizer *) * max_num_channels);
+  encoder->nlmsc    = (struct SLALMSFilter **)SLAUtility_AllocateWork(&work_ptr, sizeof(struct SLALMSFilter *) * max_num_channels);
+  encoder->emp      = (struct SLAEmphasisFilter **)SLAUtility_AllocateWork(&work_ptr, sizeof(struct SLAEmphasisFilter *) * max_num_channels);
   for (ch = 0; ch < max_num_channels; ch++) {
-    encoder->lpcs[ch]   = SLALPCSynthesizer_Create(config->max_parcor_order);
-    encoder->ltms[ch]   = SLALongTermSynthesizer_Create(config->max_longterm_order, SLALONGTERM_MAX_PERIOD);
-    encoder->nlmsc[ch]  = SLALMSFilter_Create(config->max_lms_order_per_filter);
-    encoder->emp[ch]    = SLAEmphasisFilter_Create();
+    tmp_work_size       = SLALPCSynthesizer_CalculateWorkSize(config->max_parcor_order);
+    encoder->lpcs[ch]   = SLALPCSynthesizer_CreateWithWork(config->max_parcor_order,
+        SLAUtility_AllocateWork(&work_ptr, (size_t)tmp_work_size), tmp_work_size);
+    tmp_work_size       = SLALongTermSynthesizer_CalculateWorkSize(config->max_longterm_order, SLALONGTERM_MAX_PERIOD);
+    encoder->ltms[ch]   = SLALongTermSynthesizer_CreateWithWork(config->max_longterm_order, SLALONGTERM_MAX_PERIOD,
+        SLAUtility_AllocateWork(&work_ptr, (size_t)tmp_work_size), tmp_work_size);
+    tmp_work_size       = SLALMSFilter_CalculateWorkSize(config->max_lms_order_per_filter);
+    encoder->nlmsc[ch]  = SLALMSFilter_CreateWithWork(config->max_lms_order_per_filter,
+        SLAUtility_AllocateWork(&work_ptr, (size_t)tmp_work_size), tmp_work_size);
+    tmp_work_size       = SLAEmphasisFilter_CalculateWorkSize();
+    encoder->emp[ch]    = SLAEmphasisFilter_CreateWithWork(
+        SLAUtility_AllocateWork(&work_ptr, (size_t)tmp_work_size), tmp_work_size);
   }
 
+  SLA_Assert((work_ptr - (uint8_t *)work) <= work_size);
+
   /* ステータスフラグをすべて落とす */
   encoder->status_flag = 0;
+
+#ifdef SLA_ENABLE_STATISTICS
+  /* 統計情報のクリアとヒストグラム記録先の設定 */
+  memset(&encoder->statistics, 0, sizeof(struct SLAStatistics));
+  SLACoder_SetRiceParameterHistogram(encoder->coder, encoder->statistics.rice_parameter_histogram);
+#endif
   
   return encoder;
 }
 
+/* エンコーダハンドルの作成 */
+struct SLAEncoder* SLAEncoder_Create(const struct SLAEncoderConfig* config)
+{
+  int32_t work_size;
+  void* work;
+  struct SLAEncoder* encoder;
+
+  if ((work_size = SLAEncoder_CalculateWorkSize(config)) < 0) {
+    return NULL;
+  }
+
+  work = malloc((size_t)work_size);
+  if ((encoder = SLAEncoder_CreateWithWork(config, work, work_size)) == NULL) {
+    NULLCHECK_AND_FREE(work);
+    return NULL;
+  }
+  encoder->alloced_by_own = 1;
+
+  return encoder;
+}
+
 /* エンコーダハンドルの破棄 */
+/* 補足）内部ハンドルも含めて全てワーク領域上にあるため、ワーク領域の解放のみ行う */
 void SLAEncoder_Destroy(struct SLAEncoder* encoder)
 {
-  uint32_t ch;
-
-  if (encoder != NULL) {
-    for (ch = 0; ch < encoder->max_num_channels; ch++) {
-      NULLCHECK_AND_FREE(encoder->input_double[ch]);
-      NULLCHECK_AND_FREE(encoder->input_int32[ch]);
-      NULLCHECK_AND_FREE(encoder->residual[ch]);
-      NULLCHECK_AND_FREE(encoder->tmp_residual[ch]);
-      NULLCHECK_AND_FREE(encoder->parcor_coef[ch]);
-      NULLCHECK_AND_FREE(encoder->parcor_coef_int32[ch]);
-      NULLCHECK_AND_FREE(encoder->parcor_coef_code[ch]);
-      NULLCHECK_AND_FREE(encoder->longterm_coef[ch]);
-      NULLCHECK_AND_FREE(encoder->longterm_coef_int32[ch]);
-    }
-    NULLCHECK_AND_FREE(encoder->input_double);
-    NULLCHECK_AND_FREE(encoder->input_int32);
-    NULLCHECK_AND_FREE(encoder->residual);
-    NULLCHECK_AND_FREE(encoder->tmp_residual);
-    NULLCHECK_AND_FREE(encoder->parcor_coef);
-    NULLCHECK_AND_FREE(encoder->parcor_coef_int32);
-    NULLCHECK_AND_FREE(encoder->parcor_coef_code);
-    NULLCHECK_AND_FREE(encoder->longterm_coef);
-    NULLCHECK_AND_FREE(encoder->longterm_coef_int32);
-    NULLCHECK_AND_FREE(encoder->num_block_partition_samples);
-    NULLCHECK_AND_FREE(encoder->parcor_rshift);
-    SLALPCCalculator_Destroy(encoder->lpcc);
-    SLALongTermCalculator_Destroy(encoder->ltc);
-    SLAOptimalEncodeEstimator_Destroy(encoder->oee);
-    for (ch = 0; ch < encoder->max_num_channels; ch++) {
-      SLALPCSynthesizer_Destroy(encoder->lpcs[ch]);
-      SLALongTermSynthesizer_Destroy(encoder->ltms[ch]);
-      SLALMSFilter_Destroy(encoder->nlmsc[ch]);
-      SLAEmphasisFilter_Destroy(encoder->emp[ch]);
-    }
-    SLACoder_Destroy(encoder->coder);
-    NULLCHECK_AND_FREE(encoder->ltms);
-    NULLCHECK_AND_FREE(encoder->nlmsc);
-    NULLCHECK_AND_FREE(encoder->emp);
-    free(encoder);
+  if ((encoder != NULL) && encoder->alloced_by_own) {
+    free(encoder->work);
   }
 }
 
@@ -183,6 +301,7 @@ SLAApiResult SLAEncoder_SetWaveFormat(struct SLAEncoder* encoder,
 
   /* エンコーダの許容範囲か？ */
   if ((wave_format->num_channels > encoder->max_num_channels)
+      || (wave_format->num_channels > SLA_MAX_NUM_CHANNELS)
       || (wave_format->bit_per_sample > 32)) {
     return SLA_APIRESULT_EXCEED_HANDLE_CAPACITY;
   }
@@ -255,7 +374,7 @@ SLAApiResult SLAEncoder_EncodeHeader(
   /* チャンネル数 */
   SLAByteArray_PutUint8(data_pos,  (uint8_t)header->wave_format.num_channels);
   /* サンプル数 */
-  SLAByteArray_PutUint32(data_pos, header->num_samples);
+  SLAByteArray_PutUint64(data_pos, header->num_samples);
   /* サンプリングレート */
   SLAByteArray_PutUint32(data_pos, header->wave_format.sampling_rate);
   /* サンプルあたりbit数 */
@@ -273,7 +392,7 @@ SLAApiResult SLAEncoder_EncodeHeader(
   /* SLAブロック数 */
   SLAByteArray_PutUint32(data_pos, header->num_blocks);
   /* SLAブロックあたりサンプル数 */
-  SLAByteArray_PutUint16(data_pos, (uint16_t)header->encode_param.max_num_block_samples);
+  SLAByteArray_PutUint32(data_pos, header->encode_param.max_num_block_samples);
   /* 最大ブロックサイズ */
   SLAByteArray_PutUint32(data_pos, header->max_block_size);
   /* 最大bps */
@@ -352,9 +471,135 @@ static SLAApiResult SLAEncoder_ApplyChProcessing(struct SLAEncoder* encoder, uin
   return SLA_APIRESULT_OK;
 }
 
+/* PCM入力の内容チェック */
+static SLAApiResult SLAEncoder_CheckPcmInput(
+    const struct SLAPcmInput* input, uint32_t num_channels, uint32_t bit_per_sample)
+{
+  uint32_t ch;
+
+  if ((input == NULL) || (input->channel_data == NULL) || (input->stride == 0)) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  for (ch = 0; ch < num_channels; ch++) {
+    if (input->channel_data[ch] == NULL) {
+      return SLA_APIRESULT_INVALID_ARGUMENT;
+    }
+  }
+
+  /* 型に収まらないビット幅 */
+  switch (input->sample_type) {
+    case SLA_PCM_SAMPLE_TYPE_INT16:
+      if (bit_per_sample > 16) {
+        return SLA_APIRESULT_INVALID_ARGUMENT;
+      }
+      break;
+    case SLA_PCM_SAMPLE_TYPE_PACKED_INT24:
+      if (bit_per_sample > 24) {
+        return SLA_APIRESULT_INVALID_ARGUMENT;
+      }
+      break;
+    case SLA_PCM_SAMPLE_TYPE_INT32:
+    case SLA_PCM_SAMPLE_TYPE_INT32_LEFT_JUSTIFIED:
+      break;
+    default:
+      return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  return SLA_APIRESULT_OK;
+}
+
+/* PCM入力を作業領域に読み込み */
+/* 補足）double化は[-1,1)に正規化、int32化は右詰めの値をさらにrshiftだけ右シフトする
+ *       型変換・デインターリーブ・シフトを1パスで行う */
+static void SLAEncoder_LoadPcmInput(struct SLAEncoder* encoder,
+    const struct SLAPcmInput* input, uint32_t offset, uint32_t num_samples, uint32_t rshift)
+{
+  uint32_t  ch, smpl, stride, bit_per_sample;
+  double    scale;
+  double*   dst_double;
+  int32_t*  dst_int32;
+
+  SLA_Assert(encoder != NULL);
+  SLA_Assert(input != NULL);
+
+  stride          = input->stride;
+  bit_per_sample  = encoder->wave_format.bit_per_sample;
+  SLA_Assert(rshift < bit_per_sample);
+
+  /* 右詰めの値の正規化係数 */
+  scale = pow(2, 1.0 - bit_per_sample);
+
+  for (ch = 0; ch < encoder->wave_format.num_channels; ch++) {
+    dst_double  = encoder->input_double[ch];
+    dst_int32   = encoder->input_int32[ch];
+    switch (input->sample_type) {
+      case SLA_PCM_SAMPLE_TYPE_INT16:
+        {
+          const int16_t* src = (const int16_t *)input->channel_data[ch] + (size_t)offset * stride;
+          for (smpl = 0; smpl < num_samples; smpl++) {
+            int32_t val = src[(size_t)smpl * stride];
+            dst_double[smpl]  = (double)val * scale;
+            dst_int32[smpl]   = (int32_t)SLAUTILITY_SHIFT_RIGHT_ARITHMETIC(val, rshift);
+          }
+        }
+        break;
+      case SLA_PCM_SAMPLE_TYPE_PACKED_INT24:
+        {
+          const uint8_t* src = (const uint8_t *)input->channel_data[ch] + (size_t)offset * stride * 3;
+          for (smpl = 0; smpl < num_samples; smpl++) {
+            int32_t val = SLAENCODER_GET_PACKED_INT24(&src[(size_t)smpl * stride * 3]);
+            dst_double[smpl]  = (double)val * scale;
+            dst_int32[smpl]   = (int32_t)SLAUTILITY_SHIFT_RIGHT_ARITHMETIC(val, rshift);
+          }
+        }
+        break;
+      case SLA_PCM_SAMPLE_TYPE_INT32:
+        {
+          const int32_t* src = (const int32_t *)input->channel_data[ch] + (size_t)offset * stride;
+          for (smpl = 0; smpl < num_samples; smpl++) {
+            int32_t val = src[(size_t)smpl * stride];
+            dst_double[smpl]  = (double)val * scale;
+            dst_int32[smpl]   = (int32_t)SLAUTILITY_SHIFT_RIGHT_ARITHMETIC(val, rshift);
+          }
+        }
+        break;
+      case SLA_PCM_SAMPLE_TYPE_INT32_LEFT_JUSTIFIED:
+        {
+          const int32_t* src = (const int32_t *)input->channel_data[ch] + (size_t)offset * stride;
+          const uint32_t lj_rshift = 32 - bit_per_sample + rshift;
+          for (smpl = 0; smpl < num_samples; smpl++) {
+            int32_t val = src[(size_t)smpl * stride];
+            dst_double[smpl]  = (double)val * pow(2, -31);
+            dst_int32[smpl]   = (int32_t)SLAUTILITY_SHIFT_RIGHT_ARITHMETIC(val, lj_rshift);
+          }
+        }
+        break;
+      default:
+        SLA_Assert(0);
+    }
+  }
+}
+
+/* チャンネル毎の32bit左詰め入力をPCM入力として参照 */
+static void SLAEncoder_SetLeftJustifiedPcmInput(struct SLAEncoder* encoder,
+    const int32_t* const* input, struct SLAPcmInput* pcm_input)
+{
+  uint32_t ch;
+
+  SLA_Assert(encoder->wave_format.num_channels <= encoder->max_num_channels);
+
+  for (ch = 0; ch < encoder->wave_format.num_channels; ch++) {
+    encoder->channel_data[ch] = input[ch];
+  }
+  pcm_input->sample_type  = SLA_PCM_SAMPLE_TYPE_INT32_LEFT_JUSTIFIED;
+  pcm_input->channel_data = encoder->channel_data;
+  pcm_input->stride       = 1;
+}
+
 /* 最適なブロック分割の探索 */
 static SLAApiResult SLAEncoder_SearchOptimalBlockPartitions(struct SLAEncoder* encoder,
-    const int32_t* const* input, uint32_t num_samples,
+    const struct SLAPcmInput* input, uint32_t offset, uint32_t num_samples,
     uint32_t min_num_block_samples, uint32_t delta_num_samples, uint32_t max_num_block_samples,
     uint32_t *optimal_num_partitions, uint32_t *optimal_num_block_samples)
 {
@@ -378,12 +623,7 @@ static SLAApiResult SLAEncoder_SearchOptimalBlockPartitions(struct SLAEncoder* e
   parcor_order  = encoder->encode_param.parcor_order;
 
   /* データを設定 */
-  for (ch = 0; ch < num_channels; ch++) {
-    for (smpl = 0; smpl < num_samples; smpl++) {
-      encoder->input_double[ch][smpl] = (double)input[ch][smpl] * pow(2, -31);
-      encoder->input_int32[ch][smpl]  = input[ch][smpl] >> (32 - encoder->wave_format.bit_per_sample);
-    }
-  }
+  SLAEncoder_LoadPcmInput(encoder, input, offset, num_samples, 0);
   /* チャンネル毎の処理実行 */
   if ((api_ret = SLAEncoder_ApplyChProcessing(encoder, max_num_block_samples)) != SLA_APIRESULT_OK) {
     return api_ret;
@@ -421,37 +661,85 @@ DETECT_NOT_SILENCE:
   return SLA_APIRESULT_OK;
 }
 
-/* オフセット分の左シフト量を計算 */
-static uint32_t SLAEncoder_CalculateLeftShiftOffset(
-    struct SLAEncoder* encoder, const int32_t* const* input, uint32_t num_samples)
+/* 入力全体のビットパターン（全サンプルのビットOR）からオフセット分の左シフト量を計算 */
+uint8_t SLAEncoder_CalculateLeftShiftOffsetFromBitMask(uint32_t bit_per_sample, uint32_t bit_mask)
 {
-  uint32_t ch, smpl, minabs_bits;
-  uint32_t mask = 0;
-
-  SLA_Assert(encoder != NULL);
-  SLA_Assert(input != NULL);
-
-  /* 使用されているビットを検査 */
-  for (ch = 0; ch < encoder->wave_format.num_channels; ch++) {
-    for (smpl = 0; smpl < num_samples; smpl++) {
-      mask |= (uint32_t)input[ch][smpl];
-    }
-  }
+  uint32_t minabs_bits;
 
   /* 全入力が0 */
-  if (mask == 0) {
+  if (bit_mask == 0) {
     return 0;
   }
 
   /* ntz（末尾へ続く0の個数）を計算
    * ntz(x) = 32 - nlz(~x & (x-1)), nlz(x) = 31 - log2ceil(x)を使用 */
-  minabs_bits = 1 + SLAUTILITY_LOG2FLOOR(~mask & (mask - 1));
+  minabs_bits = 1 + SLAUTILITY_LOG2FLOOR(~bit_mask & (bit_mask - 1));
   SLA_Assert(minabs_bits <= 31);
 
   /* (32-minabs_bits)はダイナミックレンジbitを示す */
   /* 元のビット幅から引くことで元の左シフト量が求まる */
-  SLA_Assert(encoder->wave_format.bit_per_sample >= (32 - minabs_bits));
-  return encoder->wave_format.bit_per_sample - (32 - minabs_bits);
+  SLA_Assert(bit_per_sample >= (32 - minabs_bits));
+  return (uint8_t)(bit_per_sample - (32 - minabs_bits));
+}
+
+/* PCM入力のビットパターンを累積 */
+SLAApiResult SLAEncoder_AccumulatePcmBitMask(const struct SLAPcmInput* input,
+    uint32_t num_channels, uint32_t bit_per_sample, uint32_t num_samples, uint32_t* bit_mask)
+{
+  uint32_t      ch, smpl, stride;
+  uint32_t      mask = 0;
+  SLAApiResult  api_ret;
+
+  /* 引数チェック */
+  if ((bit_mask == NULL) || (bit_per_sample == 0) || (bit_per_sample > 32)) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+  if ((api_ret = SLAEncoder_CheckPcmInput(input, num_channels, bit_per_sample)) != SLA_APIRESULT_OK) {
+    return api_ret;
+  }
+
+  /* 使用されているビットを検査 */
+  stride = input->stride;
+  for (ch = 0; ch < num_channels; ch++) {
+    switch (input->sample_type) {
+      case SLA_PCM_SAMPLE_TYPE_INT16:
+        {
+          const int16_t* src = (const int16_t *)input->channel_data[ch];
+          for (smpl = 0; smpl < num_samples; smpl++) {
+            int32_t val = src[(size_t)smpl * stride];
+            mask |= (uint32_t)val;
+          }
+        }
+        break;
+      case SLA_PCM_SAMPLE_TYPE_PACKED_INT24:
+        {
+          const uint8_t* src = (const uint8_t *)input->channel_data[ch];
+          for (smpl = 0; smpl < num_samples; smpl++) {
+            mask |= (uint32_t)SLAENCODER_GET_PACKED_INT24(&src[(size_t)smpl * stride * 3]);
+          }
+        }
+        break;
+      case SLA_PCM_SAMPLE_TYPE_INT32:
+      case SLA_PCM_SAMPLE_TYPE_INT32_LEFT_JUSTIFIED:
+        {
+          const int32_t* src = (const int32_t *)input->channel_data[ch];
+          for (smpl = 0; smpl < num_samples; smpl++) {
+            mask |= (uint32_t)src[(size_t)smpl * stride];
+          }
+        }
+        break;
+      default:
+        SLA_Assert(0);
+    }
+  }
+
+  /* 32bit左詰めに換算 */
+  if (input->sample_type != SLA_PCM_SAMPLE_TYPE_INT32_LEFT_JUSTIFIED) {
+    mask <<= (32 - bit_per_sample);
+  }
+
+  *bit_mask |= mask;
+  return SLA_APIRESULT_OK;
 }
 
 /* 1ブロックエンコード */
@@ -459,13 +747,7 @@ SLAApiResult SLAEncoder_EncodeBlock(struct SLAEncoder* encoder,
     const int32_t* const* input, uint32_t num_samples,
     uint8_t* data, uint32_t data_size, uint32_t* output_size)
 {
-  uint32_t              ch, smpl, ord;
-  uint32_t              num_channels, parcor_order, longterm_order;
-  uint32_t              bitwidth;
-  uint16_t              crc16;
-  double                estimated_code_length;
-  SLAPredictorApiResult predictor_ret;
-  SLAApiResult          api_ret;
+  struct SLAPcmInput  pcm_input;
 
   /* 引数チェック */
   if (encoder == NULL || input == NULL
@@ -479,6 +761,28 @@ SLAApiResult SLAEncoder_EncodeBlock(struct SLAEncoder* encoder,
     return SLA_APIRESULT_PARAMETER_NOT_SET;
   }
 
+  SLAEncoder_SetLeftJustifiedPcmInput(encoder, input, &pcm_input);
+  return SLAEncoder_EncodeBlockPcm(encoder, &pcm_input, num_samples, data, data_size, output_size);
+}
+
+/* 入力のoffsetサンプル目から1ブロックエンコード */
+static SLAApiResult SLAEncoder_EncodeBlockAt(struct SLAEncoder* encoder,
+    const struct SLAPcmInput* input, uint32_t offset, uint32_t num_samples,
+    uint8_t* data, uint32_t data_size, uint32_t* output_size)
+{
+  uint32_t              ch, smpl, ord;
+  uint32_t              num_channels, parcor_order, longterm_order;
+  uint32_t              bitwidth, block_header_size;
+  uint16_t              crc16;
+  double                estimated_code_length;
+  SLAPredictorApiResult predictor_ret;
+  SLAApiResult          api_ret;
+
+  SLA_Assert(encoder != NULL);
+  SLA_Assert(input != NULL);
+  SLA_Assert(data != NULL);
+  SLA_Assert(output_size != NULL);
+
   /* 許容サンプル数を超えている */
   if (num_samples > encoder->max_num_block_samples) {
     return SLA_APIRESULT_EXCEED_HANDLE_CAPACITY;
@@ -502,14 +806,7 @@ SLAApiResult SLAEncoder_EncodeBlock(struct SLAEncoder* encoder,
   /* 入力をdouble化/情報が失われない程度に右シフト */
   SLA_Assert(encoder->wave_format.bit_per_sample > encoder->wave_format.offset_lshift);
   SLA_Assert((encoder->wave_format.bit_per_sample - encoder->wave_format.offset_lshift) < 32);
-  for (ch = 0; ch < num_channels; ch++) {
-    for (smpl = 0; smpl < num_samples; smpl++) {
-      encoder->input_double[ch][smpl] = (double)input[ch][smpl] * pow(2, -31);
-      encoder->input_int32[ch][smpl]  
-        = SLAUTILITY_SHIFT_RIGHT_ARITHMETIC(input[ch][smpl], 
-            32 - encoder->wave_format.bit_per_sample + encoder->wave_format.offset_lshift);
-    }
-  }
+  SLAEncoder_LoadPcmInput(encoder, input, offset, num_samples, encoder->wave_format.offset_lshift);
 
   /* チャンネル毎の処理 */
   if ((api_ret = SLAEncoder_ApplyChProcessing(encoder, num_samples)) != SLA_APIRESULT_OK) {
@@ -535,6 +832,8 @@ SLAApiResult SLAEncoder_EncodeBlock(struct SLAEncoder* encoder,
       continue;
     }
 
+    SLA_STATISTICS_START_STAGE(encoder);
+
     /* 窓掛け */
     /* 補足）窓掛けとプリエンファシスはほぼ順不同だが、先に窓をかけたほうが僅かに性能が良い */
     SLAUtility_ApplyWindow(encoder->window, encoder->input_double[ch], num_samples); 
@@ -561,6 +860,7 @@ SLAApiResult SLAEncoder_EncodeBlock(struct SLAEncoder* encoder,
     /* 推定圧縮率が閾値以上ならば、予測を諦めて生データ出力を行う */
     if (estimated_code_length >= SLA_ESTIMATE_CODELENGTH_THRESHOLD) {
       encoder->block_data_type = SLA_BLOCK_DATA_TYPE_RAWDATA;
+      SLA_STATISTICS_END_STAGE(encoder, SLA_STATISTICS_STAGE_LPC);
       break;
     }
 
@@ -615,6 +915,8 @@ SLAApiResult SLAEncoder_EncodeBlock(struct SLAEncoder* encoder,
     }
     /* 残差をPARCOR予測による残差に差し替え */
     memcpy(encoder->residual[ch], encoder->tmp_residual[ch], sizeof(int32_t) * num_samples);
+    SLA_STATISTICS_END_STAGE(encoder, SLA_STATISTICS_STAGE_LPC);
+    SLA_STATISTICS_START_STAGE(encoder);
 
     /* 残差信号に対してロングターム係数計算 */
     predictor_ret = SLALongTermCalculator_CalculateCoef(encoder->ltc,
@@ -654,6 +956,8 @@ SLAApiResult SLAEncoder_EncodeBlock(struct SLAEncoder* encoder,
       /* 残差をロングタームによる残差に差し替え */
       memcpy(encoder->residual[ch], encoder->tmp_residual[ch], sizeof(int32_t) * num_samples);
     }
+    SLA_STATISTICS_END_STAGE(encoder, SLA_STATISTICS_STAGE_LONGTERM);
+    SLA_STATISTICS_START_STAGE(encoder);
 
     /* LMSで残差計算 */
     if (SLALMSFilter_Reset(encoder->nlmsc[ch]) != SLAPREDICTOR_APIRESULT_OK) {
@@ -668,9 +972,11 @@ SLAApiResult SLAEncoder_EncodeBlock(struct SLAEncoder* encoder,
     } else {
       return SLA_APIRESULT_FAILED_TO_PREDICT;
     }
-
+    SLA_STATISTICS_END_STAGE(encoder, SLA_STATISTICS_STAGE_LMS);
   }
 
+  SLA_STATISTICS_START_STAGE(encoder);
+
   /* 初期パラメータの計算 */
   SLACoder_CalculateInitialRecursiveRiceParameter(encoder->coder, 
       SLACODER_NUM_RECURSIVERICE_PARAMETER, 
@@ -689,8 +995,13 @@ SLAApiResult SLAEncoder_EncodeBlock(struct SLAEncoder* encoder,
   SLABitWriter_PutBits(&encoder->strm, 0, 32);
   /* CRC16:一旦飛ばす（後で計算するため、領域だけ確保） */
   SLABitWriter_PutBits(&encoder->strm, 0, 16);
-  /* ブロックのサンプル数 */
-  SLABitWriter_PutBits(&encoder->strm, num_samples, 16);
+  /* ブロックのサンプル数: 16bitに収まらなければエスケープ値に続けて32bitで記録 */
+  if (num_samples > SLA_BLOCK_NUM_SAMPLES_16BIT_MAX) {
+    SLABitWriter_PutBits(&encoder->strm, SLA_BLOCK_NUM_SAMPLES_ESCAPE, 16);
+    SLABitWriter_PutBits(&encoder->strm, num_samples, 32);
+  } else {
+    SLABitWriter_PutBits(&encoder->strm, num_samples, 16);
+  }
   /* ブロックデータタイプ */
   SLABitWriter_PutBits(&encoder->strm, encoder->block_data_type, 2);
 
@@ -736,12 +1047,15 @@ SLAApiResult SLAEncoder_EncodeBlock(struct SLAEncoder* encoder,
   /* ここまでがブロックヘッダ. バイト境界に揃える */
   SLABitStream_Flush(&encoder->strm);
 
+  /* ブロックヘッダサイズの取得 */
+  SLABitStream_Tell(&encoder->strm, (int32_t *)&block_header_size);
+
   /* データ符号化 */
   switch (encoder->block_data_type) {
     case SLA_BLOCK_DATA_TYPE_RAWDATA:
       /* 圧縮を断念している。生データを符号なし整数化して書き出す */
       {
-        uint32_t output_bits[SLA_MAX_CHANNELS];
+        uint32_t* output_bits = encoder->raw_data_bits;
         /* ビット幅を設定 */
         for (ch = 0; ch < num_channels; ch++) {
           /* 左シフトしている場合があるのでその分は書き出しビット幅を減らす */
@@ -783,11 +1097,16 @@ SLAApiResult SLAEncoder_EncodeBlock(struct SLAEncoder* encoder,
   /* 出力サイズの取得 */
   SLABitStream_Tell(&encoder->strm, (int32_t *)output_size);
 
+  SLA_STATISTICS_END_STAGE(encoder, SLA_STATISTICS_STAGE_ENTROPY_CODING);
+  SLA_STATISTICS_START_STAGE(encoder);
+
   /* ブロックCRC16計算 */
   crc16 = SLAUtility_CalculateCRC16(
       &data[SLA_BLOCK_CRC16_CALC_START_OFFSET],
       (*output_size) - SLA_BLOCK_CRC16_CALC_START_OFFSET);
 
+  SLA_STATISTICS_END_STAGE(encoder, SLA_STATISTICS_STAGE_CRC);
+
   /* オフセット / CRC16値の書き込み */
   SLABitStream_Seek(&encoder->strm, 
       SLA_BLOCK_CRC16_CALC_START_OFFSET - 2 - 4, SLABITSTREAM_SEEK_SET);  /* オフセットの書き込み位置に移動 */
@@ -797,28 +1116,198 @@ SLAApiResult SLAEncoder_EncodeBlock(struct SLAEncoder* encoder,
   /* ビットストリーム破棄 */
   SLABitStream_Close(&encoder->strm);
 
+  /* 統計情報の記録 */
+  SLA_STATISTICS_COUNT_BLOCK(encoder, encoder->block_data_type, num_samples, block_header_size, *output_size);
+
   return SLA_APIRESULT_OK;
 }
 
-/* ヘッダを含めて全ブロックエンコード */
-SLAApiResult SLAEncoder_EncodeWhole(struct SLAEncoder* encoder,
-    const int32_t* const* input, uint32_t num_samples,
+/* 1ブロックエンコード（PCM入力） */
+SLAApiResult SLAEncoder_EncodeBlockPcm(struct SLAEncoder* encoder,
+    const struct SLAPcmInput* input, uint32_t num_samples,
     uint8_t* data, uint32_t data_size, uint32_t* output_size)
 {
-  uint32_t              ch, part;
+  SLAApiResult api_ret;
+
+  /* 引数チェック */
+  if (encoder == NULL || input == NULL
+      || data == NULL || output_size == NULL) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  /* エンコードに必要なパラメータがセットされていない */
+  if ((!(encoder->status_flag & SLAENCODER_STATUS_FLAG_SET_WAVE_FORMAT))
+      || (!(encoder->status_flag & SLAENCODER_STATUS_FLAG_SET_ENCODE_PARAMETER))) {
+    return SLA_APIRESULT_PARAMETER_NOT_SET;
+  }
+
+  /* 入力の内容チェック */
+  if ((api_ret = SLAEncoder_CheckPcmInput(input,
+          encoder->wave_format.num_channels, encoder->wave_format.bit_per_sample)) != SLA_APIRESULT_OK) {
+    return api_ret;
+  }
+
+  return SLAEncoder_EncodeBlockAt(encoder, input, 0, num_samples, data, data_size, output_size);
+}
+
+/* 入力のoffsetサンプル目から最適なブロック分割を探索してエンコード */
+static SLAApiResult SLAEncoder_EncodePartitionedBlocksAt(struct SLAEncoder* encoder,
+    const struct SLAPcmInput* input, uint32_t offset, uint32_t num_samples,
+    uint8_t* data, uint32_t data_size, uint32_t* output_size, struct SLAHeaderInfo* header)
+{
+  uint32_t              part;
   uint32_t              num_partitions;
-  uint32_t              encode_offset_sample, num_remain_samples;
-  uint32_t              cur_output_size, block_size, max_block_size, num_blocks;
-  const int32_t*        input_ptr[SLA_MAX_CHANNELS];
+  uint32_t              encode_offset_sample, cur_output_size, block_size;
+  SLAApiResult          api_ret;
+
+  SLA_Assert(encoder != NULL);
+  SLA_Assert(input != NULL);
+  SLA_Assert(data != NULL);
+  SLA_Assert(output_size != NULL);
+  SLA_Assert(header != NULL);
+
+  /* 最適なブロック分割の探索 */
+  SLA_STATISTICS_START_STAGE(encoder);
+  if ((api_ret = SLAEncoder_SearchOptimalBlockPartitions(encoder,
+          input, offset, num_samples,
+          (uint32_t)SLAUTILITY_MIN(SLA_MIN_BLOCK_NUM_SAMPLES, num_samples),
+          SLA_GET_SEARCH_BLOCK_NUM_SAMPLES_DELTA(num_samples),
+          num_samples,
+          &num_partitions, encoder->num_block_partition_samples)) != SLA_APIRESULT_OK) {
+    return api_ret;
+  }
+  SLA_STATISTICS_END_STAGE(encoder, SLA_STATISTICS_STAGE_PARTITION_SEARCH);
+
+  /* 分割に従ってエンコード */
+  cur_output_size = 0;
+  encode_offset_sample = offset;
+  for (part = 0; part < num_partitions; part++) {
+    uint32_t  block_bit_per_second;
+    uint32_t  num_encode_samples = encoder->num_block_partition_samples[part];
+    /* 出力バッファサイズが足らない */
+    if (cur_output_size >= data_size) {
+      return SLA_APIRESULT_INSUFFICIENT_BUFFER_SIZE;
+    }
+    /* ブロックエンコード */
+    if ((api_ret = SLAEncoder_EncodeBlockAt(encoder,
+            input, encode_offset_sample, num_encode_samples,
+            &data[cur_output_size], data_size - cur_output_size,
+            &block_size)) != SLA_APIRESULT_OK) {
+      return api_ret;
+    }
+    /* 出力データサイズの更新 */
+    cur_output_size += block_size;
+    /* エンコードしたサンプル数の更新 */
+    encode_offset_sample += num_encode_samples;
+    /* 最大ブロックサイズの記録 */
+    if (block_size > header->max_block_size) {
+      header->max_block_size = block_size;
+    }
+    /* 最大bpsの計算 */
+    block_bit_per_second = (8 * block_size * encoder->wave_format.sampling_rate) / num_encode_samples;
+    if (block_bit_per_second > header->max_bit_per_second) {
+      header->max_bit_per_second = block_bit_per_second;
+    }
+    /* ブロック数増加 */
+    header->num_blocks++;
+  }
+
+  /* 最終ブロックを書き出したところでオーバーランを検知 */
+  if (cur_output_size > data_size) {
+    return SLA_APIRESULT_INSUFFICIENT_DATA_SIZE;
+  }
+
+  /* 出力サイズの書き込み */
+  *output_size = cur_output_size;
+
+  return SLA_APIRESULT_OK;
+}
+
+/* 最適なブロック分割を探索してエンコード（PCM入力） */
+SLAApiResult SLAEncoder_EncodePartitionedBlocksPcm(struct SLAEncoder* encoder,
+    const struct SLAPcmInput* input, uint32_t num_samples,
+    uint8_t* data, uint32_t data_size, uint32_t* output_size, struct SLAHeaderInfo* header)
+{
+  SLAApiResult api_ret;
+
+  /* 引数チェック */
+  if (encoder == NULL || input == NULL || data == NULL
+      || output_size == NULL || header == NULL) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  /* エンコードに必要なパラメータがセットされていない */
+  if ((!(encoder->status_flag & SLAENCODER_STATUS_FLAG_SET_WAVE_FORMAT))
+      || (!(encoder->status_flag & SLAENCODER_STATUS_FLAG_SET_ENCODE_PARAMETER))) {
+    return SLA_APIRESULT_PARAMETER_NOT_SET;
+  }
+
+  /* 1ブロックに収まらない */
+  if ((num_samples == 0) || (num_samples > encoder->encode_param.max_num_block_samples)) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  /* 入力の内容チェック */
+  if ((api_ret = SLAEncoder_CheckPcmInput(input,
+          encoder->wave_format.num_channels, encoder->wave_format.bit_per_sample)) != SLA_APIRESULT_OK) {
+    return api_ret;
+  }
+
+  return SLAEncoder_EncodePartitionedBlocksAt(encoder,
+      input, 0, num_samples, data, data_size, output_size, header);
+}
+
+/* 最適なブロック分割を探索してエンコード */
+SLAApiResult SLAEncoder_EncodePartitionedBlocks(struct SLAEncoder* encoder,
+    const int32_t* const* input, uint32_t num_samples,
+    uint8_t* data, uint32_t data_size, uint32_t* output_size, struct SLAHeaderInfo* header)
+{
+  struct SLAPcmInput  pcm_input;
+
+  /* 引数チェック */
+  if (encoder == NULL || input == NULL || data == NULL
+      || output_size == NULL || header == NULL) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  /* エンコードに必要なパラメータがセットされていない */
+  if ((!(encoder->status_flag & SLAENCODER_STATUS_FLAG_SET_WAVE_FORMAT))
+      || (!(encoder->status_flag & SLAENCODER_STATUS_FLAG_SET_ENCODE_PARAMETER))) {
+    return SLA_APIRESULT_PARAMETER_NOT_SET;
+  }
+
+  SLAEncoder_SetLeftJustifiedPcmInput(encoder, input, &pcm_input);
+  return SLAEncoder_EncodePartitionedBlocksPcm(encoder,
+      &pcm_input, num_samples, data, data_size, output_size, header);
+}
+
+/* ヘッダを含めて全ブロックエンコード（PCM入力） */
+SLAApiResult SLAEncoder_EncodeWholePcm(struct SLAEncoder* encoder,
+    const struct SLAPcmInput* input, uint32_t num_samples,
+    uint8_t* data, uint32_t data_size, uint32_t* output_size)
+{
+  uint32_t              encode_offset_sample, num_encode_samples;
+  uint32_t              cur_output_size, encoded_size, bit_mask;
   struct SLAHeaderInfo  header;
   SLAApiResult          api_ret;
-  uint32_t              max_bit_per_second;
 
   /* 引数チェック */
   if (encoder == NULL || input == NULL || data == NULL || output_size == NULL) {
     return SLA_APIRESULT_INVALID_ARGUMENT;
   }
 
+  /* エンコードに必要なパラメータがセットされていない */
+  if ((!(encoder->status_flag & SLAENCODER_STATUS_FLAG_SET_WAVE_FORMAT))
+      || (!(encoder->status_flag & SLAENCODER_STATUS_FLAG_SET_ENCODE_PARAMETER))) {
+    return SLA_APIRESULT_PARAMETER_NOT_SET;
+  }
+
+  /* 入力の内容チェック */
+  if ((api_ret = SLAEncoder_CheckPcmInput(input,
+          encoder->wave_format.num_channels, encoder->wave_format.bit_per_sample)) != SLA_APIRESULT_OK) {
+    return api_ret;
+  }
+
   /* ヘッダ情報設定 */
   header.wave_format    = encoder->wave_format;
   header.encode_param   = encoder->encode_param;
@@ -832,73 +1321,39 @@ SLAApiResult SLAEncoder_EncodeWhole(struct SLAEncoder* encoder,
   }
 
   /* オフセット分の左シフト量を解析 */
+  bit_mask = 0;
+  if ((api_ret = SLAEncoder_AccumulatePcmBitMask(input, encoder->wave_format.num_channels,
+          encoder->wave_format.bit_per_sample, num_samples, &bit_mask)) != SLA_APIRESULT_OK) {
+    return api_ret;
+  }
   header.wave_format.offset_lshift
     = encoder->wave_format.offset_lshift
-    = (uint8_t)SLAEncoder_CalculateLeftShiftOffset(encoder, input, num_samples);
+    = SLAEncoder_CalculateLeftShiftOffsetFromBitMask(encoder->wave_format.bit_per_sample, bit_mask);
   SLA_Assert(encoder->wave_format.bit_per_sample > encoder->wave_format.offset_lshift);
 
   /* 全ブロックを逐次エンコード */
   cur_output_size = SLA_HEADER_SIZE;
-  max_block_size = 0;
   encode_offset_sample = 0;
-  num_blocks = 0;
-  max_bit_per_second = 0;
+  header.num_blocks         = 0;
+  header.max_block_size     = 0;
+  header.max_bit_per_second = 0;
   while (encode_offset_sample < num_samples) {
     /* 出力バッファサイズが足らない */
     if (cur_output_size >= data_size) {
       return SLA_APIRESULT_INSUFFICIENT_BUFFER_SIZE;
     }
 
-    /* 入力信号のポインタをセット */
-    for (ch = 0; ch < encoder->wave_format.num_channels; ch++) {
-      input_ptr[ch] = &input[ch][encode_offset_sample];
-    }
-
-    /* 残りサンプル */
-    num_remain_samples = num_samples - encode_offset_sample;
-
-    /* 最適なブロック分割の探索 */
-    if ((api_ret = SLAEncoder_SearchOptimalBlockPartitions(encoder,
-            input_ptr,
-            SLAUTILITY_MIN(encoder->encode_param.max_num_block_samples, num_remain_samples),
-            (uint32_t)SLAUTILITY_MIN(SLA_MIN_BLOCK_NUM_SAMPLES, num_remain_samples),
-            SLA_SEARCH_BLOCK_NUM_SAMPLES_DELTA,
-            SLAUTILITY_MIN(encoder->encode_param.max_num_block_samples, num_remain_samples),
-            &num_partitions, encoder->num_block_partition_samples)) != SLA_APIRESULT_OK) {
+    /* 最大ブロックサンプル数ずつ分割を探索してエンコード */
+    num_encode_samples
+      = SLAUTILITY_MIN(encoder->encode_param.max_num_block_samples, num_samples - encode_offset_sample);
+    if ((api_ret = SLAEncoder_EncodePartitionedBlocksAt(encoder,
+            input, encode_offset_sample, num_encode_samples,
+            &data[cur_output_size], data_size - cur_output_size,
+            &encoded_size, &header)) != SLA_APIRESULT_OK) {
       return api_ret;
     }
-
-    /* 分割に従ってエンコード */
-    for (part = 0; part < num_partitions; part++) {
-      uint32_t  block_bit_per_second;
-      uint32_t  num_encode_samples = encoder->num_block_partition_samples[part];
-      /* 入力信号のポインタをセット */
-      for (ch = 0; ch < encoder->wave_format.num_channels; ch++) {
-        input_ptr[ch] = &input[ch][encode_offset_sample];
-      }
-      /* ブロックエンコード */
-      if ((api_ret = SLAEncoder_EncodeBlock(encoder,
-              input_ptr, num_encode_samples,
-              &data[cur_output_size], data_size - cur_output_size,
-              &block_size)) != SLA_APIRESULT_OK) {
-        return api_ret;
-      }
-      /* 出力データサイズの更新 */
-      cur_output_size += block_size;
-      /* エンコードしたサンプル数の更新 */
-      encode_offset_sample += num_encode_samples;
-      /* 最大ブロックサイズの記録 */
-      if (block_size > max_block_size) {
-        max_block_size = block_size;
-      }
-      /* 最大bpsの計算 */
-      block_bit_per_second = (8 * block_size * encoder->wave_format.sampling_rate) / num_encode_samples;
-      if (block_bit_per_second > max_bit_per_second) {
-        max_bit_per_second = block_bit_per_second;
-      }
-      /* ブロック数増加 */
-      num_blocks++;
-    }
+    cur_output_size += encoded_size;
+    encode_offset_sample += num_encode_samples;
 
     /* 進捗表示 */
     if (encoder->verpose_flag != 0) {
@@ -911,15 +1366,7 @@ SLAApiResult SLAEncoder_EncodeWhole(struct SLAEncoder* encoder,
     }
   }
 
-  /* 最終ブロックを書き出したところでオーバーランを検知 */
-  if (cur_output_size > data_size) {
-    return SLA_APIRESULT_INSUFFICIENT_DATA_SIZE;
-  }
-
   /* ブロック数, 最大ブロックサイズ, 最大bpsを反映（ヘッダの再度書き込み） */
-  header.num_blocks         = num_blocks;
-  header.max_block_size     = max_block_size;
-  header.max_bit_per_second = max_bit_per_second;
   if ((api_ret = SLAEncoder_EncodeHeader(&header, data, data_size))
       != SLA_APIRESULT_OK) {
     return api_ret;
@@ -930,3 +1377,59 @@ SLAApiResult SLAEncoder_EncodeWhole(struct SLAEncoder* encoder,
 
   return SLA_APIRESULT_OK;
 }
+
+/* ヘッダを含めて全ブロックエンコード */
+SLAApiResult SLAEncoder_EncodeWhole(struct SLAEncoder* encoder,
+    const int32_t* const* input, uint32_t num_samples,
+    uint8_t* data, uint32_t data_size, uint32_t* output_size)
+{
+  struct SLAPcmInput  pcm_input;
+
+  /* 引数チェック */
+  if (encoder == NULL || input == NULL || data == NULL || output_size == NULL) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  /* エンコードに必要なパラメータがセットされていない */
+  if ((!(encoder->status_flag & SLAENCODER_STATUS_FLAG_SET_WAVE_FORMAT))
+      || (!(encoder->status_flag & SLAENCODER_STATUS_FLAG_SET_ENCODE_PARAMETER))) {
+    return SLA_APIRESULT_PARAMETER_NOT_SET;
+  }
+
+  SLAEncoder_SetLeftJustifiedPcmInput(encoder, input, &pcm_input);
+  return SLAEncoder_EncodeWholePcm(encoder, &pcm_input, num_samples, data, data_size, output_size);
+}
+
+/* 統計情報の取得 */
+SLAApiResult SLAEncoder_GetStatistics(const struct SLAEncoder* encoder, struct SLAStatistics* statistics)
+{
+  /* 引数チェック */
+  if ((encoder == NULL) || (statistics == NULL)) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+
+#ifdef SLA_ENABLE_STATISTICS
+  *statistics = encoder->statistics;
+  statistics->ticks_per_second = SLA_STATISTICS_TICKS_PER_SECOND;
+  statistics->tick_clock = SLA_STATISTICS_TICK_CLOCK;
+  return SLA_APIRESULT_OK;
+#else
+  return SLA_APIRESULT_STATISTICS_DISABLED;
+#endif
+}
+
+/* 統計情報のリセット */
+SLAApiResult SLAEncoder_ResetStatistics(struct SLAEncoder* encoder)
+{
+  /* 引数チェック */
+  if (encoder == NULL) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+
+#ifdef SLA_ENABLE_STATISTICS
+  memset(&encoder->statistics, 0, sizeof(struct SLAStatistics));
+  return SLA_APIRESULT_OK;
+#else
+  return SLA_APIRESULT_STATISTICS_DISABLED;
+#endif
+}
@@ -23,6 +23,9 @@
 #define SLAOPTIMALENCODEESTIMATOR_CALCULATE_NUM_NODES(num_samples, delta_num_samples) \
   ((((num_samples) + ((delta_num_samples) - 1)) / (delta_num_samples)) + 1)
 
+/* 16bit幅の格子型フィルタで扱える絶対値の上限（この値以上は飽和の可能性ありとみなす） */
+#define SLALPCSYNTHESIZER_INT16_ABS_LIMIT             (32767)
+
 /* sign(x) * log2ceil(|x| + 1) の計算 TODO:負荷が高い */
 #define SLALMS_SIGNED_LOG2CEIL(x) (SLAUTILITY_SIGN(x) * (int32_t)SLAUTILITY_LOG2CEIL((uint32_t)SLAUTILITY_ABS(x) + 1))
 
@@ -45,13 +48,22 @@ struct SLALPCCalculator {
   double*   auto_corr;     /* 標本自己相関       */
   double*   lpc_coef;      /* LPC係数ベクトル    */
   double*   parcor_coef;   /* PARCOR係数ベクトル */
+  uint8_t   alloced_by_own; /* 自前で領域を確保したか */
+  void*     work;           /* ワーク領域先頭ポインタ */
 };
 
 /* 音声合成ハンドル（格子型フィルタ） */
 struct SLALPCSynthesizer {
-  uint32_t  max_order;            /* 最大次数     */
-  int32_t*  forward_residual;     /* 前向き誤差   */
-  int32_t*  backward_residual;    /* 後ろ向き誤差 */
+  uint32_t  max_order;                    /* 最大次数                                 */
+  int32_t*  forward_residual;             /* 前向き誤差                               */
+  int32_t*  backward_residual;            /* 後ろ向き誤差                             */
+  int16_t*  backward_residual_int16[2];   /* 16bit幅の後ろ向き誤差（ダブルバッファ）  */
+  uint32_t  backward_residual_int16_pos;  /* 16bit幅の後ろ向き誤差の参照面            */
+  int16_t*  parcor_coef_int16;            /* 16bit幅のPARCOR係数                      */
+  uint8_t   is_int16_residual;            /* 後ろ向き誤差を16bit幅で保持しているか    */
+  const struct SLAPredictorKernelTable* kernel_table; /* 使用する計算カーネル         */
+  uint8_t   alloced_by_own;               /* 自前で領域を確保したか                   */
+  void*     work;                         /* ワーク領域先頭ポインタ                   */
 };
 
 /* ロングターム計算ハンドル */
@@ -65,6 +77,8 @@ struct SLALongTermCalculator {
   struct SLALESolver* lesolver;                 /* 連立一次方程式ソルバー     */
   double**            R_mat;                    /* 自己相関行列               */
   double*             ltm_coef_vec;             /* ロングターム係数ベクトル   */
+  uint8_t             alloced_by_own;           /* 自前で領域を確保したか     */
+  void*               work;                     /* ワーク領域先頭ポインタ     */
 };
 
 /* ロングターム予測合成ハンドル */
@@ -73,6 +87,8 @@ struct SLALongTermSynthesizer {
   int32_t*  signal_buffer;            /* 入力データバッファ         */
   uint32_t  signal_buffer_size;       /* 入力データサイズ           */
   uint32_t  signal_buffer_pos;        /* バッファ参照位置           */
+  uint8_t   alloced_by_own;           /* 自前で領域を確保したか     */
+  void*     work;                     /* ワーク領域先頭ポインタ     */
 };
 
 /* LMS計算ハンドル */
@@ -87,6 +103,9 @@ struct SLALMSFilter {
   uint32_t  signal_sign_buffer_size;  /* バッファサイズ                   */
   uint32_t  buffer_pos;               /* バッファ参照位置                 */
   uint32_t  num_input_samples;        /* 入力サンプル数カウント           */
+  const struct SLAPredictorKernelTable* kernel_table; /* 使用する計算カーネル */
+  uint8_t   alloced_by_own;           /* 自前で領域を確保したか           */
+  void*     work;                     /* ワーク領域先頭ポインタ           */
 };
 
 /* 最適ブロック分割探索ハンドル */
@@ -96,13 +115,50 @@ struct SLAOptimalBlockPartitionEstimator {
   double*   cost;               /* 最小コスト               */
   uint32_t* path;               /* パス経路                 */
   uint8_t*  used_flag;          /* 各ノードの使用状態フラグ */
+  uint8_t   alloced_by_own;     /* 自前で領域を確保したか   */
+  void*     work;               /* ワーク領域先頭ポインタ   */
 };
 
 /* エンファシスフィルタハンドル */
 struct SLAEmphasisFilter {
-  int32_t prev_int32;           /* 直前のサンプル */
+  int32_t prev_int32;           /* 直前のサンプル           */
+  uint8_t alloced_by_own;       /* 自前で領域を確保したか   */
+  void*   work;                 /* ワーク領域先頭ポインタ   */
 };
 
+/* 格子型フィルタによる音声合成カーネル（32bit幅） */
+typedef void (*SLALPCSynthesizeInt32Kernel)(
+    int32_t* backward_residual,
+    const int32_t* residual, uint32_t num_samples,
+    const int32_t* parcor_coef, uint32_t order, int32_t* output);
+
+/* 格子型フィルタによる音声合成カーネル（16bit幅） 16bit幅で合成できたサンプル数を返す */
+typedef uint32_t (*SLALPCSynthesizeInt16Kernel)(
+    int16_t** backward_residual, uint32_t* buffer_pos,
+    const int32_t* residual, uint32_t num_samples,
+    const int16_t* parcor_coef, uint32_t order, int32_t* output);
+
+/* LMSの予測値計算カーネル */
+typedef int32_t (*SLALMSCalculatePredictKernel)(
+    const int32_t* fir_coef, const int32_t* fir_buffer,
+    const int32_t* iir_coef, const int32_t* iir_buffer, uint32_t num_coef);
+
+/* 命令セット毎の計算カーネルテーブル */
+struct SLAPredictorKernelTable {
+  SLASIMDInstructionSet         simd;                   /* 命令セット               */
+  SLALPCSynthesizeInt32Kernel   lpc_synthesize_int32;   /* 格子型フィルタ（32bit幅）*/
+  SLALPCSynthesizeInt16Kernel   lpc_synthesize_int16;   /* 格子型フィルタ（16bit幅）*/
+  SLALMSCalculatePredictKernel  lms_calculate_predict;  /* LMSの予測値計算          */
+};
+
+/* 命令セットの指定で選んだ計算カーネルテーブル（NULLならば自動選択） */
+/* 補足）書き込むのはSLAPredictor_SetSIMDInstructionSetのみ。
+ *       各ハンドルは作成時に読み出したテーブルを保持し、演算中はこの変数を参照しない */
+static const struct SLAPredictorKernelTable* st_kernel_table = NULL;
+
+/* ハンドル作成時に使用する計算カーネルテーブルの取得 */
+static const struct SLAPredictorKernelTable* SLAPredictor_GetCurrentKernelTable(void);
+
 /*（標本）自己相関の計算 */
 static SLAPredictorError LPC_CalculateAutoCorrelation(
     const double* data, uint32_t num_samples,
@@ -144,27 +200,69 @@ static const int32_t logsignlms_delta_table[64][3] = {
 };
 #undef DEFINE_LMS_DELTA_ENTRY
 
-/* LPC係数計算ハンドルの作成 */
-struct SLALPCCalculator* SLALPCCalculator_Create(uint32_t max_order)
+/* LPC係数計算ハンドルのワークサイズ計算 */
+int32_t SLALPCCalculator_CalculateWorkSize(uint32_t max_order)
 {
+  int32_t work_size;
+
+  work_size = SLA_MEMORY_ALIGNMENT + SLAUTILITY_WORK_SIZE(sizeof(struct SLALPCCalculator));
+  work_size += 4 * SLAUTILITY_WORK_SIZE(sizeof(double) * (max_order + 2)); /* a_vec, e_vec, u_vec, v_vec */
+  work_size += 3 * SLAUTILITY_WORK_SIZE(sizeof(double) * (max_order + 1)); /* auto_corr, lpc_coef, parcor_coef */
+
+  return work_size;
+}
+
+/* LPC係数計算ハンドルの作成（ワーク領域指定） */
+struct SLALPCCalculator* SLALPCCalculator_CreateWithWork(uint32_t max_order, void* work, int32_t work_size)
+{
+  uint8_t* work_ptr;
   struct SLALPCCalculator* lpc;
 
-  lpc = (struct SLALPCCalculator *)malloc(sizeof(struct SLALPCCalculator));
+  /* 引数チェック */
+  if ((work == NULL) || (work_size < SLALPCCalculator_CalculateWorkSize(max_order))) {
+    return NULL;
+  }
 
-  lpc->max_order = max_order;
+  work_ptr = SLAUTILITY_ALIGN_WORK(work);
+
+  lpc = (struct SLALPCCalculator *)SLAUtility_AllocateWork(&work_ptr, sizeof(struct SLALPCCalculator));
+
+  lpc->max_order      = max_order;
+  lpc->alloced_by_own = 0;
+  lpc->work           = work;
 
   /* 計算用ベクトルの領域割当 */
-  lpc->a_vec = (double *)malloc(sizeof(double) * (max_order + 2)); /* a_0, a_k+1を含めるとmax_order+2 */
-  lpc->e_vec = (double *)malloc(sizeof(double) * (max_order + 2)); /* e_0, e_k+1を含めるとmax_order+2 */
-  lpc->u_vec = (double *)malloc(sizeof(double) * (max_order + 2));
-  lpc->v_vec = (double *)malloc(sizeof(double) * (max_order + 2));
+  lpc->a_vec = (double *)SLAUtility_AllocateWork(&work_ptr, sizeof(double) * (max_order + 2)); /* a_0, a_k+1を含めるとmax_order+2 */
+  lpc->e_vec = (double *)SLAUtility_AllocateWork(&work_ptr, sizeof(double) * (max_order + 2)); /* e_0, e_k+1を含めるとmax_order+2 */
+  lpc->u_vec = (double *)SLAUtility_AllocateWork(&work_ptr, sizeof(double) * (max_order + 2));
+  lpc->v_vec = (double *)SLAUtility_AllocateWork(&work_ptr, sizeof(double) * (max_order + 2));
 
   /* 標本自己相関の領域割当 */
-  lpc->auto_corr = (double *)malloc(sizeof(double) * (max_order + 1));
+  lpc->auto_corr = (double *)SLAUtility_AllocateWork(&work_ptr, sizeof(double) * (max_order + 1));
 
   /* 係数ベクトルの領域割当 */
-  lpc->lpc_coef     = (double *)malloc(sizeof(double) * (max_order + 1));
-  lpc->parcor_coef  = (double *)malloc(sizeof(double) * (max_order + 1));
+  lpc->lpc_coef     = (double *)SLAUtility_AllocateWork(&work_ptr, sizeof(double) * (max_order + 1));
+  lpc->parcor_coef  = (double *)SLAUtility_AllocateWork(&work_ptr, sizeof(double) * (max_order + 1));
+
+  SLA_Assert((work_ptr - (uint8_t *)work) <= work_size);
+
+  return lpc;
+}
+
+/* LPC係数計算ハンドルの作成 */
+struct SLALPCCalculator* SLALPCCalculator_Create(uint32_t max_order)
+{
+  int32_t work_size;
+  void* work;
+  struct SLALPCCalculator* lpc;
+
+  work_size = SLALPCCalculator_CalculateWorkSize(max_order);
+  work = malloc((size_t)work_size);
+  if ((lpc = SLALPCCalculator_CreateWithWork(max_order, work, work_size)) == NULL) {
+    NULLCHECK_AND_FREE(work);
+    return NULL;
+  }
+  lpc->alloced_by_own = 1;
 
   return lpc;
 }
@@ -172,15 +270,8 @@ struct SLALPCCalculator* SLALPCCalculator_Create(uint32_t max_order)
 /* LPC係数計算ハンドルの破棄 */
 void SLALPCCalculator_Destroy(struct SLALPCCalculator* lpcc)
 {
-  if (lpcc != NULL) {
-    NULLCHECK_AND_FREE(lpcc->a_vec);
-    NULLCHECK_AND_FREE(lpcc->e_vec);
-    NULLCHECK_AND_FREE(lpcc->u_vec);
-    NULLCHECK_AND_FREE(lpcc->v_vec);
-    NULLCHECK_AND_FREE(lpcc->auto_corr);
-    NULLCHECK_AND_FREE(lpcc->lpc_coef);
-    NULLCHECK_AND_FREE(lpcc->parcor_coef);
-    free(lpcc);
+  if ((lpcc != NULL) && lpcc->alloced_by_own) {
+    free(lpcc->work);
   }
 }
 
@@ -501,37 +592,80 @@ SLAPredictorApiResult SLALPCCalculator_CalculateResidualPower(
   return SLAPREDICTOR_APIRESULT_OK;
 }
 
-/* LPC音声合成ハンドルの作成 */
-struct SLALPCSynthesizer* SLALPCSynthesizer_Create(uint32_t max_order)
+/* LPC音声合成ハンドルのワークサイズ計算 */
+int32_t SLALPCSynthesizer_CalculateWorkSize(uint32_t max_order)
 {
+  int32_t work_size;
+
+  work_size = SLA_MEMORY_ALIGNMENT + SLAUTILITY_WORK_SIZE(sizeof(struct SLALPCSynthesizer));
+  work_size += 2 * SLAUTILITY_WORK_SIZE(sizeof(int32_t) * (max_order + 1)); /* 前向き/後ろ向き誤差 */
+  work_size += 3 * SLAUTILITY_WORK_SIZE(sizeof(int16_t) * (max_order + 1)); /* 16bit幅の後ろ向き誤差/係数 */
+
+  return work_size;
+}
+
+/* LPC音声合成ハンドルの作成（ワーク領域指定） */
+struct SLALPCSynthesizer* SLALPCSynthesizer_CreateWithWork(uint32_t max_order, void* work, int32_t work_size)
+{
+  uint8_t* work_ptr;
   struct SLALPCSynthesizer* lpcs;
 
-  lpcs = (struct SLALPCSynthesizer *)malloc(sizeof(struct SLALPCSynthesizer));
+  /* 引数チェック */
+  if ((work == NULL) || (work_size < SLALPCSynthesizer_CalculateWorkSize(max_order))) {
+    return NULL;
+  }
+
+  work_ptr = SLAUTILITY_ALIGN_WORK(work);
+
+  lpcs = (struct SLALPCSynthesizer *)SLAUtility_AllocateWork(&work_ptr, sizeof(struct SLALPCSynthesizer));
 
-  lpcs->max_order = max_order;
+  lpcs->max_order       = max_order;
+  lpcs->kernel_table    = SLAPredictor_GetCurrentKernelTable();
+  lpcs->alloced_by_own  = 0;
+  lpcs->work            = work;
 
   /* 前向き/後ろ向き誤差の領域確保 */
-  lpcs->forward_residual  = malloc(sizeof(int32_t) * (max_order + 1));
-  lpcs->backward_residual = malloc(sizeof(int32_t) * (max_order + 1));
+  lpcs->forward_residual  = (int32_t *)SLAUtility_AllocateWork(&work_ptr, sizeof(int32_t) * (max_order + 1));
+  lpcs->backward_residual = (int32_t *)SLAUtility_AllocateWork(&work_ptr, sizeof(int32_t) * (max_order + 1));
+
+  /* 16bit幅の後ろ向き誤差/係数の領域確保 */
+  lpcs->backward_residual_int16[0]  = (int16_t *)SLAUtility_AllocateWork(&work_ptr, sizeof(int16_t) * (max_order + 1));
+  lpcs->backward_residual_int16[1]  = (int16_t *)SLAUtility_AllocateWork(&work_ptr, sizeof(int16_t) * (max_order + 1));
+  lpcs->parcor_coef_int16           = (int16_t *)SLAUtility_AllocateWork(&work_ptr, sizeof(int16_t) * (max_order + 1));
+
+  SLA_Assert((work_ptr - (uint8_t *)work) <= work_size);
 
   /* 状態リセット */
   if (SLALPCSynthesizer_Reset(lpcs) != SLAPREDICTOR_APIRESULT_OK) {
-    free(lpcs->forward_residual);
-    free(lpcs->backward_residual);
-    free(lpcs);
     return NULL;
   }
 
   return lpcs;
 }
 
+/* LPC音声合成ハンドルの作成 */
+struct SLALPCSynthesizer* SLALPCSynthesizer_Create(uint32_t max_order)
+{
+  int32_t work_size;
+  void* work;
+  struct SLALPCSynthesizer* lpcs;
+
+  work_size = SLALPCSynthesizer_CalculateWorkSize(max_order);
+  work = malloc((size_t)work_size);
+  if ((lpcs = SLALPCSynthesizer_CreateWithWork(max_order, work, work_size)) == NULL) {
+    NULLCHECK_AND_FREE(work);
+    return NULL;
+  }
+  lpcs->alloced_by_own = 1;
+
+  return lpcs;
+}
+
 /* LPC音声合成ハンドルの破棄 */
 void SLALPCSynthesizer_Destroy(struct SLALPCSynthesizer* lpc)
 {
-  if (lpc != NULL) {
-    NULLCHECK_AND_FREE(lpc->forward_residual);
-    NULLCHECK_AND_FREE(lpc->backward_residual);
-    free(lpc);
+  if ((lpc != NULL) && lpc->alloced_by_own) {
+    free(lpc->work);
   }
 }
 
@@ -548,11 +682,38 @@ SLAPredictorApiResult SLALPCSynthesizer_Reset(struct SLALPCSynthesizer* lpc)
   /* 誤差をゼロ初期化 */
   for (ord = 0; ord < lpc->max_order + 1; ord++) {
     lpc->forward_residual[ord] = lpc->backward_residual[ord] = 0;
+    lpc->backward_residual_int16[0][ord] = lpc->backward_residual_int16[1][ord] = 0;
   }
 
+  /* ゼロは16bit幅で表現できるので16bit幅の誤差から開始 */
+  lpc->backward_residual_int16_pos  = 0;
+  lpc->is_int16_residual            = 1;
+
   return SLAPREDICTOR_APIRESULT_OK;
 }
 
+/* 16bit幅で保持している後ろ向き誤差を32bit幅に戻す */
+static void SLALPCSynthesizer_WidenBackwardResidual(struct SLALPCSynthesizer* lpc)
+{
+  uint32_t ord;
+  const int16_t* backward_residual_int16;
+
+  SLA_Assert(lpc != NULL);
+
+  /* 既に32bit幅ならば何もしない */
+  if (lpc->is_int16_residual == 0) {
+    return;
+  }
+
+  backward_residual_int16 = lpc->backward_residual_int16[lpc->backward_residual_int16_pos];
+  for (ord = 0; ord < lpc->max_order + 1; ord++) {
+    lpc->backward_residual[ord] = backward_residual_int16[ord];
+  }
+
+  /* 以降はブロック先頭でリセットされるまで32bit幅で合成 */
+  lpc->is_int16_residual = 0;
+}
+
 /* PARCOR係数により予測/誤差出力（32bit整数入出力）: 乗算時に32bit幅になるように修正 */
 SLAPredictorApiResult SLALPCSynthesizer_PredictByParcorCoefInt32(
     struct SLALPCSynthesizer* lpc,
@@ -606,44 +767,136 @@ SLAPredictorApiResult SLALPCSynthesizer_PredictByParcorCoefInt32(
   return SLAPREDICTOR_APIRESULT_OK;
 }
 
-/* PARCOR係数により誤差信号から音声合成（32bit整数入出力） */
-SLAPredictorApiResult SLALPCSynthesizer_SynthesizeByParcorCoefInt32(
-    struct SLALPCSynthesizer* lpc,
+/* 格子型フィルタによる音声合成（32bit幅）: リファレンス実装 */
+static void SLALPCSynthesizer_SynthesizeInt32Reference(
+    int32_t* backward_residual,
     const int32_t* residual, uint32_t num_samples,
     const int32_t* parcor_coef, uint32_t order, int32_t* output)
 {
   uint32_t      ord, samp;
-  int32_t*      backward_residual;
   const int32_t half = (1UL << 14); /* 丸め誤差軽減のための加算定数 = 0.5 */
 
-  /* 引数チェック */
-  if (lpc == NULL || residual == NULL
-      || parcor_coef == NULL || output == NULL) {
-    return SLAPREDICTOR_APIRESULT_INVALID_ARGUMENT;
+  for (samp = 0; samp < num_samples; samp++) {
+    int32_t forward_residual;
+    /* 誤差入力 */
+    forward_residual = residual[samp];
+    for (ord = order; ord >= 1; ord--) {
+      /* 前向き誤差計算 */
+      forward_residual += (int32_t)SLAUTILITY_SHIFT_RIGHT_ARITHMETIC(parcor_coef[ord] * backward_residual[ord - 1] + half, 15);
+      /* 後ろ向き誤差計算 */
+      backward_residual[ord] = backward_residual[ord - 1] - (int32_t)SLAUTILITY_SHIFT_RIGHT_ARITHMETIC(parcor_coef[ord] * forward_residual + half, 15);
+    }
+    /* 合成信号 */
+    output[samp] = forward_residual;
+    /* 後ろ向き誤差計算部にデータ入力 */
+    backward_residual[0] = forward_residual;
   }
+}
 
-  /* 次数チェック */
-  if (order > lpc->max_order) {
-    return SLAPREDICTOR_APIRESULT_EXCEED_MAX_ORDER;
+/* 格子型フィルタによる音声合成（16bit幅）: リファレンス実装 */
+/* 16bit幅に収まって合成できたサンプル数を返す */
+/* 補足）直前の後ろ向き誤差を読んで次の面に書き込み、成功したら面を入れ替える */
+/* 　　　途中で16bit幅を超えそうになった時も直前の面は壊れていない */
+static uint32_t SLALPCSynthesizer_SynthesizeInt16Reference(
+    int16_t** backward_residual, uint32_t* buffer_pos,
+    const int32_t* residual, uint32_t num_samples,
+    const int16_t* parcor_coef, uint32_t order, int32_t* output)
+{
+  uint32_t      ord, samp, pos;
+  int32_t       forward_residual, backward;
+  int16_t       *prev_backward_residual, *next_backward_residual;
+  const int32_t half = (1UL << 14); /* 丸め誤差軽減のための加算定数 = 0.5 */
+
+  pos = (*buffer_pos);
+  for (samp = 0; samp < num_samples; samp++) {
+    prev_backward_residual = backward_residual[pos];
+    next_backward_residual = backward_residual[pos ^ 1];
+
+    /* 誤差入力 */
+    forward_residual = residual[samp];
+    if (SLAUTILITY_ABS(forward_residual) >= SLALPCSYNTHESIZER_INT16_ABS_LIMIT) {
+      break;
+    }
+
+    for (ord = order; ord >= 1; ord--) {
+      /* 前向き誤差計算 */
+      forward_residual += (int32_t)SLAUTILITY_SHIFT_RIGHT_ARITHMETIC(parcor_coef[ord] * prev_backward_residual[ord - 1] + half, 15);
+      /* 後ろ向き誤差計算 */
+      backward = prev_backward_residual[ord - 1] - (int32_t)SLAUTILITY_SHIFT_RIGHT_ARITHMETIC(parcor_coef[ord] * forward_residual + half, 15);
+      if (SLAUTILITY_ABS(backward) >= SLALPCSYNTHESIZER_INT16_ABS_LIMIT) {
+        break;
+      }
+      next_backward_residual[ord] = (int16_t)backward;
+    }
+
+    /* 16bit幅を超えた */
+    if ((ord >= 1) || (SLAUTILITY_ABS(forward_residual) >= SLALPCSYNTHESIZER_INT16_ABS_LIMIT)) {
+      break;
+    }
+
+    /* 合成信号 */
+    output[samp] = forward_residual;
+    /* 後ろ向き誤差計算部にデータ入力 */
+    next_backward_residual[0] = (int16_t)forward_residual;
+    /* 面の入れ替え */
+    pos ^= 1;
   }
 
-  /* オート変数にポインタをコピー */
-  backward_residual = lpc->backward_residual;
+  (*buffer_pos) = pos;
+  return samp;
+}
+
+/* LMSの予測値計算: リファレンス実装 */
+static int32_t SLALMSFilter_CalculatePredictReference(
+    const int32_t* fir_coef, const int32_t* fir_buffer,
+    const int32_t* iir_coef, const int32_t* iir_buffer, uint32_t num_coef)
+{
+  uint32_t i;
+  int32_t predict = 0;
+
+  for (i = 0; i < num_coef; i++) {
+    /* FIRフィルタ予測 */
+    predict += fir_coef[i] * fir_buffer[i];
+    /* オーバーフローチェック */
+    SLA_Assert(SLAUTILITY_SHIFT_RIGHT_ARITHMETIC((int64_t)fir_coef[i] * fir_buffer[i], 10) <= (int64_t)INT32_MAX);
+    SLA_Assert(SLAUTILITY_SHIFT_RIGHT_ARITHMETIC((int64_t)fir_coef[i] * fir_buffer[i], 10) >= (int64_t)INT32_MIN);
+    /* IIRフィルタ予測 */
+    predict += iir_coef[i] * iir_buffer[i];
+    /* オーバーフローチェック */
+    SLA_Assert(SLAUTILITY_SHIFT_RIGHT_ARITHMETIC((int64_t)iir_coef[i] * iir_buffer[i], 10) <= (int64_t)INT32_MAX);
+    SLA_Assert(SLAUTILITY_SHIFT_RIGHT_ARITHMETIC((int64_t)iir_coef[i] * iir_buffer[i], 10) >= (int64_t)INT32_MIN);
+  }
+
+  return predict;
+}
 
-  /* 格子型フィルタによる音声合成 */
 #if defined(USE_SSE)
-  /* 注意）実行できるかのチェックは行っていない... */
-  SLA_Assert(order % 4 == 0);
+/* 格子型フィルタによる音声合成（32bit幅）: SSE4.1実装 */
+SLAUTILITY_TARGET_SSE41
+static void SLALPCSynthesizer_SynthesizeInt32SSE41(
+    int32_t* backward_residual,
+    const int32_t* residual, uint32_t num_samples,
+    const int32_t* parcor_coef, uint32_t order, int32_t* output)
+{
+  uint32_t      ord, samp;
+  const int32_t half = (1UL << 14); /* 丸め誤差軽減のための加算定数 = 0.5 */
+
+  /* 4次ずつ処理できない場合はリファレンス実装で合成 */
+  if ((order % 4) != 0) {
+    SLALPCSynthesizer_SynthesizeInt32Reference(backward_residual,
+        residual, num_samples, parcor_coef, order, output);
+    return;
+  }
+
   for (samp = 0; samp < num_samples; samp++) {
-    __attribute__((aligned(16))) int32_t ftmp[4]; 
     __m128i vforw;
-    __m128i vhalf     = _mm_set_epi32(half, half, half, half);
-    __m128i vmask0FFF = _mm_set_epi32( 0, ~0, ~0, ~0);
-    __m128i vmask00FF = _mm_set_epi32( 0,  0, ~0, ~0);
-    __m128i vmask000F = _mm_set_epi32( 0,  0,  0, ~0);
+    const __m128i vhalf     = _mm_set_epi32(half, half, half, half);
+    const __m128i vmask0FFF = _mm_set_epi32( 0, ~0, ~0, ~0);
+    const __m128i vmask00FF = _mm_set_epi32( 0,  0, ~0, ~0);
+    const __m128i vmask000F = _mm_set_epi32( 0,  0,  0, ~0);
 
     /* 入力取得 */
-    vforw = _mm_set_epi32(residual[samp], residual[samp], residual[samp], residual[samp]);
+    vforw = _mm_set1_epi32(residual[samp]);
 
     /* 4次ずつ計算 */
     for (ord = order; ord > 0; ord -= 4) {
@@ -663,8 +916,8 @@ SLAPredictorApiResult SLALPCSynthesizer_SynthesizeByParcorCoefInt32(
       multmp[2] = (int32_t)SLAUTILITY_SHIFT_RIGHT_ARITHMETIC(multmp[2], 15);
       multmp[3] = (int32_t)SLAUTILITY_SHIFT_RIGHT_ARITHMETIC(multmp[3], 15);
       */
-      vcoef = _mm_loadu_si128((__m128i *)&parcor_coef[ord - 3]);
-      vback = _mm_loadu_si128((__m128i *)&backward_residual[ord - 4]);
+      vcoef = _mm_loadu_si128((const __m128i *)&parcor_coef[ord - 3]);
+      vback = _mm_loadu_si128((const __m128i *)&backward_residual[ord - 4]);
       vmul = _mm_mullo_epi32(vcoef, vback);
       vmul = _mm_add_epi32(vmul, vhalf);
       vmul = _mm_srai_epi32(vmul, 15);
@@ -711,61 +964,545 @@ SLAPredictorApiResult SLALPCSynthesizer_SynthesizeByParcorCoefInt32(
     }
 
     /* 結果取得 */
-    _mm_stream_si128((__m128i *)ftmp, vforw);
+    output[samp] = _mm_cvtsi128_si32(vforw);
     /* 後ろ向き誤差入力 */
-    backward_residual[0] = ftmp[0];
-    /* 出力 */
-    output[samp] = ftmp[0];
+    backward_residual[0] = output[samp];
   }
-#else
-  /* リファレンス実装 */
+}
+
+/* 格子型フィルタによる音声合成（16bit幅）: SSE4.1実装 */
+/* 16bit幅に収まって合成できたサンプル数を返す */
+SLAUTILITY_TARGET_SSE41
+static uint32_t SLALPCSynthesizer_SynthesizeInt16SSE41(
+    int16_t** backward_residual, uint32_t* buffer_pos,
+    const int32_t* residual, uint32_t num_samples,
+    const int16_t* parcor_coef, uint32_t order, int32_t* output)
+{
+  uint32_t  ord, samp, pos;
+  int16_t   *prev_backward_residual, *next_backward_residual;
+
+  /* 8次ずつ処理できない場合はリファレンス実装で合成 */
+  if ((order % 8) != 0) {
+    return SLALPCSynthesizer_SynthesizeInt16Reference(backward_residual, buffer_pos,
+        residual, num_samples, parcor_coef, order, output);
+  }
+
+  pos = (*buffer_pos);
   for (samp = 0; samp < num_samples; samp++) {
-    int32_t forward_residual;
+    __m128i vforw, vmask;
+    const __m128i vlimit = _mm_set1_epi16(SLALPCSYNTHESIZER_INT16_ABS_LIMIT);
+    __m128i vabsmax = _mm_setzero_si128();
+
+    prev_backward_residual = backward_residual[pos];
+    next_backward_residual = backward_residual[pos ^ 1];
+
     /* 誤差入力 */
-    forward_residual = residual[samp];
-    for (ord = order; ord >= 1; ord--) {
-      /* 前向き誤差計算 */
-      forward_residual += (int32_t)SLAUTILITY_SHIFT_RIGHT_ARITHMETIC(parcor_coef[ord] * backward_residual[ord - 1] + half, 15);
-      /* 後ろ向き誤差計算 */
-      backward_residual[ord] = backward_residual[ord - 1] - (int32_t)SLAUTILITY_SHIFT_RIGHT_ARITHMETIC(parcor_coef[ord] * forward_residual + half, 15);
+    if (SLAUTILITY_ABS(residual[samp]) >= SLALPCSYNTHESIZER_INT16_ABS_LIMIT) {
+      break;
+    }
+    vforw = _mm_set1_epi16((int16_t)residual[samp]);
+
+    /* 8次ずつ計算 */
+    for (ord = order; ord > 0; ord -= 8) {
+      __m128i vback, vmul, vcoef;
+
+      /* multmp[i] = round(coef[ord - 7 + i] * backward_residual[ord - 8 + i]) */
+      /* 補足）mulhrsは (a * b + 2^14) >> 15 と一致 */
+      vcoef = _mm_loadu_si128((const __m128i *)&parcor_coef[ord - 7]);
+      vback = _mm_loadu_si128((const __m128i *)&prev_backward_residual[ord - 8]);
+      vmul  = _mm_mulhrs_epi16(vcoef, vback);
+
+      /* 上位レーンからの累積和: ftmp[i] = ftmp + multmp[7] + ... + multmp[i] */
+      /* 飽和加算を使い、途中結果の絶対値の最大を記録して16bit幅超過を検出 */
+      vmul    = _mm_adds_epi16(vmul, _mm_srli_si128(vmul, 2));
+      vabsmax = _mm_max_epu16(vabsmax, _mm_abs_epi16(vmul));
+      vmul    = _mm_adds_epi16(vmul, _mm_srli_si128(vmul, 4));
+      vabsmax = _mm_max_epu16(vabsmax, _mm_abs_epi16(vmul));
+      vmul    = _mm_adds_epi16(vmul, _mm_srli_si128(vmul, 8));
+      vabsmax = _mm_max_epu16(vabsmax, _mm_abs_epi16(vmul));
+      vforw   = _mm_shuffle_epi32(_mm_shufflelo_epi16(vforw, 0), 0);
+      vforw   = _mm_adds_epi16(vforw, vmul);
+      vabsmax = _mm_max_epu16(vabsmax, _mm_abs_epi16(vforw));
+
+      /* backward_residual[ord - 7 + i] = backward_residual[ord - 8 + i] - round(coef[ord - 7 + i] * ftmp[i]) */
+      vmul    = _mm_mulhrs_epi16(vcoef, vforw);
+      vback   = _mm_subs_epi16(vback, vmul);
+      vabsmax = _mm_max_epu16(vabsmax, _mm_abs_epi16(vback));
+      _mm_storeu_si128((__m128i *)&next_backward_residual[ord - 7], vback);
+    }
+
+    /* 16bit幅を超えた可能性がある */
+    vmask = _mm_cmpeq_epi16(_mm_min_epu16(vabsmax, vlimit), vlimit);
+    if (_mm_movemask_epi8(vmask) != 0) {
+      break;
     }
+
     /* 合成信号 */
-    output[samp] = forward_residual;
+    output[samp] = (int16_t)_mm_extract_epi16(vforw, 0);
     /* 後ろ向き誤差計算部にデータ入力 */
-    backward_residual[0] = forward_residual;
+    next_backward_residual[0] = (int16_t)output[samp];
+    /* 面の入れ替え */
+    pos ^= 1;
   }
+
+  (*buffer_pos) = pos;
+  return samp;
+}
+
+/* LMSの予測値計算: SSE4.1実装 */
+SLAUTILITY_TARGET_SSE41
+static int32_t SLALMSFilter_CalculatePredictSSE41(
+    const int32_t* fir_coef, const int32_t* fir_buffer,
+    const int32_t* iir_coef, const int32_t* iir_buffer, uint32_t num_coef)
+{
+  uint32_t i;
+  __m128i vsum = _mm_setzero_si128();
+
+  /* 補足）リファレンス実装と同じく32bitの剰余演算で累積するので結果は一致する */
+  SLA_Assert((num_coef % 4) == 0);
+  for (i = 0; i < num_coef; i += 4) {
+    vsum = _mm_add_epi32(vsum, _mm_mullo_epi32(
+          _mm_loadu_si128((const __m128i *)&fir_coef[i]), _mm_loadu_si128((const __m128i *)&fir_buffer[i])));
+    vsum = _mm_add_epi32(vsum, _mm_mullo_epi32(
+          _mm_loadu_si128((const __m128i *)&iir_coef[i]), _mm_loadu_si128((const __m128i *)&iir_buffer[i])));
+  }
+
+  /* 水平加算 */
+  vsum = _mm_add_epi32(vsum, _mm_shuffle_epi32(vsum, _MM_SHUFFLE(1, 0, 3, 2)));
+  vsum = _mm_add_epi32(vsum, _mm_shuffle_epi32(vsum, _MM_SHUFFLE(2, 3, 0, 1)));
+
+  return _mm_cvtsi128_si32(vsum);
+}
+#endif /* USE_SSE */
+
+/* リファレンス実装の計算カーネル */
+static const struct SLAPredictorKernelTable st_reference_kernel_table = {
+  SLA_SIMDINSTRUCTIONSET_NONE,
+  SLALPCSynthesizer_SynthesizeInt32Reference,
+  SLALPCSynthesizer_SynthesizeInt16Reference,
+  SLALMSFilter_CalculatePredictReference
+};
+
+#if defined(USE_SSE)
+/* SSE4.1実装の計算カーネル */
+static const struct SLAPredictorKernelTable st_sse41_kernel_table = {
+  SLA_SIMDINSTRUCTIONSET_SSE41,
+  SLALPCSynthesizer_SynthesizeInt32SSE41,
+  SLALPCSynthesizer_SynthesizeInt16SSE41,
+  SLALMSFilter_CalculatePredictSSE41
+};
 #endif
 
+/* 命令セットに対応する計算カーネルを取得 見つからない場合はNULL */
+static const struct SLAPredictorKernelTable* SLAPredictor_GetKernelTable(SLASIMDInstructionSet simd)
+{
+  switch (simd) {
+    case SLA_SIMDINSTRUCTIONSET_NONE:
+      return &st_reference_kernel_table;
+#if defined(USE_SSE)
+    case SLA_SIMDINSTRUCTIONSET_SSE41:
+      return &st_sse41_kernel_table;
+#endif
+    default:
+      break;
+  }
+  return NULL;
+}
+
+/* 使用する命令セットの設定 */
+SLAPredictorApiResult SLAPredictor_SetSIMDInstructionSet(SLASIMDInstructionSet simd)
+{
+  const struct SLAPredictorKernelTable* table;
+  SLASIMDInstructionSet available = SLAUtility_GetAvailableSIMDInstructionSet();
+
+  /* 自動選択: 実行環境で使用可能な命令セット */
+  if (simd == SLA_SIMDINSTRUCTIONSET_AUTO) {
+    simd = available;
+  }
+
+  /* 実行環境で使えない命令セットが指定された */
+  if (simd > available) {
+    return SLAPREDICTOR_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  /* ビルドに含まれていない命令セットが指定された */
+  if ((table = SLAPredictor_GetKernelTable(simd)) == NULL) {
+    return SLAPREDICTOR_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  st_kernel_table = table;
   return SLAPREDICTOR_APIRESULT_OK;
 }
 
-/* ロングターム計算ハンドルの作成 */
-struct SLALongTermCalculator* SLALongTermCalculator_Create(
+/* ハンドル作成時に使用する計算カーネルテーブルの取得 */
+/* 補足）未指定時は実行環境で使用可能な命令セットをその都度選ぶ（静的変数には書き込まない） */
+static const struct SLAPredictorKernelTable* SLAPredictor_GetCurrentKernelTable(void)
+{
+  const struct SLAPredictorKernelTable* table;
+
+  if (st_kernel_table != NULL) {
+    return st_kernel_table;
+  }
+
+  /* 使用可能な命令セットがビルドに含まれていなければリファレンス実装 */
+  if ((table = SLAPredictor_GetKernelTable(SLAUtility_GetAvailableSIMDInstructionSet())) == NULL) {
+    table = &st_reference_kernel_table;
+  }
+
+  return table;
+}
+
+/* 使用中の命令セットの取得 */
+SLASIMDInstructionSet SLAPredictor_GetSIMDInstructionSet(void)
+{
+  return SLAPredictor_GetCurrentKernelTable()->simd;
+}
+
+/* 実行環境で使える全ての計算カーネルをリファレンス実装と照合 */
+SLAPredictorApiResult SLAPredictor_CheckKernels(void)
+{
+#define CHECK_NUM_SAMPLES 512
+#define CHECK_MAX_ORDER   32
+  uint32_t  i, smpl, ord, order, simd;
+  uint32_t  seed, ref_pos, test_pos, ref_num, test_num;
+  int32_t   residual[CHECK_NUM_SAMPLES];
+  int32_t   ref_output[CHECK_NUM_SAMPLES], test_output[CHECK_NUM_SAMPLES];
+  int32_t   coef32[CHECK_MAX_ORDER + 1];
+  int16_t   coef16[CHECK_MAX_ORDER + 1];
+  int32_t   ref_back32[CHECK_MAX_ORDER + 1], test_back32[CHECK_MAX_ORDER + 1];
+  int16_t   ref_back16[2][CHECK_MAX_ORDER + 1], test_back16[2][CHECK_MAX_ORDER + 1];
+  int16_t   *ref_back16_p[2], *test_back16_p[2];
+  int32_t   lms_buffer[4][CHECK_MAX_ORDER];
+  const struct SLAPredictorKernelTable* table;
+  SLASIMDInstructionSet available = SLAUtility_GetAvailableSIMDInstructionSet();
+  static const uint32_t check_orders[] = { 4, 7, 8, 16, 20, 32 };
+  /* 入力振幅のビット幅（16bit幅の合成が途中で32bit幅に切り替わる入力を含む） */
+  static const uint32_t check_bitwidths[] = { 8, 14, 17 };
+
+/* 線形合同法による擬似乱数 */
+#define CHECK_RAND(seed) ((seed) = (uint32_t)((1103515245UL * (seed) + 12345UL) & 0x7FFFFFFFUL), (int32_t)((seed) >> 8))
+
+  ref_back16_p[0] = ref_back16[0]; ref_back16_p[1] = ref_back16[1];
+  test_back16_p[0] = test_back16[0]; test_back16_p[1] = test_back16[1];
+
+  for (simd = SLA_SIMDINSTRUCTIONSET_NONE; simd <= (uint32_t)available; simd++) {
+    if ((table = SLAPredictor_GetKernelTable((SLASIMDInstructionSet)simd)) == NULL) {
+      continue;
+    }
+    for (order = 0; order < sizeof(check_orders) / sizeof(check_orders[0]); order++) {
+      for (i = 0; i < sizeof(check_bitwidths) / sizeof(check_bitwidths[0]); i++) {
+        seed = order * 31 + i;
+        /* 安定なフィルタになるよう減衰させた係数 */
+        coef32[0] = 0;
+        for (ord = 1; ord <= check_orders[order]; ord++) {
+          coef32[ord] = (CHECK_RAND(seed) % 65536 - 32768) / (int32_t)(ord + 1);
+          coef16[ord] = (int16_t)coef32[ord];
+        }
+        for (smpl = 0; smpl < CHECK_NUM_SAMPLES; smpl++) {
+          residual[smpl] = CHECK_RAND(seed) % (1 << check_bitwidths[i]) - (1 << (check_bitwidths[i] - 1));
+        }
+
+        /* 32bit幅の格子型フィルタ */
+        memset(ref_back32, 0, sizeof(ref_back32));
+        memset(test_back32, 0, sizeof(test_back32));
+        SLALPCSynthesizer_SynthesizeInt32Reference(ref_back32,
+            residual, CHECK_NUM_SAMPLES, coef32, check_orders[order], ref_output);
+        table->lpc_synthesize_int32(test_back32,
+            residual, CHECK_NUM_SAMPLES, coef32, check_orders[order], test_output);
+        if ((memcmp(ref_output, test_output, sizeof(int32_t) * CHECK_NUM_SAMPLES) != 0)
+            || (memcmp(ref_back32, test_back32, sizeof(ref_back32)) != 0)) {
+          return SLAPREDICTOR_APIRESULT_NG;
+        }
+
+        /* 16bit幅の格子型フィルタ: 合成できたサンプル数まで一致するか */
+        memset(ref_back16, 0, sizeof(ref_back16));
+        memset(test_back16, 0, sizeof(test_back16));
+        ref_pos = test_pos = 0;
+        ref_num = SLALPCSynthesizer_SynthesizeInt16Reference(ref_back16_p, &ref_pos,
+            residual, CHECK_NUM_SAMPLES, coef16, check_orders[order], ref_output);
+        test_num = table->lpc_synthesize_int16(test_back16_p, &test_pos,
+            residual, CHECK_NUM_SAMPLES, coef16, check_orders[order], test_output);
+        /* 補足）SIMD実装は前向き誤差の途中結果も16bit幅に制限するため早く打ち切ることがある */
+        if ((test_num > ref_num)
+            || (memcmp(ref_output, test_output, sizeof(int32_t) * test_num) != 0)) {
+          return SLAPREDICTOR_APIRESULT_NG;
+        }
+
+        /* LMSの予測値計算 */
+        if ((check_orders[order] % 4) == 0) {
+          for (ord = 0; ord < check_orders[order]; ord++) {
+            lms_buffer[0][ord] = CHECK_RAND(seed) % 4096 - 2048;
+            lms_buffer[1][ord] = residual[ord];
+            lms_buffer[2][ord] = CHECK_RAND(seed) % 4096 - 2048;
+            lms_buffer[3][ord] = residual[CHECK_NUM_SAMPLES - ord - 1];
+          }
+          if (SLALMSFilter_CalculatePredictReference(lms_buffer[0], lms_buffer[1],
+                lms_buffer[2], lms_buffer[3], check_orders[order])
+              != table->lms_calculate_predict(lms_buffer[0], lms_buffer[1],
+                lms_buffer[2], lms_buffer[3], check_orders[order])) {
+            return SLAPREDICTOR_APIRESULT_NG;
+          }
+        }
+      }
+    }
+  }
+
+  return SLAPREDICTOR_APIRESULT_OK;
+#undef CHECK_RAND
+#undef CHECK_NUM_SAMPLES
+#undef CHECK_MAX_ORDER
+}
+
+/* PARCOR係数により誤差信号から音声合成（32bit整数入出力） */
+SLAPredictorApiResult SLALPCSynthesizer_SynthesizeByParcorCoefInt32(
+    struct SLALPCSynthesizer* lpc,
+    const int32_t* residual, uint32_t num_samples,
+    const int32_t* parcor_coef, uint32_t order, int32_t* output)
+{
+  /* 引数チェック */
+  if (lpc == NULL || residual == NULL
+      || parcor_coef == NULL || output == NULL) {
+    return SLAPREDICTOR_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  /* 次数チェック */
+  if (order > lpc->max_order) {
+    return SLAPREDICTOR_APIRESULT_EXCEED_MAX_ORDER;
+  }
+
+  /* 16bit幅の誤差を保持していたら32bit幅に戻す */
+  SLALPCSynthesizer_WidenBackwardResidual(lpc);
+
+  /* 格子型フィルタによる音声合成 */
+  lpc->kernel_table->lpc_synthesize_int32(lpc->backward_residual,
+      residual, num_samples, parcor_coef, order, output);
+
+  return SLAPREDICTOR_APIRESULT_OK;
+}
+
+/* PARCOR係数により誤差信号から音声合成（16bit幅の後ろ向き誤差, 32bit整数入出力） */
+/* 途中で16bit幅を超えそうになったら、そのサンプル以降は32bit幅の合成に切り替える */
+SLAPredictorApiResult SLALPCSynthesizer_SynthesizeByParcorCoefInt16(
+    struct SLALPCSynthesizer* lpc,
+    const int32_t* residual, uint32_t num_samples,
+    const int32_t* parcor_coef, uint32_t order, int32_t* output)
+{
+  uint32_t ord, num_synthesized;
+
+  /* 引数チェック */
+  if (lpc == NULL || residual == NULL
+      || parcor_coef == NULL || output == NULL) {
+    return SLAPREDICTOR_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  /* 次数チェック */
+  if (order > lpc->max_order) {
+    return SLAPREDICTOR_APIRESULT_EXCEED_MAX_ORDER;
+  }
+
+  /* 既に32bit幅に切り替わっていれば32bit幅で合成 */
+  if (lpc->is_int16_residual == 0) {
+    return SLALPCSynthesizer_SynthesizeByParcorCoefInt32(lpc,
+        residual, num_samples, parcor_coef, order, output);
+  }
+
+  /* 係数を16bit幅に変換 */
+  for (ord = 0; ord < order + 1; ord++) {
+    /* 16bit幅に収まらない係数があれば32bit幅で合成 */
+    if ((parcor_coef[ord] > INT16_MAX) || (parcor_coef[ord] < INT16_MIN)) {
+      return SLALPCSynthesizer_SynthesizeByParcorCoefInt32(lpc,
+          residual, num_samples, parcor_coef, order, output);
+    }
+    lpc->parcor_coef_int16[ord] = (int16_t)parcor_coef[ord];
+  }
+
+  /* 16bit幅の格子型フィルタによる音声合成 */
+  num_synthesized = lpc->kernel_table->lpc_synthesize_int16(
+      lpc->backward_residual_int16, &lpc->backward_residual_int16_pos,
+      residual, num_samples, lpc->parcor_coef_int16, order, output);
+
+  /* 16bit幅を超えたサンプル以降は32bit幅で合成 */
+  if (num_synthesized < num_samples) {
+    return SLALPCSynthesizer_SynthesizeByParcorCoefInt32(lpc,
+        &residual[num_synthesized], num_samples - num_synthesized,
+        parcor_coef, order, &output[num_synthesized]);
+  }
+
+  return SLAPREDICTOR_APIRESULT_OK;
+}
+
+/* 格子型フィルタの1段分の合成 */
+/* 補足）次数固定版で使用。coef, back, forward_residual, halfは展開先の変数を参照 */
+#define SLALPCSYNTHESIZER_LATTICE_STEP(ord) {\
+  forward_residual += (int32_t)SLAUTILITY_SHIFT_RIGHT_ARITHMETIC(coef[(ord)] * back[(ord) - 1] + half, 15);\
+  back[(ord)] = back[(ord) - 1] - (int32_t)SLAUTILITY_SHIFT_RIGHT_ARITHMETIC(coef[(ord)] * forward_residual + half, 15);\
+}
+#define SLALPCSYNTHESIZER_LATTICE_STEP4(ord) \
+  SLALPCSYNTHESIZER_LATTICE_STEP((ord) + 3) SLALPCSYNTHESIZER_LATTICE_STEP((ord) + 2) \
+  SLALPCSYNTHESIZER_LATTICE_STEP((ord) + 1) SLALPCSYNTHESIZER_LATTICE_STEP((ord) + 0)
+#define SLALPCSYNTHESIZER_LATTICE_STEP8(ord) \
+  SLALPCSYNTHESIZER_LATTICE_STEP4((ord) + 4) SLALPCSYNTHESIZER_LATTICE_STEP4((ord) + 0)
+#define SLALPCSYNTHESIZER_LATTICE_STEP16(ord) \
+  SLALPCSYNTHESIZER_LATTICE_STEP8((ord) + 8) SLALPCSYNTHESIZER_LATTICE_STEP8((ord) + 0)
+#define SLALPCSYNTHESIZER_LATTICE_STEP32(ord) \
+  SLALPCSYNTHESIZER_LATTICE_STEP16((ord) + 16) SLALPCSYNTHESIZER_LATTICE_STEP16((ord) + 0)
+
+/* 次数固定のPARCOR係数による音声合成関数の定義（32bit整数入出力） */
+/* 補足）全段を展開し、係数と後ろ向き誤差はオート変数（レジスタ）に保持する */
+/* 　　　use_simd_kernelが1の次数は、ハンドルがSIMDの計算カーネルを持つ場合そちらで合成する */
+#define SLALPCSYNTHESIZER_DEFINE_SYNTHESIZE_INT32_FIXED_ORDER(order, lattice_steps, use_simd_kernel) \
+SLAPredictorApiResult SLALPCSynthesizer_SynthesizeByParcorCoefInt32Order##order(\
+    struct SLALPCSynthesizer* lpc,\
+    const int32_t* residual, uint32_t num_samples,\
+    const int32_t* parcor_coef, int32_t* output)\
+{\
+  uint32_t      ord, samp;\
+  int32_t       forward_residual;\
+  int32_t       coef[(order) + 1], back[(order) + 1];\
+  const int32_t half = (1UL << 14); /* 丸め誤差軽減のための加算定数 = 0.5 */\
+\
+  /* 引数チェック */\
+  if (lpc == NULL || residual == NULL\
+      || parcor_coef == NULL || output == NULL) {\
+    return SLAPREDICTOR_APIRESULT_INVALID_ARGUMENT;\
+  }\
+\
+  /* 次数チェック */\
+  if ((order) > lpc->max_order) {\
+    return SLAPREDICTOR_APIRESULT_EXCEED_MAX_ORDER;\
+  }\
+\
+  /* SIMDの計算カーネルの方が速い次数はカーネルで合成 */\
+  if ((use_simd_kernel) && (lpc->kernel_table->simd != SLA_SIMDINSTRUCTIONSET_NONE)) {\
+    return SLALPCSynthesizer_SynthesizeByParcorCoefInt32(lpc,\
+        residual, num_samples, parcor_coef, (order), output);\
+  }\
+\
+  /* 16bit幅の誤差を保持していたら32bit幅に戻す */\
+  SLALPCSynthesizer_WidenBackwardResidual(lpc);\
+\
+  /* 係数と後ろ向き誤差をオート変数に受ける */\
+  for (ord = 0; ord < (order) + 1; ord++) {\
+    coef[ord] = parcor_coef[ord];\
+    back[ord] = lpc->backward_residual[ord];\
+  }\
+\
+  /* 格子型フィルタによる音声合成 */\
+  for (samp = 0; samp < num_samples; samp++) {\
+    /* 誤差入力 */\
+    forward_residual = residual[samp];\
+    /* 高次から順に合成 */\
+    lattice_steps\
+    /* 合成信号 */\
+    output[samp] = forward_residual;\
+    /* 後ろ向き誤差計算部にデータ入力 */\
+    back[0] = forward_residual;\
+  }\
+\
+  /* 後ろ向き誤差を書き戻す */\
+  for (ord = 0; ord < (order) + 1; ord++) {\
+    lpc->backward_residual[ord] = back[ord];\
+  }\
+\
+  return SLAPREDICTOR_APIRESULT_OK;\
+}
+
+/* 次数固定のPARCOR係数による音声合成関数の実体 */
+/* 補足）8,16次は展開したスカラー実装がSSE4.1の計算カーネルより速く、32次は逆転する */
+SLALPCSYNTHESIZER_DEFINE_SYNTHESIZE_INT32_FIXED_ORDER(8,  SLALPCSYNTHESIZER_LATTICE_STEP8(1), 0)
+SLALPCSYNTHESIZER_DEFINE_SYNTHESIZE_INT32_FIXED_ORDER(16, SLALPCSYNTHESIZER_LATTICE_STEP16(1), 0)
+SLALPCSYNTHESIZER_DEFINE_SYNTHESIZE_INT32_FIXED_ORDER(32, SLALPCSYNTHESIZER_LATTICE_STEP32(1), 1)
+
+/* ロングターム計算ハンドルのワークサイズ計算 */
+int32_t SLALongTermCalculator_CalculateWorkSize(
     uint32_t fft_size, uint32_t max_pitch_period, 
     uint32_t max_num_pitch_candidates, uint32_t max_num_taps)
 {
-  uint32_t dim;
-  struct SLALongTermCalculator* ltm;
+  int32_t work_size;
+
+  SLAUTILITY_UNUSED_ARGUMENT(max_pitch_period);
 
   /* 2のべき乗数になっているかチェック */
   if (fft_size & (fft_size - 1)) {
+    return -1;
+  }
+
+  work_size = SLA_MEMORY_ALIGNMENT + SLAUTILITY_WORK_SIZE(sizeof(struct SLALongTermCalculator));
+  work_size += SLAUTILITY_WORK_SIZE(sizeof(double) * fft_size);
+  work_size += SLAUTILITY_WORK_SIZE(sizeof(uint32_t) * max_num_pitch_candidates);
+  work_size += SLALESolver_CalculateWorkSize(max_num_taps);
+  work_size += SLAUTILITY_WORK_SIZE(sizeof(double) * max_num_taps);
+  work_size += SLAUTILITY_WORK_SIZE(sizeof(double *) * max_num_taps);
+  work_size += (int32_t)max_num_taps * SLAUTILITY_WORK_SIZE(sizeof(double) * max_num_taps);
+
+  return work_size;
+}
+
+/* ロングターム計算ハンドルの作成（ワーク領域指定） */
+struct SLALongTermCalculator* SLALongTermCalculator_CreateWithWork(
+    uint32_t fft_size, uint32_t max_pitch_period, 
+    uint32_t max_num_pitch_candidates, uint32_t max_num_taps,
+    void* work, int32_t work_size)
+{
+  uint32_t dim;
+  int32_t lesolver_work_size, required_work_size;
+  uint8_t* work_ptr;
+  struct SLALongTermCalculator* ltm;
+
+  /* 引数チェック */
+  required_work_size = SLALongTermCalculator_CalculateWorkSize(
+      fft_size, max_pitch_period, max_num_pitch_candidates, max_num_taps);
+  if ((work == NULL) || (required_work_size < 0) || (work_size < required_work_size)) {
     return NULL;
   }
 
-  ltm = (struct SLALongTermCalculator *)malloc(sizeof(struct SLALongTermCalculator));
+  work_ptr = SLAUTILITY_ALIGN_WORK(work);
 
+  ltm = (struct SLALongTermCalculator *)SLAUtility_AllocateWork(&work_ptr, sizeof(struct SLALongTermCalculator));
+
+  ltm->alloced_by_own           = 0;
+  ltm->work                     = work;
   ltm->fft_size                 = fft_size;
-  ltm->auto_corr                = (double *)malloc(sizeof(double) * fft_size);
+  ltm->auto_corr                = (double *)SLAUtility_AllocateWork(&work_ptr, sizeof(double) * fft_size);
   ltm->max_num_pitch_candidates = max_num_pitch_candidates;
   ltm->max_pitch_period         = max_pitch_period;
-  ltm->pitch_candidate          = (uint32_t *)malloc(sizeof(uint32_t) * max_num_pitch_candidates);
+  ltm->pitch_candidate          = (uint32_t *)SLAUtility_AllocateWork(&work_ptr, sizeof(uint32_t) * max_num_pitch_candidates);
   ltm->max_num_taps             = max_num_taps;
-  ltm->lesolver                 = SLALESolver_Create(max_num_taps);
-  ltm->ltm_coef_vec             = (double *)malloc(sizeof(double) * max_num_taps);
-  ltm->R_mat                    = (double **)malloc(sizeof(double *) * max_num_taps);
+  lesolver_work_size            = SLALESolver_CalculateWorkSize(max_num_taps);
+  ltm->lesolver                 = SLALESolver_CreateWithWork(max_num_taps,
+      SLAUtility_AllocateWork(&work_ptr, (size_t)lesolver_work_size), lesolver_work_size);
+  ltm->ltm_coef_vec             = (double *)SLAUtility_AllocateWork(&work_ptr, sizeof(double) * max_num_taps);
+  ltm->R_mat                    = (double **)SLAUtility_AllocateWork(&work_ptr, sizeof(double *) * max_num_taps);
   for (dim = 0; dim < max_num_taps; dim++) {
-    ltm->R_mat[dim] = (double *)malloc(sizeof(double) * max_num_taps);
+    ltm->R_mat[dim] = (double *)SLAUtility_AllocateWork(&work_ptr, sizeof(double) * max_num_taps);
+  }
+
+  SLA_Assert((work_ptr - (uint8_t *)work) <= work_size);
+
+  return ltm;
+}
+
+/* ロングターム計算ハンドルの作成 */
+struct SLALongTermCalculator* SLALongTermCalculator_Create(
+    uint32_t fft_size, uint32_t max_pitch_period, 
+    uint32_t max_num_pitch_candidates, uint32_t max_num_taps)
+{
+  int32_t work_size;
+  void* work;
+  struct SLALongTermCalculator* ltm;
+
+  if ((work_size = SLALongTermCalculator_CalculateWorkSize(
+          fft_size, max_pitch_period, max_num_pitch_candidates, max_num_taps)) < 0) {
+    return NULL;
+  }
+
+  work = malloc((size_t)work_size);
+  if ((ltm = SLALongTermCalculator_CreateWithWork(
+          fft_size, max_pitch_period, max_num_pitch_candidates, max_num_taps, work, work_size)) == NULL) {
+    NULLCHECK_AND_FREE(work);
+    return NULL;
   }
+  ltm->alloced_by_own = 1;
 
   return ltm;
 }
@@ -773,17 +1510,8 @@ struct SLALongTermCalculator* SLALongTermCalculator_Create(
 /* ロングターム計算ハンドルの破棄 */
 void SLALongTermCalculator_Destroy(struct SLALongTermCalculator* ltm_calculator)
 {
-  if (ltm_calculator != NULL) {
-    uint32_t dim;
-    NULLCHECK_AND_FREE(ltm_calculator->auto_corr);
-    NULLCHECK_AND_FREE(ltm_calculator->pitch_candidate);
-    SLALESolver_Destroy(ltm_calculator->lesolver);
-    NULLCHECK_AND_FREE(ltm_calculator->ltm_coef_vec);
-    for (dim = 0; dim < ltm_calculator->max_num_taps; dim++) {
-      NULLCHECK_AND_FREE(ltm_calculator->R_mat[dim]);
-    }
-    NULLCHECK_AND_FREE(ltm_calculator->R_mat);
-    free(ltm_calculator);
+  if ((ltm_calculator != NULL) && ltm_calculator->alloced_by_own) {
+    free(ltm_calculator->work);
   }
 }
 
@@ -979,33 +1707,74 @@ SLAPredictorApiResult SLALongTermCalculator_CalculateCoef(
   return SLAPREDICTOR_APIRESULT_OK;
 }
 
-/* ロングターム予測合成ハンドル作成 */
-struct SLALongTermSynthesizer* SLALongTermSynthesizer_Create(uint32_t max_num_taps, uint32_t max_pitch_period)
+/* ロングターム予測合成ハンドルのワークサイズ計算 */
+int32_t SLALongTermSynthesizer_CalculateWorkSize(uint32_t max_num_taps, uint32_t max_pitch_period)
+{
+  int32_t work_size;
+
+  work_size = SLA_MEMORY_ALIGNMENT + SLAUTILITY_WORK_SIZE(sizeof(struct SLALongTermSynthesizer));
+  work_size += SLAUTILITY_WORK_SIZE(sizeof(int32_t) * 2 * (max_num_taps + max_pitch_period));
+
+  return work_size;
+}
+
+/* ロングターム予測合成ハンドル作成（ワーク領域指定） */
+struct SLALongTermSynthesizer* SLALongTermSynthesizer_CreateWithWork(
+    uint32_t max_num_taps, uint32_t max_pitch_period, void* work, int32_t work_size)
 {
   struct SLALongTermSynthesizer* ltm;
   uint32_t tmp_buffer_size;
+  uint8_t* work_ptr;
+
+  /* 引数チェック */
+  if ((work == NULL) || (work_size < SLALongTermSynthesizer_CalculateWorkSize(max_num_taps, max_pitch_period))) {
+    return NULL;
+  }
+
+  work_ptr = SLAUTILITY_ALIGN_WORK(work);
 
-  ltm = malloc(sizeof(struct SLALongTermSynthesizer));
+  ltm = (struct SLALongTermSynthesizer *)SLAUtility_AllocateWork(&work_ptr, sizeof(struct SLALongTermSynthesizer));
+  ltm->alloced_by_own = 0;
+  ltm->work           = work;
   
   /* 計算効率化のために2倍確保 */
   tmp_buffer_size         = 2 * (max_num_taps + max_pitch_period);
   ltm->signal_buffer_size = tmp_buffer_size;
-  ltm->signal_buffer      = (int32_t *)malloc(sizeof(int32_t) * tmp_buffer_size);
+  ltm->signal_buffer      = (int32_t *)SLAUtility_AllocateWork(&work_ptr, sizeof(int32_t) * tmp_buffer_size);
+
+  SLA_Assert((work_ptr - (uint8_t *)work) <= work_size);
   
   if (SLALongTermSynthesizer_Reset(ltm) != SLAPREDICTOR_APIRESULT_OK) {
-    free(ltm->signal_buffer);
-    free(ltm);
     return NULL;
   }
 
   return ltm;
 }
 
+/* ロングターム予測合成ハンドル作成 */
+struct SLALongTermSynthesizer* SLALongTermSynthesizer_Create(uint32_t max_num_taps, uint32_t max_pitch_period)
+{
+  int32_t work_size;
+  void* work;
+  struct SLALongTermSynthesizer* ltm;
+
+  work_size = SLALongTermSynthesizer_CalculateWorkSize(max_num_taps, max_pitch_period);
+  work = malloc((size_t)work_size);
+  if ((ltm = SLALongTermSynthesizer_CreateWithWork(max_num_taps, max_pitch_period, work, work_size)) == NULL) {
+    NULLCHECK_AND_FREE(work);
+    return NULL;
+  }
+  ltm->alloced_by_own = 1;
+
+  return ltm;
+}
+
 /* ロングターム予測合成ハンドル破棄 */
 void SLALongTermSynthesizer_Destroy(struct SLALongTermSynthesizer* ltm)
 {
-  NULLCHECK_AND_FREE(ltm->signal_buffer);
-  NULLCHECK_AND_FREE(ltm);
+  if ((ltm != NULL) && ltm->alloced_by_own) {
+    free(ltm->work);
+  }
 }
 
 /* ロングターム予測合成ハンドルリセット */
@@ -1129,45 +1898,143 @@ SLAPredictorApiResult SLALongTermSynthesizer_SynthesizeInt32(
       residual, num_samples, pitch_period, ltm_coef, num_taps, output, 0);
 }
 
-/* LMS計算ハンドルの作成 */
-struct SLALMSFilter* SLALMSFilter_Create(uint32_t max_num_coef)
+/* タップ数固定のロングターム誤差信号からの音声合成関数の定義 */
+/* 補足）予測/合成が始まるまでのバッファリング中は汎用関数で合成する */
+#define SLALONGTERMSYNTHESIZER_DEFINE_SYNTHESIZE_INT32_FIXED_TAPS(num_taps) \
+SLAPredictorApiResult SLALongTermSynthesizer_SynthesizeInt32Taps##num_taps(\
+    struct SLALongTermSynthesizer* ltm,\
+    const int32_t* residual, uint32_t num_samples,\
+    uint32_t pitch_period, const int32_t* ltm_coef, int32_t* output)\
+{\
+  uint32_t        smpl, j;\
+  const int32_t   half = (1UL << 30); /* 丸め用定数(0.5) */\
+  int64_t         predict;\
+  const uint32_t  max_delay = pitch_period + ((num_taps) >> 1);\
+  uint32_t        buffer_pos;\
+  int32_t*        signal_buffer;\
+  int32_t         coef[(num_taps)];\
+\
+  /* 引数チェック */\
+  if ((ltm == NULL) || (residual == NULL) || (ltm_coef == NULL) || (output == NULL)) {\
+    return SLAPREDICTOR_APIRESULT_INVALID_ARGUMENT;\
+  }\
+\
+  /* ピッチ周期0またはバッファリング中は汎用関数で処理 */\
+  if ((pitch_period == 0) || (ltm->num_input_samples < max_delay)) {\
+    return SLALongTermSynthesizer_SynthesizeInt32(ltm,\
+        residual, num_samples, pitch_period, ltm_coef, (num_taps), output);\
+  }\
+\
+  /* 頻繁に参照する変数をオート変数に受ける */\
+  signal_buffer = ltm->signal_buffer;\
+  buffer_pos    = ltm->signal_buffer_pos;\
+  for (j = 0; j < (num_taps); j++) {\
+    coef[j] = ltm_coef[j];\
+  }\
+\
+  /* ロングターム合成 */\
+  for (smpl = 0; smpl < num_samples; smpl++) {\
+    predict = half;\
+    for (j = 0; j < (num_taps); j++) {\
+      predict += (int64_t)coef[j] * signal_buffer[buffer_pos + max_delay - 1 - j];\
+    }\
+    predict = SLAUTILITY_SHIFT_RIGHT_ARITHMETIC(predict, 31);\
+\
+    /* 出力計算 */\
+    output[smpl] = residual[smpl] + (int32_t)predict;\
+\
+    /* バッファ更新 */\
+    buffer_pos = (buffer_pos == 0) ? (max_delay - 1) : (buffer_pos - 1);\
+    signal_buffer[buffer_pos]\
+      = signal_buffer[buffer_pos + max_delay]\
+      = output[smpl];\
+  }\
+\
+  /* バッファ参照位置を記録 */\
+  ltm->signal_buffer_pos = buffer_pos;\
+\
+  /* 入力サンプル数を増加 */\
+  ltm->num_input_samples += num_samples;\
+\
+  return SLAPREDICTOR_APIRESULT_OK;\
+}
+
+/* タップ数固定のロングターム誤差信号からの音声合成関数の実体 */
+SLALONGTERMSYNTHESIZER_DEFINE_SYNTHESIZE_INT32_FIXED_TAPS(1)
+SLALONGTERMSYNTHESIZER_DEFINE_SYNTHESIZE_INT32_FIXED_TAPS(3)
+
+/* LMS計算ハンドルのワークサイズ計算 */
+int32_t SLALMSFilter_CalculateWorkSize(uint32_t max_num_coef)
+{
+  int32_t work_size;
+
+  work_size = SLA_MEMORY_ALIGNMENT + SLAUTILITY_WORK_SIZE(sizeof(struct SLALMSFilter));
+  work_size += 2 * SLAUTILITY_WORK_SIZE(sizeof(int32_t) * max_num_coef);      /* 係数 */
+  work_size += 4 * SLAUTILITY_WORK_SIZE(sizeof(int32_t) * 2 * max_num_coef);  /* 信号/符号バッファ */
+
+  return work_size;
+}
+
+/* LMS計算ハンドルの作成（ワーク領域指定） */
+struct SLALMSFilter* SLALMSFilter_CreateWithWork(uint32_t max_num_coef, void* work, int32_t work_size)
 {
   struct SLALMSFilter* nlms;
+  uint8_t* work_ptr;
+
+  /* 引数チェック */
+  if ((work == NULL) || (work_size < SLALMSFilter_CalculateWorkSize(max_num_coef))) {
+    return NULL;
+  }
 
-  nlms = malloc(sizeof(struct SLALMSFilter));
+  work_ptr = SLAUTILITY_ALIGN_WORK(work);
+
+  nlms = (struct SLALMSFilter *)SLAUtility_AllocateWork(&work_ptr, sizeof(struct SLALMSFilter));
+  nlms->alloced_by_own          = 0;
+  nlms->work                    = work;
   nlms->max_num_coef            = max_num_coef;
   nlms->signal_sign_buffer_size = SLAUTILITY_ROUNDUP2POWERED(max_num_coef);
+  nlms->kernel_table            = SLAPredictor_GetCurrentKernelTable();
 
-  nlms->fir_coef                = malloc(sizeof(int32_t) * max_num_coef);
-  nlms->iir_coef                = malloc(sizeof(int32_t) * max_num_coef);
+  nlms->fir_coef                = (int32_t *)SLAUtility_AllocateWork(&work_ptr, sizeof(int32_t) * max_num_coef);
+  nlms->iir_coef                = (int32_t *)SLAUtility_AllocateWork(&work_ptr, sizeof(int32_t) * max_num_coef);
   /* バッファアクセスの高速化のため2倍確保 */
-  nlms->fir_sign_buffer         = malloc(sizeof(int32_t) * 2 * max_num_coef);
-  nlms->iir_sign_buffer         = malloc(sizeof(int32_t) * 2 * max_num_coef);
-  nlms->fir_buffer              = malloc(sizeof(int32_t) * 2 * max_num_coef);
-  nlms->iir_buffer              = malloc(sizeof(int32_t) * 2 * max_num_coef);
+  nlms->fir_sign_buffer         = (int32_t *)SLAUtility_AllocateWork(&work_ptr, sizeof(int32_t) * 2 * max_num_coef);
+  nlms->iir_sign_buffer         = (int32_t *)SLAUtility_AllocateWork(&work_ptr, sizeof(int32_t) * 2 * max_num_coef);
+  nlms->fir_buffer              = (int32_t *)SLAUtility_AllocateWork(&work_ptr, sizeof(int32_t) * 2 * max_num_coef);
+  nlms->iir_buffer              = (int32_t *)SLAUtility_AllocateWork(&work_ptr, sizeof(int32_t) * 2 * max_num_coef);
+
+  SLA_Assert((work_ptr - (uint8_t *)work) <= work_size);
 
   if (SLALMSFilter_Reset(nlms) != SLAPREDICTOR_APIRESULT_OK) {
-    free(nlms->fir_coef); free(nlms->iir_coef);
-    free(nlms->fir_sign_buffer); free(nlms->iir_sign_buffer);
-    free(nlms->fir_buffer); free(nlms->iir_buffer);
-    free(nlms);
     return NULL;
   }
 
   return nlms;
 }
 
+/* LMS計算ハンドルの作成 */
+struct SLALMSFilter* SLALMSFilter_Create(uint32_t max_num_coef)
+{
+  int32_t work_size;
+  void* work;
+  struct SLALMSFilter* nlms;
+
+  work_size = SLALMSFilter_CalculateWorkSize(max_num_coef);
+  work = malloc((size_t)work_size);
+  if ((nlms = SLALMSFilter_CreateWithWork(max_num_coef, work, work_size)) == NULL) {
+    NULLCHECK_AND_FREE(work);
+    return NULL;
+  }
+  nlms->alloced_by_own = 1;
+
+  return nlms;
+}
+
 /* LMS計算ハンドルの破棄 */
 void SLALMSFilter_Destroy(struct SLALMSFilter* nlms)
 {
-  if (nlms != NULL) {
-    NULLCHECK_AND_FREE(nlms->fir_coef);
-    NULLCHECK_AND_FREE(nlms->iir_coef);
-    NULLCHECK_AND_FREE(nlms->fir_sign_buffer);
-    NULLCHECK_AND_FREE(nlms->iir_sign_buffer);
-    NULLCHECK_AND_FREE(nlms->fir_buffer);
-    NULLCHECK_AND_FREE(nlms->iir_buffer);
-    free(nlms);
+  if ((nlms != NULL) && nlms->alloced_by_own) {
+    free(nlms->work);
   }
 }
 
@@ -1258,18 +2125,9 @@ SLAPredictorApiResult SLALMSFilter_PredictInt32(
   for (; smpl < num_samples; smpl++) {
     /* 予測 */
     predict = (int32_t)(1 << 9);  /* 丸め誤差回避 */
-    for (i = 0; i < num_coef; i++) {
-      /* FIRフィルタ予測 */
-      predict += nlms->fir_coef[i] * nlms->fir_buffer[buffer_pos + i];
-      /* オーバーフローチェック */
-      SLA_Assert(SLAUTILITY_SHIFT_RIGHT_ARITHMETIC((int64_t)nlms->fir_coef[i] * nlms->fir_buffer[buffer_pos + i], 10) <= (int64_t)INT32_MAX);
-      SLA_Assert(SLAUTILITY_SHIFT_RIGHT_ARITHMETIC((int64_t)nlms->fir_coef[i] * nlms->fir_buffer[buffer_pos + i], 10) >= (int64_t)INT32_MIN);
-      /* IIRフィルタ予測 */
-      predict += nlms->iir_coef[i] * nlms->iir_buffer[buffer_pos + i];
-      /* オーバーフローチェック */
-      SLA_Assert(SLAUTILITY_SHIFT_RIGHT_ARITHMETIC((int64_t)nlms->iir_coef[i] * nlms->iir_buffer[buffer_pos + i], 10) <= (int64_t)INT32_MAX);
-      SLA_Assert(SLAUTILITY_SHIFT_RIGHT_ARITHMETIC((int64_t)nlms->iir_coef[i] * nlms->iir_buffer[buffer_pos + i], 10) >= (int64_t)INT32_MIN);
-    }
+    predict += nlms->kernel_table->lms_calculate_predict(
+        nlms->fir_coef, &nlms->fir_buffer[buffer_pos],
+        nlms->iir_coef, &nlms->iir_buffer[buffer_pos], num_coef);
     predict = SLAUTILITY_SHIFT_RIGHT_ARITHMETIC(predict, 10);
 
     /* 出力計算 / 残差テーブルの参照をセット */
@@ -1390,18 +2248,9 @@ SLAPredictorApiResult SLALMSFilter_SynthesizeInt32(
   for (; smpl < num_samples; smpl++) {
     /* 予測 */
     predict = (int32_t)(1 << 9);  /* 丸め誤差回避 */
-    for (i = 0; i < num_coef; i++) {
-      /* FIRフィルタ予測 */
-      predict += nlms->fir_coef[i] * nlms->fir_buffer[buffer_pos + i];
-      /* オーバーフローチェック */
-      SLA_Assert(SLAUTILITY_SHIFT_RIGHT_ARITHMETIC((int64_t)nlms->fir_coef[i] * nlms->fir_buffer[buffer_pos + i], 10) <= (int64_t)INT32_MAX);
-      SLA_Assert(SLAUTILITY_SHIFT_RIGHT_ARITHMETIC((int64_t)nlms->fir_coef[i] * nlms->fir_buffer[buffer_pos + i], 10) >= (int64_t)INT32_MIN);
-      /* IIRフィルタ予測 */
-      predict += nlms->iir_coef[i] * nlms->iir_buffer[buffer_pos + i];
-      /* オーバーフローチェック */
-      SLA_Assert(SLAUTILITY_SHIFT_RIGHT_ARITHMETIC((int64_t)nlms->iir_coef[i] * nlms->iir_buffer[buffer_pos + i], 10) <= (int64_t)INT32_MAX);
-      SLA_Assert(SLAUTILITY_SHIFT_RIGHT_ARITHMETIC((int64_t)nlms->iir_coef[i] * nlms->iir_buffer[buffer_pos + i], 10) >= (int64_t)INT32_MIN);
-    }
+    predict += nlms->kernel_table->lms_calculate_predict(
+        nlms->fir_coef, &nlms->fir_buffer[buffer_pos],
+        nlms->iir_coef, &nlms->iir_buffer[buffer_pos], num_coef);
     predict = SLAUTILITY_SHIFT_RIGHT_ARITHMETIC(predict, 10);
 
     /* 出力計算 / 残差テーブルの参照をセット */
@@ -1462,6 +2311,101 @@ SLAPredictorApiResult SLALMSFilter_SynthesizeInt32(
   return SLAPREDICTOR_APIRESULT_OK;
 }
 
+/* 次数固定のLMS合成関数の定義 */
+/* 補足）係数・遅延信号・符号はオート変数（レジスタ）に保持し、遅延はシフトで表現する */
+/* 　　　予測/合成が始まるまでのバッファリング中は汎用関数で合成する */
+#define SLALMSFILTER_DEFINE_SYNTHESIZE_INT32_FIXED_ORDER(num_coef) \
+SLAPredictorApiResult SLALMSFilter_SynthesizeInt32Order##num_coef(\
+    struct SLALMSFilter* nlms,\
+    const int32_t* residual, uint32_t num_samples, int32_t* output)\
+{\
+  uint32_t        smpl, i, pos;\
+  int32_t         predict;\
+  const int32_t*  delta_table_p;\
+  int32_t         fir_coef[(num_coef)], iir_coef[(num_coef)];\
+  int32_t         fir_buffer[(num_coef)], iir_buffer[(num_coef)];\
+  int32_t         fir_sign[(num_coef)], iir_sign[(num_coef)];\
+\
+  /* 引数チェック */\
+  if ((nlms == NULL) || (residual == NULL) || (output == NULL)) {\
+    return SLAPREDICTOR_APIRESULT_INVALID_ARGUMENT;\
+  }\
+\
+  /* 次数チェック */\
+  if ((num_coef) > nlms->max_num_coef) {\
+    return SLAPREDICTOR_APIRESULT_EXCEED_MAX_ORDER;\
+  }\
+\
+  /* バッファリング中は汎用関数で合成 */\
+  if (nlms->num_input_samples < (num_coef)) {\
+    return SLALMSFilter_SynthesizeInt32(nlms, (num_coef), residual, num_samples, output);\
+  }\
+\
+  /* 状態をオート変数に受ける */\
+  for (i = 0; i < (num_coef); i++) {\
+    fir_coef[i]   = nlms->fir_coef[i];\
+    iir_coef[i]   = nlms->iir_coef[i];\
+    fir_buffer[i] = nlms->fir_buffer[nlms->buffer_pos + i];\
+    iir_buffer[i] = nlms->iir_buffer[nlms->buffer_pos + i];\
+    fir_sign[i]   = nlms->fir_sign_buffer[nlms->buffer_pos + i];\
+    iir_sign[i]   = nlms->iir_sign_buffer[nlms->buffer_pos + i];\
+  }\
+\
+  /* フィルタ処理実行 */\
+  for (smpl = 0; smpl < num_samples; smpl++) {\
+    /* 予測 */\
+    predict = (int32_t)(1 << 9);  /* 丸め誤差回避 */\
+    for (i = 0; i < (num_coef); i++) {\
+      predict += fir_coef[i] * fir_buffer[i];\
+      predict += iir_coef[i] * iir_buffer[i];\
+    }\
+    predict = SLAUTILITY_SHIFT_RIGHT_ARITHMETIC(predict, 10);\
+\
+    /* 出力計算 / 残差テーブルの参照をセット */\
+    delta_table_p = logsignlms_delta_table[SLALMS_SIGNED_LOG2CEIL(residual[smpl]) + 32];\
+    output[smpl]  = residual[smpl] + predict;\
+\
+    /* 係数更新 */\
+    for (i = 0; i < (num_coef); i++) {\
+      fir_coef[i] += delta_table_p[fir_sign[i]];\
+      iir_coef[i] += delta_table_p[iir_sign[i]];\
+    }\
+\
+    /* 遅延信号と符号をシフトして記録 */\
+    for (i = (num_coef) - 1; i > 0; i--) {\
+      fir_buffer[i] = fir_buffer[i - 1];\
+      iir_buffer[i] = iir_buffer[i - 1];\
+      fir_sign[i]   = fir_sign[i - 1];\
+      iir_sign[i]   = iir_sign[i - 1];\
+    }\
+    fir_buffer[0] = output[smpl];\
+    iir_buffer[0] = predict;\
+    fir_sign[0]   = SLAUTILITY_SIGN(output[smpl]) + 1;\
+    iir_sign[0]   = SLAUTILITY_SIGN(predict) + 1;\
+  }\
+\
+  /* 状態を書き戻す（リングバッファの形式に戻す） */\
+  nlms->buffer_pos = (nlms->buffer_pos - num_samples) & ((num_coef) - 1);\
+  for (i = 0; i < (num_coef); i++) {\
+    nlms->fir_coef[i] = fir_coef[i];\
+    nlms->iir_coef[i] = iir_coef[i];\
+    pos = (nlms->buffer_pos + i) & ((num_coef) - 1);\
+    nlms->fir_buffer[pos]      = nlms->fir_buffer[pos + (num_coef)]      = fir_buffer[i];\
+    nlms->iir_buffer[pos]      = nlms->iir_buffer[pos + (num_coef)]      = iir_buffer[i];\
+    nlms->fir_sign_buffer[pos] = nlms->fir_sign_buffer[pos + (num_coef)] = fir_sign[i];\
+    nlms->iir_sign_buffer[pos] = nlms->iir_sign_buffer[pos + (num_coef)] = iir_sign[i];\
+  }\
+\
+  /* 入力サンプル数増加 */\
+  nlms->num_input_samples += num_samples;\
+\
+  return SLAPREDICTOR_APIRESULT_OK;\
+}
+
+/* 次数固定のLMS合成関数の実体 */
+SLALMSFILTER_DEFINE_SYNTHESIZE_INT32_FIXED_ORDER(4)
+SLALMSFILTER_DEFINE_SYNTHESIZE_INT32_FIXED_ORDER(8)
+
 /* 最大分割数計算 */
 /* 用語 "ノード" が外に出るのを嫌ったため関数化 */
 uint32_t SLAOptimalEncodeEstimator_CalculateMaxNumPartitions(
@@ -1470,19 +2414,51 @@ uint32_t SLAOptimalEncodeEstimator_CalculateMaxNumPartitions(
   return SLAOPTIMALENCODEESTIMATOR_CALCULATE_NUM_NODES(max_num_samples, delta_num_samples);
 }
 
-/* 探索ハンドルの作成 */
-struct SLAOptimalBlockPartitionEstimator* SLAOptimalEncodeEstimator_Create(
+/* 探索ハンドルのワークサイズ計算 */
+int32_t SLAOptimalEncodeEstimator_CalculateWorkSize(
     uint32_t max_num_samples, uint32_t delta_num_samples)
+{
+  int32_t work_size;
+  uint32_t tmp_max_num_nodes;
+
+  /* 引数チェック */
+  if ((delta_num_samples == 0) || (max_num_samples < delta_num_samples)) {
+    return -1;
+  }
+
+  tmp_max_num_nodes 
+    = SLAOPTIMALENCODEESTIMATOR_CALCULATE_NUM_NODES(max_num_samples, delta_num_samples);
+
+  work_size = SLA_MEMORY_ALIGNMENT + SLAUTILITY_WORK_SIZE(sizeof(struct SLAOptimalBlockPartitionEstimator));
+  work_size += SLAUTILITY_WORK_SIZE(sizeof(double *) * tmp_max_num_nodes);
+  work_size += SLAUTILITY_WORK_SIZE(sizeof(double) * tmp_max_num_nodes);
+  work_size += SLAUTILITY_WORK_SIZE(sizeof(uint32_t) * tmp_max_num_nodes);
+  work_size += SLAUTILITY_WORK_SIZE(sizeof(uint8_t) * tmp_max_num_nodes);
+  work_size += (int32_t)tmp_max_num_nodes * SLAUTILITY_WORK_SIZE(sizeof(double) * tmp_max_num_nodes);
+
+  return work_size;
+}
+
+/* 探索ハンドルの作成（ワーク領域指定） */
+struct SLAOptimalBlockPartitionEstimator* SLAOptimalEncodeEstimator_CreateWithWork(
+    uint32_t max_num_samples, uint32_t delta_num_samples, void* work, int32_t work_size)
 {
   uint32_t i, tmp_max_num_nodes;
+  int32_t required_work_size;
+  uint8_t* work_ptr;
   struct SLAOptimalBlockPartitionEstimator* oee;
 
   /* 引数チェック */
-  if (max_num_samples < delta_num_samples) {
+  required_work_size = SLAOptimalEncodeEstimator_CalculateWorkSize(max_num_samples, delta_num_samples);
+  if ((work == NULL) || (required_work_size < 0) || (work_size < required_work_size)) {
     return NULL;
   }
 
-  oee = malloc(sizeof(struct SLAOptimalBlockPartitionEstimator));
+  work_ptr = SLAUTILITY_ALIGN_WORK(work);
+
+  oee = (struct SLAOptimalBlockPartitionEstimator *)SLAUtility_AllocateWork(&work_ptr, sizeof(struct SLAOptimalBlockPartitionEstimator));
+  oee->alloced_by_own = 0;
+  oee->work           = work;
 
   /* 最大ノード数の計算 */
   tmp_max_num_nodes 
@@ -1490,30 +2466,46 @@ struct SLAOptimalBlockPartitionEstimator* SLAOptimalEncodeEstimator_Create(
   oee->max_num_nodes = tmp_max_num_nodes;
 
   /* 領域確保 */
-  oee->adjacency_matrix = (double **)malloc(sizeof(double *) * tmp_max_num_nodes);
-  oee->cost             = (double *)malloc(sizeof(double) * tmp_max_num_nodes);
-  oee->path             = (uint32_t *)malloc(sizeof(uint32_t) * tmp_max_num_nodes);
-  oee->used_flag        = (uint8_t *)malloc(sizeof(uint8_t) * tmp_max_num_nodes);
+  oee->adjacency_matrix = (double **)SLAUtility_AllocateWork(&work_ptr, sizeof(double *) * tmp_max_num_nodes);
+  oee->cost             = (double *)SLAUtility_AllocateWork(&work_ptr, sizeof(double) * tmp_max_num_nodes);
+  oee->path             = (uint32_t *)SLAUtility_AllocateWork(&work_ptr, sizeof(uint32_t) * tmp_max_num_nodes);
+  oee->used_flag        = (uint8_t *)SLAUtility_AllocateWork(&work_ptr, sizeof(uint8_t) * tmp_max_num_nodes);
   for (i = 0; i < tmp_max_num_nodes; i++) {
-    oee->adjacency_matrix[i] = (double *)malloc(sizeof(double) * tmp_max_num_nodes);
+    oee->adjacency_matrix[i] = (double *)SLAUtility_AllocateWork(&work_ptr, sizeof(double) * tmp_max_num_nodes);
   }
 
+  SLA_Assert((work_ptr - (uint8_t *)work) <= work_size);
+
   return oee;
 }
 
 /* 探索ハンドルの作成 */
+struct SLAOptimalBlockPartitionEstimator* SLAOptimalEncodeEstimator_Create(
+    uint32_t max_num_samples, uint32_t delta_num_samples)
+{
+  int32_t work_size;
+  void* work;
+  struct SLAOptimalBlockPartitionEstimator* oee;
+
+  if ((work_size = SLAOptimalEncodeEstimator_CalculateWorkSize(max_num_samples, delta_num_samples)) < 0) {
+    return NULL;
+  }
+
+  work = malloc((size_t)work_size);
+  if ((oee = SLAOptimalEncodeEstimator_CreateWithWork(max_num_samples, delta_num_samples, work, work_size)) == NULL) {
+    NULLCHECK_AND_FREE(work);
+    return NULL;
+  }
+  oee->alloced_by_own = 1;
+
+  return oee;
+}
+
+/* 探索ハンドルの破棄 */
 void SLAOptimalEncodeEstimator_Destroy(struct SLAOptimalBlockPartitionEstimator* oee)
 {
-  uint32_t i;
-  if (oee != NULL) {
-    for (i = 0; i < oee->max_num_nodes; i++) {
-      NULLCHECK_AND_FREE(oee->adjacency_matrix[i]);
-    }
-    NULLCHECK_AND_FREE(oee->adjacency_matrix);
-    NULLCHECK_AND_FREE(oee->cost);
-    NULLCHECK_AND_FREE(oee->path);
-    NULLCHECK_AND_FREE(oee->used_flag);
-    NULLCHECK_AND_FREE(oee);
+  if ((oee != NULL) && oee->alloced_by_own) {
+    free(oee->work);
   }
 }
 
@@ -1704,25 +2696,60 @@ SLAPredictorApiResult SLAOptimalEncodeEstimator_SearchOptimalBlockPartitions(
   return SLAPREDICTOR_APIRESULT_OK;
 }
 
-/* エンファシスフィルタの作成 */
-struct SLAEmphasisFilter* SLAEmphasisFilter_Create(void)
+/* エンファシスフィルタのワークサイズ計算 */
+int32_t SLAEmphasisFilter_CalculateWorkSize(void)
+{
+  return SLA_MEMORY_ALIGNMENT + SLAUTILITY_WORK_SIZE(sizeof(struct SLAEmphasisFilter));
+}
+
+/* エンファシスフィルタの作成（ワーク領域指定） */
+struct SLAEmphasisFilter* SLAEmphasisFilter_CreateWithWork(void* work, int32_t work_size)
 {
   struct SLAEmphasisFilter* emp;
+  uint8_t* work_ptr;
+
+  /* 引数チェック */
+  if ((work == NULL) || (work_size < SLAEmphasisFilter_CalculateWorkSize())) {
+    return NULL;
+  }
 
-  emp = (struct SLAEmphasisFilter *)malloc(sizeof(struct SLAEmphasisFilter));
+  work_ptr = SLAUTILITY_ALIGN_WORK(work);
+
+  emp = (struct SLAEmphasisFilter *)SLAUtility_AllocateWork(&work_ptr, sizeof(struct SLAEmphasisFilter));
+  emp->alloced_by_own = 0;
+  emp->work           = work;
 
   if (SLAEmphasisFilter_Reset(emp) != SLAPREDICTOR_APIRESULT_OK) {
-    free(emp);
     return NULL;
   }
 
   return emp;
 }
 
+/* エンファシスフィルタの作成 */
+struct SLAEmphasisFilter* SLAEmphasisFilter_Create(void)
+{
+  int32_t work_size;
+  void* work;
+  struct SLAEmphasisFilter* emp;
+
+  work_size = SLAEmphasisFilter_CalculateWorkSize();
+  work = malloc((size_t)work_size);
+  if ((emp = SLAEmphasisFilter_CreateWithWork(work, work_size)) == NULL) {
+    NULLCHECK_AND_FREE(work);
+    return NULL;
+  }
+  emp->alloced_by_own = 1;
+
+  return emp;
+}
+
 /* エンファシスフィルタの破棄 */
 void SLAEmphasisFilter_Destroy(struct SLAEmphasisFilter* emp)
 {
-  NULLCHECK_AND_FREE(emp);
+  if ((emp != NULL) && emp->alloced_by_own) {
+    free(emp->work);
+  }
 }
 
 /* エンファシスフィルタのリセット */
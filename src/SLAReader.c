@@ -0,0 +1,459 @@
+/* メモリマップにPOSIXの機能を使う */
+#if !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+#include "SLAReader.h"
+#include "SLAUtility.h"
+#include "SLAByteArray.h"
+#include "SLAInternal.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* メモリマップが使える環境か */
+#if !defined(SLAREADER_DISABLE_MMAP) && (defined(__unix__) || defined(__APPLE__))
+#define SLAREADER_USE_MMAP
+#endif
+
+#if defined(SLAREADER_USE_MMAP)
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/* 索引ファイルの拡張子 */
+#define SLAREADER_INDEX_FILE_EXTENSION  ".slaidx"
+/* ブロック索引の初期エントリ数（ヘッダにブロック数がない場合） */
+#define SLAREADER_INITIAL_NUM_ENTRIES   256
+
+/* SLAファイル読み込みハンドル */
+struct SLAReader {
+  struct SLADecoder*          decoder;
+  struct SLAHeaderInfo        header;
+  const uint8_t*              data;               /* ファイル全体のデータ                 */
+  uint64_t                    data_size;          /* ファイルサイズ                       */
+  uint8_t                     is_mapped;          /* メモリマップしているか               */
+  struct SLABlockIndexEntry*  entries;            /* ブロック索引                         */
+  uint32_t                    num_entries;        /* 作成済みのエントリ数                 */
+  uint32_t                    max_num_entries;    /* エントリ領域の大きさ                 */
+  uint64_t                    next_data_offset;   /* 次に辿るブロックの位置               */
+  uint64_t                    next_sample_offset; /* 次に辿るブロックの先頭サンプル位置   */
+  uint8_t                     is_index_complete;  /* 全ブロックの索引を作成済みか         */
+};
+
+/* ファイル全体をメモリマップ */
+static SLAApiResult SLAReader_MapFile(struct SLAReader* reader, const char* filename)
+{
+#if defined(SLAREADER_USE_MMAP)
+  int fd;
+  struct stat fstat_buf;
+  void* ptr;
+
+  if ((fd = open(filename, O_RDONLY)) < 0) {
+    return SLA_APIRESULT_NG;
+  }
+  /* 空ファイル・アドレス空間に収まらないファイルはマップしない */
+  if ((fstat(fd, &fstat_buf) != 0) || (fstat_buf.st_size <= 0)
+      || ((uint64_t)fstat_buf.st_size > (uint64_t)((size_t)-1))) {
+    close(fd);
+    return SLA_APIRESULT_NG;
+  }
+  ptr = mmap(NULL, (size_t)fstat_buf.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  /* マップ後はファイル記述子は不要 */
+  close(fd);
+  if (ptr == MAP_FAILED) {
+    return SLA_APIRESULT_NG;
+  }
+
+  reader->data      = (const uint8_t *)ptr;
+  reader->data_size = (uint64_t)fstat_buf.st_size;
+  reader->is_mapped = 1;
+  return SLA_APIRESULT_OK;
+#else
+  (void)reader;
+  (void)filename;
+  return SLA_APIRESULT_NG;
+#endif
+}
+
+/* ファイル全体を読み込み（メモリマップできない場合） */
+/* 補足）ftellの範囲（longの最大値）までのファイルを読める */
+static SLAApiResult SLAReader_LoadFile(struct SLAReader* reader, const char* filename)
+{
+  FILE* fp;
+  long file_size;
+  uint8_t* buffer;
+
+  if ((fp = fopen(filename, "rb")) == NULL) {
+    return SLA_APIRESULT_NG;
+  }
+  if ((fseek(fp, 0, SEEK_END) != 0) || ((file_size = ftell(fp)) <= 0)
+      || ((unsigned long)file_size > (unsigned long)((size_t)-1)) || (fseek(fp, 0, SEEK_SET) != 0)) {
+    fclose(fp);
+    return SLA_APIRESULT_NG;
+  }
+  if ((buffer = (uint8_t *)malloc((size_t)file_size)) == NULL) {
+    fclose(fp);
+    return SLA_APIRESULT_NG;
+  }
+  if (fread(buffer, sizeof(uint8_t), (size_t)file_size, fp) != (size_t)file_size) {
+    free(buffer);
+    fclose(fp);
+    return SLA_APIRESULT_NG;
+  }
+  fclose(fp);
+
+  reader->data      = buffer;
+  reader->data_size = (uint64_t)file_size;
+  reader->is_mapped = 0;
+  return SLA_APIRESULT_OK;
+}
+
+/* 索引ファイルがあれば読み込む（内容が一致しなければ使わない） */
+static void SLAReader_LoadIndexFile(struct SLAReader* reader, const char* filename)
+{
+  FILE* fp;
+  char* index_filename;
+  uint8_t* index_data;
+  long index_size;
+  struct SLABlockIndexInfo info;
+  struct SLABlockIndexEntry* entries;
+
+  if ((index_filename = (char *)malloc(strlen(filename) + strlen(SLAREADER_INDEX_FILE_EXTENSION) + 1)) == NULL) {
+    return;
+  }
+  strcpy(index_filename, filename);
+  strcat(index_filename, SLAREADER_INDEX_FILE_EXTENSION);
+  fp = fopen(index_filename, "rb");
+  free(index_filename);
+  if (fp == NULL) {
+    return;
+  }
+
+  /* 索引ファイル全体を読み込み */
+  index_data = NULL;
+  if ((fseek(fp, 0, SEEK_END) == 0) && ((index_size = ftell(fp)) > 0)
+      && ((unsigned long)index_size <= UINT32_MAX) && (fseek(fp, 0, SEEK_SET) == 0)) {
+    index_data = (uint8_t *)malloc((size_t)index_size);
+    if ((index_data != NULL)
+        && (fread(index_data, sizeof(uint8_t), (size_t)index_size, fp) != (size_t)index_size)) {
+      free(index_data);
+      index_data = NULL;
+    }
+  }
+  fclose(fp);
+  if (index_data == NULL) {
+    return;
+  }
+
+  /* 対象ファイルのものか確認してからエントリを読み込む */
+  if ((SLADecoder_DecodeBlockIndexFile(index_data, (uint32_t)index_size, &info, NULL, 0) == SLA_APIRESULT_OK)
+      && (SLADecoder_CheckBlockIndexSource(&info, reader->data, reader->data_size) == SLA_APIRESULT_OK)
+      && (info.num_entries > 0)) {
+    entries = (struct SLABlockIndexEntry *)malloc(sizeof(struct SLABlockIndexEntry) * info.num_entries);
+    if ((entries != NULL)
+        && (SLADecoder_DecodeBlockIndexFile(index_data, (uint32_t)index_size,
+            &info, entries, info.num_entries) == SLA_APIRESULT_OK)) {
+      free(reader->entries);
+      reader->entries           = entries;
+      reader->num_entries       = info.num_entries;
+      reader->max_num_entries   = info.num_entries;
+      reader->is_index_complete = 1;
+    } else {
+      free(entries);
+    }
+  }
+
+  free(index_data);
+}
+
+/* ファイルを開く */
+struct SLAReader* SLAReader_Open(const char* filename, const struct SLADecoderConfig* config)
+{
+  struct SLAReader* reader;
+
+  /* 引数チェック */
+  if ((filename == NULL) || (config == NULL)) {
+    return NULL;
+  }
+
+  if ((reader = (struct SLAReader *)malloc(sizeof(struct SLAReader))) == NULL) {
+    return NULL;
+  }
+  memset(reader, 0, sizeof(struct SLAReader));
+
+  /* メモリマップできなければ全体を読み込む */
+  if ((SLAReader_MapFile(reader, filename) != SLA_APIRESULT_OK)
+      && (SLAReader_LoadFile(reader, filename) != SLA_APIRESULT_OK)) {
+    free(reader);
+    return NULL;
+  }
+
+  /* ヘッダ読み出しとデコーダハンドルの作成 */
+  if ((SLADecoder_DecodeHeader(reader->data,
+          (uint32_t)SLAUTILITY_MIN(reader->data_size, SLA_HEADER_SIZE), &reader->header) != SLA_APIRESULT_OK)
+      || ((reader->decoder = SLADecoder_Create(config)) == NULL)) {
+    SLAReader_Close(reader);
+    return NULL;
+  }
+
+  /* ブロック索引はヘッダ直後から必要になった分だけ作成する */
+  /* 補足）ヘッダのブロック数はデータに収まりうる数までに制限（足りなければ拡張する） */
+  reader->max_num_entries = (reader->header.num_blocks != SLA_NUM_BLOCKS_INVALID)
+    ? reader->header.num_blocks : SLAREADER_INITIAL_NUM_ENTRIES;
+  reader->max_num_entries = (uint32_t)SLAUTILITY_MIN((uint64_t)reader->max_num_entries,
+      reader->data_size / SLA_MINIMUM_BLOCK_HEADER_SIZE);
+  reader->max_num_entries = SLAUTILITY_MAX(reader->max_num_entries, 1);
+  if ((reader->entries = (struct SLABlockIndexEntry *)malloc(
+          sizeof(struct SLABlockIndexEntry) * reader->max_num_entries)) == NULL) {
+    SLAReader_Close(reader);
+    return NULL;
+  }
+  reader->num_entries         = 0;
+  reader->next_data_offset    = reader->header.header_size;
+  reader->next_sample_offset  = 0;
+  reader->is_index_complete   = 0;
+
+  /* 索引ファイルがあれば使う */
+  SLAReader_LoadIndexFile(reader, filename);
+
+  return reader;
+}
+
+/* ファイルを閉じる */
+void SLAReader_Close(struct SLAReader* reader)
+{
+  if (reader == NULL) {
+    return;
+  }
+
+  if (reader->data != NULL) {
+#if defined(SLAREADER_USE_MMAP)
+    if (reader->is_mapped) {
+      munmap((void *)reader->data, (size_t)reader->data_size);
+    } else {
+      free((void *)reader->data);
+    }
+#else
+    free((void *)reader->data);
+#endif
+  }
+  SLADecoder_Destroy(reader->decoder);
+  free(reader->entries);
+  free(reader);
+}
+
+/* ヘッダ情報の取得 */
+const struct SLAHeaderInfo* SLAReader_GetHeaderInfo(const struct SLAReader* reader)
+{
+  return (reader != NULL) ? &reader->header : NULL;
+}
+
+/* ファイル全体のデータの取得 */
+SLAApiResult SLAReader_GetData(const struct SLAReader* reader, const uint8_t** data, uint64_t* data_size)
+{
+  /* 引数チェック */
+  if ((reader == NULL) || (data == NULL) || (data_size == NULL)) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  *data       = reader->data;
+  *data_size  = reader->data_size;
+  return SLA_APIRESULT_OK;
+}
+
+/* 内部のデコーダハンドルの取得 */
+struct SLADecoder* SLAReader_GetDecoder(struct SLAReader* reader)
+{
+  return (reader != NULL) ? reader->decoder : NULL;
+}
+
+/* アクセスパターンの指定 */
+SLAApiResult SLAReader_SetAccessPattern(struct SLAReader* reader, SLAReaderAccessPattern pattern)
+{
+  /* 引数チェック */
+  if (reader == NULL) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+
+#if defined(SLAREADER_USE_MMAP)
+  if (reader->is_mapped) {
+    int advice;
+    switch (pattern) {
+      case SLAREADER_ACCESSPATTERN_NORMAL:      advice = POSIX_MADV_NORMAL;     break;
+      case SLAREADER_ACCESSPATTERN_SEQUENTIAL:  advice = POSIX_MADV_SEQUENTIAL; break;
+      case SLAREADER_ACCESSPATTERN_RANDOM:      advice = POSIX_MADV_RANDOM;     break;
+      default: return SLA_APIRESULT_INVALID_ARGUMENT;
+    }
+    /* 助言なので失敗しても読み込みには影響しない */
+    (void)posix_madvise((void *)reader->data, (size_t)reader->data_size, advice);
+  }
+#else
+  if ((pattern != SLAREADER_ACCESSPATTERN_NORMAL)
+      && (pattern != SLAREADER_ACCESSPATTERN_SEQUENTIAL)
+      && (pattern != SLAREADER_ACCESSPATTERN_RANDOM)) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+#endif
+
+  return SLA_APIRESULT_OK;
+}
+
+/* ブロック索引を1ブロック分延ばす */
+/* 補足）ブロックヘッダの先頭だけを読み、ブロックデータには触れない */
+static SLAApiResult SLAReader_ExtendIndex(struct SLAReader* reader)
+{
+  uint64_t offset;
+  uint32_t block_size;
+  const uint8_t* block;
+  struct SLABlockIndexEntry* entry;
+
+  SLA_Assert(reader != NULL);
+  SLA_Assert(!reader->is_index_complete);
+
+  offset = reader->next_data_offset;
+
+  /* 末尾に到達 */
+  if ((offset >= reader->data_size)
+      || ((reader->header.num_samples != SLA_NUM_SAMPLES_INVALID)
+        && (reader->next_sample_offset >= reader->header.num_samples))) {
+    reader->is_index_complete = 1;
+    return SLA_APIRESULT_OK;
+  }
+
+  /* ブロックヘッダの確認 */
+  if ((reader->data_size - offset) < SLA_MINIMUM_BLOCK_HEADER_SIZE) {
+    return SLA_APIRESULT_INSUFFICIENT_DATA_SIZE;
+  }
+  block = &reader->data[offset];
+  if (SLAByteArray_ReadUint16(block) != SLA_BLOCK_SYNC_CODE) {
+    return SLA_APIRESULT_FAILED_TO_FIND_SYNC_CODE;
+  }
+  block_size = SLAByteArray_ReadUint32(&block[2]) + SLA_BLOCK_SIZE_FIELD_END_OFFSET;
+  if ((block_size < SLA_MINIMUM_BLOCK_HEADER_SIZE) || (block_size > (reader->data_size - offset))) {
+    return SLA_APIRESULT_INSUFFICIENT_DATA_SIZE;
+  }
+
+  /* エントリ領域が足りなければ拡張 */
+  if (reader->num_entries >= reader->max_num_entries) {
+    struct SLABlockIndexEntry* entries = (struct SLABlockIndexEntry *)realloc(reader->entries,
+        sizeof(struct SLABlockIndexEntry) * reader->max_num_entries * 2);
+    if (entries == NULL) {
+      return SLA_APIRESULT_NG;
+    }
+    reader->entries         = entries;
+    reader->max_num_entries *= 2;
+  }
+
+  entry = &reader->entries[reader->num_entries];
+  entry->data_offset    = offset;
+  entry->sample_offset  = reader->next_sample_offset;
+  entry->block_size     = block_size;
+  entry->crc16          = SLAByteArray_ReadUint16(&block[SLA_BLOCK_SIZE_FIELD_END_OFFSET]);
+  entry->num_samples    = SLAUtility_GetBlockNumSamples(block, block_size);
+
+  reader->num_entries++;
+  reader->next_data_offset    += block_size;
+  reader->next_sample_offset  += entry->num_samples;
+
+  return SLA_APIRESULT_OK;
+}
+
+/* ブロック数の取得 */
+SLAApiResult SLAReader_GetNumBlocks(struct SLAReader* reader, uint32_t* num_blocks)
+{
+  SLAApiResult ret;
+
+  /* 引数チェック */
+  if ((reader == NULL) || (num_blocks == NULL)) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  while (!reader->is_index_complete) {
+    if ((ret = SLAReader_ExtendIndex(reader)) != SLA_APIRESULT_OK) {
+      return ret;
+    }
+  }
+
+  *num_blocks = reader->num_entries;
+  return SLA_APIRESULT_OK;
+}
+
+/* ブロック索引エントリの取得 */
+SLAApiResult SLAReader_GetBlockIndexEntry(struct SLAReader* reader,
+    uint32_t block_no, struct SLABlockIndexEntry* entry)
+{
+  SLAApiResult ret;
+
+  /* 引数チェック */
+  if ((reader == NULL) || (entry == NULL)) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  /* 必要なブロックまで索引を作成 */
+  while ((block_no >= reader->num_entries) && !reader->is_index_complete) {
+    if ((ret = SLAReader_ExtendIndex(reader)) != SLA_APIRESULT_OK) {
+      return ret;
+    }
+  }
+  if (block_no >= reader->num_entries) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  *entry = reader->entries[block_no];
+  return SLA_APIRESULT_OK;
+}
+
+/* 1ブロックのデコード */
+SLAApiResult SLAReader_DecodeBlock(struct SLAReader* reader, uint32_t block_no,
+    int32_t** buffer, uint32_t buffer_num_samples, uint32_t* output_num_samples)
+{
+  struct SLABlockIndexEntry entry;
+  SLAApiResult ret;
+
+  /* 引数チェック */
+  if ((reader == NULL) || (buffer == NULL) || (output_num_samples == NULL)) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  if ((ret = SLAReader_GetBlockIndexEntry(reader, block_no, &entry)) != SLA_APIRESULT_OK) {
+    return ret;
+  }
+
+  /* ブロックの範囲だけをデコード */
+  return SLADecoder_DecodeRange(reader->decoder, reader->data, reader->data_size,
+      reader->entries, reader->num_entries, entry.sample_offset, entry.num_samples,
+      buffer, buffer_num_samples, output_num_samples);
+}
+
+/* サンプル範囲のデコード */
+SLAApiResult SLAReader_DecodeRange(struct SLAReader* reader,
+    uint64_t start_sample, uint32_t num_samples,
+    int32_t** buffer, uint32_t buffer_num_samples, uint32_t* output_num_samples)
+{
+  SLAApiResult ret;
+
+  /* 引数チェック */
+  if ((reader == NULL) || (buffer == NULL) || (output_num_samples == NULL)) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  /* 開始サンプルを含むブロックまで索引を作成 */
+  while (((reader->num_entries == 0) || (reader->next_sample_offset <= start_sample))
+      && !reader->is_index_complete) {
+    if ((ret = SLAReader_ExtendIndex(reader)) != SLA_APIRESULT_OK) {
+      return ret;
+    }
+  }
+  if (reader->num_entries == 0) {
+    return SLA_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  return SLADecoder_DecodeRange(reader->decoder, reader->data, reader->data_size,
+      reader->entries, reader->num_entries, start_sample, num_samples,
+      buffer, buffer_num_samples, output_num_samples);
+}
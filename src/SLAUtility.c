@@ -1,11 +1,18 @@
+/* 統計情報の時刻取得にPOSIXの単調増加時計を使う */
+#if !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 199309L
+#endif
+
 #include "SLAUtility.h"
 #include "SLAInternal.h"
+#include "SLAByteArray.h"
 
 #include <math.h>
 #include <stdlib.h>
 #include <stddef.h>
 #include <string.h>
 #include <float.h>
+#include <time.h>
 
 /* 連立１次方程式ソルバー */
 struct SLALESolver {
@@ -15,6 +22,8 @@ struct SLALESolver {
   double*   x_vec;          /* 解ベクトル   */
   double*   err_vec;        /* 誤差ベクトル */
   double**  A_lu;           /* LU分解した係数行列 */
+  uint8_t   alloced_by_own; /* 自前で領域を確保したか */
+  void*     work;           /* ワーク領域先頭ポインタ */
 };
 
 /* データパケット */
@@ -321,14 +330,16 @@ void SLAUtility_FFT(double* data, uint32_t n, int32_t sign)
 /* CRC16(IBM)の計算 */
 uint16_t SLAUtility_CalculateCRC16(const uint8_t* data, uint64_t data_size)
 {
-  uint16_t crc16;
+  /* 初期値から計算 */
+  return SLAUtility_UpdateCRC16(0x0000, data, data_size);
+}
 
+/* CRC16(CRC-IBM)の途中結果に続くデータを加えた値の計算 */
+uint16_t SLAUtility_UpdateCRC16(uint16_t crc16, const uint8_t* data, uint64_t data_size)
+{
   /* 引数チェック */
   SLA_Assert(data != NULL);
 
-  /* 初期値 */
-  crc16 = 0x0000;
-
   /* modulo2計算 */
   while (data_size--) {
     /* 補足）多項式は反転済みなので、この計算により入出力反転済みとできる */
@@ -338,6 +349,30 @@ uint16_t SLAUtility_CalculateCRC16(const uint8_t* data, uint64_t data_size)
   return crc16;
 }
 
+/* ブロック先頭のデータからブロックサンプル数を読み出し */
+uint32_t SLAUtility_GetBlockNumSamples(const uint8_t* block_data, uint32_t data_size)
+{
+  uint32_t num_samples;
+
+  /* 引数チェック */
+  SLA_Assert(block_data != NULL);
+
+  if (data_size < SLA_MINIMUM_BLOCK_HEADER_SIZE) {
+    return 0;
+  }
+
+  /* 16bitに収まらない場合はエスケープ値の後ろに32bitで記録されている */
+  num_samples = SLAByteArray_ReadUint16(&block_data[SLA_BLOCK_CRC16_CALC_START_OFFSET]);
+  if (num_samples == SLA_BLOCK_NUM_SAMPLES_ESCAPE) {
+    if (data_size < SLA_EXTENDED_BLOCK_HEADER_SIZE) {
+      return 0;
+    }
+    num_samples = SLAByteArray_ReadUint32(&block_data[SLA_BLOCK_CRC16_CALC_START_OFFSET + 2]);
+  }
+
+  return num_samples;
+}
+
 /* NLZ（最上位ビットから1に当たるまでのビット数）の計算 */
 uint32_t SLAUtility_NLZSoft(uint32_t x)
 {
@@ -446,40 +481,92 @@ double SLAUtility_Log2(double x)
 #undef INV_LOGE2
 }
 
-/* 連立一次方程式ソルバーの作成 */
-struct SLALESolver* SLALESolver_Create(uint32_t max_dim)
+/* ワーク領域から領域を切り出し、ワーク領域の参照位置を進める */
+void* SLAUtility_AllocateWork(uint8_t** work_ptr, size_t size)
+{
+  void* ptr;
+
+  SLA_Assert(work_ptr != NULL);
+  SLA_Assert(((uintptr_t)(*work_ptr) % SLA_MEMORY_ALIGNMENT) == 0);
+
+  ptr = *work_ptr;
+  *work_ptr += SLAUTILITY_ROUNDUP(size, SLA_MEMORY_ALIGNMENT);
+
+  return ptr;
+}
+
+/* 連立一次方程式ソルバーのワークサイズ計算 */
+int32_t SLALESolver_CalculateWorkSize(uint32_t max_dim)
+{
+  int32_t work_size;
+
+  work_size = SLA_MEMORY_ALIGNMENT + SLAUTILITY_WORK_SIZE(sizeof(struct SLALESolver));
+  work_size += SLAUTILITY_WORK_SIZE(sizeof(double) * max_dim);    /* row_scale    */
+  work_size += SLAUTILITY_WORK_SIZE(sizeof(uint32_t) * max_dim);  /* change_index */
+  work_size += SLAUTILITY_WORK_SIZE(sizeof(double) * max_dim);    /* x_vec        */
+  work_size += SLAUTILITY_WORK_SIZE(sizeof(double) * max_dim);    /* err_vec      */
+  work_size += SLAUTILITY_WORK_SIZE(sizeof(double *) * max_dim);  /* A_lu         */
+  work_size += (int32_t)max_dim * SLAUTILITY_WORK_SIZE(sizeof(double) * max_dim);
+
+  return work_size;
+}
+
+/* 連立一次方程式ソルバーの作成（ワーク領域指定） */
+struct SLALESolver* SLALESolver_CreateWithWork(uint32_t max_dim, void* work, int32_t work_size)
 {
   uint32_t dim;
+  uint8_t* work_ptr;
   struct SLALESolver* lesolver;
 
-  lesolver     = (struct SLALESolver *)malloc(sizeof(struct SLALESolver));
-  lesolver->max_dim      = max_dim;
-  lesolver->row_scale    = (double *)malloc(sizeof(double) * max_dim);
-  lesolver->change_index = (uint32_t *)malloc(sizeof(uint32_t) * max_dim);
-  lesolver->x_vec        = (double *)malloc(sizeof(double) * max_dim);
-  lesolver->err_vec      = (double *)malloc(sizeof(double) * max_dim);
-  lesolver->A_lu         = (double **)malloc(sizeof(double*) * max_dim);
+  /* 引数チェック */
+  if ((work == NULL) || (work_size < SLALESolver_CalculateWorkSize(max_dim))) {
+    return NULL;
+  }
+
+  work_ptr = SLAUTILITY_ALIGN_WORK(work);
+
+  lesolver = (struct SLALESolver *)SLAUtility_AllocateWork(&work_ptr, sizeof(struct SLALESolver));
+  lesolver->max_dim        = max_dim;
+  lesolver->alloced_by_own = 0;
+  lesolver->work           = work;
+  lesolver->row_scale    = (double *)SLAUtility_AllocateWork(&work_ptr, sizeof(double) * max_dim);
+  lesolver->change_index = (uint32_t *)SLAUtility_AllocateWork(&work_ptr, sizeof(uint32_t) * max_dim);
+  lesolver->x_vec        = (double *)SLAUtility_AllocateWork(&work_ptr, sizeof(double) * max_dim);
+  lesolver->err_vec      = (double *)SLAUtility_AllocateWork(&work_ptr, sizeof(double) * max_dim);
+  lesolver->A_lu         = (double **)SLAUtility_AllocateWork(&work_ptr, sizeof(double*) * max_dim);
 
   for (dim = 0; dim < max_dim; dim++) {
-    lesolver->A_lu[dim] = (double *)malloc(sizeof(double) * max_dim);
+    lesolver->A_lu[dim] = (double *)SLAUtility_AllocateWork(&work_ptr, sizeof(double) * max_dim);
   }
 
+  SLA_Assert((work_ptr - (uint8_t *)work) <= work_size);
+
+  return lesolver;
+}
+
+/* 連立一次方程式ソルバーの作成 */
+struct SLALESolver* SLALESolver_Create(uint32_t max_dim)
+{
+  int32_t work_size;
+  void* work;
+  struct SLALESolver* lesolver;
+
+  work_size = SLALESolver_CalculateWorkSize(max_dim);
+  work = malloc((size_t)work_size);
+  if ((lesolver = SLALESolver_CreateWithWork(max_dim, work, work_size)) == NULL) {
+    NULLCHECK_AND_FREE(work);
+    return NULL;
+  }
+  lesolver->alloced_by_own = 1;
+
   return lesolver;
 }
 
 /* 連立一次方程式ソルバーの破棄 */
 void SLALESolver_Destroy(struct SLALESolver* lesolver)
 {
-  if (lesolver != NULL) {
-    uint32_t dim;
-    for (dim = 0; dim < lesolver->max_dim; dim++) {
-      NULLCHECK_AND_FREE(lesolver->A_lu[dim]);
-    }
-    NULLCHECK_AND_FREE(lesolver->A_lu);
-    NULLCHECK_AND_FREE(lesolver->row_scale);
-    NULLCHECK_AND_FREE(lesolver->change_index);
-    NULLCHECK_AND_FREE(lesolver->x_vec);
-    NULLCHECK_AND_FREE(lesolver->err_vec);
+  if ((lesolver != NULL) && lesolver->alloced_by_own) {
+    free(lesolver->work);
   }
 }
 
@@ -695,15 +782,69 @@ uint32_t SLAUtility_GetDataBitWidth(
   return (maxabs > 0) ? (SLAUTILITY_LOG2CEIL(maxabs) + 1) : 1;
 }
 
+/* 実行環境で使用可能な最上位のSIMD命令セットを取得 */
+SLASIMDInstructionSet SLAUtility_GetAvailableSIMDInstructionSet(void)
+{
+#if defined(USE_SSE)
+  /* cpuidによる判定 */
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("sse4.1")) {
+    return SLA_SIMDINSTRUCTIONSET_SSE41;
+  }
+#endif
+  return SLA_SIMDINSTRUCTIONSET_NONE;
+}
+
+/* 統計情報用の時刻取得[tick] */
+uint64_t SLAUtility_GetStatisticsTick(void)
+{
+#if defined(CLOCK_MONOTONIC)
+  struct timespec ts;
+
+  /* 実時間をナノ秒単位で取得（clock()はCPU時間かつ粒度が粗い） */
+  if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0) {
+    return (uint64_t)ts.tv_sec * 1000000000UL + (uint64_t)ts.tv_nsec;
+  }
+  return 0;
+#else
+  return (uint64_t)clock();
+#endif
+}
+
+/* 統計情報用の1秒あたりのtick数 */
+uint64_t SLAUtility_GetStatisticsTicksPerSecond(void)
+{
+#if defined(CLOCK_MONOTONIC)
+  return 1000000000UL;
+#else
+  return (uint64_t)CLOCKS_PER_SEC;
+#endif
+}
+
+/* 統計情報用の時刻を計測する時計の種類 */
+SLAStatisticsClock SLAUtility_GetStatisticsTickClock(void)
+{
+#if defined(CLOCK_MONOTONIC)
+  return SLA_STATISTICS_CLOCK_MONOTONIC;
+#else
+  return SLA_STATISTICS_CLOCK_PROCESS_CPU;
+#endif
+}
+
 /* パケットキューの作成 */
 struct SLADataPacketQueue* SLADataPacketQueue_Create(uint32_t max_num_packets)
 {
   uint32_t pos;
   struct SLADataPacketQueue* queue;
 
-  queue = malloc(sizeof(struct SLADataPacketQueue));
+  if ((queue = malloc(sizeof(struct SLADataPacketQueue))) == NULL) {
+    return NULL;
+  }
 
-  queue->packets          = malloc(sizeof(struct SLADataPacket) * max_num_packets);
+  if ((queue->packets = malloc(sizeof(struct SLADataPacket) * max_num_packets)) == NULL) {
+    free(queue);
+    return NULL;
+  }
   queue->max_num_packets  = max_num_packets;
   queue->num_free_packets = max_num_packets;
   queue->write_pos        = 0;
@@ -818,6 +959,117 @@ SLADataPacketQueueApiResult SLADataPacketQueue_GetDataFragment(
   return SLA_DATAPACKETQUEUE_APIRESULT_OK;
 }
 
+/* 未読み出しのデータ片の参照（読み出し位置は進めない） */
+SLADataPacketQueueApiResult SLADataPacketQueue_PeekDataFragment(
+    const struct SLADataPacketQueue* queue, const uint8_t** data_ptr, uint32_t* data_size)
+{
+  const struct SLADataPacket* packet;
+
+  SLA_Assert(queue != NULL);
+  SLA_Assert(data_ptr != NULL);
+  SLA_Assert(data_size != NULL);
+
+  /* キューにパケットが一つも入っていない */
+  if (queue->num_free_packets == queue->max_num_packets) {
+    return SLA_DATAPACKETQUEUE_APIRESULT_NO_DATA_FRAGMENTS;
+  }
+
+  /* パケットを取得 */
+  packet = &queue->packets[queue->read_pos];
+
+  /* 読み出しが書き出しに追いついており、データもすべて消費している */
+  if ((queue->read_pos == queue->write_pos)
+      && (packet->data_size == packet->used_size)) {
+    return SLA_DATAPACKETQUEUE_APIRESULT_NO_DATA_FRAGMENTS;
+  }
+
+  /* 出力に反映 */
+  SLA_Assert(packet->data_size >= packet->used_size);
+  (*data_ptr)   = &packet->data[packet->used_size];
+  (*data_size)  = packet->data_size - packet->used_size;
+
+  return SLA_DATAPACKETQUEUE_APIRESULT_OK;
+}
+
+/* 未読み出しのデータの先頭からoffsetバイト目以降をコピー（読み出し位置は進めない） */
+SLADataPacketQueueApiResult SLADataPacketQueue_PeekData(
+    const struct SLADataPacketQueue* queue, uint32_t offset, uint8_t* data, uint32_t data_size)
+{
+  uint32_t pos, copy_size;
+  const struct SLADataPacket* packet;
+
+  SLA_Assert(queue != NULL);
+  SLA_Assert(data != NULL);
+
+  /* 一つもパケットが入っていない */
+  if (queue->num_free_packets == queue->max_num_packets) {
+    return (data_size == 0) ? SLA_DATAPACKETQUEUE_APIRESULT_OK : SLA_DATAPACKETQUEUE_APIRESULT_NO_DATA_FRAGMENTS;
+  }
+
+  /* パケットを辿りながら未読み出し部分をコピー */
+  pos = queue->read_pos;
+  do {
+    uint32_t remain_size;
+    packet = &queue->packets[pos];
+    SLA_Assert(packet->data_size >= packet->used_size);
+    remain_size = packet->data_size - packet->used_size;
+    if (offset >= remain_size) {
+      /* オフセットまで読み飛ばし */
+      offset -= remain_size;
+    } else {
+      copy_size = SLAUTILITY_MIN(remain_size - offset, data_size);
+      memcpy(data, &packet->data[packet->used_size + offset], copy_size);
+      data      += copy_size;
+      data_size -= copy_size;
+      offset    = 0;
+    }
+    pos = (pos + 1) % queue->max_num_packets;
+  } while ((data_size > 0) && (pos != queue->write_pos));
+
+  /* 要求サイズに満たない */
+  if (data_size > 0) {
+    return SLA_DATAPACKETQUEUE_APIRESULT_NO_DATA_FRAGMENTS;
+  }
+
+  return SLA_DATAPACKETQUEUE_APIRESULT_OK;
+}
+
+/* 未読み出しのデータの先頭からoffsetバイト目を含むデータ片の参照（読み出し位置は進めない） */
+SLADataPacketQueueApiResult SLADataPacketQueue_PeekDataFragmentAt(
+    const struct SLADataPacketQueue* queue, uint32_t offset, const uint8_t** data_ptr, uint32_t* data_size)
+{
+  uint32_t pos;
+  const struct SLADataPacket* packet;
+
+  SLA_Assert(queue != NULL);
+  SLA_Assert(data_ptr != NULL);
+  SLA_Assert(data_size != NULL);
+
+  /* 一つもパケットが入っていない */
+  if (queue->num_free_packets == queue->max_num_packets) {
+    return SLA_DATAPACKETQUEUE_APIRESULT_NO_DATA_FRAGMENTS;
+  }
+
+  /* オフセットを含むパケットまで辿る */
+  pos = queue->read_pos;
+  do {
+    uint32_t remain_size;
+    packet = &queue->packets[pos];
+    SLA_Assert(packet->data_size >= packet->used_size);
+    remain_size = packet->data_size - packet->used_size;
+    if (offset < remain_size) {
+      (*data_ptr)   = &packet->data[packet->used_size + offset];
+      (*data_size)  = remain_size - offset;
+      return SLA_DATAPACKETQUEUE_APIRESULT_OK;
+    }
+    offset -= remain_size;
+    pos = (pos + 1) % queue->max_num_packets;
+  } while (pos != queue->write_pos);
+
+  /* オフセットまでデータが届いていない */
+  return SLA_DATAPACKETQUEUE_APIRESULT_NO_DATA_FRAGMENTS;
+}
+
 /* 消費済みデータ片の回収 */
 SLADataPacketQueueApiResult SLADataPacketQueue_DequeueDataFragment(
     struct SLADataPacketQueue* queue, const uint8_t** data_ptr, uint32_t* data_size)
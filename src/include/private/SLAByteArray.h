@@ -23,6 +23,13 @@
    (((uint32_t)((p_array)[3])) <<  0)     \
   )
 
+/* 8バイト読み出し */
+#define SLAByteArray_ReadUint64(p_array)  \
+  (uint64_t)(                             \
+   (((uint64_t)SLAByteArray_ReadUint32(&(p_array)[0])) << 32) | \
+   (((uint64_t)SLAByteArray_ReadUint32(&(p_array)[4])) <<  0)   \
+  )
+
 /* 1バイト取得 */
 #define SLAByteArray_GetUint8(p_array, p_u8val) {     \
   (*(p_u8val)) = SLAByteArray_ReadUint8(p_array);     \
@@ -41,6 +48,12 @@
   (p_array) += 4;                                     \
 }
 
+/* 8バイト取得 */
+#define SLAByteArray_GetUint64(p_array, p_u64val) {   \
+  (*(p_u64val)) = SLAByteArray_ReadUint64(p_array);   \
+  (p_array) += 8;                                     \
+}
+
 /* 1バイト書き出し */
 #define SLAByteArray_WriteUint8(p_array, u8val)   {   \
   ((p_array)[0]) = (uint8_t)(u8val);                  \
@@ -60,6 +73,12 @@
   ((p_array)[3]) = (uint8_t)(((u32val) >>  0) & 0xFF);  \
 }
 
+/* 8バイト書き出し */
+#define SLAByteArray_WriteUint64(p_array, u64val) {                     \
+  SLAByteArray_WriteUint32(&(p_array)[0], (uint32_t)((u64val) >> 32));  \
+  SLAByteArray_WriteUint32(&(p_array)[4], (uint32_t)((u64val) >>  0));  \
+}
+
 /* 1バイト出力 */
 #define SLAByteArray_PutUint8(p_array, u8val) {       \
   SLAByteArray_WriteUint8(p_array, u8val);            \
@@ -78,4 +97,10 @@
   (p_array) += 4;                                     \
 }
 
+/* 8バイト出力 */
+#define SLAByteArray_PutUint64(p_array, u64val) {     \
+  SLAByteArray_WriteUint64(p_array, u64val);          \
+  (p_array) += 8;                                     \
+}
+
 #endif /* SLA_BYTEARRAY_H_INCLUDED */
@@ -11,12 +11,24 @@ struct SLACoder;
 extern "C" {
 #endif 
 
+/* 符号化ハンドルのワークサイズ計算 */
+int32_t SLACoder_CalculateWorkSize(uint32_t max_num_channels, uint32_t max_num_parameters);
+
+/* 符号化ハンドルの作成（ワーク領域指定） */
+struct SLACoder* SLACoder_CreateWithWork(
+    uint32_t max_num_channels, uint32_t max_num_parameters, void* work, int32_t work_size);
+
 /* 符号化ハンドルの作成 */
 struct SLACoder* SLACoder_Create(uint32_t max_num_channels, uint32_t max_num_parameters);
 
 /* 符号化ハンドルの破棄 */
 void SLACoder_Destroy(struct SLACoder* coder);
 
+#ifdef SLA_ENABLE_STATISTICS
+/* ライス符号パラメータのヒストグラム記録先の設定（NULLで記録しない） */
+void SLACoder_SetRiceParameterHistogram(struct SLACoder* coder, uint64_t* histogram);
+#endif
+
 /* 初期パラメータの計算 */
 void SLACoder_CalculateInitialRecursiveRiceParameter(
     struct SLACoder* coder, uint32_t num_parameters,
@@ -0,0 +1,19 @@
+#ifndef SLA_ENCODEPRESET_H_INCLUDED
+#define SLA_ENCODEPRESET_H_INCLUDED
+
+#include "SLA.h"
+
+/* エンコードプリセット（CUIとベンチマークで共有） */
+static const struct SLAEncodeParameter encode_preset[] = {
+  /* parcor, longterm, lms,             ch_porcess_method,                   window_func_type, max_block_size */
+  {       8,        1,   4,      SLA_CHPROCESSMETHOD_NONE, SLA_WINDOWFUNCTIONTYPE_RECTANGULAR,           4096 },
+  {       8,        1,   8, SLA_CHPROCESSMETHOD_STEREO_MS,         SLA_WINDOWFUNCTIONTYPE_SIN,          12288 },
+  {      16,        1,   8, SLA_CHPROCESSMETHOD_STEREO_MS,         SLA_WINDOWFUNCTIONTYPE_SIN,          12288 },
+  {      32,        3,   8, SLA_CHPROCESSMETHOD_STEREO_MS,         SLA_WINDOWFUNCTIONTYPE_SIN,          12288 },
+  {      32,        3,   8, SLA_CHPROCESSMETHOD_STEREO_MS,         SLA_WINDOWFUNCTIONTYPE_SIN,          16384 }
+};
+
+/* エンコードプリセット数 */
+#define SLA_NUM_ENCODE_PRESETS (sizeof(encode_preset) / sizeof(encode_preset[0]))
+
+#endif /* SLA_ENCODEPRESET_H_INCLUDED */
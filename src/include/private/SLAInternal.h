@@ -3,7 +3,6 @@
 
 #include <assert.h>
 
-#define SLA_MAX_CHANNELS                            8                       /* 処理可能な最大チャンネル数（撤廃予定） */
 /* 内部エンコードパラメータ */
 #define SLA_BLOCK_SYNC_CODE                         0xFFFF                  /* ブロック先頭の同期コード                 */
 #define SLALONGTERM_MAX_PERIOD                      256                     /* ロングタームの最大周期                   */
@@ -13,13 +12,15 @@
 #define SLALONGTERM_MIN_PITCH_THRESHOULD            3                       /* 最小ピッチ周期                           */
 #define SLA_MIN_BLOCK_NUM_SAMPLES                   2048                    /* 最小ブロックサイズ                       */
 #define SLA_SEARCH_BLOCK_NUM_SAMPLES_DELTA          1024                    /* ブロックサイズ探索時のブロックサイズ増分 */
+#define SLA_SEARCH_BLOCK_MAX_NUM_DIVISIONS          16                      /* ブロックサイズ探索時の最大分割数 */
 #define SLA_PRE_EMPHASIS_COEFFICIENT_SHIFT          5                       /* プレエンファシスのシフト量               */
 #define SLALMS_DELTA_WEIGHT_SHIFT                   4                       /* LMSの更新量の固定小数値のシフト量      */
 #define SLACODER_NUM_RECURSIVERICE_PARAMETER        2                       /* 再帰的ライス符号のパラメータ数 */
 #define SLACODER_LOW_THRESHOULD_PARAMETER           8  /* [-4,4] */         /* 固定パラメータ符号を使うか否かの閾値 */
 #define SLACODER_QUOTPART_THRESHOULD                16                      /* 再帰的ライス符号の商部分の閾値 これ以上の大きさの商はガンマ符号化 */
 #define SLA_STREAMING_DECODE_NUM_SAMPLES_MARGIN     1.05f                   /* ストリーミングデコード時の出力サンプルの余裕をもたせるための比率 */
-#define SLA_STREAMING_DECODE_MAX_NUM_PACKETS        8                       /* ストリーミングデコードで使用する最大パケット数 */
+#define SLA_STREAMING_DECODE_MAX_NUM_PACKETS        64                      /* ストリーミングデコードで使用する最大パケット数（データ片はデコードが終わるまで保持） */
+#define SLA_STREAMING_DECODE_PACKETS_UNIT_NUM_SAMPLES 16384                 /* 最大パケット数を確保するブロックサンプル数の単位 */
 
 /* パスの長さに対して与えるペナルティサイズ[byte]
  * 補足）分割を増やすと以下の要因でサイズが増える
@@ -32,7 +33,25 @@
 #define SLA_HEADER_CRC16_CALC_START_OFFSET          (1 * 4 + 4 + 2)         /* シグネチャ + 先頭ブロックまでのオフセット + CRC16記録フィールド */
 /* ブロックのCRC16書き込み開始位置 */
 #define SLA_BLOCK_CRC16_CALC_START_OFFSET           (2 + 4 + 2)             /* 同期コード + 次のブロックまでのオフセット + CRC16記録フィールド */
+#define SLA_BLOCK_SIZE_FIELD_END_OFFSET             (2 + 4)                 /* ブロックサイズが確定する位置: 同期コード + 次のブロックまでのオフセット */
 #define SLA_MINIMUM_BLOCK_HEADER_SIZE               (2 + 4 + 2 + 2 + 1)     /* 最小のブロックヘッダサイズ: 同期コード + オフセット + CRC16 + ブロックサンプル数 + ブロックデータタイプ をバイト境界に合わせた値 */
+#define SLA_EXTENDED_BLOCK_HEADER_SIZE              (SLA_MINIMUM_BLOCK_HEADER_SIZE + 4)     /* 32bitのブロックサンプル数を含む最小のブロックヘッダサイズ */
+/* ブロックサンプル数フィールド
+ * 補足）16bitに収まらないサンプル数はエスケープ値0を記録し、続く32bitに記録する */
+#define SLA_BLOCK_NUM_SAMPLES_ESCAPE                0
+#define SLA_BLOCK_NUM_SAMPLES_16BIT_MAX             0xFFFF
+
+/* ブロックサイズ探索時のブロックサイズ増分を取得
+ * 補足）探索コストはノード数の3乗に比例するため、大きなブロックでは分割数が
+ *       SLA_SEARCH_BLOCK_MAX_NUM_DIVISIONSを超えないよう増分を広げる */
+#define SLA_GET_SEARCH_BLOCK_NUM_SAMPLES_DELTA(num_samples) \
+  (SLA_SEARCH_BLOCK_NUM_SAMPLES_DELTA \
+   * (((num_samples) + SLA_SEARCH_BLOCK_NUM_SAMPLES_DELTA * SLA_SEARCH_BLOCK_MAX_NUM_DIVISIONS - 1) \
+     / (SLA_SEARCH_BLOCK_NUM_SAMPLES_DELTA * SLA_SEARCH_BLOCK_MAX_NUM_DIVISIONS)))
+/* ブロックサイズ探索のワーク領域計算に使うサンプル数（増分はSLA_SEARCH_BLOCK_NUM_SAMPLES_DELTAとして計算） */
+#define SLA_GET_SEARCH_BLOCK_WORK_NUM_SAMPLES(max_num_block_samples) \
+  (((max_num_block_samples) < (SLA_SEARCH_BLOCK_NUM_SAMPLES_DELTA * SLA_SEARCH_BLOCK_MAX_NUM_DIVISIONS)) \
+   ? (max_num_block_samples) : (SLA_SEARCH_BLOCK_NUM_SAMPLES_DELTA * SLA_SEARCH_BLOCK_MAX_NUM_DIVISIONS))
 
 /* PARCORの次数から係数のビット幅を取得 */
 #define SLA_GET_PARCOR_QUANTIZE_BIT_WIDTH(order)  (((order) < SLAPARCOR_COEF_LOW_ORDER_THRESHOULD) ? 16 : 8)
@@ -63,6 +82,40 @@
   }
 #endif
 
+/* 統計情報収集 */
+#ifdef SLA_ENABLE_STATISTICS
+/* 時刻取得（サイクルカウンタ等を使う場合はビルド時に差し替える） */
+#ifndef SLA_STATISTICS_GET_TICK
+#define SLA_STATISTICS_GET_TICK()           SLAUtility_GetStatisticsTick()
+#define SLA_STATISTICS_TICKS_PER_SECOND     SLAUtility_GetStatisticsTicksPerSecond()
+#define SLA_STATISTICS_TICK_CLOCK           SLAUtility_GetStatisticsTickClock()
+#endif
+#ifndef SLA_STATISTICS_TICK_CLOCK
+#define SLA_STATISTICS_TICK_CLOCK           SLA_STATISTICS_CLOCK_USER_DEFINED
+#endif
+/* 処理段階の計測開始/終了（ハンドルにstatistics, stage_start_tickメンバが必要） */
+#define SLA_STATISTICS_START_STAGE(handle) \
+  ((handle)->stage_start_tick = SLA_STATISTICS_GET_TICK())
+#define SLA_STATISTICS_END_STAGE(handle, stage) \
+  ((handle)->statistics.stage_ticks[(stage)] += SLA_STATISTICS_GET_TICK() - (handle)->stage_start_tick)
+/* 1ブロック分の記録（サイズはバイト単位） */
+#define SLA_STATISTICS_COUNT_BLOCK(handle, block_type, block_num_samples, header_size, block_size) { \
+  switch (block_type) {                                                                             \
+    case SLA_BLOCK_DATA_TYPE_COMPRESSDATA:  (handle)->statistics.num_compressed_blocks++; break;    \
+    case SLA_BLOCK_DATA_TYPE_SILENT:        (handle)->statistics.num_silent_blocks++;     break;    \
+    case SLA_BLOCK_DATA_TYPE_RAWDATA:       (handle)->statistics.num_raw_blocks++;        break;    \
+    default:                                                                              break;    \
+  }                                                                                                 \
+  (handle)->statistics.num_samples      += (uint64_t)(block_num_samples) * (handle)->wave_format.num_channels; \
+  (handle)->statistics.coefficient_bits += 8 * (uint64_t)(header_size);                            \
+  (handle)->statistics.residual_bits    += 8 * (uint64_t)((block_size) - (header_size));           \
+}
+#else
+#define SLA_STATISTICS_START_STAGE(handle)
+#define SLA_STATISTICS_END_STAGE(handle, stage)
+#define SLA_STATISTICS_COUNT_BLOCK(handle, block_type, block_num_samples, header_size, block_size)
+#endif
+
 /* ブロックデータタイプ */
 typedef enum SLABlockDataTypeTag {
   SLA_BLOCK_DATA_TYPE_COMPRESSDATA  = 0,     /* 圧縮済みデータ */
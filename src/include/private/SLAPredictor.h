@@ -1,7 +1,7 @@
 #ifndef SLAPREDICTOR_H_INCLUDED
 #define SLAPREDICTOR_H_INCLUDED
 
-#include "SLAStdint.h"
+#include "SLA.h"
 
 /* LPC係数計算ハンドル */
 struct SLALPCCalculator;
@@ -37,6 +37,23 @@ typedef enum SLAPredictorApiResultTag {
 extern "C" {
 #endif
 
+/* 使用する命令セットの設定 */
+/* 補足）SLA_SIMDINSTRUCTIONSET_AUTOで実行環境で使用可能な命令セットを選択。
+ *       設定はこれ以降に作成したハンドルに反映される（他スレッドのハンドル作成と同時に呼ばないこと） */
+SLAPredictorApiResult SLAPredictor_SetSIMDInstructionSet(SLASIMDInstructionSet simd);
+
+/* 使用中の命令セットの取得 */
+SLASIMDInstructionSet SLAPredictor_GetSIMDInstructionSet(void);
+
+/* 実行環境で使用可能な全命令セットの計算カーネルをリファレンス実装と照合 */
+SLAPredictorApiResult SLAPredictor_CheckKernels(void);
+
+/* LPC係数計算ハンドルのワークサイズ計算 */
+int32_t SLALPCCalculator_CalculateWorkSize(uint32_t max_order);
+
+/* LPC係数計算ハンドルの作成（ワーク領域指定） */
+struct SLALPCCalculator* SLALPCCalculator_CreateWithWork(uint32_t max_order, void* work, int32_t work_size);
+
 /* LPC係数計算ハンドルの作成 */
 struct SLALPCCalculator* SLALPCCalculator_Create(uint32_t max_order);
 
@@ -62,6 +79,12 @@ SLAPredictorApiResult SLALPCCalculator_CalculateResidualPower(
     const double* parcor_coef, uint32_t order,
     double* residual_power);
 
+/* LPC音声合成ハンドルのワークサイズ計算 */
+int32_t SLALPCSynthesizer_CalculateWorkSize(uint32_t max_order);
+
+/* LPC音声合成ハンドルの作成（ワーク領域指定） */
+struct SLALPCSynthesizer* SLALPCSynthesizer_CreateWithWork(uint32_t max_order, void* work, int32_t work_size);
+
 /* LPC音声合成ハンドルの作成 */
 struct SLALPCSynthesizer* SLALPCSynthesizer_Create(uint32_t max_order);
 
@@ -87,6 +110,41 @@ SLAPredictorApiResult SLALPCSynthesizer_SynthesizeByParcorCoefInt32(
     const int32_t* parcor_coef, uint32_t order,
     int32_t* output);
 
+/* PARCOR係数により誤差信号から音声合成（16bit幅の後ろ向き誤差, 32bit整数入出力） */
+/* 係数parcor_coefはorder+1個の配列 */
+/* 16bit幅に収まらなくなった時点で32bit幅の合成に切り替わる（結果は32bit版と一致） */
+SLAPredictorApiResult SLALPCSynthesizer_SynthesizeByParcorCoefInt16(
+    struct SLALPCSynthesizer* lpcs,
+    const int32_t* residual, uint32_t num_samples,
+    const int32_t* parcor_coef, uint32_t order,
+    int32_t* output);
+
+/* 次数固定のPARCOR係数による誤差信号からの音声合成（32bit整数入出力） */
+/* 係数parcor_coefはorder+1個の配列 */
+SLAPredictorApiResult SLALPCSynthesizer_SynthesizeByParcorCoefInt32Order8(
+    struct SLALPCSynthesizer* lpcs,
+    const int32_t* residual, uint32_t num_samples,
+    const int32_t* parcor_coef, int32_t* output);
+SLAPredictorApiResult SLALPCSynthesizer_SynthesizeByParcorCoefInt32Order16(
+    struct SLALPCSynthesizer* lpcs,
+    const int32_t* residual, uint32_t num_samples,
+    const int32_t* parcor_coef, int32_t* output);
+SLAPredictorApiResult SLALPCSynthesizer_SynthesizeByParcorCoefInt32Order32(
+    struct SLALPCSynthesizer* lpcs,
+    const int32_t* residual, uint32_t num_samples,
+    const int32_t* parcor_coef, int32_t* output);
+
+/* ロングターム計算ハンドルのワークサイズ計算 */
+int32_t SLALongTermCalculator_CalculateWorkSize(
+    uint32_t fft_size, uint32_t max_pitch_period, 
+    uint32_t max_num_pitch_candidates, uint32_t max_num_taps);
+
+/* ロングターム計算ハンドルの作成（ワーク領域指定） */
+struct SLALongTermCalculator* SLALongTermCalculator_CreateWithWork(
+    uint32_t fft_size, uint32_t max_pitch_period, 
+    uint32_t max_num_pitch_candidates, uint32_t max_num_taps,
+    void* work, int32_t work_size);
+
 /* ロングターム計算ハンドルの作成 */
 struct SLALongTermCalculator* SLALongTermCalculator_Create(
     uint32_t fft_size, uint32_t max_pitch_period, 
@@ -101,6 +159,13 @@ SLAPredictorApiResult SLALongTermCalculator_CalculateCoef(
 	const int32_t* data, uint32_t num_samples,
 	uint32_t* pitch_num_samples, double* ltm_coef, uint32_t num_taps);
 
+/* ロングターム予測合成ハンドルのワークサイズ計算 */
+int32_t SLALongTermSynthesizer_CalculateWorkSize(uint32_t max_num_taps, uint32_t max_pitch_period);
+
+/* ロングターム予測合成ハンドル作成（ワーク領域指定） */
+struct SLALongTermSynthesizer* SLALongTermSynthesizer_CreateWithWork(
+    uint32_t max_num_taps, uint32_t max_pitch_period, void* work, int32_t work_size);
+
 /* ロングターム予測合成ハンドル作成 */
 struct SLALongTermSynthesizer* SLALongTermSynthesizer_Create(uint32_t max_num_taps, uint32_t max_pitch_period);
 
@@ -124,6 +189,22 @@ SLAPredictorApiResult SLALongTermSynthesizer_SynthesizeInt32(
 	uint32_t pitch_period,
 	const int32_t* ltm_coef, uint32_t num_taps, int32_t* output);
 
+/* タップ数固定のロングターム誤差信号から音声合成 */
+SLAPredictorApiResult SLALongTermSynthesizer_SynthesizeInt32Taps1(
+  struct SLALongTermSynthesizer* ltm,
+	const int32_t* residual, uint32_t num_samples,
+	uint32_t pitch_period, const int32_t* ltm_coef, int32_t* output);
+SLAPredictorApiResult SLALongTermSynthesizer_SynthesizeInt32Taps3(
+  struct SLALongTermSynthesizer* ltm,
+	const int32_t* residual, uint32_t num_samples,
+	uint32_t pitch_period, const int32_t* ltm_coef, int32_t* output);
+
+/* LMS計算ハンドルのワークサイズ計算 */
+int32_t SLALMSFilter_CalculateWorkSize(uint32_t max_num_coef);
+
+/* LMS計算ハンドルの作成（ワーク領域指定） */
+struct SLALMSFilter* SLALMSFilter_CreateWithWork(uint32_t max_num_coef, void* work, int32_t work_size);
+
 /* LMS計算ハンドルの作成 */
 struct SLALMSFilter* SLALMSFilter_Create(uint32_t max_num_coef);
 
@@ -143,11 +224,27 @@ SLAPredictorApiResult SLALMSFilter_SynthesizeInt32(
     struct SLALMSFilter* nlms, uint32_t num_coef,
     const int32_t* residual, uint32_t num_samples, int32_t* output);
 
+/* 次数固定のLMS合成 */
+SLAPredictorApiResult SLALMSFilter_SynthesizeInt32Order4(
+    struct SLALMSFilter* nlms,
+    const int32_t* residual, uint32_t num_samples, int32_t* output);
+SLAPredictorApiResult SLALMSFilter_SynthesizeInt32Order8(
+    struct SLALMSFilter* nlms,
+    const int32_t* residual, uint32_t num_samples, int32_t* output);
+
+/* 探索ハンドルのワークサイズ計算 */
+int32_t SLAOptimalEncodeEstimator_CalculateWorkSize(
+    uint32_t max_num_samples, uint32_t delta_num_samples);
+
+/* 探索ハンドルの作成（ワーク領域指定） */
+struct SLAOptimalBlockPartitionEstimator* SLAOptimalEncodeEstimator_CreateWithWork(
+    uint32_t max_num_samples, uint32_t delta_num_samples, void* work, int32_t work_size);
+
 /* 探索ハンドルの作成 */
 struct SLAOptimalBlockPartitionEstimator* SLAOptimalEncodeEstimator_Create(
     uint32_t max_num_samples, uint32_t delta_num_samples);
 
-/* 最適なブロック分割の探索ハンドルの作成 */
+/* 探索ハンドルの破棄 */
 void SLAOptimalEncodeEstimator_Destroy(struct SLAOptimalBlockPartitionEstimator* oee);
 
 /* 最適なブロック分割の探索 */
@@ -163,6 +260,12 @@ SLAPredictorApiResult SLAOptimalEncodeEstimator_SearchOptimalBlockPartitions(
 uint32_t SLAOptimalEncodeEstimator_CalculateMaxNumPartitions(
     uint32_t max_num_samples, uint32_t delta_num_samples);
 
+/* エンファシスフィルタのワークサイズ計算 */
+int32_t SLAEmphasisFilter_CalculateWorkSize(void);
+
+/* エンファシスフィルタの作成（ワーク領域指定） */
+struct SLAEmphasisFilter* SLAEmphasisFilter_CreateWithWork(void* work, int32_t work_size);
+
 /* エンファシスフィルタの作成 */
 struct SLAEmphasisFilter* SLAEmphasisFilter_Create(void);
 
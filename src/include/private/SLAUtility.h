@@ -1,12 +1,15 @@
 #ifndef SLAUTILITY_H_INCLUDED
 #define SLAUTILITY_H_INCLUDED
 
-#include "SLAStdint.h"
+#include "SLA.h"
+#include <stddef.h>
 
-#if defined(__SSE4_1__)
-/* SSE命令を使用した最適化コードを使用する */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+/* SSE命令を使用した最適化コードをビルドする（使用するかは実行時に判定） */
 #define USE_SSE
 #include <x86intrin.h>
+/* SSE4.1命令を使用する関数の修飾子 */
+#define SLAUTILITY_TARGET_SSE41 __attribute__((target("sse4.1")))
 #endif
 
 /* 円周率 */
@@ -65,6 +68,17 @@
 #define SLAUTILITY_ROUNDUP2POWERED(x) SLAUtility_RoundUp2PoweredSoft(x)
 #endif
 
+/* ワーク領域のアラインメント（キャッシュライン幅） */
+#define SLA_MEMORY_ALIGNMENT 64
+/* nの倍数への切り上げ */
+#define SLAUTILITY_ROUNDUP(val, n) ((((val) + ((n) - 1)) / (n)) * (n))
+/* ワーク領域から切り出す領域のサイズ（アラインメント単位に切り上げ） */
+#define SLAUTILITY_WORK_SIZE(size) ((int32_t)SLAUTILITY_ROUNDUP((size), SLA_MEMORY_ALIGNMENT))
+/* ワークサイズの合計計算用（桁あふれしないよう64bitで計算） */
+#define SLAUTILITY_WORK_SIZE64(size) ((uint64_t)SLAUTILITY_ROUNDUP((uint64_t)(size), SLA_MEMORY_ALIGNMENT))
+/* ワーク領域の先頭をアラインメント境界に合わせる */
+#define SLAUTILITY_ALIGN_WORK(ptr) ((uint8_t *)SLAUTILITY_ROUNDUP((uintptr_t)(ptr), SLA_MEMORY_ALIGNMENT))
+
 /* データパケットキューのAPI結果 */
 typedef enum SLADataPacketQueueApiResultTag {
   SLA_DATAPACKETQUEUE_APIRESULT_OK = 0,
@@ -104,6 +118,14 @@ void SLAUtility_FFT(double* data, uint32_t n, int32_t sign);
 /* CRC16(CRC-IBM)の計算 */
 uint16_t SLAUtility_CalculateCRC16(const uint8_t* data, uint64_t data_size);
 
+/* CRC16(CRC-IBM)の途中結果に続くデータを加えた値の計算 */
+/* 補足）データを分割して計算しても一括で計算した結果と一致する */
+uint16_t SLAUtility_UpdateCRC16(uint16_t crc16, const uint8_t* data, uint64_t data_size);
+
+/* ブロック先頭のデータからブロックサンプル数を読み出し */
+/* 補足）サンプル数を読み出すのにデータが足りない場合は0を返す */
+uint32_t SLAUtility_GetBlockNumSamples(const uint8_t* block_data, uint32_t data_size);
+
 /* NLZ（最上位ビットから1に当たるまでのビット数）の計算 */
 uint32_t SLAUtility_NLZSoft(uint32_t val);
 
@@ -125,6 +147,16 @@ double SLAUtility_Round(double d);
 /* log2関数（C89で定義されていない） */
 double SLAUtility_Log2(double x);
 
+/* ワーク領域から領域を切り出し、ワーク領域の参照位置を進める */
+/* 補足）work_ptrはアラインメント境界に合っていること */
+void* SLAUtility_AllocateWork(uint8_t** work_ptr, size_t size);
+
+/* 連立一次方程式ソルバーのワークサイズ計算 */
+int32_t SLALESolver_CalculateWorkSize(uint32_t max_dim);
+
+/* 連立一次方程式ソルバーの作成（ワーク領域指定） */
+struct SLALESolver* SLALESolver_CreateWithWork(uint32_t max_dim, void* work, int32_t work_size);
+
 /* 連立一次方程式ソルバーの作成 */
 struct SLALESolver* SLALESolver_Create(uint32_t max_dim);
 
@@ -142,6 +174,18 @@ int32_t SLALESolver_Solve(
 uint32_t SLAUtility_GetDataBitWidth(
     const int32_t* data, uint32_t num_samples);
 
+/* 実行環境で使用可能な最上位のSIMD命令セットを取得 */
+SLASIMDInstructionSet SLAUtility_GetAvailableSIMDInstructionSet(void);
+
+/* 統計情報用の時刻取得[tick] */
+uint64_t SLAUtility_GetStatisticsTick(void);
+
+/* 統計情報用の1秒あたりのtick数 */
+uint64_t SLAUtility_GetStatisticsTicksPerSecond(void);
+
+/* 統計情報用の時刻を計測する時計の種類 */
+SLAStatisticsClock SLAUtility_GetStatisticsTickClock(void);
+
 /* パケットキューの作成 */
 struct SLADataPacketQueue* SLADataPacketQueue_Create(uint32_t max_num_packets);
 
@@ -156,6 +200,19 @@ SLADataPacketQueueApiResult SLADataPacketQueue_EnqueueDataFragment(
 SLADataPacketQueueApiResult SLADataPacketQueue_GetDataFragment(
     struct SLADataPacketQueue* queue, const uint8_t** data_ptr, uint32_t* data_size, uint32_t max_data_size);
 
+/* 未読み出しのデータ片の参照（読み出し位置は進めない） */
+SLADataPacketQueueApiResult SLADataPacketQueue_PeekDataFragment(
+    const struct SLADataPacketQueue* queue, const uint8_t** data_ptr, uint32_t* data_size);
+
+/* 未読み出しのデータの先頭からoffsetバイト目以降をコピー（読み出し位置は進めない） */
+SLADataPacketQueueApiResult SLADataPacketQueue_PeekData(
+    const struct SLADataPacketQueue* queue, uint32_t offset, uint8_t* data, uint32_t data_size);
+
+/* 未読み出しのデータの先頭からoffsetバイト目を含むデータ片の参照（読み出し位置は進めない） */
+/* 補足）data_ptrはoffsetバイト目を指し、data_sizeにはそのデータ片の残りサイズを返す */
+SLADataPacketQueueApiResult SLADataPacketQueue_PeekDataFragmentAt(
+    const struct SLADataPacketQueue* queue, uint32_t offset, const uint8_t** data_ptr, uint32_t* data_size);
+
 /* 消費済みデータ片の回収 */
 SLADataPacketQueueApiResult SLADataPacketQueue_DequeueDataFragment(
     struct SLADataPacketQueue* queue, const uint8_t** data_ptr, uint32_t* data_size);
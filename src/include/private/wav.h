@@ -26,7 +26,7 @@ struct WAVFileFormat {
   uint32_t      num_channels;     /* チャンネル数 */
   uint32_t      sampling_rate;    /* サンプリングレート */
   uint32_t      bits_per_sample;  /* 量子化ビット数 */
-  uint32_t      num_samples;      /* サンプル数 */
+  uint64_t      num_samples;      /* サンプル数 */
 };
 
 /* WAVファイルハンドル */
@@ -38,6 +38,12 @@ struct WAVFile {
 /* アクセサ */
 #define WAVFile_PCM(wavfile, samp, ch)  (wavfile->data[(ch)][(samp)])
 
+/* WAVストリーム読み込みハンドル */
+struct WAVStreamReader;
+
+/* WAVストリーム書き出しハンドル */
+struct WAVStreamWriter;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -59,6 +65,47 @@ WAVApiResult WAV_WriteToFile(
 WAVApiResult WAV_GetWAVFormatFromFile(
     const char* filename, struct WAVFileFormat* format);
 
+/* ストリーム読み込みの開始（ヘッダまで読み込む） */
+/* 補足）ファイル名が"-"ならば標準入力から読み込む。RF64/BW64, Wave64のファイルも読み込める */
+struct WAVStreamReader* WAVStreamReader_Open(const char* filename);
+
+/* ストリーム読み込みの終了 */
+void WAVStreamReader_Close(struct WAVStreamReader* reader);
+
+/* フォーマットの取得 */
+const struct WAVFileFormat* WAVStreamReader_GetFormat(const struct WAVStreamReader* reader);
+
+/* PCMデータをチャンネル毎の配列に読み込み */
+/* 補足）データ末尾に達した場合は読み込めた分だけ返す */
+WAVApiResult WAVStreamReader_Read(struct WAVStreamReader* reader,
+    WAVPcmData** data, uint32_t num_samples, uint32_t* num_read_samples);
+
+/* PCMデータをファイル上の形式（インターリーブ・リトルエンディアン）のまま読み込み */
+/* 補足）dataには num_samples * チャンネル数 * (ビット深度/8) バイトの領域が必要
+ *       データ末尾に達した場合は読み込めた分だけ返す */
+WAVApiResult WAVStreamReader_ReadInterleaved(struct WAVStreamReader* reader,
+    void* data, uint32_t num_samples, uint32_t* num_read_samples);
+
+/* 読み込み位置をPCMデータの先頭に戻す */
+/* 補足）パイプ等のシークできない入力ではWAV_APIRESULT_IOERRORを返す */
+WAVApiResult WAVStreamReader_Rewind(struct WAVStreamReader* reader);
+
+/* ストリーム書き出しの開始（ヘッダを書き出す） */
+/* 補足）ファイル名が"-"ならば標準出力に書き出す。PCMデータが4GiBを超える場合はRF64形式で書き出す */
+struct WAVStreamWriter* WAVStreamWriter_Open(const char* filename, const struct WAVFileFormat* format);
+
+/* PCMデータをチャンネル毎の配列から書き出し */
+WAVApiResult WAVStreamWriter_Write(struct WAVStreamWriter* writer,
+    const WAVPcmData* const* data, uint32_t num_samples);
+
+/* ファイル上の形式（インターリーブ・リトルエンディアン）のPCMデータをそのまま書き出し */
+WAVApiResult WAVStreamWriter_WriteInterleaved(struct WAVStreamWriter* writer,
+    const void* data, uint32_t num_samples);
+
+/* ストリーム書き出しの終了 */
+/* 補足）書き出したサンプル数がヘッダと異なる場合は、シークできればヘッダのサイズを書き直す */
+WAVApiResult WAVStreamWriter_Close(struct WAVStreamWriter* writer);
+
 #ifdef __cplusplus
 }
 #endif
@@ -6,17 +6,35 @@
 /* バージョン文字列 */
 #define SLA_VERSION_STRING          "1.0.0"
 /* フォーマットバージョン */
-#define SLA_FORMAT_VERSION			    1
+#define SLA_FORMAT_VERSION			    3
 /* ヘッダのサイズ */
-#define SLA_HEADER_SIZE			        43
+#define SLA_HEADER_SIZE			        49
+/* フォーマットバージョン1のヘッダのサイズ（ヘッダのデコードに最低限必要なサイズ） */
+#define SLA_HEADER_SIZE_V1		      43
+/* フォーマットバージョン2のヘッダのサイズ */
+#define SLA_HEADER_SIZE_V2		      47
+/* 記録可能な最大チャンネル数（ヘッダのチャンネル数は1byte） */
+#define SLA_MAX_NUM_CHANNELS        255
+/* 記録可能なブロックあたり最大サンプル数 */
+#define SLA_MAX_NUM_BLOCK_SAMPLES   1048576
 /* ブロックヘッダのサイズ */
 #define SLA_BLOCK_HEADER_SIZE			  10
 /* サンプル数の無効値 */
-#define SLA_NUM_SAMPLES_INVALID		  0xFFFFFFFF
+#define SLA_NUM_SAMPLES_INVALID		  (~(uint64_t)0)
 /* SLAブロック数の無効値 */
 #define SLA_NUM_BLOCKS_INVALID		  0xFFFFFFFF
 /* 最大ブロックサイズの無効値 */
 #define SLA_MAX_BLOCK_SIZE_INVAILD	0xFFFFFFFF
+/* ブロック索引ファイルのフォーマットバージョン */
+#define SLA_BLOCK_INDEX_FORMAT_VERSION  2
+/* ブロック索引ファイルのヘッダサイズ */
+#define SLA_BLOCK_INDEX_HEADER_SIZE     32
+/* ブロック索引ファイルのヘッダサイズ（バージョン1: オフセット・サンプル数が32bit） */
+#define SLA_BLOCK_INDEX_HEADER_SIZE_V1  24
+/* ブロック索引ファイルのエントリあたりサイズ */
+#define SLA_BLOCK_INDEX_ENTRY_SIZE      26
+/* ブロック索引ファイルのエントリあたりサイズ（バージョン1） */
+#define SLA_BLOCK_INDEX_ENTRY_SIZE_V1   18
 
 /* ブロックエンコード/デコードに十分なブロックサイズ */
 #define SLA_CalculateSufficientBlockSize(num_channels, num_samples, bit_per_sample)	\
@@ -39,7 +57,11 @@ typedef enum SLAApiResultTag {
   SLA_APIRESULT_FAILED_TO_FIND_SYNC_CODE,     /* 同期コードを発見できなかった */
   SLA_APIRESULT_INVALID_WINDOWFUNCTION_TYPE,  /* 不正な窓関数が指定された */
   SLA_APIRESULT_NO_DATA_FRAGMENTS,            /* 回収可能なデータ片が存在しない */
-  SLA_APIRESULT_PARAMETER_NOT_SET             /* 波形パラメータ/エンコードパラメータがハンドルにセットされていない */
+  SLA_APIRESULT_PARAMETER_NOT_SET,            /* 波形パラメータ/エンコードパラメータがハンドルにセットされていない */
+  SLA_APIRESULT_UNSUPPORTED_INSTRUCTION_SET,  /* 実行環境で使用できない命令セットが指定された */
+  SLA_APIRESULT_STATISTICS_DISABLED,          /* 統計情報の収集が無効なビルド */
+  SLA_APIRESULT_INDEX_SOURCE_MISMATCH,        /* ブロック索引が対象のデータと一致しない */
+  SLA_APIRESULT_CACHE_MISS                    /* キャッシュに目的のブロックがない */
 } SLAApiResult;
 
 /* マルチチャンネル処理方法 */
@@ -57,6 +79,59 @@ typedef enum SLAWindowFunctionTypeTag {
 	SLA_WINDOWFUNCTIONTYPE_VORBIS	            /* Vorbis窓             */
 } SLAWindowFunctionType;
 
+/* SIMD命令セット */
+/* 補足）値が大きいほど上位の命令セット */
+typedef enum SLASIMDInstructionSetTag {
+  SLA_SIMDINSTRUCTIONSET_NONE = 0,          /* SIMD命令を使用しない                   */
+  SLA_SIMDINSTRUCTIONSET_SSE41,             /* SSE4.1                                 */
+  SLA_SIMDINSTRUCTIONSET_AUTO = 0xFF        /* 実行環境で使用可能な命令セットを自動選択 */
+} SLASIMDInstructionSet;
+
+/* PCMサンプルの型（エンコーダ入力/デコーダ出力） */
+typedef enum SLAPcmSampleTypeTag {
+  SLA_PCM_SAMPLE_TYPE_INT16 = 0,              /* 16bit符号付き整数（右詰め）                              */
+  SLA_PCM_SAMPLE_TYPE_PACKED_INT24,           /* 3byte詰め24bit符号付き整数（右詰め・リトルエンディアン） */
+  SLA_PCM_SAMPLE_TYPE_INT32,                  /* 32bit符号付き整数（右詰め）                              */
+  SLA_PCM_SAMPLE_TYPE_INT32_LEFT_JUSTIFIED,   /* 32bit符号付き整数（左詰め・従来のAPIと同じ形式）         */
+  SLA_PCM_SAMPLE_TYPE_FLOAT32                 /* 32bit浮動小数点（[-1,1)に正規化・デコーダ出力のみ）      */
+} SLAPcmSampleType;
+
+/* 統計情報の処理段階 */
+typedef enum SLAStatisticsStageTag {
+  SLA_STATISTICS_STAGE_PARTITION_SEARCH = 0,  /* ブロック分割探索（エンコードのみ） */
+  SLA_STATISTICS_STAGE_LPC,                   /* PARCOR予測/合成（エンファシス含む） */
+  SLA_STATISTICS_STAGE_LONGTERM,              /* ロングターム予測/合成             */
+  SLA_STATISTICS_STAGE_LMS,                   /* LMS予測/合成                      */
+  SLA_STATISTICS_STAGE_ENTROPY_CODING,        /* エントロピー符号化/復号           */
+  SLA_STATISTICS_STAGE_CRC,                   /* CRC16計算                         */
+  SLA_STATISTICS_NUM_STAGES                   /* 処理段階の数                      */
+} SLAStatisticsStage;
+
+/* 統計情報の処理時間計測に使う時計 */
+typedef enum SLAStatisticsClockTag {
+  SLA_STATISTICS_CLOCK_MONOTONIC = 0,         /* 単調増加の実時間（clock_gettime(CLOCK_MONOTONIC)） */
+  SLA_STATISTICS_CLOCK_PROCESS_CPU,           /* プロセスのCPU時間（clock()）                       */
+  SLA_STATISTICS_CLOCK_USER_DEFINED           /* ビルド時に差し替えた時計（単位はticks_per_second） */
+} SLAStatisticsClock;
+
+/* 統計情報のライス符号パラメータヒストグラムのビン数 */
+#define SLA_STATISTICS_RICE_HISTOGRAM_SIZE  32
+
+/* エンコード/デコード統計情報 */
+/* 補足）SLA_ENABLE_STATISTICSを定義してビルドした場合のみ収集される */
+struct SLAStatistics {
+  uint64_t  stage_ticks[SLA_STATISTICS_NUM_STAGES]; /* 処理段階毎の処理時間[tick]                     */
+  uint64_t  ticks_per_second;                       /* 1秒あたりのtick数                              */
+  SLAStatisticsClock tick_clock;                    /* tickを計測した時計                             */
+  uint32_t  num_compressed_blocks;                  /* 圧縮ブロック数                                 */
+  uint32_t  num_silent_blocks;                      /* 無音ブロック数                                 */
+  uint32_t  num_raw_blocks;                         /* 生データブロック数                             */
+  uint64_t  num_samples;                            /* 処理サンプル数（全チャンネル合計）             */
+  uint64_t  coefficient_bits;                       /* ブロックヘッダ（係数等）のビット数             */
+  uint64_t  residual_bits;                          /* ブロックデータ（残差/生データ）のビット数      */
+  uint64_t  rice_parameter_histogram[SLA_STATISTICS_RICE_HISTOGRAM_SIZE]; /* log2(ライス符号パラメータ)毎の符号化回数 */
+};
+
 /* 波形フォーマット */
 struct SLAWaveFormat {
 	uint32_t  num_channels;			/* チャンネル数             */
@@ -79,10 +154,31 @@ struct SLAEncodeParameter {
 struct SLAHeaderInfo {
 	struct SLAWaveFormat      wave_format;	      /* 波形フォーマット         */
   struct SLAEncodeParameter encode_param;       /* エンコードパラメータ     */
-	uint32_t                  num_samples;			  /* 全サンプル数             */
+	uint64_t                  num_samples;			  /* 全サンプル数             */
   uint32_t                  num_blocks;         /* ブロック数               */
 	uint32_t                  max_block_size;		  /* 最大ブロックサイズ[byte] */
   uint32_t                  max_bit_per_second; /* 最大bps                  */
+  uint32_t                  header_size;        /* ヘッダサイズ[byte]（先頭ブロックの位置。デコード時に設定） */
 };
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 使用するSIMD命令セットの設定 */
+/* 補足）設定しない場合は実行環境で使用可能な命令セットを自動選択する。
+ *       設定はこれ以降に作成したエンコーダ/デコーダハンドルに反映されるので、ハンドル作成前に呼ぶこと。
+ *       他スレッドでのハンドル作成と同時に呼んではならない */
+SLAApiResult SLA_SetSIMDInstructionSet(SLASIMDInstructionSet simd);
+
+/* 使用中のSIMD命令セットの取得 */
+SLASIMDInstructionSet SLA_GetSIMDInstructionSet(void);
+
+/* 実行環境で使用可能な全命令セットの演算がリファレンス実装と一致するか自己診断 */
+SLAApiResult SLA_CheckSIMDInstructionSet(void);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* SLA_H_INCLUDED */
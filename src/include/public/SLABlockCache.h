@@ -0,0 +1,72 @@
+#ifndef SLA_BLOCK_CACHE_H_INCLUDED
+#define SLA_BLOCK_CACHE_H_INCLUDED
+
+#include "SLA.h"
+#include "SLAStdint.h"
+
+/* ブロックキャッシュハンドル */
+struct SLABlockCache;
+
+/* 排他制御関数型（分割単位でロック/アンロックする） */
+typedef void (*SLABlockCacheLockFunction)(void* lock_context, uint32_t shard_no);
+
+/* ブロックキャッシュコンフィグ */
+struct SLABlockCacheConfig {
+  uint32_t                  max_num_channels;       /* 最大チャンネル数                                 */
+  uint32_t                  max_num_block_samples;  /* 最大ブロックサンプル数                           */
+  uint32_t                  max_cache_size;         /* キャッシュするデコード結果の総サイズ上限[byte]   */
+  uint32_t                  num_shards;             /* 分割数（ロックの単位）                           */
+  SLABlockCacheLockFunction lock;                   /* ロック関数（NULLならば排他制御しない）           */
+  SLABlockCacheLockFunction unlock;                 /* アンロック関数                                   */
+  void*                     lock_context;           /* ロック/アンロック関数に渡す引数                  */
+};
+
+/* ブロックキャッシュの利用状況 */
+struct SLABlockCacheStatistics {
+  uint32_t  num_slots;      /* 格納可能なブロック数   */
+  uint32_t  num_used_slots; /* 格納中のブロック数     */
+  uint32_t  num_hits;       /* ヒット回数             */
+  uint32_t  num_misses;     /* ミス回数               */
+  uint32_t  num_evictions;  /* 追い出したブロック数   */
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ブロックキャッシュの作成に必要なワークサイズ計算 */
+/* 補足）不正なコンフィグの場合は負値を返す */
+int32_t SLABlockCache_CalculateWorkSize(const struct SLABlockCacheConfig* config);
+
+/* ブロックキャッシュの作成（ワーク領域指定） */
+struct SLABlockCache* SLABlockCache_CreateWithWork(const struct SLABlockCacheConfig* config, void* work, int32_t work_size);
+
+/* ブロックキャッシュの作成 */
+struct SLABlockCache* SLABlockCache_Create(const struct SLABlockCacheConfig* config);
+
+/* ブロックキャッシュの破棄 */
+void SLABlockCache_Destroy(struct SLABlockCache* cache);
+
+/* デコード済みブロックの取得 */
+/* 補足）(stream_id, block_no)のブロックがなければSLA_APIRESULT_CACHE_MISSを返す */
+SLAApiResult SLABlockCache_Get(struct SLABlockCache* cache,
+    uint32_t stream_id, uint32_t block_no,
+    int32_t** buffer, uint32_t num_channels, uint32_t buffer_num_samples, uint32_t* output_num_samples);
+
+/* デコード済みブロックの格納 */
+/* 補足）空きがなければ最も長く参照されていないブロックを追い出す */
+SLAApiResult SLABlockCache_Put(struct SLABlockCache* cache,
+    uint32_t stream_id, uint32_t block_no,
+    const int32_t* const* samples, uint32_t num_channels, uint32_t num_samples);
+
+/* ストリームのブロックを全て破棄 */
+SLAApiResult SLABlockCache_Invalidate(struct SLABlockCache* cache, uint32_t stream_id);
+
+/* 利用状況の取得 */
+SLAApiResult SLABlockCache_GetStatistics(struct SLABlockCache* cache, struct SLABlockCacheStatistics* statistics);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SLA_BLOCK_CACHE_H_INCLUDED */
@@ -2,6 +2,7 @@
 #define SLA_DECODER_H_INCLUDED
 
 #include "SLA.h"
+#include "SLABlockCache.h"
 #include "SLAStdint.h"
 
 /* デコーダバージョン */
@@ -13,6 +14,9 @@ struct SLADecoder;
 /* ストリーミングデコーダハンドル */
 struct SLAStreamingDecoder;
 
+/* デコーダハンドルプール */
+struct SLADecoderPool;
+
 /* デコーダコンフィグ */
 struct SLADecoderConfig {
 	uint32_t  max_num_channels;			      /* エンコード可能な最大チャンネル数 */
@@ -24,6 +28,59 @@ struct SLADecoderConfig {
   uint8_t   verpose_flag;               /* 詳細な情報を表示するか */
 };
 
+/* 一括デコードの入出力 */
+struct SLADecodeBatchItem {
+  const uint8_t*  data;                 /* [in] SLAデータ（ヘッダを含む）   */
+  uint32_t        data_size;            /* [in] データサイズ                */
+  int32_t**       buffer;               /* [in] チャンネル毎の出力先        */
+  uint32_t        buffer_num_samples;   /* [in] 出力先のチャンネルあたりサンプル数 */
+  uint32_t        output_num_samples;   /* [out] デコードしたサンプル数     */
+  SLAApiResult    result;               /* [out] このデータのデコード結果   */
+};
+
+/* 完全性検証の結果 */
+struct SLAVerifyResult {
+  uint32_t  num_blocks;     /* 検証したブロック数 */
+  uint64_t  num_samples;    /* 検証したブロックのチャンネルあたりサンプル数の合計 */
+  uint64_t  error_offset;   /* 異常を検出した位置（正常時はデータ末尾）[byte] */
+};
+
+/* 一括デコードの並列実行に使うスレッド操作 */
+/* 補足）spawnはfunc(arg)を別スレッドで実行し、そのスレッドを識別する値を返す（起動できなければNULL）。
+ *       joinはspawnが返したスレッドの終了を待つ。user_dataはそれぞれにそのまま渡される */
+struct SLADecodeBatchThreadFunctions {
+  void* (*spawn)(void (*func)(void* arg), void* arg, void* user_data);
+  void  (*join)(void* thread, void* user_data);
+  void* user_data;
+};
+
+/* PCM出力 */
+/* 補足）インターリーブ形式ならchannel_data[ch]にch番目のサンプルの書き込み先・strideにチャンネル数を、
+ *       チャンネル毎の形式ならchannel_data[ch]に各チャンネルの先頭アドレス・strideに1を指定する
+ *       右詰めの型にはbit_per_sampleビットの値を書き出す */
+struct SLAPcmOutput {
+  SLAPcmSampleType  sample_type;  /* サンプルの型 */
+  void* const*      channel_data; /* チャンネル毎の先頭サンプルの書き込み先 */
+  uint32_t          stride;       /* 同一チャンネルの次のサンプルまでの間隔（サンプル数単位） */
+};
+
+/* ブロック索引のエントリ */
+struct SLABlockIndexEntry {
+  uint64_t  data_offset;        /* データ先頭からブロック先頭までのオフセット[byte] */
+  uint64_t  sample_offset;      /* ブロック先頭のサンプル位置                       */
+  uint32_t  block_size;         /* ブロックサイズ[byte]                             */
+  uint32_t  num_samples;        /* ブロックのチャンネルあたりサンプル数             */
+  uint16_t  crc16;              /* ブロックに記録されたCRC16                        */
+};
+
+/* ブロック索引ファイルの情報 */
+struct SLABlockIndexInfo {
+  uint64_t  source_data_size;     /* 索引を作成したデータのサイズ[byte]   */
+  uint16_t  source_header_crc16;  /* 索引を作成したデータのヘッダのCRC16  */
+  uint64_t  num_samples;          /* 索引に含まれる全サンプル数           */
+  uint32_t  num_entries;          /* 索引のエントリ数                     */
+};
+
 /* ストリーミングデコーダコンフィグ */
 struct SLAStreamingDecoderConfig {
   struct SLADecoderConfig core_config;          /* デコーダコンフィグ         */
@@ -39,12 +96,25 @@ extern "C" {
 SLAApiResult SLADecoder_DecodeHeader(
     const uint8_t* data, uint32_t data_size, struct SLAHeaderInfo* header_info);
 
+/* デコーダハンドルの作成に必要なワークサイズ計算 */
+/* 補足）不正なコンフィグの場合は負値を返す */
+int32_t SLADecoder_CalculateWorkSize(const struct SLADecoderConfig* config);
+
+/* デコーダハンドルの作成（ワーク領域指定） */
+/* 補足）内部領域は全てworkから切り出す（先頭アドレスのアラインメントは不問）
+ * workはハンドル使用中は保持し、破棄後に呼び出し側で解放すること */
+struct SLADecoder* SLADecoder_CreateWithWork(const struct SLADecoderConfig* config, void* work, int32_t work_size);
+
 /* デコーダハンドルの作成 */
 struct SLADecoder* SLADecoder_Create(const struct SLADecoderConfig* condig);
 
 /* デコーダハンドルの破棄 */
 void SLADecoder_Destroy(struct SLADecoder* decoder);
 
+/* デコーダハンドルを新しいストリーム向けにリセット */
+/* 補足）セット済みの波形パラメータ・エンコードパラメータも破棄する */
+SLAApiResult SLADecoder_Reset(struct SLADecoder* decoder);
+
 /* 波形パラメータをデコーダにセット */
 SLAApiResult SLADecoder_SetWaveFormat(struct SLADecoder* decoder,
     const struct SLAWaveFormat* wave_format);
@@ -53,11 +123,147 @@ SLAApiResult SLADecoder_SetWaveFormat(struct SLADecoder* decoder,
 SLAApiResult SLADecoder_SetEncodeParameter(struct SLADecoder* decoder,
     const struct SLAEncodeParameter* encode_param);
 
+/* ブロック先頭のデータからブロックサイズを取得 */
+/* 補足）同期コードとブロックサイズのフィールドだけを読むので、ブロック全体が揃う前に使える */
+SLAApiResult SLADecoder_GetBlockSize(const uint8_t* data, uint32_t data_size, uint32_t* block_size);
+
+/* 1ブロックデコード */
+/* 補足）dataはブロック先頭を指すこと。データが1ブロックに満たなければSLA_APIRESULT_INSUFFICIENT_DATA_SIZEを返す */
+SLAApiResult SLADecoder_DecodeBlock(struct SLADecoder* decoder,
+    const uint8_t* data, uint32_t data_size,
+    int32_t** buffer, uint32_t buffer_num_samples,
+    uint32_t* output_block_size, uint32_t* output_num_samples);
+
 /* ヘッダを含めて全ブロックデコード（波形パラメータ・エンコードパラメータも自動でセット） */
 SLAApiResult SLADecoder_DecodeWhole(struct SLADecoder* decoder,
     const uint8_t* data, uint32_t data_size,
     int32_t** buffer, uint32_t buffer_num_samples, uint32_t* output_num_samples);
 
+/* 1ブロックデコード（PCM出力） */
+/* 補足）型変換・インターリーブはオフセット分の左シフトと同じパスで行う */
+SLAApiResult SLADecoder_DecodeBlockPcm(struct SLADecoder* decoder,
+    const uint8_t* data, uint32_t data_size,
+    const struct SLAPcmOutput* output, uint32_t buffer_num_samples,
+    uint32_t* output_block_size, uint32_t* output_num_samples);
+
+/* 1ブロックデコード（内部バッファの参照を返す） */
+/* 補足）buffer[ch]にデコーダ内部のチャンネル毎の領域（右詰め32bit整数）の先頭アドレスを返す。
+ *       内容はハンドルで次にデコードするまで有効 */
+SLAApiResult SLADecoder_DecodeBlockBorrowed(struct SLADecoder* decoder,
+    const uint8_t* data, uint32_t data_size, const int32_t** buffer,
+    uint32_t* output_block_size, uint32_t* output_num_samples);
+
+/* ヘッダを含めて全ブロックデコード（PCM出力・波形パラメータ・エンコードパラメータも自動でセット） */
+SLAApiResult SLADecoder_DecodeWholePcm(struct SLADecoder* decoder,
+    const uint8_t* data, uint32_t data_size,
+    const struct SLAPcmOutput* output, uint32_t buffer_num_samples, uint32_t* output_num_samples);
+
+/* 範囲デコードで参照するブロックキャッシュの設定 */
+/* 補足）キャッシュのキーは(stream_id, ブロック番号)。ブロック番号はブロック索引の位置（索引なしでは先頭からの順番）。
+ *       cacheにNULLを与えると参照を外す。SLADecoder_Resetでも外れる */
+SLAApiResult SLADecoder_SetBlockCache(struct SLADecoder* decoder,
+    struct SLABlockCache* cache, uint32_t stream_id);
+
+/* ヘッダを含むデータからサンプル範囲だけデコード（波形パラメータ・エンコードパラメータも自動でセット） */
+/* 補足）範囲にかかるブロックだけをデコードし、先頭/末尾ブロックは範囲外を切り捨てて出力する。
+ *       entriesにブロック索引を与えれば開始ブロックを二分探索し、NULLならブロックヘッダのサイズを辿って探す。
+ *       データ末尾を超える範囲は切り詰め、出力したサンプル数をoutput_num_samplesに返す。
+ *       データサイズ・開始サンプルは4GiB/2^32サンプルを超えてよい */
+SLAApiResult SLADecoder_DecodeRange(struct SLADecoder* decoder,
+    const uint8_t* data, uint64_t data_size,
+    const struct SLABlockIndexEntry* entries, uint32_t num_entries,
+    uint64_t start_sample, uint32_t num_samples,
+    int32_t** buffer, uint32_t buffer_num_samples, uint32_t* output_num_samples);
+
+/* 統計情報の取得 */
+/* 補足）SLA_ENABLE_STATISTICSを定義せずにビルドした場合はSLA_APIRESULT_STATISTICS_DISABLEDを返す */
+SLAApiResult SLADecoder_GetStatistics(const struct SLADecoder* decoder, struct SLAStatistics* statistics);
+
+/* 統計情報のリセット */
+SLAApiResult SLADecoder_ResetStatistics(struct SLADecoder* decoder);
+
+/* 同期コードの走査によるブロック索引の作成 */
+/* 補足）ヘッダを含むデータ全体を与える（ヘッダが壊れている場合は先頭から走査する）。
+ *       同期コードの候補はブロックサイズ・CRC16で検証し、有効なブロックのみ記録する。
+ *       entriesがNULLのときはブロック数の計数のみ行う。num_entriesにはどの結果でも見つかったブロック数を書き込む。
+ *       ブロック数がmax_num_entriesを超えるときは先頭max_num_entries個だけ記録して
+ *       SLA_APIRESULT_EXCEED_HANDLE_CAPACITYを返す（num_entriesは必要なエントリ数になる）。
+ *       欠落/途中で切れたブロックがあればSLA_APIRESULT_DETECT_DATA_CORRUPTIONを返すが、
+ *       見つかったブロックは記録する（以降のサンプル位置は欠落分を含まない） */
+SLAApiResult SLADecoder_BuildBlockIndex(const uint8_t* data, uint64_t data_size,
+    struct SLABlockIndexEntry* entries, uint32_t max_num_entries, uint32_t* num_entries);
+
+/* 1ブロックの完全性検証 */
+/* 補足）dataはブロック先頭を指すこと。同期コード・ブロックサイズ・サンプル数・CRC16を確かめ、
+ *       エントロピー復号と合成は行わない。headerを与えればヘッダに記録された上限も確かめる。
+ *       データが1ブロックに満たなければSLA_APIRESULT_INSUFFICIENT_DATA_SIZEを返す */
+SLAApiResult SLADecoder_VerifyBlock(const uint8_t* data, uint32_t data_size,
+    const struct SLAHeaderInfo* header, uint32_t* block_size, uint32_t* num_samples);
+
+/* ヘッダを含むデータ全体の完全性検証 */
+/* 補足）ヘッダと全ブロックをSLADecoder_VerifyBlockで先頭から順に検証し、
+ *       ブロック数・サンプル数の合計がヘッダの記録と一致するか確かめる。
+ *       異常があればその位置をresult->error_offsetに返す */
+SLAApiResult SLADecoder_VerifyStream(const uint8_t* data, uint64_t data_size,
+    struct SLAVerifyResult* result);
+
+/* ブロック索引ファイルのサイズ計算 */
+/* 補足）サイズが32bitで表現できないエントリ数のときは0を返す */
+uint32_t SLADecoder_CalculateBlockIndexFileSize(uint32_t num_entries);
+
+/* ブロック索引ファイルの書き出し */
+/* 補足）sla_dataには索引を作成したデータ全体を与える（ヘッダのCRC16とサイズを記録して対応付ける） */
+SLAApiResult SLADecoder_EncodeBlockIndexFile(
+    const uint8_t* sla_data, uint64_t sla_data_size,
+    const struct SLABlockIndexEntry* entries, uint32_t num_entries,
+    uint8_t* buffer, uint32_t buffer_size, uint32_t* output_size);
+
+/* ブロック索引ファイルの読み込み */
+/* 補足）entriesがNULLのときは情報の読み取りのみ行う。フォーマットバージョン1の索引も読める */
+SLAApiResult SLADecoder_DecodeBlockIndexFile(
+    const uint8_t* index_data, uint32_t index_data_size, struct SLABlockIndexInfo* info,
+    struct SLABlockIndexEntry* entries, uint32_t max_num_entries);
+
+/* ブロック索引が対象データのものか確認 */
+/* 補足）header_dataにはデータ先頭のSLA_HEADER_SIZEバイトを与える。オーディオデータには触れない */
+SLAApiResult SLADecoder_CheckBlockIndexSource(const struct SLABlockIndexInfo* info,
+    const uint8_t* header_data, uint64_t source_data_size);
+
+/* ブロック索引からサンプル位置を含むブロックを二分探索 */
+SLAApiResult SLADecoder_SearchBlockIndex(
+    const struct SLABlockIndexEntry* entries, uint32_t num_entries,
+    uint64_t sample_position, uint32_t* entry_index);
+
+/* デコーダハンドルプールの作成 */
+/* 補足）全ハンドルを1回の領域確保でまとめて作成する */
+struct SLADecoderPool* SLADecoderPool_Create(const struct SLADecoderConfig* config, uint32_t num_decoders);
+
+/* デコーダハンドルプールの破棄 */
+void SLADecoderPool_Destroy(struct SLADecoderPool* pool);
+
+/* プールからリセット済みのデコーダハンドルを取得（空きがなければNULL） */
+struct SLADecoder* SLADecoderPool_Acquire(struct SLADecoderPool* pool);
+
+/* デコーダハンドルをプールに返却 */
+SLAApiResult SLADecoderPool_Release(struct SLADecoderPool* pool, struct SLADecoder* decoder);
+
+/* 複数データの一括デコード */
+/* 補足）プールのハンドル1つを使い回して呼び出しスレッドで順にデコードする。
+ *       各データの結果はitems[i].resultに入り、戻り値は最初に失敗したデータの結果。
+ *       並列にデコードする場合はSLADecoder_DecodeBatchParallelを使う */
+SLAApiResult SLADecoder_DecodeBatch(struct SLADecoderPool* pool,
+    struct SLADecodeBatchItem* items, uint32_t num_items);
+
+/* 複数データの並列一括デコード */
+/* 補足）プールの空いているハンドル数（データ数まで）のワーカでitemsを分担してデコードする。
+ *       先頭のワーカは呼び出しスレッドで、残りはthread_functions->spawnで起動したスレッドで処理し、
+ *       全て終わってから戻る。起動できなかったワーカの分は呼び出しスレッドで処理する。
+ *       thread_functionsがNULLならSLADecoder_DecodeBatchと同じ。結果の返し方もSLADecoder_DecodeBatchと同じ。
+ *       プール自体はスレッド安全ではないため、同じプールで同時に呼び出さないこと */
+SLAApiResult SLADecoder_DecodeBatchParallel(struct SLADecoderPool* pool,
+    struct SLADecodeBatchItem* items, uint32_t num_items,
+    const struct SLADecodeBatchThreadFunctions* thread_functions);
+
 /* ストリーミングデコーダの作成 */
 struct SLAStreamingDecoder* SLAStreamingDecoder_Create(const struct SLAStreamingDecoderConfig* config);
 
@@ -80,15 +286,31 @@ SLAApiResult SLAStreamingDecoder_EstimateMinimumNessesaryDataSize(struct SLAStre
 SLAApiResult SLAStreamingDecoder_EstimateDecodableNumSamples(struct SLAStreamingDecoder* decoder,
     uint32_t* estimate_num_samples);
 
+/* デコード中ブロックの完了に必要な追加データサイズを取得 */
+/* 補足）ブロックサイズが未確定の場合はブロックサイズの読み取りに必要なサイズを返す */
+SLAApiResult SLAStreamingDecoder_GetNecessaryDataSize(struct SLAStreamingDecoder* decoder,
+    uint32_t* necessary_data_size);
+
+/* 供給済みのデータだけで確実にデコード可能なサンプル数を取得 */
+/* 補足）ブロックヘッダから計算するため推定値ではない。全体が揃っていないブロックのサンプルは数えない */
+SLAApiResult SLAStreamingDecoder_GetDecodableNumSamples(struct SLAStreamingDecoder* decoder,
+    uint32_t* decodable_num_samples);
+
 /* デコード関数呼び出しあたりの出力サンプル数を取得 */
 SLAApiResult SLAStreamingDecoder_GetOutputNumSamplesPerDecode(struct SLAStreamingDecoder* decoder,
     uint32_t* output_num_samples);
 
 /* デコーダにデータ片を供給 */
+/* 補足）データ片はコピーせずに参照するため、回収するまで内容を保持すること。
+ *       回収されていないデータ片で保持数の上限に達するとSLA_APIRESULT_EXCEED_HANDLE_CAPACITYを返す */
 SLAApiResult SLAStreamingDecoder_AppendDataFragment(struct SLAStreamingDecoder* decoder,
     const uint8_t* data, uint32_t data_size);
 
 /* デコーダに残っているデータ片の回収 */
+/* 補足）データ片はそれを含むブロックのデコードが終わってから回収可能になり、1回の呼び出しで1つずつ返す。
+ *       1回のデコードで複数のデータ片が回収可能になることもあるため、デコードの後は
+ *       SLA_APIRESULT_NO_DATA_FRAGMENTSが返るまで繰り返し呼ぶこと（1回だけでは回収漏れが溜まり、
+ *       SLAStreamingDecoder_AppendDataFragmentが失敗するようになる） */
 SLAApiResult SLAStreamingDecoder_CollectDataFragment(struct SLAStreamingDecoder* decoder,
     const uint8_t** data_ptr, uint32_t* data_size);
 
@@ -97,9 +319,24 @@ SLAApiResult SLAStreamingDecoder_GetRemainDataSize(struct SLAStreamingDecoder* d
     uint32_t* remain_data_size);
 
 /* ストリーミングデコード */
+/* 補足）CRCチェック有効時はブロック全体のCRC16をデコード前に照合し、不一致ならば何も出力せず
+ *       SLA_APIRESULT_DETECT_DATA_CORRUPTIONを返す。そのため全体が揃ったブロックの分だけデコードし、
+ *       揃ったブロックが無ければSLA_APIRESULT_INSUFFICIENT_DATA_SIZEを返す（データを追加して再度呼ぶこと） */
 SLAApiResult SLAStreamingDecoder_Decode(struct SLAStreamingDecoder* decoder,
     int32_t** buffer, uint32_t buffer_num_samples, uint32_t* num_output_samples);
 
+/* 指定サンプル数ちょうどのストリーミングデコード（オーディオコールバック向け） */
+/* 補足）内部でメモリ確保・ロックは行わない。全体が揃ったブロックでnum_framesに満たないときは
+ *       何もせずSLA_APIRESULT_INSUFFICIENT_DATA_SIZEを返す。
+ *       CRCチェック有効時は、次のブロックのCRC16を前のブロックのデコードに合わせて少しずつ計算し、
+ *       ブロック境界では残りだけを照合する。境界の呼び出しを軽くするには次のブロックを早めに供給すること */
+SLAApiResult SLAStreamingDecoder_DecodeFrames(struct SLAStreamingDecoder* decoder,
+    int32_t** buffer, uint32_t num_frames);
+
+/* 統計情報の取得 */
+SLAApiResult SLAStreamingDecoder_GetStatistics(const struct SLAStreamingDecoder* decoder,
+    struct SLAStatistics* statistics);
+
 #ifdef __cplusplus
 }
 #endif
@@ -20,10 +20,30 @@ struct SLAEncoderConfig {
   uint8_t   verpose_flag;               /* 詳細な情報を表示するか */
 };
 
+/* PCM入力 */
+/* 補足）インターリーブ形式ならchannel_data[ch]にch番目のサンプルのアドレス・strideにチャンネル数を、
+ *       チャンネル毎の形式ならchannel_data[ch]に各チャンネルの先頭アドレス・strideに1を指定する
+ *       右詰めの型ではサンプル値の範囲は波形パラメータのbit_per_sampleに従う
+ *       SLA_PCM_SAMPLE_TYPE_FLOAT32は入力には使えない */
+struct SLAPcmInput {
+  SLAPcmSampleType    sample_type;  /* サンプルの型 */
+  const void* const*  channel_data; /* チャンネル毎の先頭サンプルのアドレス */
+  uint32_t            stride;       /* 同一チャンネルの次のサンプルまでの間隔（サンプル数単位） */
+};
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* エンコーダハンドルの作成に必要なワークサイズ計算 */
+/* 補足）不正なコンフィグの場合は負値を返す */
+int32_t SLAEncoder_CalculateWorkSize(const struct SLAEncoderConfig* config);
+
+/* エンコーダハンドルの作成（ワーク領域指定） */
+/* 補足）内部領域は全てworkから切り出す（先頭アドレスのアラインメントは不問）
+ * workはハンドル使用中は保持し、破棄後に呼び出し側で解放すること */
+struct SLAEncoder* SLAEncoder_CreateWithWork(const struct SLAEncoderConfig* config, void* work, int32_t work_size);
+
 /* エンコーダハンドルの作成 */
 struct SLAEncoder* SLAEncoder_Create(const struct SLAEncoderConfig* config);
 
@@ -47,11 +67,49 @@ SLAApiResult SLAEncoder_EncodeBlock(struct SLAEncoder* encoder,
     const int32_t* const* input, uint32_t num_samples,
     uint8_t* data, uint32_t data_size, uint32_t* output_size);
 
+/* 最適なブロック分割を探索してエンコード */
+/* 補足）num_samplesは最大ブロックサンプル数以下で、入力を分割して与える場合に使用する
+ *       headerのブロック数・最大ブロックサイズ・最大bpsを更新する */
+SLAApiResult SLAEncoder_EncodePartitionedBlocks(struct SLAEncoder* encoder,
+    const int32_t* const* input, uint32_t num_samples,
+    uint8_t* data, uint32_t data_size, uint32_t* output_size, struct SLAHeaderInfo* header);
+
+/* 1ブロックエンコード（PCM入力） */
+SLAApiResult SLAEncoder_EncodeBlockPcm(struct SLAEncoder* encoder,
+    const struct SLAPcmInput* input, uint32_t num_samples,
+    uint8_t* data, uint32_t data_size, uint32_t* output_size);
+
+/* 最適なブロック分割を探索してエンコード（PCM入力） */
+SLAApiResult SLAEncoder_EncodePartitionedBlocksPcm(struct SLAEncoder* encoder,
+    const struct SLAPcmInput* input, uint32_t num_samples,
+    uint8_t* data, uint32_t data_size, uint32_t* output_size, struct SLAHeaderInfo* header);
+
+/* PCM入力のビットパターン（32bit左詰めに換算した全サンプルのビットOR）をbit_maskに累積 */
+/* 補足）結果はSLAEncoder_CalculateLeftShiftOffsetFromBitMaskに与える */
+SLAApiResult SLAEncoder_AccumulatePcmBitMask(const struct SLAPcmInput* input,
+    uint32_t num_channels, uint32_t bit_per_sample, uint32_t num_samples, uint32_t* bit_mask);
+
+/* 入力全体のビットパターン（全サンプルのビットOR）からオフセット分の左シフト量を計算 */
+/* 補足）入力を分割して与える場合に使用し、結果は波形パラメータのoffset_lshiftにセットする */
+uint8_t SLAEncoder_CalculateLeftShiftOffsetFromBitMask(uint32_t bit_per_sample, uint32_t bit_mask);
+
 /* ヘッダを含めて全ブロックエンコード */
 SLAApiResult SLAEncoder_EncodeWhole(struct SLAEncoder* encoder,
     const int32_t* const* input, uint32_t num_samples,
     uint8_t* data, uint32_t data_size, uint32_t* output_size);
 
+/* ヘッダを含めて全ブロックエンコード（PCM入力） */
+SLAApiResult SLAEncoder_EncodeWholePcm(struct SLAEncoder* encoder,
+    const struct SLAPcmInput* input, uint32_t num_samples,
+    uint8_t* data, uint32_t data_size, uint32_t* output_size);
+
+/* 統計情報の取得 */
+/* 補足）SLA_ENABLE_STATISTICSを定義せずにビルドした場合はSLA_APIRESULT_STATISTICS_DISABLEDを返す */
+SLAApiResult SLAEncoder_GetStatistics(const struct SLAEncoder* encoder, struct SLAStatistics* statistics);
+
+/* 統計情報のリセット */
+SLAApiResult SLAEncoder_ResetStatistics(struct SLAEncoder* encoder);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,65 @@
+#ifndef SLA_READER_H_INCLUDED
+#define SLA_READER_H_INCLUDED
+
+#include "SLA.h"
+#include "SLADecoder.h"
+#include "SLAStdint.h"
+
+/* SLAファイル読み込みハンドル */
+struct SLAReader;
+
+/* 読み込みのアクセスパターン */
+typedef enum SLAReaderAccessPatternTag {
+  SLAREADER_ACCESSPATTERN_NORMAL = 0,   /* 指定なし                 */
+  SLAREADER_ACCESSPATTERN_SEQUENTIAL,   /* 先頭から順に読む         */
+  SLAREADER_ACCESSPATTERN_RANDOM        /* ブロック単位で飛び飛びに読む */
+} SLAReaderAccessPattern;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ファイルを開く */
+/* 補足）可能ならファイルをメモリマップし、できなければ全体を読み込む。
+ *       ファイル名に".slaidx"を付けた索引ファイルがあり、内容が一致すればブロック索引として使う */
+struct SLAReader* SLAReader_Open(const char* filename, const struct SLADecoderConfig* config);
+
+/* ファイルを閉じる */
+void SLAReader_Close(struct SLAReader* reader);
+
+/* ヘッダ情報の取得 */
+const struct SLAHeaderInfo* SLAReader_GetHeaderInfo(const struct SLAReader* reader);
+
+/* ファイル全体のデータの取得 */
+/* 補足）メモリマップ時は参照したページだけが読み込まれる */
+SLAApiResult SLAReader_GetData(const struct SLAReader* reader, const uint8_t** data, uint64_t* data_size);
+
+/* 内部のデコーダハンドルの取得 */
+struct SLADecoder* SLAReader_GetDecoder(struct SLAReader* reader);
+
+/* アクセスパターンの指定（メモリマップ時はOSに先読みの方針を伝える） */
+SLAApiResult SLAReader_SetAccessPattern(struct SLAReader* reader, SLAReaderAccessPattern pattern);
+
+/* ブロック数の取得 */
+/* 補足）ブロック索引がなければ全ブロックヘッダを辿って作成する */
+SLAApiResult SLAReader_GetNumBlocks(struct SLAReader* reader, uint32_t* num_blocks);
+
+/* ブロック索引エントリの取得 */
+/* 補足）ブロック索引は必要なブロックまでブロックヘッダを辿って作成する（ブロックデータは読まない） */
+SLAApiResult SLAReader_GetBlockIndexEntry(struct SLAReader* reader,
+    uint32_t block_no, struct SLABlockIndexEntry* entry);
+
+/* 1ブロックのデコード */
+SLAApiResult SLAReader_DecodeBlock(struct SLAReader* reader, uint32_t block_no,
+    int32_t** buffer, uint32_t buffer_num_samples, uint32_t* output_num_samples);
+
+/* サンプル範囲のデコード */
+SLAApiResult SLAReader_DecodeRange(struct SLAReader* reader,
+    uint64_t start_sample, uint32_t num_samples,
+    int32_t** buffer, uint32_t buffer_num_samples, uint32_t* output_num_samples);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SLA_READER_H_INCLUDED */
@@ -4,8 +4,14 @@
  * To Public License, Version 2, as published by Sam Hocevar. See
  * http://www.wtfpl.net/ for more details. */
 
+/* スレッドとディレクトリ走査にPOSIXの機能を使う */
+#if !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L
+#endif
+
 #include "SLAEncoder.h"
 #include "SLADecoder.h"
+#include "SLAEncodePreset.h"
 
 #include "wav.h"
 #include "command_line_parser.h"
@@ -13,19 +19,40 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
 #include <sys/stat.h>
 
+/* スレッドが使える環境か */
+#if !defined(SLACLI_DISABLE_THREADS) && (defined(__unix__) || defined(__APPLE__))
+#define SLACLI_USE_POSIX
+#endif
+
+#if defined(SLACLI_USE_POSIX)
+#include <pthread.h>
+#include <dirent.h>
+#include <unistd.h>
+#endif
+
 /* 2つのうち小さい値の選択 */
 #define MIN(a, b) (((a) < (b)) ? (a) : (b))
 
 /* エンコード */
-static int do_encode(const char* in_filename, const char* out_filename, uint32_t encode_preset_no, uint8_t verpose_flag);
+static int do_encode(const char* in_filename, const char* out_filename, uint32_t encode_preset_no,
+    uint32_t max_num_block_samples, uint8_t verpose_flag, const char* statistics_filename);
 
 /* デコード */
-static int do_decode(const char* in_filename, const char* out_filename, uint8_t enable_crc_check, uint8_t verpose_flag);
+static int do_decode(const char* in_filename, const char* out_filename, uint8_t enable_crc_check, uint8_t verpose_flag,
+    const char* statistics_filename);
 
 /* ストリーミングデコード */
-static int do_streaming_decode(const char* in_filename, const char* out_filename, uint8_t enable_crc_check, uint8_t verpose_flag);
+static int do_streaming_decode(const char* in_filename, const char* out_filename, uint8_t enable_crc_check, uint8_t verpose_flag,
+    const char* statistics_filename);
+
+/* ブロック索引ファイルの作成 */
+static int do_index(const char* in_filename, const char* out_filename, uint8_t verpose_flag);
+
+/* 完全性の検証 */
+static int do_test(const char* in_filename, uint8_t deep_flag, uint8_t verpose_flag);
 
 /* コマンドライン仕様 */
 static struct CommandLineParserSpecification command_line_spec[] = {
@@ -56,73 +83,199 @@ static struct CommandLineParserSpecification command_line_spec[] = {
   { 's', "streaming", COMMAND_LINE_PARSER_FALSE, 
     "Use streaming decode(for debug; 120fps)", 
     NULL, COMMAND_LINE_PARSER_FALSE },
+  { 'i', "instruction-set", COMMAND_LINE_PARSER_TRUE, 
+    "Specify SIMD instruction set(auto, none, sse4.1) default:auto", 
+    NULL, COMMAND_LINE_PARSER_FALSE },
+  { 'x', "index", COMMAND_LINE_PARSER_FALSE, 
+    "Index mode: write a block index sidecar(default output: INPUT_FILE_NAME.slaidx)", 
+    NULL, COMMAND_LINE_PARSER_FALSE },
+  { 'S', "statistics", COMMAND_LINE_PARSER_TRUE, 
+    "Write per-stage statistics as JSON to the file(stdout for standard output; needs a build with ENABLE_STATISTICS=1)", 
+    NULL, COMMAND_LINE_PARSER_FALSE },
+  { 'B', "block-samples", COMMAND_LINE_PARSER_TRUE, 
+    "Specify the maximum number of samples per block(2048 - 1048576) default:value of the compress mode", 
+    NULL, COMMAND_LINE_PARSER_FALSE },
+  { 'j', "jobs", COMMAND_LINE_PARSER_TRUE, 
+    "Batch mode: encode/decode/test all given files and directories with the number of threads(0 for all cores)", 
+    NULL, COMMAND_LINE_PARSER_FALSE },
+  { 't', "test", COMMAND_LINE_PARSER_FALSE, 
+    "Test mode: verify header/block CRC16 and structure without decoding(no output file)", 
+    NULL, COMMAND_LINE_PARSER_FALSE },
+  { 'D', "deep", COMMAND_LINE_PARSER_FALSE, 
+    "With test mode, also decode all blocks to check the bitstream", 
+    NULL, COMMAND_LINE_PARSER_FALSE },
   { 0, }
 };
 
-/* エンコードプリセット */
-static const struct SLAEncodeParameter encode_preset[] = {
-  /* parcor, longterm, lms,             ch_porcess_method,                   window_func_type, max_block_size */
-  {       8,        1,   4,      SLA_CHPROCESSMETHOD_NONE, SLA_WINDOWFUNCTIONTYPE_RECTANGULAR,           4096 },
-  {       8,        1,   8, SLA_CHPROCESSMETHOD_STEREO_MS,         SLA_WINDOWFUNCTIONTYPE_SIN,          12288 },
-  {      16,        1,   8, SLA_CHPROCESSMETHOD_STEREO_MS,         SLA_WINDOWFUNCTIONTYPE_SIN,          12288 },
-  {      32,        3,   8, SLA_CHPROCESSMETHOD_STEREO_MS,         SLA_WINDOWFUNCTIONTYPE_SIN,          12288 },
-  {      32,        3,   8, SLA_CHPROCESSMETHOD_STEREO_MS,         SLA_WINDOWFUNCTIONTYPE_SIN,          16384 }
-};
-
 /* エンコードプリセット数 */
-static const uint32_t num_encode_preset = sizeof(encode_preset) / sizeof(encode_preset[0]);
+static const uint32_t num_encode_preset = SLA_NUM_ENCODE_PRESETS;
 
 /* デフォルトのプリセット番号 */
 static const uint32_t default_preset_no = 2;
 
+/* 指定可能なブロックあたり最大サンプル数の範囲 */
+static const uint32_t min_num_block_samples_limit = 2048;
+static const uint32_t max_num_block_samples_limit = SLA_MAX_NUM_BLOCK_SAMPLES;
+
+/* 統計情報のJSON書き出し */
+static int write_statistics(const char* filename, const char* mode_name, const struct SLAStatistics* stats)
+{
+  static const char* stage_name[SLA_STATISTICS_NUM_STAGES] = {
+    "partition_search", "lpc", "longterm", "lms", "entropy_coding", "crc"
+  };
+  static const char* tick_clock_name[] = {
+    "monotonic", "process_cpu", "user_defined"
+  };
+  uint32_t i;
+  FILE* fp;
+
+  if (strcmp(filename, "stdout") == 0) {
+    fp = stdout;
+  } else if ((fp = fopen(filename, "w")) == NULL) {
+    fprintf(stderr, "Failed to open %s \n", filename);
+    return 1;
+  }
+
+  fprintf(fp, "{\n");
+  fprintf(fp, "  \"mode\": \"%s\",\n", mode_name);
+  fprintf(fp, "  \"tick_clock\": \"%s\",\n", tick_clock_name[stats->tick_clock]);
+  fprintf(fp, "  \"ticks_per_second\": %lu,\n", (unsigned long)stats->ticks_per_second);
+  fprintf(fp, "  \"stage_seconds\": {");
+  for (i = 0; i < SLA_STATISTICS_NUM_STAGES; i++) {
+    fprintf(fp, "%s \"%s\": %.6f", (i == 0) ? "" : ",", stage_name[i],
+        (double)stats->stage_ticks[i] / (double)stats->ticks_per_second);
+  }
+  fprintf(fp, " },\n");
+  fprintf(fp, "  \"blocks\": { \"compressed\": %u, \"silent\": %u, \"raw\": %u },\n",
+      stats->num_compressed_blocks, stats->num_silent_blocks, stats->num_raw_blocks);
+  fprintf(fp, "  \"num_samples\": %lu,\n", (unsigned long)stats->num_samples);
+  fprintf(fp, "  \"coefficient_bits\": %lu,\n", (unsigned long)stats->coefficient_bits);
+  fprintf(fp, "  \"residual_bits\": %lu,\n", (unsigned long)stats->residual_bits);
+  fprintf(fp, "  \"coefficient_bits_per_sample\": %.4f,\n",
+      (stats->num_samples > 0) ? ((double)stats->coefficient_bits / (double)stats->num_samples) : 0.0);
+  fprintf(fp, "  \"residual_bits_per_sample\": %.4f,\n",
+      (stats->num_samples > 0) ? ((double)stats->residual_bits / (double)stats->num_samples) : 0.0);
+  fprintf(fp, "  \"rice_parameter_log2_histogram\": [");
+  for (i = 0; i < SLA_STATISTICS_RICE_HISTOGRAM_SIZE; i++) {
+    fprintf(fp, "%s%lu", (i == 0) ? " " : ", ", (unsigned long)stats->rice_parameter_histogram[i]);
+  }
+  fprintf(fp, " ]\n");
+  fprintf(fp, "}\n");
+
+  if (fp != stdout) {
+    fclose(fp);
+  }
+
+  return 0;
+}
+
+/* 統計情報取得結果の確認と書き出し */
+static int output_statistics(const char* filename, const char* mode_name,
+    SLAApiResult get_result, const struct SLAStatistics* stats)
+{
+  if (get_result == SLA_APIRESULT_STATISTICS_DISABLED) {
+    fprintf(stderr, "Statistics are not collected in this build (rebuild with ENABLE_STATISTICS=1). \n");
+    return 1;
+  } else if (get_result != SLA_APIRESULT_OK) {
+    fprintf(stderr, "Failed to get statistics: %d \n", get_result);
+    return 1;
+  }
+
+  return write_statistics(filename, mode_name, stats);
+}
+
+/* リトルエンディアン環境か？ */
+static int is_little_endian(void)
+{
+  const uint16_t probe = 1;
+  return (*((const uint8_t *)&probe) == 1) ? 1 : 0;
+}
+
+/* 書きかけの出力ファイルの削除 */
+/* 補足）デバイスファイル等を指定された場合は消さない */
+static void remove_partial_output(const char* filename)
+{
+  struct stat file_stat;
+
+  if ((stat(filename, &file_stat) == 0) && S_ISREG(file_stat.st_mode)) {
+    remove(filename);
+  }
+}
+
+/* 入力の読み込み */
+static WAVApiResult read_encoder_input(struct WAVStreamReader* in_wav,
+    uint8_t* interleaved, int32_t** input, uint32_t num_samples, uint32_t* num_read_samples)
+{
+  if (interleaved != NULL) {
+    return WAVStreamReader_ReadInterleaved(in_wav, interleaved, num_samples, num_read_samples);
+  }
+  return WAVStreamReader_Read(in_wav, input, num_samples, num_read_samples);
+}
+
 /* エンコード */
-static int do_encode(const char* in_filename, const char* out_filename, uint32_t encode_preset_no, uint8_t verpose_flag)
+/* 補足）入力は最大ブロックサンプル数ずつ読み込み、エンコードしたものから順に書き出す
+ *       ファイル上の形式をエンコーダが直接扱える場合はデインターリーブせずに渡す
+ *       max_num_block_samplesが0ならばプリセットの値を使う */
+static int do_encode(const char* in_filename, const char* out_filename, uint32_t encode_preset_no,
+    uint32_t max_num_block_samples, uint8_t verpose_flag, const char* statistics_filename)
 {
-  FILE*                             out_fp;
-  struct WAVFile*                   in_wav;
-  struct stat                       fstat;
-  struct SLAEncoder*                encoder;
+  FILE*                             out_fp = NULL;
+  struct WAVStreamReader*           in_wav;
+  struct WAVFileFormat              wav_format;
+  struct SLAEncoder*                encoder = NULL;
   struct SLAEncoderConfig           config;
   struct SLAEncodeParameter         enc_param;
   struct SLAWaveFormat              wave_format;
-  uint8_t*                          buffer;
-  uint32_t                          buffer_size, encoded_data_size;
+  struct SLAHeaderInfo              header;
+  int32_t**                         input = NULL;
+  uint8_t*                          interleaved = NULL;
+  const void**                      channel_data = NULL;
+  struct SLAPcmInput                pcm_input;
+  uint8_t*                          buffer = NULL;
+  uint32_t                          ch, buffer_size, encoded_data_size, num_read_samples;
+  uint64_t                          num_encoded_samples, output_size;
   const struct SLAEncodeParameter*  ppreset;
   SLAApiResult                      ret;
+  uint8_t                           out_opened = 0;
+  int                               result = 1;
 
-  /* エンコーダハンドルの作成 */
-  config.max_num_channels         = 8;
-  config.max_num_block_samples    = 16384;
+  /* WAVファイルオープン（ヘッダだけ読む） */
+  if ((in_wav = WAVStreamReader_Open(in_filename)) == NULL) {
+    fprintf(stderr, "Failed to open %s \n", in_filename);
+    return 1;
+  }
+  wav_format = *WAVStreamReader_GetFormat(in_wav);
+  if (wav_format.num_channels > SLA_MAX_NUM_CHANNELS) {
+    fprintf(stderr, "Unsupported number of channels: %d \n", wav_format.num_channels);
+    goto EXIT;
+  }
+
+  /* エンコーダハンドルの作成（チャンネル数は入力に合わせる） */
+  ppreset = &encode_preset[encode_preset_no];
+  if (max_num_block_samples == 0) {
+    max_num_block_samples = ppreset->max_num_block_samples;
+  }
+  config.max_num_channels         = wav_format.num_channels;
+  config.max_num_block_samples    = max_num_block_samples;
   config.max_parcor_order         = 48;
   config.max_longterm_order       = 5;
   config.max_lms_order_per_filter = 40;
   config.verpose_flag             = verpose_flag;
+  if (SLAEncoder_CalculateWorkSize(&config) < 0) {
+    fprintf(stderr, "Work area for %d channels x %u block samples is too large(reduce -B). \n",
+        wav_format.num_channels, max_num_block_samples);
+    goto EXIT;
+  }
   if ((encoder = SLAEncoder_Create(&config)) == NULL) {
     fprintf(stderr, "Failed to create encoder handle. \n");
-    return 1;
-  }
-
-  /* WAVファイルオープン */
-  if ((in_wav = WAV_CreateFromFile(in_filename)) == NULL) {
-    fprintf(stderr, "Failed to open %s \n", in_filename);
-    return 1;
-  }
-
-  /* 波形パラメータの設定 */
-  wave_format.num_channels    = in_wav->format.num_channels;
-  wave_format.bit_per_sample  = in_wav->format.bits_per_sample;
-  wave_format.sampling_rate   = in_wav->format.sampling_rate;
-  if ((ret = SLAEncoder_SetWaveFormat(encoder, &wave_format)) != SLA_APIRESULT_OK) {
-    fprintf(stderr, "Failed to set wave parameter: %d \n", ret);
-    return 1;
+    goto EXIT;
   }
 
   /* エンコードパラメータの設定 */
-  ppreset = &encode_preset[encode_preset_no];
   enc_param.parcor_order            = ppreset->parcor_order;
   enc_param.longterm_order          = ppreset->longterm_order;
   enc_param.lms_order_per_filter    = ppreset->lms_order_per_filter;
-  if ((in_wav->format.num_channels == 2) 
+  if ((wav_format.num_channels == 2) 
       && (ppreset->ch_process_method == SLA_CHPROCESSMETHOD_STEREO_MS)) {
     /* 音源がステレオのときだけMSは有効 */
     enc_param.ch_process_method = SLA_CHPROCESSMETHOD_STEREO_MS;
@@ -130,86 +283,287 @@ static int do_encode(const char* in_filename, const char* out_filename, uint32_t
     enc_param.ch_process_method = SLA_CHPROCESSMETHOD_NONE;
   }
   enc_param.window_function_type  = ppreset->window_function_type;
-  enc_param.max_num_block_samples = ppreset->max_num_block_samples;
+  enc_param.max_num_block_samples = max_num_block_samples;
   if ((ret = SLAEncoder_SetEncodeParameter(encoder, &enc_param)) != SLA_APIRESULT_OK) {
     fprintf(stderr, "Failed to set encode parameter: %d \n", ret);
-    return 1;
+    goto EXIT;
   }
 
-  /* 入力ファイルのサイズを拾っておく */
-  stat(in_filename, &fstat);
-  /* 入力wavの2倍よりは大きくならないだろうという想定 */
-  buffer_size = (uint32_t)(2 * fstat.st_size);
+  /* 入力/出力データ領域を作成（最大ブロックサンプル数分） */
+  /* 補足）24bitは常に、16/32bitはリトルエンディアン環境でファイル上の形式のまま渡せる */
+  if (((input = (int32_t **)calloc(wav_format.num_channels, sizeof(int32_t *))) == NULL)
+      || ((channel_data = (const void **)calloc(wav_format.num_channels, sizeof(void *))) == NULL)) {
+    fprintf(stderr, "Failed to allocate memory. \n");
+    goto EXIT;
+  }
+  if ((wav_format.bits_per_sample == 24)
+      || (is_little_endian() && ((wav_format.bits_per_sample == 16) || (wav_format.bits_per_sample == 32)))) {
+    const uint32_t bytes_per_sample = wav_format.bits_per_sample / 8;
+    if ((interleaved = (uint8_t *)malloc(bytes_per_sample * wav_format.num_channels * enc_param.max_num_block_samples)) == NULL) {
+      fprintf(stderr, "Failed to allocate memory. \n");
+      goto EXIT;
+    }
+    for (ch = 0; ch < wav_format.num_channels; ch++) {
+      channel_data[ch] = &interleaved[ch * bytes_per_sample];
+    }
+    switch (wav_format.bits_per_sample) {
+      case 16:  pcm_input.sample_type = SLA_PCM_SAMPLE_TYPE_INT16;        break;
+      case 24:  pcm_input.sample_type = SLA_PCM_SAMPLE_TYPE_PACKED_INT24; break;
+      default:  pcm_input.sample_type = SLA_PCM_SAMPLE_TYPE_INT32;        break;
+    }
+    pcm_input.stride = wav_format.num_channels;
+  } else {
+    for (ch = 0; ch < wav_format.num_channels; ch++) {
+      if ((input[ch] = (int32_t *)malloc(sizeof(int32_t) * enc_param.max_num_block_samples)) == NULL) {
+        fprintf(stderr, "Failed to allocate memory. \n");
+        goto EXIT;
+      }
+      channel_data[ch] = input[ch];
+    }
+    pcm_input.sample_type = SLA_PCM_SAMPLE_TYPE_INT32_LEFT_JUSTIFIED;
+    pcm_input.stride      = 1;
+  }
+  pcm_input.channel_data = channel_data;
+  buffer_size = SLA_CalculateSufficientBlockSize(
+      wav_format.num_channels, enc_param.max_num_block_samples, wav_format.bits_per_sample);
+  if ((buffer = (uint8_t *)malloc(buffer_size)) == NULL) {
+    fprintf(stderr, "Failed to allocate memory. \n");
+    goto EXIT;
+  }
 
-  /* エンコードデータ領域を作成 */
-  buffer = (uint8_t *)malloc(buffer_size);
+  /* オフセット分の左シフト量を解析 */
+  /* 補足）シークできない入力では全体を見られないので解析しない */
+  wave_format.offset_lshift = 0;
+  if (WAVStreamReader_Rewind(in_wav) == WAV_APIRESULT_OK) {
+    uint32_t bit_mask = 0;
+    while ((read_encoder_input(in_wav, interleaved, input, enc_param.max_num_block_samples, &num_read_samples) == WAV_APIRESULT_OK)
+        && (num_read_samples > 0)) {
+      SLAEncoder_AccumulatePcmBitMask(&pcm_input,
+          wav_format.num_channels, wav_format.bits_per_sample, num_read_samples, &bit_mask);
+    }
+    if (WAVStreamReader_Rewind(in_wav) != WAV_APIRESULT_OK) {
+      fprintf(stderr, "Failed to rewind %s \n", in_filename);
+      goto EXIT;
+    }
+    wave_format.offset_lshift
+      = SLAEncoder_CalculateLeftShiftOffsetFromBitMask(wav_format.bits_per_sample, bit_mask);
+  }
 
-  /* 一括エンコード */
-  if ((ret = SLAEncoder_EncodeWhole(encoder, 
-          (const int32_t* const *)in_wav->data, in_wav->format.num_samples,
-          buffer, buffer_size, &encoded_data_size)) != SLA_APIRESULT_OK) {
-    fprintf(stderr, "Encoding error! %d \n", ret);
-    return 1;
+  /* 波形パラメータの設定 */
+  wave_format.num_channels    = wav_format.num_channels;
+  wave_format.bit_per_sample  = wav_format.bits_per_sample;
+  wave_format.sampling_rate   = wav_format.sampling_rate;
+  if ((ret = SLAEncoder_SetWaveFormat(encoder, &wave_format)) != SLA_APIRESULT_OK) {
+    fprintf(stderr, "Failed to set wave parameter: %d \n", ret);
+    goto EXIT;
   }
 
-  out_fp = fopen(out_filename, "wb");
-  fwrite(buffer, sizeof(uint8_t), encoded_data_size, out_fp);
+  /* 出力ファイルオープン */
+  if (strcmp(out_filename, "-") == 0) {
+    out_fp = stdout;
+  } else if ((out_fp = fopen(out_filename, "wb")) == NULL) {
+    fprintf(stderr, "Failed to open %s \n", out_filename);
+    goto EXIT;
+  } else {
+    out_opened = 1;
+  }
+
+  /* 仮のヘッダの書き出し（ブロック数等は未知とする） */
+  header.wave_format        = wave_format;
+  header.encode_param       = enc_param;
+  header.num_samples        = wav_format.num_samples;
+  header.num_blocks         = SLA_NUM_BLOCKS_INVALID;
+  header.max_block_size     = SLA_MAX_BLOCK_SIZE_INVAILD;
+  header.max_bit_per_second = 0;
+  if ((ret = SLAEncoder_EncodeHeader(&header, buffer, buffer_size)) != SLA_APIRESULT_OK) {
+    fprintf(stderr, "Failed to encode header: %d \n", ret);
+    goto EXIT;
+  }
+  if (fwrite(buffer, sizeof(uint8_t), SLA_HEADER_SIZE, out_fp) != SLA_HEADER_SIZE) {
+    fprintf(stderr, "Failed to write %s \n", out_filename);
+    goto EXIT;
+  }
+  output_size = SLA_HEADER_SIZE;
+
+  /* 読み込んだ分から逐次エンコード */
+  header.num_blocks     = 0;
+  header.max_block_size = 0;
+  num_encoded_samples   = 0;
+  while (1) {
+    if (read_encoder_input(in_wav, interleaved, input, enc_param.max_num_block_samples, &num_read_samples) != WAV_APIRESULT_OK) {
+      fprintf(stderr, "Failed to read %s \n", in_filename);
+      goto EXIT;
+    }
+    if (num_read_samples == 0) {
+      break;
+    }
+    if ((ret = SLAEncoder_EncodePartitionedBlocksPcm(encoder,
+            &pcm_input, num_read_samples,
+            buffer, buffer_size, &encoded_data_size, &header)) != SLA_APIRESULT_OK) {
+      fprintf(stderr, "Encoding error! %d \n", ret);
+      goto EXIT;
+    }
+    if (fwrite(buffer, sizeof(uint8_t), encoded_data_size, out_fp) != encoded_data_size) {
+      fprintf(stderr, "Failed to write %s \n", out_filename);
+      goto EXIT;
+    }
+    num_encoded_samples += num_read_samples;
+    output_size         += encoded_data_size;
+
+    /* 進捗表示 */
+    if ((verpose_flag != 0) && (wav_format.num_samples > 0)) {
+      printf("progress:%2u%% (compress ratio:%3.1f %%)\r",
+          (unsigned int)(((double)num_encoded_samples / (double)wav_format.num_samples) * 100),
+          ((double)output_size / ((double)num_encoded_samples * wav_format.num_channels * (wav_format.bits_per_sample / 8))) * 100);
+      fflush(stdout);
+    }
+  }
+
+  /* ブロック数, 最大ブロックサイズ, 最大bpsを反映（ヘッダの再度書き込み） */
+  /* 補足）シークできない出力では仮のヘッダのまま */
+  header.num_samples = num_encoded_samples;
+  if (fseek(out_fp, 0, SEEK_SET) == 0) {
+    if ((SLAEncoder_EncodeHeader(&header, buffer, buffer_size) != SLA_APIRESULT_OK)
+        || (fwrite(buffer, sizeof(uint8_t), SLA_HEADER_SIZE, out_fp) != SLA_HEADER_SIZE)) {
+      fprintf(stderr, "Failed to write %s \n", out_filename);
+      goto EXIT;
+    }
+  } else if (num_encoded_samples != wav_format.num_samples) {
+    fprintf(stderr, "Input ended before the size in the WAV header; the SLA header cannot be fixed. \n");
+    goto EXIT;
+  }
+
+  /* 出力の確定 */
+  /* 補足）書き出しの失敗はクローズ時に判明することがある */
+  if (out_fp != stdout) {
+    int close_ret = fclose(out_fp);
+    out_fp = NULL;
+    if (close_ret != 0) {
+      fprintf(stderr, "Failed to write %s \n", out_filename);
+      goto EXIT;
+    }
+  } else if (fflush(out_fp) != 0) {
+    fprintf(stderr, "Failed to write %s \n", out_filename);
+    goto EXIT;
+  }
 
   if (verpose_flag != 0) {
-    printf("Encode succuess! size:%d -> %d \n", 
-        (uint32_t)fstat.st_size, encoded_data_size);
+    printf("Encode succuess! size:%lu -> %lu \n", 
+        (unsigned long)(num_encoded_samples * wav_format.num_channels * (wav_format.bits_per_sample / 8)), (unsigned long)output_size);
   }
 
-  fclose(out_fp);
+  /* 統計情報の書き出し */
+  if (statistics_filename != NULL) {
+    struct SLAStatistics statistics;
+    if (output_statistics(statistics_filename, "encode",
+          SLAEncoder_GetStatistics(encoder, &statistics), &statistics) != 0) {
+      goto EXIT;
+    }
+  }
+
+  result = 0;
+
+EXIT:
+  /* 失敗時は書きかけの出力ファイルを残さない */
+  if ((out_fp != NULL) && (out_fp != stdout)) {
+    fclose(out_fp);
+  }
+  if ((result != 0) && (out_opened != 0)) {
+    remove_partial_output(out_filename);
+  }
   free(buffer);
-  WAV_Destroy(in_wav);
-  SLAEncoder_Destroy(encoder);
+  free(interleaved);
+  if (input != NULL) {
+    for (ch = 0; ch < wav_format.num_channels; ch++) {
+      free(input[ch]);
+    }
+    free(input);
+  }
+  free(channel_data);
+  WAVStreamReader_Close(in_wav);
+  if (encoder != NULL) {
+    SLAEncoder_Destroy(encoder);
+  }
 
-  return 0;
+  return result;
+}
+
+/* ブロックデータ読み込みバッファのサイズ計算 */
+/* 補足）ヘッダ直後に読み込み済みのデータは必ず収める */
+static uint32_t get_block_buffer_size(const struct SLAHeaderInfo* header, uint32_t data_size)
+{
+  uint32_t buffer_size;
+
+  buffer_size = (header->max_block_size != SLA_MAX_BLOCK_SIZE_INVAILD)
+    ? header->max_block_size
+    : SLA_CalculateSufficientBlockSize(header->wave_format.num_channels,
+        header->encode_param.max_num_block_samples, header->wave_format.bit_per_sample);
+  if (buffer_size < data_size) {
+    buffer_size = data_size;
+  }
+  /* ブロックを含まないデータでも0サイズの確保はしない */
+  if (buffer_size < SLA_BLOCK_HEADER_SIZE) {
+    buffer_size = SLA_BLOCK_HEADER_SIZE;
+  }
+
+  return buffer_size;
+}
+
+/* 出力の書き出し */
+static WAVApiResult write_decoder_output(struct WAVStreamWriter* out_wav,
+    const uint8_t* interleaved, int32_t* const* output, uint32_t num_samples)
+{
+  if (interleaved != NULL) {
+    return WAVStreamWriter_WriteInterleaved(out_wav, interleaved, num_samples);
+  }
+  return WAVStreamWriter_Write(out_wav, (const int32_t* const *)output, num_samples);
 }
 
 /* デコード */
-static int do_decode(const char* in_filename, const char* out_filename, uint8_t enable_crc_check, uint8_t verpose_flag)
+/* 補足）入力はブロック単位で読み込み、デコードしたものから順に書き出す
+ *       ファイル上の形式でデコーダが直接書き出せる場合はインターリーブ済みの結果を受け取る */
+static int do_decode(const char* in_filename, const char* out_filename, uint8_t enable_crc_check, uint8_t verpose_flag,
+    const char* statistics_filename)
 {
   FILE*                     in_fp;
-  struct WAVFile*           out_wav;
+  struct WAVStreamWriter*   out_wav = NULL;
   struct WAVFileFormat      wav_format;
-  struct stat               fstat;
-  struct SLADecoder*        decoder;
+  struct SLADecoder*        decoder = NULL;
   struct SLADecoderConfig   config;
   struct SLAHeaderInfo      header;
+  int32_t**                 output = NULL;
+  uint8_t*                  interleaved = NULL;
+  void**                    channel_data = NULL;
+  struct SLAPcmOutput       pcm_output;
   uint8_t*                  buffer;
-  uint32_t                  buffer_size, decode_num_samples;
+  uint32_t                  ch, buffer_size, data_size, block_size, block_num_samples;
+  uint64_t                  num_decoded_samples;
   SLAApiResult              ret;
+  uint8_t                   out_opened = 0;
+  int                       result = 1;
 
-  /* デコーダハンドルの作成 */
-  config.max_num_channels         = 8;
-  config.max_num_block_samples    = 16384;
-  config.max_parcor_order         = 48;
-  config.max_longterm_order       = 5;
-  config.max_lms_order_per_filter = 40;
-  config.enable_crc_check         = enable_crc_check;
-  config.verpose_flag             = verpose_flag;
-  if ((decoder = SLADecoder_Create(&config)) == NULL) {
-    fprintf(stderr, "Failed to create decoder handle. \n");
+  /* 入力ファイルオープン */
+  if (strcmp(in_filename, "-") == 0) {
+    in_fp = stdin;
+  } else if ((in_fp = fopen(in_filename, "rb")) == NULL) {
+    fprintf(stderr, "Failed to open %s \n", in_filename);
     return 1;
   }
 
-  /* 入力ファイルオープン */
-  in_fp = fopen(in_filename, "rb");
-  /* 入力ファイルのサイズ取得 / バッファ領域割り当て */
-  stat(in_filename, &fstat);
-  buffer_size = (uint32_t)fstat.st_size;
-  buffer = (uint8_t *)malloc(buffer_size);
-  /* バッファ領域にデータをロード */
-  fread(buffer, sizeof(uint8_t), buffer_size, in_fp);
-  fclose(in_fp);
-
   /* ヘッダデコード */
-  if ((ret = SLADecoder_DecodeHeader(buffer, buffer_size, &header))
-      != SLA_APIRESULT_OK) {
+  /* 補足）ヘッダサイズはフォーマットバージョンで異なるので最大サイズ分読み、ヘッダの後ろはブロックデータとして扱う */
+  buffer_size = SLA_HEADER_SIZE;
+  if ((buffer = (uint8_t *)malloc(buffer_size)) == NULL) {
+    fprintf(stderr, "Failed to allocate memory. \n");
+    goto EXIT;
+  }
+  if ((data_size = (uint32_t)fread(buffer, sizeof(uint8_t), SLA_HEADER_SIZE, in_fp)) < SLA_HEADER_SIZE_V1) {
+    fprintf(stderr, "Failed to read header of %s \n", in_filename);
+    goto EXIT;
+  }
+  if ((ret = SLADecoder_DecodeHeader(buffer, data_size, &header)) != SLA_APIRESULT_OK) {
     fprintf(stderr, "Failed to get header information: %d \n", ret);
-    return 1;
+    goto EXIT;
   }
 
   /* ヘッダから得られた情報を表示 */
@@ -222,60 +576,209 @@ static int do_decode(const char* in_filename, const char* out_filename, uint8_t
     printf("Longterm Order:              %d \n", header.encode_param.longterm_order);
     printf("LMS Order Par Filter:        %d \n", header.encode_param.lms_order_per_filter);
     printf("Channel Process Method:      %d \n", header.encode_param.ch_process_method);
-    printf("Max Number of Block Samples: %d \n", header.encode_param.max_num_block_samples);
-    printf("Number of Samples:           %d \n", header.num_samples);
+    printf("Max Number of Block Samples: %u \n", header.encode_param.max_num_block_samples);
+    printf("Number of Samples:           %lu \n", (unsigned long)header.num_samples);
     printf("Number of Blocks:            %d \n", header.num_blocks);
     printf("Max Block Size:              %d \n", header.max_block_size);
     printf("Max Bit Per Second(bps):     %d \n", header.max_bit_per_second);
   }
 
-  /* 出力wavハンドルの生成 */
-  wav_format.data_format     = WAV_DATA_FORMAT_PCM;
-  wav_format.num_channels    = header.wave_format.num_channels;
-  wav_format.sampling_rate   = header.wave_format.sampling_rate;
-  wav_format.bits_per_sample = header.wave_format.bit_per_sample;
-  wav_format.num_samples     = header.num_samples;
-  if ((out_wav = WAV_Create(&wav_format)) == NULL) {
-    fprintf(stderr, "Failed to create wav handle. \n");
-    return 1;
+  /* デコーダハンドルの作成（チャンネル数とブロックあたり最大サンプル数はヘッダに合わせる） */
+  config.max_num_channels         = header.wave_format.num_channels;
+  config.max_num_block_samples    = header.encode_param.max_num_block_samples;
+  config.max_parcor_order         = 48;
+  config.max_longterm_order       = 5;
+  config.max_lms_order_per_filter = 40;
+  config.enable_crc_check         = enable_crc_check;
+  config.verpose_flag             = verpose_flag;
+  if ((decoder = SLADecoder_Create(&config)) == NULL) {
+    fprintf(stderr, "Failed to create decoder handle. \n");
+    goto EXIT;
   }
 
   /* ヘッダから読み取ったパラメータをデコーダにセット */
   if ((ret = SLADecoder_SetWaveFormat(decoder, 
           &header.wave_format)) != SLA_APIRESULT_OK) {
     fprintf(stderr, "Failed to set wave parameter: %d \n", ret);
-    return 1;
+    goto EXIT;
   }
   if ((ret = SLADecoder_SetEncodeParameter(decoder, 
           &header.encode_param)) != SLA_APIRESULT_OK) {
     fprintf(stderr, "Failed to set encode parameter: %d \n", ret);
-    return 1;
+    goto EXIT;
   }
 
-  /* 一括デコード */
-  if ((ret = SLADecoder_DecodeWhole(decoder, 
-          buffer, buffer_size,
-          (int32_t **)out_wav->data, out_wav->format.num_samples,
-          &decode_num_samples)) != SLA_APIRESULT_OK) {
-    fprintf(stderr, "Decoding error! %d \n", ret);
-    return 1;
+  /* 出力wavの書き出し開始 */
+  wav_format.data_format     = WAV_DATA_FORMAT_PCM;
+  wav_format.num_channels    = header.wave_format.num_channels;
+  wav_format.sampling_rate   = header.wave_format.sampling_rate;
+  wav_format.bits_per_sample = header.wave_format.bit_per_sample;
+  /* 補足）サンプル数が不明ならば0として書き出し、終了時にヘッダを直す */
+  wav_format.num_samples     = (header.num_samples != SLA_NUM_SAMPLES_INVALID) ? header.num_samples : 0;
+  if ((out_wav = WAVStreamWriter_Open(out_filename, &wav_format)) == NULL) {
+    fprintf(stderr, "Failed to open %s \n", out_filename);
+    goto EXIT;
+  }
+  out_opened = (strcmp(out_filename, "-") != 0) ? 1 : 0;
+
+  /* 1ブロック分の入力/出力データ領域を作成 */
+  /* 補足）24bitは常に、16/32bitはリトルエンディアン環境でファイル上の形式のまま受け取れる */
+  if (((output = (int32_t **)calloc(header.wave_format.num_channels, sizeof(int32_t *))) == NULL)
+      || ((channel_data = (void **)calloc(header.wave_format.num_channels, sizeof(void *))) == NULL)) {
+    fprintf(stderr, "Failed to allocate memory. \n");
+    goto EXIT;
+  }
+  if ((wav_format.bits_per_sample == 24)
+      || (is_little_endian() && ((wav_format.bits_per_sample == 16) || (wav_format.bits_per_sample == 32)))) {
+    const uint32_t bytes_per_sample = wav_format.bits_per_sample / 8;
+    if ((interleaved = (uint8_t *)malloc(bytes_per_sample * wav_format.num_channels * header.encode_param.max_num_block_samples)) == NULL) {
+      fprintf(stderr, "Failed to allocate memory. \n");
+      goto EXIT;
+    }
+    for (ch = 0; ch < wav_format.num_channels; ch++) {
+      channel_data[ch] = &interleaved[ch * bytes_per_sample];
+    }
+    switch (wav_format.bits_per_sample) {
+      case 16:  pcm_output.sample_type = SLA_PCM_SAMPLE_TYPE_INT16;        break;
+      case 24:  pcm_output.sample_type = SLA_PCM_SAMPLE_TYPE_PACKED_INT24; break;
+      default:  pcm_output.sample_type = SLA_PCM_SAMPLE_TYPE_INT32;        break;
+    }
+    pcm_output.stride = wav_format.num_channels;
+  } else {
+    for (ch = 0; ch < header.wave_format.num_channels; ch++) {
+      if ((output[ch] = (int32_t *)malloc(sizeof(int32_t) * header.encode_param.max_num_block_samples)) == NULL) {
+        fprintf(stderr, "Failed to allocate memory. \n");
+        goto EXIT;
+      }
+      channel_data[ch] = output[ch];
+    }
+    pcm_output.sample_type = SLA_PCM_SAMPLE_TYPE_INT32_LEFT_JUSTIFIED;
+    pcm_output.stride      = 1;
+  }
+  pcm_output.channel_data = channel_data;
+  /* ヘッダの後ろまで読み込んだ分はブロックデータとして先頭に詰める */
+  memmove(buffer, &buffer[header.header_size], data_size - header.header_size);
+  data_size -= header.header_size;
+  /* 補足）バッファは最大ブロックサイズ（不明ならば十分なサイズ）で確保し、それを超えるブロックは破損として扱う */
+  buffer_size = get_block_buffer_size(&header, data_size);
+  {
+    uint8_t* new_buffer;
+    if ((new_buffer = (uint8_t *)realloc(buffer, buffer_size)) == NULL) {
+      fprintf(stderr, "Failed to allocate memory. \n");
+      goto EXIT;
+    }
+    buffer = new_buffer;
   }
 
-  /* WAVファイル書き出し */
-  if (WAV_WriteToFile(out_filename, out_wav) != WAV_APIRESULT_OK) {
-    fprintf(stderr, "Failed to write wav file. \n");
-    return 1;
+  /* ブロック単位で逐次デコード */
+  num_decoded_samples = 0;
+  while ((header.num_samples == SLA_NUM_SAMPLES_INVALID) || (num_decoded_samples < header.num_samples)) {
+    /* バッファを満たす */
+    data_size += (uint32_t)fread(&buffer[data_size], sizeof(uint8_t), buffer_size - data_size, in_fp);
+    if (data_size == 0) {
+      break;
+    }
+
+    /* ブロックサイズの確認 */
+    if ((ret = SLADecoder_GetBlockSize(buffer, data_size, &block_size)) != SLA_APIRESULT_OK) {
+      fprintf(stderr, "Failed to find the next block: %d \n", ret);
+      goto EXIT;
+    }
+    if (block_size > buffer_size) {
+      fprintf(stderr, "Block size %u exceeds the maximum block size %u(data is corrupted). \n", block_size, buffer_size);
+      goto EXIT;
+    }
+    if (block_size > data_size) {
+      fprintf(stderr, "The last block is truncated. \n");
+      goto EXIT;
+    }
+
+    /* ブロックデコード */
+    if ((ret = SLADecoder_DecodeBlockPcm(decoder, buffer, block_size,
+            &pcm_output, header.encode_param.max_num_block_samples,
+            &block_size, &block_num_samples)) != SLA_APIRESULT_OK) {
+      fprintf(stderr, "Decoding error! %d \n", ret);
+      goto EXIT;
+    }
+    if (write_decoder_output(out_wav, interleaved, output, block_num_samples) != WAV_APIRESULT_OK) {
+      fprintf(stderr, "Failed to write wav file. \n");
+      goto EXIT;
+    }
+
+    /* 残りのデータを先頭に詰める */
+    memmove(buffer, &buffer[block_size], data_size - block_size);
+    data_size           -= block_size;
+    num_decoded_samples += block_num_samples;
+
+    /* 進捗の表示 */
+    if ((verpose_flag != 0) && (header.num_samples != SLA_NUM_SAMPLES_INVALID)) {
+      printf("progress:%2u%% \r", (unsigned int)(((double)num_decoded_samples / (double)header.num_samples) * 100));
+      fflush(stdout);
+    }
+  }
+
+  /* WAVファイル書き出し終了 */
+  {
+    const WAVApiResult close_ret = WAVStreamWriter_Close(out_wav);
+    out_wav = NULL;
+    if (close_ret != WAV_APIRESULT_OK) {
+      fprintf(stderr, "Failed to write wav file. \n");
+      goto EXIT;
+    }
+  }
+
+  /* 読み込みエラー・ブロック境界での途中終了の検出 */
+  if (ferror(in_fp)) {
+    fprintf(stderr, "Failed to read %s \n", in_filename);
+    goto EXIT;
+  }
+  if ((header.num_samples != SLA_NUM_SAMPLES_INVALID) && (num_decoded_samples < header.num_samples)) {
+    fprintf(stderr, "Input is truncated: decoded %lu of %lu samples. \n",
+        (unsigned long)num_decoded_samples, (unsigned long)header.num_samples);
+    goto EXIT;
+  }
+
+  /* 統計情報の書き出し */
+  if (statistics_filename != NULL) {
+    struct SLAStatistics statistics;
+    if (output_statistics(statistics_filename, "decode",
+          SLADecoder_GetStatistics(decoder, &statistics), &statistics) != 0) {
+      goto EXIT;
+    }
   }
 
+  result = 0;
+
+EXIT:
+  /* 失敗時は書きかけの出力ファイルを残さない */
+  if (out_wav != NULL) {
+    (void)WAVStreamWriter_Close(out_wav);
+  }
+  if ((result != 0) && (out_opened != 0)) {
+    remove_partial_output(out_filename);
+  }
+  if (in_fp != stdin) {
+    fclose(in_fp);
+  }
   free(buffer);
-  WAV_Destroy(out_wav);
-  SLADecoder_Destroy(decoder);
+  free(interleaved);
+  if (output != NULL) {
+    for (ch = 0; ch < header.wave_format.num_channels; ch++) {
+      free(output[ch]);
+    }
+    free(output);
+  }
+  free(channel_data);
+  if (decoder != NULL) {
+    SLADecoder_Destroy(decoder);
+  }
 
-  return 0;
+  return result;
 }
 
 /* ストリーミングデコード */
-static int do_streaming_decode(const char* in_filename, const char* out_filename, uint8_t enable_crc_check, uint8_t verpose_flag)
+static int do_streaming_decode(const char* in_filename, const char* out_filename, uint8_t enable_crc_check, uint8_t verpose_flag,
+    const char* statistics_filename)
 {
   FILE*                               in_fp;
   struct WAVFile*                     out_wav;
@@ -286,31 +789,18 @@ static int do_streaming_decode(const char* in_filename, const char* out_filename
   struct SLAStreamingDecoderConfig    streaming_config;
   struct SLAHeaderInfo                header;
   uint8_t*                            buffer;
+  int32_t**                           output_ptr;
   uint32_t                            buffer_size, sample_progress, data_progress;
   SLAApiResult                        ret;
 
-  /* デコーダハンドルの作成 */
-  core_config.max_num_channels         = 8;
-  core_config.max_num_block_samples    = 16384;
-  core_config.max_parcor_order         = 48;
-  core_config.max_longterm_order       = 5;
-  core_config.max_lms_order_per_filter = 40;
-  core_config.enable_crc_check         = enable_crc_check;
-  core_config.verpose_flag             = verpose_flag;
-
-  streaming_config.max_bit_per_sample = 24;
-  streaming_config.decode_interval_hz = 120.0f;
-  streaming_config.core_config = core_config;
-
-  if ((decoder = SLAStreamingDecoder_Create(&streaming_config)) == NULL) {
-    fprintf(stderr, "Failed to create decoder handle. \n");
-    return 1;
-  }
-
   /* 入力ファイルオープン */
   in_fp = fopen(in_filename, "rb");
   /* 入力ファイルのサイズ取得 / バッファ領域割り当て */
   stat(in_filename, &fstat);
+  if ((uint64_t)fstat.st_size > UINT32_MAX) {
+    fprintf(stderr, "%s is too large (4GiB or more) for this mode. \n", in_filename);
+    return 1;
+  }
   buffer_size = (uint32_t)fstat.st_size;
   buffer = (uint8_t *)malloc(buffer_size);
   /* バッファ領域にデータをロード */
@@ -334,8 +824,8 @@ static int do_streaming_decode(const char* in_filename, const char* out_filename
     printf("Longterm Order:              %d \n", header.encode_param.longterm_order);
     printf("LMS Order Per Filter:        %d \n", header.encode_param.lms_order_per_filter);
     printf("Channel Process Method:      %d \n", header.encode_param.ch_process_method);
-    printf("Max Number of Block Samples: %d \n", header.encode_param.max_num_block_samples);
-    printf("Number of Samples:           %d \n", header.num_samples);
+    printf("Max Number of Block Samples: %u \n", header.encode_param.max_num_block_samples);
+    printf("Number of Samples:           %lu \n", (unsigned long)header.num_samples);
     printf("Number of Blocks:            %d \n", header.num_blocks);
     printf("Max Block Size:              %d \n", header.max_block_size);
     printf("Max Bit Per Second(bps):     %d \n", header.max_bit_per_second);
@@ -352,6 +842,25 @@ static int do_streaming_decode(const char* in_filename, const char* out_filename
     return 1;
   }
 
+  /* デコーダハンドルの作成（チャンネル数とブロックあたり最大サンプル数はヘッダに合わせる） */
+  /* 補足）ストリーミングデコーダの連結領域はブロックサイズに比例して確保される */
+  core_config.max_num_channels         = header.wave_format.num_channels;
+  core_config.max_num_block_samples    = header.encode_param.max_num_block_samples;
+  core_config.max_parcor_order         = 48;
+  core_config.max_longterm_order       = 5;
+  core_config.max_lms_order_per_filter = 40;
+  core_config.enable_crc_check         = enable_crc_check;
+  core_config.verpose_flag             = verpose_flag;
+
+  streaming_config.max_bit_per_sample = 24;
+  streaming_config.decode_interval_hz = 120.0f;
+  streaming_config.core_config = core_config;
+
+  if ((decoder = SLAStreamingDecoder_Create(&streaming_config)) == NULL) {
+    fprintf(stderr, "Failed to create decoder handle. \n");
+    return 1;
+  }
+
   /* ヘッダから読み取ったパラメータをデコーダにセット */
   if ((ret = SLAStreamingDecoder_SetWaveFormat(decoder, 
           &header.wave_format)) != SLA_APIRESULT_OK) {
@@ -365,12 +874,12 @@ static int do_streaming_decode(const char* in_filename, const char* out_filename
   }
 
   /* ストリーミングデコード */
+  output_ptr = (int32_t **)malloc(sizeof(int32_t *) * header.wave_format.num_channels);
   sample_progress = 0;
-  data_progress = SLA_HEADER_SIZE;
+  data_progress = header.header_size;
   while (sample_progress < header.num_samples) {
     uint32_t ch;
     uint32_t put_data_size, estimate_min_data_size, tmp_output_samples;
-    int32_t  *output_ptr[8];
     const uint8_t* dummy_out_ptr;
     uint32_t dummy_out_size;
 
@@ -390,21 +899,26 @@ static int do_streaming_decode(const char* in_filename, const char* out_filename
     for (ch = 0; ch < header.wave_format.num_channels; ch++) {
       output_ptr[ch] = &out_wav->data[ch][sample_progress];
     }
-    if ((ret = SLAStreamingDecoder_Decode(decoder,
-            output_ptr, header.num_samples - sample_progress, &tmp_output_samples)) != SLA_APIRESULT_OK) {
+    ret = SLAStreamingDecoder_Decode(decoder,
+        output_ptr, (uint32_t)(header.num_samples - sample_progress), &tmp_output_samples);
+    if ((ret == SLA_APIRESULT_INSUFFICIENT_DATA_SIZE) && ((data_progress + put_data_size) < buffer_size)) {
+      /* ブロック全体が揃うまでデータを追加する */
+      tmp_output_samples = 0;
+    } else if (ret != SLA_APIRESULT_OK) {
       fprintf(stderr, "Streaming Decode failed! ret:%d \n", ret);
       return 1;
     }
 
     /* 消費済みデータ回収 */
-    SLAStreamingDecoder_CollectDataFragment(decoder, &dummy_out_ptr, &dummy_out_size);
+    while (SLAStreamingDecoder_CollectDataFragment(decoder,
+          &dummy_out_ptr, &dummy_out_size) == SLA_APIRESULT_OK) ;
 
     /* 出力を進める */
     data_progress     += put_data_size;
     sample_progress   += tmp_output_samples;
 
     if (verpose_flag != 0) {
-      printf("progress: %4.1f %% \r", (double)sample_progress / header.num_samples * 100.0f);
+      printf("progress: %4.1f %% \r", (double)sample_progress / (double)header.num_samples * 100.0f);
       fflush(stdout);
     }
   }
@@ -415,32 +929,619 @@ static int do_streaming_decode(const char* in_filename, const char* out_filename
     return 1;
   }
 
+  /* 統計情報の書き出し */
+  if (statistics_filename != NULL) {
+    struct SLAStatistics statistics;
+    if (output_statistics(statistics_filename, "streaming_decode",
+          SLAStreamingDecoder_GetStatistics(decoder, &statistics), &statistics) != 0) {
+      return 1;
+    }
+  }
+
   free(buffer);
+  free(output_ptr);
   WAV_Destroy(out_wav);
   SLAStreamingDecoder_Destroy(decoder);
 
   return 0;
 }
 
+/* ブロック索引ファイルの作成 */
+static int do_index(const char* in_filename, const char* out_filename, uint8_t verpose_flag)
+{
+  FILE*                       in_fp;
+  FILE*                       out_fp;
+  struct stat                 fstat;
+  struct SLABlockIndexEntry*  entries;
+  uint8_t*                    buffer;
+  uint8_t*                    index_data;
+  uint64_t                    buffer_size;
+  uint32_t                    num_entries, index_size;
+  SLAApiResult                ret;
+
+  /* 入力ファイルオープン */
+  if ((in_fp = fopen(in_filename, "rb")) == NULL) {
+    fprintf(stderr, "Failed to open %s \n", in_filename);
+    return 1;
+  }
+  /* 入力ファイルのサイズ取得 / バッファ領域割り当て */
+  /* 補足）索引のオフセットは64bitなので4GiB以上のファイルも扱える */
+  if ((stat(in_filename, &fstat) != 0) || ((uint64_t)fstat.st_size > (uint64_t)((size_t)-1))) {
+    fprintf(stderr, "Failed to get the size of %s \n", in_filename);
+    fclose(in_fp);
+    return 1;
+  }
+  buffer_size = (uint64_t)fstat.st_size;
+  if ((buffer = (uint8_t *)malloc((size_t)buffer_size)) == NULL) {
+    fprintf(stderr, "Failed to allocate memory. \n");
+    fclose(in_fp);
+    return 1;
+  }
+  /* バッファ領域にデータをロード */
+  if (fread(buffer, sizeof(uint8_t), (size_t)buffer_size, in_fp) != (size_t)buffer_size) {
+    fprintf(stderr, "Failed to read %s \n", in_filename);
+    free(buffer);
+    fclose(in_fp);
+    return 1;
+  }
+  fclose(in_fp);
+
+  /* ブロック数の計数 */
+  ret = SLADecoder_BuildBlockIndex(buffer, buffer_size, NULL, 0, &num_entries);
+  if ((ret != SLA_APIRESULT_OK) && (ret != SLA_APIRESULT_DETECT_DATA_CORRUPTION)) {
+    fprintf(stderr, "Failed to scan blocks: %d \n", ret);
+    return 1;
+  }
+
+  /* 索引の作成 */
+  entries = (struct SLABlockIndexEntry *)malloc(sizeof(struct SLABlockIndexEntry) * (num_entries + 1));
+  ret = SLADecoder_BuildBlockIndex(buffer, buffer_size, entries, num_entries, &num_entries);
+  if (ret == SLA_APIRESULT_DETECT_DATA_CORRUPTION) {
+    /* 破損ブロックは索引に含めずに続行 */
+    fprintf(stderr, "Warning: %s contains damaged blocks; they are excluded from the index. \n", in_filename);
+  } else if (ret != SLA_APIRESULT_OK) {
+    fprintf(stderr, "Failed to build block index: %d \n", ret);
+    return 1;
+  }
+
+  /* 索引ファイルの書き出し */
+  if (((index_size = SLADecoder_CalculateBlockIndexFileSize(num_entries)) == 0)
+      || ((index_data = (uint8_t *)malloc(index_size)) == NULL)) {
+    fprintf(stderr, "Failed to allocate block index for %u blocks. \n", num_entries);
+    return 1;
+  }
+  if ((ret = SLADecoder_EncodeBlockIndexFile(buffer, buffer_size,
+          entries, num_entries, index_data, index_size, &index_size)) != SLA_APIRESULT_OK) {
+    fprintf(stderr, "Failed to encode block index: %d \n", ret);
+    return 1;
+  }
+  if ((out_fp = fopen(out_filename, "wb")) == NULL) {
+    fprintf(stderr, "Failed to open %s \n", out_filename);
+    return 1;
+  }
+  fwrite(index_data, sizeof(uint8_t), index_size, out_fp);
+  fclose(out_fp);
+
+  if (verpose_flag != 0) {
+    printf("Num Blocks:                  %d \n", num_entries);
+    printf("Index Size:                  %d \n", index_size);
+  }
+
+  free(index_data);
+  free(entries);
+  free(buffer);
+
+  return 0;
+}
+
+/* 完全性の検証 */
+/* 補足）ブロック単位で読み込みながら検証するため、ファイル全体をメモリに載せない
+ *       deep_flagが立っていれば各ブロックをCRCチェック付きでデコードし、出力は捨てる */
+static int do_test(const char* in_filename, uint8_t deep_flag, uint8_t verpose_flag)
+{
+  FILE*                     in_fp;
+  struct SLADecoder*        decoder = NULL;
+  struct SLADecoderConfig   config;
+  struct SLAHeaderInfo      header;
+  int32_t**                 output = NULL;
+  uint8_t*                  buffer;
+  uint32_t                  ch, buffer_size, data_size, block_size, block_num_samples, num_blocks;
+  uint64_t                  num_samples, offset;
+  SLAApiResult              ret;
+  int                       result = 1;
+
+  /* 入力ファイルオープン */
+  if (strcmp(in_filename, "-") == 0) {
+    in_fp = stdin;
+  } else if ((in_fp = fopen(in_filename, "rb")) == NULL) {
+    fprintf(stderr, "Failed to open %s \n", in_filename);
+    return 1;
+  }
+
+  /* ヘッダ検証 */
+  buffer_size = SLA_HEADER_SIZE;
+  if ((buffer = (uint8_t *)malloc(buffer_size)) == NULL) {
+    fprintf(stderr, "Failed to allocate memory. \n");
+    goto EXIT;
+  }
+  data_size = (uint32_t)fread(buffer, sizeof(uint8_t), SLA_HEADER_SIZE, in_fp);
+  if ((ret = SLADecoder_DecodeHeader(buffer, data_size, &header)) != SLA_APIRESULT_OK) {
+    fprintf(stderr, "%s: header is broken: %d \n", in_filename, ret);
+    goto EXIT;
+  }
+
+  /* 詳細検証ではデコーダハンドルを作成 */
+  if (deep_flag != 0) {
+    config.max_num_channels         = header.wave_format.num_channels;
+    config.max_num_block_samples    = header.encode_param.max_num_block_samples;
+    config.max_parcor_order         = 48;
+    config.max_longterm_order       = 5;
+    config.max_lms_order_per_filter = 40;
+    config.enable_crc_check         = 1;
+    config.verpose_flag             = 0;
+    if ((decoder = SLADecoder_Create(&config)) == NULL) {
+      fprintf(stderr, "Failed to create decoder handle. \n");
+      goto EXIT;
+    }
+    if (((ret = SLADecoder_SetWaveFormat(decoder, &header.wave_format)) != SLA_APIRESULT_OK)
+        || ((ret = SLADecoder_SetEncodeParameter(decoder, &header.encode_param)) != SLA_APIRESULT_OK)) {
+      fprintf(stderr, "%s: invalid parameters in header: %d \n", in_filename, ret);
+      goto EXIT;
+    }
+    if ((output = (int32_t **)calloc(header.wave_format.num_channels, sizeof(int32_t *))) == NULL) {
+      fprintf(stderr, "Failed to allocate memory. \n");
+      goto EXIT;
+    }
+    for (ch = 0; ch < header.wave_format.num_channels; ch++) {
+      if ((output[ch] = (int32_t *)malloc(sizeof(int32_t) * header.encode_param.max_num_block_samples)) == NULL) {
+        fprintf(stderr, "Failed to allocate memory. \n");
+        goto EXIT;
+      }
+    }
+  }
+
+  /* ヘッダの後ろまで読み込んだ分はブロックデータとして先頭に詰める */
+  memmove(buffer, &buffer[header.header_size], data_size - header.header_size);
+  data_size -= header.header_size;
+  /* 補足）バッファは最大ブロックサイズ（不明ならば十分なサイズ）で確保し、それを超えるブロックは破損として扱う */
+  buffer_size = get_block_buffer_size(&header, data_size);
+  {
+    uint8_t* new_buffer;
+    if ((new_buffer = (uint8_t *)realloc(buffer, buffer_size)) == NULL) {
+      fprintf(stderr, "Failed to allocate memory. \n");
+      goto EXIT;
+    }
+    buffer = new_buffer;
+  }
+
+  /* ブロック単位で逐次検証 */
+  num_blocks = 0;
+  num_samples = 0;
+  offset = header.header_size;
+  while (1) {
+    /* バッファを満たす */
+    data_size += (uint32_t)fread(&buffer[data_size], sizeof(uint8_t), buffer_size - data_size, in_fp);
+    if (data_size == 0) {
+      break;
+    }
+
+    /* バッファに収まらないブロックは破損 */
+    if ((SLADecoder_GetBlockSize(buffer, data_size, &block_size) == SLA_APIRESULT_OK)
+        && (block_size > buffer_size)) {
+      fprintf(stderr, "%s: block %u at offset %lu exceeds the maximum block size %u \n",
+          in_filename, num_blocks, (unsigned long)offset, buffer_size);
+      goto EXIT;
+    }
+
+    /* ブロック検証 */
+    if ((ret = SLADecoder_VerifyBlock(buffer, data_size, &header,
+            &block_size, &block_num_samples)) != SLA_APIRESULT_OK) {
+      fprintf(stderr, "%s: block %u at offset %lu is broken: %d \n",
+          in_filename, num_blocks, (unsigned long)offset, ret);
+      goto EXIT;
+    }
+    if (decoder != NULL) {
+      uint32_t decoded_block_size, decoded_num_samples;
+      if (((ret = SLADecoder_DecodeBlock(decoder, buffer, block_size,
+                output, header.encode_param.max_num_block_samples,
+                &decoded_block_size, &decoded_num_samples)) != SLA_APIRESULT_OK)
+          || (decoded_block_size != block_size) || (decoded_num_samples != block_num_samples)) {
+        fprintf(stderr, "%s: failed to decode block %u at offset %lu: %d \n",
+            in_filename, num_blocks, (unsigned long)offset, ret);
+        goto EXIT;
+      }
+    }
+
+    /* 残りのデータを先頭に詰める */
+    memmove(buffer, &buffer[block_size], data_size - block_size);
+    data_size   -= block_size;
+    offset      += block_size;
+    num_samples += block_num_samples;
+    num_blocks++;
+  }
+
+  /* ヘッダに記録されたブロック数・サンプル数との一致 */
+  if ((header.num_blocks != SLA_NUM_BLOCKS_INVALID) && (num_blocks != header.num_blocks)) {
+    fprintf(stderr, "%s: number of blocks mismatch (header:%u actual:%u) \n",
+        in_filename, header.num_blocks, num_blocks);
+    goto EXIT;
+  }
+  if ((header.num_samples != SLA_NUM_SAMPLES_INVALID) && (num_samples != header.num_samples)) {
+    fprintf(stderr, "%s: number of samples mismatch (header:%lu actual:%lu) \n",
+        in_filename, (unsigned long)header.num_samples, (unsigned long)num_samples);
+    goto EXIT;
+  }
+
+  if (verpose_flag != 0) {
+    printf("%s: OK (%u blocks, %lu samples) \n", in_filename, num_blocks, (unsigned long)num_samples);
+  }
+  result = 0;
+
+EXIT:
+  if (in_fp != stdin) {
+    fclose(in_fp);
+  }
+  if (output != NULL) {
+    for (ch = 0; ch < header.wave_format.num_channels; ch++) {
+      free(output[ch]);
+    }
+    free(output);
+  }
+  if (decoder != NULL) {
+    SLADecoder_Destroy(decoder);
+  }
+  free(buffer);
+  return result;
+}
+
+/* バッチ処理の1ファイル分のジョブ */
+struct BatchJob {
+  char*     in_filename;    /* 入力ファイル名 */
+  char*     out_filename;   /* 出力ファイル名 */
+  double    size;           /* 入力ファイルサイズ */
+  uint32_t  order;          /* 列挙順 */
+  int       result;         /* 処理結果（0で成功） */
+};
+
+/* バッチ処理のジョブリスト */
+struct BatchJobList {
+  struct BatchJob*  jobs;       /* ジョブ配列 */
+  uint32_t          num_jobs;   /* ジョブ数 */
+  uint32_t          capacity;   /* 配列の確保数 */
+};
+
+/* バッチ処理の共有状態 */
+struct BatchContext {
+  struct BatchJobList*  list;             /* ジョブリスト */
+  uint8_t               decode_flag;      /* デコードするか？ */
+  uint8_t               test_flag;        /* 検証のみ行うか？ */
+  uint8_t               deep_flag;        /* 検証時にデコードまで行うか？ */
+  uint32_t              encode_preset_no; /* エンコードプリセット番号 */
+  uint32_t              max_num_block_samples; /* ブロックあたり最大サンプル数（0ならばプリセットの値） */
+  uint8_t               enable_crc_check; /* CRCチェックを行うか？ */
+  uint8_t               verpose_flag;     /* 進捗を表示するか？ */
+  uint32_t              next_job;         /* 次に取り出すジョブ番号 */
+  uint32_t              num_finished;     /* 処理を終えたジョブ数 */
+#if defined(SLACLI_USE_POSIX)
+  pthread_mutex_t       mutex;            /* 共有状態の排他 */
+#endif
+};
+
+/* 拡張子の判定（大文字小文字は区別しない） */
+static int batch_has_extension(const char* filename, const char* ext)
+{
+  size_t i, len = strlen(filename), ext_len = strlen(ext);
+
+  if (len < ext_len) {
+    return 0;
+  }
+  for (i = 0; i < ext_len; i++) {
+    if (tolower((unsigned char)filename[len - ext_len + i]) != tolower((unsigned char)ext[i])) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/* ジョブの追加 */
+static int batch_add_job(struct BatchJobList* list, const char* in_filename,
+    const char* in_ext, const char* out_ext, double size)
+{
+  struct BatchJob* job;
+  size_t base_len = strlen(in_filename);
+
+  /* 配列の拡張 */
+  if (list->num_jobs >= list->capacity) {
+    uint32_t capacity = (list->capacity == 0) ? 64 : (2 * list->capacity);
+    struct BatchJob* jobs = (struct BatchJob *)realloc(list->jobs, sizeof(struct BatchJob) * capacity);
+    if (jobs == NULL) {
+      return 1;
+    }
+    list->jobs = jobs;
+    list->capacity = capacity;
+  }
+
+  /* 出力ファイル名は入力の拡張子を置き換えたもの */
+  if (batch_has_extension(in_filename, in_ext)) {
+    base_len -= strlen(in_ext);
+  }
+  job = &list->jobs[list->num_jobs];
+  job->in_filename = (char *)malloc(strlen(in_filename) + 1);
+  job->out_filename = (char *)malloc(base_len + strlen(out_ext) + 1);
+  if ((job->in_filename == NULL) || (job->out_filename == NULL)) {
+    free(job->in_filename);
+    free(job->out_filename);
+    return 1;
+  }
+  strcpy(job->in_filename, in_filename);
+  memcpy(job->out_filename, in_filename, base_len);
+  strcpy(&job->out_filename[base_len], out_ext);
+  job->size = size;
+  job->order = list->num_jobs;
+  job->result = 1;
+  list->num_jobs++;
+
+  return 0;
+}
+
+/* パスをジョブリストに追加 */
+/* 補足）ディレクトリは再帰的に辿り、入力の拡張子を持つファイルだけを追加する */
+static int batch_add_path(struct BatchJobList* list, const char* path,
+    const char* in_ext, const char* out_ext, uint8_t from_directory)
+{
+  struct stat path_stat;
+
+  if (stat(path, &path_stat) != 0) {
+    fprintf(stderr, "Failed to open %s \n", path);
+    return 1;
+  }
+
+  if (S_ISDIR(path_stat.st_mode)) {
+#if defined(SLACLI_USE_POSIX)
+    DIR* dir;
+    struct dirent* entry;
+    int ret = 0;
+    if ((dir = opendir(path)) == NULL) {
+      fprintf(stderr, "Failed to open directory %s \n", path);
+      return 1;
+    }
+    while ((ret == 0) && ((entry = readdir(dir)) != NULL)) {
+      char* child;
+      if ((strcmp(entry->d_name, ".") == 0) || (strcmp(entry->d_name, "..") == 0)) {
+        continue;
+      }
+      if ((child = (char *)malloc(strlen(path) + strlen(entry->d_name) + 2)) == NULL) {
+        ret = 1;
+        break;
+      }
+      sprintf(child, "%s/%s", path, entry->d_name);
+      ret = batch_add_path(list, child, in_ext, out_ext, 1);
+      free(child);
+    }
+    closedir(dir);
+    return ret;
+#else
+    fprintf(stderr, "Directory input is not supported on this platform: %s \n", path);
+    return 1;
+#endif
+  }
+
+  /* ディレクトリ内では入力の拡張子を持つ通常ファイルだけを対象にする */
+  if ((from_directory != 0)
+      && (!S_ISREG(path_stat.st_mode) || !batch_has_extension(path, in_ext))) {
+    return 0;
+  }
+
+  if (batch_add_job(list, path, in_ext, out_ext, (double)path_stat.st_size) != 0) {
+    fprintf(stderr, "Failed to allocate memory. \n");
+    return 1;
+  }
+
+  return 0;
+}
+
+/* ジョブの並び順: 大きいファイルから先に処理して末尾で待つスレッドを減らす */
+static int batch_compare_job(const void* a, const void* b)
+{
+  const struct BatchJob* job_a = (const struct BatchJob *)a;
+  const struct BatchJob* job_b = (const struct BatchJob *)b;
+
+  if (job_a->size != job_b->size) {
+    return (job_a->size > job_b->size) ? -1 : 1;
+  }
+  return (job_a->order < job_b->order) ? -1 : 1;
+}
+
+/* 共有状態の排他開始/終了 */
+static void batch_lock(struct BatchContext* ctx)
+{
+#if defined(SLACLI_USE_POSIX)
+  pthread_mutex_lock(&ctx->mutex);
+#else
+  (void)ctx;
+#endif
+}
+static void batch_unlock(struct BatchContext* ctx)
+{
+#if defined(SLACLI_USE_POSIX)
+  pthread_mutex_unlock(&ctx->mutex);
+#else
+  (void)ctx;
+#endif
+}
+
+/* バッチ処理のワーカ: 空いたスレッドが次のジョブを取り出して処理する */
+static void* batch_worker(void* arg)
+{
+  struct BatchContext* ctx = (struct BatchContext *)arg;
+  struct BatchJob* job;
+
+  while (1) {
+    /* ジョブの取り出し */
+    batch_lock(ctx);
+    if (ctx->next_job >= ctx->list->num_jobs) {
+      batch_unlock(ctx);
+      break;
+    }
+    job = &ctx->list->jobs[ctx->next_job++];
+    batch_unlock(ctx);
+
+    /* 単一ファイルの処理と同じ経路で処理するため、出力は逐次処理と一致する */
+    if (ctx->test_flag != 0) {
+      job->result = do_test(job->in_filename, ctx->deep_flag, 0);
+    } else if (ctx->decode_flag != 0) {
+      job->result = do_decode(job->in_filename, job->out_filename, ctx->enable_crc_check, 0, NULL);
+    } else {
+      job->result = do_encode(job->in_filename, job->out_filename, ctx->encode_preset_no, ctx->max_num_block_samples, 0, NULL);
+    }
+
+    /* 進捗表示 */
+    batch_lock(ctx);
+    ctx->num_finished++;
+    if (job->result != 0) {
+      fprintf(stderr, "Failed to %s %s \n",
+          (ctx->test_flag != 0) ? "verify" : ((ctx->decode_flag != 0) ? "decode" : "encode"), job->in_filename);
+    } else if ((ctx->verpose_flag != 0) && (ctx->test_flag != 0)) {
+      printf("[%u/%u] %s: OK \n", ctx->num_finished, ctx->list->num_jobs, job->in_filename);
+      fflush(stdout);
+    } else if (ctx->verpose_flag != 0) {
+      printf("[%u/%u] %s -> %s \n", ctx->num_finished, ctx->list->num_jobs, job->in_filename, job->out_filename);
+      fflush(stdout);
+    }
+    batch_unlock(ctx);
+  }
+
+  return NULL;
+}
+
+/* 複数ファイルの一括処理 */
+/* 補足）検証（test_flag）ではデコードと同様に.slaファイルを対象とし、出力ファイルは作らない */
+static int do_batch(const char* const* paths, uint32_t num_paths, uint32_t num_threads,
+    uint8_t decode_flag, uint8_t test_flag, uint8_t deep_flag,
+    uint32_t encode_preset_no, uint32_t max_num_block_samples,
+    uint8_t enable_crc_check, uint8_t verpose_flag)
+{
+  struct BatchJobList list = { NULL, 0, 0 };
+  struct BatchContext ctx;
+  const char* in_ext = ((decode_flag != 0) || (test_flag != 0)) ? ".sla" : ".wav";
+  const char* out_ext = (decode_flag != 0) ? ".wav" : ".sla";
+  uint32_t i, num_failed;
+  int ret = 0;
+
+  /* ジョブの列挙 */
+  for (i = 0; i < num_paths; i++) {
+    if (strcmp(paths[i], "-") == 0) {
+      fprintf(stderr, "Standard input/output cannot be used with -j. \n");
+      ret = 1;
+      goto EXIT;
+    }
+    if ((ret = batch_add_path(&list, paths[i], in_ext, out_ext, 0)) != 0) {
+      goto EXIT;
+    }
+  }
+  if (list.num_jobs == 0) {
+    fprintf(stderr, "No %s files found. \n", in_ext);
+    ret = 1;
+    goto EXIT;
+  }
+  qsort(list.jobs, list.num_jobs, sizeof(struct BatchJob), batch_compare_job);
+
+  ctx.list = &list;
+  ctx.decode_flag = decode_flag;
+  ctx.test_flag = test_flag;
+  ctx.deep_flag = deep_flag;
+  ctx.encode_preset_no = encode_preset_no;
+  ctx.max_num_block_samples = max_num_block_samples;
+  ctx.enable_crc_check = enable_crc_check;
+  ctx.verpose_flag = verpose_flag;
+  ctx.next_job = 0;
+  ctx.num_finished = 0;
+
+  num_threads = MIN(num_threads, list.num_jobs);
+#if defined(SLACLI_USE_POSIX)
+  if (num_threads > 1) {
+    pthread_t* threads;
+    uint32_t num_created = 0;
+    if ((threads = (pthread_t *)malloc(sizeof(pthread_t) * num_threads)) == NULL) {
+      fprintf(stderr, "Failed to allocate memory. \n");
+      ret = 1;
+      goto EXIT;
+    }
+    pthread_mutex_init(&ctx.mutex, NULL);
+    for (i = 0; i < num_threads; i++) {
+      if (pthread_create(&threads[i], NULL, batch_worker, &ctx) != 0) {
+        break;
+      }
+      num_created++;
+    }
+    /* スレッドを1つも作れなければ呼び出しスレッドで処理する */
+    if (num_created == 0) {
+      batch_worker(&ctx);
+    }
+    for (i = 0; i < num_created; i++) {
+      pthread_join(threads[i], NULL);
+    }
+    pthread_mutex_destroy(&ctx.mutex);
+    free(threads);
+  } else {
+    pthread_mutex_init(&ctx.mutex, NULL);
+    batch_worker(&ctx);
+    pthread_mutex_destroy(&ctx.mutex);
+  }
+#else
+  batch_worker(&ctx);
+#endif
+
+  /* 結果の集計 */
+  num_failed = 0;
+  for (i = 0; i < list.num_jobs; i++) {
+    if (list.jobs[i].result != 0) {
+      num_failed++;
+    }
+  }
+  if (verpose_flag != 0) {
+    printf("Processed %u files (%u failed) \n", list.num_jobs, num_failed);
+  }
+  ret = (num_failed == 0) ? 0 : 1;
+
+EXIT:
+  for (i = 0; i < list.num_jobs; i++) {
+    free(list.jobs[i].in_filename);
+    free(list.jobs[i].out_filename);
+  }
+  free(list.jobs);
+  return ret;
+}
+
 /* 使用法の表示 */
 static void print_usage(char** argv)
 {
   printf("Usage: %s [options] INPUT_FILE_NAME OUTPUT_FILE_NAME \n", argv[0]);
+  printf("       %s -t [-D] [options] INPUT_FILE_NAME \n", argv[0]);
+  printf("       %s -e|-d|-t -j NUM_THREADS [options] FILE_OR_DIRECTORY ... \n", argv[0]);
+  printf("('-' as a file name means standard input/output) \n");
+  printf("(batch mode writes X.sla for X.wav and X.wav for X.sla next to each input) \n");
 }
 
 /* バージョン情報の表示 */
 static void print_version_info(void)
 {
+  static const char* simd_name[] = { "none", "sse4.1" };
   printf("SLA - Solitary Lossless Audio Compressor Version %s \n", SLA_VERSION_STRING);
+  printf("SIMD instruction set: %s \n", simd_name[SLA_GetSIMDInstructionSet()]);
 }
 
 /* メインエントリ */
 int main(int argc, char** argv)
 {
   const char* filename_ptr[2] = { NULL, NULL };
+  const char** batch_files = NULL;
   const char* input_file;
-  const char* output_file;
+  const char* output_file = NULL;
+  const char* statistics_file = NULL;
+  char*       index_file = NULL;
   uint8_t     verpose_flag = 1;
+  uint32_t    num_files, num_threads = 0;
 
   /* 引数が足らない */
   if (argc == 1) {
@@ -449,11 +1550,66 @@ int main(int argc, char** argv)
   }
 
   /* コマンドライン解析 */
+  /* 補足）バッチ処理では全てがファイル名になりうるため引数の数だけ領域を確保 */
+  if ((batch_files = (const char **)calloc((size_t)argc, sizeof(const char *))) == NULL) {
+    return 1;
+  }
   if (CommandLineParser_ParseArguments(command_line_spec,
-        argc, argv, filename_ptr, sizeof(filename_ptr) / sizeof(filename_ptr[0]))
+        argc, argv, batch_files, (uint32_t)argc)
       != COMMAND_LINE_PARSER_RESULT_OK) {
     return 1;
   }
+  for (num_files = 0; (num_files < (uint32_t)argc) && (batch_files[num_files] != NULL); num_files++) ;
+
+  /* バッチ処理のスレッド数 */
+  if (CommandLineParser_GetOptionAcquired(command_line_spec, "jobs") == COMMAND_LINE_PARSER_TRUE) {
+    char* end;
+    long jobs = strtol(CommandLineParser_GetArgumentString(command_line_spec, "jobs"), &end, 10);
+    if ((*end != '\0') || (jobs < 0)) {
+      fprintf(stderr, "%s: invalid number of threads. \n", argv[0]);
+      return 1;
+    }
+    num_threads = (uint32_t)jobs;
+    if (num_threads == 0) {
+#if defined(SLACLI_USE_POSIX)
+      long num_cores = sysconf(_SC_NPROCESSORS_ONLN);
+      num_threads = (num_cores > 0) ? (uint32_t)num_cores : 1;
+#else
+      num_threads = 1;
+#endif
+    }
+  } else {
+    /* 単一ファイルの処理 */
+    if (num_files > 2) {
+      fprintf(stderr, "%s: too many file names are specified(use -j for batch mode). \n", argv[0]);
+      return 1;
+    }
+    filename_ptr[0] = batch_files[0];
+    filename_ptr[1] = batch_files[1];
+    free(batch_files);
+    batch_files = NULL;
+  }
+
+  /* SIMD命令セットの指定 */
+  if (CommandLineParser_GetOptionAcquired(command_line_spec, "instruction-set") == COMMAND_LINE_PARSER_TRUE) {
+    const char* simd_arg
+      = CommandLineParser_GetArgumentString(command_line_spec, "instruction-set");
+    SLASIMDInstructionSet simd;
+    if (strcmp(simd_arg, "auto") == 0) {
+      simd = SLA_SIMDINSTRUCTIONSET_AUTO;
+    } else if (strcmp(simd_arg, "none") == 0) {
+      simd = SLA_SIMDINSTRUCTIONSET_NONE;
+    } else if (strcmp(simd_arg, "sse4.1") == 0) {
+      simd = SLA_SIMDINSTRUCTIONSET_SSE41;
+    } else {
+      fprintf(stderr, "%s: unknown instruction set %s. \n", argv[0], simd_arg);
+      return 1;
+    }
+    if (SLA_SetSIMDInstructionSet(simd) != SLA_APIRESULT_OK) {
+      fprintf(stderr, "%s: instruction set %s is not supported on this machine. \n", argv[0], simd_arg);
+      return 1;
+    }
+  }
 
   /* ヘルプやバージョン情報の表示判定 */
   if (CommandLineParser_GetOptionAcquired(command_line_spec, "help") == COMMAND_LINE_PARSER_TRUE) {
@@ -466,6 +1622,16 @@ int main(int argc, char** argv)
     return 0;
   }
 
+  /* バッチ処理ではファイル毎に入出力を決める */
+  if (batch_files != NULL) {
+    filename_ptr[0] = batch_files[0];
+    if ((CommandLineParser_GetOptionAcquired(command_line_spec, "index") == COMMAND_LINE_PARSER_TRUE)
+        || (CommandLineParser_GetOptionAcquired(command_line_spec, "statistics") == COMMAND_LINE_PARSER_TRUE)) {
+      fprintf(stderr, "%s: index(-x) and statistics(-S) cannot be used with -j. \n", argv[0]);
+      return 1;
+    }
+  }
+
   /* 入力ファイル名の取得 */
   if ((input_file = filename_ptr[0]) == NULL) {
     fprintf(stderr, "%s: input file must be specified. \n", argv[0]);
@@ -473,7 +1639,17 @@ int main(int argc, char** argv)
   }
   
   /* 出力ファイル名の取得 */
-  if ((output_file = filename_ptr[1]) == NULL) {
+  if ((filename_ptr[1] == NULL)
+      && (CommandLineParser_GetOptionAcquired(command_line_spec, "index") == COMMAND_LINE_PARSER_TRUE)) {
+    /* 索引作成時は入力ファイル名に拡張子を付けた名前を既定とする */
+    index_file = (char *)malloc(strlen(input_file) + strlen(".slaidx") + 1);
+    strcpy(index_file, input_file);
+    strcat(index_file, ".slaidx");
+    filename_ptr[1] = index_file;
+  }
+  if ((batch_files == NULL)
+      && (CommandLineParser_GetOptionAcquired(command_line_spec, "test") != COMMAND_LINE_PARSER_TRUE)
+      && ((output_file = filename_ptr[1]) == NULL)) {
     fprintf(stderr, "%s: output file must be specified. \n", argv[0]);
     return 1;
   }
@@ -484,6 +1660,14 @@ int main(int argc, char** argv)
       fprintf(stderr, "%s: encode and decode mode cannot specify simultaneously. \n", argv[0]);
       return 1;
   }
+  /* 検証は他のモードと同時に指定できない */
+  if ((CommandLineParser_GetOptionAcquired(command_line_spec, "test") == COMMAND_LINE_PARSER_TRUE)
+      && ((CommandLineParser_GetOptionAcquired(command_line_spec, "decode") == COMMAND_LINE_PARSER_TRUE)
+        || (CommandLineParser_GetOptionAcquired(command_line_spec, "encode") == COMMAND_LINE_PARSER_TRUE)
+        || (CommandLineParser_GetOptionAcquired(command_line_spec, "index") == COMMAND_LINE_PARSER_TRUE))) {
+    fprintf(stderr, "%s: test mode cannot specify with encode, decode or index mode. \n", argv[0]);
+    return 1;
+  }
 
   /* 情報表示オプション */
   if (CommandLineParser_GetOptionAcquired(command_line_spec, "verpose") == COMMAND_LINE_PARSER_TRUE) {
@@ -491,8 +1675,43 @@ int main(int argc, char** argv)
   } else if (CommandLineParser_GetOptionAcquired(command_line_spec, "quiet") == COMMAND_LINE_PARSER_TRUE) {
     verpose_flag = 0;
   }
+  /* 標準出力にデータを書き出す場合は情報を表示しない */
+  if ((output_file != NULL) && (strcmp(output_file, "-") == 0)) {
+    verpose_flag = 0;
+  }
 
-  if (CommandLineParser_GetOptionAcquired(command_line_spec, "decode") == COMMAND_LINE_PARSER_TRUE) {
+  /* 統計情報の出力先 */
+  if (CommandLineParser_GetOptionAcquired(command_line_spec, "statistics") == COMMAND_LINE_PARSER_TRUE) {
+    statistics_file = CommandLineParser_GetArgumentString(command_line_spec, "statistics");
+    /* 標準出力に書き出す場合は進捗表示と混ざらないようにする */
+    if (strcmp(statistics_file, "stdout") == 0) {
+      verpose_flag = 0;
+    }
+  }
+
+  if (CommandLineParser_GetOptionAcquired(command_line_spec, "test") == COMMAND_LINE_PARSER_TRUE) {
+    /* 完全性の検証 */
+    const uint8_t deep_flag
+      = (CommandLineParser_GetOptionAcquired(command_line_spec, "deep") == COMMAND_LINE_PARSER_TRUE) ? 1 : 0;
+    if (batch_files != NULL) {
+      int ret = do_batch(batch_files, num_files, num_threads, 0, 1, deep_flag, 0, 0, 1, verpose_flag);
+      free(batch_files);
+      if (ret != 0) {
+        return 1;
+      }
+    } else if (do_test(input_file, deep_flag, verpose_flag) != 0) {
+      fprintf(stderr, "%s: %s is broken. \n", argv[0], input_file);
+      return 1;
+    }
+  } else if (CommandLineParser_GetOptionAcquired(command_line_spec, "index") == COMMAND_LINE_PARSER_TRUE) {
+    /* ブロック索引作成 */
+    int ret = do_index(input_file, output_file, verpose_flag);
+    free(index_file);
+    if (ret != 0) {
+      fprintf(stderr, "%s: failed to index %s. \n", argv[0], input_file);
+      return 1;
+    }
+  } else if (CommandLineParser_GetOptionAcquired(command_line_spec, "decode") == COMMAND_LINE_PARSER_TRUE) {
     /* デコード */
     uint8_t enable_crc_check = 1;
     /* CRC有効フラグを取得 */
@@ -502,13 +1721,19 @@ int main(int argc, char** argv)
       enable_crc_check = (strcmp(crc_check_arg, "yes") == 0) ? 1 : 0;
     }
     /* 一括デコード実行 */
-    if (CommandLineParser_GetOptionAcquired(command_line_spec, "streaming") == COMMAND_LINE_PARSER_TRUE) {
-      if (do_streaming_decode(input_file, output_file, enable_crc_check, verpose_flag) != 0) {
+    if (batch_files != NULL) {
+      int ret = do_batch(batch_files, num_files, num_threads, 1, 0, 0, 0, 0, enable_crc_check, verpose_flag);
+      free(batch_files);
+      if (ret != 0) {
+        return 1;
+      }
+    } else if (CommandLineParser_GetOptionAcquired(command_line_spec, "streaming") == COMMAND_LINE_PARSER_TRUE) {
+      if (do_streaming_decode(input_file, output_file, enable_crc_check, verpose_flag, statistics_file) != 0) {
         fprintf(stderr, "%s: failed to streaming decode %s. \n", argv[0], input_file);
         return 1;
       }
     } else {
-      if (do_decode(input_file, output_file, enable_crc_check, verpose_flag) != 0) {
+      if (do_decode(input_file, output_file, enable_crc_check, verpose_flag, statistics_file) != 0) {
         fprintf(stderr, "%s: failed to decode %s. \n", argv[0], input_file);
         return 1;
       }
@@ -516,6 +1741,7 @@ int main(int argc, char** argv)
   } else if (CommandLineParser_GetOptionAcquired(command_line_spec, "encode") == COMMAND_LINE_PARSER_TRUE) {
     /* エンコード */
     uint32_t encode_preset_no = default_preset_no;
+    uint32_t max_num_block_samples = 0;
     /* エンコードプリセット番号取得 */
     if (CommandLineParser_GetOptionAcquired(command_line_spec, "mode") == COMMAND_LINE_PARSER_TRUE) {
       encode_preset_no = (uint32_t)strtol(CommandLineParser_GetArgumentString(command_line_spec, "mode"), NULL, 10);
@@ -524,12 +1750,28 @@ int main(int argc, char** argv)
         return 1;
       }
     }
+    /* ブロックあたり最大サンプル数取得 */
+    if (CommandLineParser_GetOptionAcquired(command_line_spec, "block-samples") == COMMAND_LINE_PARSER_TRUE) {
+      char* end;
+      long num_samples = strtol(CommandLineParser_GetArgumentString(command_line_spec, "block-samples"), &end, 10);
+      if ((*end != '\0') || (num_samples < (long)min_num_block_samples_limit) || (num_samples > (long)max_num_block_samples_limit)) {
+        fprintf(stderr, "%s: number of block samples is out of range. \n", argv[0]);
+        return 1;
+      }
+      max_num_block_samples = (uint32_t)num_samples;
+    }
     /* 一括エンコード実行 */
-    if (do_encode(input_file, output_file, encode_preset_no, verpose_flag) != 0) {
+    if (batch_files != NULL) {
+      int ret = do_batch(batch_files, num_files, num_threads, 0, 0, 0, encode_preset_no, max_num_block_samples, 0, verpose_flag);
+      free(batch_files);
+      if (ret != 0) {
+        return 1;
+      }
+    } else if (do_encode(input_file, output_file, encode_preset_no, max_num_block_samples, verpose_flag, statistics_file) != 0) {
       return 1;
     }
   } else {
-    fprintf(stderr, "%s: decode(-d) or encode(-e) option must be specified. \n", argv[0]);
+    fprintf(stderr, "%s: decode(-d), encode(-e), test(-t) or index(-x) option must be specified. \n", argv[0]);
     return 1;
   }
 
@@ -7,6 +7,16 @@
 
 /* パーサの読み込みバッファサイズ */
 #define WAVBITBUFFER_BUFFER_SIZE         (10 * 1024)
+/* PCMデータを一括で読み込む際のサンプル数（チャンネルあたり） */
+#define WAVPARSER_BULK_READ_NUM_SAMPLES  (16 * 1024)
+/* PCMデータを一括で書き出す際のサンプル数（チャンネルあたり） */
+#define WAVWRITER_BULK_WRITE_NUM_SAMPLES (16 * 1024)
+/* 1回のシークで進める最大バイト数 */
+#define WAVPARSER_MAX_SEEK_BYTES         (1UL << 30)
+/* RIFF形式で記録できる最大のPCMデータサイズ（RIFFサイズ=PCMデータサイズ+36が32bitに収まる） */
+#define WAV_RIFF_MAX_PCM_DATA_SIZE       (0xFFFFFFFFUL - 36)
+/* ds64チャンクのサイズ（チャンクヘッダ8byte + 各サイズ24byte + テーブル長4byte） */
+#define WAV_DS64_CHUNK_SIZE              36
 
 /* 下位n_bitsを取得 */
 /* 補足）((1 << n_bits) - 1)は下位の数値だけ取り出すマスクになる */
@@ -21,11 +31,26 @@ typedef enum WAVErrorTag {
   WAV_ERROR_INVALID_FORMAT      /* 不正なフォーマット */
 } WAVError;
 
+/* コンテナの種類 */
+typedef enum WAVContainerTag {
+  WAV_CONTAINER_RIFF = 0,       /* RIFF/WAVE */
+  WAV_CONTAINER_RF64,           /* RF64/BW64（ds64チャンクに64bitのサイズを記録） */
+  WAV_CONTAINER_W64             /* Sony Wave64（GUIDのチャンクIDと64bitのサイズ） */
+} WAVContainer;
+
+/* Wave64のGUIDのうち先頭4バイト（チャンクID）以降
+ * 補足）riff以外のGUIDは末尾12バイトが共通 */
+static const uint8_t wav_w64_riff_guid_tail[12]
+  = { 0x2E, 0x91, 0xCF, 0x11, 0xA5, 0xD6, 0x28, 0xDB, 0x04, 0xC1, 0x00, 0x00 };
+static const uint8_t wav_w64_chunk_guid_tail[12]
+  = { 0xF3, 0xAC, 0xD3, 0x11, 0x8C, 0xD1, 0x00, 0xC0, 0x4F, 0x8E, 0xDB, 0x8A };
+
 /* ビットバッファ */
 struct WAVBitBuffer {
   uint8_t   bytes[WAVBITBUFFER_BUFFER_SIZE];   /* ビットバッファ */
   uint32_t  bit_count;                        /* ビット入力カウント */
   int32_t   byte_pos;                         /* バイト列読み込み位置 */
+  int32_t   num_bytes;                        /* バッファに読み込んだバイト数 */
 };
 
 /* パーサ */
@@ -42,6 +67,24 @@ struct WAVWriter {
   struct WAVBitBuffer buffer;   /* ビットバッファ */
 };
 
+/* WAVストリーム読み込みハンドル */
+struct WAVStreamReader {
+  struct WAVParser      parser;             /* パーサ                         */
+  struct WAVFileFormat  format;             /* フォーマット                   */
+  uint64_t              num_read_samples;   /* 読み込み済みサンプル数         */
+  long                  data_offset;        /* PCMデータ先頭のファイル位置    */
+  uint8_t*              buffer;             /* インターリーブされたデータ領域 */
+};
+
+/* WAVストリーム書き出しハンドル */
+struct WAVStreamWriter {
+  struct WAVWriter      writer;             /* ライタ                         */
+  struct WAVFileFormat  format;             /* フォーマット                   */
+  uint64_t              num_write_samples;  /* 書き出し済みサンプル数         */
+  uint8_t               rf64;               /* RF64形式のヘッダで書き出したか */
+  uint8_t*              buffer;             /* インターリーブしたデータ領域   */
+};
+
 /* パーサの初期化 */
 static void WAVParser_Initialize(struct WAVParser* parser, FILE* fp);
 /* パーサの使用終了 */
@@ -50,6 +93,10 @@ static void WAVParser_Finalize(struct WAVParser* parser);
 static WAVError WAVParser_GetBits(struct WAVParser* parser, uint32_t n_bits, uint64_t* bitsbuf);
 /* シーク（fseek準拠） */
 static WAVError WAVParser_Seek(struct WAVParser* parser, int32_t offset, int32_t wherefrom);
+/* バイト列を取得し、取得できたバイト数を返す（バイト境界にいる時のみ使用可） */
+static uint32_t WAVParser_GetBytes(struct WAVParser* parser, uint8_t* buffer, uint32_t num_bytes);
+/* 読み飛ばし（シークできない入力では読み捨てる） */
+static WAVError WAVParser_Skip(struct WAVParser* parser, uint64_t num_bytes);
 /* ライタの初期化 */
 static void WAVWriter_Initialize(struct WAVWriter* writer, FILE* fp);
 /* ライタの終了 */
@@ -62,9 +109,13 @@ static WAVError WAVWriter_Flush(struct WAVWriter* writer);
 static WAVError WAVWriter_PutLittleEndianBytes(
     struct WAVWriter* writer, uint32_t nbytes, uint64_t data);
 
+/* RF64形式のヘッダが必要か */
+static uint8_t WAV_IsRF64Required(const struct WAVFileFormat* format);
+/* ライタを使用して文字列出力 */
+static WAVError WAVWriter_PutString(struct WAVWriter* writer, const char* string);
 /* ライタを使用してファイルフォーマットに従ったヘッダ部を出力 */
 static WAVError WAVWriter_PutWAVHeader(
-    struct WAVWriter* writer, const struct WAVFileFormat* format);
+    struct WAVWriter* writer, const struct WAVFileFormat* format, uint8_t rf64);
 /* ライタを使用してPCMデータ出力 */
 static WAVError WAVWriter_PutWAVPcmData(
     struct WAVWriter* writer, const struct WAVFile* wavfile);
@@ -78,6 +129,14 @@ static WAVError WAVParser_GetString(
 /* パーサを使用して文字列取得/一致チェック */
 static WAVError WAVParser_CheckSignatureString(
   struct WAVParser* parser, const char* signature, uint32_t signature_length);
+/* パーサを使用してWave64のGUIDの残り12バイトの一致チェック */
+static WAVError WAVParser_CheckGUIDTail(
+  struct WAVParser* parser, const uint8_t* guid_tail);
+/* パーサを使用してチャンクIDとチャンクのデータサイズを取得 */
+static WAVError WAVParser_GetChunkHeader(
+    struct WAVParser* parser, WAVContainer container, char* chunk_id, uint64_t* chunk_size);
+/* パディングを含めたチャンクのデータサイズ */
+static uint64_t WAV_GetPaddedChunkSize(WAVContainer container, uint64_t chunk_size);
 /* パーサを使用してファイルフォーマットを読み取り */
 static WAVError WAVParser_GetWAVFormat(
     struct WAVParser* parser, struct WAVFileFormat* format);
@@ -85,6 +144,13 @@ static WAVError WAVParser_GetWAVFormat(
 static WAVError WAVParser_GetWAVPcmData(
     struct WAVParser* parser, struct WAVFile* wavfile);
 
+/* インターリーブされたPCMデータをチャンネル毎の32bit整数形式に変換 */
+static void WAV_DeinterleavePcmData(const struct WAVFileFormat* format,
+    const uint8_t* src, WAVPcmData** data, uint64_t offset, uint32_t num_samples);
+/* チャンネル毎の32bit整数形式のPCMデータをインターリーブしてファイル形式に変換 */
+static void WAV_InterleavePcmData(const struct WAVFileFormat* format,
+    const WAVPcmData* const* data, uint64_t offset, uint32_t num_samples, uint8_t* dst);
+
 /* 8bitPCM形式を32bit形式に変換 */
 static int32_t WAV_Convert8bitPCMto32bitPCM(int32_t in_8bitpcm);
 /* 16bitPCM形式を32bit形式に変換 */
@@ -97,106 +163,159 @@ static int32_t WAV_Convert32bitPCMto32bitPCM(int32_t in_32bitpcm);
 /* 32bitPCM形式を8bit形式に変換（注意：返り値は32bit整数だが、8bit範囲でクリップされている） */
 static int32_t WAV_Convert32bitPCMto8bitPCM(int32_t in_32bitpcm);
 /* 32bitPCM形式を16bit形式に変換（注意：返り値は32bit整数だが、16bit範囲でクリップされている） */
-static int32_t WAV_Convert32bitPCMto8bitPCM(int32_t in_32bitpcm);
-/* 32bitPCM形式を24bit形式に変換（注意：返り値は32bit整数だが、24bit範囲でクリップされている） */
 static int32_t WAV_Convert32bitPCMto16bitPCM(int32_t in_32bitpcm);
+/* 32bitPCM形式を24bit形式に変換（注意：返り値は32bit整数だが、24bit範囲でクリップされている） */
+static int32_t WAV_Convert32bitPCMto24bitPCM(int32_t in_32bitpcm);
 /* 32bitPCM形式を32bit形式に変換 */
 static int32_t WAV_Convert32bitPCMto32bitPCM(int32_t in_32bitpcm);
 
 /* パーサを使用してファイルフォーマットを読み取り */
+/* 補足）RIFF/WAVEの他、RF64（BW64）とSony Wave64のコンテナに対応する */
 static WAVError WAVParser_GetWAVFormat(
     struct WAVParser* parser, struct WAVFileFormat* format)
 {
-  uint64_t  bitsbuf;
-  int32_t   fmt_chunk_size;
+  uint64_t      bitsbuf, chunk_size, data_size, ds64_data_size;
+  uint32_t      block_align;
+  char          string_buf[4];
+  uint8_t       fmt_found, is_extensible;
+  WAVContainer  container;
   struct WAVFileFormat tmp_format;
 
   /* 引数チェック */
   if (parser == NULL || format == NULL) {
     return WAV_ERROR_INVALID_PARAMETER;
   }
-  
-  /* ヘッダ 'R', 'I', 'F', 'F' をチェック */
-  if (WAVParser_CheckSignatureString(parser, "RIFF", 4) != WAV_ERROR_OK) {
-    return WAV_ERROR_INVALID_FORMAT;
-  }
-
-  /* ファイルサイズ-8（読み飛ばし） */
-  if (WAVParser_GetLittleEndianBytes(parser, 4, &bitsbuf) != WAV_ERROR_OK) { return WAV_ERROR_IO; }
-
-  /* ヘッダ 'W', 'A', 'V', 'E' をチェック */
-  if (WAVParser_CheckSignatureString(parser, "WAVE", 4) != WAV_ERROR_OK) {
-    return WAV_ERROR_INVALID_FORMAT;
-  }
 
-  /* fmtチャンクのヘッダ 'f', 'm', 't', ' ' をチェック */
-  if (WAVParser_CheckSignatureString(parser, "fmt ", 4) != WAV_ERROR_OK) {
+  /* コンテナの判定 */
+  if (WAVParser_GetString(parser, string_buf, 4) != WAV_ERROR_OK) { return WAV_ERROR_IO; }
+  if (strncmp(string_buf, "RIFF", 4) == 0) {
+    container = WAV_CONTAINER_RIFF;
+  } else if ((strncmp(string_buf, "RF64", 4) == 0) || (strncmp(string_buf, "BW64", 4) == 0)) {
+    container = WAV_CONTAINER_RF64;
+  } else if (strncmp(string_buf, "riff", 4) == 0) {
+    container = WAV_CONTAINER_W64;
+    /* riffのGUIDの残り */
+    if (WAVParser_CheckGUIDTail(parser, wav_w64_riff_guid_tail) != WAV_ERROR_OK) {
+      return WAV_ERROR_INVALID_FORMAT;
+    }
+  } else {
     return WAV_ERROR_INVALID_FORMAT;
   }
 
-  /* fmtチャンクのバイト数を取得
-   * 補足/注意）16より大きいサイズのfmtチャンクの内容（拡張）は読み飛ばす */
-  if (WAVParser_GetLittleEndianBytes(parser, 4, &bitsbuf) != WAV_ERROR_OK) { return WAV_ERROR_IO; }
-  fmt_chunk_size = (int32_t)bitsbuf;
+  /* ファイルサイズ（読み飛ばし） */
+  if (WAVParser_GetLittleEndianBytes(parser,
+        (container == WAV_CONTAINER_W64) ? 8 : 4, &bitsbuf) != WAV_ERROR_OK) { return WAV_ERROR_IO; }
 
-  /* フォーマットIDをチェック
-   * 補足）1（リニアPCM）以外対応していない */
-  if (WAVParser_GetLittleEndianBytes(parser, 2, &bitsbuf) != WAV_ERROR_OK) { return WAV_ERROR_IO; }
-  if (bitsbuf != 1) {
-    /* fprintf(stderr, "Unsupported format: fmt chunk format ID \n"); */
+  /* ヘッダ 'W', 'A', 'V', 'E' をチェック */
+  if (container == WAV_CONTAINER_W64) {
+    if ((WAVParser_CheckSignatureString(parser, "wave", 4) != WAV_ERROR_OK)
+        || (WAVParser_CheckGUIDTail(parser, wav_w64_chunk_guid_tail) != WAV_ERROR_OK)) {
+      return WAV_ERROR_INVALID_FORMAT;
+    }
+  } else if (WAVParser_CheckSignatureString(parser, "WAVE", 4) != WAV_ERROR_OK) {
     return WAV_ERROR_INVALID_FORMAT;
   }
-  tmp_format.data_format = WAV_DATA_FORMAT_PCM;
-
-  /* チャンネル数 */
-  if (WAVParser_GetLittleEndianBytes(parser, 2, &bitsbuf) != WAV_ERROR_OK) { return WAV_ERROR_IO; }
-  tmp_format.num_channels = (uint32_t)bitsbuf;
 
-  /* サンプリングレート */
-  if (WAVParser_GetLittleEndianBytes(parser, 4, &bitsbuf) != WAV_ERROR_OK) { return WAV_ERROR_IO; }
-  tmp_format.sampling_rate =(uint32_t) bitsbuf;
-
-  /* データ速度（byte/sec）は読み飛ばし */
-  if (WAVParser_GetLittleEndianBytes(parser, 4, &bitsbuf) != WAV_ERROR_OK) { return WAV_ERROR_IO; }
-
-  /* ブロックあたりサイズ数は読み飛ばし */
-  if (WAVParser_GetLittleEndianBytes(parser, 2, &bitsbuf) != WAV_ERROR_OK) { return WAV_ERROR_IO; }
-
-  /* 量子化ビット数（サンプルあたりのビット数） */
-  if (WAVParser_GetLittleEndianBytes(parser, 2, &bitsbuf) != WAV_ERROR_OK) { return WAV_ERROR_IO; }
-  tmp_format.bits_per_sample = (uint32_t)bitsbuf;
-
-  /* 拡張部分の読み取りには未対応: 読み飛ばしを行う */
-  if (fmt_chunk_size > 16) {
-    fprintf(stderr, "Warning: skip fmt chunk extention (unsupported). \n");
-    if (WAVParser_Seek(parser, fmt_chunk_size - 16, SEEK_CUR) != WAV_ERROR_OK) { return WAV_ERROR_IO; }
-  }
-  
   /* チャンク読み取り */
+  fmt_found = 0;
+  is_extensible = 0;
+  ds64_data_size = 0;
   while (1) {
-    char string_buf[4];
-    /* チャンク文字列取得 */
-    if (WAVParser_GetString(parser, string_buf, 4) != WAV_ERROR_OK) {
-      return WAV_ERROR_IO;
+    WAVError err;
+    if ((err = WAVParser_GetChunkHeader(parser, container, string_buf, &chunk_size)) != WAV_ERROR_OK) {
+      return err;
     }
-    if (strncmp(string_buf, "data", 4) == 0) {
+    if ((container == WAV_CONTAINER_RF64) && (strncmp(string_buf, "ds64", 4) == 0)) {
+      /* ds64チャンク: 32bitに収まらないサイズ */
+      if (chunk_size < 24) {
+        return WAV_ERROR_INVALID_FORMAT;
+      }
+      /* RIFFサイズは読み飛ばし */
+      if (WAVParser_GetLittleEndianBytes(parser, 8, &bitsbuf) != WAV_ERROR_OK) { return WAV_ERROR_IO; }
+      /* dataチャンクのサイズ */
+      if (WAVParser_GetLittleEndianBytes(parser, 8, &ds64_data_size) != WAV_ERROR_OK) { return WAV_ERROR_IO; }
+      /* サンプル数はdataチャンクのサイズから求めるので読み飛ばし、テーブルも読み飛ばす */
+      if (WAVParser_Skip(parser, WAV_GetPaddedChunkSize(container, chunk_size) - 16) != WAV_ERROR_OK) { return WAV_ERROR_IO; }
+    } else if (strncmp(string_buf, "fmt ", 4) == 0) {
+      /* fmtチャンク
+       * 補足/注意）16より大きいサイズのfmtチャンクの内容（拡張）は読み飛ばす */
+      if (chunk_size < 16) {
+        return WAV_ERROR_INVALID_FORMAT;
+      }
+
+      /* フォーマットIDをチェック
+       * 補足）1（リニアPCM）と、サブフォーマットがリニアPCMの0xFFFE（WAVE_FORMAT_EXTENSIBLE）以外対応していない */
+      if (WAVParser_GetLittleEndianBytes(parser, 2, &bitsbuf) != WAV_ERROR_OK) { return WAV_ERROR_IO; }
+      if ((bitsbuf == 0xFFFE) && (chunk_size >= 40)) {
+        is_extensible = 1;
+      } else if (bitsbuf != 1) {
+        /* fprintf(stderr, "Unsupported format: fmt chunk format ID \n"); */
+        return WAV_ERROR_INVALID_FORMAT;
+      }
+      tmp_format.data_format = WAV_DATA_FORMAT_PCM;
+
+      /* チャンネル数 */
+      if (WAVParser_GetLittleEndianBytes(parser, 2, &bitsbuf) != WAV_ERROR_OK) { return WAV_ERROR_IO; }
+      tmp_format.num_channels = (uint32_t)bitsbuf;
+
+      /* サンプリングレート */
+      if (WAVParser_GetLittleEndianBytes(parser, 4, &bitsbuf) != WAV_ERROR_OK) { return WAV_ERROR_IO; }
+      tmp_format.sampling_rate =(uint32_t) bitsbuf;
+
+      /* データ速度（byte/sec）は読み飛ばし */
+      if (WAVParser_GetLittleEndianBytes(parser, 4, &bitsbuf) != WAV_ERROR_OK) { return WAV_ERROR_IO; }
+
+      /* ブロックあたりサイズ数は読み飛ばし */
+      if (WAVParser_GetLittleEndianBytes(parser, 2, &bitsbuf) != WAV_ERROR_OK) { return WAV_ERROR_IO; }
+
+      /* 量子化ビット数（サンプルあたりのビット数） */
+      if (WAVParser_GetLittleEndianBytes(parser, 2, &bitsbuf) != WAV_ERROR_OK) { return WAV_ERROR_IO; }
+      tmp_format.bits_per_sample = (uint32_t)bitsbuf;
+
+      if (is_extensible) {
+        /* 拡張サイズ・有効ビット数・チャンネルマスクは読み飛ばし、サブフォーマットGUIDの先頭（フォーマットID）だけ見る */
+        if (WAVParser_Skip(parser, 8) != WAV_ERROR_OK) { return WAV_ERROR_IO; }
+        if (WAVParser_GetLittleEndianBytes(parser, 2, &bitsbuf) != WAV_ERROR_OK) { return WAV_ERROR_IO; }
+        if (bitsbuf != 1) {
+          return WAV_ERROR_INVALID_FORMAT;
+        }
+        if (WAVParser_Skip(parser, WAV_GetPaddedChunkSize(container, chunk_size) - 26) != WAV_ERROR_OK) { return WAV_ERROR_IO; }
+      } else {
+        /* 拡張部分の読み取りには未対応: 読み飛ばしを行う */
+        if (chunk_size > 16) {
+          fprintf(stderr, "Warning: skip fmt chunk extention (unsupported). \n");
+        }
+        if (WAVParser_Skip(parser, WAV_GetPaddedChunkSize(container, chunk_size) - 16) != WAV_ERROR_OK) { return WAV_ERROR_IO; }
+      }
+      fmt_found = 1;
+    } else if (strncmp(string_buf, "data", 4) == 0) {
       /* データチャンクを見つけたら終わり */
       break;
     } else {
-      /* 他のチャンクはサイズだけ取得してシークにより読み飛ばす */
-      if (WAVParser_GetLittleEndianBytes(parser, 4, &bitsbuf) != WAV_ERROR_OK) {
+      /* 他のチャンクはシークにより読み飛ばす */
+      /* printf("chunk:%.4s size:%lu \n", string_buf, (unsigned long)chunk_size); */
+      if (WAVParser_Skip(parser, WAV_GetPaddedChunkSize(container, chunk_size)) != WAV_ERROR_OK) {
         return WAV_ERROR_IO;
       }
-      /* printf("chunk:%s size:%d \n", string_buf, (int32_t)bitsbuf); */
-      WAVParser_Seek(parser, (int32_t)bitsbuf, SEEK_CUR);
     }
   }
 
+  /* fmtチャンクはdataチャンクより前に必要 */
+  if (fmt_found == 0) {
+    return WAV_ERROR_INVALID_FORMAT;
+  }
+  block_align = (tmp_format.bits_per_sample / 8) * tmp_format.num_channels;
+  if (block_align == 0) {
+    return WAV_ERROR_INVALID_FORMAT;
+  }
+
   /* サンプル数: 波形データバイト数から算出 */
-  if (WAVParser_GetLittleEndianBytes(parser, 4, &bitsbuf) != WAV_ERROR_OK) { return WAV_ERROR_IO; }
-  tmp_format.num_samples = (uint32_t)bitsbuf;
-  assert(tmp_format.num_samples % ((tmp_format.bits_per_sample / 8) * tmp_format.num_channels) == 0);
-  tmp_format.num_samples /= ((tmp_format.bits_per_sample / 8) * tmp_format.num_channels);
+  /* 補足）RF64ではdataチャンクのサイズが0xFFFFFFFFならばds64チャンクの値を使う */
+  data_size = chunk_size;
+  if ((container == WAV_CONTAINER_RF64) && (chunk_size == 0xFFFFFFFFUL)) {
+    data_size = ds64_data_size;
+  }
+  tmp_format.num_samples = data_size / block_align;
 
   /* 構造体コピー */
   *format = tmp_format;
@@ -205,50 +324,96 @@ static WAVError WAVParser_GetWAVFormat(
 }
 
 /* パーサを使用してPCMデータを読み取り */
+/* 補足）データチャンクはビットバッファを通さず一括で読み込み、チャンネル毎の配列に振り分ける */
 static WAVError WAVParser_GetWAVPcmData(
     struct WAVParser* parser, struct WAVFile* wavfile)
 {
-  uint32_t  ch, sample, bytes_per_sample;
-  uint64_t  bitsbuf;
-  int32_t   (*convert_to_sint32_func)(int32_t);
+  uint64_t  progress;
+  uint32_t  num_read_samples, block_align;
+  uint8_t*  read_buffer;
+  WAVError  err;
 
   /* 引数チェック */
   if (parser == NULL || wavfile == NULL) {
     return WAV_ERROR_INVALID_PARAMETER;
   }
 
-  /* ビット深度に合わせてPCMデータの変換関数を決定 */
+  /* 対応しているビット深度か */
   switch (wavfile->format.bits_per_sample) {
-    case 8:
-      convert_to_sint32_func = WAV_Convert8bitPCMto32bitPCM;
-      break;
-    case 16:
-      convert_to_sint32_func = WAV_Convert16bitPCMto32bitPCM;
-      break;
-    case 24:
-      convert_to_sint32_func = WAV_Convert24bitPCMto32bitPCM;
-      break;
-    case 32:
-      convert_to_sint32_func = WAV_Convert32bitPCMto32bitPCM;
+    case 8: case 16: case 24: case 32:
       break;
     default:
       /* fprintf(stderr, "Unsupported bits per sample format(=%d). \n", wavfile->format.bits_per_sample); */
       return WAV_ERROR_INVALID_FORMAT;
   }
 
+  block_align = (wavfile->format.bits_per_sample / 8) * wavfile->format.num_channels;
+  if ((read_buffer = (uint8_t *)malloc(block_align * WAVPARSER_BULK_READ_NUM_SAMPLES)) == NULL) {
+    return WAV_ERROR_NG;
+  }
+
   /* データ読み取り */
-  bytes_per_sample = wavfile->format.bits_per_sample / 8;
-  for (sample = 0; sample < wavfile->format.num_samples; sample++) {
-    for (ch = 0; ch < wavfile->format.num_channels; ch++) {
-      if (WAVParser_GetLittleEndianBytes(parser, bytes_per_sample, &bitsbuf) != WAV_ERROR_OK) {
-        return WAV_ERROR_IO;
-      }
-      /* 32bit整数形式に変形してデータにセット */
-      wavfile->data[ch][sample] = convert_to_sint32_func((int32_t)(bitsbuf));
+  err = WAV_ERROR_OK;
+  for (progress = 0; progress < wavfile->format.num_samples; progress += num_read_samples) {
+    num_read_samples = WAVPARSER_BULK_READ_NUM_SAMPLES;
+    if (num_read_samples > (wavfile->format.num_samples - progress)) {
+      num_read_samples = (uint32_t)(wavfile->format.num_samples - progress);
+    }
+    if (WAVParser_GetBytes(parser, read_buffer, block_align * num_read_samples) != block_align * num_read_samples) {
+      err = WAV_ERROR_IO;
+      break;
     }
+    /* インターリーブを解いて32bit整数形式に変形 */
+    WAV_DeinterleavePcmData(&wavfile->format, read_buffer, wavfile->data, progress, num_read_samples);
   }
 
-  return WAV_ERROR_OK;
+  free(read_buffer);
+  return err;
+}
+
+/* インターリーブされたPCMデータをチャンネル毎の32bit整数形式に変換 */
+/* 補足）ビット深度毎のループで変換関数を直接呼ぶので、ループ内で展開される */
+static void WAV_DeinterleavePcmData(const struct WAVFileFormat* format,
+    const uint8_t* src, WAVPcmData** data, uint64_t offset, uint32_t num_samples)
+{
+  uint32_t ch, smpl;
+  const uint32_t bytes_per_sample = format->bits_per_sample / 8;
+  const uint32_t block_align = bytes_per_sample * format->num_channels;
+
+  for (ch = 0; ch < format->num_channels; ch++) {
+    const uint8_t* psrc = &src[ch * bytes_per_sample];
+    WAVPcmData* dst = &data[ch][offset];
+    switch (bytes_per_sample) {
+      case 1:
+        for (smpl = 0; smpl < num_samples; smpl++) {
+          dst[smpl] = WAV_Convert8bitPCMto32bitPCM((int32_t)psrc[0]);
+          psrc += block_align;
+        }
+        break;
+      case 2:
+        for (smpl = 0; smpl < num_samples; smpl++) {
+          dst[smpl] = WAV_Convert16bitPCMto32bitPCM((int32_t)((uint32_t)psrc[0] | ((uint32_t)psrc[1] << 8)));
+          psrc += block_align;
+        }
+        break;
+      case 3:
+        for (smpl = 0; smpl < num_samples; smpl++) {
+          dst[smpl] = WAV_Convert24bitPCMto32bitPCM(
+              (int32_t)((uint32_t)psrc[0] | ((uint32_t)psrc[1] << 8) | ((uint32_t)psrc[2] << 16)));
+          psrc += block_align;
+        }
+        break;
+      case 4:
+        for (smpl = 0; smpl < num_samples; smpl++) {
+          dst[smpl] = WAV_Convert32bitPCMto32bitPCM(
+              (int32_t)((uint32_t)psrc[0] | ((uint32_t)psrc[1] << 8) | ((uint32_t)psrc[2] << 16) | ((uint32_t)psrc[3] << 24)));
+          psrc += block_align;
+        }
+        break;
+      default:
+        assert(0);
+    }
+  }
 }
 
 /* ファイルからWAVファイルフォーマットだけ読み取り */
@@ -464,7 +629,7 @@ static WAVError WAVParser_GetBits(struct WAVParser* parser, uint32_t n_bits, uin
 
   /* 初回読み込み */
   if (buf->byte_pos == -1) {
-      if (fread(buf->bytes, sizeof(uint8_t), WAVBITBUFFER_BUFFER_SIZE, parser->fp) == 0) {
+      if ((buf->num_bytes = (int32_t)fread(buf->bytes, sizeof(uint8_t), WAVBITBUFFER_BUFFER_SIZE, parser->fp)) == 0) {
         return WAV_ERROR_IO;
       }
       buf->byte_pos   = 0;
@@ -486,7 +651,7 @@ static WAVError WAVParser_GetBits(struct WAVParser* parser, uint32_t n_bits, uin
 
     /* バッファが一杯ならば、再度読み込み */
     if (buf->byte_pos == WAVBITBUFFER_BUFFER_SIZE) {
-      if (fread(buf->bytes, sizeof(uint8_t), WAVBITBUFFER_BUFFER_SIZE, parser->fp) == 0) {
+      if ((buf->num_bytes = (int32_t)fread(buf->bytes, sizeof(uint8_t), WAVBITBUFFER_BUFFER_SIZE, parser->fp)) == 0) {
         return WAV_ERROR_IO;
       }
       buf->byte_pos = 0;
@@ -502,21 +667,93 @@ static WAVError WAVParser_GetBits(struct WAVParser* parser, uint32_t n_bits, uin
   return WAV_ERROR_OK;
 }
 
+/* ビットバッファに先読みしていて未読のバイト数 */
+static uint32_t WAVParser_GetNumBufferedBytes(const struct WAVParser* parser)
+{
+  const struct WAVBitBuffer *buf = &(parser->buffer);
+
+  if (buf->byte_pos == -1) {
+    return 0;
+  }
+
+  /* 補足）bit_countが0ならばbyte_posのバイトは読み終えている
+   *       ファイル末尾ではバッファサイズより少なく読み込んでいる */
+  assert((buf->bit_count == 0) || (buf->bit_count == 8));
+  return (uint32_t)(buf->num_bytes - buf->byte_pos) - ((buf->bit_count == 0) ? 1 : 0);
+}
+
 /* シーク（fseek準拠） */
+/* 補足）シークに失敗した場合はパーサの状態を変えない */
 static WAVError WAVParser_Seek(struct WAVParser* parser, int32_t offset, int32_t wherefrom)
 {
-  if (parser->buffer.byte_pos != -1) {
+  if (wherefrom == SEEK_CUR) {
     /* バッファに取り込んだ分先読みしているので戻す */
-    offset -= (WAVBITBUFFER_BUFFER_SIZE - (parser->buffer.byte_pos + 1));
+    offset -= (int32_t)WAVParser_GetNumBufferedBytes(parser);
   }
   /* 移動 */
-  fseek(parser->fp, offset, wherefrom);
+  if (fseek(parser->fp, offset, wherefrom) != 0) {
+    return WAV_ERROR_IO;
+  }
   /* バッファをクリア */
   parser->buffer.byte_pos = -1;
 
   return WAV_ERROR_OK;
 }
 
+/* バイト列を取得し、取得できたバイト数を返す（バイト境界にいる時のみ使用可） */
+/* 補足）ビットバッファに先読みした分から取り出し、残りはファイルから直接読み込む */
+static uint32_t WAVParser_GetBytes(struct WAVParser* parser, uint8_t* buffer, uint32_t num_bytes)
+{
+  uint32_t num_buffered, num_copy;
+  struct WAVBitBuffer *buf = &(parser->buffer);
+
+  num_buffered = WAVParser_GetNumBufferedBytes(parser);
+  num_copy = (num_bytes < num_buffered) ? num_bytes : num_buffered;
+
+  if (num_copy > 0) {
+    const int32_t start = buf->byte_pos + ((buf->bit_count == 0) ? 1 : 0);
+    memcpy(buffer, &buf->bytes[start], num_copy);
+    /* 最後に取り出したバイトを読み終えた状態にする */
+    buf->byte_pos   = start + (int32_t)num_copy - 1;
+    buf->bit_count  = 0;
+  }
+
+  /* 残りはファイルから直接読む */
+  if (num_copy < num_bytes) {
+    /* バッファは空になったので次回は読み直させる */
+    buf->byte_pos = -1;
+    num_copy += (uint32_t)fread(&buffer[num_copy], sizeof(uint8_t), num_bytes - num_copy, parser->fp);
+  }
+
+  return num_copy;
+}
+
+/* 読み飛ばし（シークできない入力では読み捨てる） */
+static WAVError WAVParser_Skip(struct WAVParser* parser, uint64_t num_bytes)
+{
+  uint8_t discard[256];
+
+  /* int32_tに収まる単位でシーク */
+  while (num_bytes > 0) {
+    const uint32_t num_seek = (num_bytes < WAVPARSER_MAX_SEEK_BYTES) ? (uint32_t)num_bytes : WAVPARSER_MAX_SEEK_BYTES;
+    if (WAVParser_Seek(parser, (int32_t)num_seek, SEEK_CUR) != WAV_ERROR_OK) {
+      break;
+    }
+    num_bytes -= num_seek;
+  }
+
+  /* パイプ等のシークできない入力 */
+  while (num_bytes > 0) {
+    const uint32_t num_read = (num_bytes < sizeof(discard)) ? (uint32_t)num_bytes : (uint32_t)sizeof(discard);
+    if (WAVParser_GetBytes(parser, discard, num_read) != num_read) {
+      return WAV_ERROR_IO;
+    }
+    num_bytes -= num_read;
+  }
+
+  return WAV_ERROR_OK;
+}
+
 /* WAVファイルハンドルを破棄 */
 void WAV_Destroy(struct WAVFile* wavfile)
 {
@@ -541,11 +778,33 @@ void WAV_Destroy(struct WAVFile* wavfile)
 #undef NULLCHECK_AND_FREE
 }
 
+/* RF64形式のヘッダが必要か */
+static uint8_t WAV_IsRF64Required(const struct WAVFileFormat* format)
+{
+  const uint32_t block_align = (format->bits_per_sample / 8) * format->num_channels;
+
+  if (block_align == 0) {
+    return 0;
+  }
+  return (format->num_samples > (WAV_RIFF_MAX_PCM_DATA_SIZE / block_align)) ? 1 : 0;
+}
+
+/* ライタを使用して文字列出力 */
+static WAVError WAVWriter_PutString(struct WAVWriter* writer, const char* string)
+{
+  while (*string != '\0') {
+    if (WAVWriter_PutBits(writer, (uint8_t)*string, 8) != WAV_ERROR_OK) { return WAV_ERROR_IO; }
+    string++;
+  }
+  return WAV_ERROR_OK;
+}
+
 /* ライタを使用してファイルフォーマットに従ったヘッダ部を出力 */
+/* 補足）RF64形式ではサイズを0xFFFFFFFFとし、実際の値はds64チャンクに記録する */
 static WAVError WAVWriter_PutWAVHeader(
-    struct WAVWriter* writer, const struct WAVFileFormat* format)
+    struct WAVWriter* writer, const struct WAVFileFormat* format, uint8_t rf64)
 {
-  uint32_t filesize, pcm_data_size;
+  uint64_t filesize, pcm_data_size;
 
   /* 引数チェック */
   if (writer == NULL || format == NULL) {
@@ -558,6 +817,11 @@ static WAVError WAVWriter_PutWAVHeader(
     return WAV_ERROR_INVALID_FORMAT;
   }
 
+  /* 32bitのサイズに収まらなければRF64形式が必要 */
+  if ((rf64 == 0) && (WAV_IsRF64Required(format) != 0)) {
+    return WAV_ERROR_INVALID_FORMAT;
+  }
+
   /* PCM データサイズ */
   pcm_data_size 
     = format->num_samples * (format->bits_per_sample / 8) * format->num_channels;
@@ -567,27 +831,31 @@ static WAVError WAVWriter_PutWAVHeader(
     = pcm_data_size
     + 44; /* "RIFF" から ("data"のサイズ) までのフィールドのバイト数
              拡張部分を一切含まない */
+  if (rf64 != 0) {
+    filesize += WAV_DS64_CHUNK_SIZE;
+  }
   
   /* ヘッダ 'R', 'I', 'F', 'F' を出力 */
-  if (WAVWriter_PutBits(writer, 'R', 8) != WAV_ERROR_OK) { return WAV_ERROR_IO; };
-  if (WAVWriter_PutBits(writer, 'I', 8) != WAV_ERROR_OK) { return WAV_ERROR_IO; };
-  if (WAVWriter_PutBits(writer, 'F', 8) != WAV_ERROR_OK) { return WAV_ERROR_IO; };
-  if (WAVWriter_PutBits(writer, 'F', 8) != WAV_ERROR_OK) { return WAV_ERROR_IO; };
+  if (WAVWriter_PutString(writer, (rf64 != 0) ? "RF64" : "RIFF") != WAV_ERROR_OK) { return WAV_ERROR_IO; }
 
   /* ファイルサイズ-8（この要素以降のサイズ） */
-  if (WAVWriter_PutLittleEndianBytes(writer, 4, filesize - 8) != WAV_ERROR_OK) { return WAV_ERROR_IO; }
+  if (WAVWriter_PutLittleEndianBytes(writer, 4, (rf64 != 0) ? 0xFFFFFFFFUL : (filesize - 8)) != WAV_ERROR_OK) { return WAV_ERROR_IO; }
 
   /* ヘッダ 'W', 'A', 'V', 'E' を出力 */
-  if (WAVWriter_PutBits(writer, 'W', 8) != WAV_ERROR_OK) { return WAV_ERROR_IO; };
-  if (WAVWriter_PutBits(writer, 'A', 8) != WAV_ERROR_OK) { return WAV_ERROR_IO; };
-  if (WAVWriter_PutBits(writer, 'V', 8) != WAV_ERROR_OK) { return WAV_ERROR_IO; };
-  if (WAVWriter_PutBits(writer, 'E', 8) != WAV_ERROR_OK) { return WAV_ERROR_IO; };
+  if (WAVWriter_PutString(writer, "WAVE") != WAV_ERROR_OK) { return WAV_ERROR_IO; }
+
+  /* ds64チャンク: RIFFサイズ, dataサイズ, サンプル数, テーブル長（0） */
+  if (rf64 != 0) {
+    if (WAVWriter_PutString(writer, "ds64") != WAV_ERROR_OK) { return WAV_ERROR_IO; }
+    if (WAVWriter_PutLittleEndianBytes(writer, 4, WAV_DS64_CHUNK_SIZE - 8) != WAV_ERROR_OK) { return WAV_ERROR_IO; }
+    if (WAVWriter_PutLittleEndianBytes(writer, 8, filesize - 8) != WAV_ERROR_OK) { return WAV_ERROR_IO; }
+    if (WAVWriter_PutLittleEndianBytes(writer, 8, pcm_data_size) != WAV_ERROR_OK) { return WAV_ERROR_IO; }
+    if (WAVWriter_PutLittleEndianBytes(writer, 8, format->num_samples) != WAV_ERROR_OK) { return WAV_ERROR_IO; }
+    if (WAVWriter_PutLittleEndianBytes(writer, 4, 0) != WAV_ERROR_OK) { return WAV_ERROR_IO; }
+  }
 
   /* fmtチャンクのヘッダ 'f', 'm', 't', ' ' を出力 */
-  if (WAVWriter_PutBits(writer, 'f', 8) != WAV_ERROR_OK) { return WAV_ERROR_IO; };
-  if (WAVWriter_PutBits(writer, 'm', 8) != WAV_ERROR_OK) { return WAV_ERROR_IO; };
-  if (WAVWriter_PutBits(writer, 't', 8) != WAV_ERROR_OK) { return WAV_ERROR_IO; };
-  if (WAVWriter_PutBits(writer, ' ', 8) != WAV_ERROR_OK) { return WAV_ERROR_IO; };
+  if (WAVWriter_PutString(writer, "fmt ") != WAV_ERROR_OK) { return WAV_ERROR_IO; }
 
   /* fmtチャンクのバイト数を出力 （補足）現在は16byte決め打ち */
   if (WAVWriter_PutLittleEndianBytes(writer, 4, 16) != WAV_ERROR_OK) { return WAV_ERROR_IO; };
@@ -615,56 +883,112 @@ static WAVError WAVWriter_PutWAVHeader(
   if (WAVWriter_PutLittleEndianBytes(writer, 2, format->bits_per_sample) != WAV_ERROR_OK) { return WAV_ERROR_IO; };
 
   /* "data" チャンクのヘッダ出力 */
-  if (WAVWriter_PutBits(writer, 'd', 8) != WAV_ERROR_OK) { return WAV_ERROR_IO; };
-  if (WAVWriter_PutBits(writer, 'a', 8) != WAV_ERROR_OK) { return WAV_ERROR_IO; };
-  if (WAVWriter_PutBits(writer, 't', 8) != WAV_ERROR_OK) { return WAV_ERROR_IO; };
-  if (WAVWriter_PutBits(writer, 'a', 8) != WAV_ERROR_OK) { return WAV_ERROR_IO; };
+  if (WAVWriter_PutString(writer, "data") != WAV_ERROR_OK) { return WAV_ERROR_IO; }
 
   /* 波形データバイト数 */
-  if (WAVWriter_PutLittleEndianBytes(writer, 4, pcm_data_size) != WAV_ERROR_OK) { return WAV_ERROR_IO; }
+  if (WAVWriter_PutLittleEndianBytes(writer, 4, (rf64 != 0) ? 0xFFFFFFFFUL : pcm_data_size) != WAV_ERROR_OK) { return WAV_ERROR_IO; }
 
   return WAV_ERROR_OK;
 }
 
 /* ライタを使用してPCMデータ出力 */
+/* 補足）データチャンクはビットバッファを通さず、インターリーブしたものを一括で書き出す */
 static WAVError WAVWriter_PutWAVPcmData(
     struct WAVWriter* writer, const struct WAVFile* wavfile)
 {
-  uint32_t  ch, sample, bytes_per_sample;
-  int32_t   (*convert_sint32_to_pcmdata_func)(int32_t);
+  uint64_t  progress;
+  uint32_t  num_write_samples, block_align;
+  uint8_t*  write_buffer;
+  WAVError  err;
 
-  /* ビット深度に合わせてPCMデータの変換関数を決定 */
+  /* 対応しているビット深度か */
   switch (wavfile->format.bits_per_sample) {
-    case 8:
-      convert_sint32_to_pcmdata_func = WAV_Convert32bitPCMto8bitPCM;
-      break;
-    case 16:
-      convert_sint32_to_pcmdata_func = WAV_Convert32bitPCMto16bitPCM;
-      break;
-    case 24:
-      convert_sint32_to_pcmdata_func = WAV_Convert32bitPCMto24bitPCM;
-      break;
-    case 32:
-      convert_sint32_to_pcmdata_func = WAV_Convert32bitPCMto32bitPCM;
+    case 8: case 16: case 24: case 32:
       break;
     default:
       /* fprintf(stderr, "Unsupported bits per sample format(=%d). \n", wavfile->format.bits_per_sample); */
       return WAV_ERROR_INVALID_FORMAT;
   }
 
+  /* ビットバッファに溜まっている分（ヘッダ）を先に書き出す */
+  if (WAVWriter_Flush(writer) != WAV_ERROR_OK) {
+    return WAV_ERROR_IO;
+  }
+
+  block_align = (wavfile->format.bits_per_sample / 8) * wavfile->format.num_channels;
+  if ((write_buffer = (uint8_t *)malloc(block_align * WAVWRITER_BULK_WRITE_NUM_SAMPLES)) == NULL) {
+    return WAV_ERROR_NG;
+  }
+
   /* チャンネルインターリーブしつつ出力 */
-  bytes_per_sample = wavfile->format.bits_per_sample / 8;
-  for (sample = 0; sample < wavfile->format.num_samples; sample++) {
-    for (ch = 0; ch < wavfile->format.num_channels; ch++) {
-      if (WAVWriter_PutLittleEndianBytes(writer,
-            bytes_per_sample,
-            (uint64_t)convert_sint32_to_pcmdata_func(WAVFile_PCM(wavfile, sample, ch))) != WAV_ERROR_OK) {
-        return WAV_ERROR_IO;
-      }
+  err = WAV_ERROR_OK;
+  for (progress = 0; progress < wavfile->format.num_samples; progress += num_write_samples) {
+    num_write_samples = WAVWRITER_BULK_WRITE_NUM_SAMPLES;
+    if (num_write_samples > (wavfile->format.num_samples - progress)) {
+      num_write_samples = (uint32_t)(wavfile->format.num_samples - progress);
+    }
+    WAV_InterleavePcmData(&wavfile->format,
+        (const WAVPcmData* const *)wavfile->data, progress, num_write_samples, write_buffer);
+    if (fwrite(write_buffer, block_align, num_write_samples, writer->fp) != num_write_samples) {
+      err = WAV_ERROR_IO;
+      break;
     }
   }
 
-  return WAV_ERROR_OK;
+  free(write_buffer);
+  return err;
+}
+
+/* チャンネル毎の32bit整数形式のPCMデータをインターリーブしてファイル形式に変換 */
+static void WAV_InterleavePcmData(const struct WAVFileFormat* format,
+    const WAVPcmData* const* data, uint64_t offset, uint32_t num_samples, uint8_t* dst)
+{
+  uint32_t ch, smpl;
+  const uint32_t bytes_per_sample = format->bits_per_sample / 8;
+  const uint32_t block_align = bytes_per_sample * format->num_channels;
+
+  /* 32bit整数形式からビット深度に合わせて変換 */
+  for (ch = 0; ch < format->num_channels; ch++) {
+    const WAVPcmData* src = &data[ch][offset];
+    uint8_t* pdst = &dst[ch * bytes_per_sample];
+    switch (bytes_per_sample) {
+      case 1:
+        for (smpl = 0; smpl < num_samples; smpl++) {
+          pdst[0] = (uint8_t)WAV_Convert32bitPCMto8bitPCM(src[smpl]);
+          pdst += block_align;
+        }
+        break;
+      case 2:
+        for (smpl = 0; smpl < num_samples; smpl++) {
+          const uint32_t pcm = (uint32_t)WAV_Convert32bitPCMto16bitPCM(src[smpl]);
+          pdst[0] = (uint8_t)((pcm >> 0) & 0xFF);
+          pdst[1] = (uint8_t)((pcm >> 8) & 0xFF);
+          pdst += block_align;
+        }
+        break;
+      case 3:
+        for (smpl = 0; smpl < num_samples; smpl++) {
+          const uint32_t pcm = (uint32_t)WAV_Convert32bitPCMto24bitPCM(src[smpl]);
+          pdst[0] = (uint8_t)((pcm >>  0) & 0xFF);
+          pdst[1] = (uint8_t)((pcm >>  8) & 0xFF);
+          pdst[2] = (uint8_t)((pcm >> 16) & 0xFF);
+          pdst += block_align;
+        }
+        break;
+      case 4:
+        for (smpl = 0; smpl < num_samples; smpl++) {
+          const uint32_t pcm = (uint32_t)WAV_Convert32bitPCMto32bitPCM(src[smpl]);
+          pdst[0] = (uint8_t)((pcm >>  0) & 0xFF);
+          pdst[1] = (uint8_t)((pcm >>  8) & 0xFF);
+          pdst[2] = (uint8_t)((pcm >> 16) & 0xFF);
+          pdst[3] = (uint8_t)((pcm >> 24) & 0xFF);
+          pdst += block_align;
+        }
+        break;
+      default:
+        assert(0);
+    }
+  }
 }
 
 /* ファイル書き出し */
@@ -690,12 +1014,14 @@ WAVApiResult WAV_WriteToFile(
   WAVWriter_Initialize(&writer, fp);
 
   /* ヘッダ書き出し */
-  if (WAVWriter_PutWAVHeader(&writer, &wavfile->format) != WAV_ERROR_OK) {
+  if (WAVWriter_PutWAVHeader(&writer, &wavfile->format, WAV_IsRF64Required(&wavfile->format)) != WAV_ERROR_OK) {
+    fclose(fp);
     return WAV_APIRESULT_NG;
   }
 
   /* データ書き出し */
   if (WAVWriter_PutWAVPcmData(&writer, wavfile) != WAV_ERROR_OK) {
+    fclose(fp);
     return WAV_APIRESULT_NG;
   }
 
@@ -891,3 +1217,379 @@ static WAVError WAVParser_CheckSignatureString(
 
   return WAV_ERROR_OK;
 }
+
+/* パーサを使用してWave64のGUIDの残り12バイトの一致チェック */
+static WAVError WAVParser_CheckGUIDTail(
+  struct WAVParser* parser, const uint8_t* guid_tail)
+{
+  uint32_t i_byte;
+  uint64_t bitsbuf;
+
+  assert(parser != NULL && guid_tail != NULL);
+
+  for (i_byte = 0; i_byte < 12; i_byte++) {
+    if (WAVParser_GetBits(parser, 8, &bitsbuf) != WAV_ERROR_OK) {
+      return WAV_ERROR_IO;
+    }
+    if (guid_tail[i_byte] != (uint8_t)bitsbuf) {
+      return WAV_ERROR_INVALID_FORMAT;
+    }
+  }
+
+  return WAV_ERROR_OK;
+}
+
+/* パーサを使用してチャンクIDとチャンクのデータサイズを取得 */
+/* 補足）Wave64はGUIDの末尾が一致しないチャンクのIDを空白で埋めて返す */
+static WAVError WAVParser_GetChunkHeader(
+    struct WAVParser* parser, WAVContainer container, char* chunk_id, uint64_t* chunk_size)
+{
+  uint64_t bitsbuf;
+
+  assert(parser != NULL && chunk_id != NULL && chunk_size != NULL);
+
+  /* チャンクID */
+  if (WAVParser_GetString(parser, chunk_id, 4) != WAV_ERROR_OK) {
+    return WAV_ERROR_IO;
+  }
+
+  if (container == WAV_CONTAINER_W64) {
+    WAVError err = WAVParser_CheckGUIDTail(parser, wav_w64_chunk_guid_tail);
+    if (err == WAV_ERROR_INVALID_FORMAT) {
+      memset(chunk_id, ' ', 4);
+    } else if (err != WAV_ERROR_OK) {
+      return err;
+    }
+    /* サイズはチャンクヘッダ（GUID+サイズ）の24バイトを含む */
+    if (WAVParser_GetLittleEndianBytes(parser, 8, &bitsbuf) != WAV_ERROR_OK) {
+      return WAV_ERROR_IO;
+    }
+    if (bitsbuf < 24) {
+      return WAV_ERROR_INVALID_FORMAT;
+    }
+    *chunk_size = bitsbuf - 24;
+  } else {
+    if (WAVParser_GetLittleEndianBytes(parser, 4, &bitsbuf) != WAV_ERROR_OK) {
+      return WAV_ERROR_IO;
+    }
+    *chunk_size = bitsbuf;
+  }
+
+  return WAV_ERROR_OK;
+}
+
+/* パディングを含めたチャンクのデータサイズ */
+/* 補足）RIFFは2バイト境界、Wave64は8バイト境界に揃える */
+static uint64_t WAV_GetPaddedChunkSize(WAVContainer container, uint64_t chunk_size)
+{
+  const uint64_t align = (container == WAV_CONTAINER_W64) ? 8 : 2;
+  return (chunk_size + align - 1) & ~(align - 1);
+}
+
+/* ストリーム読み込みの開始（ヘッダまで読み込む） */
+struct WAVStreamReader* WAVStreamReader_Open(const char* filename)
+{
+  struct WAVStreamReader* reader;
+  FILE* fp;
+  long pos;
+
+  /* 引数チェック */
+  if (filename == NULL) {
+    return NULL;
+  }
+
+  /* wavファイルを開く */
+  if (strcmp(filename, "-") == 0) {
+    fp = stdin;
+  } else if ((fp = fopen(filename, "rb")) == NULL) {
+    return NULL;
+  }
+
+  if ((reader = (struct WAVStreamReader *)malloc(sizeof(struct WAVStreamReader))) == NULL) {
+    goto EXIT_FAILURE_WITH_CLOSE;
+  }
+  reader->buffer = NULL;
+
+  /* ヘッダ読み取り */
+  WAVParser_Initialize(&reader->parser, fp);
+  if (WAVParser_GetWAVFormat(&reader->parser, &reader->format) != WAV_ERROR_OK) {
+    goto EXIT_FAILURE_WITH_CLOSE;
+  }
+
+  /* 対応しているビット深度か */
+  switch (reader->format.bits_per_sample) {
+    case 8: case 16: case 24: case 32:
+      break;
+    default:
+      goto EXIT_FAILURE_WITH_CLOSE;
+  }
+
+  /* 読み込み領域の確保 */
+  reader->buffer = (uint8_t *)malloc(
+      (reader->format.bits_per_sample / 8) * reader->format.num_channels * WAVPARSER_BULK_READ_NUM_SAMPLES);
+  if (reader->buffer == NULL) {
+    goto EXIT_FAILURE_WITH_CLOSE;
+  }
+
+  /* データ先頭位置を記録（シークできない入力では-1） */
+  pos = ftell(fp);
+  reader->data_offset = (pos < 0) ? -1 : (pos - (long)WAVParser_GetNumBufferedBytes(&reader->parser));
+  reader->num_read_samples = 0;
+
+  return reader;
+
+EXIT_FAILURE_WITH_CLOSE:
+  if (reader != NULL) {
+    free(reader->buffer);
+    free(reader);
+  }
+  if (fp != stdin) {
+    fclose(fp);
+  }
+  return NULL;
+}
+
+/* ストリーム読み込みの終了 */
+void WAVStreamReader_Close(struct WAVStreamReader* reader)
+{
+  if (reader != NULL) {
+    if (reader->parser.fp != stdin) {
+      fclose(reader->parser.fp);
+    }
+    WAVParser_Finalize(&reader->parser);
+    free(reader->buffer);
+    free(reader);
+  }
+}
+
+/* フォーマットの取得 */
+const struct WAVFileFormat* WAVStreamReader_GetFormat(const struct WAVStreamReader* reader)
+{
+  if (reader == NULL) {
+    return NULL;
+  }
+  return &reader->format;
+}
+
+/* PCMデータをチャンネル毎の配列に読み込み */
+WAVApiResult WAVStreamReader_Read(struct WAVStreamReader* reader,
+    WAVPcmData** data, uint32_t num_samples, uint32_t* num_read_samples)
+{
+  uint32_t progress, num_request, num_read, block_align;
+
+  /* 引数チェック */
+  if ((reader == NULL) || (data == NULL) || (num_read_samples == NULL)) {
+    return WAV_APIRESULT_INVALID_PARAMETER;
+  }
+
+  /* データチャンクの残りに制限 */
+  if (num_samples > (reader->format.num_samples - reader->num_read_samples)) {
+    num_samples = (uint32_t)(reader->format.num_samples - reader->num_read_samples);
+  }
+
+  block_align = (reader->format.bits_per_sample / 8) * reader->format.num_channels;
+  for (progress = 0; progress < num_samples; progress += num_read) {
+    num_request = num_samples - progress;
+    if (num_request > WAVPARSER_BULK_READ_NUM_SAMPLES) {
+      num_request = WAVPARSER_BULK_READ_NUM_SAMPLES;
+    }
+    num_read = WAVParser_GetBytes(&reader->parser, reader->buffer, block_align * num_request) / block_align;
+    WAV_DeinterleavePcmData(&reader->format, reader->buffer, data, progress, num_read);
+    /* ファイル末尾に達した */
+    if (num_read < num_request) {
+      progress += num_read;
+      break;
+    }
+  }
+
+  reader->num_read_samples += progress;
+  *num_read_samples = progress;
+  return WAV_APIRESULT_OK;
+}
+
+/* PCMデータをファイル上の形式のまま読み込み */
+WAVApiResult WAVStreamReader_ReadInterleaved(struct WAVStreamReader* reader,
+    void* data, uint32_t num_samples, uint32_t* num_read_samples)
+{
+  uint32_t block_align;
+
+  /* 引数チェック */
+  if ((reader == NULL) || (data == NULL) || (num_read_samples == NULL)) {
+    return WAV_APIRESULT_INVALID_PARAMETER;
+  }
+
+  /* データチャンクの残りに制限 */
+  if (num_samples > (reader->format.num_samples - reader->num_read_samples)) {
+    num_samples = (uint32_t)(reader->format.num_samples - reader->num_read_samples);
+  }
+
+  block_align = (reader->format.bits_per_sample / 8) * reader->format.num_channels;
+  num_samples = WAVParser_GetBytes(&reader->parser, (uint8_t *)data, block_align * num_samples) / block_align;
+
+  reader->num_read_samples += num_samples;
+  *num_read_samples = num_samples;
+  return WAV_APIRESULT_OK;
+}
+
+/* 読み込み位置をPCMデータの先頭に戻す */
+WAVApiResult WAVStreamReader_Rewind(struct WAVStreamReader* reader)
+{
+  /* 引数チェック */
+  if (reader == NULL) {
+    return WAV_APIRESULT_INVALID_PARAMETER;
+  }
+
+  if ((reader->data_offset < 0)
+      || (WAVParser_Seek(&reader->parser, (int32_t)reader->data_offset, SEEK_SET) != WAV_ERROR_OK)) {
+    return WAV_APIRESULT_IOERROR;
+  }
+  reader->num_read_samples = 0;
+
+  return WAV_APIRESULT_OK;
+}
+
+/* ストリーム書き出しの開始（ヘッダを書き出す） */
+struct WAVStreamWriter* WAVStreamWriter_Open(const char* filename, const struct WAVFileFormat* format)
+{
+  struct WAVStreamWriter* writer;
+  FILE* fp;
+
+  /* 引数チェック */
+  if ((filename == NULL) || (format == NULL)) {
+    return NULL;
+  }
+
+  /* 対応しているビット深度か */
+  switch (format->bits_per_sample) {
+    case 8: case 16: case 24: case 32:
+      break;
+    default:
+      return NULL;
+  }
+
+  /* wavファイルを開く */
+  if (strcmp(filename, "-") == 0) {
+    fp = stdout;
+  } else if ((fp = fopen(filename, "wb")) == NULL) {
+    return NULL;
+  }
+
+  if ((writer = (struct WAVStreamWriter *)malloc(sizeof(struct WAVStreamWriter))) == NULL) {
+    goto EXIT_FAILURE_WITH_CLOSE;
+  }
+  writer->format = *format;
+  writer->num_write_samples = 0;
+  writer->rf64 = WAV_IsRF64Required(format);
+  writer->buffer = (uint8_t *)malloc(
+      (format->bits_per_sample / 8) * format->num_channels * WAVWRITER_BULK_WRITE_NUM_SAMPLES);
+  if (writer->buffer == NULL) {
+    goto EXIT_FAILURE_WITH_CLOSE;
+  }
+
+  /* ヘッダ書き出し */
+  WAVWriter_Initialize(&writer->writer, fp);
+  if ((WAVWriter_PutWAVHeader(&writer->writer, format, writer->rf64) != WAV_ERROR_OK)
+      || (WAVWriter_Flush(&writer->writer) != WAV_ERROR_OK)) {
+    goto EXIT_FAILURE_WITH_CLOSE;
+  }
+
+  return writer;
+
+EXIT_FAILURE_WITH_CLOSE:
+  if (writer != NULL) {
+    free(writer->buffer);
+    free(writer);
+  }
+  if (fp != stdout) {
+    fclose(fp);
+  }
+  return NULL;
+}
+
+/* PCMデータをチャンネル毎の配列から書き出し */
+WAVApiResult WAVStreamWriter_Write(struct WAVStreamWriter* writer,
+    const WAVPcmData* const* data, uint32_t num_samples)
+{
+  uint32_t progress, num_write, block_align;
+
+  /* 引数チェック */
+  if ((writer == NULL) || (data == NULL)) {
+    return WAV_APIRESULT_INVALID_PARAMETER;
+  }
+
+  block_align = (writer->format.bits_per_sample / 8) * writer->format.num_channels;
+  for (progress = 0; progress < num_samples; progress += num_write) {
+    num_write = num_samples - progress;
+    if (num_write > WAVWRITER_BULK_WRITE_NUM_SAMPLES) {
+      num_write = WAVWRITER_BULK_WRITE_NUM_SAMPLES;
+    }
+    WAV_InterleavePcmData(&writer->format, data, progress, num_write, writer->buffer);
+    if (fwrite(writer->buffer, block_align, num_write, writer->writer.fp) != num_write) {
+      return WAV_APIRESULT_IOERROR;
+    }
+    writer->num_write_samples += num_write;
+  }
+
+  return WAV_APIRESULT_OK;
+}
+
+/* ファイル上の形式のPCMデータをそのまま書き出し */
+WAVApiResult WAVStreamWriter_WriteInterleaved(struct WAVStreamWriter* writer,
+    const void* data, uint32_t num_samples)
+{
+  uint32_t block_align;
+
+  /* 引数チェック */
+  if ((writer == NULL) || (data == NULL)) {
+    return WAV_APIRESULT_INVALID_PARAMETER;
+  }
+
+  block_align = (writer->format.bits_per_sample / 8) * writer->format.num_channels;
+  if (fwrite(data, block_align, num_samples, writer->writer.fp) != num_samples) {
+    return WAV_APIRESULT_IOERROR;
+  }
+  writer->num_write_samples += num_samples;
+
+  return WAV_APIRESULT_OK;
+}
+
+/* ストリーム書き出しの終了 */
+WAVApiResult WAVStreamWriter_Close(struct WAVStreamWriter* writer)
+{
+  WAVApiResult ret = WAV_APIRESULT_OK;
+  FILE* fp;
+
+  /* 引数チェック */
+  if (writer == NULL) {
+    return WAV_APIRESULT_INVALID_PARAMETER;
+  }
+
+  fp = writer->writer.fp;
+
+  /* サンプル数がヘッダと異なる場合はヘッダを書き直す */
+  /* 補足）ヘッダの形式（RIFF/RF64）は開始時のままなので、RIFF形式で4GiBを超えた場合は直せない */
+  if (writer->num_write_samples != writer->format.num_samples) {
+    writer->format.num_samples = writer->num_write_samples;
+    if (fseek(fp, 0, SEEK_SET) != 0) {
+      /* シークできない出力ではヘッダを直せない */
+      ret = WAV_APIRESULT_IOERROR;
+    } else if ((WAVWriter_PutWAVHeader(&writer->writer, &writer->format, writer->rf64) != WAV_ERROR_OK)
+        || (WAVWriter_Flush(&writer->writer) != WAV_ERROR_OK)) {
+      ret = WAV_APIRESULT_IOERROR;
+    }
+  }
+
+  WAVWriter_Finalize(&writer->writer);
+  if (fp != stdout) {
+    if (fclose(fp) != 0) {
+      ret = WAV_APIRESULT_IOERROR;
+    }
+  } else if (fflush(fp) != 0) {
+    ret = WAV_APIRESULT_IOERROR;
+  }
+
+  free(writer->buffer);
+  free(writer);
+
+  return ret;
+}
@@ -0,0 +1,425 @@
+#include "test.h"
+
+#include <string.h>
+#include <stdlib.h>
+
+/* テスト対象のモジュール */
+#include "../src/SLABlockCache.c"
+
+/* テストのセットアップ関数 */
+void testSLABlockCache_Setup(void);
+
+static int testSLABlockCache_Initialize(void *obj)
+{
+  TEST_UNUSED_PARAMETER(obj);
+  return 0;
+}
+
+static int testSLABlockCache_Finalize(void *obj)
+{
+  TEST_UNUSED_PARAMETER(obj);
+  return 0;
+}
+
+/* テスト用のロック状態 */
+struct BlockCacheTestLockState {
+  uint32_t num_shards;
+  int32_t  lock_count[4];   /* 分割毎のロック中の回数 */
+  uint32_t num_locks;       /* ロック関数の呼び出し回数 */
+  uint8_t  is_error;        /* 二重ロック/ロックしていないのにアンロックした */
+};
+
+/* テスト用ロック関数 */
+static void testSLABlockCache_Lock(void* lock_context, uint32_t shard_no)
+{
+  struct BlockCacheTestLockState* state = (struct BlockCacheTestLockState *)lock_context;
+  if ((shard_no >= state->num_shards) || (state->lock_count[shard_no] != 0)) {
+    state->is_error = 1;
+    return;
+  }
+  state->lock_count[shard_no]++;
+  state->num_locks++;
+}
+
+/* テスト用アンロック関数 */
+static void testSLABlockCache_Unlock(void* lock_context, uint32_t shard_no)
+{
+  struct BlockCacheTestLockState* state = (struct BlockCacheTestLockState *)lock_context;
+  if ((shard_no >= state->num_shards) || (state->lock_count[shard_no] != 1)) {
+    state->is_error = 1;
+    return;
+  }
+  state->lock_count[shard_no]--;
+}
+
+/* 有効なコンフィグをセット */
+static void testSLABlockCache_SetValidConfig(struct SLABlockCacheConfig* config)
+{
+  config->max_num_channels      = 2;
+  config->max_num_block_samples = 16;
+  config->max_cache_size        = 4 * sizeof(int32_t) * 2 * 16;
+  config->num_shards            = 1;
+  config->lock                  = NULL;
+  config->unlock                = NULL;
+  config->lock_context          = NULL;
+}
+
+/* 作成破棄テスト */
+static void testSLABlockCache_CreateDestroyTest(void *obj)
+{
+  TEST_UNUSED_PARAMETER(obj);
+
+  /* ワークサイズ計算 */
+  {
+    struct SLABlockCacheConfig config;
+
+    testSLABlockCache_SetValidConfig(&config);
+    Test_AssertCondition(SLABlockCache_CalculateWorkSize(&config) > 0);
+
+    /* 不正なコンフィグ */
+    Test_AssertCondition(SLABlockCache_CalculateWorkSize(NULL) < 0);
+    testSLABlockCache_SetValidConfig(&config);
+    config.num_shards = 0;
+    Test_AssertCondition(SLABlockCache_CalculateWorkSize(&config) < 0);
+    testSLABlockCache_SetValidConfig(&config);
+    config.max_num_block_samples = 0;
+    Test_AssertCondition(SLABlockCache_CalculateWorkSize(&config) < 0);
+    /* 1ブロックも格納できない */
+    testSLABlockCache_SetValidConfig(&config);
+    config.max_cache_size = sizeof(int32_t) * 2 * 16 - 1;
+    Test_AssertCondition(SLABlockCache_CalculateWorkSize(&config) < 0);
+    /* 分割数より少ないブロックしか格納できない */
+    testSLABlockCache_SetValidConfig(&config);
+    config.num_shards = 5;
+    Test_AssertCondition(SLABlockCache_CalculateWorkSize(&config) < 0);
+    /* ロック関数の片方だけ指定 */
+    testSLABlockCache_SetValidConfig(&config);
+    config.lock = testSLABlockCache_Lock;
+    Test_AssertCondition(SLABlockCache_CalculateWorkSize(&config) < 0);
+    /* スロットサイズの計算が32bitで桁あふれする */
+    testSLABlockCache_SetValidConfig(&config);
+    config.max_num_channels = 0x40000001UL;
+    config.max_num_block_samples = 1;
+    Test_AssertCondition(SLABlockCache_CalculateWorkSize(&config) < 0);
+    testSLABlockCache_SetValidConfig(&config);
+    config.max_num_channels = 0x10000;
+    config.max_num_block_samples = 0x10000;
+    config.max_cache_size = 0xFFFFFFFFUL;
+    Test_AssertCondition(SLABlockCache_CalculateWorkSize(&config) < 0);
+  }
+
+  /* ワーク領域を渡して作成 */
+  {
+    struct SLABlockCacheConfig config;
+    struct SLABlockCache* cache;
+    int32_t work_size;
+    void* work;
+
+    testSLABlockCache_SetValidConfig(&config);
+    work_size = SLABlockCache_CalculateWorkSize(&config);
+    work = malloc((size_t)work_size);
+    Test_AssertCondition(SLABlockCache_CreateWithWork(&config, work, work_size - 1) == NULL);
+    cache = SLABlockCache_CreateWithWork(&config, work, work_size);
+    Test_AssertCondition(cache != NULL);
+    Test_AssertEqual(cache->alloced_by_own, 0);
+    Test_AssertEqual(cache->shards[0].num_slots, 4);
+    SLABlockCache_Destroy(cache);
+    free(work);
+  }
+
+  /* 自前で確保して作成 */
+  {
+    struct SLABlockCacheConfig config;
+    struct SLABlockCache* cache;
+
+    testSLABlockCache_SetValidConfig(&config);
+    cache = SLABlockCache_Create(&config);
+    Test_AssertCondition(cache != NULL);
+    Test_AssertEqual(cache->alloced_by_own, 1);
+    SLABlockCache_Destroy(cache);
+  }
+}
+
+/* 格納/取得とLRU追い出しのテスト */
+static void testSLABlockCache_PutGetTest(void *obj)
+{
+  TEST_UNUSED_PARAMETER(obj);
+
+  /* 格納したブロックを取り出せるか */
+  {
+    struct SLABlockCacheConfig config;
+    struct SLABlockCache* cache;
+    struct SLABlockCacheStatistics stats;
+    int32_t src0[16], src1[16], dst0[16], dst1[16];
+    const int32_t* src[2];
+    int32_t* dst[2];
+    uint32_t i, num_samples;
+
+    for (i = 0; i < 16; i++) {
+      src0[i] = (int32_t)i;
+      src1[i] = -(int32_t)i;
+    }
+    src[0] = src0; src[1] = src1;
+    dst[0] = dst0; dst[1] = dst1;
+
+    testSLABlockCache_SetValidConfig(&config);
+    cache = SLABlockCache_Create(&config);
+
+    /* 空の状態ではミス */
+    Test_AssertEqual(SLABlockCache_Get(cache, 0, 0, dst, 2, 16, &num_samples), SLA_APIRESULT_CACHE_MISS);
+
+    Test_AssertEqual(SLABlockCache_Put(cache, 0, 0, src, 2, 10), SLA_APIRESULT_OK);
+    memset(dst0, 0, sizeof(dst0));
+    memset(dst1, 0, sizeof(dst1));
+    Test_AssertEqual(SLABlockCache_Get(cache, 0, 0, dst, 2, 16, &num_samples), SLA_APIRESULT_OK);
+    Test_AssertEqual(num_samples, 10);
+    Test_AssertEqual(memcmp(dst0, src0, sizeof(int32_t) * 10), 0);
+    Test_AssertEqual(memcmp(dst1, src1, sizeof(int32_t) * 10), 0);
+
+    /* 別のストリーム/ブロック番号ではミス */
+    Test_AssertEqual(SLABlockCache_Get(cache, 1, 0, dst, 2, 16, &num_samples), SLA_APIRESULT_CACHE_MISS);
+    Test_AssertEqual(SLABlockCache_Get(cache, 0, 1, dst, 2, 16, &num_samples), SLA_APIRESULT_CACHE_MISS);
+
+    /* 取り出し先が小さい・チャンネル数が違う */
+    Test_AssertEqual(SLABlockCache_Get(cache, 0, 0, dst, 2, 9, &num_samples), SLA_APIRESULT_INSUFFICIENT_BUFFER_SIZE);
+    Test_AssertEqual(SLABlockCache_Get(cache, 0, 0, dst, 1, 16, &num_samples), SLA_APIRESULT_INVALID_ARGUMENT);
+
+    /* 格納できない大きさ */
+    Test_AssertEqual(SLABlockCache_Put(cache, 0, 1, src, 2, 17), SLA_APIRESULT_EXCEED_HANDLE_CAPACITY);
+    Test_AssertEqual(SLABlockCache_Put(cache, 0, 1, src, 3, 16), SLA_APIRESULT_EXCEED_HANDLE_CAPACITY);
+
+    Test_AssertEqual(SLABlockCache_GetStatistics(cache, &stats), SLA_APIRESULT_OK);
+    Test_AssertEqual(stats.num_slots, 4);
+    Test_AssertEqual(stats.num_used_slots, 1);
+    Test_AssertEqual(stats.num_hits, 1);
+    Test_AssertEqual(stats.num_misses, 3);
+    Test_AssertEqual(stats.num_evictions, 0);
+
+    SLABlockCache_Destroy(cache);
+  }
+
+  /* 最も古く参照したブロックから追い出されるか */
+  {
+    struct SLABlockCacheConfig config;
+    struct SLABlockCache* cache;
+    struct SLABlockCacheStatistics stats;
+    int32_t src0[16], src1[16], dst0[16], dst1[16];
+    const int32_t* src[2];
+    int32_t* dst[2];
+    uint32_t i, num_samples;
+
+    src[0] = src0; src[1] = src1;
+    dst[0] = dst0; dst[1] = dst1;
+
+    testSLABlockCache_SetValidConfig(&config);
+    cache = SLABlockCache_Create(&config);
+
+    /* 4スロットを埋める */
+    for (i = 0; i < 4; i++) {
+      src0[0] = (int32_t)i;
+      Test_AssertEqual(SLABlockCache_Put(cache, 7, i, src, 2, 16), SLA_APIRESULT_OK);
+    }
+    /* ブロック0を参照して最新にする */
+    Test_AssertEqual(SLABlockCache_Get(cache, 7, 0, dst, 2, 16, &num_samples), SLA_APIRESULT_OK);
+    /* 5つ目を格納するとブロック1が追い出される */
+    Test_AssertEqual(SLABlockCache_Put(cache, 7, 4, src, 2, 16), SLA_APIRESULT_OK);
+    Test_AssertEqual(SLABlockCache_Get(cache, 7, 1, dst, 2, 16, &num_samples), SLA_APIRESULT_CACHE_MISS);
+    Test_AssertEqual(SLABlockCache_Get(cache, 7, 0, dst, 2, 16, &num_samples), SLA_APIRESULT_OK);
+    Test_AssertEqual(dst0[0], 0);
+    Test_AssertEqual(SLABlockCache_Get(cache, 7, 2, dst, 2, 16, &num_samples), SLA_APIRESULT_OK);
+    Test_AssertEqual(dst0[0], 2);
+
+    /* 格納済みのブロックは上書きされる（追い出しは起きない） */
+    src0[0] = 100;
+    Test_AssertEqual(SLABlockCache_Put(cache, 7, 2, src, 2, 16), SLA_APIRESULT_OK);
+    Test_AssertEqual(SLABlockCache_Get(cache, 7, 2, dst, 2, 16, &num_samples), SLA_APIRESULT_OK);
+    Test_AssertEqual(dst0[0], 100);
+
+    Test_AssertEqual(SLABlockCache_GetStatistics(cache, &stats), SLA_APIRESULT_OK);
+    Test_AssertEqual(stats.num_used_slots, 4);
+    Test_AssertEqual(stats.num_evictions, 1);
+
+    /* ストリーム単位の破棄（別ストリームの格納で1つ追い出される） */
+    Test_AssertEqual(SLABlockCache_Put(cache, 8, 0, src, 2, 16), SLA_APIRESULT_OK);
+    Test_AssertEqual(SLABlockCache_Invalidate(cache, 7), SLA_APIRESULT_OK);
+    Test_AssertEqual(SLABlockCache_GetStatistics(cache, &stats), SLA_APIRESULT_OK);
+    Test_AssertEqual(stats.num_used_slots, 1);
+    Test_AssertEqual(SLABlockCache_Get(cache, 7, 0, dst, 2, 16, &num_samples), SLA_APIRESULT_CACHE_MISS);
+    Test_AssertEqual(SLABlockCache_Get(cache, 8, 0, dst, 2, 16, &num_samples), SLA_APIRESULT_OK);
+
+    /* 破棄した後も空きスロットを再利用できる */
+    for (i = 0; i < 3; i++) {
+      Test_AssertEqual(SLABlockCache_Put(cache, 9, i, src, 2, 16), SLA_APIRESULT_OK);
+    }
+    Test_AssertEqual(SLABlockCache_GetStatistics(cache, &stats), SLA_APIRESULT_OK);
+    Test_AssertEqual(stats.num_used_slots, 4);
+    Test_AssertEqual(stats.num_evictions, 2);
+
+    SLABlockCache_Destroy(cache);
+  }
+}
+
+/* 分割とロックのテスト */
+static void testSLABlockCache_ShardLockTest(void *obj)
+{
+  TEST_UNUSED_PARAMETER(obj);
+
+  {
+    struct SLABlockCacheConfig config;
+    struct SLABlockCache* cache;
+    struct SLABlockCacheStatistics stats;
+    struct BlockCacheTestLockState state;
+    int32_t src0[16], src1[16], dst0[16], dst1[16];
+    const int32_t* src[2];
+    int32_t* dst[2];
+    uint32_t i, num_samples;
+
+    memset(&state, 0, sizeof(state));
+    memset(src0, 0, sizeof(src0));
+    memset(src1, 0, sizeof(src1));
+    state.num_shards = 4;
+    src[0] = src0; src[1] = src1;
+    dst[0] = dst0; dst[1] = dst1;
+
+    testSLABlockCache_SetValidConfig(&config);
+    config.num_shards     = 4;
+    config.max_cache_size = 4 * 3 * sizeof(int32_t) * 2 * 16;
+    config.lock           = testSLABlockCache_Lock;
+    config.unlock         = testSLABlockCache_Unlock;
+    config.lock_context   = &state;
+    cache = SLABlockCache_Create(&config);
+    Test_AssertCondition(cache != NULL);
+
+    /* 分割数を超えるブロックを格納・取得 */
+    for (i = 0; i < 8; i++) {
+      src0[0] = (int32_t)i;
+      Test_AssertEqual(SLABlockCache_Put(cache, 1, i, src, 2, 16), SLA_APIRESULT_OK);
+    }
+    for (i = 0; i < 8; i++) {
+      if (SLABlockCache_Get(cache, 1, i, dst, 2, 16, &num_samples) == SLA_APIRESULT_OK) {
+        Test_AssertEqual(dst0[0], (int32_t)i);
+      }
+    }
+    Test_AssertEqual(SLABlockCache_Invalidate(cache, 1), SLA_APIRESULT_OK);
+    Test_AssertEqual(SLABlockCache_GetStatistics(cache, &stats), SLA_APIRESULT_OK);
+    Test_AssertEqual(stats.num_slots, 12);
+    Test_AssertEqual(stats.num_used_slots, 0);
+
+    /* ロック/アンロックの対応が取れているか */
+    Test_AssertEqual(state.is_error, 0);
+    Test_AssertEqual(state.num_locks, 8 + 8 + 4 + 4);
+    for (i = 0; i < 4; i++) {
+      Test_AssertEqual(state.lock_count[i], 0);
+    }
+
+    SLABlockCache_Destroy(cache);
+  }
+}
+
+/* 多数のブロックを出し入れしても参照実装と一致するか */
+static void testSLABlockCache_ManyBlocksTest(void *obj)
+{
+#define NUM_TEST_SLOTS  64
+#define NUM_TEST_KEYS   200
+  TEST_UNUSED_PARAMETER(obj);
+
+  {
+    struct SLABlockCacheConfig config;
+    struct SLABlockCache* cache;
+    struct SLABlockCacheStatistics stats;
+    int32_t src0[1], dst0[1];
+    const int32_t* src[1];
+    int32_t* dst[1];
+    /* 参照実装: キー毎の最終参照時刻（0は未格納） */
+    uint32_t last_access[NUM_TEST_KEYS];
+    uint32_t i, k, time, num_samples, num_stored, is_ok;
+
+    src[0] = src0;
+    dst[0] = dst0;
+    memset(last_access, 0, sizeof(last_access));
+
+    testSLABlockCache_SetValidConfig(&config);
+    config.max_num_channels      = 1;
+    config.max_num_block_samples = 1;
+    config.max_cache_size        = NUM_TEST_SLOTS * sizeof(int32_t);
+    cache = SLABlockCache_Create(&config);
+    Test_AssertCondition(cache != NULL);
+
+    is_ok = 1;
+    srand(1);
+    for (time = 1; time <= 20000; time++) {
+      /* キーはストリーム番号とブロック番号に分けて与える */
+      k = (uint32_t)rand() % NUM_TEST_KEYS;
+      if ((rand() % 3) == 0) {
+        src0[0] = (int32_t)k;
+        if (SLABlockCache_Put(cache, k % 5, k / 5, src, 1, 1) != SLA_APIRESULT_OK) {
+          is_ok = 0;
+          break;
+        }
+        /* 満杯なら参照実装でも最も古いキーを追い出す */
+        num_stored = 0;
+        for (i = 0; i < NUM_TEST_KEYS; i++) {
+          num_stored += (last_access[i] > 0) ? 1 : 0;
+        }
+        if ((last_access[k] == 0) && (num_stored == NUM_TEST_SLOTS)) {
+          uint32_t oldest = NUM_TEST_KEYS;
+          for (i = 0; i < NUM_TEST_KEYS; i++) {
+            if ((last_access[i] > 0) && ((oldest == NUM_TEST_KEYS) || (last_access[i] < last_access[oldest]))) {
+              oldest = i;
+            }
+          }
+          last_access[oldest] = 0;
+        }
+        last_access[k] = time;
+      } else if ((rand() % 50) == 0) {
+        /* ストリーム単位の破棄 */
+        if (SLABlockCache_Invalidate(cache, k % 5) != SLA_APIRESULT_OK) {
+          is_ok = 0;
+          break;
+        }
+        for (i = 0; i < NUM_TEST_KEYS; i++) {
+          if ((i % 5) == (k % 5)) {
+            last_access[i] = 0;
+          }
+        }
+      } else {
+        SLAApiResult ret = SLABlockCache_Get(cache, k % 5, k / 5, dst, 1, 1, &num_samples);
+        if (last_access[k] > 0) {
+          if ((ret != SLA_APIRESULT_OK) || (dst0[0] != (int32_t)k)) {
+            is_ok = 0;
+            break;
+          }
+          last_access[k] = time;
+        } else if (ret != SLA_APIRESULT_CACHE_MISS) {
+          is_ok = 0;
+          break;
+        }
+      }
+    }
+    Test_AssertEqual(is_ok, 1);
+
+    num_stored = 0;
+    for (i = 0; i < NUM_TEST_KEYS; i++) {
+      num_stored += (last_access[i] > 0) ? 1 : 0;
+    }
+    Test_AssertEqual(SLABlockCache_GetStatistics(cache, &stats), SLA_APIRESULT_OK);
+    Test_AssertEqual(stats.num_slots, NUM_TEST_SLOTS);
+    Test_AssertEqual(stats.num_used_slots, num_stored);
+
+    SLABlockCache_Destroy(cache);
+  }
+#undef NUM_TEST_SLOTS
+#undef NUM_TEST_KEYS
+}
+
+void testSLABlockCache_Setup(void)
+{
+  struct TestSuite *suite
+    = Test_AddTestSuite("SLA Block Cache Test Suite",
+        NULL, testSLABlockCache_Initialize, testSLABlockCache_Finalize);
+
+  Test_AddTest(suite, testSLABlockCache_CreateDestroyTest);
+  Test_AddTest(suite, testSLABlockCache_PutGetTest);
+  Test_AddTest(suite, testSLABlockCache_ShardLockTest);
+  Test_AddTest(suite, testSLABlockCache_ManyBlocksTest);
+}
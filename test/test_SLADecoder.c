@@ -59,6 +59,203 @@ static void testSLADecoder_DecodeHeaderTest(void *obj)
     Test_AssertEqual(write_header.num_samples,                    get_header.num_samples);
     Test_AssertEqual(write_header.num_blocks,                     get_header.num_blocks);
     Test_AssertEqual(write_header.max_block_size,                 get_header.max_block_size);
+    Test_AssertEqual(get_header.header_size, SLA_HEADER_SIZE);
+  }
+
+  /* 32bitを超えるサンプル数も保持できるか？ */
+  {
+    struct SLAHeaderInfo write_header, get_header;
+    uint8_t data[SLA_HEADER_SIZE];
+
+    SLATestUtility_SetValidHeaderInfo(&write_header);
+    write_header.num_samples = ((uint64_t)3 << 32) | 0x12345678UL;
+    Test_AssertEqual(
+        SLAEncoder_EncodeHeader(&write_header, data, sizeof(data)),
+        SLA_APIRESULT_OK);
+    Test_AssertEqual(
+        SLADecoder_DecodeHeader(data, sizeof(data), &get_header),
+        SLA_APIRESULT_OK);
+    Test_AssertCondition(get_header.num_samples == write_header.num_samples);
+  }
+
+  /* ハンドルの領域サイズを決める値が範囲外のヘッダは不正とするか？ */
+  {
+    static const struct {
+      uint8_t   num_channels;
+      uint32_t  max_num_block_samples;
+    } invalid_values[] = {
+      { 0, 4096 }, { 2, 0 }, { 2, SLA_MAX_NUM_BLOCK_SAMPLES + 1 }, { 2, 0x15555556UL },
+    };
+    struct SLAHeaderInfo write_header, get_header;
+    uint8_t data[SLA_HEADER_SIZE];
+    uint8_t* data_ptr;
+    uint32_t i;
+
+    for (i = 0; i < sizeof(invalid_values) / sizeof(invalid_values[0]); i++) {
+      SLATestUtility_SetValidHeaderInfo(&write_header);
+      Test_AssertEqual(
+          SLAEncoder_EncodeHeader(&write_header, data, sizeof(data)),
+          SLA_APIRESULT_OK);
+      /* チャンネル数とブロックあたり最大サンプル数を書き換え、CRC16は正しく付け直す */
+      data[14] = invalid_values[i].num_channels;
+      data_ptr = &data[37];
+      SLAByteArray_PutUint32(data_ptr, invalid_values[i].max_num_block_samples);
+      data_ptr = &data[SLA_HEADER_CRC16_CALC_START_OFFSET - 2];
+      SLAByteArray_PutUint16(data_ptr, SLAUtility_CalculateCRC16(
+            &data[SLA_HEADER_CRC16_CALC_START_OFFSET], SLA_HEADER_SIZE - SLA_HEADER_CRC16_CALC_START_OFFSET));
+      Test_AssertEqual(
+          SLADecoder_DecodeHeader(data, sizeof(data), &get_header),
+          SLA_APIRESULT_INVALID_HEADER_FORMAT);
+    }
+
+    /* 上限ちょうどは受け付ける */
+    SLATestUtility_SetValidHeaderInfo(&write_header);
+    write_header.wave_format.num_channels = SLA_MAX_NUM_CHANNELS;
+    write_header.encode_param.max_num_block_samples = SLA_MAX_NUM_BLOCK_SAMPLES;
+    Test_AssertEqual(
+        SLAEncoder_EncodeHeader(&write_header, data, sizeof(data)),
+        SLA_APIRESULT_OK);
+    Test_AssertEqual(
+        SLADecoder_DecodeHeader(data, sizeof(data), &get_header),
+        SLA_APIRESULT_OK);
+    Test_AssertEqual(get_header.wave_format.num_channels, SLA_MAX_NUM_CHANNELS);
+    Test_AssertEqual(get_header.encode_param.max_num_block_samples, SLA_MAX_NUM_BLOCK_SAMPLES);
+  }
+
+  /* ブロックヘッダより小さい最大ブロックサイズのヘッダは不正とするか？ */
+  {
+    static const uint32_t invalid_max_block_sizes[] = { 0, 1, SLA_MINIMUM_BLOCK_HEADER_SIZE - 1 };
+    struct SLAHeaderInfo write_header, get_header;
+    uint8_t data[SLA_HEADER_SIZE];
+    uint32_t i;
+
+    for (i = 0; i < sizeof(invalid_max_block_sizes) / sizeof(invalid_max_block_sizes[0]); i++) {
+      SLATestUtility_SetValidHeaderInfo(&write_header);
+      write_header.max_block_size = invalid_max_block_sizes[i];
+      Test_AssertEqual(
+          SLAEncoder_EncodeHeader(&write_header, data, sizeof(data)),
+          SLA_APIRESULT_OK);
+      Test_AssertEqual(
+          SLADecoder_DecodeHeader(data, sizeof(data), &get_header),
+          SLA_APIRESULT_INVALID_HEADER_FORMAT);
+    }
+
+    /* ブロックヘッダちょうど・未知の値は受け付ける */
+    SLATestUtility_SetValidHeaderInfo(&write_header);
+    write_header.max_block_size = SLA_MINIMUM_BLOCK_HEADER_SIZE;
+    Test_AssertEqual(
+        SLAEncoder_EncodeHeader(&write_header, data, sizeof(data)),
+        SLA_APIRESULT_OK);
+    Test_AssertEqual(
+        SLADecoder_DecodeHeader(data, sizeof(data), &get_header),
+        SLA_APIRESULT_OK);
+    write_header.max_block_size = SLA_MAX_BLOCK_SIZE_INVAILD;
+    Test_AssertEqual(
+        SLAEncoder_EncodeHeader(&write_header, data, sizeof(data)),
+        SLA_APIRESULT_OK);
+    Test_AssertEqual(
+        SLADecoder_DecodeHeader(data, sizeof(data), &get_header),
+        SLA_APIRESULT_OK);
+
+    /* ブロックを含まないデータは0を受け付ける */
+    write_header.num_samples    = 0;
+    write_header.num_blocks     = 0;
+    write_header.max_block_size = 0;
+    Test_AssertEqual(
+        SLAEncoder_EncodeHeader(&write_header, data, sizeof(data)),
+        SLA_APIRESULT_OK);
+    Test_AssertEqual(
+        SLADecoder_DecodeHeader(data, sizeof(data), &get_header),
+        SLA_APIRESULT_OK);
+    Test_AssertEqual(get_header.max_block_size, 0);
+  }
+
+  /* フォーマットバージョン2（ブロックあたりサンプル数16bit）のヘッダも読めるか？ */
+  {
+    struct SLAHeaderInfo write_header, get_header;
+    uint8_t v3data[SLA_HEADER_SIZE];
+    uint8_t data[SLA_HEADER_SIZE_V2];
+    uint8_t* data_ptr;
+
+    SLATestUtility_SetValidHeaderInfo(&write_header);
+    Test_AssertEqual(
+        SLAEncoder_EncodeHeader(&write_header, v3data, sizeof(v3data)),
+        SLA_APIRESULT_OK);
+
+    /* バージョン3のヘッダからバージョン2のヘッダを組み立てる */
+    /* ブロックあたりサンプル数を16bitに詰め、以降のフィールドはそのまま */
+    memcpy(data, v3data, 37);
+    memcpy(&data[39], &v3data[41], SLA_HEADER_SIZE - 41);
+    data_ptr = &data[4];
+    SLAByteArray_PutUint32(data_ptr, SLA_HEADER_SIZE_V2 - 8);
+    data_ptr = &data[SLA_HEADER_CRC16_CALC_START_OFFSET];
+    SLAByteArray_PutUint32(data_ptr, 2);
+    data_ptr = &data[37];
+    SLAByteArray_PutUint16(data_ptr, (uint16_t)write_header.encode_param.max_num_block_samples);
+    data_ptr = &data[SLA_HEADER_CRC16_CALC_START_OFFSET - 2];
+    SLAByteArray_PutUint16(data_ptr, SLAUtility_CalculateCRC16(
+          &data[SLA_HEADER_CRC16_CALC_START_OFFSET], SLA_HEADER_SIZE_V2 - SLA_HEADER_CRC16_CALC_START_OFFSET));
+
+    Test_AssertEqual(
+        SLADecoder_DecodeHeader(data, sizeof(data), &get_header),
+        SLA_APIRESULT_OK);
+    Test_AssertEqual(get_header.header_size, SLA_HEADER_SIZE_V2);
+    Test_AssertCondition(get_header.num_samples == write_header.num_samples);
+    Test_AssertEqual(write_header.encode_param.max_num_block_samples, get_header.encode_param.max_num_block_samples);
+    Test_AssertEqual(write_header.num_blocks,                     get_header.num_blocks);
+    Test_AssertEqual(write_header.max_block_size,                 get_header.max_block_size);
+    Test_AssertEqual(write_header.max_bit_per_second,             get_header.max_bit_per_second);
+  }
+
+  /* フォーマットバージョン1（サンプル数32bit）のヘッダも読めるか？ */
+  {
+    struct SLAHeaderInfo write_header, get_header;
+    uint8_t v3data[SLA_HEADER_SIZE];
+    uint8_t data[SLA_HEADER_SIZE_V1];
+    uint8_t* data_ptr;
+
+    SLATestUtility_SetValidHeaderInfo(&write_header);
+    Test_AssertEqual(
+        SLAEncoder_EncodeHeader(&write_header, v3data, sizeof(v3data)),
+        SLA_APIRESULT_OK);
+
+    /* バージョン3のヘッダからバージョン1のヘッダを組み立てる */
+    /* シグネチャ・チャンネル数はそのまま、サンプル数を32bit、ブロックあたりサンプル数を16bitに詰め、以降のフィールドはそのまま */
+    memcpy(data, v3data, 15);
+    memcpy(&data[19], &v3data[23], 14);
+    memcpy(&data[35], &v3data[41], SLA_HEADER_SIZE - 41);
+    data_ptr = &data[33];
+    SLAByteArray_PutUint16(data_ptr, (uint16_t)write_header.encode_param.max_num_block_samples);
+    data_ptr = &data[4];
+    SLAByteArray_PutUint32(data_ptr, SLA_HEADER_SIZE_V1 - 8);
+    data_ptr = &data[SLA_HEADER_CRC16_CALC_START_OFFSET];
+    SLAByteArray_PutUint32(data_ptr, 1);
+    data_ptr = &data[15];
+    SLAByteArray_PutUint32(data_ptr, (uint32_t)write_header.num_samples);
+    data_ptr = &data[SLA_HEADER_CRC16_CALC_START_OFFSET - 2];
+    SLAByteArray_PutUint16(data_ptr, SLAUtility_CalculateCRC16(
+          &data[SLA_HEADER_CRC16_CALC_START_OFFSET], SLA_HEADER_SIZE_V1 - SLA_HEADER_CRC16_CALC_START_OFFSET));
+
+    Test_AssertEqual(
+        SLADecoder_DecodeHeader(data, sizeof(data), &get_header),
+        SLA_APIRESULT_OK);
+    Test_AssertEqual(get_header.header_size, SLA_HEADER_SIZE_V1);
+    Test_AssertCondition(get_header.num_samples == write_header.num_samples);
+    Test_AssertEqual(write_header.wave_format.sampling_rate,      get_header.wave_format.sampling_rate);
+    Test_AssertEqual(write_header.encode_param.max_num_block_samples, get_header.encode_param.max_num_block_samples);
+    Test_AssertEqual(write_header.num_blocks,                     get_header.num_blocks);
+    Test_AssertEqual(write_header.max_block_size,                 get_header.max_block_size);
+
+    /* バージョン1で不明なサンプル数は無効値に読み替える */
+    data_ptr = &data[15];
+    SLAByteArray_PutUint32(data_ptr, 0xFFFFFFFFUL);
+    data_ptr = &data[SLA_HEADER_CRC16_CALC_START_OFFSET - 2];
+    SLAByteArray_PutUint16(data_ptr, SLAUtility_CalculateCRC16(
+          &data[SLA_HEADER_CRC16_CALC_START_OFFSET], SLA_HEADER_SIZE_V1 - SLA_HEADER_CRC16_CALC_START_OFFSET));
+    Test_AssertEqual(
+        SLADecoder_DecodeHeader(data, sizeof(data), &get_header),
+        SLA_APIRESULT_OK);
+    Test_AssertCondition(get_header.num_samples == SLA_NUM_SAMPLES_INVALID);
   }
 
   /* 簡単な失敗テスト */
@@ -572,6 +769,12 @@ static void testSLAStreamingDecoder_CreateDestroyTest(void *obj)
     config.decode_interval_hz = 0.0f;
     decoder = SLAStreamingDecoder_Create(&config);
     Test_AssertCondition(decoder == NULL);
+
+    /* コアデコーダのコンフィグが異常 */
+    SLAStreamingDecoder_SetDefaultConfig(&config);
+    config.core_config.max_num_block_samples = SLA_MAX_NUM_BLOCK_SAMPLES + 1;
+    decoder = SLAStreamingDecoder_Create(&config);
+    Test_AssertCondition(decoder == NULL);
   }
 }
 
@@ -650,22 +853,88 @@ static void testSLAStreamingDecoder_GetDecodeInformationTest(void *obj)
     Test_AssertEqual(SLAStreamingDecoder_GetRemainDataSize(decoder, &remain_data_size), SLA_APIRESULT_OK);
     Test_AssertEqual(remain_data_size, 10);
 
-    /* データ回収 */
-    Test_AssertEqual(SLAStreamingDecoder_CollectDataFragment(decoder, &get_data, &collect_data_size), SLA_APIRESULT_OK);
-    Test_AssertCondition(get_data == &data[0]);
-    Test_AssertEqual(collect_data_size, 10);
+    /* デコードしていないので回収できない */
+    Test_AssertEqual(SLAStreamingDecoder_CollectDataFragment(decoder, &get_data, &collect_data_size), SLA_APIRESULT_NO_DATA_FRAGMENTS);
 
     /* 残りは10 */
     Test_AssertEqual(SLAStreamingDecoder_GetRemainDataSize(decoder, &remain_data_size), SLA_APIRESULT_OK);
     Test_AssertEqual(remain_data_size, 10);
 
-    /* 連続バッファ内で10バイト消費 */
-    decoder->data_buffer_provided_size -= 10;
+    /* データ片を10バイト消費 */
+    Test_AssertEqual(SLADataPacketQueue_GetDataFragment(decoder->queue, &get_data, &collect_data_size, 10), SLA_DATAPACKETQUEUE_APIRESULT_OK);
 
     /* 残りは0 */
     Test_AssertEqual(SLAStreamingDecoder_GetRemainDataSize(decoder, &remain_data_size), SLA_APIRESULT_OK);
     Test_AssertEqual(remain_data_size, 0);
 
+    /* 消費済みのデータ片が回収できる */
+    Test_AssertEqual(SLAStreamingDecoder_CollectDataFragment(decoder, &get_data, &collect_data_size), SLA_APIRESULT_OK);
+    Test_AssertCondition(get_data == &data[0]);
+    Test_AssertEqual(collect_data_size, 10);
+
+    SLAStreamingDecoder_Destroy(decoder);
+  }
+
+  /* ブロックヘッダに基づく必要データサイズ・デコード可能サンプル数のテスト */
+  {
+    struct SLAStreamingDecoderConfig  config;
+    struct SLAStreamingDecoder*       decoder;
+    uint32_t necessary_data_size, decodable_num_samples;
+    uint8_t data[36];
+
+    /* 20バイト100サンプルのブロックと16バイト50サンプルのブロックを並べる */
+    memset(data, 0, sizeof(data));
+    SLAByteArray_WriteUint16(&data[0], SLA_BLOCK_SYNC_CODE);
+    SLAByteArray_WriteUint32(&data[2], 20 - 6);
+    SLAByteArray_WriteUint16(&data[8], 100);
+    SLAByteArray_WriteUint16(&data[20], SLA_BLOCK_SYNC_CODE);
+    SLAByteArray_WriteUint32(&data[22], 16 - 6);
+    SLAByteArray_WriteUint16(&data[28], 50);
+
+    SLAStreamingDecoder_SetDefaultConfig(&config);
+    decoder = SLAStreamingDecoder_Create(&config);
+
+    /* 何もしていないのでブロックサイズ確定まで6バイト必要 */
+    Test_AssertEqual(SLAStreamingDecoder_GetNecessaryDataSize(decoder, &necessary_data_size), SLA_APIRESULT_OK);
+    Test_AssertEqual(necessary_data_size, 6);
+    Test_AssertEqual(SLAStreamingDecoder_GetDecodableNumSamples(decoder, &decodable_num_samples), SLA_APIRESULT_OK);
+    Test_AssertEqual(decodable_num_samples, 0);
+
+    /* ブロックサイズが読めない */
+    Test_AssertEqual(SLAStreamingDecoder_AppendDataFragment(decoder, &data[0], 3), SLA_APIRESULT_OK);
+    Test_AssertEqual(SLAStreamingDecoder_GetNecessaryDataSize(decoder, &necessary_data_size), SLA_APIRESULT_OK);
+    Test_AssertEqual(necessary_data_size, 3);
+
+    /* データ片をまたいでブロックサイズが読める */
+    Test_AssertEqual(SLAStreamingDecoder_AppendDataFragment(decoder, &data[3], 7), SLA_APIRESULT_OK);
+    Test_AssertEqual(SLAStreamingDecoder_GetNecessaryDataSize(decoder, &necessary_data_size), SLA_APIRESULT_OK);
+    Test_AssertEqual(necessary_data_size, 10);
+    Test_AssertEqual(SLAStreamingDecoder_GetDecodableNumSamples(decoder, &decodable_num_samples), SLA_APIRESULT_OK);
+    Test_AssertEqual(decodable_num_samples, 0);
+
+    /* 1ブロック揃った */
+    Test_AssertEqual(SLAStreamingDecoder_AppendDataFragment(decoder, &data[10], 14), SLA_APIRESULT_OK);
+    Test_AssertEqual(SLAStreamingDecoder_GetNecessaryDataSize(decoder, &necessary_data_size), SLA_APIRESULT_OK);
+    Test_AssertEqual(necessary_data_size, 0);
+    Test_AssertEqual(SLAStreamingDecoder_GetDecodableNumSamples(decoder, &decodable_num_samples), SLA_APIRESULT_OK);
+    Test_AssertEqual(decodable_num_samples, 100);
+
+    /* 2ブロック揃った */
+    Test_AssertEqual(SLAStreamingDecoder_AppendDataFragment(decoder, &data[24], 12), SLA_APIRESULT_OK);
+    Test_AssertEqual(SLAStreamingDecoder_GetDecodableNumSamples(decoder, &decodable_num_samples), SLA_APIRESULT_OK);
+    Test_AssertEqual(decodable_num_samples, 150);
+
+    /* デコード済みのサンプルは減じられる */
+    decoder->current_block_sample_offset = 40;
+    Test_AssertEqual(SLAStreamingDecoder_GetDecodableNumSamples(decoder, &decodable_num_samples), SLA_APIRESULT_OK);
+    Test_AssertEqual(decodable_num_samples, 110);
+
+    /* 不正な引数 */
+    Test_AssertEqual(SLAStreamingDecoder_GetNecessaryDataSize(NULL, &necessary_data_size), SLA_APIRESULT_INVALID_ARGUMENT);
+    Test_AssertEqual(SLAStreamingDecoder_GetNecessaryDataSize(decoder, NULL), SLA_APIRESULT_INVALID_ARGUMENT);
+    Test_AssertEqual(SLAStreamingDecoder_GetDecodableNumSamples(NULL, &decodable_num_samples), SLA_APIRESULT_INVALID_ARGUMENT);
+    Test_AssertEqual(SLAStreamingDecoder_GetDecodableNumSamples(decoder, NULL), SLA_APIRESULT_INVALID_ARGUMENT);
+
     SLAStreamingDecoder_Destroy(decoder);
   }
 
@@ -799,7 +1068,7 @@ static void testSLAStreamingDecoder_AppendCollectDataFragmentTest(void* obj)
     struct SLAStreamingDecoderConfig  config;
     struct SLAStreamingDecoder*       decoder;
     uint8_t *data_fragment;
-    uint32_t tmp_data_size;
+    uint32_t tmp_data_size, remain_size;
 
     /* データを突っ込んで見る */
     SLAStreamingDecoder_SetDefaultConfig(&config);
@@ -813,9 +1082,10 @@ static void testSLAStreamingDecoder_AppendCollectDataFragmentTest(void* obj)
     Test_AssertEqual(
         SLAStreamingDecoder_AppendDataFragment(decoder, data_fragment, tmp_data_size),
         SLA_APIRESULT_OK);
-    Test_AssertEqual(
-        memcmp(decoder->data_buffer, data_fragment, sizeof(uint8_t) * tmp_data_size), 0);
-    Test_AssertEqual(decoder->data_buffer_provided_size, tmp_data_size);
+    /* データ片はコピーされずキューで参照される */
+    Test_AssertEqual(decoder->data_buffer_provided_size, 0);
+    SLAStreamingDecoder_GetRemainDataSize(decoder, &remain_size);
+    Test_AssertEqual(remain_size, tmp_data_size);
     free(data_fragment);
     SLAStreamingDecoder_Destroy(decoder);
 
@@ -831,9 +1101,7 @@ static void testSLAStreamingDecoder_AppendCollectDataFragmentTest(void* obj)
     Test_AssertEqual(
         SLAStreamingDecoder_AppendDataFragment(decoder, data_fragment, tmp_data_size),
         SLA_APIRESULT_OK);
-    Test_AssertEqual(
-        memcmp(decoder->data_buffer, data_fragment, sizeof(uint8_t) * tmp_data_size), 0);
-    Test_AssertEqual(decoder->data_buffer_provided_size, tmp_data_size);
+    Test_AssertEqual(decoder->data_buffer_provided_size, 0);
     SLAStreamingDecoder_GetRemainDataSize(decoder, &tmp_data_size);
     Test_AssertEqual(tmp_data_size, 0);
     free(data_fragment);
@@ -912,14 +1180,19 @@ static void testSLAStreamingDecoder_AppendCollectDataFragmentTest(void* obj)
       data_fragment[i] = rand() & 0xFF;
     }
 
-    /* 投入したデータは戻ってくるか？ */
+    /* 投入したデータは消費後に戻ってくるか？ */
     Test_AssertEqual(
         SLAStreamingDecoder_AppendDataFragment(decoder, data_fragment, tmp_data_size), 
         SLA_APIRESULT_OK);
-    Test_AssertEqual(decoder->data_buffer_provided_size, tmp_data_size);
     Test_AssertEqual(
-        SLAStreamingDecoder_CollectDataFragment(decoder, &tmp_data_fragment, &tmp_data_size), SLA_APIRESULT_OK);
-    Test_AssertEqual(memcmp(data_fragment, tmp_data_fragment, tmp_data_size), 0);
+        SLAStreamingDecoder_CollectDataFragment(decoder, &tmp_data_fragment, &tmp_output_size), SLA_APIRESULT_NO_DATA_FRAGMENTS);
+    Test_AssertEqual(
+        SLADataPacketQueue_GetDataFragment(decoder->queue, &tmp_data_fragment, &tmp_output_size, tmp_data_size),
+        SLA_DATAPACKETQUEUE_APIRESULT_OK);
+    Test_AssertEqual(
+        SLAStreamingDecoder_CollectDataFragment(decoder, &tmp_data_fragment, &tmp_output_size), SLA_APIRESULT_OK);
+    Test_AssertCondition(tmp_data_fragment == data_fragment);
+    Test_AssertEqual(tmp_output_size, tmp_data_size);
 
     free(data_fragment);
     SLAStreamingDecoder_Destroy(decoder);
@@ -938,7 +1211,12 @@ static void testSLAStreamingDecoder_AppendCollectDataFragmentTest(void* obj)
     Test_AssertEqual(
         SLAStreamingDecoder_AppendDataFragment(decoder, data_fragment, tmp_data_size), 
         SLA_APIRESULT_OK);
-    Test_AssertEqual(decoder->data_buffer_provided_size, 2 * tmp_data_size);
+    Test_AssertEqual(
+        SLADataPacketQueue_GetDataFragment(decoder->queue, &tmp_data_fragment, &tmp_output_size, tmp_data_size),
+        SLA_DATAPACKETQUEUE_APIRESULT_OK);
+    Test_AssertEqual(
+        SLADataPacketQueue_GetDataFragment(decoder->queue, &tmp_data_fragment, &tmp_output_size, tmp_data_size),
+        SLA_DATAPACKETQUEUE_APIRESULT_OK);
     Test_AssertEqual(
         SLAStreamingDecoder_CollectDataFragment(decoder, &tmp_data_fragment, &tmp_output_size), SLA_APIRESULT_OK);
     Test_AssertEqual(tmp_data_size, tmp_output_size);
@@ -947,11 +1225,58 @@ static void testSLAStreamingDecoder_AppendCollectDataFragmentTest(void* obj)
         SLAStreamingDecoder_CollectDataFragment(decoder, &tmp_data_fragment, &tmp_output_size), SLA_APIRESULT_OK);
     Test_AssertEqual(tmp_data_size, tmp_output_size);
     Test_AssertEqual(memcmp(data_fragment, tmp_data_fragment, tmp_data_size), 0);
+    Test_AssertEqual(
+        SLAStreamingDecoder_CollectDataFragment(decoder, &tmp_data_fragment, &tmp_output_size), SLA_APIRESULT_NO_DATA_FRAGMENTS);
 
     free(data_fragment);
     SLAStreamingDecoder_Destroy(decoder);
   }
 
+  /* 回収しないデータ片が溜まると供給できなくなり、回収すれば再び供給できるか？ */
+  {
+    uint32_t num_appended;
+    struct SLAStreamingDecoderConfig  config;
+    struct SLAStreamingDecoder*       decoder;
+    uint8_t data_fragment[16];
+    const uint8_t* tmp_data_fragment;
+    uint32_t tmp_output_size;
+
+    SLAStreamingDecoder_SetDefaultConfig(&config);
+    decoder = SLAStreamingDecoder_Create(&config);
+    memset(data_fragment, 0, sizeof(data_fragment));
+
+    num_appended = 0;
+    while (SLAStreamingDecoder_AppendDataFragment(decoder,
+          data_fragment, sizeof(data_fragment)) == SLA_APIRESULT_OK) {
+      num_appended++;
+    }
+    Test_AssertCondition(num_appended > 0);
+    Test_AssertEqual(SLAStreamingDecoder_AppendDataFragment(decoder,
+          data_fragment, sizeof(data_fragment)), SLA_APIRESULT_EXCEED_HANDLE_CAPACITY);
+
+    /* 消費済みの2つを回収すると2つ供給できる */
+    Test_AssertEqual(
+        SLADataPacketQueue_GetDataFragment(decoder->queue, &tmp_data_fragment, &tmp_output_size, sizeof(data_fragment)),
+        SLA_DATAPACKETQUEUE_APIRESULT_OK);
+    Test_AssertEqual(
+        SLADataPacketQueue_GetDataFragment(decoder->queue, &tmp_data_fragment, &tmp_output_size, sizeof(data_fragment)),
+        SLA_DATAPACKETQUEUE_APIRESULT_OK);
+    Test_AssertEqual(
+        SLAStreamingDecoder_CollectDataFragment(decoder, &tmp_data_fragment, &tmp_output_size), SLA_APIRESULT_OK);
+    Test_AssertEqual(
+        SLAStreamingDecoder_CollectDataFragment(decoder, &tmp_data_fragment, &tmp_output_size), SLA_APIRESULT_OK);
+    Test_AssertEqual(
+        SLAStreamingDecoder_CollectDataFragment(decoder, &tmp_data_fragment, &tmp_output_size), SLA_APIRESULT_NO_DATA_FRAGMENTS);
+    Test_AssertEqual(SLAStreamingDecoder_AppendDataFragment(decoder,
+          data_fragment, sizeof(data_fragment)), SLA_APIRESULT_OK);
+    Test_AssertEqual(SLAStreamingDecoder_AppendDataFragment(decoder,
+          data_fragment, sizeof(data_fragment)), SLA_APIRESULT_OK);
+    Test_AssertEqual(SLAStreamingDecoder_AppendDataFragment(decoder,
+          data_fragment, sizeof(data_fragment)), SLA_APIRESULT_EXCEED_HANDLE_CAPACITY);
+
+    SLAStreamingDecoder_Destroy(decoder);
+  }
+
 
   /* データ片回収失敗テスト */
   {
@@ -3,11 +3,15 @@
 #include "SLADecoder.h"
 #include "SLAInternal.h"
 #include "SLAUtility.h"
+#include "SLAByteArray.h"
+#include "SLA_TestUtility.h"
 
 #include <stdlib.h>
 #include <math.h>
 #include <assert.h>
 #include <stdio.h>
+#include <string.h>
+#include <string.h>
 
 /* このテストは様々な波形がエンコード -> デコードが元に戻るかを確認する */
 /* ユニットテストは短く終わるのが大原則なので長尺の入力はNG */
@@ -372,7 +376,7 @@ static int32_t testSLAEncodeDecode_DoStreamingDecodeTestCase(const struct Encode
   double        **input_double;
   int32_t       **input;
   uint8_t       *data;
-  int32_t       **output;
+  int32_t       **output, **sub_output;
   SLAApiResult  api_ret;
   struct SLAHeaderInfo header;
 
@@ -381,6 +385,7 @@ static int32_t testSLAEncodeDecode_DoStreamingDecodeTestCase(const struct Encode
   struct SLAStreamingDecoderConfig streaming_decoder_config;
   struct SLAEncoder* encoder;
   struct SLAStreamingDecoder* decoder;
+  struct SLAStreamingDecoder* sub_decoder;
 
   assert(test_case != NULL);
   assert(test_case->num_samples <= (1UL << 15));  /* 長過ぎる入力はNG */
@@ -412,17 +417,21 @@ static int32_t testSLAEncodeDecode_DoStreamingDecodeTestCase(const struct Encode
   input_double  = (double **)malloc(sizeof(double*) * num_channels);
   input         = (int32_t **)malloc(sizeof(int32_t*) * num_channels);
   output        = (int32_t **)malloc(sizeof(int32_t*) * num_channels);
+  sub_output    = (int32_t **)malloc(sizeof(int32_t*) * num_channels);
   data          = (uint8_t *)malloc(data_size);
   for (ch = 0; ch < num_channels; ch++) {
     input_double[ch]  = (double *)malloc(sizeof(double) * num_samples);
     input[ch]         = (int32_t *)malloc(sizeof(int32_t) * num_samples);
     output[ch]        = (int32_t *)malloc(sizeof(int32_t) * num_samples);
+    sub_output[ch]    = (int32_t *)malloc(sizeof(int32_t) * num_samples);
   }
 
   /* エンコード・デコードハンドル作成 */
   encoder = SLAEncoder_Create(&encoder_config);
   decoder = SLAStreamingDecoder_Create(&streaming_decoder_config);
-  if (encoder == NULL || decoder == NULL) {
+  /* 交互に動かしても互いに干渉しないか確かめるためのデコーダ */
+  sub_decoder = SLAStreamingDecoder_Create(&streaming_decoder_config);
+  if (encoder == NULL || decoder == NULL || sub_decoder == NULL) {
     ret = 1;
     goto EXIT;
   }
@@ -464,12 +473,14 @@ static int32_t testSLAEncodeDecode_DoStreamingDecodeTestCase(const struct Encode
   }
 
   /* デコーダにパラメータを設定 */
-  if ((api_ret = SLAStreamingDecoder_SetWaveFormat(decoder, &header.wave_format)) != SLA_APIRESULT_OK) {
+  if (((api_ret = SLAStreamingDecoder_SetWaveFormat(decoder, &header.wave_format)) != SLA_APIRESULT_OK)
+      || ((api_ret = SLAStreamingDecoder_SetWaveFormat(sub_decoder, &header.wave_format)) != SLA_APIRESULT_OK)) {
     fprintf(stderr, "Set waveformat failed! ret:%d \n", api_ret);
     ret = 6;
     goto EXIT;
   }
-  if ((api_ret = SLAStreamingDecoder_SetEncodeParameter(decoder, &header.encode_param)) != SLA_APIRESULT_OK) {
+  if (((api_ret = SLAStreamingDecoder_SetEncodeParameter(decoder, &header.encode_param)) != SLA_APIRESULT_OK)
+      || ((api_ret = SLAStreamingDecoder_SetEncodeParameter(sub_decoder, &header.encode_param)) != SLA_APIRESULT_OK)) {
     fprintf(stderr, "Set encode parameter failed! ret:%d \n", api_ret);
     ret = 7;
     goto EXIT;
@@ -480,10 +491,11 @@ static int32_t testSLAEncodeDecode_DoStreamingDecodeTestCase(const struct Encode
   data_progress = SLA_HEADER_SIZE;
   while (sample_progress < num_samples) {
     uint32_t ch;
-    uint32_t put_data_size, estimate_min_data_size, tmp_output_samples;
+    uint32_t put_data_size, estimate_min_data_size, tmp_output_samples, sub_output_samples;
     uint32_t dummy_out_size;
     const uint8_t* dummy_out_ptr;
-    int32_t  *output_ptr[SLA_MAX_CHANNELS];
+    int32_t  *output_ptr[SLA_MAX_NUM_CHANNELS];
+    int32_t  *sub_output_ptr[SLA_MAX_NUM_CHANNELS];
 
     /* 供給データサイズの確定 */
     if (sample_progress == 0) {
@@ -495,26 +507,49 @@ static int32_t testSLAEncodeDecode_DoStreamingDecodeTestCase(const struct Encode
     put_data_size = SLAUTILITY_MIN(estimate_min_data_size, encoded_size - data_progress);
 
     /* データ供給 */
-    if ((api_ret = SLAStreamingDecoder_AppendDataFragment(decoder,
-            &data[data_progress], put_data_size)) != SLA_APIRESULT_OK) {
+    if (((api_ret = SLAStreamingDecoder_AppendDataFragment(decoder,
+              &data[data_progress], put_data_size)) != SLA_APIRESULT_OK)
+        || ((api_ret = SLAStreamingDecoder_AppendDataFragment(sub_decoder,
+              &data[data_progress], put_data_size)) != SLA_APIRESULT_OK)) {
       fprintf(stderr, "Data append failed! ret:%d \n", api_ret);
       ret = 8;
       goto EXIT;
     }
 
     /* データを回収できるなら回収しておく */
-    SLAStreamingDecoder_CollectDataFragment(decoder, &dummy_out_ptr, &dummy_out_size);
+    while (SLAStreamingDecoder_CollectDataFragment(decoder,
+          &dummy_out_ptr, &dummy_out_size) == SLA_APIRESULT_OK) ;
+    while (SLAStreamingDecoder_CollectDataFragment(sub_decoder,
+          &dummy_out_ptr, &dummy_out_size) == SLA_APIRESULT_OK) ;
 
     /* ストリーミングデコード */
     for (ch = 0; ch < num_channels; ch++) {
-      output_ptr[ch] = &output[ch][sample_progress];
+      output_ptr[ch]      = &output[ch][sample_progress];
+      sub_output_ptr[ch]  = &sub_output[ch][sample_progress];
+    }
+    /* 補足）CRCチェック有効なので、ブロック全体が揃うまではデータ不足が返る */
+    api_ret = SLAStreamingDecoder_Decode(decoder,
+        output_ptr, num_samples - sample_progress, &tmp_output_samples);
+    if ((api_ret == SLA_APIRESULT_INSUFFICIENT_DATA_SIZE) && ((data_progress + put_data_size) < encoded_size)) {
+      tmp_output_samples = 0;
+    } else if (api_ret != SLA_APIRESULT_OK) {
+      fprintf(stderr, "Streaming Decode failed! ret:%d \n", api_ret);
+      ret = 9;
+      goto EXIT;
     }
-    if ((api_ret = SLAStreamingDecoder_Decode(decoder,
-            output_ptr, num_samples - sample_progress, &tmp_output_samples)) != SLA_APIRESULT_OK) {
+    api_ret = SLAStreamingDecoder_Decode(sub_decoder,
+        sub_output_ptr, num_samples - sample_progress, &sub_output_samples);
+    if ((api_ret == SLA_APIRESULT_INSUFFICIENT_DATA_SIZE) && ((data_progress + put_data_size) < encoded_size)) {
+      sub_output_samples = 0;
+    } else if (api_ret != SLA_APIRESULT_OK) {
       fprintf(stderr, "Streaming Decode failed! ret:%d \n", api_ret);
       ret = 9;
       goto EXIT;
     }
+    if (tmp_output_samples != sub_output_samples) {
+      ret = 10;
+      goto EXIT;
+    }
 
     /* 出力を進める */
     data_progress     += put_data_size;
@@ -524,7 +559,7 @@ static int32_t testSLAEncodeDecode_DoStreamingDecodeTestCase(const struct Encode
   /* 一致確認 */
   for (ch = 0; ch < num_channels; ch++) {
     for (smpl = 0; smpl < num_samples; smpl++) {
-      if (input[ch][smpl] != output[ch][smpl]) {
+      if ((input[ch][smpl] != output[ch][smpl]) || (input[ch][smpl] != sub_output[ch][smpl])) {
         printf("%5d %12d vs %12d \n", smpl, input[ch][smpl], output[ch][smpl]);
         ret = 7;
         goto EXIT;
@@ -539,16 +574,19 @@ EXIT:
   /* ハンドル開放 */
   SLAEncoder_Destroy(encoder);
   SLAStreamingDecoder_Destroy(decoder);
+  SLAStreamingDecoder_Destroy(sub_decoder);
 
   /* 一時領域の開放 */
   for (ch = 0; ch < num_channels; ch++) {
     free(input_double[ch]);
     free(input[ch]);
     free(output[ch]);
+    free(sub_output[ch]);
   }
   free(input_double);
   free(input);
   free(output);
+  free(sub_output);
   free(data);
 
   return ret;
@@ -1153,6 +1191,50 @@ static void testSLAEncodeDecode_EncodeDecodeTest(void *obj)
       { 4, 1, 4, SLA_CHPROCESSMETHOD_NONE, SLA_WINDOWFUNCTIONTYPE_SIN, 16384 },
       4096,
       testSLAEncodeDecode_GenerateGaussNoise },
+
+    /* 次数固定の合成関数の部 */
+    { { 2, 16,  44100,  0 },
+      {  8, 1, 4, SLA_CHPROCESSMETHOD_NONE, SLA_WINDOWFUNCTIONTYPE_RECTANGULAR, 4096 },
+      16384,
+      testSLAEncodeDecode_GenerateChirp },
+    { { 2, 24,  48000,  0 },
+      {  8, 1, 8, SLA_CHPROCESSMETHOD_STEREO_MS, SLA_WINDOWFUNCTIONTYPE_SIN, 12288 },
+      16384,
+      testSLAEncodeDecode_GenerateGaussNoise },
+    { { 2, 16,  44100,  0 },
+      { 16, 1, 8, SLA_CHPROCESSMETHOD_STEREO_MS, SLA_WINDOWFUNCTIONTYPE_SIN, 12288 },
+      16384,
+      testSLAEncodeDecode_GenerateSinWave },
+    { { 2, 24,  96000,  0 },
+      { 16, 1, 8, SLA_CHPROCESSMETHOD_STEREO_MS, SLA_WINDOWFUNCTIONTYPE_SIN, 12288 },
+      16384,
+      testSLAEncodeDecode_GenerateChirp },
+    { { 2, 16,  44100,  0 },
+      { 32, 3, 8, SLA_CHPROCESSMETHOD_STEREO_MS, SLA_WINDOWFUNCTIONTYPE_SIN, 12288 },
+      16384,
+      testSLAEncodeDecode_GenerateGaussNoise },
+    { { 2, 24, 192000,  0 },
+      { 32, 3, 8, SLA_CHPROCESSMETHOD_STEREO_MS, SLA_WINDOWFUNCTIONTYPE_SIN, 12288 },
+      16384,
+      testSLAEncodeDecode_GenerateChirp },
+
+    /* 多チャンネルの部 */
+    { { 16, 16,  48000,  0 },
+      { 8, 1, 8, SLA_CHPROCESSMETHOD_NONE, SLA_WINDOWFUNCTIONTYPE_SIN, 4096 },
+      8192,
+      testSLAEncodeDecode_GenerateChirp },
+    { { 32, 24,  48000,  0 },
+      { 8, 1, 8, SLA_CHPROCESSMETHOD_NONE, SLA_WINDOWFUNCTIONTYPE_SIN, 4096 },
+      8192,
+      testSLAEncodeDecode_GenerateGaussNoise },
+    { { 64, 16,  48000,  0 },
+      { 8, 1, 8, SLA_CHPROCESSMETHOD_NONE, SLA_WINDOWFUNCTIONTYPE_SIN, 4096 },
+      8192,
+      testSLAEncodeDecode_GenerateSinWave },
+    { { 64,  8,  44100,  0 },
+      { 8, 1, 8, SLA_CHPROCESSMETHOD_NONE, SLA_WINDOWFUNCTIONTYPE_SIN, 4096 },
+      8192,
+      testSLAEncodeDecode_GenerateWhiteNoise },
   };
 
   /* テストケース数 */
@@ -1389,6 +1471,50 @@ static void testSLAEncodeDecode_EncodeStreamingDecodeTest(void *obj)
       { 4, 1, 4, SLA_CHPROCESSMETHOD_STEREO_MS, SLA_WINDOWFUNCTIONTYPE_SIN, 8192 },
       32768,
       testSLAEncodeDecode_GenerateGaussNoise },
+
+    /* 次数固定の合成関数の部 */
+    { { 2, 16,  44100,  0 },
+      {  8, 1, 4, SLA_CHPROCESSMETHOD_NONE, SLA_WINDOWFUNCTIONTYPE_RECTANGULAR, 4096 },
+      16384,
+      testSLAEncodeDecode_GenerateChirp },
+    { { 2, 24,  48000,  0 },
+      {  8, 1, 8, SLA_CHPROCESSMETHOD_STEREO_MS, SLA_WINDOWFUNCTIONTYPE_SIN, 12288 },
+      16384,
+      testSLAEncodeDecode_GenerateGaussNoise },
+    { { 2, 16,  44100,  0 },
+      { 16, 1, 8, SLA_CHPROCESSMETHOD_STEREO_MS, SLA_WINDOWFUNCTIONTYPE_SIN, 12288 },
+      16384,
+      testSLAEncodeDecode_GenerateSinWave },
+    { { 2, 24,  96000,  0 },
+      { 16, 1, 8, SLA_CHPROCESSMETHOD_STEREO_MS, SLA_WINDOWFUNCTIONTYPE_SIN, 12288 },
+      16384,
+      testSLAEncodeDecode_GenerateChirp },
+    { { 2, 16,  44100,  0 },
+      { 32, 3, 8, SLA_CHPROCESSMETHOD_STEREO_MS, SLA_WINDOWFUNCTIONTYPE_SIN, 12288 },
+      16384,
+      testSLAEncodeDecode_GenerateGaussNoise },
+    { { 2, 24, 192000,  0 },
+      { 32, 3, 8, SLA_CHPROCESSMETHOD_STEREO_MS, SLA_WINDOWFUNCTIONTYPE_SIN, 12288 },
+      16384,
+      testSLAEncodeDecode_GenerateChirp },
+
+    /* 多チャンネルの部 */
+    { { 16, 16,  48000,  0 },
+      { 8, 1, 8, SLA_CHPROCESSMETHOD_NONE, SLA_WINDOWFUNCTIONTYPE_SIN, 4096 },
+      8192,
+      testSLAEncodeDecode_GenerateChirp },
+    { { 32, 24,  48000,  0 },
+      { 8, 1, 8, SLA_CHPROCESSMETHOD_NONE, SLA_WINDOWFUNCTIONTYPE_SIN, 4096 },
+      8192,
+      testSLAEncodeDecode_GenerateGaussNoise },
+    { { 64, 16,  48000,  0 },
+      { 8, 1, 8, SLA_CHPROCESSMETHOD_NONE, SLA_WINDOWFUNCTIONTYPE_SIN, 4096 },
+      8192,
+      testSLAEncodeDecode_GenerateSinWave },
+    { { 64,  8,  44100,  0 },
+      { 8, 1, 8, SLA_CHPROCESSMETHOD_NONE, SLA_WINDOWFUNCTIONTYPE_SIN, 4096 },
+      8192,
+      testSLAEncodeDecode_GenerateWhiteNoise },
   };
 
   /* テストケース数 */
@@ -1405,6 +1531,2079 @@ static void testSLAEncodeDecode_EncodeStreamingDecodeTest(void *obj)
   }
 }
 
+/* 指定サンプル数ちょうどのストリーミングデコードのテスト */
+static void testSLAEncodeDecode_StreamingDecodeFramesTest(void *obj)
+{
+  static const struct EncodeDecodeTestCase test_case = {
+    { 2, 16, 44100, 0 },
+    { 16, 1, 8, SLA_CHPROCESSMETHOD_STEREO_MS, SLA_WINDOWFUNCTIONTYPE_SIN, 4096 },
+    16384,
+    testSLAEncodeDecode_GenerateChirp };
+  const uint32_t num_frames = 64;
+  uint32_t ch, smpl, num_channels, num_samples, data_size, encoded_size;
+  double   **input_double;
+  int32_t  **input, **output;
+  uint8_t  *data;
+  struct SLAEncoderConfig           encoder_config;
+  struct SLAStreamingDecoderConfig  config;
+  struct SLAHeaderInfo              header;
+  struct SLAEncoder*                encoder;
+
+  TEST_UNUSED_PARAMETER(obj);
+
+  num_samples   = test_case.num_samples;
+  num_channels  = test_case.wave_format.num_channels;
+  data_size     = SLA_HEADER_SIZE + SLA_CalculateSufficientBlockSize(num_channels, num_samples, test_case.wave_format.bit_per_sample);
+
+  /* 一時領域の割り当て */
+  input_double  = (double **)malloc(sizeof(double*) * num_channels);
+  input         = (int32_t **)malloc(sizeof(int32_t*) * num_channels);
+  output        = (int32_t **)malloc(sizeof(int32_t*) * num_channels);
+  data          = (uint8_t *)malloc(data_size);
+  for (ch = 0; ch < num_channels; ch++) {
+    input_double[ch]  = (double *)malloc(sizeof(double) * num_samples);
+    input[ch]         = (int32_t *)malloc(sizeof(int32_t) * num_samples);
+    output[ch]        = (int32_t *)malloc(sizeof(int32_t) * num_samples);
+  }
+
+  /* エンコード */
+  encoder_config.max_num_channels         = num_channels;
+  encoder_config.max_num_block_samples    = test_case.encode_parameter.max_num_block_samples;
+  encoder_config.max_parcor_order         = test_case.encode_parameter.parcor_order;
+  encoder_config.max_longterm_order       = test_case.encode_parameter.longterm_order;
+  encoder_config.max_lms_order_per_filter = test_case.encode_parameter.lms_order_per_filter;
+  encoder_config.verpose_flag             = 0;
+  encoder = SLAEncoder_Create(&encoder_config);
+  test_case.gen_wave_func(input_double, num_channels, num_samples);
+  testSLAEncodeDecode_InputDoubleToInputFixedFloat(
+      &test_case.wave_format, input_double, input, num_channels, num_samples);
+  Test_AssertEqual(SLAEncoder_SetWaveFormat(encoder, &test_case.wave_format), SLA_APIRESULT_OK);
+  Test_AssertEqual(SLAEncoder_SetEncodeParameter(encoder, &test_case.encode_parameter), SLA_APIRESULT_OK);
+  Test_AssertEqual(SLAEncoder_EncodeWhole(encoder,
+        (const int32_t **)input, num_samples, data, data_size, &encoded_size), SLA_APIRESULT_OK);
+  Test_AssertEqual(SLADecoder_DecodeHeader(data, encoded_size, &header), SLA_APIRESULT_OK);
+
+  SLAStreamingDecoder_SetDefaultConfig(&config);
+  config.core_config.enable_crc_check = 1;
+
+  /* 全データを一度に供給し、固定サンプル数ずつ取り出す */
+  {
+    struct SLAStreamingDecoder* decoder;
+    int32_t* output_ptr[SLA_MAX_NUM_CHANNELS];
+    uint32_t progress, num_decode;
+    int32_t is_ok;
+
+    decoder = SLAStreamingDecoder_Create(&config);
+    Test_AssertEqual(SLAStreamingDecoder_SetWaveFormat(decoder, &header.wave_format), SLA_APIRESULT_OK);
+    Test_AssertEqual(SLAStreamingDecoder_SetEncodeParameter(decoder, &header.encode_param), SLA_APIRESULT_OK);
+    Test_AssertEqual(SLAStreamingDecoder_AppendDataFragment(decoder,
+          &data[SLA_HEADER_SIZE], encoded_size - SLA_HEADER_SIZE), SLA_APIRESULT_OK);
+
+    is_ok = 1;
+    for (progress = 0; progress < num_samples; progress += num_decode) {
+      num_decode = SLAUTILITY_MIN(num_frames, num_samples - progress);
+      for (ch = 0; ch < num_channels; ch++) {
+        output_ptr[ch] = &output[ch][progress];
+      }
+      if (SLAStreamingDecoder_DecodeFrames(decoder, output_ptr, num_decode) != SLA_APIRESULT_OK) {
+        is_ok = 0;
+        break;
+      }
+    }
+    Test_AssertEqual(is_ok, 1);
+
+    /* これ以上はデコードできない */
+    Test_AssertEqual(SLAStreamingDecoder_DecodeFrames(decoder, output_ptr, 1), SLA_APIRESULT_INSUFFICIENT_DATA_SIZE);
+
+    /* 一致確認 */
+    for (ch = 0; ch < num_channels; ch++) {
+      for (smpl = 0; smpl < num_samples; smpl++) {
+        if (input[ch][smpl] != output[ch][smpl]) {
+          is_ok = 0;
+        }
+      }
+    }
+    Test_AssertEqual(is_ok, 1);
+
+    SLAStreamingDecoder_Destroy(decoder);
+  }
+
+  /* 小さなデータ片を不足した時だけ供給する */
+  {
+    struct SLAStreamingDecoder* decoder;
+    int32_t* output_ptr[SLA_MAX_NUM_CHANNELS];
+    uint32_t progress, data_progress, num_decode, data_fragment_size;
+    const uint8_t* collect_data;
+    uint32_t collect_size;
+    SLAApiResult ret;
+    int32_t is_ok;
+
+    decoder = SLAStreamingDecoder_Create(&config);
+    Test_AssertEqual(SLAStreamingDecoder_SetWaveFormat(decoder, &header.wave_format), SLA_APIRESULT_OK);
+    Test_AssertEqual(SLAStreamingDecoder_SetEncodeParameter(decoder, &header.encode_param), SLA_APIRESULT_OK);
+
+    is_ok = 1;
+    progress = 0;
+    data_progress = SLA_HEADER_SIZE;
+    while (progress < num_samples) {
+      num_decode = SLAUTILITY_MIN(num_frames, num_samples - progress);
+      for (ch = 0; ch < num_channels; ch++) {
+        output_ptr[ch] = &output[ch][progress];
+      }
+      ret = SLAStreamingDecoder_DecodeFrames(decoder, output_ptr, num_decode);
+      if (ret == SLA_APIRESULT_INSUFFICIENT_DATA_SIZE) {
+        /* データが尽きているのに足りないのはおかしい */
+        if (data_progress >= encoded_size) {
+          is_ok = 0;
+          break;
+        }
+        data_fragment_size = SLAUTILITY_MIN(333, encoded_size - data_progress);
+        SLAStreamingDecoder_AppendDataFragment(decoder, &data[data_progress], data_fragment_size);
+        data_progress += data_fragment_size;
+        continue;
+      } else if (ret != SLA_APIRESULT_OK) {
+        is_ok = 0;
+        break;
+      }
+      while (SLAStreamingDecoder_CollectDataFragment(decoder,
+            &collect_data, &collect_size) == SLA_APIRESULT_OK) ;
+      progress += num_decode;
+    }
+    Test_AssertEqual(is_ok, 1);
+
+    /* 一致確認 */
+    for (ch = 0; ch < num_channels; ch++) {
+      for (smpl = 0; smpl < num_samples; smpl++) {
+        if (input[ch][smpl] != output[ch][smpl]) {
+          is_ok = 0;
+        }
+      }
+    }
+    Test_AssertEqual(is_ok, 1);
+
+    SLAStreamingDecoder_Destroy(decoder);
+  }
+
+  /* ブロック途中のデータ破損を、そのブロックのサンプルを出力する前に検出できるか */
+  {
+    struct SLAStreamingDecoder* decoder;
+    int32_t* output_ptr[SLA_MAX_NUM_CHANNELS];
+    uint32_t first_block_size, num_output_samples;
+    int32_t is_ok;
+
+    /* 先頭ブロックの中央付近を壊す */
+    first_block_size = SLAByteArray_ReadUint32(&data[SLA_HEADER_SIZE + 2]) + SLA_BLOCK_SIZE_FIELD_END_OFFSET;
+    data[SLA_HEADER_SIZE + first_block_size / 2] ^= 0x10;
+
+    for (ch = 0; ch < num_channels; ch++) {
+      memset(output[ch], 0, sizeof(int32_t) * num_samples);
+      output_ptr[ch] = output[ch];
+    }
+
+    /* 固定サンプル数の取り出し: 最初の呼び出しで検出 */
+    decoder = SLAStreamingDecoder_Create(&config);
+    Test_AssertEqual(SLAStreamingDecoder_SetWaveFormat(decoder, &header.wave_format), SLA_APIRESULT_OK);
+    Test_AssertEqual(SLAStreamingDecoder_SetEncodeParameter(decoder, &header.encode_param), SLA_APIRESULT_OK);
+    Test_AssertEqual(SLAStreamingDecoder_AppendDataFragment(decoder,
+          &data[SLA_HEADER_SIZE], encoded_size - SLA_HEADER_SIZE), SLA_APIRESULT_OK);
+    Test_AssertEqual(SLAStreamingDecoder_DecodeFrames(decoder, output_ptr, num_frames), SLA_APIRESULT_DETECT_DATA_CORRUPTION);
+    SLAStreamingDecoder_Destroy(decoder);
+
+    /* 通常のストリーミングデコード: ブロックが揃うまではデータ不足、揃ったら破損を検出 */
+    decoder = SLAStreamingDecoder_Create(&config);
+    Test_AssertEqual(SLAStreamingDecoder_SetWaveFormat(decoder, &header.wave_format), SLA_APIRESULT_OK);
+    Test_AssertEqual(SLAStreamingDecoder_SetEncodeParameter(decoder, &header.encode_param), SLA_APIRESULT_OK);
+    Test_AssertEqual(SLAStreamingDecoder_AppendDataFragment(decoder,
+          &data[SLA_HEADER_SIZE], first_block_size - 1), SLA_APIRESULT_OK);
+    Test_AssertEqual(SLAStreamingDecoder_Decode(decoder,
+          output_ptr, num_samples, &num_output_samples), SLA_APIRESULT_INSUFFICIENT_DATA_SIZE);
+    Test_AssertEqual(SLAStreamingDecoder_AppendDataFragment(decoder,
+          &data[SLA_HEADER_SIZE + first_block_size - 1], encoded_size - SLA_HEADER_SIZE - first_block_size + 1), SLA_APIRESULT_OK);
+    Test_AssertEqual(SLAStreamingDecoder_Decode(decoder,
+          output_ptr, num_samples, &num_output_samples), SLA_APIRESULT_DETECT_DATA_CORRUPTION);
+    SLAStreamingDecoder_Destroy(decoder);
+
+    /* 壊れたブロックのサンプルは出力されていない */
+    is_ok = 1;
+    for (ch = 0; ch < num_channels; ch++) {
+      for (smpl = 0; smpl < num_samples; smpl++) {
+        if (output[ch][smpl] != 0) {
+          is_ok = 0;
+        }
+      }
+    }
+    Test_AssertEqual(is_ok, 1);
+
+    /* 壊したデータを戻す */
+    data[SLA_HEADER_SIZE + first_block_size / 2] ^= 0x10;
+  }
+
+  /* 前のブロックのデコード中に計算を進めた部分の破損も、そのブロックの先頭で検出できるか */
+  {
+    struct SLAStreamingDecoder* decoder;
+    int32_t* output_ptr[SLA_MAX_NUM_CHANNELS];
+    uint32_t first_block_size, first_block_num_samples, progress, num_decode;
+    SLAApiResult ret;
+    int32_t is_ok;
+
+    /* 2番目のブロックの先頭付近（CRC16の計算範囲の先頭）を壊す */
+    first_block_size = SLAByteArray_ReadUint32(&data[SLA_HEADER_SIZE + 2]) + SLA_BLOCK_SIZE_FIELD_END_OFFSET;
+    first_block_num_samples = SLAUtility_GetBlockNumSamples(&data[SLA_HEADER_SIZE], first_block_size);
+    Test_AssertCondition(SLA_HEADER_SIZE + first_block_size + SLA_MINIMUM_BLOCK_HEADER_SIZE < encoded_size);
+    data[SLA_HEADER_SIZE + first_block_size + SLA_BLOCK_CRC16_CALC_START_OFFSET + 4] ^= 0x01;
+
+    decoder = SLAStreamingDecoder_Create(&config);
+    Test_AssertEqual(SLAStreamingDecoder_SetWaveFormat(decoder, &header.wave_format), SLA_APIRESULT_OK);
+    Test_AssertEqual(SLAStreamingDecoder_SetEncodeParameter(decoder, &header.encode_param), SLA_APIRESULT_OK);
+    Test_AssertEqual(SLAStreamingDecoder_AppendDataFragment(decoder,
+          &data[SLA_HEADER_SIZE], encoded_size - SLA_HEADER_SIZE), SLA_APIRESULT_OK);
+
+    /* 先頭ブロックは全てデコードでき、2番目のブロックに入る呼び出しで破損を検出 */
+    ret = SLA_APIRESULT_OK;
+    for (progress = 0; progress < num_samples; progress += num_decode) {
+      num_decode = SLAUTILITY_MIN(num_frames, num_samples - progress);
+      for (ch = 0; ch < num_channels; ch++) {
+        output_ptr[ch] = &output[ch][progress];
+      }
+      if ((ret = SLAStreamingDecoder_DecodeFrames(decoder, output_ptr, num_decode)) != SLA_APIRESULT_OK) {
+        break;
+      }
+    }
+    Test_AssertEqual(ret, SLA_APIRESULT_DETECT_DATA_CORRUPTION);
+    Test_AssertEqual(progress, first_block_num_samples);
+    is_ok = 1;
+    for (ch = 0; ch < num_channels; ch++) {
+      for (smpl = 0; smpl < first_block_num_samples; smpl++) {
+        if (input[ch][smpl] != output[ch][smpl]) {
+          is_ok = 0;
+        }
+      }
+    }
+    Test_AssertEqual(is_ok, 1);
+    SLAStreamingDecoder_Destroy(decoder);
+
+    data[SLA_HEADER_SIZE + first_block_size + SLA_BLOCK_CRC16_CALC_START_OFFSET + 4] ^= 0x01;
+  }
+
+  SLAEncoder_Destroy(encoder);
+  for (ch = 0; ch < num_channels; ch++) {
+    free(input_double[ch]);
+    free(input[ch]);
+    free(output[ch]);
+  }
+  free(input_double);
+  free(input);
+  free(output);
+  free(data);
+}
+
+/* ワーク領域を指定して作成したハンドルでのエンコードデコードテスト */
+static void testSLAEncodeDecode_CreateWithWorkTest(void *obj)
+{
+  static const struct EncodeDecodeTestCase test_case = {
+    { 2, 16, 44100, 0 },
+    { 16, 1, 8, SLA_CHPROCESSMETHOD_STEREO_MS, SLA_WINDOWFUNCTIONTYPE_SIN, 4096 },
+    16384,
+    testSLAEncodeDecode_GenerateChirp };
+  uint32_t ch, smpl, num_channels, num_samples, data_size, encoded_size, decoded_num_samples;
+  int32_t  encoder_work_size, decoder_work_size, is_ok;
+  double   **input_double;
+  int32_t  **input, **output;
+  uint8_t  *data, *encoder_work, *decoder_work;
+  struct SLAEncoderConfig encoder_config;
+  struct SLADecoderConfig decoder_config;
+  struct SLAEncoder*      encoder;
+  struct SLADecoder*      decoder;
+
+  TEST_UNUSED_PARAMETER(obj);
+
+  num_samples   = test_case.num_samples;
+  num_channels  = test_case.wave_format.num_channels;
+  data_size     = SLA_HEADER_SIZE + SLA_CalculateSufficientBlockSize(num_channels, num_samples, test_case.wave_format.bit_per_sample);
+
+  /* 一時領域の割り当て */
+  input_double  = (double **)malloc(sizeof(double*) * num_channels);
+  input         = (int32_t **)malloc(sizeof(int32_t*) * num_channels);
+  output        = (int32_t **)malloc(sizeof(int32_t*) * num_channels);
+  data          = (uint8_t *)malloc(data_size);
+  for (ch = 0; ch < num_channels; ch++) {
+    input_double[ch]  = (double *)malloc(sizeof(double) * num_samples);
+    input[ch]         = (int32_t *)malloc(sizeof(int32_t) * num_samples);
+    output[ch]        = (int32_t *)malloc(sizeof(int32_t) * num_samples);
+  }
+
+  SLAEncoder_SetDefaultConfig(&encoder_config);
+  SLADecoder_SetDefaultConfig(&decoder_config);
+
+  /* ワークサイズ計算 */
+  Test_AssertEqual(SLAEncoder_CalculateWorkSize(NULL), -1);
+  Test_AssertEqual(SLADecoder_CalculateWorkSize(NULL), -1);
+  encoder_work_size = SLAEncoder_CalculateWorkSize(&encoder_config);
+  decoder_work_size = SLADecoder_CalculateWorkSize(&decoder_config);
+  Test_AssertCondition(encoder_work_size > 0);
+  Test_AssertCondition(decoder_work_size > 0);
+
+  /* int32_tで表せないワークサイズは-1（桁あふれで小さな値にならない） */
+  {
+    struct SLAEncoderConfig large_encoder_config = encoder_config;
+    struct SLADecoderConfig large_decoder_config = decoder_config;
+    large_encoder_config.max_num_channels       = SLA_MAX_NUM_CHANNELS;
+    large_encoder_config.max_num_block_samples  = SLA_MAX_NUM_BLOCK_SAMPLES;
+    large_decoder_config.max_num_channels       = SLA_MAX_NUM_CHANNELS;
+    large_decoder_config.max_num_block_samples  = SLA_MAX_NUM_BLOCK_SAMPLES;
+    Test_AssertEqual(SLAEncoder_CalculateWorkSize(&large_encoder_config), -1);
+    Test_AssertEqual(SLADecoder_CalculateWorkSize(&large_decoder_config), -1);
+    Test_AssertCondition(SLADecoderPool_Create(&large_decoder_config, 1) == NULL);
+    /* ブロックあたりサンプル数が上限を超える設定も-1 */
+    large_encoder_config.max_num_channels       = 2;
+    large_encoder_config.max_num_block_samples  = SLA_MAX_NUM_BLOCK_SAMPLES + 1;
+    large_decoder_config.max_num_channels       = 2;
+    large_decoder_config.max_num_block_samples  = SLA_MAX_NUM_BLOCK_SAMPLES + 1;
+    Test_AssertEqual(SLAEncoder_CalculateWorkSize(&large_encoder_config), -1);
+    Test_AssertEqual(SLADecoder_CalculateWorkSize(&large_decoder_config), -1);
+    /* ハンドル数の積があふれるプール */
+    Test_AssertCondition(SLADecoderPool_Create(&decoder_config, 0xFFFFFFFFUL) == NULL);
+  }
+
+  /* 先頭をずらしたワーク領域を与える */
+  encoder_work = (uint8_t *)malloc((size_t)encoder_work_size + 1);
+  decoder_work = (uint8_t *)malloc((size_t)decoder_work_size + 1);
+
+  /* 不正な引数 */
+  Test_AssertCondition(SLAEncoder_CreateWithWork(NULL, encoder_work + 1, encoder_work_size) == NULL);
+  Test_AssertCondition(SLAEncoder_CreateWithWork(&encoder_config, NULL, encoder_work_size) == NULL);
+  Test_AssertCondition(SLAEncoder_CreateWithWork(&encoder_config, encoder_work + 1, encoder_work_size - 1) == NULL);
+  Test_AssertCondition(SLADecoder_CreateWithWork(NULL, decoder_work + 1, decoder_work_size) == NULL);
+  Test_AssertCondition(SLADecoder_CreateWithWork(&decoder_config, NULL, decoder_work_size) == NULL);
+  Test_AssertCondition(SLADecoder_CreateWithWork(&decoder_config, decoder_work + 1, decoder_work_size - 1) == NULL);
+
+  encoder = SLAEncoder_CreateWithWork(&encoder_config, encoder_work + 1, encoder_work_size);
+  decoder = SLADecoder_CreateWithWork(&decoder_config, decoder_work + 1, decoder_work_size);
+  Test_AssertCondition(encoder != NULL);
+  Test_AssertCondition(decoder != NULL);
+
+  /* エンコード */
+  test_case.gen_wave_func(input_double, num_channels, num_samples);
+  testSLAEncodeDecode_InputDoubleToInputFixedFloat(
+      &test_case.wave_format, input_double, input, num_channels, num_samples);
+  Test_AssertEqual(SLAEncoder_SetWaveFormat(encoder, &test_case.wave_format), SLA_APIRESULT_OK);
+  Test_AssertEqual(SLAEncoder_SetEncodeParameter(encoder, &test_case.encode_parameter), SLA_APIRESULT_OK);
+  Test_AssertEqual(SLAEncoder_EncodeWhole(encoder,
+        (const int32_t **)input, num_samples, data, data_size, &encoded_size), SLA_APIRESULT_OK);
+
+  /* デコード */
+  Test_AssertEqual(SLADecoder_DecodeWhole(decoder,
+        data, encoded_size, output, num_samples, &decoded_num_samples), SLA_APIRESULT_OK);
+  Test_AssertEqual(decoded_num_samples, num_samples);
+
+  /* 一致確認 */
+  is_ok = 1;
+  for (ch = 0; ch < num_channels; ch++) {
+    for (smpl = 0; smpl < num_samples; smpl++) {
+      if (input[ch][smpl] != output[ch][smpl]) {
+        is_ok = 0;
+      }
+    }
+  }
+  Test_AssertEqual(is_ok, 1);
+
+  /* ワーク領域は呼び出し側で解放 */
+  SLAEncoder_Destroy(encoder);
+  SLADecoder_Destroy(decoder);
+  free(encoder_work);
+  free(decoder_work);
+
+  for (ch = 0; ch < num_channels; ch++) {
+    free(input_double[ch]);
+    free(input[ch]);
+    free(output[ch]);
+  }
+  free(input_double);
+  free(input);
+  free(output);
+  free(data);
+}
+
+/* 統計情報取得のテスト */
+static void testSLAEncodeDecode_StatisticsTest(void *obj)
+{
+  static const struct EncodeDecodeTestCase test_case = {
+    { 2, 16, 44100, 0 },
+    { 16, 1, 8, SLA_CHPROCESSMETHOD_STEREO_MS, SLA_WINDOWFUNCTIONTYPE_SIN, 4096 },
+    8192 * 4,
+    testSLAEncodeDecode_GenerateChirp };
+  uint32_t ch, smpl, num_channels, num_samples, data_size, encoded_size, decoded_num_samples;
+  uint32_t rand_state;
+#ifdef SLA_ENABLE_STATISTICS
+  uint32_t i;
+  uint64_t histogram_sum, total_ticks;
+#endif
+  double   **input_double;
+  int32_t  **input, **output;
+  uint8_t  *data;
+  struct SLAEncoderConfig encoder_config;
+  struct SLADecoderConfig decoder_config;
+  struct SLAEncoder*      encoder;
+  struct SLADecoder*      decoder;
+  struct SLAHeaderInfo    header;
+  struct SLAStatistics    enc_stats, dec_stats;
+
+  TEST_UNUSED_PARAMETER(obj);
+
+  num_samples   = test_case.num_samples;
+  num_channels  = test_case.wave_format.num_channels;
+  data_size     = SLA_HEADER_SIZE + SLA_CalculateSufficientBlockSize(num_channels, num_samples, test_case.wave_format.bit_per_sample);
+
+  /* 一時領域の割り当て */
+  input_double  = (double **)malloc(sizeof(double*) * num_channels);
+  input         = (int32_t **)malloc(sizeof(int32_t*) * num_channels);
+  output        = (int32_t **)malloc(sizeof(int32_t*) * num_channels);
+  data          = (uint8_t *)malloc(data_size);
+  for (ch = 0; ch < num_channels; ch++) {
+    input_double[ch]  = (double *)malloc(sizeof(double) * num_samples);
+    input[ch]         = (int32_t *)malloc(sizeof(int32_t) * num_samples);
+    output[ch]        = (int32_t *)malloc(sizeof(int32_t) * num_samples);
+  }
+
+  SLAEncoder_SetDefaultConfig(&encoder_config);
+  SLADecoder_SetDefaultConfig(&decoder_config);
+  encoder = SLAEncoder_Create(&encoder_config);
+  decoder = SLADecoder_Create(&decoder_config);
+
+  /* 不正な引数 */
+  Test_AssertEqual(SLAEncoder_GetStatistics(NULL, &enc_stats), SLA_APIRESULT_INVALID_ARGUMENT);
+  Test_AssertEqual(SLAEncoder_GetStatistics(encoder, NULL), SLA_APIRESULT_INVALID_ARGUMENT);
+  Test_AssertEqual(SLAEncoder_ResetStatistics(NULL), SLA_APIRESULT_INVALID_ARGUMENT);
+  Test_AssertEqual(SLADecoder_GetStatistics(NULL, &dec_stats), SLA_APIRESULT_INVALID_ARGUMENT);
+  Test_AssertEqual(SLADecoder_GetStatistics(decoder, NULL), SLA_APIRESULT_INVALID_ARGUMENT);
+  Test_AssertEqual(SLADecoder_ResetStatistics(NULL), SLA_APIRESULT_INVALID_ARGUMENT);
+
+#ifdef SLA_ENABLE_STATISTICS
+  /* 作成直後は全て0 */
+  Test_AssertEqual(SLAEncoder_GetStatistics(encoder, &enc_stats), SLA_APIRESULT_OK);
+  Test_AssertEqual(enc_stats.num_samples, 0);
+  Test_AssertEqual(enc_stats.num_compressed_blocks + enc_stats.num_silent_blocks + enc_stats.num_raw_blocks, 0);
+  Test_AssertCondition(enc_stats.ticks_per_second > 0);
+  Test_AssertCondition(enc_stats.tick_clock != SLA_STATISTICS_CLOCK_USER_DEFINED);
+#endif
+
+  /* 先頭は無音、末尾は最大振幅の白色雑音（無音・圧縮・生データの全ブロックを含める） */
+  test_case.gen_wave_func(input_double, num_channels, num_samples);
+  rand_state = 1;
+  for (ch = 0; ch < num_channels; ch++) {
+    for (smpl = 0; smpl < 8192; smpl++) {
+      input_double[ch][smpl] = 0.0f;
+    }
+    for (smpl = num_samples - 8192; smpl < num_samples; smpl++) {
+      rand_state = rand_state * 1103515245UL + 12345UL;
+      input_double[ch][smpl] = ((double)((rand_state >> 8) & 0xFFFF) / 0x8000) - 1.0f;
+    }
+  }
+  testSLAEncodeDecode_InputDoubleToInputFixedFloat(
+      &test_case.wave_format, input_double, input, num_channels, num_samples);
+
+  /* エンコード・デコード */
+  Test_AssertEqual(SLAEncoder_SetWaveFormat(encoder, &test_case.wave_format), SLA_APIRESULT_OK);
+  Test_AssertEqual(SLAEncoder_SetEncodeParameter(encoder, &test_case.encode_parameter), SLA_APIRESULT_OK);
+  Test_AssertEqual(SLAEncoder_EncodeWhole(encoder,
+        (const int32_t **)input, num_samples, data, data_size, &encoded_size), SLA_APIRESULT_OK);
+  Test_AssertEqual(SLADecoder_DecodeWhole(decoder,
+        data, encoded_size, output, num_samples, &decoded_num_samples), SLA_APIRESULT_OK);
+  Test_AssertEqual(SLADecoder_DecodeHeader(data, encoded_size, &header), SLA_APIRESULT_OK);
+
+#ifdef SLA_ENABLE_STATISTICS
+  /* エンコード側の統計 */
+  Test_AssertEqual(SLAEncoder_GetStatistics(encoder, &enc_stats), SLA_APIRESULT_OK);
+  Test_AssertEqual(enc_stats.num_samples, (uint64_t)num_samples * num_channels);
+  Test_AssertEqual(enc_stats.num_compressed_blocks + enc_stats.num_silent_blocks + enc_stats.num_raw_blocks, header.num_blocks);
+  Test_AssertCondition(enc_stats.num_compressed_blocks > 0);
+  Test_AssertCondition(enc_stats.num_silent_blocks > 0);
+  Test_AssertCondition(enc_stats.num_raw_blocks > 0);
+  Test_AssertEqual(enc_stats.coefficient_bits + enc_stats.residual_bits, 8 * (uint64_t)(encoded_size - SLA_HEADER_SIZE));
+  histogram_sum = 0;
+  for (i = 0; i < SLA_STATISTICS_RICE_HISTOGRAM_SIZE; i++) {
+    histogram_sum += enc_stats.rice_parameter_histogram[i];
+  }
+  Test_AssertCondition(histogram_sum > 0);
+  Test_AssertCondition(histogram_sum < enc_stats.num_samples);
+
+  /* デコード側の統計はストリームの内容について一致する */
+  Test_AssertEqual(SLADecoder_GetStatistics(decoder, &dec_stats), SLA_APIRESULT_OK);
+  Test_AssertEqual(dec_stats.num_samples, enc_stats.num_samples);
+  Test_AssertEqual(dec_stats.num_compressed_blocks, enc_stats.num_compressed_blocks);
+  Test_AssertEqual(dec_stats.num_silent_blocks, enc_stats.num_silent_blocks);
+  Test_AssertEqual(dec_stats.num_raw_blocks, enc_stats.num_raw_blocks);
+  Test_AssertEqual(dec_stats.coefficient_bits, enc_stats.coefficient_bits);
+  Test_AssertEqual(dec_stats.residual_bits, enc_stats.residual_bits);
+  for (i = 0; i < SLA_STATISTICS_RICE_HISTOGRAM_SIZE; i++) {
+    Test_AssertEqual(dec_stats.rice_parameter_histogram[i], enc_stats.rice_parameter_histogram[i]);
+  }
+  /* デコーダにはブロック分割探索はない */
+  Test_AssertEqual(dec_stats.stage_ticks[SLA_STATISTICS_STAGE_PARTITION_SEARCH], 0);
+  /* 処理時間が計測されている */
+  total_ticks = 0;
+  for (i = 0; i < SLA_STATISTICS_NUM_STAGES; i++) {
+    total_ticks += dec_stats.stage_ticks[i];
+  }
+  Test_AssertCondition(total_ticks > 0);
+  Test_AssertEqual(dec_stats.tick_clock, enc_stats.tick_clock);
+
+  /* リセット */
+  Test_AssertEqual(SLAEncoder_ResetStatistics(encoder), SLA_APIRESULT_OK);
+  Test_AssertEqual(SLADecoder_ResetStatistics(decoder), SLA_APIRESULT_OK);
+  Test_AssertEqual(SLAEncoder_GetStatistics(encoder, &enc_stats), SLA_APIRESULT_OK);
+  Test_AssertEqual(SLADecoder_GetStatistics(decoder, &dec_stats), SLA_APIRESULT_OK);
+  Test_AssertEqual(enc_stats.num_samples, 0);
+  Test_AssertEqual(enc_stats.coefficient_bits + enc_stats.residual_bits, 0);
+  Test_AssertEqual(dec_stats.num_samples, 0);
+  Test_AssertEqual(dec_stats.num_compressed_blocks, 0);
+#else
+  /* 統計情報無効のビルドでは取得・リセットできない */
+  Test_AssertEqual(SLAEncoder_GetStatistics(encoder, &enc_stats), SLA_APIRESULT_STATISTICS_DISABLED);
+  Test_AssertEqual(SLADecoder_GetStatistics(decoder, &dec_stats), SLA_APIRESULT_STATISTICS_DISABLED);
+  Test_AssertEqual(SLAEncoder_ResetStatistics(encoder), SLA_APIRESULT_STATISTICS_DISABLED);
+  Test_AssertEqual(SLADecoder_ResetStatistics(decoder), SLA_APIRESULT_STATISTICS_DISABLED);
+#endif
+
+  SLAEncoder_Destroy(encoder);
+  SLADecoder_Destroy(decoder);
+  for (ch = 0; ch < num_channels; ch++) {
+    free(input_double[ch]);
+    free(input[ch]);
+    free(output[ch]);
+  }
+  free(input_double);
+  free(input);
+  free(output);
+  free(data);
+}
+
+/* ブロック索引作成のテスト */
+static void testSLAEncodeDecode_BuildBlockIndexTest(void *obj)
+{
+  static const struct EncodeDecodeTestCase test_case = {
+    { 2, 16, 44100, 0 },
+    { 16, 1, 8, SLA_CHPROCESSMETHOD_STEREO_MS, SLA_WINDOWFUNCTIONTYPE_SIN, 4096 },
+    4096 * 8 + 100,
+    testSLAEncodeDecode_GenerateChirp };
+  uint32_t ch, i, num_channels, num_samples, data_size, encoded_size, num_blocks, num_entries;
+  uint32_t offset, sample_offset;
+  double   **input_double;
+  int32_t  **input;
+  uint8_t  *data;
+  struct SLAEncoderConfig     encoder_config;
+  struct SLAEncoder*          encoder;
+  struct SLAHeaderInfo        header;
+  struct SLABlockIndexEntry   expected[32], entries[32];
+
+  TEST_UNUSED_PARAMETER(obj);
+
+  num_samples   = test_case.num_samples;
+  num_channels  = test_case.wave_format.num_channels;
+  data_size     = SLA_HEADER_SIZE + SLA_CalculateSufficientBlockSize(num_channels, num_samples, test_case.wave_format.bit_per_sample);
+
+  /* 一時領域の割り当て */
+  input_double  = (double **)malloc(sizeof(double*) * num_channels);
+  input         = (int32_t **)malloc(sizeof(int32_t*) * num_channels);
+  data          = (uint8_t *)malloc(data_size);
+  for (ch = 0; ch < num_channels; ch++) {
+    input_double[ch]  = (double *)malloc(sizeof(double) * num_samples);
+    input[ch]         = (int32_t *)malloc(sizeof(int32_t) * num_samples);
+  }
+
+  /* エンコード */
+  SLAEncoder_SetDefaultConfig(&encoder_config);
+  encoder = SLAEncoder_Create(&encoder_config);
+  test_case.gen_wave_func(input_double, num_channels, num_samples);
+  testSLAEncodeDecode_InputDoubleToInputFixedFloat(
+      &test_case.wave_format, input_double, input, num_channels, num_samples);
+  Test_AssertEqual(SLAEncoder_SetWaveFormat(encoder, &test_case.wave_format), SLA_APIRESULT_OK);
+  Test_AssertEqual(SLAEncoder_SetEncodeParameter(encoder, &test_case.encode_parameter), SLA_APIRESULT_OK);
+  Test_AssertEqual(SLAEncoder_EncodeWhole(encoder,
+        (const int32_t **)input, num_samples, data, data_size, &encoded_size), SLA_APIRESULT_OK);
+  Test_AssertEqual(SLADecoder_DecodeHeader(data, encoded_size, &header), SLA_APIRESULT_OK);
+
+  /* ブロックヘッダを順に辿って期待値を作成 */
+  offset = SLA_HEADER_SIZE;
+  sample_offset = 0;
+  num_blocks = 0;
+  while (offset < encoded_size) {
+    expected[num_blocks].data_offset    = offset;
+    expected[num_blocks].sample_offset  = sample_offset;
+    expected[num_blocks].block_size     = SLAByteArray_ReadUint32(&data[offset + 2]) + SLA_BLOCK_SIZE_FIELD_END_OFFSET;
+    expected[num_blocks].crc16          = SLAByteArray_ReadUint16(&data[offset + SLA_BLOCK_SIZE_FIELD_END_OFFSET]);
+    expected[num_blocks].num_samples    = SLAByteArray_ReadUint16(&data[offset + SLA_BLOCK_CRC16_CALC_START_OFFSET]);
+    sample_offset += expected[num_blocks].num_samples;
+    offset        += expected[num_blocks].block_size;
+    num_blocks++;
+  }
+  Test_AssertEqual(num_blocks, header.num_blocks);
+  Test_AssertCondition(num_blocks >= 4);
+
+  /* 不正な引数 */
+  num_entries = 1;
+  Test_AssertEqual(SLADecoder_BuildBlockIndex(NULL, encoded_size, entries, 32, &num_entries), SLA_APIRESULT_INVALID_ARGUMENT);
+  Test_AssertEqual(num_entries, 0);
+  Test_AssertEqual(SLADecoder_BuildBlockIndex(data, encoded_size, entries, 32, NULL), SLA_APIRESULT_INVALID_ARGUMENT);
+
+  /* 計数のみ */
+  Test_AssertEqual(SLADecoder_BuildBlockIndex(data, encoded_size, NULL, 0, &num_entries), SLA_APIRESULT_OK);
+  Test_AssertEqual(num_entries, num_blocks);
+
+  /* 領域不足: 入る分だけ記録し、必要なエントリ数を返す */
+  memset(entries, 0, sizeof(entries));
+  num_entries = 0;
+  Test_AssertEqual(SLADecoder_BuildBlockIndex(data, encoded_size, entries, num_blocks - 1, &num_entries),
+      SLA_APIRESULT_EXCEED_HANDLE_CAPACITY);
+  Test_AssertEqual(num_entries, num_blocks);
+  Test_AssertEqual(entries[num_blocks - 2].data_offset, expected[num_blocks - 2].data_offset);
+  Test_AssertEqual(entries[num_blocks - 1].data_offset, 0);
+
+  /* 正常なデータ */
+  Test_AssertEqual(SLADecoder_BuildBlockIndex(data, encoded_size, entries, 32, &num_entries), SLA_APIRESULT_OK);
+  Test_AssertEqual(num_entries, num_blocks);
+  for (i = 0; i < num_blocks; i++) {
+    Test_AssertEqual(entries[i].data_offset, expected[i].data_offset);
+    Test_AssertEqual(entries[i].sample_offset, expected[i].sample_offset);
+    Test_AssertEqual(entries[i].block_size, expected[i].block_size);
+    Test_AssertEqual(entries[i].num_samples, expected[i].num_samples);
+    Test_AssertEqual(entries[i].crc16, expected[i].crc16);
+  }
+
+  /* 末尾ブロックが途中で切れたデータ */
+  Test_AssertEqual(SLADecoder_BuildBlockIndex(data, encoded_size - 1, entries, 32, &num_entries),
+      SLA_APIRESULT_DETECT_DATA_CORRUPTION);
+  Test_AssertEqual(num_entries, num_blocks - 1);
+
+  /* ヘッダがないデータ: 先頭から走査して全ブロックを見つける */
+  Test_AssertEqual(SLADecoder_BuildBlockIndex(&data[SLA_HEADER_SIZE], encoded_size - SLA_HEADER_SIZE, entries, 32, &num_entries),
+      SLA_APIRESULT_DETECT_DATA_CORRUPTION);
+  Test_AssertEqual(num_entries, num_blocks);
+  for (i = 0; i < num_blocks; i++) {
+    Test_AssertEqual(entries[i].data_offset, expected[i].data_offset - SLA_HEADER_SIZE);
+  }
+
+  /* 2番目のブロックのデータを破壊: そのブロックだけ除外され、以降は再同期する */
+  data[expected[1].data_offset + expected[1].block_size / 2] ^= 0x5A;
+  Test_AssertEqual(SLADecoder_BuildBlockIndex(data, encoded_size, entries, 32, &num_entries),
+      SLA_APIRESULT_DETECT_DATA_CORRUPTION);
+  Test_AssertEqual(num_entries, num_blocks - 1);
+  Test_AssertEqual(entries[0].data_offset, expected[0].data_offset);
+  for (i = 1; i < num_entries; i++) {
+    Test_AssertEqual(entries[i].data_offset, expected[i + 1].data_offset);
+    Test_AssertEqual(entries[i].block_size, expected[i + 1].block_size);
+    /* 欠落分のサンプル数はわからないので詰める */
+    Test_AssertEqual(entries[i].sample_offset, expected[i + 1].sample_offset - expected[1].num_samples);
+  }
+
+  SLAEncoder_Destroy(encoder);
+  for (ch = 0; ch < num_channels; ch++) {
+    free(input_double[ch]);
+    free(input[ch]);
+  }
+  free(input_double);
+  free(input);
+  free(data);
+}
+
+/* 完全性検証のテスト */
+static void testSLAEncodeDecode_VerifyStreamTest(void *obj)
+{
+  static const struct EncodeDecodeTestCase test_case = {
+    { 2, 16, 44100, 0 },
+    { 16, 1, 8, SLA_CHPROCESSMETHOD_STEREO_MS, SLA_WINDOWFUNCTIONTYPE_SIN, 4096 },
+    4096 * 8 + 100,
+    testSLAEncodeDecode_GenerateChirp };
+  uint32_t ch, num_channels, num_samples, data_size, encoded_size, num_entries;
+  uint32_t block_size, block_num_samples;
+  double   **input_double;
+  int32_t  **input;
+  uint8_t  *data;
+  struct SLAEncoderConfig     encoder_config;
+  struct SLAEncoder*          encoder;
+  struct SLAHeaderInfo        header;
+  struct SLABlockIndexEntry   entries[32];
+  struct SLAVerifyResult      result;
+
+  TEST_UNUSED_PARAMETER(obj);
+
+  num_samples   = test_case.num_samples;
+  num_channels  = test_case.wave_format.num_channels;
+  data_size     = SLA_HEADER_SIZE + SLA_CalculateSufficientBlockSize(num_channels, num_samples, test_case.wave_format.bit_per_sample);
+
+  /* 一時領域の割り当て */
+  input_double  = (double **)malloc(sizeof(double*) * num_channels);
+  input         = (int32_t **)malloc(sizeof(int32_t*) * num_channels);
+  data          = (uint8_t *)malloc(data_size);
+  for (ch = 0; ch < num_channels; ch++) {
+    input_double[ch]  = (double *)malloc(sizeof(double) * num_samples);
+    input[ch]         = (int32_t *)malloc(sizeof(int32_t) * num_samples);
+  }
+
+  /* エンコード */
+  SLAEncoder_SetDefaultConfig(&encoder_config);
+  encoder = SLAEncoder_Create(&encoder_config);
+  test_case.gen_wave_func(input_double, num_channels, num_samples);
+  testSLAEncodeDecode_InputDoubleToInputFixedFloat(
+      &test_case.wave_format, input_double, input, num_channels, num_samples);
+  Test_AssertEqual(SLAEncoder_SetWaveFormat(encoder, &test_case.wave_format), SLA_APIRESULT_OK);
+  Test_AssertEqual(SLAEncoder_SetEncodeParameter(encoder, &test_case.encode_parameter), SLA_APIRESULT_OK);
+  Test_AssertEqual(SLAEncoder_EncodeWhole(encoder,
+        (const int32_t **)input, num_samples, data, data_size, &encoded_size), SLA_APIRESULT_OK);
+  Test_AssertEqual(SLADecoder_DecodeHeader(data, encoded_size, &header), SLA_APIRESULT_OK);
+  Test_AssertEqual(SLADecoder_BuildBlockIndex(data, encoded_size, entries, 32, &num_entries), SLA_APIRESULT_OK);
+  Test_AssertCondition(num_entries >= 4);
+
+  /* 不正な引数 */
+  Test_AssertEqual(SLADecoder_VerifyStream(NULL, encoded_size, &result), SLA_APIRESULT_INVALID_ARGUMENT);
+  Test_AssertEqual(SLADecoder_VerifyStream(data, encoded_size, NULL), SLA_APIRESULT_INVALID_ARGUMENT);
+  Test_AssertEqual(SLADecoder_VerifyBlock(NULL, encoded_size, &header, &block_size, &block_num_samples),
+      SLA_APIRESULT_INVALID_ARGUMENT);
+  Test_AssertEqual(SLADecoder_VerifyBlock(data, encoded_size, &header, NULL, &block_num_samples),
+      SLA_APIRESULT_INVALID_ARGUMENT);
+  Test_AssertEqual(SLADecoder_VerifyBlock(data, encoded_size, &header, &block_size, NULL),
+      SLA_APIRESULT_INVALID_ARGUMENT);
+
+  /* 正常なデータ */
+  Test_AssertEqual(SLADecoder_VerifyStream(data, encoded_size, &result), SLA_APIRESULT_OK);
+  Test_AssertEqual(result.num_blocks, num_entries);
+  Test_AssertCondition(result.num_samples == num_samples);
+  Test_AssertEqual(result.error_offset, encoded_size);
+
+  /* 1ブロックの検証: ヘッダの有無によらず索引と一致 */
+  Test_AssertEqual(SLADecoder_VerifyBlock(&data[entries[1].data_offset], encoded_size - entries[1].data_offset,
+        &header, &block_size, &block_num_samples), SLA_APIRESULT_OK);
+  Test_AssertEqual(block_size, entries[1].block_size);
+  Test_AssertEqual(block_num_samples, entries[1].num_samples);
+  Test_AssertEqual(SLADecoder_VerifyBlock(&data[entries[1].data_offset], entries[1].block_size,
+        NULL, &block_size, &block_num_samples), SLA_APIRESULT_OK);
+  Test_AssertEqual(block_size, entries[1].block_size);
+
+  /* 1ブロックに満たないデータ */
+  Test_AssertEqual(SLADecoder_VerifyBlock(&data[entries[1].data_offset], entries[1].block_size - 1,
+        &header, &block_size, &block_num_samples), SLA_APIRESULT_INSUFFICIENT_DATA_SIZE);
+
+  /* 末尾ブロックが途中で切れたデータ */
+  Test_AssertEqual(SLADecoder_VerifyStream(data, encoded_size - 1, &result), SLA_APIRESULT_INSUFFICIENT_DATA_SIZE);
+  Test_AssertEqual(result.num_blocks, num_entries - 1);
+  Test_AssertEqual(result.error_offset, entries[num_entries - 1].data_offset);
+
+  /* 末尾ブロックが丸ごと欠落したデータ: ヘッダのブロック数・サンプル数と合わない */
+  Test_AssertEqual(SLADecoder_VerifyStream(data, entries[num_entries - 1].data_offset, &result),
+      SLA_APIRESULT_DETECT_DATA_CORRUPTION);
+  Test_AssertEqual(result.num_blocks, num_entries - 1);
+  Test_AssertEqual(result.error_offset, entries[num_entries - 1].data_offset);
+
+  /* ヘッダの破壊 */
+  data[SLA_HEADER_SIZE - 1] ^= 0x5A;
+  Test_AssertEqual(SLADecoder_VerifyStream(data, encoded_size, &result), SLA_APIRESULT_DETECT_DATA_CORRUPTION);
+  Test_AssertEqual(result.num_blocks, 0);
+  data[SLA_HEADER_SIZE - 1] ^= 0x5A;
+
+  /* 同期コードの破壊 */
+  data[entries[2].data_offset] ^= 0x5A;
+  Test_AssertEqual(SLADecoder_VerifyStream(data, encoded_size, &result), SLA_APIRESULT_FAILED_TO_FIND_SYNC_CODE);
+  Test_AssertEqual(result.num_blocks, 2);
+  Test_AssertEqual(result.error_offset, entries[2].data_offset);
+  data[entries[2].data_offset] ^= 0x5A;
+
+  /* ブロックデータの破壊: CRC16の不一致を検出 */
+  data[entries[1].data_offset + entries[1].block_size / 2] ^= 0x5A;
+  Test_AssertEqual(SLADecoder_VerifyStream(data, encoded_size, &result), SLA_APIRESULT_DETECT_DATA_CORRUPTION);
+  Test_AssertEqual(result.num_blocks, 1);
+  Test_AssertEqual(result.error_offset, entries[1].data_offset);
+  Test_AssertEqual(SLADecoder_VerifyBlock(&data[entries[1].data_offset], entries[1].block_size,
+        &header, &block_size, &block_num_samples), SLA_APIRESULT_DETECT_DATA_CORRUPTION);
+
+  SLAEncoder_Destroy(encoder);
+  for (ch = 0; ch < num_channels; ch++) {
+    free(input_double[ch]);
+    free(input[ch]);
+  }
+  free(input_double);
+  free(input);
+  free(data);
+}
+
+/* ブロック索引ファイルのテスト */
+static void testSLAEncodeDecode_BlockIndexFileTest(void *obj)
+{
+  static const struct EncodeDecodeTestCase test_case = {
+    { 1, 16, 44100, 0 },
+    { 16, 1, 8, SLA_CHPROCESSMETHOD_NONE, SLA_WINDOWFUNCTIONTYPE_SIN, 4096 },
+    4096 * 8 + 100,
+    testSLAEncodeDecode_GenerateChirp };
+  uint32_t ch, i, num_channels, num_samples, data_size, encoded_size, num_blocks;
+  uint32_t index_size, output_size, entry_index, sample_position;
+  double   **input_double;
+  int32_t  **input;
+  uint8_t  *data, *index_data;
+  struct SLAEncoderConfig     encoder_config;
+  struct SLAEncoder*          encoder;
+  struct SLABlockIndexInfo    info;
+  struct SLABlockIndexEntry   entries[32], loaded[32];
+
+  TEST_UNUSED_PARAMETER(obj);
+
+  num_samples   = test_case.num_samples;
+  num_channels  = test_case.wave_format.num_channels;
+  data_size     = SLA_HEADER_SIZE + SLA_CalculateSufficientBlockSize(num_channels, num_samples, test_case.wave_format.bit_per_sample);
+
+  /* 一時領域の割り当て */
+  input_double  = (double **)malloc(sizeof(double*) * num_channels);
+  input         = (int32_t **)malloc(sizeof(int32_t*) * num_channels);
+  data          = (uint8_t *)malloc(data_size);
+  for (ch = 0; ch < num_channels; ch++) {
+    input_double[ch]  = (double *)malloc(sizeof(double) * num_samples);
+    input[ch]         = (int32_t *)malloc(sizeof(int32_t) * num_samples);
+  }
+
+  /* エンコード */
+  SLAEncoder_SetDefaultConfig(&encoder_config);
+  encoder = SLAEncoder_Create(&encoder_config);
+  test_case.gen_wave_func(input_double, num_channels, num_samples);
+  testSLAEncodeDecode_InputDoubleToInputFixedFloat(
+      &test_case.wave_format, input_double, input, num_channels, num_samples);
+  Test_AssertEqual(SLAEncoder_SetWaveFormat(encoder, &test_case.wave_format), SLA_APIRESULT_OK);
+  Test_AssertEqual(SLAEncoder_SetEncodeParameter(encoder, &test_case.encode_parameter), SLA_APIRESULT_OK);
+  Test_AssertEqual(SLAEncoder_EncodeWhole(encoder,
+        (const int32_t **)input, num_samples, data, data_size, &encoded_size), SLA_APIRESULT_OK);
+  Test_AssertEqual(SLADecoder_BuildBlockIndex(data, encoded_size, entries, 32, &num_blocks), SLA_APIRESULT_OK);
+
+  /* 索引ファイルの書き出し */
+  index_size = SLADecoder_CalculateBlockIndexFileSize(num_blocks);
+  Test_AssertEqual(index_size, SLA_BLOCK_INDEX_HEADER_SIZE + SLA_BLOCK_INDEX_ENTRY_SIZE * num_blocks);
+  /* 32bitで表現できるエントリ数の上限 */
+  {
+    const uint32_t max_entries = (UINT32_MAX - SLA_BLOCK_INDEX_HEADER_SIZE) / SLA_BLOCK_INDEX_ENTRY_SIZE;
+    Test_AssertEqual(SLADecoder_CalculateBlockIndexFileSize(max_entries),
+        SLA_BLOCK_INDEX_HEADER_SIZE + SLA_BLOCK_INDEX_ENTRY_SIZE * max_entries);
+    Test_AssertEqual(SLADecoder_CalculateBlockIndexFileSize(max_entries + 1), 0);
+    Test_AssertEqual(SLADecoder_CalculateBlockIndexFileSize(UINT32_MAX), 0);
+  }
+  index_data = (uint8_t *)malloc(index_size);
+  /* 桁あふれでサイズが小さく見えるエントリ数でもバッファサイズ判定をすり抜けない */
+  Test_AssertEqual(SLADecoder_EncodeBlockIndexFile(data, encoded_size,
+        entries, 165191050UL, index_data, index_size, &output_size), SLA_APIRESULT_INVALID_ARGUMENT);
+  Test_AssertEqual(SLADecoder_EncodeBlockIndexFile(data, encoded_size,
+        entries, num_blocks, index_data, index_size - 1, &output_size), SLA_APIRESULT_INSUFFICIENT_BUFFER_SIZE);
+  Test_AssertEqual(SLADecoder_EncodeBlockIndexFile(&data[1], encoded_size - 1,
+        entries, num_blocks, index_data, index_size, &output_size), SLA_APIRESULT_INVALID_HEADER_FORMAT);
+  Test_AssertEqual(SLADecoder_EncodeBlockIndexFile(data, encoded_size,
+        entries, num_blocks, index_data, index_size, &output_size), SLA_APIRESULT_OK);
+  Test_AssertEqual(output_size, index_size);
+
+  /* 読み込み: 情報のみ */
+  Test_AssertEqual(SLADecoder_DecodeBlockIndexFile(index_data, index_size, &info, NULL, 0), SLA_APIRESULT_OK);
+  Test_AssertEqual(info.num_entries, num_blocks);
+  Test_AssertEqual(info.num_samples, num_samples);
+  Test_AssertEqual(info.source_data_size, encoded_size);
+
+  /* 読み込み: エントリまで */
+  Test_AssertEqual(SLADecoder_DecodeBlockIndexFile(index_data, index_size, &info, loaded, num_blocks - 1),
+      SLA_APIRESULT_EXCEED_HANDLE_CAPACITY);
+  Test_AssertEqual(SLADecoder_DecodeBlockIndexFile(index_data, index_size - 1, &info, loaded, 32),
+      SLA_APIRESULT_INSUFFICIENT_DATA_SIZE);
+  Test_AssertEqual(SLADecoder_DecodeBlockIndexFile(index_data, index_size, &info, loaded, 32), SLA_APIRESULT_OK);
+  for (i = 0; i < num_blocks; i++) {
+    Test_AssertEqual(loaded[i].data_offset, entries[i].data_offset);
+    Test_AssertEqual(loaded[i].sample_offset, entries[i].sample_offset);
+    Test_AssertEqual(loaded[i].block_size, entries[i].block_size);
+    Test_AssertEqual(loaded[i].num_samples, entries[i].num_samples);
+    Test_AssertEqual(loaded[i].crc16, entries[i].crc16);
+  }
+
+  /* フォーマットバージョン1（オフセット・サンプル数が32bit）の索引も読める */
+  {
+    uint8_t *v1_data, *data_pos;
+    const uint32_t v1_size = SLA_BLOCK_INDEX_HEADER_SIZE_V1 + SLA_BLOCK_INDEX_ENTRY_SIZE_V1 * num_blocks;
+    struct SLABlockIndexInfo v1_info;
+    struct SLABlockIndexEntry v1_loaded[32];
+
+    v1_data = (uint8_t *)malloc(v1_size);
+    data_pos = v1_data;
+    SLAByteArray_PutUint8(data_pos, (uint8_t)'S');
+    SLAByteArray_PutUint8(data_pos, (uint8_t)'L');
+    SLAByteArray_PutUint8(data_pos, (uint8_t)'I');
+    SLAByteArray_PutUint8(data_pos, (uint8_t)'\1');
+    SLAByteArray_PutUint16(data_pos, 0);
+    SLAByteArray_PutUint32(data_pos, 1);
+    SLAByteArray_PutUint32(data_pos, encoded_size);
+    SLAByteArray_PutUint16(data_pos, info.source_header_crc16);
+    SLAByteArray_PutUint32(data_pos, num_samples);
+    SLAByteArray_PutUint32(data_pos, num_blocks);
+    for (i = 0; i < num_blocks; i++) {
+      SLAByteArray_PutUint32(data_pos, (uint32_t)entries[i].data_offset);
+      SLAByteArray_PutUint32(data_pos, (uint32_t)entries[i].sample_offset);
+      SLAByteArray_PutUint32(data_pos, entries[i].block_size);
+      SLAByteArray_PutUint32(data_pos, entries[i].num_samples);
+      SLAByteArray_PutUint16(data_pos, entries[i].crc16);
+    }
+    Test_AssertEqual((uint32_t)(data_pos - v1_data), v1_size);
+    SLAByteArray_WriteUint16(&v1_data[4], SLAUtility_CalculateCRC16(&v1_data[6], v1_size - 6));
+
+    Test_AssertEqual(SLADecoder_DecodeBlockIndexFile(v1_data, v1_size, &v1_info, v1_loaded, 32), SLA_APIRESULT_OK);
+    Test_AssertEqual(v1_info.num_entries, num_blocks);
+    Test_AssertEqual(v1_info.num_samples, num_samples);
+    Test_AssertEqual(v1_info.source_data_size, encoded_size);
+    Test_AssertEqual(SLADecoder_CheckBlockIndexSource(&v1_info, data, encoded_size), SLA_APIRESULT_OK);
+    for (i = 0; i < num_blocks; i++) {
+      Test_AssertEqual(v1_loaded[i].data_offset, entries[i].data_offset);
+      Test_AssertEqual(v1_loaded[i].sample_offset, entries[i].sample_offset);
+      Test_AssertEqual(v1_loaded[i].block_size, entries[i].block_size);
+    }
+    Test_AssertEqual(SLADecoder_DecodeBlockIndexFile(v1_data, v1_size - 1, &v1_info, v1_loaded, 32),
+        SLA_APIRESULT_INSUFFICIENT_DATA_SIZE);
+
+    /* 未知のバージョンは読まない */
+    SLAByteArray_WriteUint32(&v1_data[6], SLA_BLOCK_INDEX_FORMAT_VERSION + 1);
+    Test_AssertEqual(SLADecoder_DecodeBlockIndexFile(v1_data, v1_size, &v1_info, v1_loaded, 32),
+        SLA_APIRESULT_INVALID_HEADER_FORMAT);
+    free(v1_data);
+  }
+
+  /* 対象データとの対応確認 */
+  Test_AssertEqual(SLADecoder_CheckBlockIndexSource(&info, data, encoded_size), SLA_APIRESULT_OK);
+  Test_AssertEqual(SLADecoder_CheckBlockIndexSource(&info, data, encoded_size + 1), SLA_APIRESULT_INDEX_SOURCE_MISMATCH);
+
+  /* 二分探索: 全サンプル位置で線形探索の結果と一致するか */
+  for (sample_position = 0; sample_position < num_samples; sample_position += 97) {
+    uint32_t expected = 0;
+    for (i = 0; i < num_blocks; i++) {
+      if (entries[i].sample_offset <= sample_position) {
+        expected = i;
+      }
+    }
+    Test_AssertEqual(SLADecoder_SearchBlockIndex(loaded, num_blocks, sample_position, &entry_index), SLA_APIRESULT_OK);
+    Test_AssertEqual(entry_index, expected);
+  }
+  Test_AssertEqual(SLADecoder_SearchBlockIndex(loaded, num_blocks, num_samples - 1, &entry_index), SLA_APIRESULT_OK);
+  Test_AssertEqual(entry_index, num_blocks - 1);
+  Test_AssertEqual(SLADecoder_SearchBlockIndex(loaded, num_blocks, num_samples, &entry_index), SLA_APIRESULT_INVALID_ARGUMENT);
+
+  /* 索引の破損検出 */
+  index_data[SLA_BLOCK_INDEX_HEADER_SIZE + 3] ^= 0x01;
+  Test_AssertEqual(SLADecoder_DecodeBlockIndexFile(index_data, index_size, &info, loaded, 32),
+      SLA_APIRESULT_DETECT_DATA_CORRUPTION);
+  index_data[0] = 'X';
+  Test_AssertEqual(SLADecoder_DecodeBlockIndexFile(index_data, index_size, &info, loaded, 32),
+      SLA_APIRESULT_INVALID_HEADER_FORMAT);
+
+  SLAEncoder_Destroy(encoder);
+  for (ch = 0; ch < num_channels; ch++) {
+    free(input_double[ch]);
+    free(input[ch]);
+  }
+  free(input_double);
+  free(input);
+  free(data);
+  free(index_data);
+}
+
+/* サンプル範囲デコードのテスト */
+static void testSLAEncodeDecode_DecodeRangeTest(void *obj)
+{
+  static const struct EncodeDecodeTestCase test_case = {
+    { 2, 16, 44100, 0 },
+    { 16, 1, 8, SLA_CHPROCESSMETHOD_STEREO_MS, SLA_WINDOWFUNCTIONTYPE_SIN, 4096 },
+    4096 * 8 + 100,
+    testSLAEncodeDecode_GenerateChirp };
+  /* 開始サンプルと長さの組 */
+  static const uint32_t ranges[][2] = {
+    { 0, 4096 * 8 + 100 },    /* 全体 */
+    { 0, 1 },                 /* 先頭1サンプル */
+    { 100, 5000 },            /* ブロックをまたぐ */
+    { 4096, 4096 },           /* ブロックとずれない範囲 */
+    { 5000, 10 },             /* ブロック内部 */
+    { 4096 * 8 + 90, 100 },   /* 末尾を超える（切り詰め） */
+  };
+  uint32_t ch, i, r, num_channels, num_samples, data_size, encoded_size;
+  uint32_t num_blocks, output_num_samples, expected_num_samples, use_index;
+  double   **input_double;
+  int32_t  **input, **output;
+  uint8_t  *data;
+  struct SLAEncoderConfig     encoder_config;
+  struct SLADecoderConfig     decoder_config;
+  struct SLAEncoder*          encoder;
+  struct SLADecoder*          decoder;
+  struct SLABlockIndexEntry   entries[32];
+
+  TEST_UNUSED_PARAMETER(obj);
+
+  num_samples   = test_case.num_samples;
+  num_channels  = test_case.wave_format.num_channels;
+  data_size     = SLA_HEADER_SIZE + SLA_CalculateSufficientBlockSize(num_channels, num_samples, test_case.wave_format.bit_per_sample);
+
+  /* 一時領域の割り当て */
+  input_double  = (double **)malloc(sizeof(double*) * num_channels);
+  input         = (int32_t **)malloc(sizeof(int32_t*) * num_channels);
+  output        = (int32_t **)malloc(sizeof(int32_t*) * num_channels);
+  data          = (uint8_t *)malloc(data_size);
+  for (ch = 0; ch < num_channels; ch++) {
+    input_double[ch]  = (double *)malloc(sizeof(double) * num_samples);
+    input[ch]         = (int32_t *)malloc(sizeof(int32_t) * num_samples);
+    output[ch]        = (int32_t *)malloc(sizeof(int32_t) * num_samples);
+  }
+
+  /* エンコード */
+  SLAEncoder_SetDefaultConfig(&encoder_config);
+  SLADecoder_SetDefaultConfig(&decoder_config);
+  encoder = SLAEncoder_Create(&encoder_config);
+  decoder = SLADecoder_Create(&decoder_config);
+  test_case.gen_wave_func(input_double, num_channels, num_samples);
+  testSLAEncodeDecode_InputDoubleToInputFixedFloat(
+      &test_case.wave_format, input_double, input, num_channels, num_samples);
+  Test_AssertEqual(SLAEncoder_SetWaveFormat(encoder, &test_case.wave_format), SLA_APIRESULT_OK);
+  Test_AssertEqual(SLAEncoder_SetEncodeParameter(encoder, &test_case.encode_parameter), SLA_APIRESULT_OK);
+  Test_AssertEqual(SLAEncoder_EncodeWhole(encoder,
+        (const int32_t **)input, num_samples, data, data_size, &encoded_size), SLA_APIRESULT_OK);
+  Test_AssertEqual(SLADecoder_BuildBlockIndex(data, encoded_size, entries, 32, &num_blocks), SLA_APIRESULT_OK);
+
+  /* 索引あり/なしの両方で、各範囲の出力が入力と一致するか */
+  for (use_index = 0; use_index < 2; use_index++) {
+    for (r = 0; r < sizeof(ranges) / sizeof(ranges[0]); r++) {
+      uint8_t is_ok = 1;
+      expected_num_samples = SLAUTILITY_MIN(ranges[r][1], num_samples - ranges[r][0]);
+      for (ch = 0; ch < num_channels; ch++) {
+        memset(output[ch], 0, sizeof(int32_t) * num_samples);
+      }
+      Test_AssertEqual(SLADecoder_DecodeRange(decoder, data, encoded_size,
+            (use_index != 0) ? entries : NULL, (use_index != 0) ? num_blocks : 0,
+            ranges[r][0], ranges[r][1], output, num_samples, &output_num_samples), SLA_APIRESULT_OK);
+      Test_AssertEqual(output_num_samples, expected_num_samples);
+      for (ch = 0; ch < num_channels; ch++) {
+        for (i = 0; i < expected_num_samples; i++) {
+          if (output[ch][i] != input[ch][ranges[r][0] + i]) {
+            is_ok = 0;
+            break;
+          }
+        }
+      }
+      Test_AssertEqual(is_ok, 1);
+    }
+  }
+
+  /* 異常系 */
+  Test_AssertEqual(SLADecoder_DecodeRange(NULL, data, encoded_size,
+        NULL, 0, 0, 10, output, num_samples, &output_num_samples), SLA_APIRESULT_INVALID_ARGUMENT);
+  Test_AssertEqual(SLADecoder_DecodeRange(decoder, data, encoded_size,
+        NULL, 0, num_samples, 10, output, num_samples, &output_num_samples), SLA_APIRESULT_INVALID_ARGUMENT);
+  Test_AssertEqual(SLADecoder_DecodeRange(decoder, data, encoded_size,
+        entries, num_blocks, 100, 5000, output, 4999, &output_num_samples), SLA_APIRESULT_INSUFFICIENT_BUFFER_SIZE);
+  Test_AssertEqual(SLADecoder_DecodeRange(decoder, data, entries[2].data_offset,
+        NULL, 0, entries[2].sample_offset, 10, output, num_samples, &output_num_samples), SLA_APIRESULT_INSUFFICIENT_DATA_SIZE);
+
+  /* 壊れたブロックサイズで辿り先が範囲外・桁あふれしないか */
+  {
+    uint8_t* block_size_pos = &data[entries[0].data_offset + 2];
+    uint32_t block_size_field = SLAByteArray_ReadUint32(block_size_pos);
+    struct SLABlockIndexEntry bad_entry;
+    SLAByteArray_WriteUint32(block_size_pos, 0xFFFFFFFFUL);
+    Test_AssertEqual(SLADecoder_DecodeRange(decoder, data, encoded_size,
+          NULL, 0, entries[2].sample_offset, 10, output, num_samples, &output_num_samples), SLA_APIRESULT_DETECT_DATA_CORRUPTION);
+    SLAByteArray_WriteUint32(block_size_pos, 0xFFFFFFFFUL - SLA_BLOCK_SIZE_FIELD_END_OFFSET - entries[0].data_offset);
+    Test_AssertEqual(SLADecoder_DecodeRange(decoder, data, encoded_size,
+          NULL, 0, entries[2].sample_offset, 10, output, num_samples, &output_num_samples), SLA_APIRESULT_INSUFFICIENT_DATA_SIZE);
+    SLAByteArray_WriteUint32(block_size_pos, encoded_size);
+    Test_AssertEqual(SLADecoder_DecodeRange(decoder, data, encoded_size,
+          NULL, 0, entries[2].sample_offset, 10, output, num_samples, &output_num_samples), SLA_APIRESULT_INSUFFICIENT_DATA_SIZE);
+    SLAByteArray_WriteUint32(block_size_pos, block_size_field);
+    /* 索引の位置がデータ外 */
+    bad_entry = entries[0];
+    bad_entry.data_offset = 0xFFFFFFF0UL;
+    Test_AssertEqual(SLADecoder_DecodeRange(decoder, data, encoded_size,
+          &bad_entry, 1, 0, 10, output, num_samples, &output_num_samples), SLA_APIRESULT_INSUFFICIENT_DATA_SIZE);
+  }
+
+  /* ブロックキャッシュ経由: 2周目は全てキャッシュから取り出す */
+  {
+    struct SLABlockCacheConfig      cache_config;
+    struct SLABlockCache*           cache;
+    struct SLABlockCacheStatistics  cache_stats;
+    uint32_t pass, num_misses, num_hits;
+
+    cache_config.max_num_channels       = decoder_config.max_num_channels;
+    cache_config.max_num_block_samples  = decoder_config.max_num_block_samples;
+    cache_config.max_cache_size         = 64 * sizeof(int32_t) * decoder_config.max_num_channels * decoder_config.max_num_block_samples;
+    cache_config.num_shards             = 4;
+    cache_config.lock                   = NULL;
+    cache_config.unlock                 = NULL;
+    cache_config.lock_context           = NULL;
+    cache = SLABlockCache_Create(&cache_config);
+    Test_AssertCondition(cache != NULL);
+    Test_AssertEqual(SLADecoder_SetBlockCache(decoder, cache, 3), SLA_APIRESULT_OK);
+
+    for (pass = 0; pass < 2; pass++) {
+      for (r = 0; r < sizeof(ranges) / sizeof(ranges[0]); r++) {
+        uint8_t is_ok = 1;
+        expected_num_samples = SLAUTILITY_MIN(ranges[r][1], num_samples - ranges[r][0]);
+        for (ch = 0; ch < num_channels; ch++) {
+          memset(output[ch], 0, sizeof(int32_t) * num_samples);
+        }
+        Test_AssertEqual(SLADecoder_DecodeRange(decoder, data, encoded_size,
+              (pass != 0) ? entries : NULL, (pass != 0) ? num_blocks : 0,
+              ranges[r][0], ranges[r][1], output, num_samples, &output_num_samples), SLA_APIRESULT_OK);
+        Test_AssertEqual(output_num_samples, expected_num_samples);
+        for (ch = 0; ch < num_channels; ch++) {
+          for (i = 0; i < expected_num_samples; i++) {
+            if (output[ch][i] != input[ch][ranges[r][0] + i]) {
+              is_ok = 0;
+              break;
+            }
+          }
+        }
+        Test_AssertEqual(is_ok, 1);
+      }
+      /* 1周目で全ブロックを格納済み */
+      if (pass == 0) {
+        Test_AssertEqual(SLABlockCache_GetStatistics(cache, &cache_stats), SLA_APIRESULT_OK);
+        Test_AssertEqual(cache_stats.num_used_slots, num_blocks);
+      }
+      num_misses = cache_stats.num_misses;
+      num_hits   = cache_stats.num_hits;
+    }
+    Test_AssertEqual(SLABlockCache_GetStatistics(cache, &cache_stats), SLA_APIRESULT_OK);
+    Test_AssertEqual(cache_stats.num_misses, num_misses);
+    Test_AssertCondition(cache_stats.num_hits > num_hits);
+
+    /* リセットでキャッシュの参照が外れる */
+    Test_AssertEqual(SLADecoder_Reset(decoder), SLA_APIRESULT_OK);
+    num_hits = cache_stats.num_hits;
+    Test_AssertEqual(SLADecoder_DecodeRange(decoder, data, encoded_size,
+          NULL, 0, 0, 10, output, num_samples, &output_num_samples), SLA_APIRESULT_OK);
+    Test_AssertEqual(SLABlockCache_GetStatistics(cache, &cache_stats), SLA_APIRESULT_OK);
+    Test_AssertEqual(cache_stats.num_hits, num_hits);
+
+    SLABlockCache_Destroy(cache);
+  }
+
+  SLADecoder_Destroy(decoder);
+  SLAEncoder_Destroy(encoder);
+  for (ch = 0; ch < num_channels; ch++) {
+    free(input_double[ch]);
+    free(input[ch]);
+    free(output[ch]);
+  }
+  free(input_double);
+  free(input);
+  free(output);
+  free(data);
+}
+
+/* 分割入力でのエンコードとブロック単位デコードのテスト */
+static void testSLAEncodeDecode_EncodePartitionedBlocksTest(void *obj)
+{
+  static const struct EncodeDecodeTestCase test_case = {
+    { 2, 16, 44100, 2 },
+    { 16, 1, 8, SLA_CHPROCESSMETHOD_STEREO_MS, SLA_WINDOWFUNCTIONTYPE_SIN, 4096 },
+    4096 * 5 + 100,
+    testSLAEncodeDecode_GenerateChirp };
+  uint32_t ch, smpl, num_channels, num_samples, data_size, encoded_size, offset, bit_mask;
+  uint32_t num_encode_samples, block_size, block_num_samples, is_ok;
+  double   **input_double;
+  int32_t  **input, **output;
+  const int32_t* input_ptr[2];
+  int32_t* output_ptr[2];
+  uint8_t  *whole_data, *data;
+  struct SLAEncoderConfig     encoder_config;
+  struct SLADecoderConfig     decoder_config;
+  struct SLAEncoder*          encoder;
+  struct SLADecoder*          decoder;
+  struct SLAWaveFormat        wave_format;
+  struct SLAHeaderInfo        header;
+
+  TEST_UNUSED_PARAMETER(obj);
+
+  num_samples   = test_case.num_samples;
+  num_channels  = test_case.wave_format.num_channels;
+  data_size     = SLA_HEADER_SIZE + SLA_CalculateSufficientBlockSize(num_channels, num_samples, test_case.wave_format.bit_per_sample);
+
+  /* 一時領域の割り当て */
+  input_double  = (double **)malloc(sizeof(double*) * num_channels);
+  input         = (int32_t **)malloc(sizeof(int32_t*) * num_channels);
+  output        = (int32_t **)malloc(sizeof(int32_t*) * num_channels);
+  whole_data    = (uint8_t *)malloc(data_size);
+  data          = (uint8_t *)malloc(data_size);
+  for (ch = 0; ch < num_channels; ch++) {
+    input_double[ch]  = (double *)malloc(sizeof(double) * num_samples);
+    input[ch]         = (int32_t *)malloc(sizeof(int32_t) * num_samples);
+    output[ch]        = (int32_t *)malloc(sizeof(int32_t) * num_samples);
+  }
+
+  SLAEncoder_SetDefaultConfig(&encoder_config);
+  SLADecoder_SetDefaultConfig(&decoder_config);
+  encoder = SLAEncoder_Create(&encoder_config);
+  decoder = SLADecoder_Create(&decoder_config);
+  test_case.gen_wave_func(input_double, num_channels, num_samples);
+  testSLAEncodeDecode_InputDoubleToInputFixedFloat(
+      &test_case.wave_format, input_double, input, num_channels, num_samples);
+
+  /* 一括エンコード */
+  Test_AssertEqual(SLAEncoder_SetWaveFormat(encoder, &test_case.wave_format), SLA_APIRESULT_OK);
+  Test_AssertEqual(SLAEncoder_SetEncodeParameter(encoder, &test_case.encode_parameter), SLA_APIRESULT_OK);
+  Test_AssertEqual(SLAEncoder_EncodeWhole(encoder,
+        (const int32_t **)input, num_samples, whole_data, data_size, &encoded_size), SLA_APIRESULT_OK);
+
+  /* ビットパターンからの左シフト量は一括エンコードと一致 */
+  bit_mask = 0;
+  for (ch = 0; ch < num_channels; ch++) {
+    for (smpl = 0; smpl < num_samples; smpl++) {
+      bit_mask |= (uint32_t)input[ch][smpl];
+    }
+  }
+  wave_format = test_case.wave_format;
+  wave_format.offset_lshift = SLAEncoder_CalculateLeftShiftOffsetFromBitMask(wave_format.bit_per_sample, bit_mask);
+  Test_AssertEqual(wave_format.offset_lshift, test_case.wave_format.offset_lshift);
+  Test_AssertEqual(SLAEncoder_CalculateLeftShiftOffsetFromBitMask(16, 0), 0);
+
+  /* 最大ブロックサンプル数ずつ分割してエンコード */
+  Test_AssertEqual(SLAEncoder_SetWaveFormat(encoder, &wave_format), SLA_APIRESULT_OK);
+  header.wave_format        = wave_format;
+  header.encode_param       = test_case.encode_parameter;
+  header.num_samples        = num_samples;
+  header.num_blocks         = 0;
+  header.max_block_size     = 0;
+  header.max_bit_per_second = 0;
+  offset = SLA_HEADER_SIZE;
+  for (smpl = 0; smpl < num_samples; smpl += num_encode_samples) {
+    num_encode_samples = SLAUTILITY_MIN(test_case.encode_parameter.max_num_block_samples, num_samples - smpl);
+    for (ch = 0; ch < num_channels; ch++) {
+      input_ptr[ch] = &input[ch][smpl];
+    }
+    Test_AssertEqual(SLAEncoder_EncodePartitionedBlocks(encoder,
+          input_ptr, num_encode_samples, &data[offset], data_size - offset, &encoded_size, &header), SLA_APIRESULT_OK);
+    offset += encoded_size;
+  }
+  Test_AssertEqual(SLAEncoder_EncodeHeader(&header, data, data_size), SLA_APIRESULT_OK);
+
+  /* 一括エンコードとバイト単位で一致 */
+  Test_AssertEqual(SLAEncoder_EncodeWhole(encoder,
+        (const int32_t **)input, num_samples, whole_data, data_size, &encoded_size), SLA_APIRESULT_OK);
+  Test_AssertEqual(offset, encoded_size);
+  Test_AssertEqual(memcmp(data, whole_data, encoded_size), 0);
+
+  /* ブロックサイズを調べながら1ブロックずつデコード */
+  Test_AssertEqual(SLADecoder_SetWaveFormat(decoder, &header.wave_format), SLA_APIRESULT_OK);
+  Test_AssertEqual(SLADecoder_SetEncodeParameter(decoder, &header.encode_param), SLA_APIRESULT_OK);
+  offset = SLA_HEADER_SIZE;
+  smpl = 0;
+  while (offset < encoded_size) {
+    Test_AssertEqual(SLADecoder_GetBlockSize(&data[offset], encoded_size - offset, &block_size), SLA_APIRESULT_OK);
+    for (ch = 0; ch < num_channels; ch++) {
+      output_ptr[ch] = &output[ch][smpl];
+    }
+    /* ブロックに満たないデータ */
+    Test_AssertEqual(SLADecoder_DecodeBlock(decoder, &data[offset], block_size - 1,
+          output_ptr, num_samples - smpl, &block_size, &block_num_samples), SLA_APIRESULT_INSUFFICIENT_DATA_SIZE);
+    Test_AssertEqual(SLADecoder_GetBlockSize(&data[offset], encoded_size - offset, &block_size), SLA_APIRESULT_OK);
+    Test_AssertEqual(SLADecoder_DecodeBlock(decoder, &data[offset], block_size,
+          output_ptr, num_samples - smpl, &block_size, &block_num_samples), SLA_APIRESULT_OK);
+    offset += block_size;
+    smpl   += block_num_samples;
+  }
+  Test_AssertEqual(smpl, num_samples);
+  is_ok = 1;
+  for (ch = 0; ch < num_channels; ch++) {
+    if (memcmp(input[ch], output[ch], sizeof(int32_t) * num_samples) != 0) {
+      is_ok = 0;
+    }
+  }
+  Test_AssertEqual(is_ok, 1);
+
+  /* 異常系 */
+  Test_AssertEqual(SLADecoder_GetBlockSize(data, SLA_HEADER_SIZE, &block_size), SLA_APIRESULT_FAILED_TO_FIND_SYNC_CODE);
+  Test_AssertEqual(SLADecoder_GetBlockSize(&data[SLA_HEADER_SIZE], 5, &block_size), SLA_APIRESULT_INSUFFICIENT_DATA_SIZE);
+  Test_AssertEqual(SLADecoder_GetBlockSize(NULL, 5, &block_size), SLA_APIRESULT_INVALID_ARGUMENT);
+  Test_AssertEqual(SLAEncoder_EncodePartitionedBlocks(encoder,
+        (const int32_t **)input, test_case.encode_parameter.max_num_block_samples + 1,
+        data, data_size, &encoded_size, &header), SLA_APIRESULT_INVALID_ARGUMENT);
+  Test_AssertEqual(SLAEncoder_EncodePartitionedBlocks(encoder,
+        (const int32_t **)input, 100, data, data_size, &encoded_size, NULL), SLA_APIRESULT_INVALID_ARGUMENT);
+
+  SLADecoder_Destroy(decoder);
+  SLAEncoder_Destroy(encoder);
+  for (ch = 0; ch < num_channels; ch++) {
+    free(input_double[ch]);
+    free(input[ch]);
+    free(output[ch]);
+  }
+  free(input_double);
+  free(input);
+  free(output);
+  free(whole_data);
+  free(data);
+}
+
+/* 16bitに収まらないサンプル数のブロックのテスト */
+static void testSLAEncodeDecode_LargeBlockTest(void *obj)
+{
+  static const struct EncodeDecodeTestCase test_case = {
+    { 2, 16, 44100, 0 },
+    { 8, 1, 8, SLA_CHPROCESSMETHOD_STEREO_MS, SLA_WINDOWFUNCTIONTYPE_SIN, 131072 },
+    131072 + 5000,
+    testSLAEncodeDecode_GenerateSinWave };
+  uint32_t ch, smpl, num_channels, num_samples, data_size, encoded_size, offset;
+  uint32_t block_size, block_num_samples, sample_progress, data_progress, is_ok, is_escaped;
+  double   **input_double;
+  int32_t  **input, **output;
+  uint8_t  *data;
+  struct SLAEncoderConfig           encoder_config;
+  struct SLADecoderConfig           decoder_config;
+  struct SLAStreamingDecoderConfig  streaming_decoder_config;
+  struct SLAEncoder*                encoder;
+  struct SLADecoder*                decoder;
+  struct SLAStreamingDecoder*       streaming_decoder;
+  struct SLAHeaderInfo              header;
+
+  TEST_UNUSED_PARAMETER(obj);
+
+  num_samples   = test_case.num_samples;
+  num_channels  = test_case.wave_format.num_channels;
+  data_size     = SLA_HEADER_SIZE + SLA_CalculateSufficientBlockSize(num_channels, num_samples, test_case.wave_format.bit_per_sample);
+
+  /* 一時領域の割り当て */
+  input_double  = (double **)malloc(sizeof(double*) * num_channels);
+  input         = (int32_t **)malloc(sizeof(int32_t*) * num_channels);
+  output        = (int32_t **)malloc(sizeof(int32_t*) * num_channels);
+  data          = (uint8_t *)malloc(data_size);
+  for (ch = 0; ch < num_channels; ch++) {
+    input_double[ch]  = (double *)malloc(sizeof(double) * num_samples);
+    input[ch]         = (int32_t *)malloc(sizeof(int32_t) * num_samples);
+    output[ch]        = (int32_t *)malloc(sizeof(int32_t) * num_samples);
+  }
+
+  /* ブロックあたりサンプル数を大きくしてハンドル作成 */
+  SLAEncoder_SetDefaultConfig(&encoder_config);
+  SLAStreamingDecoder_SetDefaultConfig(&streaming_decoder_config);
+  encoder_config.max_num_block_samples = test_case.encode_parameter.max_num_block_samples;
+  streaming_decoder_config.core_config.max_num_block_samples = test_case.encode_parameter.max_num_block_samples;
+  streaming_decoder_config.core_config.enable_crc_check = 1;
+  decoder_config = streaming_decoder_config.core_config;
+  encoder = SLAEncoder_Create(&encoder_config);
+  decoder = SLADecoder_Create(&decoder_config);
+  streaming_decoder = SLAStreamingDecoder_Create(&streaming_decoder_config);
+  Test_AssertCondition((encoder != NULL) && (decoder != NULL) && (streaming_decoder != NULL));
+  test_case.gen_wave_func(input_double, num_channels, num_samples);
+  testSLAEncodeDecode_InputDoubleToInputFixedFloat(
+      &test_case.wave_format, input_double, input, num_channels, num_samples);
+
+  /* エンコード */
+  Test_AssertEqual(SLAEncoder_SetWaveFormat(encoder, &test_case.wave_format), SLA_APIRESULT_OK);
+  Test_AssertEqual(SLAEncoder_SetEncodeParameter(encoder, &test_case.encode_parameter), SLA_APIRESULT_OK);
+  Test_AssertEqual(SLAEncoder_EncodeWhole(encoder,
+        (const int32_t **)input, num_samples, data, data_size, &encoded_size), SLA_APIRESULT_OK);
+  Test_AssertEqual(SLADecoder_DecodeHeader(data, encoded_size, &header), SLA_APIRESULT_OK);
+  Test_AssertEqual(header.encode_param.max_num_block_samples, test_case.encode_parameter.max_num_block_samples);
+
+  /* ブロックサンプル数: 16bitに収まらないときだけエスケープして32bitで記録 */
+  offset = header.header_size;
+  smpl = 0;
+  is_escaped = 0;
+  while (offset < encoded_size) {
+    Test_AssertEqual(SLADecoder_GetBlockSize(&data[offset], encoded_size - offset, &block_size), SLA_APIRESULT_OK);
+    block_num_samples = SLAUtility_GetBlockNumSamples(&data[offset], block_size);
+    Test_AssertCondition(block_num_samples > 0);
+    if (block_num_samples > SLA_BLOCK_NUM_SAMPLES_16BIT_MAX) {
+      Test_AssertEqual(SLAByteArray_ReadUint16(&data[offset + SLA_BLOCK_CRC16_CALC_START_OFFSET]), SLA_BLOCK_NUM_SAMPLES_ESCAPE);
+      Test_AssertEqual(SLAUtility_GetBlockNumSamples(&data[offset], SLA_EXTENDED_BLOCK_HEADER_SIZE - 1), 0);
+      is_escaped = 1;
+    } else {
+      Test_AssertEqual(SLAByteArray_ReadUint16(&data[offset + SLA_BLOCK_CRC16_CALC_START_OFFSET]), block_num_samples);
+    }
+    offset += block_size;
+    smpl   += block_num_samples;
+  }
+  Test_AssertEqual(smpl, num_samples);
+  Test_AssertEqual(is_escaped, 1);
+
+  /* 一括デコード */
+  Test_AssertEqual(SLADecoder_DecodeWhole(decoder,
+        data, encoded_size, output, num_samples, &smpl), SLA_APIRESULT_OK);
+  Test_AssertEqual(smpl, num_samples);
+  is_ok = 1;
+  for (ch = 0; ch < num_channels; ch++) {
+    if (memcmp(input[ch], output[ch], sizeof(int32_t) * num_samples) != 0) {
+      is_ok = 0;
+    }
+  }
+  Test_AssertEqual(is_ok, 1);
+
+  /* ストリーミングデコード（1ブロックのデコード中に保持するデータ片も多くなる） */
+  for (ch = 0; ch < num_channels; ch++) {
+    memset(output[ch], 0, sizeof(int32_t) * num_samples);
+  }
+  Test_AssertEqual(SLAStreamingDecoder_SetWaveFormat(streaming_decoder, &header.wave_format), SLA_APIRESULT_OK);
+  Test_AssertEqual(SLAStreamingDecoder_SetEncodeParameter(streaming_decoder, &header.encode_param), SLA_APIRESULT_OK);
+  sample_progress = 0;
+  data_progress = header.header_size;
+  is_ok = 1;
+  while (sample_progress < num_samples) {
+    uint32_t put_data_size, estimate_min_data_size, tmp_output_samples, dummy_out_size;
+    const uint8_t* dummy_out_ptr;
+    int32_t* output_ptr[2];
+
+    if (sample_progress == 0) {
+      estimate_min_data_size = header.max_block_size;
+    } else {
+      SLAStreamingDecoder_EstimateMinimumNessesaryDataSize(streaming_decoder, &estimate_min_data_size);
+    }
+    put_data_size = SLAUTILITY_MIN(estimate_min_data_size, encoded_size - data_progress);
+    if ((SLAStreamingDecoder_AppendDataFragment(streaming_decoder,
+            &data[data_progress], put_data_size) != SLA_APIRESULT_OK)) {
+      is_ok = 0;
+      break;
+    }
+    for (ch = 0; ch < num_channels; ch++) {
+      output_ptr[ch] = &output[ch][sample_progress];
+    }
+    if (SLAStreamingDecoder_Decode(streaming_decoder,
+          output_ptr, num_samples - sample_progress, &tmp_output_samples) != SLA_APIRESULT_OK) {
+      is_ok = 0;
+      break;
+    }
+    while (SLAStreamingDecoder_CollectDataFragment(streaming_decoder,
+          &dummy_out_ptr, &dummy_out_size) == SLA_APIRESULT_OK) ;
+    data_progress   += put_data_size;
+    sample_progress += tmp_output_samples;
+  }
+  Test_AssertEqual(is_ok, 1);
+  for (ch = 0; ch < num_channels; ch++) {
+    if (memcmp(input[ch], output[ch], sizeof(int32_t) * num_samples) != 0) {
+      is_ok = 0;
+    }
+  }
+  Test_AssertEqual(is_ok, 1);
+
+  SLAStreamingDecoder_Destroy(streaming_decoder);
+  SLADecoder_Destroy(decoder);
+  SLAEncoder_Destroy(encoder);
+  for (ch = 0; ch < num_channels; ch++) {
+    free(input_double[ch]);
+    free(input[ch]);
+    free(output[ch]);
+  }
+  free(input_double);
+  free(input);
+  free(output);
+  free(data);
+}
+
+/* ハンドルプールと一括デコードのテスト */
+/* 一括デコードのテスト用スレッド: 起動時は記録だけ行い、join時に実行する */
+struct DecodeBatchTestThread {
+  void (*func)(void* arg);
+  void* arg;
+};
+struct DecodeBatchTestThreadPool {
+  struct DecodeBatchTestThread threads[4];
+  uint32_t num_spawned;
+  uint32_t num_joined;
+};
+
+/* テスト用スレッド起動 */
+static void* testSLAEncodeDecode_DecodeBatchTestSpawn(void (*func)(void* arg), void* arg, void* user_data)
+{
+  struct DecodeBatchTestThreadPool* thread_pool = (struct DecodeBatchTestThreadPool *)user_data;
+  struct DecodeBatchTestThread* thread;
+
+  if (thread_pool->num_spawned >= sizeof(thread_pool->threads) / sizeof(thread_pool->threads[0])) {
+    return NULL;
+  }
+  thread = &thread_pool->threads[thread_pool->num_spawned++];
+  thread->func = func;
+  thread->arg = arg;
+  return thread;
+}
+
+/* テスト用スレッド起動（常に失敗） */
+static void* testSLAEncodeDecode_DecodeBatchTestSpawnFail(void (*func)(void* arg), void* arg, void* user_data)
+{
+  TEST_UNUSED_PARAMETER(func);
+  TEST_UNUSED_PARAMETER(arg);
+  TEST_UNUSED_PARAMETER(user_data);
+  return NULL;
+}
+
+/* テスト用スレッド終了待ち */
+static void testSLAEncodeDecode_DecodeBatchTestJoin(void* thread, void* user_data)
+{
+  struct DecodeBatchTestThreadPool* thread_pool = (struct DecodeBatchTestThreadPool *)user_data;
+  struct DecodeBatchTestThread* test_thread = (struct DecodeBatchTestThread *)thread;
+
+  test_thread->func(test_thread->arg);
+  thread_pool->num_joined++;
+}
+
+static void testSLAEncodeDecode_DecodeBatchTest(void *obj)
+{
+#define NUM_BATCH_ITEMS 3
+  static const struct EncodeDecodeTestCase test_cases[NUM_BATCH_ITEMS] = {
+    { { 2, 16, 44100, 0 },
+      { 16, 1, 8, SLA_CHPROCESSMETHOD_STEREO_MS, SLA_WINDOWFUNCTIONTYPE_SIN, 4096 },
+      8192, testSLAEncodeDecode_GenerateChirp },
+    { { 1, 24, 48000, 0 },
+      { 8, 1, 4, SLA_CHPROCESSMETHOD_NONE, SLA_WINDOWFUNCTIONTYPE_SIN, 2048 },
+      3000, testSLAEncodeDecode_GenerateSinWave },
+    { { 2, 16, 44100, 0 },
+      { 16, 1, 8, SLA_CHPROCESSMETHOD_NONE, SLA_WINDOWFUNCTIONTYPE_SIN, 4096 },
+      5000, testSLAEncodeDecode_GenerateWhiteNoise },
+  };
+  uint32_t i, ch, smpl;
+  int32_t is_ok;
+  double**  input_double[NUM_BATCH_ITEMS];
+  int32_t** input[NUM_BATCH_ITEMS];
+  int32_t** output[NUM_BATCH_ITEMS];
+  uint8_t*  data[NUM_BATCH_ITEMS];
+  uint32_t  encoded_size[NUM_BATCH_ITEMS];
+  struct SLADecodeBatchItem items[NUM_BATCH_ITEMS];
+  struct SLAEncoderConfig encoder_config;
+  struct SLADecoderConfig decoder_config;
+  struct SLAEncoder*      encoder;
+  struct SLADecoderPool*  pool;
+
+  TEST_UNUSED_PARAMETER(obj);
+
+  SLAEncoder_SetDefaultConfig(&encoder_config);
+  SLADecoder_SetDefaultConfig(&decoder_config);
+  encoder = SLAEncoder_Create(&encoder_config);
+
+  /* 入力データを作ってエンコード */
+  for (i = 0; i < NUM_BATCH_ITEMS; i++) {
+    const struct EncodeDecodeTestCase* test_case = &test_cases[i];
+    uint32_t num_channels = test_case->wave_format.num_channels;
+    uint32_t num_samples = test_case->num_samples;
+    uint32_t data_size = SLA_HEADER_SIZE
+      + SLA_CalculateSufficientBlockSize(num_channels, num_samples, test_case->wave_format.bit_per_sample);
+
+    input_double[i] = (double **)malloc(sizeof(double*) * num_channels);
+    input[i]        = (int32_t **)malloc(sizeof(int32_t*) * num_channels);
+    output[i]       = (int32_t **)malloc(sizeof(int32_t*) * num_channels);
+    data[i]         = (uint8_t *)malloc(data_size);
+    for (ch = 0; ch < num_channels; ch++) {
+      input_double[i][ch] = (double *)malloc(sizeof(double) * num_samples);
+      input[i][ch]        = (int32_t *)malloc(sizeof(int32_t) * num_samples);
+      output[i][ch]       = (int32_t *)malloc(sizeof(int32_t) * num_samples);
+    }
+    test_case->gen_wave_func(input_double[i], num_channels, num_samples);
+    testSLAEncodeDecode_InputDoubleToInputFixedFloat(
+        &test_case->wave_format, input_double[i], input[i], num_channels, num_samples);
+    Test_AssertEqual(SLAEncoder_SetWaveFormat(encoder, &test_case->wave_format), SLA_APIRESULT_OK);
+    Test_AssertEqual(SLAEncoder_SetEncodeParameter(encoder, &test_case->encode_parameter), SLA_APIRESULT_OK);
+    Test_AssertEqual(SLAEncoder_EncodeWhole(encoder,
+          (const int32_t **)input[i], num_samples, data[i], data_size, &items[i].data_size), SLA_APIRESULT_OK);
+    encoded_size[i]             = items[i].data_size;
+    items[i].data               = data[i];
+    items[i].buffer             = output[i];
+    items[i].buffer_num_samples = num_samples;
+  }
+
+  /* プールの生成と貸出 */
+  Test_AssertCondition(SLADecoderPool_Create(NULL, 2) == NULL);
+  Test_AssertCondition(SLADecoderPool_Create(&decoder_config, 0) == NULL);
+  pool = SLADecoderPool_Create(&decoder_config, 2);
+  Test_AssertCondition(pool != NULL);
+  {
+    struct SLADecoder *decoder1, *decoder2;
+    decoder1 = SLADecoderPool_Acquire(pool);
+    decoder2 = SLADecoderPool_Acquire(pool);
+    Test_AssertCondition((decoder1 != NULL) && (decoder2 != NULL) && (decoder1 != decoder2));
+    Test_AssertCondition(SLADecoderPool_Acquire(pool) == NULL);
+    Test_AssertEqual(SLADecoderPool_Release(pool, decoder1), SLA_APIRESULT_OK);
+    Test_AssertEqual(SLADecoderPool_Release(pool, decoder1), SLA_APIRESULT_INVALID_ARGUMENT);
+    Test_AssertCondition(SLADecoderPool_Acquire(pool) == decoder1);
+    Test_AssertEqual(SLADecoderPool_Release(pool, decoder1), SLA_APIRESULT_OK);
+    Test_AssertEqual(SLADecoderPool_Release(pool, decoder2), SLA_APIRESULT_OK);
+  }
+
+  /* 一括デコード */
+  Test_AssertEqual(SLADecoder_DecodeBatch(NULL, items, NUM_BATCH_ITEMS), SLA_APIRESULT_INVALID_ARGUMENT);
+  Test_AssertEqual(SLADecoder_DecodeBatch(pool, items, NUM_BATCH_ITEMS), SLA_APIRESULT_OK);
+  is_ok = 1;
+  for (i = 0; i < NUM_BATCH_ITEMS; i++) {
+    Test_AssertEqual(items[i].result, SLA_APIRESULT_OK);
+    Test_AssertEqual(items[i].output_num_samples, test_cases[i].num_samples);
+    for (ch = 0; ch < test_cases[i].wave_format.num_channels; ch++) {
+      for (smpl = 0; smpl < test_cases[i].num_samples; smpl++) {
+        if (input[i][ch][smpl] != output[i][ch][smpl]) {
+          is_ok = 0;
+        }
+      }
+    }
+  }
+  Test_AssertEqual(is_ok, 1);
+
+  /* 途中のデータが壊れていても残りはデコードされる */
+  items[1].data_size = SLA_HEADER_SIZE - 1;
+  Test_AssertEqual(SLADecoder_DecodeBatch(pool, items, NUM_BATCH_ITEMS), SLA_APIRESULT_INSUFFICIENT_DATA_SIZE);
+  Test_AssertEqual(items[0].result, SLA_APIRESULT_OK);
+  Test_AssertEqual(items[1].result, SLA_APIRESULT_INSUFFICIENT_DATA_SIZE);
+  Test_AssertEqual(items[2].result, SLA_APIRESULT_OK);
+  Test_AssertEqual(items[2].output_num_samples, test_cases[2].num_samples);
+
+  /* 並列一括デコード */
+  {
+    struct DecodeBatchTestThreadPool thread_pool;
+    struct SLADecodeBatchThreadFunctions thread_functions;
+    struct SLADecoder* decoder;
+
+    thread_functions.spawn = testSLAEncodeDecode_DecodeBatchTestSpawn;
+    thread_functions.join = testSLAEncodeDecode_DecodeBatchTestJoin;
+    thread_functions.user_data = &thread_pool;
+
+    /* 引数チェック */
+    Test_AssertEqual(SLADecoder_DecodeBatchParallel(NULL, items, NUM_BATCH_ITEMS, &thread_functions), SLA_APIRESULT_INVALID_ARGUMENT);
+    Test_AssertEqual(SLADecoder_DecodeBatchParallel(pool, NULL, NUM_BATCH_ITEMS, &thread_functions), SLA_APIRESULT_INVALID_ARGUMENT);
+    thread_functions.join = NULL;
+    Test_AssertEqual(SLADecoder_DecodeBatchParallel(pool, items, NUM_BATCH_ITEMS, &thread_functions), SLA_APIRESULT_INVALID_ARGUMENT);
+    thread_functions.join = testSLAEncodeDecode_DecodeBatchTestJoin;
+
+    /* 2つのハンドルで分担: 1つは別スレッドで処理される */
+    for (i = 0; i < NUM_BATCH_ITEMS; i++) {
+      items[i].data_size = encoded_size[i];
+      for (ch = 0; ch < test_cases[i].wave_format.num_channels; ch++) {
+        memset(output[i][ch], 0, sizeof(int32_t) * test_cases[i].num_samples);
+      }
+      items[i].output_num_samples = 0;
+    }
+    thread_pool.num_spawned = thread_pool.num_joined = 0;
+    Test_AssertEqual(SLADecoder_DecodeBatchParallel(pool, items, NUM_BATCH_ITEMS, &thread_functions), SLA_APIRESULT_OK);
+    Test_AssertEqual(thread_pool.num_spawned, 1);
+    Test_AssertEqual(thread_pool.num_joined, 1);
+    is_ok = 1;
+    for (i = 0; i < NUM_BATCH_ITEMS; i++) {
+      Test_AssertEqual(items[i].result, SLA_APIRESULT_OK);
+      Test_AssertEqual(items[i].output_num_samples, test_cases[i].num_samples);
+      for (ch = 0; ch < test_cases[i].wave_format.num_channels; ch++) {
+        for (smpl = 0; smpl < test_cases[i].num_samples; smpl++) {
+          if (input[i][ch][smpl] != output[i][ch][smpl]) {
+            is_ok = 0;
+          }
+        }
+      }
+    }
+    Test_AssertEqual(is_ok, 1);
+    /* 全てのハンドルが返却されている */
+    Test_AssertCondition((decoder = SLADecoderPool_Acquire(pool)) != NULL);
+    Test_AssertCondition(SLADecoderPool_Acquire(pool) != NULL);
+    Test_AssertCondition(SLADecoderPool_Acquire(pool) == NULL);
+    SLADecoderPool_Release(pool, decoder);
+
+    /* 空きハンドル1つ: 呼び出しスレッドのみで処理 */
+    thread_pool.num_spawned = thread_pool.num_joined = 0;
+    Test_AssertEqual(SLADecoder_DecodeBatchParallel(pool, items, NUM_BATCH_ITEMS, &thread_functions), SLA_APIRESULT_OK);
+    Test_AssertEqual(thread_pool.num_spawned, 0);
+    for (i = 0; i < NUM_BATCH_ITEMS; i++) {
+      Test_AssertEqual(items[i].result, SLA_APIRESULT_OK);
+    }
+    /* 空きハンドル無し */
+    Test_AssertCondition(SLADecoderPool_Acquire(pool) == decoder);
+    Test_AssertEqual(SLADecoder_DecodeBatchParallel(pool, items, NUM_BATCH_ITEMS, &thread_functions), SLA_APIRESULT_EXCEED_HANDLE_CAPACITY);
+    SLADecoderPool_Destroy(pool);
+    pool = SLADecoderPool_Create(&decoder_config, 2);
+
+    /* スレッドを起動できなければ呼び出しスレッドで処理し、壊れたデータの結果も返す */
+    thread_functions.spawn = testSLAEncodeDecode_DecodeBatchTestSpawnFail;
+    items[2].data_size = SLA_HEADER_SIZE - 1;
+    Test_AssertEqual(SLADecoder_DecodeBatchParallel(pool, items, NUM_BATCH_ITEMS, &thread_functions), SLA_APIRESULT_INSUFFICIENT_DATA_SIZE);
+    Test_AssertEqual(items[0].result, SLA_APIRESULT_OK);
+    Test_AssertEqual(items[1].result, SLA_APIRESULT_OK);
+    Test_AssertEqual(items[1].output_num_samples, test_cases[1].num_samples);
+    Test_AssertEqual(items[2].result, SLA_APIRESULT_INSUFFICIENT_DATA_SIZE);
+  }
+
+  SLADecoderPool_Destroy(pool);
+  SLAEncoder_Destroy(encoder);
+  for (i = 0; i < NUM_BATCH_ITEMS; i++) {
+    for (ch = 0; ch < test_cases[i].wave_format.num_channels; ch++) {
+      free(input_double[i][ch]);
+      free(input[i][ch]);
+      free(output[i][ch]);
+    }
+    free(input_double[i]);
+    free(input[i]);
+    free(output[i]);
+    free(data[i]);
+  }
+#undef NUM_BATCH_ITEMS
+}
+
+/* PCM入力（型・インターリーブ指定）でのエンコードテスト */
+static void testSLAEncodeDecode_PcmInputTest(void *obj)
+{
+  static const struct SLAWaveFormat wave_formats[] = {
+    { 2, 16, 44100, 0 },
+    { 2, 24, 44100, 0 },
+  };
+  static const struct SLAEncodeParameter encode_parameter
+    = { 16, 1, 8, SLA_CHPROCESSMETHOD_STEREO_MS, SLA_WINDOWFUNCTIONTYPE_SIN, 4096 };
+  const uint32_t num_channels = 2;
+  const uint32_t num_samples  = 4096 * 2 + 100;
+  uint32_t  i, ch, smpl, data_size, ref_size, encoded_size, bit_mask, ref_bit_mask;
+  double    **input_double;
+  int32_t   **input, *planar32[2];
+  int16_t   *interleaved16;
+  int32_t   *interleaved32;
+  uint8_t   *packed24, *ref_data, *data;
+  const void* channel_data[2];
+  struct SLAPcmInput      pcm_input;
+  struct SLAEncoderConfig encoder_config;
+  struct SLAEncoder*      encoder;
+  struct SLAHeaderInfo    header;
+
+  TEST_UNUSED_PARAMETER(obj);
+
+  data_size = SLA_HEADER_SIZE + SLA_CalculateSufficientBlockSize(num_channels, num_samples, 24);
+
+  /* 一時領域の割り当て */
+  input_double  = (double **)malloc(sizeof(double*) * num_channels);
+  input         = (int32_t **)malloc(sizeof(int32_t*) * num_channels);
+  for (ch = 0; ch < num_channels; ch++) {
+    input_double[ch]  = (double *)malloc(sizeof(double) * num_samples);
+    input[ch]         = (int32_t *)malloc(sizeof(int32_t) * num_samples);
+    planar32[ch]      = (int32_t *)malloc(sizeof(int32_t) * num_samples);
+  }
+  interleaved16 = (int16_t *)malloc(sizeof(int16_t) * num_samples * num_channels);
+  interleaved32 = (int32_t *)malloc(sizeof(int32_t) * num_samples * num_channels);
+  packed24      = (uint8_t *)malloc(3 * num_samples * num_channels);
+  ref_data      = (uint8_t *)malloc(data_size);
+  data          = (uint8_t *)malloc(data_size);
+
+  SLAEncoder_SetDefaultConfig(&encoder_config);
+  encoder = SLAEncoder_Create(&encoder_config);
+  testSLAEncodeDecode_GenerateChirp(input_double, num_channels, num_samples);
+
+  for (i = 0; i < sizeof(wave_formats) / sizeof(wave_formats[0]); i++) {
+    const uint32_t bit_per_sample = wave_formats[i].bit_per_sample;
+
+    /* 32bit左詰めの入力から各形式の入力を作成 */
+    testSLAEncodeDecode_InputDoubleToInputFixedFloat(
+        &wave_formats[i], input_double, input, num_channels, num_samples);
+    for (ch = 0; ch < num_channels; ch++) {
+      for (smpl = 0; smpl < num_samples; smpl++) {
+        int32_t val = input[ch][smpl] >> (32 - bit_per_sample);
+        planar32[ch][smpl]                          = val;
+        interleaved16[smpl * num_channels + ch]     = (int16_t)val;
+        interleaved32[smpl * num_channels + ch]     = val;
+        packed24[3 * (smpl * num_channels + ch) + 0] = (uint8_t)((val >>  0) & 0xFF);
+        packed24[3 * (smpl * num_channels + ch) + 1] = (uint8_t)((val >>  8) & 0xFF);
+        packed24[3 * (smpl * num_channels + ch) + 2] = (uint8_t)((val >> 16) & 0xFF);
+      }
+    }
+
+    /* 従来の入力形式でエンコードした結果を基準とする */
+    Test_AssertEqual(SLAEncoder_SetWaveFormat(encoder, &wave_formats[i]), SLA_APIRESULT_OK);
+    Test_AssertEqual(SLAEncoder_SetEncodeParameter(encoder, &encode_parameter), SLA_APIRESULT_OK);
+    Test_AssertEqual(SLAEncoder_EncodeWhole(encoder,
+          (const int32_t **)input, num_samples, ref_data, data_size, &ref_size), SLA_APIRESULT_OK);
+    ref_bit_mask = 0;
+    for (ch = 0; ch < num_channels; ch++) {
+      for (smpl = 0; smpl < num_samples; smpl++) {
+        ref_bit_mask |= (uint32_t)input[ch][smpl];
+      }
+    }
+
+    /* 16bitインターリーブ */
+    if (bit_per_sample <= 16) {
+      channel_data[0] = &interleaved16[0];
+      channel_data[1] = &interleaved16[1];
+      pcm_input.sample_type   = SLA_PCM_SAMPLE_TYPE_INT16;
+      pcm_input.channel_data  = channel_data;
+      pcm_input.stride        = num_channels;
+      bit_mask = 0;
+      Test_AssertEqual(SLAEncoder_AccumulatePcmBitMask(&pcm_input,
+            num_channels, bit_per_sample, num_samples, &bit_mask), SLA_APIRESULT_OK);
+      Test_AssertEqual(bit_mask, ref_bit_mask);
+      Test_AssertEqual(SLAEncoder_EncodeWholePcm(encoder,
+            &pcm_input, num_samples, data, data_size, &encoded_size), SLA_APIRESULT_OK);
+      Test_AssertEqual(encoded_size, ref_size);
+      Test_AssertEqual(memcmp(data, ref_data, ref_size), 0);
+    }
+
+    /* 24bitインターリーブ */
+    channel_data[0] = &packed24[0];
+    channel_data[1] = &packed24[3];
+    pcm_input.sample_type   = SLA_PCM_SAMPLE_TYPE_PACKED_INT24;
+    pcm_input.channel_data  = channel_data;
+    pcm_input.stride        = num_channels;
+    bit_mask = 0;
+    Test_AssertEqual(SLAEncoder_AccumulatePcmBitMask(&pcm_input,
+          num_channels, bit_per_sample, num_samples, &bit_mask), SLA_APIRESULT_OK);
+    Test_AssertEqual(bit_mask, ref_bit_mask);
+    Test_AssertEqual(SLAEncoder_EncodeWholePcm(encoder,
+          &pcm_input, num_samples, data, data_size, &encoded_size), SLA_APIRESULT_OK);
+    Test_AssertEqual(encoded_size, ref_size);
+    Test_AssertEqual(memcmp(data, ref_data, ref_size), 0);
+
+    /* 32bitインターリーブ */
+    channel_data[0] = &interleaved32[0];
+    channel_data[1] = &interleaved32[1];
+    pcm_input.sample_type   = SLA_PCM_SAMPLE_TYPE_INT32;
+    pcm_input.channel_data  = channel_data;
+    pcm_input.stride        = num_channels;
+    Test_AssertEqual(SLAEncoder_EncodeWholePcm(encoder,
+          &pcm_input, num_samples, data, data_size, &encoded_size), SLA_APIRESULT_OK);
+    Test_AssertEqual(encoded_size, ref_size);
+    Test_AssertEqual(memcmp(data, ref_data, ref_size), 0);
+
+    /* 32bitチャンネル毎（分割エンコード） */
+    channel_data[0] = planar32[0];
+    channel_data[1] = planar32[1];
+    pcm_input.sample_type   = SLA_PCM_SAMPLE_TYPE_INT32;
+    pcm_input.channel_data  = channel_data;
+    pcm_input.stride        = 1;
+    header.num_blocks         = 0;
+    header.max_block_size     = 0;
+    header.max_bit_per_second = 0;
+    Test_AssertEqual(SLAEncoder_EncodePartitionedBlocksPcm(encoder,
+          &pcm_input, encode_parameter.max_num_block_samples,
+          data, data_size, &encoded_size, &header), SLA_APIRESULT_OK);
+    Test_AssertEqual(memcmp(data, &ref_data[SLA_HEADER_SIZE], encoded_size), 0);
+  }
+
+  /* 異常系 */
+  channel_data[0] = &interleaved16[0];
+  channel_data[1] = &interleaved16[1];
+  pcm_input.sample_type   = SLA_PCM_SAMPLE_TYPE_INT16;
+  pcm_input.channel_data  = channel_data;
+  pcm_input.stride        = num_channels;
+  /* 24bitの波形に16bit入力 */
+  Test_AssertEqual(SLAEncoder_EncodeWholePcm(encoder,
+        &pcm_input, num_samples, data, data_size, &encoded_size), SLA_APIRESULT_INVALID_ARGUMENT);
+  Test_AssertEqual(SLAEncoder_EncodeBlockPcm(encoder,
+        &pcm_input, 100, data, data_size, &encoded_size), SLA_APIRESULT_INVALID_ARGUMENT);
+  pcm_input.sample_type   = SLA_PCM_SAMPLE_TYPE_INT32;
+  pcm_input.stride        = 0;
+  Test_AssertEqual(SLAEncoder_EncodeBlockPcm(encoder,
+        &pcm_input, 100, data, data_size, &encoded_size), SLA_APIRESULT_INVALID_ARGUMENT);
+  pcm_input.stride        = num_channels;
+  channel_data[1] = NULL;
+  Test_AssertEqual(SLAEncoder_EncodeBlockPcm(encoder,
+        &pcm_input, 100, data, data_size, &encoded_size), SLA_APIRESULT_INVALID_ARGUMENT);
+  Test_AssertEqual(SLAEncoder_EncodeBlockPcm(encoder,
+        NULL, 100, data, data_size, &encoded_size), SLA_APIRESULT_INVALID_ARGUMENT);
+  Test_AssertEqual(SLAEncoder_AccumulatePcmBitMask(&pcm_input,
+        num_channels, 24, num_samples, NULL), SLA_APIRESULT_INVALID_ARGUMENT);
+
+  SLAEncoder_Destroy(encoder);
+  for (ch = 0; ch < num_channels; ch++) {
+    free(input_double[ch]);
+    free(input[ch]);
+    free(planar32[ch]);
+  }
+  free(input_double);
+  free(input);
+  free(interleaved16);
+  free(interleaved32);
+  free(packed24);
+  free(ref_data);
+  free(data);
+}
+
+/* PCM出力（型・インターリーブ指定）でのデコードテスト */
+static void testSLAEncodeDecode_PcmOutputTest(void *obj)
+{
+  static const struct SLAWaveFormat wave_formats[] = {
+    { 2, 16, 44100, 2 },
+    { 2, 24, 44100, 3 },
+  };
+  static const struct SLAEncodeParameter encode_parameter
+    = { 16, 1, 8, SLA_CHPROCESSMETHOD_STEREO_MS, SLA_WINDOWFUNCTIONTYPE_SIN, 4096 };
+  const uint32_t num_channels = 2;
+  const uint32_t num_samples  = 4096 * 2 + 100;
+  uint32_t  i, ch, smpl, data_size, encoded_size, output_num_samples, is_ok;
+  uint32_t  offset, block_size, block_num_samples;
+  double    **input_double;
+  int32_t   **input, **ref_output, *planar32[2];
+  int16_t   *interleaved16;
+  float     *interleaved_float;
+  uint8_t   *packed24, *data;
+  const int32_t* borrowed[2];
+  void*     channel_data[2];
+  struct SLAPcmOutput     pcm_output;
+  struct SLAEncoderConfig encoder_config;
+  struct SLADecoderConfig decoder_config;
+  struct SLAEncoder*      encoder;
+  struct SLADecoder*      decoder;
+
+  TEST_UNUSED_PARAMETER(obj);
+
+  data_size = SLA_HEADER_SIZE + SLA_CalculateSufficientBlockSize(num_channels, num_samples, 24);
+
+  /* 一時領域の割り当て */
+  input_double  = (double **)malloc(sizeof(double*) * num_channels);
+  input         = (int32_t **)malloc(sizeof(int32_t*) * num_channels);
+  ref_output    = (int32_t **)malloc(sizeof(int32_t*) * num_channels);
+  for (ch = 0; ch < num_channels; ch++) {
+    input_double[ch]  = (double *)malloc(sizeof(double) * num_samples);
+    input[ch]         = (int32_t *)malloc(sizeof(int32_t) * num_samples);
+    ref_output[ch]    = (int32_t *)malloc(sizeof(int32_t) * num_samples);
+    planar32[ch]      = (int32_t *)malloc(sizeof(int32_t) * num_samples);
+  }
+  interleaved16     = (int16_t *)malloc(sizeof(int16_t) * num_samples * num_channels);
+  interleaved_float = (float *)malloc(sizeof(float) * num_samples * num_channels);
+  packed24          = (uint8_t *)malloc(3 * num_samples * num_channels);
+  data              = (uint8_t *)malloc(data_size);
+
+  SLAEncoder_SetDefaultConfig(&encoder_config);
+  SLADecoder_SetDefaultConfig(&decoder_config);
+  encoder = SLAEncoder_Create(&encoder_config);
+  decoder = SLADecoder_Create(&decoder_config);
+  testSLAEncodeDecode_GenerateChirp(input_double, num_channels, num_samples);
+
+  for (i = 0; i < sizeof(wave_formats) / sizeof(wave_formats[0]); i++) {
+    const uint32_t bit_per_sample = wave_formats[i].bit_per_sample;
+
+    /* エンコード */
+    testSLAEncodeDecode_InputDoubleToInputFixedFloat(
+        &wave_formats[i], input_double, input, num_channels, num_samples);
+    Test_AssertEqual(SLAEncoder_SetWaveFormat(encoder, &wave_formats[i]), SLA_APIRESULT_OK);
+    Test_AssertEqual(SLAEncoder_SetEncodeParameter(encoder, &encode_parameter), SLA_APIRESULT_OK);
+    Test_AssertEqual(SLAEncoder_EncodeWhole(encoder,
+          (const int32_t **)input, num_samples, data, data_size, &encoded_size), SLA_APIRESULT_OK);
+
+    /* 従来の出力形式でデコードした結果を基準とする */
+    Test_AssertEqual(SLADecoder_DecodeWhole(decoder,
+          data, encoded_size, ref_output, num_samples, &output_num_samples), SLA_APIRESULT_OK);
+    Test_AssertEqual(output_num_samples, num_samples);
+
+    /* 16bitインターリーブ */
+    if (bit_per_sample <= 16) {
+      channel_data[0] = &interleaved16[0];
+      channel_data[1] = &interleaved16[1];
+      pcm_output.sample_type  = SLA_PCM_SAMPLE_TYPE_INT16;
+      pcm_output.channel_data = channel_data;
+      pcm_output.stride       = num_channels;
+      Test_AssertEqual(SLADecoder_DecodeWholePcm(decoder,
+            data, encoded_size, &pcm_output, num_samples, &output_num_samples), SLA_APIRESULT_OK);
+      Test_AssertEqual(output_num_samples, num_samples);
+      is_ok = 1;
+      for (smpl = 0; smpl < num_samples; smpl++) {
+        for (ch = 0; ch < num_channels; ch++) {
+          if (interleaved16[smpl * num_channels + ch] != (ref_output[ch][smpl] >> (32 - bit_per_sample))) {
+            is_ok = 0;
+          }
+        }
+      }
+      Test_AssertEqual(is_ok, 1);
+    }
+
+    /* 24bitインターリーブ */
+    channel_data[0] = &packed24[0];
+    channel_data[1] = &packed24[3];
+    pcm_output.sample_type  = SLA_PCM_SAMPLE_TYPE_PACKED_INT24;
+    pcm_output.channel_data = channel_data;
+    pcm_output.stride       = num_channels;
+    Test_AssertEqual(SLADecoder_DecodeWholePcm(decoder,
+          data, encoded_size, &pcm_output, num_samples, &output_num_samples), SLA_APIRESULT_OK);
+    is_ok = 1;
+    for (smpl = 0; smpl < num_samples; smpl++) {
+      for (ch = 0; ch < num_channels; ch++) {
+        const uint8_t* p = &packed24[3 * (smpl * num_channels + ch)];
+        int32_t val = (int32_t)(((uint32_t)p[0] << 8) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 24)) >> 8;
+        if (val != (ref_output[ch][smpl] >> (32 - bit_per_sample))) {
+          is_ok = 0;
+        }
+      }
+    }
+    Test_AssertEqual(is_ok, 1);
+
+    /* 32bitチャンネル毎 */
+    channel_data[0] = planar32[0];
+    channel_data[1] = planar32[1];
+    pcm_output.sample_type  = SLA_PCM_SAMPLE_TYPE_INT32;
+    pcm_output.channel_data = channel_data;
+    pcm_output.stride       = 1;
+    Test_AssertEqual(SLADecoder_DecodeWholePcm(decoder,
+          data, encoded_size, &pcm_output, num_samples, &output_num_samples), SLA_APIRESULT_OK);
+    is_ok = 1;
+    for (ch = 0; ch < num_channels; ch++) {
+      for (smpl = 0; smpl < num_samples; smpl++) {
+        if (planar32[ch][smpl] != (ref_output[ch][smpl] >> (32 - bit_per_sample))) {
+          is_ok = 0;
+        }
+      }
+    }
+    Test_AssertEqual(is_ok, 1);
+
+    /* 浮動小数点インターリーブ */
+    channel_data[0] = &interleaved_float[0];
+    channel_data[1] = &interleaved_float[1];
+    pcm_output.sample_type  = SLA_PCM_SAMPLE_TYPE_FLOAT32;
+    pcm_output.channel_data = channel_data;
+    pcm_output.stride       = num_channels;
+    Test_AssertEqual(SLADecoder_DecodeWholePcm(decoder,
+          data, encoded_size, &pcm_output, num_samples, &output_num_samples), SLA_APIRESULT_OK);
+    is_ok = 1;
+    for (smpl = 0; smpl < num_samples; smpl++) {
+      for (ch = 0; ch < num_channels; ch++) {
+        if (interleaved_float[smpl * num_channels + ch] != (float)(ref_output[ch][smpl] * pow(2, -31))) {
+          is_ok = 0;
+        }
+      }
+    }
+    Test_AssertEqual(is_ok, 1);
+
+    /* 内部バッファの参照を受け取りながらブロック単位でデコード */
+    offset = SLA_HEADER_SIZE;
+    smpl = 0;
+    is_ok = 1;
+    while (offset < encoded_size) {
+      uint32_t bsmpl;
+      Test_AssertEqual(SLADecoder_DecodeBlockBorrowed(decoder,
+            &data[offset], encoded_size - offset, borrowed, &block_size, &block_num_samples), SLA_APIRESULT_OK);
+      for (ch = 0; ch < num_channels; ch++) {
+        for (bsmpl = 0; bsmpl < block_num_samples; bsmpl++) {
+          if (borrowed[ch][bsmpl] != (ref_output[ch][smpl + bsmpl] >> (32 - bit_per_sample))) {
+            is_ok = 0;
+          }
+        }
+      }
+      offset += block_size;
+      smpl   += block_num_samples;
+    }
+    Test_AssertEqual(is_ok, 1);
+    Test_AssertEqual(smpl, num_samples);
+  }
+
+  /* 異常系 */
+  channel_data[0] = &interleaved16[0];
+  channel_data[1] = &interleaved16[1];
+  pcm_output.sample_type  = SLA_PCM_SAMPLE_TYPE_INT16;
+  pcm_output.channel_data = channel_data;
+  pcm_output.stride       = num_channels;
+  /* 24bitの波形に16bit出力 */
+  Test_AssertEqual(SLADecoder_DecodeWholePcm(decoder,
+        data, encoded_size, &pcm_output, num_samples, &output_num_samples), SLA_APIRESULT_INVALID_ARGUMENT);
+  Test_AssertEqual(SLADecoder_DecodeBlockPcm(decoder, &data[SLA_HEADER_SIZE], encoded_size - SLA_HEADER_SIZE,
+        &pcm_output, num_samples, &block_size, &block_num_samples), SLA_APIRESULT_INVALID_ARGUMENT);
+  pcm_output.sample_type  = SLA_PCM_SAMPLE_TYPE_FLOAT32;
+  pcm_output.stride       = 0;
+  Test_AssertEqual(SLADecoder_DecodeBlockPcm(decoder, &data[SLA_HEADER_SIZE], encoded_size - SLA_HEADER_SIZE,
+        &pcm_output, num_samples, &block_size, &block_num_samples), SLA_APIRESULT_INVALID_ARGUMENT);
+  Test_AssertEqual(SLADecoder_DecodeBlockPcm(decoder, &data[SLA_HEADER_SIZE], encoded_size - SLA_HEADER_SIZE,
+        NULL, num_samples, &block_size, &block_num_samples), SLA_APIRESULT_INVALID_ARGUMENT);
+  Test_AssertEqual(SLADecoder_DecodeBlockBorrowed(decoder, &data[SLA_HEADER_SIZE], encoded_size - SLA_HEADER_SIZE,
+        NULL, &block_size, &block_num_samples), SLA_APIRESULT_INVALID_ARGUMENT);
+  Test_AssertEqual(SLADecoder_DecodeWholePcm(decoder,
+        data, encoded_size, NULL, num_samples, &output_num_samples), SLA_APIRESULT_INVALID_ARGUMENT);
+
+  SLADecoder_Destroy(decoder);
+  SLAEncoder_Destroy(encoder);
+  for (ch = 0; ch < num_channels; ch++) {
+    free(input_double[ch]);
+    free(input[ch]);
+    free(ref_output[ch]);
+    free(planar32[ch]);
+  }
+  free(input_double);
+  free(input);
+  free(ref_output);
+  free(interleaved16);
+  free(interleaved_float);
+  free(packed24);
+  free(data);
+}
+
 void testSLAEncodeDecode_Setup(void)
 {
   struct TestSuite *suite
@@ -1413,4 +3612,16 @@ void testSLAEncodeDecode_Setup(void)
 
   Test_AddTest(suite, testSLAEncodeDecode_EncodeDecodeTest);
   Test_AddTest(suite, testSLAEncodeDecode_EncodeStreamingDecodeTest);
+  Test_AddTest(suite, testSLAEncodeDecode_StreamingDecodeFramesTest);
+  Test_AddTest(suite, testSLAEncodeDecode_CreateWithWorkTest);
+  Test_AddTest(suite, testSLAEncodeDecode_StatisticsTest);
+  Test_AddTest(suite, testSLAEncodeDecode_BuildBlockIndexTest);
+  Test_AddTest(suite, testSLAEncodeDecode_VerifyStreamTest);
+  Test_AddTest(suite, testSLAEncodeDecode_BlockIndexFileTest);
+  Test_AddTest(suite, testSLAEncodeDecode_DecodeRangeTest);
+  Test_AddTest(suite, testSLAEncodeDecode_DecodeBatchTest);
+  Test_AddTest(suite, testSLAEncodeDecode_EncodePartitionedBlocksTest);
+  Test_AddTest(suite, testSLAEncodeDecode_LargeBlockTest);
+  Test_AddTest(suite, testSLAEncodeDecode_PcmInputTest);
+  Test_AddTest(suite, testSLAEncodeDecode_PcmOutputTest);
 }
@@ -30,6 +30,7 @@ static void testSLAEncoder_EncodeHeaderTest(void *obj)
     struct SLAHeaderInfo header;
     uint8_t* data;
     uint8_t* data_ptr;
+    uint64_t u64buf;
     uint32_t u32buf;
     uint16_t u16buf;
     uint8_t  u8buf;
@@ -73,8 +74,8 @@ static void testSLAEncoder_EncodeHeaderTest(void *obj)
     SLAByteArray_GetUint8(data_ptr, &u8buf);
     Test_AssertEqual(u8buf, header.wave_format.num_channels);
     /* サンプル数 */
-    SLAByteArray_GetUint32(data_ptr, &u32buf);
-    Test_AssertEqual(u32buf, header.num_samples);
+    SLAByteArray_GetUint64(data_ptr, &u64buf);
+    Test_AssertEqual(u64buf, header.num_samples);
     /* サンプリングレート */
     SLAByteArray_GetUint32(data_ptr, &u32buf);
     Test_AssertEqual(u32buf, header.wave_format.sampling_rate);
@@ -100,8 +101,8 @@ static void testSLAEncoder_EncodeHeaderTest(void *obj)
     SLAByteArray_GetUint32(data_ptr, &u32buf);
     Test_AssertEqual(u32buf, header.num_blocks);
     /* SLAブロックあたりサンプル数 */
-    SLAByteArray_GetUint16(data_ptr, &u16buf);
-    Test_AssertEqual(u16buf, header.encode_param.max_num_block_samples);
+    SLAByteArray_GetUint32(data_ptr, &u32buf);
+    Test_AssertEqual(u32buf, header.encode_param.max_num_block_samples);
     /* 最大ブロックサイズ */
     SLAByteArray_GetUint32(data_ptr, &u32buf);
     Test_AssertEqual(u32buf, header.max_block_size);
@@ -202,6 +203,15 @@ static void testSLAEncoder_EncodeBlockTest(void *obj)
           config.max_num_block_samples + 1, data, suff_size, &outsize),
         SLA_APIRESULT_EXCEED_HANDLE_CAPACITY);
 
+    /* 許容チャンネル数を超えた波形 */
+    {
+      struct SLAWaveFormat wave_format = header.wave_format;
+      wave_format.num_channels = config.max_num_channels + 1;
+      Test_AssertEqual(
+          SLAEncoder_SetWaveFormat(encoder, &wave_format),
+          SLA_APIRESULT_EXCEED_HANDLE_CAPACITY);
+    }
+
     /* チャンネル毎の処理が不正 */
     encoder->encode_param.ch_process_method = SLA_CHPROCESSMETHOD_STEREO_MS;
     encoder->wave_format.num_channels       = 1;
@@ -231,6 +241,31 @@ static void testSLAEncoder_EncodeBlockTest(void *obj)
     SLAEncoder_Destroy(encoder);
   }
 
+  /* ヘッダに記録できないチャンネル数は受け付けない */
+  {
+    struct SLAEncoder*      encoder;
+    struct SLAEncoderConfig config;
+    struct SLAWaveFormat    wave_format;
+
+    SLAEncoder_SetDefaultConfig(&config);
+    config.max_num_channels       = SLA_MAX_NUM_CHANNELS + 1;
+    config.max_num_block_samples  = SLA_MIN_BLOCK_NUM_SAMPLES;
+    encoder = SLAEncoder_Create(&config);
+    Test_AssertCondition(encoder != NULL);
+
+    SLATestUtility_SetValidWaveFormat(&wave_format);
+    wave_format.num_channels = SLA_MAX_NUM_CHANNELS;
+    Test_AssertEqual(
+        SLAEncoder_SetWaveFormat(encoder, &wave_format),
+        SLA_APIRESULT_OK);
+    wave_format.num_channels = SLA_MAX_NUM_CHANNELS + 1;
+    Test_AssertEqual(
+        SLAEncoder_SetWaveFormat(encoder, &wave_format),
+        SLA_APIRESULT_EXCEED_HANDLE_CAPACITY);
+
+    SLAEncoder_Destroy(encoder);
+  }
+
   /* パラメータセット前にエンコードするとエラーになるか？ */
   {
     struct SLAEncoder*      encoder;
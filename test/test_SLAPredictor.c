@@ -83,14 +83,46 @@ static void testLPC_CalculateCoefTest(void *obj)
     lpc = SLALPCCalculator_Create(10);
     Test_AssertCondition(lpc != NULL);
 
+    Test_AssertEqual(lpc->alloced_by_own, 1);
+    Test_AssertCondition(lpc->a_vec != NULL);
+    Test_AssertCondition(lpc->parcor_coef != NULL);
+
+    SLALPCCalculator_Destroy(lpc);
+  }
+
+  /* ワーク領域を指定した生成破棄テスト */
+  {
+    struct SLALPCCalculator* lpc;
+    int32_t work_size;
+    uint8_t* work;
+
+    work_size = SLALPCCalculator_CalculateWorkSize(10);
+    Test_AssertCondition(work_size > 0);
+    work = (uint8_t *)malloc((size_t)work_size + 1);
+
+    lpc = SLALPCCalculator_CreateWithWork(10, work, work_size);
+    Test_AssertCondition(lpc != NULL);
+    Test_AssertEqual(lpc->alloced_by_own, 0);
+    Test_AssertCondition(lpc->work == work);
+    /* 全ての領域がワーク領域内にあり、キャッシュライン境界に揃っている */
+    Test_AssertCondition(((uint8_t *)lpc >= work) && ((uint8_t *)lpc < (work + work_size)));
+    Test_AssertCondition(((uint8_t *)lpc->parcor_coef > work) && ((uint8_t *)lpc->parcor_coef < (work + work_size)));
+    Test_AssertEqual((uintptr_t)lpc->a_vec % SLA_MEMORY_ALIGNMENT, 0);
+    Test_AssertEqual((uintptr_t)lpc->parcor_coef % SLA_MEMORY_ALIGNMENT, 0);
+    /* 破棄してもワーク領域は解放されない */
+    SLALPCCalculator_Destroy(lpc);
+
+    /* 先頭がずれたワーク領域にも作成できる */
+    lpc = SLALPCCalculator_CreateWithWork(10, work + 1, work_size);
+    Test_AssertCondition(lpc != NULL);
+    Test_AssertEqual((uintptr_t)lpc->a_vec % SLA_MEMORY_ALIGNMENT, 0);
     SLALPCCalculator_Destroy(lpc);
-    Test_AssertCondition(lpc->a_vec == NULL);
-    Test_AssertCondition(lpc->e_vec == NULL);
-    Test_AssertCondition(lpc->u_vec == NULL);
-    Test_AssertCondition(lpc->v_vec == NULL);
-    Test_AssertCondition(lpc->auto_corr   == NULL);
-    Test_AssertCondition(lpc->lpc_coef    == NULL);
-    Test_AssertCondition(lpc->parcor_coef == NULL);
+
+    /* ワーク領域不足・NULL */
+    Test_AssertCondition(SLALPCCalculator_CreateWithWork(10, work, work_size - 1) == NULL);
+    Test_AssertCondition(SLALPCCalculator_CreateWithWork(10, NULL, work_size) == NULL);
+
+    free(work);
   }
 
   /* 無音入力時 */
@@ -260,6 +292,20 @@ static void testSLAPredictor_SynthesizeInt32ByParcor(
   SLALPCSynthesizer_Destroy(lpcs);
 }
 
+/* PARCOR係数による合成(16bit幅の後ろ向き誤差) */
+static void testSLAPredictor_SynthesizeInt16ByParcor(
+    const int32_t* residual, uint32_t num_samples,
+    const int32_t* parcor_coef, uint32_t order, int32_t* output)
+{
+  struct SLALPCSynthesizer* lpcs = SLALPCSynthesizer_Create(order);
+
+  assert(SLALPCSynthesizer_Reset(lpcs) == SLAPREDICTOR_APIRESULT_OK);
+  assert(SLALPCSynthesizer_SynthesizeByParcorCoefInt16(
+        lpcs, residual, num_samples, parcor_coef, order, output) == SLAPREDICTOR_APIRESULT_OK);
+
+  SLALPCSynthesizer_Destroy(lpcs);
+}
+
 /* LMS係数による予測(int32_t) */
 static void testSLAPredictor_PredictInt32ByLMS(
   const int32_t* data, uint32_t num_samples,
@@ -487,6 +533,78 @@ static void testSLALPCSynthesizer_PredictSynthTest(void* obj)
       testSLAPredictor_PredictInt32ByParcor, testSLAPredictor_SynthesizeInt32ByParcor },
     { 256, 8192, 24, testSLAPredictor_GenerateNyquistOsc, testSLAPredictor_CalculateParcorCoef,
       testSLAPredictor_PredictInt32ByParcor, testSLAPredictor_SynthesizeInt32ByParcor },
+    { 16, 8192, 14, testSLAPredictor_GenerateSilence, testSLAPredictor_CalculateParcorCoef,
+      testSLAPredictor_PredictInt32ByParcor, testSLAPredictor_SynthesizeInt16ByParcor },
+    { 16, 8192, 14, testSLAPredictor_GenerateConstant, testSLAPredictor_CalculateParcorCoef,
+      testSLAPredictor_PredictInt32ByParcor, testSLAPredictor_SynthesizeInt16ByParcor },
+    { 16, 8192, 14, testSLAPredictor_GenerateNegativeConstant, testSLAPredictor_CalculateParcorCoef,
+      testSLAPredictor_PredictInt32ByParcor, testSLAPredictor_SynthesizeInt16ByParcor },
+    { 16, 8192, 14, testSLAPredictor_GenerateSineWave, testSLAPredictor_CalculateParcorCoef,
+      testSLAPredictor_PredictInt32ByParcor, testSLAPredictor_SynthesizeInt16ByParcor },
+    { 16, 8192, 14, testSLAPredictor_GenerateWhiteNoize, testSLAPredictor_CalculateParcorCoef,
+      testSLAPredictor_PredictInt32ByParcor, testSLAPredictor_SynthesizeInt16ByParcor },
+    { 16, 8192, 14, testSLAPredictor_GenerateNyquistOsc, testSLAPredictor_CalculateParcorCoef,
+      testSLAPredictor_PredictInt32ByParcor, testSLAPredictor_SynthesizeInt16ByParcor },
+    { 20, 8192, 14, testSLAPredictor_GenerateSilence, testSLAPredictor_CalculateParcorCoef,
+      testSLAPredictor_PredictInt32ByParcor, testSLAPredictor_SynthesizeInt16ByParcor },
+    { 20, 8192, 14, testSLAPredictor_GenerateConstant, testSLAPredictor_CalculateParcorCoef,
+      testSLAPredictor_PredictInt32ByParcor, testSLAPredictor_SynthesizeInt16ByParcor },
+    { 20, 8192, 14, testSLAPredictor_GenerateNegativeConstant, testSLAPredictor_CalculateParcorCoef,
+      testSLAPredictor_PredictInt32ByParcor, testSLAPredictor_SynthesizeInt16ByParcor },
+    { 20, 8192, 14, testSLAPredictor_GenerateSineWave, testSLAPredictor_CalculateParcorCoef,
+      testSLAPredictor_PredictInt32ByParcor, testSLAPredictor_SynthesizeInt16ByParcor },
+    { 20, 8192, 14, testSLAPredictor_GenerateWhiteNoize, testSLAPredictor_CalculateParcorCoef,
+      testSLAPredictor_PredictInt32ByParcor, testSLAPredictor_SynthesizeInt16ByParcor },
+    { 20, 8192, 14, testSLAPredictor_GenerateNyquistOsc, testSLAPredictor_CalculateParcorCoef,
+      testSLAPredictor_PredictInt32ByParcor, testSLAPredictor_SynthesizeInt16ByParcor },
+    { 256, 8192, 14, testSLAPredictor_GenerateSilence, testSLAPredictor_CalculateParcorCoef,
+      testSLAPredictor_PredictInt32ByParcor, testSLAPredictor_SynthesizeInt16ByParcor },
+    { 256, 8192, 14, testSLAPredictor_GenerateConstant, testSLAPredictor_CalculateParcorCoef,
+      testSLAPredictor_PredictInt32ByParcor, testSLAPredictor_SynthesizeInt16ByParcor },
+    { 256, 8192, 14, testSLAPredictor_GenerateNegativeConstant, testSLAPredictor_CalculateParcorCoef,
+      testSLAPredictor_PredictInt32ByParcor, testSLAPredictor_SynthesizeInt16ByParcor },
+    { 256, 8192, 14, testSLAPredictor_GenerateSineWave, testSLAPredictor_CalculateParcorCoef,
+      testSLAPredictor_PredictInt32ByParcor, testSLAPredictor_SynthesizeInt16ByParcor },
+    { 256, 8192, 14, testSLAPredictor_GenerateWhiteNoize, testSLAPredictor_CalculateParcorCoef,
+      testSLAPredictor_PredictInt32ByParcor, testSLAPredictor_SynthesizeInt16ByParcor },
+    { 256, 8192, 14, testSLAPredictor_GenerateNyquistOsc, testSLAPredictor_CalculateParcorCoef,
+      testSLAPredictor_PredictInt32ByParcor, testSLAPredictor_SynthesizeInt16ByParcor },
+    { 16, 8192, 16, testSLAPredictor_GenerateSilence, testSLAPredictor_CalculateParcorCoef,
+      testSLAPredictor_PredictInt32ByParcor, testSLAPredictor_SynthesizeInt16ByParcor },
+    { 16, 8192, 16, testSLAPredictor_GenerateConstant, testSLAPredictor_CalculateParcorCoef,
+      testSLAPredictor_PredictInt32ByParcor, testSLAPredictor_SynthesizeInt16ByParcor },
+    { 16, 8192, 16, testSLAPredictor_GenerateNegativeConstant, testSLAPredictor_CalculateParcorCoef,
+      testSLAPredictor_PredictInt32ByParcor, testSLAPredictor_SynthesizeInt16ByParcor },
+    { 16, 8192, 16, testSLAPredictor_GenerateSineWave, testSLAPredictor_CalculateParcorCoef,
+      testSLAPredictor_PredictInt32ByParcor, testSLAPredictor_SynthesizeInt16ByParcor },
+    { 16, 8192, 16, testSLAPredictor_GenerateWhiteNoize, testSLAPredictor_CalculateParcorCoef,
+      testSLAPredictor_PredictInt32ByParcor, testSLAPredictor_SynthesizeInt16ByParcor },
+    { 16, 8192, 16, testSLAPredictor_GenerateNyquistOsc, testSLAPredictor_CalculateParcorCoef,
+      testSLAPredictor_PredictInt32ByParcor, testSLAPredictor_SynthesizeInt16ByParcor },
+    { 20, 8192, 16, testSLAPredictor_GenerateSilence, testSLAPredictor_CalculateParcorCoef,
+      testSLAPredictor_PredictInt32ByParcor, testSLAPredictor_SynthesizeInt16ByParcor },
+    { 20, 8192, 16, testSLAPredictor_GenerateConstant, testSLAPredictor_CalculateParcorCoef,
+      testSLAPredictor_PredictInt32ByParcor, testSLAPredictor_SynthesizeInt16ByParcor },
+    { 20, 8192, 16, testSLAPredictor_GenerateNegativeConstant, testSLAPredictor_CalculateParcorCoef,
+      testSLAPredictor_PredictInt32ByParcor, testSLAPredictor_SynthesizeInt16ByParcor },
+    { 20, 8192, 16, testSLAPredictor_GenerateSineWave, testSLAPredictor_CalculateParcorCoef,
+      testSLAPredictor_PredictInt32ByParcor, testSLAPredictor_SynthesizeInt16ByParcor },
+    { 20, 8192, 16, testSLAPredictor_GenerateWhiteNoize, testSLAPredictor_CalculateParcorCoef,
+      testSLAPredictor_PredictInt32ByParcor, testSLAPredictor_SynthesizeInt16ByParcor },
+    { 20, 8192, 16, testSLAPredictor_GenerateNyquistOsc, testSLAPredictor_CalculateParcorCoef,
+      testSLAPredictor_PredictInt32ByParcor, testSLAPredictor_SynthesizeInt16ByParcor },
+    { 16, 8192, 24, testSLAPredictor_GenerateSilence, testSLAPredictor_CalculateParcorCoef,
+      testSLAPredictor_PredictInt32ByParcor, testSLAPredictor_SynthesizeInt16ByParcor },
+    { 16, 8192, 24, testSLAPredictor_GenerateConstant, testSLAPredictor_CalculateParcorCoef,
+      testSLAPredictor_PredictInt32ByParcor, testSLAPredictor_SynthesizeInt16ByParcor },
+    { 16, 8192, 24, testSLAPredictor_GenerateNegativeConstant, testSLAPredictor_CalculateParcorCoef,
+      testSLAPredictor_PredictInt32ByParcor, testSLAPredictor_SynthesizeInt16ByParcor },
+    { 16, 8192, 24, testSLAPredictor_GenerateSineWave, testSLAPredictor_CalculateParcorCoef,
+      testSLAPredictor_PredictInt32ByParcor, testSLAPredictor_SynthesizeInt16ByParcor },
+    { 16, 8192, 24, testSLAPredictor_GenerateWhiteNoize, testSLAPredictor_CalculateParcorCoef,
+      testSLAPredictor_PredictInt32ByParcor, testSLAPredictor_SynthesizeInt16ByParcor },
+    { 16, 8192, 24, testSLAPredictor_GenerateNyquistOsc, testSLAPredictor_CalculateParcorCoef,
+      testSLAPredictor_PredictInt32ByParcor, testSLAPredictor_SynthesizeInt16ByParcor },
     { 4, 8192, 16, testSLAPredictor_GenerateSilence, testSLAPredictor_CalculateCoefDummyFunction,
       testSLAPredictor_PredictInt32ByLMS, testSLAPredictor_SynthesizeInt32ByLMS },
     { 4, 8192, 16, testSLAPredictor_GenerateConstant, testSLAPredictor_CalculateCoefDummyFunction,
@@ -551,6 +669,315 @@ static void testSLALPCSynthesizer_PredictSynthTest(void* obj)
   }
 }
 
+/* 16bit幅の後ろ向き誤差による合成テスト */
+static void testSLALPCSynthesizer_SynthesizeInt16Test(void* obj)
+{
+  TEST_UNUSED_PARAMETER(obj);
+
+  /* 分割して合成しても32bit版と一致するか？ 途中で16bit幅を超える入力も含む */
+  {
+#define NUM_SAMPLES   4096
+#define NUM_CHUNK     100
+    uint32_t  i, smpl, ord, is_ok;
+    int32_t   data[NUM_SAMPLES], residual[NUM_SAMPLES];
+    int32_t   output_int32[NUM_SAMPLES], output_int16[NUM_SAMPLES];
+    double    ddata[NUM_SAMPLES], dcoef[32 + 1];
+    int32_t   coef[32 + 1];
+    struct SLALPCSynthesizer *lpcs_int32, *lpcs_int16;
+    static const uint32_t orders[] = { 8, 12, 32 };
+
+    for (i = 0; i < sizeof(orders) / sizeof(orders[0]); i++) {
+      const uint32_t order = orders[i];
+
+      /* 前半は15bit, 後半は17bit幅の正弦波 */
+      for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+        ddata[smpl] = sin(0.05f * smpl) + 0.01f * ((double)rand() / RAND_MAX - 0.5f);
+        data[smpl]  = (int32_t)SLAUtility_Round(ddata[smpl] * ((smpl < NUM_SAMPLES / 2) ? (1UL << 14) : (1UL << 16)));
+      }
+      testSLAPredictor_CalculateParcorCoef(ddata, NUM_SAMPLES, dcoef, order);
+      for (ord = 0; ord < order + 1; ord++) {
+        coef[ord] = (int32_t)SLAUtility_Round(dcoef[ord] * (1UL << 15));
+        coef[ord] = SLAUTILITY_INNER_VALUE(coef[ord], INT16_MIN, INT16_MAX);
+      }
+      testSLAPredictor_PredictInt32ByParcor(data, NUM_SAMPLES, coef, order, residual);
+
+      lpcs_int32 = SLALPCSynthesizer_Create(order);
+      lpcs_int16 = SLALPCSynthesizer_Create(order);
+      SLALPCSynthesizer_Reset(lpcs_int32);
+      SLALPCSynthesizer_Reset(lpcs_int16);
+      for (smpl = 0; smpl < NUM_SAMPLES; smpl += NUM_CHUNK) {
+        uint32_t num_process = SLAUTILITY_MIN(NUM_CHUNK, NUM_SAMPLES - smpl);
+        Test_AssertEqual(
+            SLALPCSynthesizer_SynthesizeByParcorCoefInt32(lpcs_int32,
+              &residual[smpl], num_process, coef, order, &output_int32[smpl]),
+            SLAPREDICTOR_APIRESULT_OK);
+        Test_AssertEqual(
+            SLALPCSynthesizer_SynthesizeByParcorCoefInt16(lpcs_int16,
+              &residual[smpl], num_process, coef, order, &output_int16[smpl]),
+            SLAPREDICTOR_APIRESULT_OK);
+      }
+
+      /* 後半で32bit幅に切り替わっているはず */
+      Test_AssertEqual(lpcs_int16->is_int16_residual, 0);
+
+      is_ok = 1;
+      for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+        if ((output_int32[smpl] != output_int16[smpl]) || (output_int16[smpl] != data[smpl])) {
+          is_ok = 0;
+          break;
+        }
+      }
+      Test_AssertEqual(is_ok, 1);
+
+      /* リセットすると16bit幅に戻る */
+      SLALPCSynthesizer_Reset(lpcs_int16);
+      Test_AssertEqual(lpcs_int16->is_int16_residual, 1);
+
+      SLALPCSynthesizer_Destroy(lpcs_int32);
+      SLALPCSynthesizer_Destroy(lpcs_int16);
+    }
+#undef NUM_SAMPLES
+#undef NUM_CHUNK
+  }
+}
+
+/* 次数固定版の合成関数テスト */
+static void testSLAPredictor_FixedOrderSynthesizeTest(void* obj)
+{
+  TEST_UNUSED_PARAMETER(obj);
+
+#define NUM_SAMPLES   4096
+#define NUM_CHUNK     100
+  /* PARCOR: 分割して合成しても汎用版と一致するか？（計算カーネルの選択によらない） */
+  {
+    uint32_t  i, k, smpl, ord, is_ok;
+    int32_t   data[NUM_SAMPLES], residual[NUM_SAMPLES];
+    int32_t   output_generic[NUM_SAMPLES], output_fixed[NUM_SAMPLES];
+    double    ddata[NUM_SAMPLES], dcoef[32 + 1];
+    int32_t   coef[32 + 1];
+    struct SLALPCSynthesizer *lpcs_generic, *lpcs_fixed;
+    static const uint32_t orders[] = { 8, 16, 32 };
+    static const SLASIMDInstructionSet simds[] = { SLA_SIMDINSTRUCTIONSET_NONE, SLA_SIMDINSTRUCTIONSET_AUTO };
+
+    for (k = 0; k < sizeof(simds) / sizeof(simds[0]); k++) {
+      for (i = 0; i < sizeof(orders) / sizeof(orders[0]); i++) {
+        const uint32_t order = orders[i];
+
+        for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+          ddata[smpl] = sin(0.05f * smpl) + 0.01f * ((double)rand() / RAND_MAX - 0.5f);
+          data[smpl]  = (int32_t)SLAUtility_Round(ddata[smpl] * (1UL << 20));
+        }
+        testSLAPredictor_CalculateParcorCoef(ddata, NUM_SAMPLES, dcoef, order);
+        for (ord = 0; ord < order + 1; ord++) {
+          coef[ord] = (int32_t)SLAUtility_Round(dcoef[ord] * (1UL << 15));
+        }
+        testSLAPredictor_PredictInt32ByParcor(data, NUM_SAMPLES, coef, order, residual);
+
+        /* 汎用版はリファレンス実装、次数固定版は指定した計算カーネルで作成 */
+        Test_AssertEqual(SLAPredictor_SetSIMDInstructionSet(SLA_SIMDINSTRUCTIONSET_NONE), SLAPREDICTOR_APIRESULT_OK);
+        lpcs_generic  = SLALPCSynthesizer_Create(order);
+        Test_AssertEqual(SLAPredictor_SetSIMDInstructionSet(simds[k]), SLAPREDICTOR_APIRESULT_OK);
+        lpcs_fixed    = SLALPCSynthesizer_Create(order);
+        SLALPCSynthesizer_Reset(lpcs_generic);
+        SLALPCSynthesizer_Reset(lpcs_fixed);
+        for (smpl = 0; smpl < NUM_SAMPLES; smpl += NUM_CHUNK) {
+          SLAPredictorApiResult ret;
+          uint32_t num_process = SLAUTILITY_MIN(NUM_CHUNK, NUM_SAMPLES - smpl);
+          Test_AssertEqual(
+              SLALPCSynthesizer_SynthesizeByParcorCoefInt32(lpcs_generic,
+                &residual[smpl], num_process, coef, order, &output_generic[smpl]),
+              SLAPREDICTOR_APIRESULT_OK);
+          switch (order) {
+            case 8:
+              ret = SLALPCSynthesizer_SynthesizeByParcorCoefInt32Order8(lpcs_fixed,
+                  &residual[smpl], num_process, coef, &output_fixed[smpl]);
+              break;
+            case 16:
+              ret = SLALPCSynthesizer_SynthesizeByParcorCoefInt32Order16(lpcs_fixed,
+                  &residual[smpl], num_process, coef, &output_fixed[smpl]);
+              break;
+            default:
+              ret = SLALPCSynthesizer_SynthesizeByParcorCoefInt32Order32(lpcs_fixed,
+                  &residual[smpl], num_process, coef, &output_fixed[smpl]);
+              break;
+          }
+          Test_AssertEqual(ret, SLAPREDICTOR_APIRESULT_OK);
+        }
+
+        is_ok = 1;
+        for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+          if ((output_generic[smpl] != output_fixed[smpl]) || (output_fixed[smpl] != data[smpl])) {
+            is_ok = 0;
+            break;
+          }
+        }
+        Test_AssertEqual(is_ok, 1);
+
+        SLALPCSynthesizer_Destroy(lpcs_generic);
+        SLALPCSynthesizer_Destroy(lpcs_fixed);
+      }
+    }
+  }
+
+  /* ロングターム: バッファリング中の呼び出しを含めて汎用版と一致するか？ */
+  {
+    uint32_t  i, smpl, is_ok;
+    int32_t   residual[NUM_SAMPLES];
+    int32_t   output_generic[NUM_SAMPLES], output_fixed[NUM_SAMPLES];
+    struct SLALongTermSynthesizer *ltm_generic, *ltm_fixed;
+    static const int32_t coef_taps1[1] = { 1 << 30 };
+    static const int32_t coef_taps3[3] = { 1 << 28, 1 << 29, 1 << 28 };
+    static const uint32_t num_taps[] = { 1, 3 };
+    const uint32_t pitch_period = 150;
+
+    for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+      residual[smpl] = (int32_t)SLAUtility_Round((1UL << 15) * sin(0.03f * smpl));
+    }
+
+    for (i = 0; i < sizeof(num_taps) / sizeof(num_taps[0]); i++) {
+      const int32_t* coef = (num_taps[i] == 1) ? coef_taps1 : coef_taps3;
+      ltm_generic = SLALongTermSynthesizer_Create(num_taps[i], pitch_period + 1);
+      ltm_fixed   = SLALongTermSynthesizer_Create(num_taps[i], pitch_period + 1);
+      for (smpl = 0; smpl < NUM_SAMPLES; smpl += NUM_CHUNK) {
+        SLAPredictorApiResult ret;
+        uint32_t num_process = SLAUTILITY_MIN(NUM_CHUNK, NUM_SAMPLES - smpl);
+        Test_AssertEqual(
+            SLALongTermSynthesizer_SynthesizeInt32(ltm_generic,
+              &residual[smpl], num_process, pitch_period, coef, num_taps[i], &output_generic[smpl]),
+            SLAPREDICTOR_APIRESULT_OK);
+        if (num_taps[i] == 1) {
+          ret = SLALongTermSynthesizer_SynthesizeInt32Taps1(ltm_fixed,
+              &residual[smpl], num_process, pitch_period, coef, &output_fixed[smpl]);
+        } else {
+          ret = SLALongTermSynthesizer_SynthesizeInt32Taps3(ltm_fixed,
+              &residual[smpl], num_process, pitch_period, coef, &output_fixed[smpl]);
+        }
+        Test_AssertEqual(ret, SLAPREDICTOR_APIRESULT_OK);
+      }
+
+      is_ok = 1;
+      for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+        if (output_generic[smpl] != output_fixed[smpl]) {
+          is_ok = 0;
+          break;
+        }
+      }
+      Test_AssertEqual(is_ok, 1);
+
+      SLALongTermSynthesizer_Destroy(ltm_generic);
+      SLALongTermSynthesizer_Destroy(ltm_fixed);
+    }
+  }
+
+  /* LMS: バッファリング中の呼び出しを含めて汎用版と一致するか？ */
+  {
+    uint32_t  i, smpl, is_ok;
+    int32_t   residual[NUM_SAMPLES];
+    int32_t   output_generic[NUM_SAMPLES], output_fixed[NUM_SAMPLES];
+    struct SLALMSFilter *nlms_generic, *nlms_fixed;
+    static const uint32_t orders[] = { 4, 8 };
+    /* 最初の呼び出しは次数未満のサンプル数で行う */
+    static const uint32_t chunks[] = { 3, 1, 7, NUM_CHUNK };
+
+    for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+      residual[smpl] = (int32_t)SLAUtility_Round((1UL << 12) * sin(0.07f * smpl))
+        + (int32_t)(rand() % 256) - 128;
+    }
+
+    for (i = 0; i < sizeof(orders) / sizeof(orders[0]); i++) {
+      uint32_t chunk_no = 0;
+      nlms_generic  = SLALMSFilter_Create(orders[i]);
+      nlms_fixed    = SLALMSFilter_Create(orders[i]);
+      for (smpl = 0; smpl < NUM_SAMPLES; ) {
+        SLAPredictorApiResult ret;
+        uint32_t num_process = SLAUTILITY_MIN(chunks[chunk_no], NUM_SAMPLES - smpl);
+        Test_AssertEqual(
+            SLALMSFilter_SynthesizeInt32(nlms_generic, orders[i],
+              &residual[smpl], num_process, &output_generic[smpl]),
+            SLAPREDICTOR_APIRESULT_OK);
+        if (orders[i] == 4) {
+          ret = SLALMSFilter_SynthesizeInt32Order4(nlms_fixed,
+              &residual[smpl], num_process, &output_fixed[smpl]);
+        } else {
+          ret = SLALMSFilter_SynthesizeInt32Order8(nlms_fixed,
+              &residual[smpl], num_process, &output_fixed[smpl]);
+        }
+        Test_AssertEqual(ret, SLAPREDICTOR_APIRESULT_OK);
+        smpl += num_process;
+        chunk_no = SLAUTILITY_MIN(chunk_no + 1, sizeof(chunks) / sizeof(chunks[0]) - 1);
+      }
+
+      is_ok = 1;
+      for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+        if (output_generic[smpl] != output_fixed[smpl]) {
+          is_ok = 0;
+          break;
+        }
+      }
+      Test_AssertEqual(is_ok, 1);
+
+      SLALMSFilter_Destroy(nlms_generic);
+      SLALMSFilter_Destroy(nlms_fixed);
+    }
+  }
+#undef NUM_SAMPLES
+#undef NUM_CHUNK
+}
+
+/* 命令セット切り替えテスト */
+static void testSLAPredictor_SIMDInstructionSetTest(void* obj)
+{
+  SLASIMDInstructionSet available;
+
+  TEST_UNUSED_PARAMETER(obj);
+
+  available = SLAUtility_GetAvailableSIMDInstructionSet();
+
+  /* 全計算カーネルがリファレンス実装と一致するか */
+  Test_AssertEqual(SLAPredictor_CheckKernels(), SLAPREDICTOR_APIRESULT_OK);
+
+  /* リファレンス実装は常に選択可能 */
+  Test_AssertEqual(SLAPredictor_SetSIMDInstructionSet(SLA_SIMDINSTRUCTIONSET_NONE), SLAPREDICTOR_APIRESULT_OK);
+  Test_AssertEqual(SLAPredictor_GetSIMDInstructionSet(), SLA_SIMDINSTRUCTIONSET_NONE);
+
+  /* SSE4.1は実行環境で使用可能な場合のみ選択可能 */
+  if (available >= SLA_SIMDINSTRUCTIONSET_SSE41) {
+    Test_AssertEqual(SLAPredictor_SetSIMDInstructionSet(SLA_SIMDINSTRUCTIONSET_SSE41), SLAPREDICTOR_APIRESULT_OK);
+    Test_AssertEqual(SLAPredictor_GetSIMDInstructionSet(), SLA_SIMDINSTRUCTIONSET_SSE41);
+  } else {
+    Test_AssertEqual(SLAPredictor_SetSIMDInstructionSet(SLA_SIMDINSTRUCTIONSET_SSE41), SLAPREDICTOR_APIRESULT_INVALID_ARGUMENT);
+  }
+
+  /* 作成時点の設定がハンドルに固定され、以降の設定変更の影響を受けないか */
+  {
+    struct SLALPCSynthesizer *lpcs_ref, *lpcs_auto;
+    struct SLALMSFilter *nlms_ref, *nlms_auto;
+
+    Test_AssertEqual(SLAPredictor_SetSIMDInstructionSet(SLA_SIMDINSTRUCTIONSET_NONE), SLAPREDICTOR_APIRESULT_OK);
+    lpcs_ref = SLALPCSynthesizer_Create(32);
+    nlms_ref = SLALMSFilter_Create(32);
+    Test_AssertEqual(SLAPredictor_SetSIMDInstructionSet(SLA_SIMDINSTRUCTIONSET_AUTO), SLAPREDICTOR_APIRESULT_OK);
+    lpcs_auto = SLALPCSynthesizer_Create(32);
+    nlms_auto = SLALMSFilter_Create(32);
+    Test_AssertCondition(lpcs_ref != NULL && nlms_ref != NULL);
+    Test_AssertCondition(lpcs_auto != NULL && nlms_auto != NULL);
+
+    Test_AssertEqual(lpcs_ref->kernel_table->simd, SLA_SIMDINSTRUCTIONSET_NONE);
+    Test_AssertEqual(nlms_ref->kernel_table->simd, SLA_SIMDINSTRUCTIONSET_NONE);
+    Test_AssertEqual(lpcs_auto->kernel_table->simd, available);
+    Test_AssertEqual(nlms_auto->kernel_table->simd, available);
+
+    SLALPCSynthesizer_Destroy(lpcs_ref);
+    SLALMSFilter_Destroy(nlms_ref);
+    SLALPCSynthesizer_Destroy(lpcs_auto);
+    SLALMSFilter_Destroy(nlms_auto);
+  }
+
+  /* 自動選択に戻す */
+  Test_AssertEqual(SLAPredictor_SetSIMDInstructionSet(SLA_SIMDINSTRUCTIONSET_AUTO), SLAPREDICTOR_APIRESULT_OK);
+  Test_AssertEqual(SLAPredictor_GetSIMDInstructionSet(), available);
+}
+
 /* ロングタームの係数計算テスト */
 static void testLPCLongTermCalculator_CalculateCoefTest(void* obj)
 {
@@ -1082,6 +1509,9 @@ void testSLAPredictor_Setup(void)
 
   Test_AddTest(suite, testLPC_CalculateCoefTest);
   Test_AddTest(suite, testSLALPCSynthesizer_PredictSynthTest);
+  Test_AddTest(suite, testSLALPCSynthesizer_SynthesizeInt16Test);
+  Test_AddTest(suite, testSLAPredictor_FixedOrderSynthesizeTest);
+  Test_AddTest(suite, testSLAPredictor_SIMDInstructionSetTest);
   Test_AddTest(suite, testLPCLongTermCalculator_CalculateCoefTest);
   Test_AddTest(suite, testLPCLongTermCalculator_PitchDetectTest);
   Test_AddTest(suite, testSLAOptimalEncodeEstimator_DijkstraTest);
@@ -0,0 +1,383 @@
+/* メモリマップにPOSIXの機能を使う */
+#define _POSIX_C_SOURCE 200112L
+
+#include "test.h"
+#include "SLA_TestUtility.h"
+#include "SLAEncoder.h"
+
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+/* テスト対象のモジュール */
+#include "../src/SLAReader.c"
+
+/* テスト用のファイル名 */
+#define TEST_SLA_FILENAME       "reader_test.sla"
+#define TEST_SLA_INDEX_FILENAME "reader_test.sla.slaidx"
+/* テスト用の波形のサンプル数とチャンネル数 */
+#define TEST_NUM_SAMPLES        (4096 * 6 + 123)
+#define TEST_NUM_CHANNELS       2
+
+/* テストのセットアップ関数 */
+void testSLAReader_Setup(void);
+
+static int testSLAReader_Initialize(void *obj)
+{
+  TEST_UNUSED_PARAMETER(obj);
+  return 0;
+}
+
+static int testSLAReader_Finalize(void *obj)
+{
+  TEST_UNUSED_PARAMETER(obj);
+  return 0;
+}
+
+/* テスト用のSLAファイルを作成 */
+static uint32_t testSLAReader_CreateTestFile(int32_t** input, uint8_t** encoded)
+{
+  uint32_t ch, smpl, data_size, encoded_size;
+  uint8_t* data;
+  FILE* fp;
+  struct SLAEncoderConfig   config;
+  struct SLAEncoder*        encoder;
+  struct SLAWaveFormat      wave_format;
+  struct SLAEncodeParameter enc_param;
+
+  /* 周波数の異なる正弦波 */
+  for (ch = 0; ch < TEST_NUM_CHANNELS; ch++) {
+    for (smpl = 0; smpl < TEST_NUM_SAMPLES; smpl++) {
+      input[ch][smpl] = (int32_t)(8000.0 * sin(0.01 * (ch + 1) * smpl)) << 16;
+    }
+  }
+
+  wave_format.num_channels    = TEST_NUM_CHANNELS;
+  wave_format.bit_per_sample  = 16;
+  wave_format.sampling_rate   = 44100;
+  wave_format.offset_lshift   = 0;
+  enc_param.parcor_order          = 16;
+  enc_param.longterm_order        = 1;
+  enc_param.lms_order_per_filter  = 8;
+  enc_param.ch_process_method     = SLA_CHPROCESSMETHOD_STEREO_MS;
+  enc_param.window_function_type  = SLA_WINDOWFUNCTIONTYPE_SIN;
+  enc_param.max_num_block_samples = 4096;
+
+  data_size = SLA_HEADER_SIZE + SLA_CalculateSufficientBlockSize(TEST_NUM_CHANNELS, TEST_NUM_SAMPLES, 16);
+  data = (uint8_t *)malloc(data_size);
+
+  SLAEncoder_SetDefaultConfig(&config);
+  encoder = SLAEncoder_Create(&config);
+  SLAEncoder_SetWaveFormat(encoder, &wave_format);
+  SLAEncoder_SetEncodeParameter(encoder, &enc_param);
+  SLAEncoder_EncodeWhole(encoder, (const int32_t **)input, TEST_NUM_SAMPLES, data, data_size, &encoded_size);
+  SLAEncoder_Destroy(encoder);
+
+  fp = fopen(TEST_SLA_FILENAME, "wb");
+  fwrite(data, sizeof(uint8_t), encoded_size, fp);
+  fclose(fp);
+
+  *encoded = data;
+  return encoded_size;
+}
+
+/* 索引ファイルを書き出し */
+static void testSLAReader_WriteIndexFile(const uint8_t* data, uint32_t data_size)
+{
+  uint32_t num_entries, index_size;
+  uint8_t* index_data;
+  struct SLABlockIndexEntry* entries;
+  FILE* fp;
+
+  SLADecoder_BuildBlockIndex(data, data_size, NULL, 0, &num_entries);
+  entries = (struct SLABlockIndexEntry *)malloc(sizeof(struct SLABlockIndexEntry) * num_entries);
+  SLADecoder_BuildBlockIndex(data, data_size, entries, num_entries, &num_entries);
+  index_size = SLADecoder_CalculateBlockIndexFileSize(num_entries);
+  index_data = (uint8_t *)malloc(index_size);
+  SLADecoder_EncodeBlockIndexFile(data, data_size, entries, num_entries, index_data, index_size, &index_size);
+
+  fp = fopen(TEST_SLA_INDEX_FILENAME, "wb");
+  fwrite(index_data, sizeof(uint8_t), index_size, fp);
+  fclose(fp);
+
+  free(index_data);
+  free(entries);
+}
+
+/* 開閉とデコードのテスト */
+static void testSLAReader_OpenDecodeTest(void *obj)
+{
+  uint32_t ch, i, encoded_size, num_blocks, num_samples, total;
+  int32_t *input[TEST_NUM_CHANNELS], *output[TEST_NUM_CHANNELS];
+  uint8_t *encoded;
+  const uint8_t *data;
+  uint64_t data_size;
+  struct SLADecoderConfig   config;
+  struct SLAReader*         reader;
+  struct SLABlockIndexEntry entry, expected[32];
+  uint32_t num_expected;
+
+  TEST_UNUSED_PARAMETER(obj);
+
+  for (ch = 0; ch < TEST_NUM_CHANNELS; ch++) {
+    input[ch]   = (int32_t *)malloc(sizeof(int32_t) * TEST_NUM_SAMPLES);
+    output[ch]  = (int32_t *)malloc(sizeof(int32_t) * TEST_NUM_SAMPLES);
+  }
+  remove(TEST_SLA_INDEX_FILENAME);
+  encoded_size = testSLAReader_CreateTestFile(input, &encoded);
+  SLADecoder_SetDefaultConfig(&config);
+  Test_AssertEqual(SLADecoder_BuildBlockIndex(encoded, encoded_size, expected, 32, &num_expected), SLA_APIRESULT_OK);
+
+  /* 失敗ケース */
+  Test_AssertCondition(SLAReader_Open(NULL, &config) == NULL);
+  Test_AssertCondition(SLAReader_Open(TEST_SLA_FILENAME, NULL) == NULL);
+  Test_AssertCondition(SLAReader_Open("no_such_file.sla", &config) == NULL);
+
+  /* 開いた直後はヘッダだけ読み、索引は作成しない */
+  reader = SLAReader_Open(TEST_SLA_FILENAME, &config);
+  Test_AssertCondition(reader != NULL);
+#if defined(SLAREADER_USE_MMAP)
+  Test_AssertEqual(reader->is_mapped, 1);
+#endif
+  Test_AssertEqual(reader->num_entries, 0);
+  Test_AssertEqual(SLAReader_GetHeaderInfo(reader)->num_samples, TEST_NUM_SAMPLES);
+  Test_AssertEqual(SLAReader_GetHeaderInfo(reader)->wave_format.num_channels, TEST_NUM_CHANNELS);
+  Test_AssertEqual(SLAReader_GetData(reader, &data, &data_size), SLA_APIRESULT_OK);
+  Test_AssertEqual(data_size, encoded_size);
+  Test_AssertEqual(memcmp(data, encoded, encoded_size), 0);
+  Test_AssertCondition(SLAReader_GetDecoder(reader) != NULL);
+  Test_AssertEqual(SLAReader_SetAccessPattern(reader, SLAREADER_ACCESSPATTERN_RANDOM), SLA_APIRESULT_OK);
+
+  /* 必要なブロックまでしか索引を作らない */
+  Test_AssertEqual(SLAReader_GetBlockIndexEntry(reader, 2, &entry), SLA_APIRESULT_OK);
+  Test_AssertEqual(reader->num_entries, 3);
+  Test_AssertEqual(entry.data_offset, expected[2].data_offset);
+  Test_AssertEqual(entry.sample_offset, expected[2].sample_offset);
+  Test_AssertEqual(entry.block_size, expected[2].block_size);
+  Test_AssertEqual(entry.num_samples, expected[2].num_samples);
+  Test_AssertEqual(entry.crc16, expected[2].crc16);
+
+  /* ブロック単位のデコード */
+  total = 0;
+  Test_AssertEqual(SLAReader_GetNumBlocks(reader, &num_blocks), SLA_APIRESULT_OK);
+  Test_AssertEqual(num_blocks, num_expected);
+  Test_AssertEqual(SLAReader_GetBlockIndexEntry(reader, num_blocks, &entry), SLA_APIRESULT_INVALID_ARGUMENT);
+  for (i = 0; i < num_blocks; i++) {
+    int32_t* block_output[TEST_NUM_CHANNELS];
+    for (ch = 0; ch < TEST_NUM_CHANNELS; ch++) {
+      block_output[ch] = &output[ch][total];
+    }
+    Test_AssertEqual(SLAReader_DecodeBlock(reader, i, block_output, TEST_NUM_SAMPLES - total, &num_samples), SLA_APIRESULT_OK);
+    Test_AssertEqual(num_samples, expected[i].num_samples);
+    total += num_samples;
+  }
+  Test_AssertEqual(total, TEST_NUM_SAMPLES);
+  for (ch = 0; ch < TEST_NUM_CHANNELS; ch++) {
+    Test_AssertEqual(memcmp(input[ch], output[ch], sizeof(int32_t) * TEST_NUM_SAMPLES), 0);
+  }
+  SLAReader_Close(reader);
+
+  /* 範囲デコード（開いた直後から） */
+  reader = SLAReader_Open(TEST_SLA_FILENAME, &config);
+  Test_AssertEqual(SLAReader_DecodeRange(reader, 10000, 3000, output, TEST_NUM_SAMPLES, &num_samples), SLA_APIRESULT_OK);
+  Test_AssertEqual(num_samples, 3000);
+  for (ch = 0; ch < TEST_NUM_CHANNELS; ch++) {
+    Test_AssertEqual(memcmp(&input[ch][10000], output[ch], sizeof(int32_t) * 3000), 0);
+  }
+  Test_AssertCondition(reader->num_entries < num_expected);
+  Test_AssertEqual(SLAReader_DecodeRange(reader, TEST_NUM_SAMPLES, 1, output, TEST_NUM_SAMPLES, &num_samples),
+      SLA_APIRESULT_INVALID_ARGUMENT);
+  SLAReader_Close(reader);
+
+  /* 全体を読み込む経路 */
+  {
+    struct SLAReader tmp_reader;
+    memset(&tmp_reader, 0, sizeof(tmp_reader));
+    Test_AssertEqual(SLAReader_LoadFile(&tmp_reader, TEST_SLA_FILENAME), SLA_APIRESULT_OK);
+    Test_AssertEqual(tmp_reader.is_mapped, 0);
+    Test_AssertEqual(tmp_reader.data_size, encoded_size);
+    Test_AssertEqual(memcmp(tmp_reader.data, encoded, encoded_size), 0);
+    free((void *)tmp_reader.data);
+    Test_AssertEqual(SLAReader_LoadFile(&tmp_reader, "no_such_file.sla"), SLA_APIRESULT_NG);
+  }
+
+  for (ch = 0; ch < TEST_NUM_CHANNELS; ch++) {
+    free(input[ch]);
+    free(output[ch]);
+  }
+  free(encoded);
+  remove(TEST_SLA_FILENAME);
+}
+
+/* 索引ファイルのテスト */
+static void testSLAReader_IndexFileTest(void *obj)
+{
+  uint32_t ch, encoded_size, num_blocks;
+  int32_t *input[TEST_NUM_CHANNELS];
+  uint8_t *encoded;
+  struct SLADecoderConfig   config;
+  struct SLAReader*         reader;
+
+  TEST_UNUSED_PARAMETER(obj);
+
+  for (ch = 0; ch < TEST_NUM_CHANNELS; ch++) {
+    input[ch] = (int32_t *)malloc(sizeof(int32_t) * TEST_NUM_SAMPLES);
+  }
+  encoded_size = testSLAReader_CreateTestFile(input, &encoded);
+  SLADecoder_SetDefaultConfig(&config);
+
+  /* 一致する索引ファイルがあれば開いた時点で索引が揃う */
+  testSLAReader_WriteIndexFile(encoded, encoded_size);
+  reader = SLAReader_Open(TEST_SLA_FILENAME, &config);
+  Test_AssertCondition(reader != NULL);
+  Test_AssertEqual(reader->is_index_complete, 1);
+  Test_AssertEqual(SLAReader_GetNumBlocks(reader, &num_blocks), SLA_APIRESULT_OK);
+  Test_AssertEqual(num_blocks, SLAReader_GetHeaderInfo(reader)->num_blocks);
+  SLAReader_Close(reader);
+
+  /* 別のデータの索引ファイルは使わない */
+  testSLAReader_WriteIndexFile(encoded, encoded_size);
+  {
+    /* 対象ファイルを1バイト伸ばしてサイズを変える */
+    FILE* fp = fopen(TEST_SLA_FILENAME, "ab");
+    fputc(0, fp);
+    fclose(fp);
+  }
+  reader = SLAReader_Open(TEST_SLA_FILENAME, &config);
+  Test_AssertCondition(reader != NULL);
+  Test_AssertEqual(reader->is_index_complete, 0);
+  Test_AssertEqual(reader->num_entries, 0);
+  SLAReader_Close(reader);
+
+  for (ch = 0; ch < TEST_NUM_CHANNELS; ch++) {
+    free(input[ch]);
+  }
+  free(encoded);
+  remove(TEST_SLA_FILENAME);
+  remove(TEST_SLA_INDEX_FILENAME);
+}
+
+/* 4GiBを超える位置のブロックのテスト */
+/* 補足）ヘッダの直後を空けて4GiBより先に1ブロックだけ置いたスパースファイルを作り、
+ *       索引ファイル経由でオフセット・サンプル位置が32bitを超えるブロックをデコードする */
+static void testSLAReader_LargeOffsetTest(void *obj)
+{
+#if defined(SLAREADER_USE_MMAP)
+  const uint64_t large_data_offset = ((uint64_t)1 << 32) + 4096;
+  const uint64_t large_sample_offset = ((uint64_t)1 << 32) + 100;
+  uint32_t ch, smpl, encoded_size, num_entries, index_size, num_samples, num_blocks;
+  int32_t *input[TEST_NUM_CHANNELS], *output[TEST_NUM_CHANNELS];
+  uint8_t *encoded, *index_data;
+  uint8_t header_data[SLA_HEADER_SIZE];
+  const uint8_t *data;
+  uint64_t data_size;
+  struct SLAHeaderInfo      header;
+  struct SLABlockIndexEntry entries[32], large_entry;
+  struct SLADecoderConfig   config;
+  struct SLAReader*         reader;
+  FILE* fp;
+
+  TEST_UNUSED_PARAMETER(obj);
+
+  /* 64bitのアドレス空間でなければマップできない */
+  if ((sizeof(size_t) < 8) || (sizeof(long) < 8)) {
+    return;
+  }
+
+  for (ch = 0; ch < TEST_NUM_CHANNELS; ch++) {
+    input[ch]   = (int32_t *)malloc(sizeof(int32_t) * TEST_NUM_SAMPLES);
+    output[ch]  = (int32_t *)malloc(sizeof(int32_t) * TEST_NUM_SAMPLES);
+  }
+  encoded_size = testSLAReader_CreateTestFile(input, &encoded);
+  SLADecoder_SetDefaultConfig(&config);
+  Test_AssertEqual(SLADecoder_BuildBlockIndex(encoded, encoded_size, entries, 32, &num_entries), SLA_APIRESULT_OK);
+  Test_AssertCondition(num_entries > 2);
+
+  /* 2番目のブロックを4GiB先・サンプル位置2^32以降に置いたファイルを作成 */
+  large_entry = entries[1];
+  large_entry.data_offset   = large_data_offset;
+  large_entry.sample_offset = large_sample_offset;
+  Test_AssertEqual(SLADecoder_DecodeHeader(encoded, encoded_size, &header), SLA_APIRESULT_OK);
+  header.num_samples  = large_sample_offset + large_entry.num_samples;
+  header.num_blocks   = 1;
+  Test_AssertEqual(SLAEncoder_EncodeHeader(&header, header_data, sizeof(header_data)), SLA_APIRESULT_OK);
+  fp = fopen(TEST_SLA_FILENAME, "wb");
+  Test_AssertCondition(fp != NULL);
+  fwrite(header_data, sizeof(uint8_t), SLA_HEADER_SIZE, fp);
+  Test_AssertEqual(fseek(fp, (long)large_data_offset, SEEK_SET), 0);
+  fwrite(&encoded[entries[1].data_offset], sizeof(uint8_t), entries[1].block_size, fp);
+  fclose(fp);
+  data_size = large_data_offset + large_entry.block_size;
+
+  /* 索引ファイルの書き出し */
+  index_size = SLADecoder_CalculateBlockIndexFileSize(1);
+  index_data = (uint8_t *)malloc(index_size);
+  Test_AssertEqual(SLADecoder_EncodeBlockIndexFile(header_data, data_size,
+        &large_entry, 1, index_data, index_size, &index_size), SLA_APIRESULT_OK);
+  fp = fopen(TEST_SLA_INDEX_FILENAME, "wb");
+  fwrite(index_data, sizeof(uint8_t), index_size, fp);
+  fclose(fp);
+
+  /* 4GiBを超えるファイルも開けて索引が使われる */
+  reader = SLAReader_Open(TEST_SLA_FILENAME, &config);
+  Test_AssertCondition(reader != NULL);
+  if (reader != NULL) {
+    struct SLABlockIndexEntry entry;
+    Test_AssertEqual(reader->is_index_complete, 1);
+    Test_AssertEqual(SLAReader_GetData(reader, &data, &data_size), SLA_APIRESULT_OK);
+    Test_AssertCondition(data_size == (large_data_offset + large_entry.block_size));
+    Test_AssertEqual(SLAReader_GetNumBlocks(reader, &num_blocks), SLA_APIRESULT_OK);
+    Test_AssertEqual(num_blocks, 1);
+    Test_AssertEqual(SLAReader_GetBlockIndexEntry(reader, 0, &entry), SLA_APIRESULT_OK);
+    Test_AssertCondition(entry.data_offset == large_data_offset);
+    Test_AssertCondition(entry.sample_offset == large_sample_offset);
+
+    /* ブロック全体 */
+    Test_AssertEqual(SLAReader_DecodeBlock(reader, 0, output, TEST_NUM_SAMPLES, &num_samples), SLA_APIRESULT_OK);
+    Test_AssertEqual(num_samples, entries[1].num_samples);
+    for (ch = 0; ch < TEST_NUM_CHANNELS; ch++) {
+      for (smpl = 0; smpl < num_samples; smpl++) {
+        if (output[ch][smpl] != input[ch][entries[1].sample_offset + smpl]) {
+          break;
+        }
+      }
+      Test_AssertEqual(smpl, num_samples);
+    }
+
+    /* ブロック途中からの範囲 */
+    Test_AssertEqual(SLAReader_DecodeRange(reader, large_sample_offset + 10, 100,
+          output, TEST_NUM_SAMPLES, &num_samples), SLA_APIRESULT_OK);
+    Test_AssertEqual(num_samples, 100);
+    for (ch = 0; ch < TEST_NUM_CHANNELS; ch++) {
+      Test_AssertEqual(memcmp(output[ch], &input[ch][entries[1].sample_offset + 10], sizeof(int32_t) * 100), 0);
+    }
+    /* 索引より前の位置は範囲外 */
+    Test_AssertEqual(SLAReader_DecodeRange(reader, 0, 100,
+          output, TEST_NUM_SAMPLES, &num_samples), SLA_APIRESULT_INVALID_ARGUMENT);
+    SLAReader_Close(reader);
+  }
+
+  for (ch = 0; ch < TEST_NUM_CHANNELS; ch++) {
+    free(input[ch]);
+    free(output[ch]);
+  }
+  free(index_data);
+  free(encoded);
+  remove(TEST_SLA_FILENAME);
+  remove(TEST_SLA_INDEX_FILENAME);
+#else
+  TEST_UNUSED_PARAMETER(obj);
+#endif
+}
+
+void testSLAReader_Setup(void)
+{
+  struct TestSuite *suite
+    = Test_AddTestSuite("SLA Reader Test Suite",
+        NULL, testSLAReader_Initialize, testSLAReader_Finalize);
+
+  Test_AddTest(suite, testSLAReader_OpenDecodeTest);
+  Test_AddTest(suite, testSLAReader_IndexFileTest);
+  Test_AddTest(suite, testSLAReader_LargeOffsetTest);
+}
@@ -1,3 +1,6 @@
+/* テスト対象のモジュールがPOSIXの時計を使うため */
+#define _POSIX_C_SOURCE 199309L
+
 #include "test.h"
 #include <stdio.h>
 #include <stdlib.h>
@@ -886,6 +889,82 @@ static void testSLADataPacketQueue_AppendCoollectDataTest(void* obj)
     SLADataPacketQueue_Destroy(queue);
   }
 
+  /* 先頭データの参照テスト: 参照しても読み出し位置は進まない */
+  {
+    struct SLADataPacketQueue* queue;
+    const uint8_t data1[6] = { 1, 2, 3, 4, 5, 6 };
+    const uint8_t data2[2] = { 7, 8 };
+    const uint8_t*  get_data;
+    uint32_t        get_data_size;
+
+    queue = SLADataPacketQueue_Create(2);
+
+    /* 空のときは参照できない */
+    Test_AssertEqual(SLADataPacketQueue_PeekDataFragment(queue, &get_data, &get_data_size), SLA_DATAPACKETQUEUE_APIRESULT_NO_DATA_FRAGMENTS);
+
+    Test_AssertEqual(SLADataPacketQueue_EnqueueDataFragment(queue, data1, sizeof(data1)), SLA_DATAPACKETQUEUE_APIRESULT_OK);
+    Test_AssertEqual(SLADataPacketQueue_EnqueueDataFragment(queue, data2, sizeof(data2)), SLA_DATAPACKETQUEUE_APIRESULT_OK);
+
+    /* 何度参照しても同じ結果 */
+    Test_AssertEqual(SLADataPacketQueue_PeekDataFragment(queue, &get_data, &get_data_size), SLA_DATAPACKETQUEUE_APIRESULT_OK);
+    Test_AssertCondition(get_data == &data1[0]); Test_AssertEqual(get_data_size, 6);
+    Test_AssertEqual(SLADataPacketQueue_PeekDataFragment(queue, &get_data, &get_data_size), SLA_DATAPACKETQUEUE_APIRESULT_OK);
+    Test_AssertCondition(get_data == &data1[0]); Test_AssertEqual(get_data_size, 6);
+    Test_AssertEqual(SLADataPacketQueue_GetRemainDataSize(queue), 8);
+
+    /* 一部を取り出すと未読部分が参照される */
+    Test_AssertEqual(SLADataPacketQueue_GetDataFragment(queue, &get_data, &get_data_size, 4), SLA_DATAPACKETQUEUE_APIRESULT_OK);
+    Test_AssertEqual(SLADataPacketQueue_PeekDataFragment(queue, &get_data, &get_data_size), SLA_DATAPACKETQUEUE_APIRESULT_OK);
+    Test_AssertCondition(get_data == &data1[4]); Test_AssertEqual(get_data_size, 2);
+
+    /* 読み切ると次のパケットが参照される */
+    Test_AssertEqual(SLADataPacketQueue_GetDataFragment(queue, &get_data, &get_data_size, 4), SLA_DATAPACKETQUEUE_APIRESULT_OK);
+    Test_AssertEqual(SLADataPacketQueue_PeekDataFragment(queue, &get_data, &get_data_size), SLA_DATAPACKETQUEUE_APIRESULT_OK);
+    Test_AssertCondition(get_data == &data2[0]); Test_AssertEqual(get_data_size, 2);
+
+    /* 全部読み切ると参照できない */
+    Test_AssertEqual(SLADataPacketQueue_GetDataFragment(queue, &get_data, &get_data_size, 4), SLA_DATAPACKETQUEUE_APIRESULT_OK);
+    Test_AssertEqual(SLADataPacketQueue_PeekDataFragment(queue, &get_data, &get_data_size), SLA_DATAPACKETQUEUE_APIRESULT_NO_DATA_FRAGMENTS);
+
+    SLADataPacketQueue_Destroy(queue);
+  }
+
+  /* オフセット指定のデータコピーテスト: パケットをまたいでコピーできるか */
+  {
+    struct SLADataPacketQueue* queue;
+    const uint8_t data1[3] = { 1, 2, 3 };
+    const uint8_t data2[4] = { 4, 5, 6, 7 };
+    const uint8_t*  get_data;
+    uint32_t        get_data_size;
+    uint8_t         copy_data[4];
+
+    queue = SLADataPacketQueue_Create(2);
+
+    /* 空のときはコピーできない */
+    Test_AssertEqual(SLADataPacketQueue_PeekData(queue, 0, copy_data, 1), SLA_DATAPACKETQUEUE_APIRESULT_NO_DATA_FRAGMENTS);
+
+    Test_AssertEqual(SLADataPacketQueue_EnqueueDataFragment(queue, data1, sizeof(data1)), SLA_DATAPACKETQUEUE_APIRESULT_OK);
+    Test_AssertEqual(SLADataPacketQueue_EnqueueDataFragment(queue, data2, sizeof(data2)), SLA_DATAPACKETQUEUE_APIRESULT_OK);
+
+    /* パケットをまたいでコピー */
+    Test_AssertEqual(SLADataPacketQueue_PeekData(queue, 1, copy_data, 4), SLA_DATAPACKETQUEUE_APIRESULT_OK);
+    Test_AssertEqual(copy_data[0], 2); Test_AssertEqual(copy_data[1], 3);
+    Test_AssertEqual(copy_data[2], 4); Test_AssertEqual(copy_data[3], 5);
+
+    /* 読み出し位置は進まない */
+    Test_AssertEqual(SLADataPacketQueue_GetRemainDataSize(queue), 7);
+
+    /* 読み出し済みの部分は飛ばされる */
+    Test_AssertEqual(SLADataPacketQueue_GetDataFragment(queue, &get_data, &get_data_size, 2), SLA_DATAPACKETQUEUE_APIRESULT_OK);
+    Test_AssertEqual(SLADataPacketQueue_PeekData(queue, 0, copy_data, 2), SLA_DATAPACKETQUEUE_APIRESULT_OK);
+    Test_AssertEqual(copy_data[0], 3); Test_AssertEqual(copy_data[1], 4);
+
+    /* 残りを超えるコピーはできない */
+    Test_AssertEqual(SLADataPacketQueue_PeekData(queue, 2, copy_data, 4), SLA_DATAPACKETQUEUE_APIRESULT_NO_DATA_FRAGMENTS);
+
+    SLADataPacketQueue_Destroy(queue);
+  }
+
 }
 
 void testSLAUtility_Setup(void)
@@ -440,6 +440,27 @@ static void testCommandLineParser_GetOtherStringTest(void *obj)
     Test_AssertEqual(strcmp(specs[0].argument_string, "inputfile"), 0);
   }
 
+  /* "-"単体はオプションではなく文字列として扱う */
+  {
+    struct CommandLineParserSpecification specs[] = {
+      { 'i', "input", COMMAND_LINE_PARSER_TRUE, "input file", NULL, COMMAND_LINE_PARSER_FALSE },
+      { 0, }
+    };
+    char* test_argv[] = { "progname", "-", "-i", "inputfile", "-" };
+    const char* other_string_array[2];
+
+    Test_AssertEqual(
+        CommandLineParser_ParseArguments(
+          specs,
+          sizeof(test_argv) / sizeof(test_argv[0]), test_argv,
+          other_string_array, sizeof(other_string_array) / sizeof(other_string_array[0])),
+        COMMAND_LINE_PARSER_RESULT_OK);
+
+    Test_AssertEqual(strcmp(other_string_array[0], "-"), 0);
+    Test_AssertEqual(strcmp(other_string_array[1], "-"), 0);
+    Test_AssertEqual(strcmp(specs[0].argument_string, "inputfile"), 0);
+  }
+
   /* 失敗系 */
 
   /* バッファサイズが足らない */
@@ -8,10 +8,12 @@ void testSLAEncoder_Setup(void);
 void testSLADecoder_Setup(void);
 void testSLAUtility_Setup(void);
 void testSLAByteArray_Setup(void);
+void testSLABlockCache_Setup(void);
 void testSLAEncodeDecode_Setup(void);
 
 void testWAV_Setup(void);
 void testCommandLineParser_Setup(void);
+void testSLAReader_Setup(void);
 
 /* テスト実行 */
 int main(int argc, char **argv)
@@ -30,10 +32,12 @@ int main(int argc, char **argv)
   testSLADecoder_Setup();
   testSLAUtility_Setup();
   testSLAByteArray_Setup();
+  testSLABlockCache_Setup();
   testSLAEncodeDecode_Setup();
 
   testWAV_Setup();
   testCommandLineParser_Setup();
+  testSLAReader_Setup();
 
   ret = Test_RunAllTestSuite();
 
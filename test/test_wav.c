@@ -136,16 +136,16 @@ static void testWAV_WriteTest(void *obj)
     WAVWriter_Initialize(&writer, fp);
 
     Test_AssertNotEqual(
-        WAVWriter_PutWAVHeader(&writer, NULL),
+        WAVWriter_PutWAVHeader(&writer, NULL, 0),
         WAV_ERROR_OK);
     Test_AssertNotEqual(
-        WAVWriter_PutWAVHeader(NULL, &format),
+        WAVWriter_PutWAVHeader(NULL, &format, 0),
         WAV_ERROR_OK);
     Test_AssertNotEqual(
-        WAVWriter_PutWAVHeader(NULL, NULL),
+        WAVWriter_PutWAVHeader(NULL, NULL, 0),
         WAV_ERROR_OK);
     Test_AssertNotEqual(
-        WAVWriter_PutWAVHeader(&writer, &format),
+        WAVWriter_PutWAVHeader(&writer, &format, 0),
         WAV_ERROR_OK);
 
     WAVWriter_Finalize(&writer);
@@ -245,6 +245,412 @@ static void testWAV_WriteTest(void *obj)
 
 }
 
+/* ビット深度・サイズ毎の読み書き一致テスト */
+static void testWAV_ReadWriteBitDepthTest(void *obj)
+{
+  const char test_filename[] = "tmp.wav";
+  const uint32_t bits_per_sample_list[] = { 8, 16, 24, 32 };
+  /* ビットバッファより小さいファイル・一括読み込み単位をまたぐファイル */
+  const uint32_t num_samples_list[] = { 100, WAVPARSER_BULK_READ_NUM_SAMPLES + 37 };
+  uint32_t i_bits, i_size, ch, smpl, is_ok;
+  struct WAVFileFormat format;
+  struct WAVFile *src_wavfile, *test_wavfile;
+
+  TEST_UNUSED_PARAMETER(obj);
+
+  for (i_bits = 0; i_bits < sizeof(bits_per_sample_list) / sizeof(bits_per_sample_list[0]); i_bits++) {
+    for (i_size = 0; i_size < sizeof(num_samples_list) / sizeof(num_samples_list[0]); i_size++) {
+      format.data_format     = WAV_DATA_FORMAT_PCM;
+      format.num_channels    = 3;
+      format.sampling_rate   = 48000;
+      format.bits_per_sample = bits_per_sample_list[i_bits];
+      format.num_samples     = num_samples_list[i_size];
+
+      /* 最小値・最大値を含む全域の値で埋める */
+      src_wavfile = WAV_Create(&format);
+      srand(i_bits * 10 + i_size);
+      for (ch = 0; ch < format.num_channels; ch++) {
+        for (smpl = 0; smpl < format.num_samples; smpl++) {
+          uint32_t rnd = ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+          if (smpl == 0) {
+            rnd = 0x80000000UL;
+          } else if (smpl == 1) {
+            rnd = 0x7FFFFFFFUL;
+          }
+          /* 下位ビットはファイルに残らないので落としておく */
+          rnd &= (0xFFFFFFFFUL << (32 - format.bits_per_sample));
+          WAVFile_PCM(src_wavfile, smpl, ch) = (int32_t)rnd;
+        }
+      }
+
+      Test_AssertEqual(WAV_WriteToFile(test_filename, src_wavfile), WAV_APIRESULT_OK);
+      test_wavfile = WAV_CreateFromFile(test_filename);
+      Test_AssertCondition(test_wavfile != NULL);
+      Test_AssertEqual(memcmp(&src_wavfile->format, &test_wavfile->format, sizeof(struct WAVFileFormat)), 0);
+
+      is_ok = 1;
+      for (ch = 0; ch < format.num_channels; ch++) {
+        if (memcmp(src_wavfile->data[ch], test_wavfile->data[ch], sizeof(WAVPcmData) * format.num_samples) != 0) {
+          is_ok = 0;
+          break;
+        }
+      }
+      Test_AssertEqual(is_ok, 1);
+
+      WAV_Destroy(src_wavfile);
+      WAV_Destroy(test_wavfile);
+    }
+  }
+}
+
+/* ストリーム読み込み・書き出しのテスト */
+static void testWAV_StreamReadWriteTest(void *obj)
+{
+  const char test_filename[] = "tmp.wav";
+  const uint32_t num_samples_list[] = { 100, WAVPARSER_BULK_READ_NUM_SAMPLES * 2 + 37 };
+  uint32_t i_size, ch, smpl, progress, num_read_samples, is_ok;
+  struct WAVFileFormat format;
+  struct WAVFile *src_wavfile, *test_wavfile;
+  struct WAVStreamWriter* writer;
+  struct WAVStreamReader* reader;
+  WAVPcmData* data_ptr[3];
+
+  TEST_UNUSED_PARAMETER(obj);
+
+  for (i_size = 0; i_size < sizeof(num_samples_list) / sizeof(num_samples_list[0]); i_size++) {
+    format.data_format     = WAV_DATA_FORMAT_PCM;
+    format.num_channels    = 3;
+    format.sampling_rate   = 48000;
+    format.bits_per_sample = 24;
+    format.num_samples     = num_samples_list[i_size];
+
+    src_wavfile = WAV_Create(&format);
+    test_wavfile = WAV_Create(&format);
+    for (ch = 0; ch < format.num_channels; ch++) {
+      for (smpl = 0; smpl < format.num_samples; smpl++) {
+        WAVFile_PCM(src_wavfile, smpl, ch) = (int32_t)((((uint32_t)rand() << 16) ^ (uint32_t)rand()) & 0xFFFFFF00UL);
+      }
+    }
+
+    /* サンプル数未知のヘッダで開き、閉じる時に書き直させる */
+    format.num_samples = 0;
+    writer = WAVStreamWriter_Open(test_filename, &format);
+    Test_AssertCondition(writer != NULL);
+    for (progress = 0; progress < src_wavfile->format.num_samples; progress += 1000) {
+      for (ch = 0; ch < format.num_channels; ch++) {
+        data_ptr[ch] = &src_wavfile->data[ch][progress];
+      }
+      Test_AssertEqual(WAVStreamWriter_Write(writer, (const WAVPcmData* const *)data_ptr,
+            (src_wavfile->format.num_samples - progress < 1000) ? (src_wavfile->format.num_samples - progress) : 1000), WAV_APIRESULT_OK);
+    }
+    Test_AssertEqual(WAVStreamWriter_Close(writer), WAV_APIRESULT_OK);
+
+    /* 一括読み込みで内容を確認 */
+    {
+      struct WAVFile* wavfile = WAV_CreateFromFile(test_filename);
+      Test_AssertCondition(wavfile != NULL);
+      Test_AssertEqual(memcmp(&src_wavfile->format, &wavfile->format, sizeof(struct WAVFileFormat)), 0);
+      WAV_Destroy(wavfile);
+    }
+
+    /* 半端な単位でストリーム読み込み */
+    reader = WAVStreamReader_Open(test_filename);
+    Test_AssertCondition(reader != NULL);
+    Test_AssertEqual(memcmp(WAVStreamReader_GetFormat(reader), &src_wavfile->format, sizeof(struct WAVFileFormat)), 0);
+    progress = 0;
+    do {
+      for (ch = 0; ch < format.num_channels; ch++) {
+        data_ptr[ch] = &test_wavfile->data[ch][progress];
+      }
+      Test_AssertEqual(WAVStreamReader_Read(reader, data_ptr, 777, &num_read_samples), WAV_APIRESULT_OK);
+      progress += num_read_samples;
+    } while (num_read_samples > 0);
+    Test_AssertEqual(progress, src_wavfile->format.num_samples);
+    is_ok = 1;
+    for (ch = 0; ch < format.num_channels; ch++) {
+      if (memcmp(src_wavfile->data[ch], test_wavfile->data[ch], sizeof(WAVPcmData) * progress) != 0) {
+        is_ok = 0;
+      }
+    }
+    Test_AssertEqual(is_ok, 1);
+
+    /* 先頭に戻して読み直し */
+    Test_AssertEqual(WAVStreamReader_Rewind(reader), WAV_APIRESULT_OK);
+    Test_AssertEqual(WAVStreamReader_Read(reader, test_wavfile->data, 10, &num_read_samples), WAV_APIRESULT_OK);
+    Test_AssertEqual(num_read_samples, 10);
+    is_ok = 1;
+    for (ch = 0; ch < format.num_channels; ch++) {
+      if (memcmp(src_wavfile->data[ch], test_wavfile->data[ch], sizeof(WAVPcmData) * 10) != 0) {
+        is_ok = 0;
+      }
+    }
+    Test_AssertEqual(is_ok, 1);
+
+    /* ファイル上の形式のまま読み込み（続きから末尾まで） */
+    {
+      uint8_t* raw = (uint8_t *)malloc(3 * format.num_channels * src_wavfile->format.num_samples);
+      Test_AssertEqual(WAVStreamReader_ReadInterleaved(reader, raw,
+            src_wavfile->format.num_samples, &num_read_samples), WAV_APIRESULT_OK);
+      Test_AssertEqual(num_read_samples, src_wavfile->format.num_samples - 10);
+      is_ok = 1;
+      for (smpl = 0; smpl < num_read_samples; smpl++) {
+        for (ch = 0; ch < format.num_channels; ch++) {
+          const uint8_t* p = &raw[3 * (smpl * format.num_channels + ch)];
+          uint32_t val = ((uint32_t)p[0] << 8) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 24);
+          if ((int32_t)val != WAVFile_PCM(src_wavfile, smpl + 10, ch)) {
+            is_ok = 0;
+          }
+        }
+      }
+      Test_AssertEqual(is_ok, 1);
+      Test_AssertEqual(WAVStreamReader_ReadInterleaved(reader, raw, 1, &num_read_samples), WAV_APIRESULT_OK);
+      Test_AssertEqual(num_read_samples, 0);
+      Test_AssertEqual(WAVStreamReader_ReadInterleaved(reader, NULL, 1, &num_read_samples), WAV_APIRESULT_INVALID_PARAMETER);
+      WAVStreamReader_Close(reader);
+
+      /* ファイル上の形式のまま書き出し */
+      format.num_samples = 0;
+      writer = WAVStreamWriter_Open(test_filename, &format);
+      Test_AssertCondition(writer != NULL);
+      Test_AssertEqual(WAVStreamWriter_WriteInterleaved(writer, raw, src_wavfile->format.num_samples - 10), WAV_APIRESULT_OK);
+      Test_AssertEqual(WAVStreamWriter_WriteInterleaved(writer, NULL, 1), WAV_APIRESULT_INVALID_PARAMETER);
+      Test_AssertEqual(WAVStreamWriter_Close(writer), WAV_APIRESULT_OK);
+      {
+        struct WAVFile* wavfile = WAV_CreateFromFile(test_filename);
+        Test_AssertCondition(wavfile != NULL);
+        Test_AssertEqual(wavfile->format.num_samples, src_wavfile->format.num_samples - 10);
+        is_ok = 1;
+        for (ch = 0; ch < format.num_channels; ch++) {
+          if (memcmp(&src_wavfile->data[ch][10], wavfile->data[ch], sizeof(WAVPcmData) * wavfile->format.num_samples) != 0) {
+            is_ok = 0;
+          }
+        }
+        Test_AssertEqual(is_ok, 1);
+        WAV_Destroy(wavfile);
+      }
+      free(raw);
+    }
+
+    WAV_Destroy(src_wavfile);
+    WAV_Destroy(test_wavfile);
+  }
+
+  /* 異常系 */
+  Test_AssertCondition(WAVStreamReader_Open(NULL) == NULL);
+  Test_AssertCondition(WAVStreamReader_Open("a_file_that_does_not_exist.wav") == NULL);
+  format.bits_per_sample = 12;
+  Test_AssertCondition(WAVStreamWriter_Open(test_filename, &format) == NULL);
+}
+
+/* リトルエンディアンでバッファに書き込む */
+static uint8_t* testWAV_PutLittleEndian(uint8_t* ptr, uint64_t val, uint32_t nbytes)
+{
+  uint32_t i;
+  for (i = 0; i < nbytes; i++) {
+    *ptr++ = (uint8_t)((val >> (8 * i)) & 0xFF);
+  }
+  return ptr;
+}
+
+/* Wave64のGUIDをバッファに書き込む */
+static uint8_t* testWAV_PutW64GUID(uint8_t* ptr, const char* id, const uint8_t* guid_tail)
+{
+  memcpy(ptr, id, 4);
+  memcpy(ptr + 4, guid_tail, 12);
+  return ptr + 16;
+}
+
+/* RF64/Wave64形式の読み書きテスト */
+static void testWAV_ExtendedContainerTest(void *obj)
+{
+  const char test_filename[] = "tmp.wav";
+  uint32_t ch, smpl, is_ok;
+  struct WAVFileFormat format;
+  struct WAVFile *src_wavfile;
+
+  TEST_UNUSED_PARAMETER(obj);
+
+  format.data_format     = WAV_DATA_FORMAT_PCM;
+  format.num_channels    = 2;
+  format.sampling_rate   = 44100;
+  format.bits_per_sample = 16;
+  format.num_samples     = 123;
+  src_wavfile = WAV_Create(&format);
+  for (ch = 0; ch < format.num_channels; ch++) {
+    for (smpl = 0; smpl < format.num_samples; smpl++) {
+      WAVFile_PCM(src_wavfile, smpl, ch) = (int32_t)(((uint32_t)rand() << 16) & 0xFFFF0000UL);
+    }
+  }
+
+  /* RF64形式で書き出して読み込めるか？ */
+  {
+    FILE* fp;
+    struct WAVWriter writer;
+    struct WAVFile* wavfile;
+
+    fp = fopen(test_filename, "wb");
+    WAVWriter_Initialize(&writer, fp);
+    Test_AssertEqual(WAVWriter_PutWAVHeader(&writer, &format, 1), WAV_ERROR_OK);
+    Test_AssertEqual(WAVWriter_PutWAVPcmData(&writer, src_wavfile), WAV_ERROR_OK);
+    WAVWriter_Finalize(&writer);
+    fclose(fp);
+
+    wavfile = WAV_CreateFromFile(test_filename);
+    Test_AssertCondition(wavfile != NULL);
+    Test_AssertEqual(memcmp(&src_wavfile->format, &wavfile->format, sizeof(struct WAVFileFormat)), 0);
+    is_ok = 1;
+    for (ch = 0; ch < format.num_channels; ch++) {
+      if (memcmp(src_wavfile->data[ch], wavfile->data[ch], sizeof(WAVPcmData) * format.num_samples) != 0) {
+        is_ok = 0;
+      }
+    }
+    Test_AssertEqual(is_ok, 1);
+    WAV_Destroy(wavfile);
+  }
+
+  /* Wave64形式（奇数サイズの未知チャンク付き）を読み込めるか？ */
+  {
+    FILE* fp;
+    uint8_t *buffer, *ptr;
+    const uint32_t data_size = (uint32_t)format.num_samples * format.num_channels * 2;
+    struct WAVStreamReader* reader;
+    struct WAVFile* test_wavfile;
+    uint32_t num_read_samples;
+
+    buffer = (uint8_t *)malloc(256 + data_size);
+    ptr = buffer;
+    ptr = testWAV_PutW64GUID(ptr, "riff", wav_w64_riff_guid_tail);
+    ptr = testWAV_PutLittleEndian(ptr, 40 + 40 + 32 + 24 + data_size, 8);
+    ptr = testWAV_PutW64GUID(ptr, "wave", wav_w64_chunk_guid_tail);
+    /* fmtチャンク */
+    ptr = testWAV_PutW64GUID(ptr, "fmt ", wav_w64_chunk_guid_tail);
+    ptr = testWAV_PutLittleEndian(ptr, 24 + 16, 8);
+    ptr = testWAV_PutLittleEndian(ptr, 1, 2);
+    ptr = testWAV_PutLittleEndian(ptr, format.num_channels, 2);
+    ptr = testWAV_PutLittleEndian(ptr, format.sampling_rate, 4);
+    ptr = testWAV_PutLittleEndian(ptr, format.sampling_rate * format.num_channels * 2, 4);
+    ptr = testWAV_PutLittleEndian(ptr, format.num_channels * 2, 2);
+    ptr = testWAV_PutLittleEndian(ptr, format.bits_per_sample, 2);
+    /* 未知のチャンク（3バイト+8バイト境界までのパディング） */
+    ptr = testWAV_PutW64GUID(ptr, "junk", wav_w64_chunk_guid_tail);
+    ptr = testWAV_PutLittleEndian(ptr, 24 + 3, 8);
+    memset(ptr, 0xAA, 8);
+    ptr += 8;
+    /* dataチャンク */
+    ptr = testWAV_PutW64GUID(ptr, "data", wav_w64_chunk_guid_tail);
+    ptr = testWAV_PutLittleEndian(ptr, 24 + (uint64_t)data_size, 8);
+    for (smpl = 0; smpl < format.num_samples; smpl++) {
+      for (ch = 0; ch < format.num_channels; ch++) {
+        ptr = testWAV_PutLittleEndian(ptr, (uint32_t)WAVFile_PCM(src_wavfile, smpl, ch) >> 16, 2);
+      }
+    }
+    fp = fopen(test_filename, "wb");
+    fwrite(buffer, sizeof(uint8_t), (size_t)(ptr - buffer), fp);
+    fclose(fp);
+
+    reader = WAVStreamReader_Open(test_filename);
+    Test_AssertCondition(reader != NULL);
+    Test_AssertEqual(memcmp(WAVStreamReader_GetFormat(reader), &src_wavfile->format, sizeof(struct WAVFileFormat)), 0);
+    test_wavfile = WAV_Create(&format);
+    Test_AssertEqual(WAVStreamReader_Read(reader, test_wavfile->data, (uint32_t)format.num_samples, &num_read_samples), WAV_APIRESULT_OK);
+    Test_AssertEqual(num_read_samples, format.num_samples);
+    is_ok = 1;
+    for (ch = 0; ch < format.num_channels; ch++) {
+      if (memcmp(src_wavfile->data[ch], test_wavfile->data[ch], sizeof(WAVPcmData) * format.num_samples) != 0) {
+        is_ok = 0;
+      }
+    }
+    Test_AssertEqual(is_ok, 1);
+    WAVStreamReader_Close(reader);
+    WAV_Destroy(test_wavfile);
+
+    /* GUIDが壊れていたら読めない */
+    buffer[4] ^= 0xFF;
+    fp = fopen(test_filename, "wb");
+    fwrite(buffer, sizeof(uint8_t), (size_t)(ptr - buffer), fp);
+    fclose(fp);
+    Test_AssertCondition(WAVStreamReader_Open(test_filename) == NULL);
+
+    free(buffer);
+  }
+
+  /* WAVE_FORMAT_EXTENSIBLE（サブフォーマットがリニアPCM）を読み込めるか？ */
+  {
+    FILE* fp;
+    uint8_t *buffer, *ptr, *subformat_ptr;
+    const uint32_t data_size = (uint32_t)format.num_samples * format.num_channels * 2;
+    static const uint8_t pcm_guid_tail[14]
+      = { 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71 };
+    struct WAVStreamReader* reader;
+    struct WAVFile* test_wavfile;
+    uint32_t num_read_samples;
+
+    buffer = (uint8_t *)malloc(128 + data_size);
+    ptr = buffer;
+    memcpy(ptr, "RIFF", 4); ptr += 4;
+    ptr = testWAV_PutLittleEndian(ptr, 4 + 8 + 40 + 8 + data_size, 4);
+    memcpy(ptr, "WAVE", 4); ptr += 4;
+    /* fmtチャンク */
+    memcpy(ptr, "fmt ", 4); ptr += 4;
+    ptr = testWAV_PutLittleEndian(ptr, 40, 4);
+    ptr = testWAV_PutLittleEndian(ptr, 0xFFFE, 2);
+    ptr = testWAV_PutLittleEndian(ptr, format.num_channels, 2);
+    ptr = testWAV_PutLittleEndian(ptr, format.sampling_rate, 4);
+    ptr = testWAV_PutLittleEndian(ptr, format.sampling_rate * format.num_channels * 2, 4);
+    ptr = testWAV_PutLittleEndian(ptr, format.num_channels * 2, 2);
+    ptr = testWAV_PutLittleEndian(ptr, format.bits_per_sample, 2);
+    ptr = testWAV_PutLittleEndian(ptr, 22, 2);
+    ptr = testWAV_PutLittleEndian(ptr, format.bits_per_sample, 2);
+    ptr = testWAV_PutLittleEndian(ptr, 0, 4);
+    subformat_ptr = ptr;
+    ptr = testWAV_PutLittleEndian(ptr, 1, 2);
+    memcpy(ptr, pcm_guid_tail, sizeof(pcm_guid_tail)); ptr += sizeof(pcm_guid_tail);
+    /* dataチャンク */
+    memcpy(ptr, "data", 4); ptr += 4;
+    ptr = testWAV_PutLittleEndian(ptr, data_size, 4);
+    for (smpl = 0; smpl < format.num_samples; smpl++) {
+      for (ch = 0; ch < format.num_channels; ch++) {
+        ptr = testWAV_PutLittleEndian(ptr, (uint32_t)WAVFile_PCM(src_wavfile, smpl, ch) >> 16, 2);
+      }
+    }
+    fp = fopen(test_filename, "wb");
+    fwrite(buffer, sizeof(uint8_t), (size_t)(ptr - buffer), fp);
+    fclose(fp);
+
+    reader = WAVStreamReader_Open(test_filename);
+    Test_AssertCondition(reader != NULL);
+    Test_AssertEqual(memcmp(WAVStreamReader_GetFormat(reader), &src_wavfile->format, sizeof(struct WAVFileFormat)), 0);
+    test_wavfile = WAV_Create(&format);
+    Test_AssertEqual(WAVStreamReader_Read(reader, test_wavfile->data, (uint32_t)format.num_samples, &num_read_samples), WAV_APIRESULT_OK);
+    Test_AssertEqual(num_read_samples, format.num_samples);
+    is_ok = 1;
+    for (ch = 0; ch < format.num_channels; ch++) {
+      if (memcmp(src_wavfile->data[ch], test_wavfile->data[ch], sizeof(WAVPcmData) * format.num_samples) != 0) {
+        is_ok = 0;
+      }
+    }
+    Test_AssertEqual(is_ok, 1);
+    WAVStreamReader_Close(reader);
+    WAV_Destroy(test_wavfile);
+
+    /* サブフォーマットがリニアPCMでなければ読めない */
+    testWAV_PutLittleEndian(subformat_ptr, 3, 2);
+    fp = fopen(test_filename, "wb");
+    fwrite(buffer, sizeof(uint8_t), (size_t)(ptr - buffer), fp);
+    fclose(fp);
+    Test_AssertCondition(WAVStreamReader_Open(test_filename) == NULL);
+
+    free(buffer);
+  }
+
+  /* 4GiB以上のデータはRF64形式が必要 */
+  Test_AssertEqual(WAV_IsRF64Required(&format), 0);
+  format.num_samples = ((uint64_t)1 << 32);
+  Test_AssertEqual(WAV_IsRF64Required(&format), 1);
+
+  WAV_Destroy(src_wavfile);
+}
+
 void testWAV_Setup(void)
 {
   struct TestSuite *suite
@@ -254,4 +660,7 @@ void testWAV_Setup(void)
   Test_AddTest(suite, testWAV_GetWAVFormatTest);
   Test_AddTest(suite, testWAV_CreateDestroyTest);
   Test_AddTest(suite, testWAV_WriteTest);
+  Test_AddTest(suite, testWAV_ReadWriteBitDepthTest);
+  Test_AddTest(suite, testWAV_StreamReadWriteTest);
+  Test_AddTest(suite, testWAV_ExtendedContainerTest);
 }
@@ -0,0 +1,651 @@
+/* This program is free software. It comes without any warranty, to
+ * the extent permitted by applicable law. You can redistribute it
+ * and/or modify it under the terms of the Do What The Fuck You Want
+ * To Public License, Version 2, as published by Sam Hocevar. See
+ * http://www.wtfpl.net/ for more details. */
+
+/* エンコードプリセット毎のスループット計測 */
+
+#include "SLAEncoder.h"
+#include "SLADecoder.h"
+#include "SLAEncodePreset.h"
+#include "wav.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+/* 合成信号のサンプリングレート */
+#define BENCH_SAMPLING_RATE             44100
+/* 合成信号のデフォルト長[sec] */
+#define BENCH_DEFAULT_SIGNAL_LENGTH     10
+/* ストリーミングデコードの呼び出しあたりサンプル数 */
+#define BENCH_STREAMING_NUM_FRAMES      1024
+/* 最大チャンネル数 */
+#define BENCH_MAX_NUM_CHANNELS          8
+/* 円周率 */
+#define BENCH_PI                        3.14159265358979323846
+
+/* 2つのうち小さい値の選択 */
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+
+/* 計測対象の信号 */
+struct BenchSignal {
+  char                  name[256];      /* 信号名                 */
+  struct SLAWaveFormat  wave_format;    /* 波形フォーマット       */
+  uint32_t              num_samples;    /* チャンネルあたりサンプル数 */
+  int32_t**             data;           /* PCMデータ              */
+};
+
+/* 1工程の計測結果 */
+struct BenchStage {
+  double seconds;   /* 処理時間[sec] */
+};
+
+/* 1信号・1プリセットの計測結果 */
+struct BenchResult {
+  uint32_t            preset_no;
+  uint64_t            pcm_bytes;        /* 元データサイズ       */
+  uint64_t            encoded_bytes;    /* エンコード後サイズ   */
+  double              duration;         /* 信号長[sec]          */
+  struct BenchStage   encode;           /* エンコード           */
+  struct BenchStage   decode;           /* 一括デコード         */
+  struct BenchStage   streaming_decode; /* ストリーミングデコード */
+  int                 is_lossless;      /* 復号結果が一致したか */
+  int                 has_statistics;   /* 処理段階毎の統計情報を取得できたか */
+  struct SLAStatistics encode_statistics; /* エンコードの統計情報 */
+  struct SLAStatistics decode_statistics; /* 一括デコードの統計情報 */
+};
+
+/* 統計情報の処理段階名 */
+static const char* stage_name[SLA_STATISTICS_NUM_STAGES] = {
+  "partition_search", "lpc", "longterm", "lms", "entropy_coding", "crc"
+};
+
+/* 統計情報の時計名 */
+static const char* tick_clock_name[] = {
+  "monotonic", "process_cpu", "user_defined"
+};
+
+/* 擬似乱数（環境によらず同一系列を生成する） */
+static uint32_t bench_rand_state = 1;
+static double bench_rand_uniform(void)
+{
+  bench_rand_state = bench_rand_state * 1103515245UL + 12345UL;
+  return ((double)((bench_rand_state >> 8) & 0xFFFFFF) / (double)0x1000000) * 2.0 - 1.0;
+}
+
+/* 使用法の表示 */
+static void print_usage(const char* program_name)
+{
+  printf("Usage: %s [-l SECONDS] [-r REPEAT] [-p PRESET] [-s] [-j] [-d] [WAV_FILE ...] \n", program_name);
+  printf("  -l SECONDS  Length of synthetic signals (default:%d) \n", BENCH_DEFAULT_SIGNAL_LENGTH);
+  printf("  -r REPEAT   Repeat count; the fastest run is reported (default:1) \n");
+  printf("  -p PRESET   Measure only this preset (default:all) \n");
+  printf("  -s          Skip synthetic corpus (measure only given WAV files) \n");
+  printf("  -j          Output results as JSON \n");
+  printf("  -d          Show per-stage breakdown in text output \n");
+}
+
+/* 信号領域の確保 */
+static struct BenchSignal* create_signal(const char* name,
+    uint32_t num_channels, uint32_t bit_per_sample, uint32_t sampling_rate, uint32_t num_samples)
+{
+  uint32_t ch;
+  struct BenchSignal* signal;
+
+  signal = (struct BenchSignal *)malloc(sizeof(struct BenchSignal));
+  strncpy(signal->name, name, sizeof(signal->name) - 1);
+  signal->name[sizeof(signal->name) - 1] = '\0';
+  signal->wave_format.num_channels    = num_channels;
+  signal->wave_format.bit_per_sample  = bit_per_sample;
+  signal->wave_format.sampling_rate   = sampling_rate;
+  signal->wave_format.offset_lshift   = 0;
+  signal->num_samples = num_samples;
+  signal->data = (int32_t **)malloc(sizeof(int32_t *) * num_channels);
+  for (ch = 0; ch < num_channels; ch++) {
+    signal->data[ch] = (int32_t *)calloc(num_samples, sizeof(int32_t));
+  }
+
+  return signal;
+}
+
+/* 信号領域の破棄 */
+static void destroy_signal(struct BenchSignal* signal)
+{
+  uint32_t ch;
+  for (ch = 0; ch < signal->wave_format.num_channels; ch++) {
+    free(signal->data[ch]);
+  }
+  free(signal->data);
+  free(signal);
+}
+
+/* [-1,1]の値をビット深度に合わせて量子化 */
+static int32_t quantize(double value, uint32_t bit_per_sample)
+{
+  double scale = (double)(1UL << (bit_per_sample - 1));
+  double q = floor(value * scale + 0.5);
+  if (q > scale - 1.0) {
+    q = scale - 1.0;
+  } else if (q < -scale) {
+    q = -scale;
+  }
+  return (int32_t)q;
+}
+
+/* 対数スイープ信号 */
+static void generate_sweep(struct BenchSignal* signal)
+{
+  uint32_t ch, smpl;
+  const double f0 = 20.0, f1 = 20000.0;
+  const double duration = (double)signal->num_samples / signal->wave_format.sampling_rate;
+  const double k = log(f1 / f0);
+  for (ch = 0; ch < signal->wave_format.num_channels; ch++) {
+    for (smpl = 0; smpl < signal->num_samples; smpl++) {
+      double t = (double)smpl / signal->wave_format.sampling_rate;
+      double phase = 2.0 * BENCH_PI * f0 * duration / k * (exp(t * k / duration) - 1.0);
+      signal->data[ch][smpl] = quantize(0.5 * sin(phase + 0.25 * BENCH_PI * ch), signal->wave_format.bit_per_sample);
+    }
+  }
+}
+
+/* 白色雑音 */
+static void generate_noise(struct BenchSignal* signal)
+{
+  uint32_t ch, smpl;
+  for (ch = 0; ch < signal->wave_format.num_channels; ch++) {
+    for (smpl = 0; smpl < signal->num_samples; smpl++) {
+      signal->data[ch][smpl] = quantize(0.25 * bench_rand_uniform(), signal->wave_format.bit_per_sample);
+    }
+  }
+}
+
+/* 過渡音（減衰する打撃音の繰り返しと低音） */
+static void generate_transients(struct BenchSignal* signal)
+{
+  uint32_t ch, smpl;
+  const uint32_t interval = signal->wave_format.sampling_rate / 4;
+  for (ch = 0; ch < signal->wave_format.num_channels; ch++) {
+    for (smpl = 0; smpl < signal->num_samples; smpl++) {
+      double t = (double)smpl / signal->wave_format.sampling_rate;
+      double envelope = exp(-(double)(smpl % interval) / (0.01 * signal->wave_format.sampling_rate));
+      double value = 0.6 * envelope * bench_rand_uniform() + 0.1 * sin(2.0 * BENCH_PI * 55.0 * t);
+      signal->data[ch][smpl] = quantize(value, signal->wave_format.bit_per_sample);
+    }
+  }
+}
+
+/* 多チャンネル混合音（チャンネル毎に異なる和音と少量の雑音） */
+static void generate_multichannel_mix(struct BenchSignal* signal)
+{
+  uint32_t ch, smpl;
+  for (ch = 0; ch < signal->wave_format.num_channels; ch++) {
+    const double f0 = 110.0 * (ch + 1), f1 = 440.0 * 1.5 * (ch + 1);
+    for (smpl = 0; smpl < signal->num_samples; smpl++) {
+      double t = (double)smpl / signal->wave_format.sampling_rate;
+      double value = 0.3 * sin(2.0 * BENCH_PI * f0 * t) + 0.2 * sin(2.0 * BENCH_PI * f1 * t)
+        + 0.01 * bench_rand_uniform();
+      signal->data[ch][smpl] = quantize(value, signal->wave_format.bit_per_sample);
+    }
+  }
+}
+
+/* 合成信号コーパスの作成 */
+static uint32_t create_synthetic_corpus(struct BenchSignal** signals, uint32_t num_samples)
+{
+  uint32_t num_signals = 0;
+
+  bench_rand_state = 1;
+  signals[num_signals++] = create_signal("silence", 2, 16, BENCH_SAMPLING_RATE, num_samples);
+  signals[num_signals] = create_signal("sweep", 2, 16, BENCH_SAMPLING_RATE, num_samples);
+  generate_sweep(signals[num_signals++]);
+  signals[num_signals] = create_signal("sweep_24bit", 2, 24, BENCH_SAMPLING_RATE, num_samples);
+  generate_sweep(signals[num_signals++]);
+  signals[num_signals] = create_signal("noise", 2, 16, BENCH_SAMPLING_RATE, num_samples);
+  generate_noise(signals[num_signals++]);
+  signals[num_signals] = create_signal("transients", 2, 16, BENCH_SAMPLING_RATE, num_samples);
+  generate_transients(signals[num_signals++]);
+  signals[num_signals] = create_signal("multichannel_mix", 6, 16, BENCH_SAMPLING_RATE, num_samples);
+  generate_multichannel_mix(signals[num_signals++]);
+
+  return num_signals;
+}
+
+/* WAVファイルから信号を作成 */
+static struct BenchSignal* create_signal_from_wav(const char* filename)
+{
+  uint32_t ch;
+  struct WAVFile* wav;
+  struct BenchSignal* signal;
+
+  if ((wav = WAV_CreateFromFile(filename)) == NULL) {
+    return NULL;
+  }
+  if ((wav->format.num_channels > BENCH_MAX_NUM_CHANNELS) || (wav->format.num_samples == 0)) {
+    WAV_Destroy(wav);
+    return NULL;
+  }
+
+  signal = create_signal(filename, wav->format.num_channels,
+      wav->format.bits_per_sample, wav->format.sampling_rate, (uint32_t)wav->format.num_samples);
+  for (ch = 0; ch < wav->format.num_channels; ch++) {
+    memcpy(signal->data[ch], wav->data[ch], sizeof(int32_t) * (size_t)wav->format.num_samples);
+  }
+  WAV_Destroy(wav);
+
+  return signal;
+}
+
+/* 経過時間[sec]の取得 */
+static double elapsed_seconds(clock_t start, clock_t end)
+{
+  return (double)(end - start) / CLOCKS_PER_SEC;
+}
+
+/* ストリーミングデコード（データは一括で供給） */
+static int streaming_decode(const uint8_t* data, uint32_t data_size, int32_t** output)
+{
+  uint32_t ch, progress;
+  int32_t* output_ptr[BENCH_MAX_NUM_CHANNELS];
+  struct SLAHeaderInfo header;
+  struct SLAStreamingDecoderConfig config;
+  struct SLAStreamingDecoder* decoder;
+
+  if (SLADecoder_DecodeHeader(data, data_size, &header) != SLA_APIRESULT_OK) {
+    return 1;
+  }
+  config.core_config.max_num_channels         = header.wave_format.num_channels;
+  config.core_config.max_num_block_samples    = header.encode_param.max_num_block_samples;
+  config.core_config.max_parcor_order         = header.encode_param.parcor_order;
+  config.core_config.max_longterm_order       = header.encode_param.longterm_order;
+  config.core_config.max_lms_order_per_filter = header.encode_param.lms_order_per_filter;
+  config.core_config.enable_crc_check         = 1;
+  config.core_config.verpose_flag             = 0;
+  config.max_bit_per_sample                   = header.wave_format.bit_per_sample;
+  config.decode_interval_hz = (float)header.wave_format.sampling_rate / BENCH_STREAMING_NUM_FRAMES;
+  if ((decoder = SLAStreamingDecoder_Create(&config)) == NULL) {
+    return 1;
+  }
+  if ((SLAStreamingDecoder_SetWaveFormat(decoder, &header.wave_format) != SLA_APIRESULT_OK)
+      || (SLAStreamingDecoder_SetEncodeParameter(decoder, &header.encode_param) != SLA_APIRESULT_OK)
+      || (SLAStreamingDecoder_AppendDataFragment(decoder,
+          &data[header.header_size], data_size - header.header_size) != SLA_APIRESULT_OK)) {
+    SLAStreamingDecoder_Destroy(decoder);
+    return 1;
+  }
+
+  for (progress = 0; progress < header.num_samples; progress += BENCH_STREAMING_NUM_FRAMES) {
+    uint32_t num_frames = (uint32_t)MIN(BENCH_STREAMING_NUM_FRAMES, header.num_samples - progress);
+    for (ch = 0; ch < header.wave_format.num_channels; ch++) {
+      output_ptr[ch] = &output[ch][progress];
+    }
+    if (SLAStreamingDecoder_DecodeFrames(decoder, output_ptr, num_frames) != SLA_APIRESULT_OK) {
+      SLAStreamingDecoder_Destroy(decoder);
+      return 1;
+    }
+  }
+
+  SLAStreamingDecoder_Destroy(decoder);
+  return 0;
+}
+
+/* 1信号・1プリセットの計測 */
+static int measure(struct SLAEncoder* encoder, struct SLADecoder* decoder,
+    const struct BenchSignal* signal, uint32_t preset_no, uint32_t num_repeat, struct BenchResult* result)
+{
+  uint32_t ch, smpl, repeat, buffer_size, encoded_size, decoded_num_samples;
+  uint8_t* buffer;
+  int32_t** output;
+  clock_t start, end;
+  struct SLAEncodeParameter enc_param;
+  const uint32_t num_channels = signal->wave_format.num_channels;
+
+  /* エンコードパラメータの設定（CUIと同じくステレオの場合のみMS処理） */
+  enc_param = encode_preset[preset_no];
+  if ((num_channels != 2) || (enc_param.ch_process_method != SLA_CHPROCESSMETHOD_STEREO_MS)) {
+    enc_param.ch_process_method = SLA_CHPROCESSMETHOD_NONE;
+  }
+  if ((SLAEncoder_SetWaveFormat(encoder, &signal->wave_format) != SLA_APIRESULT_OK)
+      || (SLAEncoder_SetEncodeParameter(encoder, &enc_param) != SLA_APIRESULT_OK)) {
+    fprintf(stderr, "Failed to set parameter to encoder. \n");
+    return 1;
+  }
+
+  buffer_size = SLA_HEADER_SIZE
+    + SLA_CalculateSufficientBlockSize(num_channels, signal->num_samples, signal->wave_format.bit_per_sample);
+  buffer = (uint8_t *)malloc(buffer_size);
+  output = (int32_t **)malloc(sizeof(int32_t *) * num_channels);
+  for (ch = 0; ch < num_channels; ch++) {
+    output[ch] = (int32_t *)malloc(sizeof(int32_t) * signal->num_samples);
+  }
+
+  result->preset_no = preset_no;
+  result->pcm_bytes = (uint64_t)signal->num_samples * num_channels * ((signal->wave_format.bit_per_sample + 7) / 8);
+  result->duration  = (double)signal->num_samples / signal->wave_format.sampling_rate;
+  result->encode.seconds = result->decode.seconds = result->streaming_decode.seconds = -1.0;
+  result->is_lossless = 1;
+  (void)SLAEncoder_ResetStatistics(encoder);
+  (void)SLADecoder_ResetStatistics(decoder);
+
+  for (repeat = 0; repeat < num_repeat; repeat++) {
+    double seconds;
+
+    /* エンコード */
+    start = clock();
+    if (SLAEncoder_EncodeWhole(encoder, (const int32_t* const *)signal->data, signal->num_samples,
+          buffer, buffer_size, &encoded_size) != SLA_APIRESULT_OK) {
+      fprintf(stderr, "Failed to encode %s. \n", signal->name);
+      break;
+    }
+    end = clock();
+    seconds = elapsed_seconds(start, end);
+    if ((result->encode.seconds < 0.0) || (seconds < result->encode.seconds)) {
+      result->encode.seconds = seconds;
+    }
+    result->encoded_bytes = encoded_size;
+
+    /* 一括デコード */
+    start = clock();
+    if (SLADecoder_DecodeWhole(decoder, buffer, encoded_size,
+          output, signal->num_samples, &decoded_num_samples) != SLA_APIRESULT_OK) {
+      fprintf(stderr, "Failed to decode %s. \n", signal->name);
+      break;
+    }
+    end = clock();
+    seconds = elapsed_seconds(start, end);
+    if ((result->decode.seconds < 0.0) || (seconds < result->decode.seconds)) {
+      result->decode.seconds = seconds;
+    }
+
+    /* ストリーミングデコード（ハンドル作成を含む） */
+    start = clock();
+    if (streaming_decode(buffer, encoded_size, output) != 0) {
+      fprintf(stderr, "Failed to streaming decode %s. \n", signal->name);
+      break;
+    }
+    end = clock();
+    seconds = elapsed_seconds(start, end);
+    if ((result->streaming_decode.seconds < 0.0) || (seconds < result->streaming_decode.seconds)) {
+      result->streaming_decode.seconds = seconds;
+    }
+  }
+
+  /* 処理段階毎の統計情報（繰り返し全体の合計） */
+  result->has_statistics
+    = ((SLAEncoder_GetStatistics(encoder, &result->encode_statistics) == SLA_APIRESULT_OK)
+        && (SLADecoder_GetStatistics(decoder, &result->decode_statistics) == SLA_APIRESULT_OK)) ? 1 : 0;
+
+  /* 可逆性の確認 */
+  for (ch = 0; ch < num_channels; ch++) {
+    for (smpl = 0; smpl < signal->num_samples; smpl++) {
+      if (signal->data[ch][smpl] != output[ch][smpl]) {
+        result->is_lossless = 0;
+        break;
+      }
+    }
+  }
+
+  for (ch = 0; ch < num_channels; ch++) {
+    free(output[ch]);
+  }
+  free(output);
+  free(buffer);
+
+  return (repeat < num_repeat) ? 1 : 0;
+}
+
+/* 処理速度[MB/s]の計算 */
+static double megabytes_per_second(uint64_t bytes, double seconds)
+{
+  return (seconds > 0.0) ? ((double)bytes / (1000.0 * 1000.0) / seconds) : 0.0;
+}
+
+/* 実時間比の計算 */
+static double times_realtime(double duration, double seconds)
+{
+  return (seconds > 0.0) ? (duration / seconds) : 0.0;
+}
+
+/* 結果の表示（人間向け） */
+static void print_result_text(const char* name, const struct BenchResult* result)
+{
+  printf("%-24s %6u %7.2f%% %9.2f %9.1fx %9.2f %9.1fx %9.2f %9.1fx %s \n",
+      name, result->preset_no,
+      100.0 * (double)result->encoded_bytes / (double)result->pcm_bytes,
+      megabytes_per_second(result->pcm_bytes, result->encode.seconds),
+      times_realtime(result->duration, result->encode.seconds),
+      megabytes_per_second(result->pcm_bytes, result->decode.seconds),
+      times_realtime(result->duration, result->decode.seconds),
+      megabytes_per_second(result->pcm_bytes, result->streaming_decode.seconds),
+      times_realtime(result->duration, result->streaming_decode.seconds),
+      result->is_lossless ? "ok" : "MISMATCH");
+}
+
+/* 1工程の結果の表示（JSON） */
+static void print_stage_json(const char* stage_name,
+    const struct BenchStage* stage, const struct BenchResult* result, int is_last)
+{
+  printf("      \"%s\": { \"seconds\": %.6f, \"mb_per_sec\": %.3f, \"x_realtime\": %.2f }%s\n",
+      stage_name, stage->seconds,
+      megabytes_per_second(result->pcm_bytes, stage->seconds),
+      times_realtime(result->duration, stage->seconds), is_last ? "" : ",");
+}
+
+/* 処理段階毎の処理時間比率の表示（人間向け） */
+static void print_stage_breakdown_text(const char* label, const struct SLAStatistics* stats)
+{
+  uint32_t i;
+  uint64_t total = 0;
+
+  for (i = 0; i < SLA_STATISTICS_NUM_STAGES; i++) {
+    total += stats->stage_ticks[i];
+  }
+  printf("  %-8s", label);
+  for (i = 0; i < SLA_STATISTICS_NUM_STAGES; i++) {
+    printf(" %s:%5.1f%%", stage_name[i],
+        (total > 0) ? (100.0 * (double)stats->stage_ticks[i] / (double)total) : 0.0);
+  }
+  printf(" \n");
+}
+
+/* 処理段階毎の統計情報の表示（JSON） */
+static void print_statistics_json(const char* label,
+    const struct SLAStatistics* stats, uint32_t num_repeat, int is_last)
+{
+  uint32_t i;
+
+  printf("      \"%s\": { \"tick_clock\": \"%s\", \"stage_seconds\": {", label, tick_clock_name[stats->tick_clock]);
+  for (i = 0; i < SLA_STATISTICS_NUM_STAGES; i++) {
+    printf("%s \"%s\": %.6f", (i == 0) ? "" : ",", stage_name[i],
+        (double)stats->stage_ticks[i] / (double)stats->ticks_per_second / num_repeat);
+  }
+  printf(" },\n");
+  printf("        \"blocks\": { \"compressed\": %u, \"silent\": %u, \"raw\": %u },\n",
+      stats->num_compressed_blocks / num_repeat, stats->num_silent_blocks / num_repeat, stats->num_raw_blocks / num_repeat);
+  printf("        \"coefficient_bits_per_sample\": %.4f, \"residual_bits_per_sample\": %.4f }%s\n",
+      (stats->num_samples > 0) ? ((double)stats->coefficient_bits / (double)stats->num_samples) : 0.0,
+      (stats->num_samples > 0) ? ((double)stats->residual_bits / (double)stats->num_samples) : 0.0,
+      is_last ? "" : ",");
+}
+
+/* 結果の表示（JSON） */
+/* 補足）要素の区切りは2番目以降の要素の前に出力する（計測に失敗した要素を飛ばしても配列が崩れない） */
+static void print_result_json(const char* name, const struct BenchSignal* signal,
+    const struct BenchResult* result, uint32_t num_repeat, int is_first)
+{
+  const char* p;
+
+  if (!is_first) {
+    printf(",\n");
+  }
+
+  /* 信号名のエスケープ */
+  printf("    { \"signal\": \"");
+  for (p = name; *p != '\0'; p++) {
+    if ((*p == '"') || (*p == '\\')) {
+      putchar('\\');
+    }
+    putchar(*p);
+  }
+  printf("\",\n");
+  printf("      \"preset\": %u, \"num_channels\": %u, \"bits_per_sample\": %u, \"sampling_rate\": %u, \"num_samples\": %u,\n",
+      result->preset_no, signal->wave_format.num_channels, signal->wave_format.bit_per_sample,
+      signal->wave_format.sampling_rate, signal->num_samples);
+  printf("      \"pcm_bytes\": %lu, \"encoded_bytes\": %lu, \"compression_ratio\": %.4f, \"lossless\": %s,\n",
+      (unsigned long)result->pcm_bytes, (unsigned long)result->encoded_bytes,
+      (double)result->encoded_bytes / (double)result->pcm_bytes, result->is_lossless ? "true" : "false");
+  print_stage_json("encode", &result->encode, result, 0);
+  print_stage_json("decode", &result->decode, result, 0);
+  print_stage_json("streaming_decode", &result->streaming_decode, result, !result->has_statistics);
+  if (result->has_statistics) {
+    print_statistics_json("encode_statistics", &result->encode_statistics, num_repeat, 0);
+    print_statistics_json("decode_statistics", &result->decode_statistics, num_repeat, 1);
+  }
+  printf("    }");
+}
+
+/* 結果の集計 */
+static void accumulate_result(struct BenchResult* total, const struct BenchResult* result)
+{
+  total->pcm_bytes                += result->pcm_bytes;
+  total->encoded_bytes            += result->encoded_bytes;
+  total->duration                 += result->duration;
+  total->encode.seconds           += result->encode.seconds;
+  total->decode.seconds           += result->decode.seconds;
+  total->streaming_decode.seconds += result->streaming_decode.seconds;
+  total->is_lossless              &= result->is_lossless;
+}
+
+int main(int argc, char** argv)
+{
+  int i, json_output, skip_synthetic, show_breakdown, json_first, ret;
+  uint32_t signal_length, num_repeat, num_signals, preset_no, preset_begin, preset_end, sig;
+  struct BenchSignal** signals;
+  struct SLAEncoderConfig encoder_config;
+  struct SLADecoderConfig decoder_config;
+  struct SLAEncoder* encoder;
+  struct SLADecoder* decoder;
+
+  signal_length   = BENCH_DEFAULT_SIGNAL_LENGTH;
+  num_repeat      = 1;
+  preset_begin    = 0;
+  preset_end      = SLA_NUM_ENCODE_PRESETS;
+  json_output     = 0;
+  show_breakdown  = 0;
+  skip_synthetic  = 0;
+
+  /* オプション解析 */
+  for (i = 1; i < argc; i++) {
+    if ((strcmp(argv[i], "-l") == 0) && ((i + 1) < argc)) {
+      signal_length = (uint32_t)strtoul(argv[++i], NULL, 10);
+    } else if ((strcmp(argv[i], "-r") == 0) && ((i + 1) < argc)) {
+      num_repeat = (uint32_t)strtoul(argv[++i], NULL, 10);
+    } else if ((strcmp(argv[i], "-p") == 0) && ((i + 1) < argc)) {
+      preset_begin = (uint32_t)strtoul(argv[++i], NULL, 10);
+      preset_end = preset_begin + 1;
+    } else if (strcmp(argv[i], "-s") == 0) {
+      skip_synthetic = 1;
+    } else if (strcmp(argv[i], "-j") == 0) {
+      json_output = 1;
+    } else if (strcmp(argv[i], "-d") == 0) {
+      show_breakdown = 1;
+    } else if (argv[i][0] == '-') {
+      print_usage(argv[0]);
+      return 1;
+    } else {
+      break;
+    }
+  }
+  if ((signal_length == 0) || (num_repeat == 0) || (preset_end > SLA_NUM_ENCODE_PRESETS)
+      || (skip_synthetic && (i >= argc))) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  /* 計測対象の準備 */
+  signals = (struct BenchSignal **)malloc(sizeof(struct BenchSignal *) * (size_t)(argc + 8));
+  num_signals = 0;
+  if (!skip_synthetic) {
+    num_signals = create_synthetic_corpus(signals, signal_length * BENCH_SAMPLING_RATE);
+  }
+  for (; i < argc; i++) {
+    if ((signals[num_signals] = create_signal_from_wav(argv[i])) == NULL) {
+      fprintf(stderr, "Failed to load %s. \n", argv[i]);
+      continue;
+    }
+    num_signals++;
+  }
+
+  /* ハンドル作成（CUIと同じコンフィグ） */
+  encoder_config.max_num_channels         = BENCH_MAX_NUM_CHANNELS;
+  encoder_config.max_num_block_samples    = 16384;
+  encoder_config.max_parcor_order         = 48;
+  encoder_config.max_longterm_order       = 5;
+  encoder_config.max_lms_order_per_filter = 40;
+  encoder_config.verpose_flag             = 0;
+  decoder_config.max_num_channels         = encoder_config.max_num_channels;
+  decoder_config.max_num_block_samples    = encoder_config.max_num_block_samples;
+  decoder_config.max_parcor_order         = encoder_config.max_parcor_order;
+  decoder_config.max_longterm_order       = encoder_config.max_longterm_order;
+  decoder_config.max_lms_order_per_filter = encoder_config.max_lms_order_per_filter;
+  decoder_config.enable_crc_check         = 1;
+  decoder_config.verpose_flag             = 0;
+  encoder = SLAEncoder_Create(&encoder_config);
+  decoder = SLADecoder_Create(&decoder_config);
+
+  if (json_output) {
+    printf("{\n  \"results\": [\n");
+  } else {
+    printf("%-24s %6s %8s %9s %10s %9s %10s %9s %10s \n", "signal", "preset", "ratio",
+        "enc MB/s", "enc xRT", "dec MB/s", "dec xRT", "strm MB/s", "strm xRT");
+  }
+
+  /* プリセット毎に全信号を計測 */
+  ret = 0;
+  json_first = 1;
+  for (preset_no = preset_begin; preset_no < preset_end; preset_no++) {
+    struct BenchResult total, result;
+    memset(&total, 0, sizeof(struct BenchResult));
+    total.preset_no = preset_no;
+    total.is_lossless = 1;
+    for (sig = 0; sig < num_signals; sig++) {
+      if (measure(encoder, decoder, signals[sig], preset_no, num_repeat, &result) != 0) {
+        ret = 1;
+        continue;
+      }
+      if (!result.is_lossless) {
+        ret = 1;
+      }
+      accumulate_result(&total, &result);
+      if (json_output) {
+        print_result_json(signals[sig]->name, signals[sig], &result, num_repeat, json_first);
+        json_first = 0;
+      } else {
+        print_result_text(signals[sig]->name, &result);
+        if (show_breakdown && result.has_statistics) {
+          print_stage_breakdown_text("encode", &result.encode_statistics);
+          print_stage_breakdown_text("decode", &result.decode_statistics);
+        }
+      }
+    }
+    if (!json_output && (num_signals > 0)) {
+      print_result_text("(total)", &total);
+    }
+  }
+
+  if (json_output) {
+    printf("%s  ]\n}\n", json_first ? "" : "\n");
+  }
+
+  SLAEncoder_Destroy(encoder);
+  SLADecoder_Destroy(decoder);
+  for (sig = 0; sig < num_signals; sig++) {
+    destroy_signal(signals[sig]);
+  }
+  free(signals);
+
+  return ret;
+}
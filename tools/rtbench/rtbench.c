@@ -0,0 +1,238 @@
+/* This program is free software. It comes without any warranty, to
+ * the extent permitted by applicable law. You can redistribute it
+ * and/or modify it under the terms of the Do What The Fuck You Want
+ * To Public License, Version 2, as published by Sam Hocevar. See
+ * http://www.wtfpl.net/ for more details. */
+
+/* 指定サンプル数ちょうどのストリーミングデコードの呼び出しあたりサイクル数計測 */
+
+#include "SLADecoder.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* サイクルカウンタの読み出し */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define RTBENCH_READ_CYCLES() ((uint64_t)__builtin_ia32_rdtsc())
+#define RTBENCH_CYCLES_UNIT   "cycles"
+#else
+/* サイクルカウンタが使えない環境ではclockで代用 */
+#define RTBENCH_READ_CYCLES() ((uint64_t)clock())
+#define RTBENCH_CYCLES_UNIT   "clocks"
+#endif
+
+/* デフォルトの呼び出しあたりサンプル数 */
+#define RTBENCH_DEFAULT_NUM_FRAMES  64
+
+/* 2つのうち小さい値の選択 */
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+
+/* 計測結果 */
+struct RTBenchResult {
+  uint64_t* cycles;     /* 呼び出しあたりサイクル数 */
+  uint32_t  num_calls;  /* 呼び出し回数 */
+};
+
+/* 使用法の表示 */
+static void print_usage(const char* program_name)
+{
+  printf("Usage: %s [-n FRAMES] [-f FRAGMENT_SIZE] INPUT_FILE_NAME ... \n", program_name);
+  printf("  -n FRAMES         Number of frames per decode call (default:%d) \n", RTBENCH_DEFAULT_NUM_FRAMES);
+  printf("  -f FRAGMENT_SIZE  Append data in fragments of this size when data runs short (default:whole file) \n");
+}
+
+/* 比較関数 */
+static int compare_uint64(const void* a, const void* b)
+{
+  uint64_t va = *(const uint64_t *)a;
+  uint64_t vb = *(const uint64_t *)b;
+  return (va > vb) - (va < vb);
+}
+
+/* 統計量の表示 */
+static void print_statistics(const char* label, struct RTBenchResult* result)
+{
+  uint32_t i;
+  double mean;
+
+  if (result->num_calls == 0) {
+    return;
+  }
+
+  /* ソートして分位点を求める */
+  qsort(result->cycles, result->num_calls, sizeof(uint64_t), compare_uint64);
+  mean = 0.0f;
+  for (i = 0; i < result->num_calls; i++) {
+    mean += (double)result->cycles[i];
+  }
+  mean /= result->num_calls;
+
+  printf("%s: calls:%u mean:%.0f p50:%.0f p99:%.0f p99.9:%.0f max:%.0f [%s/call] \n",
+      label, result->num_calls, mean,
+      (double)result->cycles[(uint32_t)(0.5f * (result->num_calls - 1))],
+      (double)result->cycles[(uint32_t)(0.99f * (result->num_calls - 1))],
+      (double)result->cycles[(uint32_t)(0.999f * (result->num_calls - 1))],
+      (double)result->cycles[result->num_calls - 1], RTBENCH_CYCLES_UNIT);
+}
+
+/* 1ファイルの計測 */
+static int measure_file(const char* filename,
+    uint32_t num_frames, uint32_t fragment_size, struct RTBenchResult* result)
+{
+  FILE*                               fp;
+  uint8_t*                            data;
+  long                                file_size;
+  uint32_t                            ch, data_size, data_progress, sample_progress, num_calls;
+  int32_t**                           output;
+  struct SLAHeaderInfo                header;
+  struct SLAStreamingDecoderConfig    config;
+  struct SLAStreamingDecoder*         decoder;
+  SLAApiResult                        ret;
+
+  /* ファイル全体をメモリにロード */
+  if ((fp = fopen(filename, "rb")) == NULL) {
+    fprintf(stderr, "Failed to open %s. \n", filename);
+    return 1;
+  }
+  fseek(fp, 0, SEEK_END);
+  file_size = ftell(fp);
+  fseek(fp, 0, SEEK_SET);
+  data_size = (uint32_t)file_size;
+  data = (uint8_t *)malloc(data_size);
+  if (fread(data, sizeof(uint8_t), data_size, fp) != data_size) {
+    fprintf(stderr, "Failed to read %s. \n", filename);
+    fclose(fp);
+    free(data);
+    return 1;
+  }
+  fclose(fp);
+
+  /* ヘッダデコード */
+  if ((ret = SLADecoder_DecodeHeader(data, data_size, &header)) != SLA_APIRESULT_OK) {
+    fprintf(stderr, "Failed to get header information of %s: %d \n", filename, ret);
+    free(data);
+    return 1;
+  }
+
+  /* ヘッダに合わせたデコーダの作成 */
+  config.core_config.max_num_channels         = header.wave_format.num_channels;
+  config.core_config.max_num_block_samples    = header.encode_param.max_num_block_samples;
+  config.core_config.max_parcor_order         = header.encode_param.parcor_order;
+  config.core_config.max_longterm_order       = header.encode_param.longterm_order;
+  config.core_config.max_lms_order_per_filter = header.encode_param.lms_order_per_filter;
+  config.core_config.enable_crc_check         = 1;
+  config.core_config.verpose_flag             = 0;
+  config.max_bit_per_sample                   = header.wave_format.bit_per_sample;
+  config.decode_interval_hz                   = (float)header.wave_format.sampling_rate / (float)num_frames;
+  if ((decoder = SLAStreamingDecoder_Create(&config)) == NULL) {
+    fprintf(stderr, "Failed to create decoder handle. \n");
+    free(data);
+    return 1;
+  }
+  if (((ret = SLAStreamingDecoder_SetWaveFormat(decoder, &header.wave_format)) != SLA_APIRESULT_OK)
+      || ((ret = SLAStreamingDecoder_SetEncodeParameter(decoder, &header.encode_param)) != SLA_APIRESULT_OK)) {
+    fprintf(stderr, "Failed to set parameter: %d \n", ret);
+    SLAStreamingDecoder_Destroy(decoder);
+    free(data);
+    return 1;
+  }
+
+  /* 出力領域と計測結果領域の確保 */
+  output = (int32_t **)malloc(sizeof(int32_t *) * header.wave_format.num_channels);
+  for (ch = 0; ch < header.wave_format.num_channels; ch++) {
+    output[ch] = (int32_t *)malloc(sizeof(int32_t) * num_frames);
+  }
+  num_calls = (uint32_t)((header.num_samples + num_frames - 1) / num_frames);
+  result->cycles = (uint64_t *)realloc(result->cycles, sizeof(uint64_t) * (result->num_calls + num_calls));
+
+  /* デコードしながら計測 */
+  data_progress = header.header_size;
+  sample_progress = 0;
+  while (sample_progress < header.num_samples) {
+    uint32_t num_decode = (uint32_t)MIN(num_frames, header.num_samples - sample_progress);
+    uint64_t start, end;
+    const uint8_t* collect_data;
+    uint32_t collect_size;
+
+    start = RTBENCH_READ_CYCLES();
+    ret = SLAStreamingDecoder_DecodeFrames(decoder, output, num_decode);
+    end = RTBENCH_READ_CYCLES();
+
+    /* データ不足: データを供給して再試行（計測には含めない） */
+    if ((ret == SLA_APIRESULT_INSUFFICIENT_DATA_SIZE) && (data_progress < data_size)) {
+      uint32_t append_size = (fragment_size == 0) ? (data_size - data_progress) : MIN(fragment_size, data_size - data_progress);
+      if (SLAStreamingDecoder_AppendDataFragment(decoder, &data[data_progress], append_size) != SLA_APIRESULT_OK) {
+        fprintf(stderr, "Failed to append data fragment. \n");
+        break;
+      }
+      data_progress += append_size;
+      continue;
+    } else if (ret != SLA_APIRESULT_OK) {
+      fprintf(stderr, "Decode failed at sample %u: %d \n", sample_progress, ret);
+      break;
+    }
+
+    /* 消費済みデータ回収 */
+    while (SLAStreamingDecoder_CollectDataFragment(decoder,
+          &collect_data, &collect_size) == SLA_APIRESULT_OK) ;
+
+    result->cycles[result->num_calls++] = end - start;
+    sample_progress += num_decode;
+  }
+
+  /* 領域開放 */
+  for (ch = 0; ch < header.wave_format.num_channels; ch++) {
+    free(output[ch]);
+  }
+  free(output);
+  SLAStreamingDecoder_Destroy(decoder);
+  free(data);
+
+  return (sample_progress < header.num_samples) ? 1 : 0;
+}
+
+int main(int argc, char** argv)
+{
+  int i;
+  uint32_t num_frames, fragment_size;
+  struct RTBenchResult total, file_result;
+
+  num_frames    = RTBENCH_DEFAULT_NUM_FRAMES;
+  fragment_size = 0;
+
+  /* オプション解析 */
+  for (i = 1; i < argc; i++) {
+    if ((strcmp(argv[i], "-n") == 0) && ((i + 1) < argc)) {
+      num_frames = (uint32_t)strtoul(argv[++i], NULL, 10);
+    } else if ((strcmp(argv[i], "-f") == 0) && ((i + 1) < argc)) {
+      fragment_size = (uint32_t)strtoul(argv[++i], NULL, 10);
+    } else {
+      break;
+    }
+  }
+  if ((i >= argc) || (num_frames == 0)) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  /* ファイル毎に計測し、コーパス全体でも集計 */
+  total.cycles = NULL;
+  total.num_calls = 0;
+  for (; i < argc; i++) {
+    uint32_t offset = total.num_calls;
+    if (measure_file(argv[i], num_frames, fragment_size, &total) != 0) {
+      free(total.cycles);
+      return 1;
+    }
+    file_result.cycles    = &total.cycles[offset];
+    file_result.num_calls = total.num_calls - offset;
+    print_statistics(argv[i], &file_result);
+  }
+  print_statistics("total", &total);
+
+  free(total.cycles);
+
+  return 0;
+}